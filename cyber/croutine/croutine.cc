@@ -30,6 +30,7 @@ namespace croutine {
 
 thread_local CRoutine *CRoutine::current_routine_ = nullptr;
 thread_local char *CRoutine::main_stack_ = nullptr;
+bool CRoutine::stats_enabled_ = false;
 
 namespace {
 std::shared_ptr<base::CCObjectPool<RoutineContext>> context_pool = nullptr;
@@ -51,6 +52,8 @@ CRoutine::CRoutine(const std::function<void()> &func) : func_(func) {
       routine_num =
           std::max(routine_num, global_conf.scheduler_conf().routine_num());
     }
+    stats_enabled_ =
+        global_conf.scheduler_conf().sched_stats_conf().enable();
     context_pool.reset(new base::CCObjectPool<RoutineContext>(routine_num));
   });
 
@@ -25,6 +25,7 @@
 #include <set>
 #include <string>
 
+#include "cyber/base/macros.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
 
@@ -88,6 +89,12 @@ class CRoutine {
 
   std::chrono::steady_clock::time_point wake_time() const;
 
+  // Steady clock nanoseconds at which the croutine first became runnable
+  // since its last resume (0 if none), only kept with sched stats enabled.
+  uint64_t TakeWakeTime();
+  void MarkWakeTime(uint64_t time_ns);
+  static bool stats_enabled() { return stats_enabled_; }
+
   void set_group_name(const std::string &group_name) {
     group_name_ = group_name;
   }
@@ -109,6 +116,7 @@ class CRoutine {
 
   std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
   std::atomic_flag updated_ = ATOMIC_FLAG_INIT;
+  std::atomic<uint64_t> wake_ns_ = {0};
 
   bool force_stop_ = false;
 
@@ -120,6 +128,7 @@ class CRoutine {
 
   static thread_local CRoutine *current_routine_;
   static thread_local char *main_stack_;
+  static bool stats_enabled_;
 };
 
 inline void CRoutine::Yield(const RoutineState &state) {
@@ -150,6 +159,15 @@ inline std::chrono::steady_clock::time_point CRoutine::wake_time() const {
   return wake_time_;
 }
 
+inline uint64_t CRoutine::TakeWakeTime() {
+  return wake_ns_.exchange(0, std::memory_order_relaxed);
+}
+
+inline void CRoutine::MarkWakeTime(uint64_t time_ns) {
+  uint64_t none = 0;
+  wake_ns_.compare_exchange_strong(none, time_ns, std::memory_order_relaxed);
+}
+
 inline void CRoutine::Wake() { state_ = RoutineState::READY; }
 
 inline void CRoutine::HangUp() { CRoutine::Yield(RoutineState::DATA_WAIT); }
@@ -178,6 +196,11 @@ inline RoutineState CRoutine::UpdateState() {
   if (state_ == RoutineState::SLEEP &&
       std::chrono::steady_clock::now() > wake_time_) {
     state_ = RoutineState::READY;
+    if (cyber_unlikely(stats_enabled_)) {
+      MarkWakeTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       wake_time_.time_since_epoch())
+                       .count());
+    }
     return state_;
   }
 
@@ -203,6 +226,11 @@ inline void CRoutine::Release() {
 }
 
 inline void CRoutine::SetUpdateFlag() {
+  if (cyber_unlikely(stats_enabled_)) {
+    MarkWakeTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count());
+  }
   updated_.clear(std::memory_order_release);
 }
 
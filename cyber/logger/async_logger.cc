@@ -16,7 +16,11 @@
 
 #include "cyber/logger/async_logger.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -28,14 +32,130 @@ namespace apollo {
 namespace cyber {
 namespace logger {
 
-static const std::unordered_map<char, int> log_level_map = {
-    {'F', 3}, {'E', 2}, {'W', 1}, {'I', 0}};
+namespace {
 
-AsyncLogger::AsyncLogger(google::base::Logger* wrapped) : wrapped_(wrapped) {
-  active_buf_.reset(new std::deque<Msg>());
-  flushing_buf_.reset(new std::deque<Msg>());
+// Bytes of records a single writing thread can have pending, glog messages
+// are limited to 30000 bytes.
+constexpr size_t kRingCapacity = 256 * 1024;
+constexpr size_t kMaxMessageSize = kRingCapacity / 4;
+// A full ring is retried for about 10 ms before the message is dropped.
+constexpr int kPushRetryNum = 100;
+constexpr auto kPushRetryInterval = std::chrono::microseconds(100);
+// Lines of a module are written once this many bytes are collected.
+constexpr size_t kMaxBatchSize = 1024 * 1024;
+// The logger thread sleeps after a pass which drained less than this.
+constexpr size_t kIdleDrainSize = 64 * 1024;
+
+std::atomic<uint64_t> next_logger_id = {1};
+
+int32_t LogLevel(char severity) {
+  switch (severity) {
+    case 'F':
+      return 3;
+    case 'E':
+      return 2;
+    case 'W':
+      return 1;
+    default:
+      return 0;
+  }
 }
 
+}  // namespace
+
+// Single producer single consumer ring of records, each record is a header
+// followed by the message bytes and padded to 8 bytes. A record never wraps
+// around, the bytes left at the end of the ring are skipped instead.
+class AsyncLogger::LogRing {
+ public:
+  explicit LogRing(size_t capacity)
+      : buffer_(new char[capacity]), capacity_(capacity) {}
+
+  bool TryPush(time_t ts, int32_t level, const char* message,
+               size_t message_len) {
+    const size_t size = RecordSize(message_len);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    size_t offset = static_cast<size_t>(head % capacity_);
+    const size_t contiguous = capacity_ - offset;
+    const size_t needed = contiguous < size ? contiguous + size : size;
+    if (capacity_ - static_cast<size_t>(head - tail) < needed) {
+      return false;
+    }
+    if (contiguous < size) {
+      if (contiguous >= sizeof(RecordHeader)) {
+        RecordHeader skip = {0, 0, kSkipLength};
+        memcpy(buffer_.get() + offset, &skip, sizeof(skip));
+      }
+      head += contiguous;
+      offset = 0;
+    }
+    RecordHeader header = {static_cast<int64_t>(ts), level,
+                           static_cast<uint32_t>(message_len)};
+    memcpy(buffer_.get() + offset, &header, sizeof(header));
+    memcpy(buffer_.get() + offset + sizeof(header), message, message_len);
+    head_.store(head + size, std::memory_order_release);
+    return true;
+  }
+
+  // Calls consume(ts, level, message, message_len) for every record and
+  // returns the number of bytes released.
+  template <typename Consume>
+  size_t Drain(Consume consume) {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t start = tail_.load(std::memory_order_relaxed);
+    uint64_t tail = start;
+    while (tail < head) {
+      const size_t offset = static_cast<size_t>(tail % capacity_);
+      const size_t contiguous = capacity_ - offset;
+      if (contiguous < sizeof(RecordHeader)) {
+        tail += contiguous;
+        continue;
+      }
+      RecordHeader header;
+      memcpy(&header, buffer_.get() + offset, sizeof(header));
+      if (header.length == kSkipLength) {
+        tail += contiguous;
+        continue;
+      }
+      consume(static_cast<time_t>(header.ts), header.level,
+              buffer_.get() + offset + sizeof(header), header.length);
+      tail += RecordSize(header.length);
+    }
+    tail_.store(tail, std::memory_order_release);
+    return static_cast<size_t>(tail - start);
+  }
+
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct RecordHeader {
+    int64_t ts;
+    int32_t level;
+    uint32_t length;
+  };
+  static constexpr uint32_t kSkipLength = 0xffffffff;
+
+  static size_t RecordSize(size_t message_len) {
+    return (sizeof(RecordHeader) + message_len + 7) & ~static_cast<size_t>(7);
+  }
+
+  // head_ is only written by the producer and tail_ only by the consumer,
+  // keep them on different cache lines.
+  std::atomic<uint64_t> head_ = {0};
+  char head_padding_[64 - sizeof(std::atomic<uint64_t>)];
+  std::atomic<uint64_t> tail_ = {0};
+  char tail_padding_[64 - sizeof(std::atomic<uint64_t>)];
+  std::unique_ptr<char[]> buffer_;
+  const size_t capacity_;
+};
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped)
+    : wrapped_(wrapped), id_(next_logger_id.fetch_add(1)) {}
+
 AsyncLogger::~AsyncLogger() { Stop(); }
 
 void AsyncLogger::Start() {
@@ -51,9 +171,7 @@ void AsyncLogger::Stop() {
     log_thread_.join();
   }
 
-  FlushBuffer(active_buf_);
-  ACHECK(active_buf_->empty());
-  ACHECK(flushing_buf_->empty());
+  FlushRings();
   // std::cout << "Async Logger Stop!" << std::endl;
 }
 
@@ -64,13 +182,19 @@ void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message,
     return;
   }
   if (message_len > 0) {
-    auto msg_str = std::string(message, message_len);
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
+    const size_t length =
+        std::min(static_cast<size_t>(message_len), kMaxMessageSize);
+    const int32_t level = LogLevel(message[0]);
+    LogRing* ring = ThreadRing();
+    int retry = 0;
+    while (!ring->TryPush(timestamp, level, message, length)) {
+      if (++retry > kPushRetryNum ||
+          state_.load(std::memory_order_acquire) != RUNNING) {
+        drop_count_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      }
+      std::this_thread::sleep_for(kPushRetryInterval);
     }
-    active_buf_->emplace_back(timestamp, std::move(msg_str),
-                              log_level_map.at(message[0]));
-    flag_.clear(std::memory_order_release);
   }
 
   if (force_flush && timestamp == 0 && message && message_len == 0) {
@@ -86,42 +210,128 @@ void AsyncLogger::Flush() {
 
 uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
 
+AsyncLogger::LogRing* AsyncLogger::ThreadRing() {
+  // The ring is shared with the logger, it is released once the thread is
+  // gone and the logger thread drained what was left in it.
+  static thread_local struct {
+    uint64_t logger_id = 0;
+    std::shared_ptr<LogRing> ring;
+  } thread_ring;
+  if (cyber_unlikely(thread_ring.logger_id != id_)) {
+    auto ring = std::make_shared<LogRing>(kRingCapacity);
+    {
+      std::lock_guard<std::mutex> lock(rings_mutex_);
+      rings_.push_back(ring);
+    }
+    thread_ring.logger_id = id_;
+    thread_ring.ring = std::move(ring);
+  }
+  return thread_ring.ring.get();
+}
+
 void AsyncLogger::RunThread() {
   while (state_ == RUNNING) {
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
-    }
-    active_buf_.swap(flushing_buf_);
-    flag_.clear(std::memory_order_release);
-    FlushBuffer(flushing_buf_);
-    if (active_buf_->size() < 800) {
+    if (FlushRings() < kIdleDrainSize) {
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
   }
 }
 
-void AsyncLogger::FlushBuffer(const std::unique_ptr<std::deque<Msg>>& buffer) {
-  std::string module_name = "";
-  while (!buffer->empty()) {
-    auto& msg = buffer->front();
-    FindModuleName(&(msg.message), &module_name);
+size_t AsyncLogger::FlushRings() {
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const std::shared_ptr<LogRing>& ring) {
+                                  return ring.use_count() == 1 &&
+                                         ring->Empty();
+                                }),
+                 rings_.end());
+    drained_rings_ = rings_;
+  }
+  size_t drained = 0;
+  for (auto& ring : drained_rings_) {
+    drained += ring->Drain([this](time_t ts, int32_t level,
+                                  const char* message, size_t message_len) {
+      AppendRecord(ts, level, message, message_len);
+    });
+  }
+  drained_rings_.clear();
+  WriteBatches();
+  flush_count_.fetch_add(1, std::memory_order_relaxed);
+  return drained;
+}
 
-    if (module_logger_map_.find(module_name) == module_logger_map_.end()) {
-      std::string file_name = module_name + ".log.INFO.";
+void AsyncLogger::AppendRecord(time_t ts, int32_t level, const char* message,
+                               size_t message_len) {
+  const char* end = message + message_len;
+  const char* lpos = std::find(message, end, LEFT_BRACKET[0]);
+  const char* rpos = lpos == end ? end : std::find(lpos, end, RIGHT_BRACKET[0]);
+  const char* module = lpos + 1;
+  size_t module_len = rpos - module;
+  if (rpos == end || rpos == module) {
+    CHECK_NOTNULL(common::GlobalData::Instance());
+    const std::string& process_group =
+        common::GlobalData::Instance()->ProcessGroup();
+    module = process_group.data();
+    module_len = process_group.size();
+    // an empty "[]" tag is still cut out of the line
+    if (rpos == end) {
+      lpos = end;
+      rpos = end - 1;
+    }
+  }
+
+  // consecutive lines mostly come from the same module
+  if (last_batch_ == nullptr ||
+      module_name_.compare(0, std::string::npos, module, module_len) != 0) {
+    module_name_.assign(module, module_len);
+    last_batch_ = &module_batches_[module_name_];
+  }
+  ModuleBatch& batch = *last_batch_;
+  if (batch.file == nullptr) {
+    auto& module_logger = module_logger_map_[module_name_];
+    if (module_logger == nullptr) {
+      std::string file_name = module_name_ + ".log.INFO.";
       if (!FLAGS_log_dir.empty()) {
         file_name = FLAGS_log_dir + "/" + file_name;
       }
-      module_logger_map_[module_name].reset(
-          new LogFileObject(google::INFO, file_name.c_str()));
-      module_logger_map_[module_name]->SetSymlinkBasename(module_name.c_str());
+      module_logger.reset(new LogFileObject(google::INFO, file_name.c_str()));
+      module_logger->SetSymlinkBasename(module_name_.c_str());
+    }
+    batch.file = module_logger.get();
+  }
+  if (batch.lines.empty()) {
+    batch.ts = ts;
+  }
+  // the module tag is cut out of the line
+  batch.lines.append(message, lpos);
+  batch.lines.append(rpos + 1, end);
+  batch.force_flush = batch.force_flush || level > 0;
+  if (batch.lines.size() >= kMaxBatchSize) {
+    batch.file->Write(batch.force_flush, batch.ts, batch.lines.data(),
+                      static_cast<int>(batch.lines.size()));
+    batch.lines.clear();
+    batch.force_flush = false;
+  }
+}
+
+void AsyncLogger::WriteBatches() {
+  bool written = false;
+  for (auto& module_batch : module_batches_) {
+    ModuleBatch& batch = module_batch.second;
+    if (batch.lines.empty()) {
+      continue;
     }
-    const bool force_flush = msg.level > 0;
-    module_logger_map_.find(module_name)
-        ->second->Write(force_flush, msg.ts, msg.message.data(),
-                        static_cast<int>(msg.message.size()));
-    buffer->pop_front();
+    batch.file->Write(batch.force_flush, batch.ts, batch.lines.data(),
+                      static_cast<int>(batch.lines.size()));
+    batch.lines.clear();
+    batch.force_flush = false;
+    written = true;
+  }
+  if (written) {
+    Flush();
   }
-  Flush();
 }
 
 }  // namespace logger
@@ -21,7 +21,6 @@
 #include <condition_variable>
 #include <cstdint>
 #include <ctime>
-#include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -44,18 +43,18 @@ namespace logger {
  * @class AsyncLogger
  * @brief .
  * Wrapper for a glog Logger which asynchronously writes log messages.
- * This class starts a new thread responsible for forwarding the messages
- * to the logger, and performs double buffering. Writers append to the
- * current buffer and then wake up the logger thread. The logger swaps in
- * a new buffer and writes any accumulated messages to the wrapped
- * Logger.
+ * Every writing thread owns a lock-free single producer ring of compact
+ * records (timestamp, level and the bytes glog formatted), registered with
+ * the logger on the first message of the thread. Writers only copy the
+ * message into their ring. The logger thread drains all rings, strips the
+ * module tags and appends the lines to one batch per module, which is
+ * handed to the module's LogFileObject as a single large write.
  *
- * This double-buffering design dramatically improves performance, especially
- * for logging messages which require flushing the underlying file (i.e WARNING
- * and above for default). The flush can take a couple of milliseconds, and in
- * some cases can even block for hundreds of milliseconds or more. With the
- * double-buffered approach, threads can proceed with useful work while the IO
- * thread blocks.
+ * This design dramatically improves performance, especially for logging
+ * messages which require flushing the underlying file (i.e WARNING and above
+ * for default). The flush can take a couple of milliseconds, and in some
+ * cases can even block for hundreds of milliseconds or more. Writers neither
+ * allocate nor contend with each other or with the IO thread.
  *
  * The semantics provided by this wrapper are slightly weaker than the default
  * glog semantics. By default, glog will immediately (synchronously) flush
@@ -64,11 +63,12 @@ namespace logger {
  * a separate thread. This means that a crash just after a 'LOG_WARN' would
  * may be missing the message in the logs, but the perf benefit is probably
  * worth it. We do take care that a glog FATAL message flushes all buffered log
- * messages before exiting.
+ * messages before exiting. Lines of one thread keep their order, lines of
+ * different threads are only ordered by the time they were drained.
  *
- * @warning The logger limits the total amount of buffer space, so if the
- * underlying log blocks for too long, eventually the threads generating the log
- * messages will block as well. This prevents runaway memory usage.
+ * @warning The rings have a fixed size, so if the underlying log blocks for
+ * too long, the threads generating the log messages wait for a while and then
+ * drop their messages. This prevents runaway memory usage.
  */
 class AsyncLogger : public google::base::Logger {
  public:
@@ -125,71 +125,68 @@ class AsyncLogger : public google::base::Logger {
    */
   std::thread* LogThread() { return &log_thread_; }
 
+  /**
+   * @brief get the number of messages dropped because the ring of the
+   * writing thread stayed full
+   *
+   * @return the dropped message count
+   */
+  uint64_t DropCount() const {
+    return drop_count_.load(std::memory_order_relaxed);
+  }
+
  private:
-  // A buffered message.
-  //
-  // TODO(todd): using std::string for buffered messages is convenient but not
-  // as efficient as it could be. It's better to make the buffers just be
-  // Arenas and allocate both the message data and Msg struct from them, forming
-  // a linked list.
-  struct Msg {
-    time_t ts;
-    std::string message;
-    int32_t level;
-    Msg() : ts(0), message(), level(google::INFO) {}
-    Msg(time_t ts, std::string&& message, int32_t level)
-        : ts(ts), message(std::move(message)), level(level) {}
-    Msg(const Msg& rsh) {
-      ts = rsh.ts;
-      message = rsh.message;
-      level = rsh.level;
-    }
-    Msg(Msg&& rsh) {
-      ts = rsh.ts;
-      message = rsh.message;
-      level = rsh.level;
-    }
-    Msg& operator=(Msg&& rsh) {
-      ts = rsh.ts;
-      message = std::move(rsh.message);
-      level = rsh.level;
-      return *this;
-    }
-    Msg& operator=(const Msg& rsh) {
-      ts = rsh.ts;
-      message = rsh.message;
-      level = rsh.level;
-      return *this;
-    }
+  class LogRing;
+
+  // Lines of one module collected during a drain pass.
+  struct ModuleBatch {
+    LogFileObject* file = nullptr;
+    std::string lines;
+    time_t ts = 0;
+    bool force_flush = false;
   };
 
   void RunThread();
-  void FlushBuffer(const std::unique_ptr<std::deque<Msg>>& msg);
+  LogRing* ThreadRing();
+  // Drains every ring into the module batches and writes them, returns the
+  // number of bytes drained.
+  size_t FlushRings();
+  void AppendRecord(time_t ts, int32_t level, const char* message,
+                    size_t message_len);
+  void WriteBatches();
 
   google::base::Logger* const wrapped_;
   std::thread log_thread_;
 
+  // Tells the rings registered by the threads apart from the ones a thread
+  // still holds for a logger destroyed before.
+  const uint64_t id_;
+
   // Count of how many times the writer thread has flushed the buffers.
   // 64 bits should be enough to never worry about overflow.
   std::atomic<uint64_t> flush_count_ = {0};
 
   // Count of how many times the writer thread has dropped the log messages.
   // 64 bits should be enough to never worry about overflow.
-  uint64_t drop_count_ = 0;
-
-  // The buffer to which application threads append new log messages.
-  std::unique_ptr<std::deque<Msg>> active_buf_;
+  std::atomic<uint64_t> drop_count_ = {0};
 
-  // The buffer currently being flushed by the logger thread, cleared
-  // after a successful flush.
-  std::unique_ptr<std::deque<Msg>> flushing_buf_;
+  // Rings of all writing threads. The mutex is only taken to register a ring
+  // and by the logger thread to take a snapshot.
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<LogRing>> rings_;
+  std::vector<std::shared_ptr<LogRing>> drained_rings_;
 
   // Trigger for the logger thread to stop.
   enum State { INITTED, RUNNING, STOPPED };
   std::atomic<State> state_ = {INITTED};
-  std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+  // Serializes the drain of the logger thread with the one of Stop().
+  std::mutex flush_mutex_;
   std::unordered_map<std::string, std::unique_ptr<LogFileObject>>
       module_logger_map_;
+  std::unordered_map<std::string, ModuleBatch> module_batches_;
+  // module of the last drained line and its batch
+  std::string module_name_;
+  ModuleBatch* last_batch_ = nullptr;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncLogger);
 };
@@ -0,0 +1,213 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Cost of a log line for the writing threads, up to 32 of them logging at
+// once. BM_DequeLoggerWrite copies every line into a std::string queued in a
+// deque behind a spinlock the way AsyncLogger used to, BM_AsyncLoggerWrite
+// goes through the per thread rings of AsyncLogger. Both write the lines to
+// files in --log_dir, point it to a tmpfs to keep the disk out:
+//   async_logger_benchmark --log_dir=/dev/shm
+// CPU is what the writing threads spent, Time also includes the waits of
+// AsyncLogger writers for the logger thread to make room in their ring while
+// the deque just grows. dropped_lines counts the lines AsyncLogger gave up on
+// because the ring of the thread stayed full.
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+#include "cyber/base/macros.h"
+#include "cyber/common/log.h"
+#include "cyber/logger/async_logger.h"
+#include "cyber/logger/log_file_object.h"
+#include "cyber/logger/logger_util.h"
+
+DEFINE_int32(benchmark_line_num, 20000, "lines logged by every thread");
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+namespace {
+
+const char kLogLine[] =
+    "I0909 12:34:56.789012 12345 planning_component.cc:123] " LEFT_BRACKET
+    "planning" RIGHT_BRACKET
+    "reference line provider updated 3 lines in 1.25 ms, lane "
+    "1234_1_-1\n";
+
+// AsyncLogger before the per thread rings
+class DequeLogger {
+ public:
+  DequeLogger() {
+    active_buf_.reset(new std::deque<Msg>());
+    flushing_buf_.reset(new std::deque<Msg>());
+  }
+
+  void Start() {
+    running_ = true;
+    thread_ = std::thread(&DequeLogger::RunThread, this);
+  }
+
+  void Stop() {
+    running_ = false;
+    thread_.join();
+    FlushBuffer(active_buf_);
+  }
+
+  void Write(time_t timestamp, const char* message, int message_len) {
+    auto msg_str = std::string(message, message_len);
+    while (flag_.test_and_set(std::memory_order_acquire)) {
+      cpu_relax();
+    }
+    active_buf_->emplace_back(timestamp, std::move(msg_str),
+                              log_level_map_.at(message[0]));
+    flag_.clear(std::memory_order_release);
+  }
+
+ private:
+  struct Msg {
+    time_t ts;
+    std::string message;
+    int32_t level;
+    Msg(time_t ts, std::string&& message, int32_t level)
+        : ts(ts), message(std::move(message)), level(level) {}
+  };
+
+  void RunThread() {
+    while (running_) {
+      while (flag_.test_and_set(std::memory_order_acquire)) {
+        cpu_relax();
+      }
+      active_buf_.swap(flushing_buf_);
+      flag_.clear(std::memory_order_release);
+      FlushBuffer(flushing_buf_);
+      if (active_buf_->size() < 800) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  void FlushBuffer(const std::unique_ptr<std::deque<Msg>>& buffer) {
+    std::string module_name = "";
+    while (!buffer->empty()) {
+      auto& msg = buffer->front();
+      FindModuleName(&(msg.message), &module_name);
+      auto& module_logger = module_logger_map_[module_name];
+      if (module_logger == nullptr) {
+        std::string file_name = "deque_" + module_name + ".log.INFO.";
+        if (!FLAGS_log_dir.empty()) {
+          file_name = FLAGS_log_dir + "/" + file_name;
+        }
+        module_logger.reset(new LogFileObject(google::INFO, file_name.c_str()));
+      }
+      module_logger->Write(msg.level > 0, msg.ts, msg.message.data(),
+                           static_cast<int>(msg.message.size()));
+      buffer->pop_front();
+    }
+    for (auto& module_logger : module_logger_map_) {
+      module_logger.second->Flush();
+    }
+  }
+
+  const std::unordered_map<char, int> log_level_map_ = {
+      {'F', 3}, {'E', 2}, {'W', 1}, {'I', 0}};
+  std::unique_ptr<std::deque<Msg>> active_buf_;
+  std::unique_ptr<std::deque<Msg>> flushing_buf_;
+  std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+  std::atomic<bool> running_ = {false};
+  std::thread thread_;
+  std::unordered_map<std::string, std::unique_ptr<LogFileObject>>
+      module_logger_map_;
+};
+
+// started on first use and stopped in main once all benchmarks ran
+DequeLogger* SharedDequeLogger() {
+  static DequeLogger* logger = [] {
+    auto* deque_logger = new DequeLogger();
+    deque_logger->Start();
+    return deque_logger;
+  }();
+  return logger;
+}
+
+AsyncLogger* SharedAsyncLogger() {
+  static AsyncLogger* logger = [] {
+    auto* async_logger =
+        new AsyncLogger(google::base::GetLogger(google::INFO));
+    async_logger->Start();
+    return async_logger;
+  }();
+  return logger;
+}
+
+void BM_DequeLoggerWrite(benchmark::State& state) {
+  DequeLogger* logger = SharedDequeLogger();
+  const time_t timestamp = time(nullptr);
+  for (auto _ : state) {
+    for (int i = 0; i < FLAGS_benchmark_line_num; ++i) {
+      logger->Write(timestamp, kLogLine, sizeof(kLogLine) - 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * FLAGS_benchmark_line_num);
+}
+BENCHMARK(BM_DequeLoggerWrite)
+    ->Iterations(1)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->UseRealTime();
+
+void BM_AsyncLoggerWrite(benchmark::State& state) {
+  AsyncLogger* logger = SharedAsyncLogger();
+  const time_t timestamp = time(nullptr);
+  const uint64_t dropped = logger->DropCount();
+  for (auto _ : state) {
+    for (int i = 0; i < FLAGS_benchmark_line_num; ++i) {
+      logger->Write(false, timestamp, kLogLine, sizeof(kLogLine) - 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * FLAGS_benchmark_line_num);
+  state.counters["dropped_lines"] = benchmark::Counter(
+      static_cast<double>(logger->DropCount() - dropped),
+      benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_AsyncLoggerWrite)
+    ->Iterations(1)
+    ->Threads(1)
+    ->Threads(8)
+    ->Threads(32)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  apollo::cyber::logger::SharedDequeLogger()->Stop();
+  apollo::cyber::logger::SharedAsyncLogger()->Stop();
+  return 0;
+}
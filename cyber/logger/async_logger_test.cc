@@ -16,10 +16,18 @@
 
 #include "cyber/logger/async_logger.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "glog/logging.h"
 
+#include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 
 namespace apollo {
@@ -54,6 +62,101 @@ TEST(AsyncLoggerTest, WriteAndFlush) {
   logger.Stop();
 }
 
+TEST(AsyncLoggerTest, MultiThreadWrite) {
+  char log_dir[] = "/tmp/async_logger_test_XXXXXX";
+  ASSERT_NE(mkdtemp(log_dir), nullptr);
+  const std::string old_log_dir = FLAGS_log_dir;
+  FLAGS_log_dir = log_dir;
+
+  const int thread_num = 8;
+  // few enough lines to never fill the ring of a thread
+  const int line_num = 1000;
+  AsyncLogger logger(google::base::GetLogger(google::INFO));
+  logger.Start();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&logger, i]() {
+      time_t timep;
+      time(&timep);
+      for (int j = 0; j < line_num; ++j) {
+        std::string message =
+            "W0909 99:99:99.999999 99999 logger_test.cc:999] ";
+        message.append(LEFT_BRACKET);
+        message.append("AsyncLoggerTest3");
+        message.append(RIGHT_BRACKET);
+        message.append("thread " + std::to_string(i) + " line " +
+                       std::to_string(j) + "\n");
+        logger.Write(false, timep, message.c_str(),
+                     static_cast<int>(message.length()));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  logger.Stop();
+  EXPECT_EQ(logger.DropCount(), 0);
+
+  // every line once, in order within its thread and without the module tag
+  std::ifstream file(std::string(log_dir) + "/AsyncLoggerTest3.INFO");
+  ASSERT_TRUE(file.is_open());
+  std::vector<int> next_line(thread_num, 0);
+  std::string line;
+  int count = 0;
+  while (std::getline(file, line)) {
+    if (line[0] != 'W') {
+      continue;  // file header
+    }
+    EXPECT_EQ(line.find(LEFT_BRACKET), std::string::npos);
+    int thread = 0;
+    int index = 0;
+    ASSERT_EQ(sscanf(line.c_str() + line.find("] ") + 2, "thread %d line %d",
+                     &thread, &index),
+              2);
+    ASSERT_LT(thread, thread_num);
+    EXPECT_EQ(index, next_line[thread]++);
+    ++count;
+  }
+  EXPECT_EQ(count, thread_num * line_num);
+  FLAGS_log_dir = old_log_dir;
+}
+
+TEST(AsyncLoggerTest, EmptyModuleName) {
+  char log_dir[] = "/tmp/async_logger_test_XXXXXX";
+  ASSERT_NE(mkdtemp(log_dir), nullptr);
+  const std::string old_log_dir = FLAGS_log_dir;
+  FLAGS_log_dir = log_dir;
+  common::GlobalData::Instance()->SetProcessGroup("AsyncLoggerTest4");
+
+  // a line with an empty module tag goes to the log of the process group
+  AsyncLogger logger(google::base::GetLogger(google::INFO));
+  logger.Start();
+  time_t timep;
+  time(&timep);
+  std::string message = "I0909 99:99:99.999999 99999 logger_test.cc:999] ";
+  message.append(LEFT_BRACKET);
+  message.append(RIGHT_BRACKET);
+  message.append("empty module name\n");
+  logger.Write(false, timep, message.c_str(),
+               static_cast<int>(message.length()));
+  logger.Stop();
+
+  std::ifstream file(std::string(log_dir) + "/AsyncLoggerTest4.INFO");
+  ASSERT_TRUE(file.is_open());
+  std::string line;
+  int count = 0;
+  while (std::getline(file, line)) {
+    if (line[0] != 'I') {
+      continue;  // file header
+    }
+    EXPECT_EQ(line, "I0909 99:99:99.999999 99999 logger_test.cc:999] "
+                    "empty module name");
+    ++count;
+  }
+  EXPECT_EQ(count, 1);
+  FLAGS_log_dir = old_log_dir;
+}
+
 TEST(AsyncLoggerTest, SetLoggerToGlog) {
   google::InitGoogleLogging("AsyncLoggerTest2");
   google::SetLogDestination(google::ERROR, "");
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MESSAGE_LOANED_MESSAGE_H_
+#define CYBER_MESSAGE_LOANED_MESSAGE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "cyber/message/protobuf_factory.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+/**
+ * @brief A flat byte payload that may live outside of the message itself.
+ *
+ * A LoanedMessage either owns its bytes, or borrows them from an Owner that
+ * keeps the memory alive, e.g. a shared memory block lent by the shm
+ * transport. Borrowed payloads are how large messages (point clouds, images)
+ * travel without being copied: the writer fills the block in place and
+ * readers on the same host get a view of the very same block, which stays
+ * valid as long as any copy of the LoanedMessage is alive.
+ */
+class LoanedMessage {
+ public:
+  class Owner {
+   public:
+    virtual ~Owner() = default;
+  };
+
+  LoanedMessage() = default;
+
+  explicit LoanedMessage(std::size_t size) : buffer_(size, '\0') {
+    data_ = reinterpret_cast<uint8_t *>(&buffer_[0]);
+    size_ = size;
+    capacity_ = size;
+  }
+
+  explicit LoanedMessage(const std::string &data) : buffer_(data) {
+    data_ = reinterpret_cast<uint8_t *>(&buffer_[0]);
+    size_ = buffer_.size();
+    capacity_ = buffer_.size();
+  }
+
+  // Borrows `capacity` bytes at `data` from `owner`.
+  LoanedMessage(uint8_t *data, std::size_t size, std::size_t capacity,
+                const std::shared_ptr<Owner> &owner)
+      : data_(data), size_(size), capacity_(capacity), owner_(owner) {}
+
+  LoanedMessage(const LoanedMessage &other) { *this = other; }
+
+  LoanedMessage &operator=(const LoanedMessage &other) {
+    if (this == &other) {
+      return *this;
+    }
+    owner_ = other.owner_;
+    buffer_ = other.buffer_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    data_ = owner_ ? other.data_ : reinterpret_cast<uint8_t *>(&buffer_[0]);
+    return *this;
+  }
+
+  ~LoanedMessage() {}
+
+  const uint8_t *data() const { return data_; }
+  uint8_t *mutable_data() { return data_; }
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return capacity_; }
+  // Shrinks or grows the payload within its capacity.
+  bool set_size(std::size_t size) {
+    if (size > capacity_) {
+      return false;
+    }
+    size_ = size;
+    return true;
+  }
+
+  bool borrowed() const { return owner_ != nullptr; }
+  const std::shared_ptr<Owner> &owner() const { return owner_; }
+
+  class Descriptor {
+   public:
+    std::string full_name() const {
+      return "apollo.cyber.message.LoanedMessage";
+    }
+    std::string name() const { return "apollo.cyber.message.LoanedMessage"; }
+  };
+
+  static const Descriptor *descriptor() {
+    static Descriptor desc;
+    return &desc;
+  }
+
+  static void GetDescriptorString(const std::string &type,
+                                  std::string *desc_str) {
+    ProtobufFactory::Instance()->GetDescriptorString(type, desc_str);
+  }
+
+  bool SerializeToArray(void *data, int size) const {
+    if (data == nullptr || size < ByteSize()) {
+      return false;
+    }
+
+    if (size_ > 0) {
+      memcpy(data, data_, size_);
+    }
+    return true;
+  }
+
+  bool SerializeToString(std::string *str) const {
+    if (str == nullptr) {
+      return false;
+    }
+    str->assign(reinterpret_cast<const char *>(data_), size_);
+    return true;
+  }
+
+  // Parsing always leaves the message owning a copy of the bytes.
+  bool ParseFromArray(const void *data, int size) {
+    if (data == nullptr || size < 0) {
+      return false;
+    }
+
+    owner_ = nullptr;
+    buffer_.assign(reinterpret_cast<const char *>(data), size);
+    data_ = reinterpret_cast<uint8_t *>(&buffer_[0]);
+    size_ = buffer_.size();
+    capacity_ = buffer_.size();
+    return true;
+  }
+
+  bool ParseFromString(const std::string &str) {
+    return ParseFromArray(str.data(), static_cast<int>(str.size()));
+  }
+
+  int ByteSize() const { return static_cast<int>(size_); }
+
+  static std::string TypeName() { return "apollo.cyber.message.LoanedMessage"; }
+
+ private:
+  std::string buffer_;
+  uint8_t *data_ = reinterpret_cast<uint8_t *>(&buffer_[0]);
+  std::size_t size_ = 0;
+  std::size_t capacity_ = 0;
+  std::shared_ptr<Owner> owner_;
+};
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MESSAGE_LOANED_MESSAGE_H_
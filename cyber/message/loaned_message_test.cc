@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/message/loaned_message.h"
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+namespace {
+
+class CountingOwner : public LoanedMessage::Owner {
+ public:
+  explicit CountingOwner(int* released) : released_(released) {}
+  ~CountingOwner() override { ++*released_; }
+
+ private:
+  int* released_;
+};
+
+}  // namespace
+
+TEST(LoanedMessageTest, constructor) {
+  LoanedMessage msg_a;
+  EXPECT_EQ(msg_a.size(), 0);
+  EXPECT_FALSE(msg_a.borrowed());
+
+  LoanedMessage msg_b("loaned");
+  EXPECT_EQ(msg_b.size(), 6);
+  EXPECT_EQ(memcmp(msg_b.data(), "loaned", 6), 0);
+
+  LoanedMessage msg_c(16);
+  EXPECT_EQ(msg_c.size(), 16);
+  EXPECT_EQ(msg_c.capacity(), 16);
+  EXPECT_TRUE(msg_c.set_size(8));
+  EXPECT_FALSE(msg_c.set_size(17));
+  EXPECT_EQ(msg_c.ByteSize(), 8);
+}
+
+TEST(LoanedMessageTest, copy_owned) {
+  LoanedMessage msg_a("owned");
+  LoanedMessage msg_b(msg_a);
+  msg_a.mutable_data()[0] = 'O';
+  EXPECT_NE(msg_a.data(), msg_b.data());
+  EXPECT_EQ(memcmp(msg_b.data(), "owned", 5), 0);
+}
+
+TEST(LoanedMessageTest, borrowed) {
+  int released = 0;
+  uint8_t buf[32] = {0};
+  {
+    LoanedMessage msg_a(buf, 4, sizeof(buf),
+                        std::make_shared<CountingOwner>(&released));
+    EXPECT_TRUE(msg_a.borrowed());
+    memcpy(msg_a.mutable_data(), "view", 4);
+    EXPECT_EQ(memcmp(buf, "view", 4), 0);
+
+    LoanedMessage msg_b = msg_a;
+    EXPECT_EQ(msg_a.data(), msg_b.data());
+    EXPECT_TRUE(msg_a.set_size(32));
+    EXPECT_FALSE(msg_a.set_size(33));
+  }
+  EXPECT_EQ(released, 1);
+}
+
+TEST(LoanedMessageTest, serialize_and_parse) {
+  int released = 0;
+  uint8_t buf[16] = {0};
+  memcpy(buf, "serialize", 9);
+  LoanedMessage msg(buf, 9, sizeof(buf),
+                    std::make_shared<CountingOwner>(&released));
+  std::string str;
+  EXPECT_FALSE(msg.SerializeToString(nullptr));
+  EXPECT_TRUE(msg.SerializeToString(&str));
+  EXPECT_EQ(str, "serialize");
+  char array[8] = {0};
+  EXPECT_FALSE(msg.SerializeToArray(array, sizeof(array)));
+
+  // parsing drops the borrowed payload and owns a copy
+  EXPECT_TRUE(msg.ParseFromString("parsed"));
+  EXPECT_FALSE(msg.borrowed());
+  EXPECT_EQ(released, 1);
+  EXPECT_EQ(msg.size(), 6);
+  EXPECT_EQ(memcmp(msg.data(), "parsed", 6), 0);
+  EXPECT_FALSE(msg.ParseFromArray(nullptr, 1));
+}
+
+TEST(LoanedMessageTest, message_type) {
+  EXPECT_EQ(LoanedMessage::TypeName(), "apollo.cyber.message.LoanedMessage");
+}
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
@@ -21,6 +21,7 @@
 
 #include "cyber/base/macros.h"
 #include "cyber/common/log.h"
+#include "cyber/message/loaned_message_traits.h"
 #include "cyber/message/message_header.h"
 #include "cyber/message/protobuf_traits.h"
 #include "cyber/message/py_message_traits.h"
@@ -47,6 +47,7 @@ class Node {
   friend class Component;
   friend class TimerComponent;
   friend bool Init(const char*);
+  friend class SysMo;
   friend std::unique_ptr<Node> CreateNode(const std::string&,
                                           const std::string&);
   virtual ~Node();
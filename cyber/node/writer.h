@@ -19,11 +19,13 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "cyber/proto/topology_change.pb.h"
 
 #include "cyber/common/log.h"
+#include "cyber/message/loaned_message.h"
 #include "cyber/node/writer_base.h"
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/transport/transport.h"
@@ -84,6 +86,21 @@ class Writer : public WriterBase {
    */
   virtual bool Write(const std::shared_ptr<MessageT>& msg_ptr);
 
+  /**
+   * @brief Borrow a payload of `size` bytes to be filled in place, only for
+   * Writer<message::LoanedMessage>. When a reader in another process listens
+   * over shm, the payload is a block of the shm segment and writing the
+   * returned message publishes it without serializing or copying; readers
+   * get a LoanedMessage viewing the same block. Otherwise the payload is
+   * allocated on the heap and written like any other message.
+   * A lent block is held until every copy of the message is released, so
+   * don't keep loaned messages around longer than needed.
+   *
+   * @param size payload size in bytes
+   * @return the message to fill and write, nullptr if not initialized
+   */
+  std::shared_ptr<MessageT> Loan(std::size_t size);
+
   /**
    * @brief Is there any Reader that subscribes our Channel?
    * You can publish message when this return true
@@ -169,6 +186,18 @@ bool Writer<MessageT>::Write(const std::shared_ptr<MessageT>& msg_ptr) {
   return transmitter_->Transmit(msg_ptr);
 }
 
+template <typename MessageT>
+std::shared_ptr<MessageT> Writer<MessageT>::Loan(std::size_t size) {
+  static_assert(std::is_same<MessageT, message::LoanedMessage>::value,
+                "only LoanedMessage payloads can be lent");
+  RETURN_VAL_IF(!WriterBase::IsInit(), nullptr);
+  auto msg_ptr = transmitter_->Loan(size);
+  if (msg_ptr == nullptr) {
+    msg_ptr = std::make_shared<message::LoanedMessage>(size);
+  }
+  return msg_ptr;
+}
+
 template <typename MessageT>
 void Writer<MessageT>::JoinTheTopology() {
   // add listener
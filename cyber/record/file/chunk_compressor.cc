@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/chunk_compressor.h"
+
+#include <lz4.h>
+#include <zstd.h>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::CompressType;
+
+namespace {
+
+void PutRawSize(uint64_t raw_size, char* dst) {
+  for (size_t i = 0; i < ChunkCompressor::kRawSizeLength; ++i) {
+    dst[i] = static_cast<char>((raw_size >> (8 * i)) & 0xFF);
+  }
+}
+
+uint64_t GetRawSize(const char* src) {
+  uint64_t raw_size = 0;
+  for (size_t i = 0; i < ChunkCompressor::kRawSizeLength; ++i) {
+    raw_size |= static_cast<uint64_t>(static_cast<uint8_t>(src[i])) << (8 * i);
+  }
+  return raw_size;
+}
+
+}  // namespace
+
+bool ChunkCompressor::IsSupported(CompressType type) {
+  return type == CompressType::COMPRESS_NONE ||
+         type == CompressType::COMPRESS_LZ4 ||
+         type == CompressType::COMPRESS_ZSTD;
+}
+
+bool ChunkCompressor::Compress(CompressType type, const std::string& raw,
+                               std::string* compressed) {
+  const size_t offset = kRawSizeLength;
+  switch (type) {
+    case CompressType::COMPRESS_NONE: {
+      *compressed = raw;
+      return true;
+    }
+    case CompressType::COMPRESS_LZ4: {
+      if (raw.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        AERROR << "Chunk is too large for lz4, size: " << raw.size();
+        return false;
+      }
+      const int bound = LZ4_compressBound(static_cast<int>(raw.size()));
+      compressed->resize(offset + bound);
+      const int count = LZ4_compress_default(
+          raw.data(), &(*compressed)[offset], static_cast<int>(raw.size()),
+          bound);
+      if (count <= 0) {
+        AERROR << "lz4 compress failed, raw size: " << raw.size();
+        return false;
+      }
+      compressed->resize(offset + count);
+      break;
+    }
+    case CompressType::COMPRESS_ZSTD: {
+      const size_t bound = ZSTD_compressBound(raw.size());
+      compressed->resize(offset + bound);
+      const size_t count = ZSTD_compress(&(*compressed)[offset], bound,
+                                         raw.data(), raw.size(), kZstdLevel);
+      if (ZSTD_isError(count)) {
+        AERROR << "zstd compress failed: " << ZSTD_getErrorName(count);
+        return false;
+      }
+      compressed->resize(offset + count);
+      break;
+    }
+    default: {
+      AERROR << "Unsupported compress type: " << type;
+      return false;
+    }
+  }
+  PutRawSize(raw.size(), &(*compressed)[0]);
+  return true;
+}
+
+bool ChunkCompressor::Decompress(CompressType type, const char* data,
+                                 size_t size, std::string* raw) {
+  if (type == CompressType::COMPRESS_NONE) {
+    raw->assign(data, size);
+    return true;
+  }
+  if (!IsSupported(type)) {
+    AERROR << "Unsupported compress type: " << type;
+    return false;
+  }
+  if (size < kRawSizeLength) {
+    AERROR << "Compressed chunk is truncated, size: " << size;
+    return false;
+  }
+  const uint64_t raw_size = GetRawSize(data);
+  if (raw_size > kMaxRawSize) {
+    AERROR << "Compressed chunk claims invalid raw size: " << raw_size;
+    return false;
+  }
+  const char* payload = data + kRawSizeLength;
+  const size_t payload_size = size - kRawSizeLength;
+  raw->resize(raw_size);
+  if (type == CompressType::COMPRESS_LZ4) {
+    if (payload_size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE) ||
+        raw_size > static_cast<uint64_t>(LZ4_MAX_INPUT_SIZE)) {
+      AERROR << "Chunk is too large for lz4, size: " << payload_size;
+      return false;
+    }
+    const int count = LZ4_decompress_safe(
+        payload, &(*raw)[0], static_cast<int>(payload_size),
+        static_cast<int>(raw_size));
+    if (count < 0 || static_cast<uint64_t>(count) != raw_size) {
+      AERROR << "lz4 decompress failed, expect: " << raw_size
+             << ", actual: " << count;
+      return false;
+    }
+    return true;
+  }
+  const size_t count = ZSTD_decompress(&(*raw)[0], raw_size, payload,
+                                       payload_size);
+  if (ZSTD_isError(count)) {
+    AERROR << "zstd decompress failed: " << ZSTD_getErrorName(count);
+    return false;
+  }
+  if (count != raw_size) {
+    AERROR << "zstd decompress size mismatch, expect: " << raw_size
+           << ", actual: " << count;
+    return false;
+  }
+  return true;
+}
+
+bool ChunkCompressor::ParseCompressType(const std::string& name,
+                                        CompressType* type) {
+  if (name == "none") {
+    *type = CompressType::COMPRESS_NONE;
+  } else if (name == "lz4") {
+    *type = CompressType::COMPRESS_LZ4;
+  } else if (name == "zstd") {
+    *type = CompressType::COMPRESS_ZSTD;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,75 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_FILE_CHUNK_COMPRESSOR_H_
+#define CYBER_RECORD_FILE_CHUNK_COMPRESSOR_H_
+
+#include <cstdint>
+#include <string>
+
+#include "cyber/proto/record.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @brief Codec for chunk body sections.
+ *
+ * A compressed chunk body is stored as an 8-byte little-endian raw size
+ * followed by the codec payload, so the reader can size its output buffer
+ * without depending on codec specific framing.
+ */
+class ChunkCompressor {
+ public:
+  /**
+   * @brief Whether the given compress type is supported by this build.
+   */
+  static bool IsSupported(proto::CompressType type);
+
+  /**
+   * @brief Compress `raw` into `compressed` with the given codec.
+   *
+   * @return True for success, false for unsupported type or codec error.
+   */
+  static bool Compress(proto::CompressType type, const std::string& raw,
+                       std::string* compressed);
+
+  /**
+   * @brief Decompress `size` bytes at `data` into `raw`.
+   *
+   * @return True for success, false for unsupported type or corrupt data.
+   */
+  static bool Decompress(proto::CompressType type, const char* data,
+                         size_t size, std::string* raw);
+
+  /**
+   * @brief Parse a compress type name (none, lz4, zstd).
+   */
+  static bool ParseCompressType(const std::string& name,
+                                proto::CompressType* type);
+
+  static constexpr size_t kRawSizeLength = sizeof(uint64_t);
+  // Decompression refuses to allocate more than this for one chunk body.
+  static constexpr uint64_t kMaxRawSize = 4096ULL * 1024 * 1024;
+  static constexpr int kZstdLevel = 1;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_FILE_CHUNK_COMPRESSOR_H_
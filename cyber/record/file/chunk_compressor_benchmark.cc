@@ -0,0 +1,184 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Measures chunk body codec throughput (MB/s of raw chunk) and compression
+// ratio on synthetic chunks shaped like lidar point clouds and camera images.
+// cyber cannot depend on modules/common_msgs, so the payloads mimic the wire
+// layout of PointCloud (packed x/y/z/intensity/timestamp per point) and
+// Image (rgb8 pixel buffer) instead of serializing the real messages.
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/proto/record.pb.h"
+#include "cyber/record/file/chunk_compressor.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::ChunkBody;
+using apollo::cyber::proto::CompressType;
+
+namespace {
+
+constexpr uint64_t kBaseStampNs = 1600000000ULL * 1000 * 1000 * 1000;
+constexpr uint64_t kFrameIntervalNs = 100 * 1000 * 1000ULL;  // 10Hz
+// three frames of either kind add up to roughly one default 16MB chunk
+constexpr int kFramesPerChunk = 3;
+
+// 128 beams x 1800 azimuth steps, x/y/z/intensity as float, time as double.
+std::string MakePointCloud(std::mt19937* rng, uint64_t stamp_ns) {
+  constexpr int kBeams = 128;
+  constexpr int kSteps = 1800;
+  std::normal_distribution<float> noise(0.0f, 0.02f);
+  std::uniform_int_distribution<int> intensity(0, 255);
+  std::string content;
+  content.reserve(kBeams * kSteps * (4 * sizeof(float) + sizeof(double)));
+  for (int step = 0; step < kSteps; ++step) {
+    const double azimuth = 2.0 * M_PI * step / kSteps;
+    const double time = static_cast<double>(stamp_ns) * 1e-9 + step * 5.5e-5;
+    for (int beam = 0; beam < kBeams; ++beam) {
+      const double elevation = (-25.0 + 40.0 * beam / kBeams) * M_PI / 180.0;
+      const double range = 8.0 + 20.0 * std::fabs(std::sin(azimuth * 3.0));
+      float point[4] = {
+          static_cast<float>(range * std::cos(elevation) * std::cos(azimuth)) +
+              noise(*rng),
+          static_cast<float>(range * std::cos(elevation) * std::sin(azimuth)) +
+              noise(*rng),
+          static_cast<float>(range * std::sin(elevation)) + noise(*rng),
+          static_cast<float>(intensity(*rng))};
+      content.append(reinterpret_cast<const char*>(point), sizeof(point));
+      content.append(reinterpret_cast<const char*>(&time), sizeof(time));
+    }
+  }
+  return content;
+}
+
+// 1920x1080 rgb8 with smooth gradients plus sensor noise.
+std::string MakeImage(std::mt19937* rng) {
+  constexpr int kWidth = 1920;
+  constexpr int kHeight = 1080;
+  std::normal_distribution<float> noise(0.0f, 3.0f);
+  std::string content(kWidth * kHeight * 3, '\0');
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      const float base = 128.0f + 96.0f * std::sin(x * 0.01f + y * 0.004f);
+      for (int c = 0; c < 3; ++c) {
+        float v = base + c * 16.0f + noise(*rng);
+        v = std::fmin(255.0f, std::fmax(0.0f, v));
+        content[(y * kWidth + x) * 3 + c] = static_cast<char>(v);
+      }
+    }
+  }
+  return content;
+}
+
+std::string MakeChunk(bool point_cloud) {
+  std::mt19937 rng(42);
+  ChunkBody body;
+  for (int i = 0; i < kFramesPerChunk; ++i) {
+    auto* message = body.add_messages();
+    const uint64_t stamp = kBaseStampNs + i * kFrameIntervalNs;
+    message->set_time(stamp);
+    if (point_cloud) {
+      message->set_channel_name("/apollo/sensor/lidar128/PointCloud2");
+      message->set_content(MakePointCloud(&rng, stamp));
+    } else {
+      message->set_channel_name("/apollo/sensor/camera/front_6mm/image");
+      message->set_content(MakeImage(&rng));
+    }
+  }
+  return body.SerializeAsString();
+}
+
+const std::string& PointCloudChunk() {
+  static const std::string chunk = MakeChunk(true);
+  return chunk;
+}
+
+const std::string& ImageChunk() {
+  static const std::string chunk = MakeChunk(false);
+  return chunk;
+}
+
+void Compress(benchmark::State& state, const std::string& raw) {
+  const auto type = static_cast<CompressType>(state.range(0));
+  std::string compressed;
+  for (auto _ : state) {
+    ChunkCompressor::Compress(type, raw, &compressed);
+    benchmark::DoNotOptimize(compressed.data());
+  }
+  state.SetBytesProcessed(state.iterations() * raw.size());
+  state.counters["ratio"] =
+      static_cast<double>(raw.size()) / static_cast<double>(compressed.size());
+  state.SetLabel(proto::CompressType_Name(type));
+}
+
+void Decompress(benchmark::State& state, const std::string& raw) {
+  const auto type = static_cast<CompressType>(state.range(0));
+  std::string compressed;
+  ChunkCompressor::Compress(type, raw, &compressed);
+  std::string decompressed;
+  for (auto _ : state) {
+    ChunkCompressor::Decompress(type, compressed.data(), compressed.size(),
+                                &decompressed);
+    benchmark::DoNotOptimize(decompressed.data());
+  }
+  state.SetBytesProcessed(state.iterations() * raw.size());
+  state.counters["ratio"] =
+      static_cast<double>(raw.size()) / static_cast<double>(compressed.size());
+  state.SetLabel(proto::CompressType_Name(type));
+}
+
+void BM_CompressPointCloud(benchmark::State& state) {
+  Compress(state, PointCloudChunk());
+}
+
+void BM_DecompressPointCloud(benchmark::State& state) {
+  Decompress(state, PointCloudChunk());
+}
+
+void BM_CompressImage(benchmark::State& state) {
+  Compress(state, ImageChunk());
+}
+
+void BM_DecompressImage(benchmark::State& state) {
+  Decompress(state, ImageChunk());
+}
+
+void CodecArgs(benchmark::internal::Benchmark* b) {
+  b->Arg(CompressType::COMPRESS_LZ4)
+      ->Arg(CompressType::COMPRESS_ZSTD)
+      ->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK(BM_CompressPointCloud)->Apply(CodecArgs);
+BENCHMARK(BM_DecompressPointCloud)->Apply(CodecArgs);
+BENCHMARK(BM_CompressImage)->Apply(CodecArgs);
+BENCHMARK(BM_DecompressImage)->Apply(CodecArgs);
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/chunk_compressor.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::CompressType;
+
+TEST(ChunkCompressorTest, RoundTrip) {
+  std::string raw;
+  for (int i = 0; i < 100000; ++i) {
+    raw.push_back(static_cast<char>(i % 251));
+  }
+  for (CompressType type :
+       {CompressType::COMPRESS_NONE, CompressType::COMPRESS_LZ4,
+        CompressType::COMPRESS_ZSTD}) {
+    std::string compressed;
+    ASSERT_TRUE(ChunkCompressor::Compress(type, raw, &compressed));
+    std::string decompressed;
+    ASSERT_TRUE(ChunkCompressor::Decompress(type, compressed.data(),
+                                            compressed.size(), &decompressed));
+    EXPECT_EQ(raw, decompressed);
+    if (type != CompressType::COMPRESS_NONE) {
+      EXPECT_LT(compressed.size(), raw.size());
+    }
+  }
+}
+
+TEST(ChunkCompressorTest, EmptyInput) {
+  for (CompressType type :
+       {CompressType::COMPRESS_LZ4, CompressType::COMPRESS_ZSTD}) {
+    std::string compressed;
+    ASSERT_TRUE(ChunkCompressor::Compress(type, "", &compressed));
+    std::string decompressed = "garbage";
+    ASSERT_TRUE(ChunkCompressor::Decompress(type, compressed.data(),
+                                            compressed.size(), &decompressed));
+    EXPECT_TRUE(decompressed.empty());
+  }
+}
+
+TEST(ChunkCompressorTest, CorruptInput) {
+  std::string raw(4096, 'a');
+  for (CompressType type :
+       {CompressType::COMPRESS_LZ4, CompressType::COMPRESS_ZSTD}) {
+    std::string compressed;
+    ASSERT_TRUE(ChunkCompressor::Compress(type, raw, &compressed));
+    std::string decompressed;
+    EXPECT_FALSE(ChunkCompressor::Decompress(type, compressed.data(), 4,
+                                             &decompressed));
+    EXPECT_FALSE(ChunkCompressor::Decompress(
+        type, compressed.data(), compressed.size() - 1, &decompressed));
+  }
+}
+
+TEST(ChunkCompressorTest, UnsupportedType) {
+  EXPECT_FALSE(ChunkCompressor::IsSupported(CompressType::COMPRESS_BZ2));
+  std::string out;
+  EXPECT_FALSE(
+      ChunkCompressor::Compress(CompressType::COMPRESS_BZ2, "abc", &out));
+}
+
+TEST(ChunkCompressorTest, ParseCompressType) {
+  CompressType type;
+  ASSERT_TRUE(ChunkCompressor::ParseCompressType("lz4", &type));
+  EXPECT_EQ(CompressType::COMPRESS_LZ4, type);
+  ASSERT_TRUE(ChunkCompressor::ParseCompressType("zstd", &type));
+  EXPECT_EQ(CompressType::COMPRESS_ZSTD, type);
+  ASSERT_TRUE(ChunkCompressor::ParseCompressType("none", &type));
+  EXPECT_EQ(CompressType::COMPRESS_NONE, type);
+  EXPECT_FALSE(ChunkCompressor::ParseCompressType("bz2", &type));
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -17,6 +17,7 @@
 #include "cyber/record/file/record_file_reader.h"
 
 #include "cyber/common/file.h"
+#include "cyber/record/file/chunk_compressor.h"
 
 namespace apollo {
 namespace cyber {
@@ -42,6 +43,11 @@ bool RecordFileReader::Open(const std::string& path) {
     AERROR << "Read header section fail, file: " << path_;
     return false;
   }
+  if (!ChunkCompressor::IsSupported(header_.compress())) {
+    AERROR << "Unsupported compress type: " << header_.compress()
+           << ", file: " << path_;
+    return false;
+  }
   return true;
 }
 
@@ -132,6 +138,41 @@ bool RecordFileReader::ReadSection(Section* section) {
   return true;
 }
 
+bool RecordFileReader::ReadCompressedSection(
+    int64_t size, google::protobuf::Message* message) {
+  std::string compressed(size, '\0');
+  int64_t offset = 0;
+  while (offset < size) {
+    ssize_t count = read(fd_, &compressed[offset], size - offset);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AERROR << "Read fd failed, fd_: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    if (count == 0) {
+      end_of_file_ = true;
+      AERROR << "Compressed section is truncated, expect: " << size
+             << ", actual: " << offset;
+      return false;
+    }
+    offset += count;
+  }
+  std::string raw;
+  if (!ChunkCompressor::Decompress(header_.compress(), compressed.data(),
+                                   compressed.size(), &raw)) {
+    AERROR << "Decompress section failed, compress type: "
+           << header_.compress();
+    return false;
+  }
+  if (!message->ParseFromString(raw)) {
+    AERROR << "Parse decompressed section message failed.";
+    return false;
+  }
+  return true;
+}
+
 bool RecordFileReader::SkipSection(int64_t size) {
   int64_t pos = CurrentPosition();
   if (size > INT64_MAX - pos) {
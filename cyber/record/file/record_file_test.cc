@@ -33,6 +33,7 @@ namespace record {
 using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkHeader;
+using apollo::cyber::proto::CompressType;
 using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleMessage;
@@ -43,6 +44,7 @@ constexpr char kMsgType[] = "apollo.cyber.proto.Test";
 constexpr char kStr10B[] = "1234567890";
 constexpr char kTestFile1[] = "record_file_test_1.record";
 constexpr char kTestFile2[] = "record_file_test_2.record";
+constexpr char kTestFile3[] = "record_file_test_3.record";
 
 TEST(ChunkTest, TestAll) {
   Chunk ck;
@@ -282,6 +284,26 @@ TEST(RecordFileTest, TestIndex) {
     reader.ReadIndex();
     const auto& index = reader.GetIndex();
 
+    // the chunk header index tells which channels are in the chunk
+    int chunk_header_num = 0;
+    for (const auto& row : index.indexes()) {
+      if (row.type() != SectionType::SECTION_CHUNK_HEADER) {
+        continue;
+      }
+      ++chunk_header_num;
+      const auto& cache = row.chunk_header_cache();
+      ASSERT_EQ(2, cache.channel_cache_size());
+      EXPECT_EQ(kChan1, cache.channel_cache(0).name());
+      EXPECT_EQ(2, cache.channel_cache(0).message_number());
+      EXPECT_EQ(1e9, cache.channel_cache(0).begin_time());
+      EXPECT_EQ(3e9, cache.channel_cache(0).end_time());
+      EXPECT_EQ(kChan2, cache.channel_cache(1).name());
+      EXPECT_EQ(1, cache.channel_cache(1).message_number());
+      EXPECT_EQ(2e9, cache.channel_cache(1).begin_time());
+      EXPECT_EQ(2e9, cache.channel_cache(1).end_time());
+    }
+    EXPECT_EQ(1, chunk_header_num);
+
     // Walk through file the long way and check that the indexes match the
     // sections
     reader.Reset();
@@ -308,6 +330,66 @@ TEST(RecordFileTest, TestIndex) {
   }
 }
 
+TEST(RecordFileTest, TestCompressedChunk) {
+  const std::string content(64 * 1024, 'x');
+  for (CompressType type :
+       {CompressType::COMPRESS_LZ4, CompressType::COMPRESS_ZSTD}) {
+    {
+      RecordFileWriter rfw;
+      ASSERT_TRUE(rfw.Open(kTestFile3));
+      Header header = HeaderBuilder::GetHeaderWithChunkParams(0, 0);
+      header.set_segment_interval(0);
+      header.set_segment_raw_size(0);
+      header.set_compress(type);
+      ASSERT_TRUE(rfw.WriteHeader(header));
+
+      Channel chan1;
+      chan1.set_name(kChan1);
+      chan1.set_message_type(kMsgType);
+      chan1.set_proto_desc(kStr10B);
+      ASSERT_TRUE(rfw.WriteChannel(chan1));
+
+      for (int i = 1; i <= 3; ++i) {
+        SingleMessage msg;
+        msg.set_channel_name(chan1.name());
+        msg.set_content(content);
+        msg.set_time(i * 1e9);
+        ASSERT_TRUE(rfw.WriteMessage(msg));
+      }
+      rfw.Close();
+      ASSERT_TRUE(rfw.GetHeader().is_complete());
+      ASSERT_EQ(type, rfw.GetHeader().compress());
+      // the body compresses far below the raw message payload
+      ASSERT_LT(rfw.GetHeader().size(), content.size());
+    }
+    {
+      RecordFileReader rfr;
+      ASSERT_TRUE(rfr.Open(kTestFile3));
+      ASSERT_EQ(type, rfr.GetHeader().compress());
+
+      Section sec;
+      ASSERT_TRUE(rfr.ReadSection(&sec));
+      ASSERT_EQ(SectionType::SECTION_CHANNEL, sec.type);
+      ASSERT_TRUE(rfr.SkipSection(sec.size));
+
+      ASSERT_TRUE(rfr.ReadSection(&sec));
+      ASSERT_EQ(SectionType::SECTION_CHUNK_HEADER, sec.type);
+      ChunkHeader ckh;
+      ASSERT_TRUE(rfr.ReadSection<ChunkHeader>(sec.size, &ckh));
+      ASSERT_EQ(3, ckh.message_number());
+
+      ASSERT_TRUE(rfr.ReadSection(&sec));
+      ASSERT_EQ(SectionType::SECTION_CHUNK_BODY, sec.type);
+      ChunkBody ckb;
+      ASSERT_TRUE(rfr.ReadSection<ChunkBody>(sec.size, &ckb));
+      ASSERT_EQ(3, ckb.messages_size());
+      ASSERT_EQ(content, ckb.messages(2).content());
+      ASSERT_EQ(3e9, ckb.messages(2).time());
+    }
+    ASSERT_FALSE(remove(kTestFile3));
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -19,6 +19,7 @@
 #include <fcntl.h>
 
 #include "cyber/common/file.h"
+#include "cyber/record/file/chunk_compressor.h"
 #include "cyber/time/time.h"
 
 namespace apollo {
@@ -29,8 +30,10 @@ using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChannelCache;
 using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkBodyCache;
+using apollo::cyber::proto::ChunkChannelCache;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::ChunkHeaderCache;
+using apollo::cyber::proto::CompressType;
 using apollo::cyber::proto::Header;
 using apollo::cyber::proto::SectionType;
 using apollo::cyber::proto::SingleIndex;
@@ -118,6 +121,10 @@ void RecordFileWriter::Close() {
 }
 
 bool RecordFileWriter::WriteHeader(const Header& header) {
+  if (!ChunkCompressor::IsSupported(header.compress())) {
+    AERROR << "Unsupported compress type: " << header.compress();
+    return false;
+  }
   std::lock_guard<std::mutex> lock(mutex_);
   header_ = header;
   if (!WriteSection<Header>(header_)) {
@@ -168,8 +175,61 @@ bool RecordFileWriter::WriteChannel(const Channel& channel) {
   return true;
 }
 
+bool RecordFileWriter::WriteSection(SectionType type, const std::string& data) {
+  Section section;
+  /// zero out whole struct even if padded
+  memset(&section, 0, sizeof(section));
+  section = {type, static_cast<int64_t>(data.size())};
+  ssize_t count = write(fd_, &section, sizeof(section));
+  if (count < 0) {
+    AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+    return false;
+  }
+  if (count != sizeof(section)) {
+    AERROR << "Write fd failed, fd: " << fd_
+           << ", expect count: " << sizeof(section)
+           << ", actual count: " << count;
+    return false;
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    count = write(fd_, data.data() + written, data.size() - written);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    written += count;
+  }
+  header_.set_size(CurrentPosition());
+  return true;
+}
+
 bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
                                   const ChunkBody& chunk_body) {
+  // compress outside of the lock, this runs on the flush thread while the
+  // writer thread updates header_ under the lock
+  CompressType compress_type;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    compress_type = header_.compress();
+  }
+  std::string compressed_body;
+  if (compress_type != CompressType::COMPRESS_NONE) {
+    std::string raw_body;
+    if (!chunk_body.SerializeToString(&raw_body)) {
+      AERROR << "Serialize chunk body fail";
+      return false;
+    }
+    if (!ChunkCompressor::Compress(compress_type, raw_body,
+                                   &compressed_body)) {
+      AERROR << "Compress chunk body fail, compress type: " << compress_type;
+      return false;
+    }
+  }
+
   std::lock_guard<std::mutex> lock(mutex_);
   uint64_t pos = CurrentPosition();
   if (!WriteSection<ChunkHeader>(chunk_header)) {
@@ -184,10 +244,15 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   chunk_header_cache->set_end_time(chunk_header.end_time());
   chunk_header_cache->set_message_number(chunk_header.message_number());
   chunk_header_cache->set_raw_size(chunk_header.raw_size());
+  AddChunkChannelCache(chunk_body, chunk_header_cache);
   single_index->set_allocated_chunk_header_cache(chunk_header_cache);
 
   pos = CurrentPosition();
-  if (!WriteSection<ChunkBody>(chunk_body)) {
+  bool body_written =
+      compress_type == CompressType::COMPRESS_NONE
+          ? WriteSection<ChunkBody>(chunk_body)
+          : WriteSection(SectionType::SECTION_CHUNK_BODY, compressed_body);
+  if (!body_written) {
     AERROR << "Write chunk body fail";
     return false;
   }
@@ -207,6 +272,27 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   return true;
 }
 
+void RecordFileWriter::AddChunkChannelCache(
+    const ChunkBody& chunk_body, ChunkHeaderCache* chunk_header_cache) {
+  std::unordered_map<std::string, ChunkChannelCache*> channel_caches;
+  for (const auto& message : chunk_body.messages()) {
+    auto& channel_cache = channel_caches[message.channel_name()];
+    if (channel_cache == nullptr) {
+      channel_cache = chunk_header_cache->add_channel_cache();
+      channel_cache->set_name(message.channel_name());
+      channel_cache->set_begin_time(message.time());
+      channel_cache->set_end_time(message.time());
+    }
+    channel_cache->set_message_number(channel_cache->message_number() + 1);
+    if (channel_cache->begin_time() > message.time()) {
+      channel_cache->set_begin_time(message.time());
+    }
+    if (channel_cache->end_time() < message.time()) {
+      channel_cache->set_end_time(message.time());
+    }
+  }
+}
+
 bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
   chunk_active_->add(message);
   auto it = channel_message_number_map_.find(message.channel_name());
@@ -231,6 +317,11 @@ bool RecordFileWriter::WriteMessage(const proto::SingleMessage& message) {
   }
   {
     std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+    // the last chunk is not written yet, keep filling the active one rather
+    // than swapping the pending chunk back in, so chunks stay in time order
+    if (!chunk_flush_->empty()) {
+      return true;
+    }
     chunk_flush_.swap(chunk_active_);
     flush_cv_.notify_one();
   }
@@ -254,9 +345,16 @@ void RecordFileWriter::Flush() {
     }
     in_writing_ = false;
     chunk_flush_->clear();
+    flush_cv_.notify_all();
   }
 }
 
+void RecordFileWriter::WaitForFlush() {
+  std::unique_lock<std::mutex> flush_lock(flush_mutex_);
+  flush_cv_.wait(flush_lock,
+                 [this] { return !is_writing_ || chunk_flush_->empty(); });
+}
+
 uint64_t RecordFileWriter::GetMessageNumber(
     const std::string& channel_name) const {
   auto search = channel_message_number_map_.find(channel_name);
@@ -83,13 +83,21 @@ class RecordFileWriter : public RecordFileBase {
   bool WriteHeader(const proto::Header& header);
   bool WriteChannel(const proto::Channel& channel);
   bool WriteMessage(const proto::SingleMessage& message);
+  // Blocks until the chunk handed to the flush thread is written, a chunk
+  // due while one is still written is merged into the next one otherwise.
+  void WaitForFlush();
   uint64_t GetMessageNumber(const std::string& channel_name) const;
 
  private:
   bool WriteChunk(const proto::ChunkHeader& chunk_header,
                   const proto::ChunkBody& chunk_body);
+  // per-channel message number and time range of the chunk, so readers can
+  // skip chunks without the channels they want
+  static void AddChunkChannelCache(const proto::ChunkBody& chunk_body,
+                                   proto::ChunkHeaderCache* chunk_header_cache);
   template <typename T>
   bool WriteSection(const T& message);
+  bool WriteSection(proto::SectionType type, const std::string& data);
   bool WriteIndex();
   void Flush();
   std::atomic_bool is_writing_;
@@ -16,6 +16,7 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace apollo {
@@ -25,6 +26,7 @@ namespace record {
 using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkHeader;
+using apollo::cyber::proto::ChunkHeaderCache;
 using apollo::cyber::proto::SectionType;
 
 RecordReader::~RecordReader() {}
@@ -39,9 +41,29 @@ RecordReader::RecordReader(const std::string& file) {
   is_valid_ = true;
   header_ = file_reader_->GetHeader();
   if (file_reader_->ReadIndex()) {
+    has_index_ = true;
     index_ = file_reader_->GetIndex();
+    const ChunkHeaderCache* header_cache = nullptr;
     for (int i = 0; i < index_.indexes_size(); ++i) {
       auto single_idx = index_.mutable_indexes(i);
+      if (single_idx->type() == SectionType::SECTION_CHUNK_HEADER) {
+        header_cache = &single_idx->chunk_header_cache();
+        continue;
+      }
+      if (single_idx->type() == SectionType::SECTION_CHUNK_BODY) {
+        if (header_cache == nullptr) {
+          AERROR << "Chunk body index without chunk header index.";
+          continue;
+        }
+        ChunkIndex chunk;
+        chunk.begin_time = header_cache->begin_time();
+        chunk.end_time = header_cache->end_time();
+        chunk.body_position = single_idx->position();
+        chunk.header_cache = header_cache;
+        chunk_index_.push_back(chunk);
+        header_cache = nullptr;
+        continue;
+      }
       if (single_idx->type() != SectionType::SECTION_CHANNEL) {
         continue;
       }
@@ -62,6 +84,59 @@ void RecordReader::Reset() {
   reach_end_ = false;
   message_index_ = 0;
   chunk_.reset(new ChunkBody());
+  seeking_ = false;
+  seek_chunks_.clear();
+  seek_chunk_pos_ = 0;
+  seek_channels_.clear();
+}
+
+bool RecordReader::Seek(uint64_t begin_time, uint64_t end_time,
+                        const std::set<std::string>& channels) {
+  Reset();
+  seek_channels_ = channels;
+  if (!has_index_) {
+    return false;
+  }
+  seek_chunks_ = GetChunkIndex(begin_time, end_time, channels);
+  seeking_ = true;
+  ADEBUG << "Seek to " << seek_chunks_.size() << " of "
+         << chunk_index_.size() << " chunks, file: " << file_reader_->GetPath();
+  return true;
+}
+
+std::vector<RecordReader::ChunkIndex> RecordReader::GetChunkIndex(
+    uint64_t begin_time, uint64_t end_time,
+    const std::set<std::string>& channels) const {
+  std::vector<ChunkIndex> chunks;
+  for (const auto& chunk : chunk_index_) {
+    ChunkIndex selected = chunk;
+    // chunks of old records have no per-channel index and are kept whole
+    if (!channels.empty() && chunk.header_cache->channel_cache_size() > 0) {
+      bool has_channel = false;
+      for (const auto& channel_cache : chunk.header_cache->channel_cache()) {
+        if (channels.count(channel_cache.name()) == 0) {
+          continue;
+        }
+        if (!has_channel) {
+          selected.begin_time = channel_cache.begin_time();
+          selected.end_time = channel_cache.end_time();
+          has_channel = true;
+        }
+        selected.begin_time =
+            std::min(selected.begin_time, channel_cache.begin_time());
+        selected.end_time =
+            std::max(selected.end_time, channel_cache.end_time());
+      }
+      if (!has_channel) {
+        continue;
+      }
+    }
+    if (selected.end_time < begin_time || selected.begin_time > end_time) {
+      continue;
+    }
+    chunks.push_back(selected);
+  }
+  return chunks;
 }
 
 std::set<std::string> RecordReader::GetChannelList() const {
@@ -92,6 +167,10 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
     if (time < begin_time) {
       continue;
     }
+    if (!seek_channels_.empty() &&
+        seek_channels_.count(next_message.channel_name()) == 0) {
+      continue;
+    }
 
     message->channel_name = next_message.channel_name();
     message->content = next_message.content();
@@ -109,7 +188,43 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
   return false;
 }
 
+bool RecordReader::ReadSeekChunk(uint64_t begin_time, uint64_t end_time) {
+  while (seek_chunk_pos_ < seek_chunks_.size()) {
+    const auto& chunk = seek_chunks_[seek_chunk_pos_];
+    if (chunk.begin_time > end_time) {
+      return false;
+    }
+    ++seek_chunk_pos_;
+    if (chunk.end_time < begin_time) {
+      continue;
+    }
+    if (!file_reader_->SetPosition(chunk.body_position)) {
+      AERROR << "Failed to seek to chunk body at " << chunk.body_position
+             << ", file: " << file_reader_->GetPath();
+      return false;
+    }
+    Section section;
+    if (!file_reader_->ReadSection(&section) ||
+        section.type != SectionType::SECTION_CHUNK_BODY) {
+      AERROR << "No chunk body section at " << chunk.body_position
+             << ", file: " << file_reader_->GetPath();
+      return false;
+    }
+    chunk_.reset(new ChunkBody());
+    if (!file_reader_->ReadSection<ChunkBody>(section.size, chunk_.get())) {
+      AERROR << "Failed to read chunk body section.";
+      return false;
+    }
+    return true;
+  }
+  reach_end_ = true;
+  return false;
+}
+
 bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
+  if (seeking_) {
+    return ReadSeekChunk(begin_time, end_time);
+  }
   bool skip_next_chunk_body = false;
   while (!reach_end_) {
     Section section;
@@ -22,6 +22,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/proto/record.pb.h"
 
@@ -41,6 +42,13 @@ class RecordReader : public RecordBase {
   using FileReaderPtr = std::unique_ptr<RecordFileReader>;
   using ChannelInfoMap = std::unordered_map<std::string, proto::ChannelCache>;
 
+  struct ChunkIndex {
+    uint64_t begin_time = 0;
+    uint64_t end_time = 0;
+    int64_t body_position = 0;
+    const proto::ChunkHeaderCache* header_cache = nullptr;
+  };
+
   /**
    * @brief The constructor with record file path as parameter.
    *
@@ -73,10 +81,42 @@ class RecordReader : public RecordBase {
                    uint64_t end_time = std::numeric_limits<uint64_t>::max());
 
   /**
-   * @brief Reset the message index of record reader.
+   * @brief Reset the message index of record reader, later reads go through
+   * all chunks again.
    */
   void Reset();
 
+  /**
+   * @brief Restart reading at the chunks that hold messages of the channels
+   * within [begin_time, end_time]. They are looked up in the chunk index, the
+   * other chunks are never read from disk. Messages of other channels are
+   * dropped until the next Reset().
+   *
+   * @param begin_time
+   * @param end_time
+   * @param channels all channels if empty
+   *
+   * @return False if the record has no index, its chunks are then still read
+   * one after another.
+   */
+  bool Seek(uint64_t begin_time, uint64_t end_time,
+            const std::set<std::string>& channels = {});
+
+  /**
+   * @brief Get the chunks that hold messages of the channels within
+   * [begin_time, end_time] from the chunk index, in file order. Their times
+   * are narrowed to the given channels.
+   *
+   * @param begin_time
+   * @param end_time
+   * @param channels all channels if empty
+   *
+   * @return The chunks, empty if the record has no index.
+   */
+  std::vector<ChunkIndex> GetChunkIndex(
+      uint64_t begin_time, uint64_t end_time,
+      const std::set<std::string>& channels = {}) const;
+
   /**
    * @brief Get message number by channel name.
    *
@@ -115,9 +155,18 @@ class RecordReader : public RecordBase {
 
  private:
   bool ReadNextChunk(uint64_t begin_time, uint64_t end_time);
+  bool ReadSeekChunk(uint64_t begin_time, uint64_t end_time);
 
   bool is_valid_ = false;
+  bool has_index_ = false;
   bool reach_end_ = false;
+  // chunks in file order, from index_
+  std::vector<ChunkIndex> chunk_index_;
+  // chunks left to read after Seek(), their times narrowed to the channels
+  bool seeking_ = false;
+  std::vector<ChunkIndex> seek_chunks_;
+  size_t seek_chunk_pos_ = 0;
+  std::set<std::string> seek_channels_;
   std::unique_ptr<proto::ChunkBody> chunk_ = nullptr;
   proto::Index index_;
   int message_index_ = 0;
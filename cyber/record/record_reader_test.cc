@@ -16,7 +16,9 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -29,6 +31,7 @@ namespace record {
 using apollo::cyber::message::RawMessage;
 
 constexpr char kChannelName1[] = "/test/channel1";
+constexpr char kChannelName2[] = "/test/channel2";
 constexpr char kMessageType1[] = "apollo.cyber.proto.Test";
 constexpr char kProtoDesc[] = "1234567890";
 constexpr char kStr10B[] = "1234567890";
@@ -122,6 +125,63 @@ TEST(RecordTest, TestReaderOrder) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, TestSeek) {
+  // small chunks, channel2 only shows up in the middle of the record
+  RecordWriter writer(HeaderBuilder::GetHeaderWithChunkParams(8, 0));
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  writer.Open(kTestFile);
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName2, kMessageType1, kProtoDesc);
+  for (uint64_t i = 1; i <= 100; ++i) {
+    writer.WriteMessage(kChannelName1, std::make_shared<RawMessage>(kStr10B),
+                        i);
+    if (i >= 50 && i <= 60 && i % 5 == 0) {
+      writer.WriteMessage(kChannelName2,
+                          std::make_shared<RawMessage>(std::to_string(i)), i);
+    }
+  }
+  writer.Close();
+
+  RecordReader reader(kTestFile);
+  RecordMessage message;
+  const uint64_t kMaxTime = std::numeric_limits<uint64_t>::max();
+
+  // sparse channel over the whole record
+  ASSERT_TRUE(reader.Seek(0, kMaxTime, {kChannelName2}));
+  std::vector<uint64_t> times;
+  while (reader.ReadMessage(&message)) {
+    EXPECT_EQ(kChannelName2, message.channel_name);
+    EXPECT_EQ(std::to_string(message.time), message.content);
+    times.push_back(message.time);
+  }
+  EXPECT_EQ(std::vector<uint64_t>({50, 55, 60}), times);
+
+  // time window of all channels
+  ASSERT_TRUE(reader.Seek(20, 30));
+  times.clear();
+  while (reader.ReadMessage(&message, 20, 30)) {
+    EXPECT_EQ(kChannelName1, message.channel_name);
+    times.push_back(message.time);
+  }
+  ASSERT_EQ(11, times.size());
+  EXPECT_EQ(20, times.front());
+  EXPECT_EQ(30, times.back());
+
+  // nothing of channel2 in the window
+  ASSERT_TRUE(reader.Seek(20, 30, {kChannelName2}));
+  EXPECT_FALSE(reader.ReadMessage(&message, 20, 30));
+
+  // reset reads everything again
+  reader.Reset();
+  uint32_t count = 0;
+  while (reader.ReadMessage(&message)) {
+    ++count;
+  }
+  EXPECT_EQ(103, count);
+  ASSERT_FALSE(remove(kTestFile));
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
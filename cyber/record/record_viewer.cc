@@ -106,7 +106,8 @@ void RecordViewer::Init() {
 
 void RecordViewer::Reset() {
   for (auto& reader : readers_) {
-    reader->Reset();
+    // only the chunks of the wanted channels and time range are read
+    reader->Seek(begin_time_, end_time_, channels_);
   }
   std::fill(readers_finished_.begin(), readers_finished_.end(), false);
   curr_begin_time_ = begin_time_;
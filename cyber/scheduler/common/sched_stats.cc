@@ -0,0 +1,242 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/sched_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+int Histogram::BucketIndex(uint64_t value) {
+  if (value < 2 * kSubBucketCount) {
+    return static_cast<int>(value);
+  }
+  const int exponent = 63 - __builtin_clzll(value);
+  if (exponent >= kMaxValueBits) {
+    return kBucketCount - 1;
+  }
+  const int sub = static_cast<int>(value >> (exponent - kSubBucketBits)) &
+                  (kSubBucketCount - 1);
+  return (exponent - kSubBucketBits + 1) * kSubBucketCount + sub;
+}
+
+uint64_t Histogram::BucketLowerBound(int index) {
+  if (index < 2 * kSubBucketCount) {
+    return static_cast<uint64_t>(index);
+  }
+  const int exponent = index / kSubBucketCount + kSubBucketBits - 1;
+  const uint64_t sub = index % kSubBucketCount;
+  return (kSubBucketCount + sub) << (exponent - kSubBucketBits);
+}
+
+uint64_t Histogram::BucketUpperBound(int index) {
+  return BucketLowerBound(index + 1);
+}
+
+void HistogramSnapshot::Load(const Histogram& histogram) {
+  for (int i = 0; i < Histogram::kBucketCount; ++i) {
+    counts[i] = histogram.buckets_[i].load(std::memory_order_relaxed);
+  }
+  sum = histogram.sum_.load(std::memory_order_relaxed);
+}
+
+void HistogramSnapshot::Merge(const HistogramSnapshot& other) {
+  for (int i = 0; i < Histogram::kBucketCount; ++i) {
+    counts[i] += other.counts[i];
+  }
+  sum += other.sum;
+}
+
+void HistogramSnapshot::Subtract(const HistogramSnapshot& earlier) {
+  for (int i = 0; i < Histogram::kBucketCount; ++i) {
+    counts[i] -= std::min(counts[i], earlier.counts[i]);
+  }
+  sum -= std::min(sum, earlier.sum);
+}
+
+uint64_t HistogramSnapshot::Count() const {
+  uint64_t count = 0;
+  for (auto c : counts) {
+    count += c;
+  }
+  return count;
+}
+
+uint64_t HistogramSnapshot::Percentile(double quantile) const {
+  const uint64_t count = Count();
+  if (count == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(
+             std::ceil(quantile * static_cast<double>(count))));
+  uint64_t seen = 0;
+  for (int i = 0; i < Histogram::kBucketCount; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return Histogram::BucketUpperBound(i) - 1;
+    }
+  }
+  return Histogram::BucketUpperBound(Histogram::kBucketCount - 1) - 1;
+}
+
+void HistogramSnapshot::ToProto(proto::SchedHistogram* histogram) const {
+  histogram->Clear();
+  histogram->set_count(Count());
+  histogram->set_sum_ns(sum);
+  histogram->set_p50_ns(Percentile(0.5));
+  histogram->set_p90_ns(Percentile(0.9));
+  histogram->set_p99_ns(Percentile(0.99));
+  histogram->set_max_ns(Percentile(1.0));
+  for (int i = 0; i < Histogram::kBucketCount; ++i) {
+    if (counts[i] != 0) {
+      histogram->add_bucket_lower_ns(Histogram::BucketLowerBound(i));
+      histogram->add_bucket_upper_ns(Histogram::BucketUpperBound(i));
+      histogram->add_bucket_count(counts[i]);
+    }
+  }
+}
+
+ProcessorStats::~ProcessorStats() {
+  for (auto& slot : slots_) {
+    delete slot.load();
+  }
+}
+
+RoutineState ProcessorStats::Resume(CRoutine* cr) {
+  auto stats = Find(*cr);
+  const uint64_t wake = cr->TakeWakeTime();
+  const uint64_t start = SteadyNowNs();
+  auto state = cr->Resume();
+  const uint64_t end = SteadyNowNs();
+  if (state == RoutineState::READY) {
+    // yielded while still runnable, it waits again from now on
+    cr->MarkWakeTime(end);
+  }
+
+  if (cyber_likely(stats != nullptr)) {
+    if (wake != 0) {
+      stats->wake_to_run.Record(start > wake ? start - wake : 0);
+    }
+    stats->run_time.Record(end - start);
+    if (state == RoutineState::READY) {
+      stats->yields.store(stats->yields.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+    }
+  }
+  return state;
+}
+
+RoutineStats* ProcessorStats::Find(const CRoutine& cr) {
+  if (last_ != nullptr && last_->id == cr.id()) {
+    return last_;
+  }
+  const size_t index = cr.id() % kMaxRoutines;
+  for (size_t i = 0; i < kMaxRoutines; ++i) {
+    auto& slot = slots_[(index + i) % kMaxRoutines];
+    auto stats = slot.load(std::memory_order_relaxed);
+    if (stats == nullptr) {
+      stats = new RoutineStats(cr.id(), cr.name());
+      slot.store(stats, std::memory_order_release);
+      last_ = stats;
+      return stats;
+    }
+    if (stats->id == cr.id()) {
+      last_ = stats;
+      return stats;
+    }
+  }
+  if (!full_) {
+    full_ = true;
+    AWARN << "sched stats of processor " << tid() << " are full, "
+          << cr.name() << " and later croutines are not recorded.";
+  }
+  return nullptr;
+}
+
+void SchedStatsCollector::Collect(
+    const std::vector<std::shared_ptr<ProcessorStats>>& procs,
+    proto::SchedStats* stats) {
+  const uint64_t now = SteadyNowNs();
+  std::unordered_map<uint64_t, Totals> totals;
+  std::unordered_map<pid_t, ProcTotals> proc_totals;
+  HistogramSnapshot snapshot;
+  for (auto& proc : procs) {
+    auto& proc_total = proc_totals[proc->tid()];
+    proc->ForEach([&](const RoutineStats& routine) {
+      auto& total = totals[routine.id];
+      total.name = routine.name;
+      total.yields += routine.yields.load(std::memory_order_relaxed);
+      snapshot.Load(routine.wake_to_run);
+      total.wake_to_run.Merge(snapshot);
+      snapshot.Load(routine.run_time);
+      total.run_time.Merge(snapshot);
+      proc_total.runs += snapshot.Count();
+      proc_total.busy_ns += snapshot.sum;
+    });
+  }
+
+  for (auto& proc : procs) {
+    auto& total = proc_totals[proc->tid()];
+    auto& last = last_procs_[proc->tid()];
+    auto proc_stats = stats->add_processors();
+    proc_stats->set_tid(proc->tid());
+    proc_stats->set_run_count(total.runs - std::min(total.runs, last.runs));
+    proc_stats->set_busy_ns(total.busy_ns -
+                            std::min(total.busy_ns, last.busy_ns));
+  }
+
+  std::vector<const std::pair<const uint64_t, Totals>*> sorted;
+  sorted.reserve(totals.size());
+  for (auto& item : totals) {
+    sorted.emplace_back(&item);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) {
+    return a->second.name < b->second.name;
+  });
+
+  for (auto item : sorted) {
+    Totals interval = item->second;
+    auto last = last_.find(item->first);
+    if (last != last_.end()) {
+      interval.yields -= std::min(interval.yields, last->second.yields);
+      interval.wake_to_run.Subtract(last->second.wake_to_run);
+      interval.run_time.Subtract(last->second.run_time);
+    }
+    auto routine = stats->add_croutines();
+    routine->set_name(interval.name);
+    routine->set_id(item->first);
+    routine->set_run_count(interval.run_time.Count());
+    routine->set_yield_count(interval.yields);
+    interval.wake_to_run.ToProto(routine->mutable_wake_to_run());
+    interval.run_time.ToProto(routine->mutable_run_time());
+  }
+
+  stats->set_interval_ns(last_time_ == 0 ? 0 : now - last_time_);
+  last_ = std::move(totals);
+  last_procs_ = std::move(proc_totals);
+  last_time_ = now;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_COMMON_SCHED_STATS_H_
+#define CYBER_SCHEDULER_COMMON_SCHED_STATS_H_
+
+#include <sys/types.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/proto/sched_stats.pb.h"
+
+#include "cyber/croutine/croutine.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using croutine::CRoutine;
+using croutine::RoutineState;
+
+inline uint64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Log-linear histogram of nanosecond samples: exact below 16ns, then 8
+// sub-buckets per power of two (<= 12.5% error) up to 2^40ns (~18 min).
+// Single writer, any number of readers, no locks.
+class Histogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr int kMaxValueBits = 40;
+  static constexpr int kBucketCount =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+  static int BucketIndex(uint64_t value);
+  static uint64_t BucketLowerBound(int index);
+  static uint64_t BucketUpperBound(int index);
+
+  // only called by the owning processor thread
+  void Record(uint64_t value) {
+    auto& bucket = buckets_[BucketIndex(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value,
+               std::memory_order_relaxed);
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_ = {};
+  std::atomic<uint64_t> sum_ = {0};
+
+  friend struct HistogramSnapshot;
+};
+
+struct HistogramSnapshot {
+  void Load(const Histogram& histogram);
+  void Merge(const HistogramSnapshot& other);
+  void Subtract(const HistogramSnapshot& earlier);
+
+  uint64_t Count() const;
+  // upper bound of the bucket holding the given quantile, 0 when empty
+  uint64_t Percentile(double quantile) const;
+  void ToProto(proto::SchedHistogram* histogram) const;
+
+  std::array<uint64_t, Histogram::kBucketCount> counts = {};
+  uint64_t sum = 0;
+};
+
+struct RoutineStats {
+  RoutineStats(uint64_t id, const std::string& name) : id(id), name(name) {}
+
+  const uint64_t id;
+  const std::string name;
+  Histogram wake_to_run;
+  Histogram run_time;
+  std::atomic<uint64_t> yields = {0};
+};
+
+// Stats of the croutines run by one processor. The processor thread is the
+// only writer; entries are never removed, so readers can walk the table while
+// it is being filled.
+class ProcessorStats {
+ public:
+  static constexpr size_t kMaxRoutines = 512;
+
+  ProcessorStats() = default;
+  ~ProcessorStats();
+
+  void set_tid(pid_t tid) { tid_.store(tid); }
+  pid_t tid() const { return tid_.load(); }
+
+  // Resumes the croutine and records how long it waited and ran.
+  RoutineState Resume(CRoutine* cr);
+
+  template <typename Func>
+  void ForEach(Func&& func) const {
+    for (auto& slot : slots_) {
+      auto stats = slot.load(std::memory_order_acquire);
+      if (stats != nullptr) {
+        func(*stats);
+      }
+    }
+  }
+
+ private:
+  ProcessorStats(const ProcessorStats&) = delete;
+  ProcessorStats& operator=(const ProcessorStats&) = delete;
+
+  RoutineStats* Find(const CRoutine& cr);
+
+  std::array<std::atomic<RoutineStats*>, kMaxRoutines> slots_ = {};
+  RoutineStats* last_ = nullptr;
+  bool full_ = false;
+  std::atomic<pid_t> tid_ = {-1};
+};
+
+// Turns the cumulative per processor counters into per croutine interval
+// stats. Keeps the previous totals, so use one collector per consumer.
+class SchedStatsCollector {
+ public:
+  void Collect(const std::vector<std::shared_ptr<ProcessorStats>>& procs,
+               proto::SchedStats* stats);
+
+ private:
+  struct Totals {
+    std::string name;
+    uint64_t yields = 0;
+    HistogramSnapshot wake_to_run;
+    HistogramSnapshot run_time;
+  };
+
+  struct ProcTotals {
+    uint64_t runs = 0;
+    uint64_t busy_ns = 0;
+  };
+
+  std::unordered_map<uint64_t, Totals> last_;
+  std::unordered_map<pid_t, ProcTotals> last_procs_;
+  uint64_t last_time_ = 0;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_COMMON_SCHED_STATS_H_
@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/common/sched_stats.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+TEST(SchedStatsTest, bucket_bounds) {
+  for (uint64_t v = 0; v < 16; ++v) {
+    EXPECT_EQ(v, Histogram::BucketLowerBound(Histogram::BucketIndex(v)));
+  }
+  for (uint64_t v : {16ULL, 17ULL, 1000ULL, 123456ULL, 987654321ULL}) {
+    int index = Histogram::BucketIndex(v);
+    EXPECT_LE(Histogram::BucketLowerBound(index), v);
+    EXPECT_GT(Histogram::BucketUpperBound(index), v);
+    // 8 sub-buckets per power of two
+    EXPECT_LE(Histogram::BucketUpperBound(index) -
+                  Histogram::BucketLowerBound(index),
+              v / 8 + 1);
+  }
+  EXPECT_EQ(Histogram::kBucketCount - 1,
+            Histogram::BucketIndex(~static_cast<uint64_t>(0)));
+  EXPECT_EQ(1ULL << Histogram::kMaxValueBits,
+            Histogram::BucketUpperBound(Histogram::kBucketCount - 1));
+}
+
+TEST(SchedStatsTest, percentile) {
+  Histogram histogram;
+  for (uint64_t v = 1; v <= 100; ++v) {
+    histogram.Record(v * 1000);
+  }
+  HistogramSnapshot snapshot;
+  snapshot.Load(histogram);
+  EXPECT_EQ(100, snapshot.Count());
+  EXPECT_EQ(5050000, snapshot.sum);
+  EXPECT_NEAR(50000, snapshot.Percentile(0.5), 50000 / 8);
+  EXPECT_NEAR(99000, snapshot.Percentile(0.99), 99000 / 8);
+  EXPECT_GE(snapshot.Percentile(1.0), 100000);
+
+  HistogramSnapshot earlier = snapshot;
+  histogram.Record(7);
+  snapshot.Load(histogram);
+  snapshot.Subtract(earlier);
+  EXPECT_EQ(1, snapshot.Count());
+  EXPECT_EQ(7, snapshot.Percentile(0.5));
+
+  proto::SchedHistogram msg;
+  snapshot.ToProto(&msg);
+  EXPECT_EQ(1, msg.count());
+  ASSERT_EQ(1, msg.bucket_count_size());
+  EXPECT_EQ(7, msg.bucket_lower_ns(0));
+  EXPECT_EQ(8, msg.bucket_upper_ns(0));
+}
+
+TEST(SchedStatsTest, processor_stats) {
+  auto cr = std::make_shared<CRoutine>([]() {
+    CRoutine::Yield();
+    CRoutine::Yield(RoutineState::DATA_WAIT);
+  });
+  cr->set_id(42);
+  cr->set_name("stats_test");
+
+  auto proc = std::make_shared<ProcessorStats>();
+  proc->set_tid(1);
+  cr->MarkWakeTime(SteadyNowNs() - 1000000);
+  EXPECT_EQ(RoutineState::READY, proc->Resume(cr.get()));
+  EXPECT_EQ(RoutineState::DATA_WAIT, proc->Resume(cr.get()));
+
+  SchedStatsCollector collector;
+  proto::SchedStats stats;
+  collector.Collect({proc}, &stats);
+  ASSERT_EQ(1, stats.croutines_size());
+  const auto& routine = stats.croutines(0);
+  EXPECT_EQ("stats_test", routine.name());
+  EXPECT_EQ(42, routine.id());
+  EXPECT_EQ(2, routine.run_count());
+  EXPECT_EQ(1, routine.yield_count());
+  // the first resume waited 1ms, the second one since the yield
+  EXPECT_EQ(2, routine.wake_to_run().count());
+  EXPECT_GE(routine.wake_to_run().max_ns(), 1000000);
+  ASSERT_EQ(1, stats.processors_size());
+  EXPECT_EQ(2, stats.processors(0).run_count());
+
+  // nothing ran since the last collection
+  stats.Clear();
+  collector.Collect({proc}, &stats);
+  ASSERT_EQ(1, stats.croutines_size());
+  EXPECT_EQ(0, stats.croutines(0).run_count());
+  EXPECT_EQ(0, stats.croutines(0).wake_to_run().count());
+  EXPECT_EQ(0, stats.processors(0).run_count());
+  EXPECT_GT(stats.interval_ns(), 0);
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,274 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/work_stealing_context.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+namespace {
+
+bool HasReady(const StealGroup* group) {
+  for (auto& ready : group->ready) {
+    if (ready.load() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+WorkStealingContext::WorkStealingContext(StealGroup* group, int index)
+    : group_(group), index_(index) {}
+
+std::shared_ptr<CRoutine> WorkStealingContext::NextRoutine() {
+  if (cyber_unlikely(stop_.load())) {
+    return nullptr;
+  }
+
+  // the processor released the routine it ran last, put it where it belongs
+  if (running_ != nullptr) {
+    Settle(running_);
+    running_ = nullptr;
+  }
+  WakeSleepers();
+
+  for (auto task = Pop(); task != nullptr; task = Pop()) {
+    int expected = StealTask::QUEUED;
+    if (!task->state().compare_exchange_strong(expected,
+                                               StealTask::RUNNING)) {
+      continue;
+    }
+    auto& cr = task->cr();
+    if (!cr->Acquire()) {
+      // being removed
+      continue;
+    }
+    if (task->state().load() == StealTask::REMOVED) {
+      cr->Release();
+      continue;
+    }
+    task->last_proc().store(index_);
+    if (cr->UpdateState() == RoutineState::READY) {
+      running_ = task;
+      return cr;
+    }
+    cr->Release();
+    Settle(task);
+  }
+  return nullptr;
+}
+
+void WorkStealingContext::Wait() {
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+  if (!sleepers_.empty()) {
+    deadline = std::min(deadline, sleepers_.begin()->first);
+  }
+
+  std::unique_lock<std::mutex> lk(mtx_wq_);
+  idle_.store(true);
+  // pairs with Enqueue, which bumps the ready count before looking for idle
+  // processors, so one of the two always sees the other
+  if (!HasReady(group_)) {
+    cv_wq_.wait_until(lk, deadline, [this]() {
+      return notified_ || stop_.load() || HasReady(group_);
+    });
+  }
+  notified_ = false;
+  idle_.store(false);
+}
+
+void WorkStealingContext::Shutdown() {
+  stop_.store(true);
+  Notify();
+}
+
+void WorkStealingContext::Enqueue(StealGroup* group,
+                                  const StealTaskPtr& task) {
+  auto& state = task->state();
+  int expected = state.load();
+  while (true) {
+    if (expected == StealTask::IDLE) {
+      if (state.compare_exchange_weak(expected, StealTask::QUEUED)) {
+        break;
+      }
+    } else if (expected == StealTask::RUNNING) {
+      // the processor running it queues it again once it yields
+      if (state.compare_exchange_weak(expected, StealTask::NOTIFIED)) {
+        return;
+      }
+    } else {
+      // already queued or notified, sleeping until its wake time, or removed
+      return;
+    }
+  }
+
+  auto& contexts = group->contexts;
+  const int size = static_cast<int>(contexts.size());
+  int target = task->last_proc().load();
+  if (target < 0 || target >= size) {
+    target = static_cast<int>(group->next.fetch_add(1) % size);
+  }
+  contexts[target]->Push(task);
+  if (contexts[target]->idle_.load()) {
+    contexts[target]->Notify();
+    return;
+  }
+  // its processor is busy, wake an idle one to steal the task
+  for (int i = 1; i < size; ++i) {
+    auto* ctx = contexts[(target + i) % size];
+    if (ctx->idle_.load()) {
+      ctx->Notify();
+      return;
+    }
+  }
+}
+
+void WorkStealingContext::Remove(const StealTaskPtr& task) {
+  auto& cr = task->cr();
+  cr->Stop();
+  while (!cr->Acquire()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1));
+    AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+  }
+  task->state().store(StealTask::REMOVED);
+  cr->Release();
+}
+
+void WorkStealingContext::Push(const StealTaskPtr& task) {
+  auto prio = task->cr()->priority();
+  std::lock_guard<std::mutex> lk(rq_mutex_);
+  group_->ready[prio].fetch_add(1);
+  rq_[prio].emplace_back(task);
+}
+
+StealTaskPtr WorkStealingContext::PopLocal(uint32_t prio) {
+  std::lock_guard<std::mutex> lk(rq_mutex_);
+  auto& queue = rq_[prio];
+  if (queue.empty()) {
+    return nullptr;
+  }
+  auto task = std::move(queue.front());
+  queue.pop_front();
+  group_->ready[prio].fetch_sub(1);
+  return task;
+}
+
+StealTaskPtr WorkStealingContext::Steal(uint32_t prio) {
+  auto& contexts = group_->contexts;
+  const int size = static_cast<int>(contexts.size());
+  for (int i = 1; i < size; ++i) {
+    auto* victim = contexts[(index_ + i) % size];
+    // never wait on a busy queue, its owner or another thief is on it
+    std::unique_lock<std::mutex> lk(victim->rq_mutex_, std::try_to_lock);
+    if (!lk.owns_lock()) {
+      continue;
+    }
+    auto& queue = victim->rq_[prio];
+    if (queue.empty()) {
+      continue;
+    }
+    // the owner runs its queue from the front, thieves take from the back
+    auto task = std::move(queue.back());
+    queue.pop_back();
+    group_->ready[prio].fetch_sub(1);
+    return task;
+  }
+  return nullptr;
+}
+
+StealTaskPtr WorkStealingContext::Pop() {
+  for (int prio = MAX_PRIO - 1; prio >= 0; --prio) {
+    if (group_->ready[prio].load(std::memory_order_relaxed) <= 0) {
+      continue;
+    }
+    auto task = PopLocal(prio);
+    if (task == nullptr) {
+      task = Steal(prio);
+    }
+    if (task != nullptr) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void WorkStealingContext::Settle(const StealTaskPtr& task) {
+  auto cr_state = task->cr()->state();
+  auto& state = task->state();
+  int expected = state.load();
+  int desired = StealTask::IDLE;
+  do {
+    if (expected == StealTask::REMOVED) {
+      return;
+    }
+    switch (cr_state) {
+      case RoutineState::READY:
+        desired = StealTask::QUEUED;
+        break;
+      case RoutineState::SLEEP:
+        desired = StealTask::SLEEPING;
+        break;
+      case RoutineState::FINISHED:
+        desired = StealTask::IDLE;
+        break;
+      default:
+        desired = expected == StealTask::NOTIFIED ? StealTask::QUEUED
+                                                  : StealTask::IDLE;
+        break;
+    }
+  } while (!state.compare_exchange_weak(expected, desired));
+
+  if (desired == StealTask::QUEUED) {
+    Push(task);
+  } else if (desired == StealTask::SLEEPING) {
+    sleepers_.emplace(task->cr()->wake_time(), task);
+  }
+}
+
+void WorkStealingContext::WakeSleepers() {
+  auto now = std::chrono::steady_clock::now();
+  while (!sleepers_.empty() && sleepers_.begin()->first <= now) {
+    auto task = std::move(sleepers_.begin()->second);
+    sleepers_.erase(sleepers_.begin());
+    int expected = StealTask::SLEEPING;
+    if (task->state().compare_exchange_strong(expected, StealTask::QUEUED)) {
+      Push(task);
+    }
+  }
+}
+
+void WorkStealingContext::Notify() {
+  {
+    std::lock_guard<std::mutex> lk(mtx_wq_);
+    notified_ = true;
+  }
+  cv_wq_.notify_one();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
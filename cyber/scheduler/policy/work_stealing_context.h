@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+#define CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor_context.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+class WorkStealingContext;
+
+// A croutine as seen by the work stealing policy. state_ keeps the task in
+// at most one ready queue, and remembers a notification that arrives while
+// the task runs so that it is queued again right after.
+class StealTask {
+ public:
+  enum State : int { IDLE, QUEUED, RUNNING, NOTIFIED, SLEEPING, REMOVED };
+
+  explicit StealTask(const std::shared_ptr<CRoutine>& cr) : cr_(cr) {}
+
+  const std::shared_ptr<CRoutine>& cr() const { return cr_; }
+  std::atomic<int>& state() { return state_; }
+  // the processor that ran the task last, queued there again for locality
+  std::atomic<int>& last_proc() { return last_proc_; }
+
+ private:
+  std::shared_ptr<CRoutine> cr_;
+  std::atomic<int> state_ = {IDLE};
+  std::atomic<int> last_proc_ = {-1};
+};
+
+using StealTaskPtr = std::shared_ptr<StealTask>;
+
+// The processors of one classic_conf group, they only steal from each other.
+struct StealGroup {
+  std::vector<WorkStealingContext*> contexts;
+  // queued tasks per priority over the whole group, lets a processor notice
+  // higher priority work queued elsewhere without locking any queue
+  std::array<std::atomic<int>, MAX_PRIO> ready = {};
+  std::atomic<uint32_t> next = {0};
+};
+
+class WorkStealingContext : public ProcessorContext {
+ public:
+  WorkStealingContext(StealGroup* group, int index);
+
+  std::shared_ptr<CRoutine> NextRoutine() override;
+  void Wait() override;
+  void Shutdown() override;
+
+  // Queues a task that is ready or was notified, from any thread.
+  static void Enqueue(StealGroup* group, const StealTaskPtr& task);
+  // Blocks until the task is not running, it is never run again after.
+  static void Remove(const StealTaskPtr& task);
+
+ private:
+  using ReadyQueue = std::array<std::deque<StealTaskPtr>, MAX_PRIO>;
+  using SleepQueue =
+      std::multimap<std::chrono::steady_clock::time_point, StealTaskPtr>;
+
+  void Push(const StealTaskPtr& task);
+  StealTaskPtr PopLocal(uint32_t prio);
+  StealTaskPtr Steal(uint32_t prio);
+  StealTaskPtr Pop();
+  void Settle(const StealTaskPtr& task);
+  void WakeSleepers();
+  void Notify();
+
+  StealGroup* group_;
+  int index_;
+
+  alignas(CACHELINE_SIZE) std::mutex rq_mutex_;
+  ReadyQueue rq_;
+
+  // owned by the processor thread only
+  SleepQueue sleepers_;
+  StealTaskPtr running_ = nullptr;
+
+  alignas(CACHELINE_SIZE) std::mutex mtx_wq_;
+  std::condition_variable cv_wq_;
+  bool notified_ = false;
+  std::atomic<bool> idle_ = {false};
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
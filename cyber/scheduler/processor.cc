@@ -33,7 +33,13 @@ namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
 
-Processor::Processor() { running_.store(true); }
+Processor::Processor() {
+  running_.store(true);
+  auto& global_conf = GlobalData::Instance()->Config();
+  if (global_conf.scheduler_conf().sched_stats_conf().enable()) {
+    stats_ = std::make_shared<ProcessorStats>();
+  }
+}
 
 Processor::~Processor() { Stop(); }
 
@@ -41,6 +47,9 @@ void Processor::Run() {
   tid_.store(static_cast<int>(syscall(SYS_gettid)));
   AINFO << "processor_tid: " << tid_;
   snap_shot_->processor_id.store(tid_);
+  if (stats_ != nullptr) {
+    stats_->set_tid(tid_);
+  }
 
   while (cyber_likely(running_.load())) {
     if (cyber_likely(context_ != nullptr)) {
@@ -48,7 +57,11 @@ void Processor::Run() {
       if (croutine) {
         snap_shot_->execute_start_time.store(cyber::Time::Now().ToNanosecond());
         snap_shot_->routine_name = croutine->name();
-        croutine->Resume();
+        if (cyber_unlikely(stats_ != nullptr)) {
+          stats_->Resume(croutine.get());
+        } else {
+          croutine->Resume();
+        }
         croutine->Release();
       } else {
         snap_shot_->execute_start_time.store(0);
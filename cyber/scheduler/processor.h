@@ -28,6 +28,7 @@
 #include "cyber/proto/scheduler_conf.pb.h"
 
 #include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/common/sched_stats.h"
 #include "cyber/scheduler/processor_context.h"
 
 namespace apollo {
@@ -54,6 +55,8 @@ class Processor {
   std::atomic<pid_t>& Tid();
 
   std::shared_ptr<Snapshot> ProcSnapshot() { return snap_shot_; }
+  // nullptr unless sched stats are enabled
+  std::shared_ptr<ProcessorStats> ProcStats() { return stats_; }
 
  private:
   std::shared_ptr<ProcessorContext> context_;
@@ -67,6 +70,7 @@ class Processor {
   std::atomic<bool> running_{false};
 
   std::shared_ptr<Snapshot> snap_shot_ = std::make_shared<Snapshot>();
+  std::shared_ptr<ProcessorStats> stats_;
 };
 
 }  // namespace scheduler
@@ -122,6 +122,17 @@ void Scheduler::CheckSchedStatus() {
   snap_info.clear();
 }
 
+std::vector<std::shared_ptr<ProcessorStats>> Scheduler::ProcStats() {
+  std::vector<std::shared_ptr<ProcessorStats>> stats;
+  for (auto& processor : processors_) {
+    auto proc_stats = processor->ProcStats();
+    if (proc_stats != nullptr) {
+      stats.emplace_back(proc_stats);
+    }
+  }
+  return stats;
+}
+
 void Scheduler::Shutdown() {
   if (cyber_unlikely(stop_.exchange(true))) {
     return;
@@ -54,6 +54,7 @@ using apollo::cyber::proto::InnerThread;
 
 class Processor;
 class ProcessorContext;
+class ProcessorStats;
 
 class Scheduler {
  public:
@@ -78,6 +79,8 @@ class Scheduler {
   virtual bool RemoveCRoutine(uint64_t crid) = 0;
 
   void CheckSchedStatus();
+  // stats of every processor, empty unless sched stats are enabled
+  std::vector<std::shared_ptr<ProcessorStats>> ProcStats();
 
   void SetInnerThreadConfs(
       const std::unordered_map<std::string, InnerThread>& confs) {
@@ -0,0 +1,225 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/scheduler_work_stealing.h"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/cyber.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
+#include "cyber/scheduler/processor.h"
+#include "cyber/scheduler/scheduler_factory.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+namespace {
+
+void func() {}
+
+bool WaitFor(const std::function<bool()>& done) {
+  for (int i = 0; i < 2000 && !done(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return done();
+}
+
+class WorkStealingGroup {
+ public:
+  explicit WorkStealingGroup(int proc_num) {
+    for (int i = 0; i < proc_num; ++i) {
+      auto ctx = std::make_shared<WorkStealingContext>(&group_, i);
+      group_.contexts.emplace_back(ctx.get());
+      ctxs_.emplace_back(ctx);
+    }
+    for (auto& ctx : ctxs_) {
+      auto proc = std::make_shared<Processor>();
+      proc->BindContext(ctx);
+      procs_.emplace_back(proc);
+    }
+  }
+
+  ~WorkStealingGroup() {
+    for (auto& ctx : ctxs_) {
+      ctx->Shutdown();
+    }
+    for (auto& proc : procs_) {
+      proc->Stop();
+    }
+  }
+
+  StealGroup* group() { return &group_; }
+
+ private:
+  StealGroup group_;
+  std::vector<std::shared_ptr<WorkStealingContext>> ctxs_;
+  std::vector<std::shared_ptr<Processor>> procs_;
+};
+
+}  // namespace
+
+TEST(SchedulerWorkStealingTest, steal) {
+  WorkStealingGroup procs(4);
+  std::atomic<int> count = {0};
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+
+  std::vector<StealTaskPtr> tasks;
+  for (int i = 0; i < 100; ++i) {
+    auto cr = std::make_shared<CRoutine>([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      {
+        std::lock_guard<std::mutex> lk(mutex);
+        threads.insert(std::this_thread::get_id());
+      }
+      count.fetch_add(1);
+    });
+    auto task = std::make_shared<StealTask>(cr);
+    // everything lands in the queue of the first processor
+    task->last_proc().store(0);
+    tasks.emplace_back(task);
+  }
+  for (auto& task : tasks) {
+    WorkStealingContext::Enqueue(procs.group(), task);
+  }
+
+  EXPECT_TRUE(WaitFor([&]() { return count.load() == 100; }));
+  EXPECT_GT(threads.size(), 1);
+  for (auto& task : tasks) {
+    WorkStealingContext::Remove(task);
+  }
+}
+
+TEST(SchedulerWorkStealingTest, priority) {
+  WorkStealingGroup procs(1);
+  std::atomic<bool> start = {false};
+  std::vector<int> order;
+
+  // keeps the only processor busy until everything is queued
+  auto blocker = std::make_shared<StealTask>(std::make_shared<CRoutine>([&]() {
+    while (!start.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }));
+  WorkStealingContext::Enqueue(procs.group(), blocker);
+
+  std::vector<StealTaskPtr> tasks;
+  for (int prio : {1, 5, 3}) {
+    auto cr = std::make_shared<CRoutine>([&, prio]() { order.push_back(prio); });
+    cr->set_priority(prio);
+    tasks.emplace_back(std::make_shared<StealTask>(cr));
+    WorkStealingContext::Enqueue(procs.group(), tasks.back());
+  }
+  start.store(true);
+
+  ASSERT_TRUE(WaitFor([&]() {
+    return blocker->cr()->state() == RoutineState::FINISHED &&
+           tasks[0]->cr()->state() == RoutineState::FINISHED;
+  }));
+  EXPECT_EQ(std::vector<int>({5, 3, 1}), order);
+  WorkStealingContext::Remove(blocker);
+  for (auto& task : tasks) {
+    WorkStealingContext::Remove(task);
+  }
+}
+
+TEST(SchedulerWorkStealingTest, notify) {
+  WorkStealingGroup procs(2);
+  std::atomic<int> wakeups = {0};
+  auto cr = std::make_shared<CRoutine>([&]() {
+    while (true) {
+      wakeups.fetch_add(1);
+      CRoutine::GetCurrentRoutine()->HangUp();
+    }
+  });
+  auto task = std::make_shared<StealTask>(cr);
+  WorkStealingContext::Enqueue(procs.group(), task);
+  ASSERT_TRUE(WaitFor([&]() { return wakeups.load() == 1; }));
+
+  for (int i = 2; i <= 50; ++i) {
+    ASSERT_TRUE(WaitFor([&]() {
+      return task->state().load() == StealTask::IDLE;
+    }));
+    cr->SetUpdateFlag();
+    WorkStealingContext::Enqueue(procs.group(), task);
+    ASSERT_TRUE(WaitFor([&]() { return wakeups.load() == i; }));
+  }
+  WorkStealingContext::Remove(task);
+  EXPECT_EQ(StealTask::REMOVED, task->state().load());
+}
+
+TEST(SchedulerWorkStealingTest, sleep) {
+  WorkStealingGroup procs(1);
+  std::atomic<int> count = {0};
+  auto cr = std::make_shared<CRoutine>([&]() {
+    for (int i = 0; i < 5; ++i) {
+      CRoutine::GetCurrentRoutine()->Sleep(std::chrono::milliseconds(2));
+      count.fetch_add(1);
+    }
+  });
+  auto task = std::make_shared<StealTask>(cr);
+  WorkStealingContext::Enqueue(procs.group(), task);
+  EXPECT_TRUE(WaitFor([&]() { return count.load() == 5; }));
+  WorkStealingContext::Remove(task);
+}
+
+TEST(SchedulerWorkStealingTest, sched_work_stealing) {
+  // read example_sched_work_stealing.conf
+  GlobalData::Instance()->SetProcessGroup("example_sched_work_stealing");
+  auto sched = dynamic_cast<SchedulerWorkStealing*>(scheduler::Instance());
+  ASSERT_NE(nullptr, sched);
+  std::shared_ptr<CRoutine> cr = std::make_shared<CRoutine>(func);
+  auto task_id = GlobalData::RegisterTaskName("C");
+  cr->set_id(task_id);
+  cr->set_name("C");
+  EXPECT_TRUE(sched->DispatchTask(cr));
+  EXPECT_EQ("group2", cr->group_name());
+  EXPECT_EQ(2, cr->priority());
+  // dispatch the same task
+  EXPECT_FALSE(sched->DispatchTask(cr));
+  EXPECT_TRUE(sched->NotifyTask(task_id));
+  EXPECT_TRUE(sched->RemoveTask("C"));
+  EXPECT_FALSE(sched->NotifyTask(task_id));
+
+  std::atomic<int> count = {0};
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(sched->CreateTask([&count]() { count.fetch_add(1); },
+                                  "ws_task" + std::to_string(i)));
+  }
+  EXPECT_TRUE(WaitFor([&]() { return count.load() == 10; }));
+  sched->Shutdown();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  apollo::cyber::Init(argv[0]);
+  auto res = RUN_ALL_TESTS();
+  apollo::cyber::Clear();
+  return res;
+}
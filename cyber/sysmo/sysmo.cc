@@ -16,12 +16,25 @@
 
 #include "cyber/sysmo/sysmo.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+
 #include "cyber/common/environment.h"
+#include "cyber/common/global_data.h"
+#include "cyber/state.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
 
 using apollo::cyber::common::GetEnv;
+using apollo::cyber::common::GlobalData;
+
+namespace {
+const char kSchedStatsChannelPrefix[] = "/apollo/cyber/sched_stats/";
+}  // namespace
 
 SysMo::SysMo() { Start(); }
 
@@ -31,10 +44,18 @@ void SysMo::Start() {
     start_ = true;
     sysmo_ = std::thread(&SysMo::Checker, this);
   }
+
+  auto& stats_conf =
+      GlobalData::Instance()->Config().scheduler_conf().sched_stats_conf();
+  if (stats_conf.enable()) {
+    stats_start_ = true;
+    stats_interval_ms_ = std::max(stats_conf.interval_ms(), 10u);
+    stats_ = std::thread(&SysMo::StatsPublisher, this);
+  }
 }
 
 void SysMo::Shutdown() {
-  if (!start_ || shut_down_.exchange(true)) {
+  if ((!start_ && !stats_start_) || shut_down_.exchange(true)) {
     return;
   }
 
@@ -42,6 +63,11 @@ void SysMo::Shutdown() {
   if (sysmo_.joinable()) {
     sysmo_.join();
   }
+  if (stats_.joinable()) {
+    stats_.join();
+  }
+  stats_writer_.reset();
+  stats_node_.reset();
 }
 
 void SysMo::Checker() {
@@ -52,5 +78,36 @@ void SysMo::Checker() {
   }
 }
 
+void SysMo::StatsPublisher() {
+  auto process_group = GlobalData::Instance()->ProcessGroup();
+  while (cyber_unlikely(!shut_down_.load())) {
+    {
+      std::unique_lock<std::mutex> lk(lk_);
+      cv_.wait_for(lk, std::chrono::milliseconds(stats_interval_ms_));
+    }
+    if (shut_down_.load() || !OK()) {
+      continue;
+    }
+
+    if (stats_writer_ == nullptr) {
+      stats_node_.reset(new Node("sched_stats_" + process_group + "_" +
+                                 std::to_string(getpid())));
+      stats_writer_ = stats_node_->CreateWriter<proto::SchedStats>(
+          kSchedStatsChannelPrefix + process_group);
+      if (stats_writer_ == nullptr) {
+        AERROR << "create sched stats writer failed, stop publishing.";
+        return;
+      }
+    }
+
+    auto stats = std::make_shared<proto::SchedStats>();
+    stats_collector_.Collect(scheduler::Instance()->ProcStats(), stats.get());
+    stats->set_process_group(process_group);
+    stats->set_pid(getpid());
+    stats->set_timestamp(Time::Now().ToNanosecond());
+    stats_writer_->Write(stats);
+  }
+}
+
 }  // namespace cyber
 }  // namespace apollo
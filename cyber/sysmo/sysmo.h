@@ -20,10 +20,15 @@
 #include <chrono>
 #include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "cyber/proto/sched_stats.pb.h"
+
+#include "cyber/node/node.h"
+#include "cyber/scheduler/common/sched_stats.h"
 #include "cyber/scheduler/scheduler_factory.h"
 
 namespace apollo {
@@ -38,6 +43,7 @@ class SysMo {
 
  private:
   void Checker();
+  void StatsPublisher();
 
   std::atomic<bool> shut_down_{false};
   bool start_ = false;
@@ -47,6 +53,13 @@ class SysMo {
   std::mutex lk_;
   std::thread sysmo_;
 
+  bool stats_start_ = false;
+  uint32_t stats_interval_ms_ = 1000;
+  std::thread stats_;
+  std::unique_ptr<Node> stats_node_;
+  std::shared_ptr<Writer<proto::SchedStats>> stats_writer_;
+  scheduler::SchedStatsCollector stats_collector_;
+
   DECLARE_SINGLETON(SysMo);
 };
 
@@ -21,12 +21,15 @@
 #include <string>
 #include <vector>
 
+#include "cyber/proto/sched_stats.pb.h"
+
 #include "cyber/record/record_message.h"
 #include "cyber/tools/cyber_monitor/general_message.h"
 #include "cyber/tools/cyber_monitor/screen.h"
 
 namespace {
 constexpr int ReaderWriterOffset = 4;
+constexpr double kNsPerUs = 1000.0;
 using apollo::cyber::record::kGB;
 using apollo::cyber::record::kKB;
 using apollo::cyber::record::kMB;
@@ -148,6 +151,11 @@ int GeneralChannelMessage::Render(const Screen* s, int key) {
       current_state_ = State::ShowInfo;
       break;
 
+    case 'l':
+    case 'L':
+      current_state_ = State::ShowSchedStats;
+      break;
+
     default: {
     }
   }
@@ -171,6 +179,9 @@ int GeneralChannelMessage::Render(const Screen* s, int key) {
       case State::ShowInfo:
         RenderInfo(s, key, &line_no);
         break;
+      case State::ShowSchedStats:
+        RenderSchedStats(s, key, &line_no);
+        break;
     }
   } else {
     s->AddStr(0, line_no++, "Channel has been closed");
@@ -284,3 +295,69 @@ void GeneralChannelMessage::RenderDebugString(const Screen* s, int key,
     s->AddStr(0, (*line_no)++, "No Message Came");
   }
 }
+
+void GeneralChannelMessage::RenderSchedStats(const Screen* s, int key,
+                                             int* line_no) {
+  apollo::cyber::proto::SchedStats stats;
+  if (message_type() != stats.GetTypeName()) {
+    s->AddStr(0, (*line_no)++, "Not a SchedStats Channel");
+    return;
+  }
+  if (!has_message_come()) {
+    s->AddStr(0, (*line_no)++, "No Message Came");
+    return;
+  }
+  decltype(channel_message_) channel_msg = CopyMsgPtr();
+  if (!stats.ParseFromString(channel_msg->message)) {
+    s->AddStr(0, (*line_no)++, "Cannot parse the raw message");
+    return;
+  }
+
+  const double interval_ns = static_cast<double>(stats.interval_ns());
+  std::ostringstream out_str;
+  out_str << "Process: " << stats.process_group() << " (" << stats.pid()
+          << ")  Interval: " << std::fixed << std::setprecision(2)
+          << interval_ns / 1e9 << " s";
+  s->AddStr(0, (*line_no)++, out_str.str().c_str());
+
+  out_str.str("");
+  out_str << "Processors busy%:";
+  for (const auto& proc : stats.processors()) {
+    out_str << " " << proc.tid() << ":" << std::setprecision(0)
+            << (interval_ns > 0 ? 100.0 * proc.busy_ns() / interval_ns : 0.0);
+  }
+  s->AddStr(0, (*line_no)++, out_str.str().c_str());
+
+  out_str.str("");
+  out_str << std::left << std::setw(32) << "CRoutine" << std::right
+          << std::setw(8) << "Runs" << std::setw(8) << "Yields"
+          << std::setw(11) << "Wake p50" << std::setw(11) << "Wake p99"
+          << std::setw(11) << "Wake max" << std::setw(11) << "Run p50"
+          << std::setw(11) << "Run p99" << std::setw(11) << "Run max";
+  s->AddStr(0, (*line_no)++, out_str.str().c_str());
+  s->AddStr(0, (*line_no)++, "(latencies in us)");
+
+  page_item_count_ = s->Height() - *line_no;
+  if (page_item_count_ < 1) {
+    page_item_count_ = 1;
+  }
+  pages_ = stats.croutines_size() / page_item_count_ + 1;
+  SplitPages(key);
+
+  auto us = [](uint64_t ns) { return static_cast<double>(ns) / kNsPerUs; };
+  for (int i = page_index_ * page_item_count_;
+       i < stats.croutines_size() && *line_no < s->Height(); ++i) {
+    const auto& cr = stats.croutines(i);
+    out_str.str("");
+    out_str << std::left << std::setw(32) << cr.name().substr(0, 31)
+            << std::right << std::setw(8) << cr.run_count() << std::setw(8)
+            << cr.yield_count() << std::setprecision(1) << std::setw(11)
+            << us(cr.wake_to_run().p50_ns()) << std::setw(11)
+            << us(cr.wake_to_run().p99_ns()) << std::setw(11)
+            << us(cr.wake_to_run().max_ns()) << std::setw(11)
+            << us(cr.run_time().p50_ns()) << std::setw(11)
+            << us(cr.run_time().p99_ns()) << std::setw(11)
+            << us(cr.run_time().max_ns());
+    s->AddStr(0, (*line_no)++, out_str.str().c_str());
+  }
+}
@@ -165,10 +165,15 @@ class GeneralChannelMessage : public GeneralMessageBase {
 
   void RenderDebugString(const Screen* s, int key, int* line_no);
   void RenderInfo(const Screen* s, int key, int* line_no);
+  void RenderSchedStats(const Screen* s, int key, int* line_no);
 
   void set_has_message_come(bool b) { has_message_come_ = b; }
 
-  enum class State { ShowDebugString, ShowInfo } current_state_;
+  enum class State {
+    ShowDebugString,
+    ShowInfo,
+    ShowSchedStats
+  } current_state_;
 
   bool has_message_come_;
   std::string message_type_;
@@ -71,6 +71,7 @@ const char Screen::InteractiveCmdStr[] =
     "Commands for Channel:\n"
     "   i | I -- show Reader and Writers of Channel\n"
     "   b | B -- show Debug String of Channel Message\n"
+    "   l | L -- show croutine latency table of a sched_stats Channel\n"
     "\n"
     "Commands for Channel Repeated Datum:\n"
     "   n | N -- next repeated data item\n"
@@ -50,6 +50,10 @@ bool Info::Display(const std::string& file) {
   std::cout << std::setw(w) << "version: " << hdr.major_version() << "."
             << hdr.minor_version() << std::endl;
 
+  // compress
+  std::cout << std::setw(w) << "compress: "
+            << proto::CompressType_Name(hdr.compress()) << std::endl;
+
   // time and duration
   auto begin_time_s = static_cast<double>(hdr.begin_time()) / 1e9;
   auto end_time_s = static_cast<double>(hdr.end_time()) / 1e9;
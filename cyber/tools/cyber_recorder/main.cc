@@ -24,6 +24,7 @@
 #include "cyber/common/file.h"
 #include "cyber/common/time_conversion.h"
 #include "cyber/init.h"
+#include "cyber/record/file/chunk_compressor.h"
 #include "cyber/tools/cyber_recorder/info.h"
 #include "cyber/tools/cyber_recorder/player/player.h"
 #include "cyber/tools/cyber_recorder/recorder.h"
@@ -33,6 +34,7 @@
 using apollo::cyber::common::GetFileName;
 using apollo::cyber::common::StringToUnixSeconds;
 using apollo::cyber::common::UnixSecondsToString;
+using apollo::cyber::record::ChunkCompressor;
 using apollo::cyber::record::HeaderBuilder;
 using apollo::cyber::record::Info;
 using apollo::cyber::record::Player;
@@ -42,8 +44,8 @@ using apollo::cyber::record::Recoverer;
 using apollo::cyber::record::Spliter;
 
 const char INFO_OPTIONS[] = "h";
-const char RECORD_OPTIONS[] = "o:ac:k:i:m:h";
-const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:h";
+const char RECORD_OPTIONS[] = "o:ac:k:i:m:z:h";
+const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:t:h";
 const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:h";
 const char RECOVER_OPTIONS[] = "f:o:h";
 
@@ -137,6 +139,11 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-p, --preload <seconds>\t\t\t" << command
                   << " after trying to preload n second(s)" << std::endl;
         break;
+      case 't':
+        std::cout << "\t-t, --prefetch-threads <2>\t\t" << command
+                  << " with n chunk decoding thread(s), 0 to read in line"
+                  << std::endl;
+        break;
       case 'i':
         std::cout << "\t-i, --segment-interval <seconds>\t" << command
                   << " segmented every n second(s)" << std::endl;
@@ -145,6 +152,10 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-m, --segment-size <MB>\t\t\t" << command
                   << " segmented every n megabyte(s)" << std::endl;
         break;
+      case 'z':
+        std::cout << "\t-z, --compress <none|lz4|zstd>\t\t" << command
+                  << " with chunk compression" << std::endl;
+        break;
       case 'h':
         std::cout << "\t-h, --help\t\t\t\tshow help message" << std::endl;
         break;
@@ -170,7 +181,7 @@ int main(int argc, char** argv) {
   }
 
   int long_index = 0;
-  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:h";
+  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:t:i:m:z:h";
   static const struct option long_opts[] = {
       {"files", required_argument, nullptr, 'f'},
       {"white-channel", required_argument, nullptr, 'c'},
@@ -184,8 +195,10 @@ int main(int argc, char** argv) {
       {"start", required_argument, nullptr, 's'},
       {"delay", required_argument, nullptr, 'd'},
       {"preload", required_argument, nullptr, 'p'},
+      {"prefetch-threads", required_argument, nullptr, 't'},
       {"segment-interval", required_argument, nullptr, 'i'},
       {"segment-size", required_argument, nullptr, 'm'},
+      {"compress", required_argument, nullptr, 'z'},
       {"help", no_argument, nullptr, 'h'}};
 
   std::vector<std::string> opt_file_vec;
@@ -200,6 +213,7 @@ int main(int argc, char** argv) {
   double opt_start = 0;
   uint64_t opt_delay = 0;
   uint32_t opt_preload = 3;
+  uint32_t opt_prefetch_threads = 2;
   auto opt_header = HeaderBuilder::GetHeader();
 
   do {
@@ -308,6 +322,19 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 't':
+        try {
+          opt_prefetch_threads = std::stoi(optarg);
+        } catch (std::invalid_argument& ia) {
+          std::cout << "Invalid argument: -t/--prefetch-threads "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        } catch (const std::out_of_range& e) {
+          std::cout << "Argument is out of range: -t/--prefetch-threads "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
       case 'i':
         try {
           int interval_s = std::stoi(optarg);
@@ -346,6 +373,17 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'z': {
+        apollo::cyber::proto::CompressType compress_type;
+        if (!ChunkCompressor::ParseCompressType(std::string(optarg),
+                                                &compress_type)) {
+          std::cout << "Invalid argument: -z/--compress "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        opt_header.set_compress(compress_type);
+        break;
+      }
       case 'h':
         DisplayUsage(binary, command);
         return 0;
@@ -398,6 +436,7 @@ int main(int argc, char** argv) {
     play_param.start_time_s = opt_start;
     play_param.delay_time_s = opt_delay;
     play_param.preload_time_s = opt_preload;
+    play_param.prefetch_threads = opt_prefetch_threads;
     play_param.files_to_play.insert(opt_file_vec.begin(), opt_file_vec.end());
     play_param.black_channels.insert(opt_black_channels.begin(),
                                      opt_black_channels.end());
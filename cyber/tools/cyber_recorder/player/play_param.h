@@ -36,6 +36,8 @@ struct PlayParam {
   double start_time_s = 0;
   uint64_t delay_time_s = 0;
   uint32_t preload_time_s = 3;
+  // threads reading and decoding chunks ahead, 0 reads them one by one
+  uint32_t prefetch_threads = 2;
   std::set<std::string> files_to_play;
   std::set<std::string> channels_to_play;
   std::set<std::string> black_channels;
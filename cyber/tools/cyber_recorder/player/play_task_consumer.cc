@@ -16,6 +16,8 @@
 
 #include "cyber/tools/cyber_recorder/player/play_task_consumer.h"
 
+#include <algorithm>
+
 #include "cyber/common/log.h"
 #include "cyber/time/time.h"
 
@@ -26,6 +28,8 @@ namespace record {
 const uint64_t PlayTaskConsumer::kPauseSleepNanoSec = 100000000UL;
 const uint64_t PlayTaskConsumer::kWaitProduceSleepNanoSec = 5000000UL;
 const uint64_t PlayTaskConsumer::MIN_SLEEP_DURATION_NS = 200000000UL;
+const uint64_t PlayTaskConsumer::kSpinNanoSec = 200000UL;
+const uint64_t PlayTaskConsumer::kLateNanoSec = 1000000UL;
 
 PlayTaskConsumer::PlayTaskConsumer(const TaskBufferPtr& task_buffer,
                                    double play_rate)
@@ -52,6 +56,10 @@ void PlayTaskConsumer::Start(uint64_t begin_time_ns) {
     return;
   }
   begin_time_ns_ = begin_time_ns;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    timing_stats_ = PlayTimingStats();
+  }
   consume_th_.reset(new std::thread(&PlayTaskConsumer::ThreadFunc, this));
 }
 
@@ -72,14 +80,22 @@ void PlayTaskConsumer::Stop() {
 void PlayTaskConsumer::ThreadFunc() {
   uint64_t base_real_time_ns = 0;
   uint64_t accumulated_pause_time_ns = 0;
+  // the producer fell behind and the buffer ran dry while playing
+  bool starved = false;
 
   while (!is_stopped_.load()) {
     auto task = task_buffer_->Front();
     if (task == nullptr) {
+      starved = base_msg_play_time_ns_ != 0;
       std::this_thread::sleep_for(
           std::chrono::nanoseconds(kWaitProduceSleepNanoSec));
       continue;
     }
+    if (starved) {
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      ++timing_stats_.underrun_num;
+      starved = false;
+    }
 
     uint64_t sleep_ns = 0;
 
@@ -110,15 +126,23 @@ void PlayTaskConsumer::ThreadFunc() {
     uint64_t task_interval_ns = static_cast<uint64_t>(
         static_cast<double>(task->msg_play_time_ns() - base_msg_play_time_ns_) /
         play_rate_);
-    uint64_t real_time_interval_ns = Time::Now().ToNanosecond() -
-                                     base_real_time_ns -
-                                     accumulated_pause_time_ns;
-    if (task_interval_ns > real_time_interval_ns) {
-      sleep_ns = task_interval_ns - real_time_interval_ns;
+    const uint64_t play_at_ns =
+        base_real_time_ns + accumulated_pause_time_ns + task_interval_ns;
+    uint64_t now_ns = Time::Now().ToNanosecond();
+    if (play_at_ns > now_ns + kSpinNanoSec) {
+      sleep_ns = play_at_ns - now_ns - kSpinNanoSec;
       std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
     }
+    // sleep_for may oversleep by far more than the gap between messages at
+    // high rates, so the last stretch is spun
+    while ((now_ns = Time::Now().ToNanosecond()) < play_at_ns &&
+           !is_stopped_.load()) {
+      std::this_thread::yield();
+    }
 
     task->Play();
+    UpdateTimingStats(now_ns > play_at_ns ? now_ns - play_at_ns : 0,
+                      task_buffer_->Size());
     is_playonce_.store(false);
 
     last_played_msg_real_time_ns_ = task->msg_real_time_ns();
@@ -133,6 +157,17 @@ void PlayTaskConsumer::ThreadFunc() {
   }
 }
 
+void PlayTaskConsumer::UpdateTimingStats(uint64_t delay_ns, size_t backlog) {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  ++timing_stats_.played_msg_num;
+  if (delay_ns > kLateNanoSec) {
+    ++timing_stats_.late_msg_num;
+  }
+  timing_stats_.total_delay_ns += delay_ns;
+  timing_stats_.max_delay_ns = std::max(timing_stats_.max_delay_ns, delay_ns);
+  timing_stats_.max_backlog = std::max(timing_stats_.max_backlog, backlog);
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
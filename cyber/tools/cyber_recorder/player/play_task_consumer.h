@@ -20,6 +20,7 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 #include "cyber/tools/cyber_recorder/player/play_task_buffer.h"
@@ -28,6 +29,17 @@ namespace apollo {
 namespace cyber {
 namespace record {
 
+struct PlayTimingStats {
+  uint64_t played_msg_num = 0;
+  // published more than 1 ms after their scheduled time
+  uint64_t late_msg_num = 0;
+  uint64_t total_delay_ns = 0;
+  uint64_t max_delay_ns = 0;
+  // times the task buffer ran dry during playback
+  uint64_t underrun_num = 0;
+  size_t max_backlog = 0;
+};
+
 class PlayTaskConsumer {
  public:
   using ThreadPtr = std::unique_ptr<std::thread>;
@@ -48,9 +60,15 @@ class PlayTaskConsumer {
   uint64_t last_played_msg_real_time_ns() const {
     return last_played_msg_real_time_ns_;
   }
+  // stats since the last Start(), kept after Stop()
+  PlayTimingStats timing_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return timing_stats_;
+  }
 
  private:
   void ThreadFunc();
+  void UpdateTimingStats(uint64_t delay_ns, size_t backlog);
 
   double play_rate_;
   ThreadPtr consume_th_;
@@ -62,7 +80,11 @@ class PlayTaskConsumer {
   uint64_t base_msg_play_time_ns_;
   uint64_t base_msg_real_time_ns_;
   uint64_t last_played_msg_real_time_ns_;
+  PlayTimingStats timing_stats_;
+  mutable std::mutex stats_mutex_;
   static const uint64_t kPauseSleepNanoSec;
+  static const uint64_t kSpinNanoSec;
+  static const uint64_t kLateNanoSec;
   static const uint64_t kWaitProduceSleepNanoSec;
   static const uint64_t MIN_SLEEP_DURATION_NS;
 };
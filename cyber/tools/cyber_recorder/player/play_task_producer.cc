@@ -23,6 +23,7 @@
 #include "cyber/common/time_conversion.h"
 #include "cyber/cyber.h"
 #include "cyber/message/protobuf_factory.h"
+#include "cyber/tools/cyber_recorder/player/record_prefetcher.h"
 
 namespace apollo {
 namespace cyber {
@@ -47,6 +48,7 @@ PlayTaskProducer::PlayTaskProducer(const TaskBufferPtr& task_buffer,
       earliest_begin_time_(std::numeric_limits<uint64_t>::max()),
       latest_end_time_(0),
       total_msg_num_(0),
+      prefetch_wait_num_(0),
       preload_fill_buffer_mode_(preload_fill_buffer_mode) {}
 
 PlayTaskProducer::~PlayTaskProducer() { Stop(); }
@@ -122,6 +124,7 @@ bool PlayTaskProducer::ReadRecordInfo() {
     }
 
     record_readers_.emplace_back(record_reader);
+    record_files_.emplace_back(file);
 
     auto channel_list = record_reader->GetChannelList();
     // loop each channel info
@@ -378,6 +381,11 @@ void PlayTaskProducer::ThreadFunc() {
     preload_size = kMinTaskBufferSize;
   }
 
+  if (play_param_.prefetch_threads > 0) {
+    ThreadFuncWithPrefetch(avg_interval_time_ns, preload_size);
+    return;
+  }
+
   record_viewer_ptr_ = std::make_shared<RecordViewer>(
       record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
       play_param_.channels_to_play);
@@ -419,6 +427,65 @@ void PlayTaskProducer::ThreadFunc() {
   }
 }
 
+void PlayTaskProducer::ThreadFuncWithPrefetch(uint64_t avg_interval_time_ns,
+                                              uint32_t preload_size) {
+  const uint64_t loop_time_ns =
+      play_param_.end_time_ns - play_param_.begin_time_ns;
+  const auto& channels = play_param_.channels_to_play;
+
+  uint32_t loop_num = 0;
+  while (!is_stopped_.load()) {
+    uint64_t plus_time_ns = loop_num * loop_time_ns;
+    ChunkMessageMerger merger(play_param_.begin_time_ns,
+                              play_param_.end_time_ns, channels);
+    auto push_tasks_before = [&](uint64_t time_ns) {
+      proto::SingleMessage msg;
+      while (!is_stopped_.load() && merger.PopBefore(time_ns, &msg)) {
+        auto search = writers_.find(msg.channel_name());
+        if (search == writers_.end()) {
+          continue;
+        }
+        while (!is_stopped_.load() && task_buffer_->Size() > preload_size) {
+          std::this_thread::sleep_for(
+              std::chrono::nanoseconds(avg_interval_time_ns));
+        }
+        auto raw_msg = std::make_shared<message::RawMessage>();
+        raw_msg->message.swap(*msg.mutable_content());
+        task_buffer_->Push(std::make_shared<PlayTask>(
+            raw_msg, search->second, msg.time(), msg.time() + plus_time_ns));
+      }
+    };
+
+    RecordPrefetcher prefetcher(
+        record_files_, play_param_.begin_time_ns, play_param_.end_time_ns,
+        channels, play_param_.prefetch_threads,
+        play_param_.prefetch_threads * 2);
+    if (!prefetcher.Start()) {
+      is_stopped_.store(true);
+      break;
+    }
+
+    RecordPrefetcher::Chunk chunk;
+    while (!is_stopped_.load() && prefetcher.Next(&chunk)) {
+      push_tasks_before(chunk.begin_time);
+      merger.AddChunk(chunk.body.get());
+    }
+    push_tasks_before(std::numeric_limits<uint64_t>::max());
+    prefetcher.Stop();
+    prefetch_wait_num_ += prefetcher.wait_num();
+    if (prefetcher.failed_chunk_num() > 0) {
+      AERROR << prefetcher.failed_chunk_num() << " of "
+             << prefetcher.chunk_num() << " chunks could not be read.";
+    }
+
+    if (!play_param_.is_loop_playback) {
+      is_stopped_.store(true);
+      break;
+    }
+    ++loop_num;
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -67,6 +67,8 @@ class PlayTaskProducer {
   bool is_stopped() const { return is_stopped_.load(); }
   bool is_initialized() const { return is_initialized_.load(); }
   void set_stopped() { is_stopped_.exchange(true); }
+  // times playback had to wait for a chunk to be decoded
+  uint64_t prefetch_wait_num() const { return prefetch_wait_num_.load(); }
   void WriteRecordProgress(const double& curr_time_s,
                                            const double& total_time_s);
    /**
@@ -87,6 +89,8 @@ class PlayTaskProducer {
   bool CreatePlayTaskWriter(const std::string& channel_name,
                             const std::string& msg_type);
   void ThreadFunc();
+  void ThreadFuncWithPrefetch(uint64_t avg_interval_time_ns,
+                              uint32_t preload_size);
   void ThreadFuncUnderPreloadMode();
 
   PlayParam play_param_;
@@ -100,11 +104,13 @@ class PlayTaskProducer {
   WriterMap writers_;
   MessageTypeMap msg_types_;
   std::vector<RecordReaderPtr> record_readers_;
+  std::vector<std::string> record_files_;
   RecordViewerPtr record_viewer_ptr_;
 
   uint64_t earliest_begin_time_;
   uint64_t latest_end_time_;
   uint64_t total_msg_num_;
+  std::atomic<uint64_t> prefetch_wait_num_;
 
   // This parameter indicates whether the producer needs to preload the buffer
   // When this value is true, it means that we preload the buffer before playing
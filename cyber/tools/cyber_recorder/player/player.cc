@@ -253,6 +253,19 @@ bool Player::Start() {
   }
 
   std::cout << "\nplay finished." << std::endl;
+  const auto stats = consumer_->timing_stats();
+  if (stats.played_msg_num > 0) {
+    std::cout << std::setprecision(1) << "played " << stats.played_msg_num
+              << " messages, timing error mean: "
+              << static_cast<double>(stats.total_delay_ns) /
+                     static_cast<double>(stats.played_msg_num) / 1e3
+              << " us, max: " << static_cast<double>(stats.max_delay_ns) / 1e3
+              << " us, late (> 1 ms): " << stats.late_msg_num
+              << ", max backlog: " << stats.max_backlog
+              << ", buffer underruns: " << stats.underrun_num
+              << ", chunk decode waits: " << producer_->prefetch_wait_num()
+              << std::endl;
+  }
   std::cout.flags(before);
   return true;
 }
@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/player/record_prefetcher.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::ChunkBody;
+using apollo::cyber::proto::SectionType;
+using apollo::cyber::proto::SingleMessage;
+
+RecordPrefetcher::RecordPrefetcher(const std::vector<std::string>& files,
+                                   uint64_t begin_time, uint64_t end_time,
+                                   const std::set<std::string>& channels,
+                                   uint32_t thread_num,
+                                   uint32_t max_ahead_chunks)
+    : files_(files),
+      begin_time_(begin_time),
+      end_time_(end_time),
+      channels_(channels),
+      thread_num_(std::max(thread_num, 1U)),
+      max_ahead_chunks_(std::max(max_ahead_chunks, 1U)) {}
+
+RecordPrefetcher::~RecordPrefetcher() { Stop(); }
+
+bool RecordPrefetcher::Start() {
+  if (!threads_.empty()) {
+    AERROR << "prefetcher has been started.";
+    return false;
+  }
+  tasks_.clear();
+  for (size_t i = 0; i < files_.size(); ++i) {
+    RecordReader reader(files_[i]);
+    if (!reader.IsValid()) {
+      AERROR << "skip invalid record file: " << files_[i];
+      continue;
+    }
+    for (const auto& chunk :
+         reader.GetChunkIndex(begin_time_, end_time_, channels_)) {
+      Task task;
+      task.file_index = i;
+      task.begin_time = chunk.begin_time;
+      task.body_position = chunk.body_position;
+      tasks_.push_back(task);
+    }
+  }
+  // chunks of one record are already in order, this merges the records
+  std::stable_sort(tasks_.begin(), tasks_.end(),
+                   [](const Task& lhs, const Task& rhs) {
+                     return lhs.begin_time < rhs.begin_time;
+                   });
+  bodies_.clear();
+  bodies_.resize(tasks_.size());
+  decoded_.assign(tasks_.size(), false);
+  next_task_ = 0;
+  next_chunk_ = 0;
+  wait_num_ = 0;
+  failed_chunk_num_ = 0;
+  is_stopped_ = false;
+
+  const size_t thread_num =
+      std::min(static_cast<size_t>(thread_num_), tasks_.size());
+  for (size_t i = 0; i < thread_num; ++i) {
+    threads_.emplace_back(&RecordPrefetcher::ThreadFunc, this);
+  }
+  AINFO << "prefetch " << tasks_.size() << " chunks of " << files_.size()
+        << " records with " << thread_num << " threads.";
+  return true;
+}
+
+void RecordPrefetcher::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  task_cv_.notify_all();
+  chunk_cv_.notify_all();
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  threads_.clear();
+}
+
+bool RecordPrefetcher::Next(Chunk* chunk) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (is_stopped_ || next_chunk_ >= tasks_.size()) {
+      return false;
+    }
+    if (!decoded_[next_chunk_]) {
+      ++wait_num_;
+      chunk_cv_.wait(lock,
+                     [this] { return is_stopped_ || decoded_[next_chunk_]; });
+      if (is_stopped_) {
+        return false;
+      }
+    }
+    chunk->begin_time = tasks_[next_chunk_].begin_time;
+    chunk->body = std::move(bodies_[next_chunk_]);
+    ++next_chunk_;
+  }
+  task_cv_.notify_all();
+  return true;
+}
+
+void RecordPrefetcher::ThreadFunc() {
+  // one descriptor per record and thread, so the reads run in parallel
+  std::vector<std::unique_ptr<RecordFileReader>> readers(files_.size());
+  while (true) {
+    size_t index = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_cv_.wait(lock, [this] {
+        return is_stopped_ || next_task_ >= tasks_.size() ||
+               next_task_ < next_chunk_ + max_ahead_chunks_;
+      });
+      if (is_stopped_ || next_task_ >= tasks_.size()) {
+        return;
+      }
+      index = next_task_++;
+    }
+
+    ChunkBodyPtr body(new ChunkBody());
+    if (!ReadChunk(tasks_[index], &readers, body.get())) {
+      AERROR << "failed to read chunk at " << tasks_[index].body_position
+             << ", file: " << files_[tasks_[index].file_index];
+      ++failed_chunk_num_;
+      body->Clear();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      bodies_[index] = std::move(body);
+      decoded_[index] = true;
+    }
+    chunk_cv_.notify_all();
+  }
+}
+
+bool RecordPrefetcher::ReadChunk(
+    const Task& task, std::vector<std::unique_ptr<RecordFileReader>>* readers,
+    ChunkBody* body) {
+  auto& reader = (*readers)[task.file_index];
+  if (reader == nullptr) {
+    reader.reset(new RecordFileReader());
+    if (!reader->Open(files_[task.file_index])) {
+      reader.reset();
+      return false;
+    }
+  }
+  if (!reader->SetPosition(task.body_position)) {
+    return false;
+  }
+  Section section;
+  if (!reader->ReadSection(&section) ||
+      section.type != SectionType::SECTION_CHUNK_BODY) {
+    return false;
+  }
+  return reader->ReadSection<ChunkBody>(section.size, body);
+}
+
+ChunkMessageMerger::ChunkMessageMerger(uint64_t begin_time,
+                                       uint64_t end_time,
+                                       const std::set<std::string>& channels)
+    : begin_time_(begin_time), end_time_(end_time), channels_(channels) {}
+
+void ChunkMessageMerger::AddChunk(ChunkBody* body) {
+  for (auto& msg : *body->mutable_messages()) {
+    if (msg.time() < begin_time_ || msg.time() > end_time_) {
+      continue;
+    }
+    if (!channels_.empty() && channels_.count(msg.channel_name()) == 0) {
+      continue;
+    }
+    // the content is moved, not copied
+    messages_.emplace(msg.time(), SingleMessage())->second.Swap(&msg);
+  }
+}
+
+bool ChunkMessageMerger::PopBefore(uint64_t time, SingleMessage* message) {
+  if (messages_.empty() || messages_.begin()->first >= time) {
+    return false;
+  }
+  message->Swap(&messages_.begin()->second);
+  messages_.erase(messages_.begin());
+  return true;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TOOLS_CYBER_RECORDER_PLAYER_RECORD_PREFETCHER_H_
+#define CYBER_TOOLS_CYBER_RECORDER_PLAYER_RECORD_PREFETCHER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cyber/proto/record.pb.h"
+#include "cyber/record/record_reader.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @brief Reads and decodes the chunks of several records ahead of playback.
+ * The chunks covering the play range are taken from the record indexes and
+ * sorted by begin time; worker threads, each with its own file descriptors,
+ * decode up to max_ahead_chunks of them in parallel while Next() hands them
+ * out in that order.
+ */
+class RecordPrefetcher {
+ public:
+  using ChunkBodyPtr = std::unique_ptr<proto::ChunkBody>;
+
+  struct Chunk {
+    uint64_t begin_time = 0;
+    ChunkBodyPtr body;
+  };
+
+  RecordPrefetcher(const std::vector<std::string>& files, uint64_t begin_time,
+                   uint64_t end_time, const std::set<std::string>& channels,
+                   uint32_t thread_num, uint32_t max_ahead_chunks);
+  virtual ~RecordPrefetcher();
+
+  bool Start();
+  void Stop();
+
+  /**
+   * @brief Wait for the next chunk in begin time order.
+   *
+   * @return False once all chunks are handed out or after Stop().
+   */
+  bool Next(Chunk* chunk);
+
+  size_t chunk_num() const { return tasks_.size(); }
+  // times Next() found its chunk not decoded yet
+  uint64_t wait_num() const { return wait_num_; }
+  uint64_t failed_chunk_num() const { return failed_chunk_num_.load(); }
+
+ private:
+  struct Task {
+    size_t file_index = 0;
+    uint64_t begin_time = 0;
+    int64_t body_position = 0;
+  };
+
+  void ThreadFunc();
+  bool ReadChunk(const Task& task,
+                 std::vector<std::unique_ptr<RecordFileReader>>* readers,
+                 proto::ChunkBody* body);
+
+  std::vector<std::string> files_;
+  uint64_t begin_time_;
+  uint64_t end_time_;
+  std::set<std::string> channels_;
+  uint32_t thread_num_;
+  uint32_t max_ahead_chunks_;
+
+  std::vector<Task> tasks_;
+  std::vector<ChunkBodyPtr> bodies_;
+  std::vector<bool> decoded_;
+  size_t next_task_ = 0;
+  size_t next_chunk_ = 0;
+  bool is_stopped_ = true;
+  std::mutex mutex_;
+  std::condition_variable task_cv_;
+  std::condition_variable chunk_cv_;
+  std::vector<std::thread> threads_;
+
+  uint64_t wait_num_ = 0;
+  std::atomic<uint64_t> failed_chunk_num_{0};
+};
+
+/**
+ * @brief Puts the messages of the chunks handed out by RecordPrefetcher back
+ * into time order. Chunks of several records may overlap in time, so the
+ * messages are held back until the next chunk begins after them.
+ */
+class ChunkMessageMerger {
+ public:
+  ChunkMessageMerger(uint64_t begin_time, uint64_t end_time,
+                     const std::set<std::string>& channels);
+
+  // takes the messages of the chunk within the play range and channels
+  void AddChunk(proto::ChunkBody* body);
+
+  /**
+   * @brief Take the earliest message held back, if it is before time.
+   * Messages of one time keep the order they were added in.
+   */
+  bool PopBefore(uint64_t time, proto::SingleMessage* message);
+
+  size_t Size() const { return messages_.size(); }
+
+ private:
+  uint64_t begin_time_;
+  uint64_t end_time_;
+  std::set<std::string> channels_;
+  std::multimap<uint64_t, proto::SingleMessage> messages_;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TOOLS_CYBER_RECORDER_PLAYER_RECORD_PREFETCHER_H_
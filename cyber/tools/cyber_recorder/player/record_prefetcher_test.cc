@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/player/record_prefetcher.h"
+
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/record/file/record_file_writer.h"
+#include "cyber/record/header_builder.h"
+#include "cyber/record/record_viewer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::Channel;
+using apollo::cyber::proto::SingleMessage;
+
+constexpr char kChannelA[] = "/test/channel_a";
+constexpr char kChannelB[] = "/test/channel_b";
+constexpr char kTestFile1[] = "prefetcher_test_1.record";
+constexpr char kTestFile2[] = "prefetcher_test_2.record";
+constexpr uint64_t kMsgNum = 400;
+
+// a message every 20 ns from offset on, a chunk ends with the first message
+// more than 100 ns after its first one
+constexpr uint64_t kChunkMsgNum = 7;
+constexpr uint64_t kChunkNum = (kMsgNum + kChunkMsgNum - 1) / kChunkMsgNum;
+
+static void ConstructRecord(const std::string& file, uint64_t offset) {
+  RecordFileWriter writer;
+  ASSERT_TRUE(writer.Open(file));
+  proto::Header header = HeaderBuilder::GetHeaderWithChunkParams(100, 0);
+  header.set_segment_interval(0);
+  header.set_segment_raw_size(0);
+  ASSERT_TRUE(writer.WriteHeader(header));
+  for (const char* name : {kChannelA, kChannelB}) {
+    Channel channel;
+    channel.set_name(name);
+    channel.set_message_type("apollo.cyber.proto.Test");
+    ASSERT_TRUE(writer.WriteChannel(channel));
+  }
+  for (uint64_t i = 0; i < kMsgNum; ++i) {
+    SingleMessage msg;
+    msg.set_channel_name(i % 3 == 0 ? kChannelB : kChannelA);
+    msg.set_time(1000 + offset + i * 20);
+    msg.set_content(file + ":" + std::to_string(i));
+    ASSERT_TRUE(writer.WriteMessage(msg));
+    // every chunk due is written on its own
+    writer.WaitForFlush();
+  }
+  writer.Close();
+}
+
+struct PlayedMessage {
+  uint64_t time;
+  std::string channel_name;
+  std::string content;
+
+  bool operator==(const PlayedMessage& other) const {
+    return time == other.time && channel_name == other.channel_name &&
+           content == other.content;
+  }
+};
+
+::std::ostream& operator<<(::std::ostream& os, const PlayedMessage& msg) {
+  return os << msg.time << " " << msg.channel_name << " " << msg.content;
+}
+
+// the messages as PlayTaskProducer::ThreadFunc plays them
+std::vector<PlayedMessage> ViewerMessages(
+    uint64_t begin_time, uint64_t end_time,
+    const std::set<std::string>& channels) {
+  std::vector<std::shared_ptr<RecordReader>> readers = {
+      std::make_shared<RecordReader>(kTestFile1),
+      std::make_shared<RecordReader>(kTestFile2)};
+  RecordViewer viewer(readers, begin_time, end_time, channels);
+  std::vector<PlayedMessage> messages;
+  for (auto& msg : viewer) {
+    messages.push_back({msg.time, msg.channel_name, msg.content});
+  }
+  return messages;
+}
+
+// the messages as PlayTaskProducer::ThreadFuncWithPrefetch plays them
+std::vector<PlayedMessage> PrefetchedMessages(
+    uint64_t begin_time, uint64_t end_time,
+    const std::set<std::string>& channels, uint32_t thread_num,
+    size_t* chunk_num) {
+  RecordPrefetcher prefetcher({kTestFile1, kTestFile2}, begin_time, end_time,
+                              channels, thread_num, thread_num * 2);
+  EXPECT_TRUE(prefetcher.Start());
+  ChunkMessageMerger merger(begin_time, end_time, channels);
+  std::vector<PlayedMessage> messages;
+  SingleMessage msg;
+  auto pop_before = [&](uint64_t time) {
+    while (merger.PopBefore(time, &msg)) {
+      messages.push_back({msg.time(), msg.channel_name(), msg.content()});
+    }
+  };
+  RecordPrefetcher::Chunk chunk;
+  while (prefetcher.Next(&chunk)) {
+    pop_before(chunk.begin_time);
+    merger.AddChunk(chunk.body.get());
+  }
+  pop_before(std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(merger.Size(), 0);
+  EXPECT_EQ(prefetcher.failed_chunk_num(), 0);
+  *chunk_num = prefetcher.chunk_num();
+  return messages;
+}
+
+class RecordPrefetcherTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    // the messages of the records interleave, 10 ns apart
+    ConstructRecord(kTestFile1, 0);
+    ConstructRecord(kTestFile2, 10);
+  }
+  static void TearDownTestCase() {
+    remove(kTestFile1);
+    remove(kTestFile2);
+  }
+};
+
+TEST_F(RecordPrefetcherTest, order_test) {
+  const uint64_t end_time = std::numeric_limits<uint64_t>::max();
+  const std::vector<PlayedMessage> expected = ViewerMessages(0, end_time, {});
+  ASSERT_EQ(expected.size(), 2 * kMsgNum);
+  for (const uint32_t thread_num : {1U, 4U}) {
+    size_t chunk_num = 0;
+    EXPECT_EQ(PrefetchedMessages(0, end_time, {}, thread_num, &chunk_num),
+              expected)
+        << thread_num << " threads";
+    EXPECT_EQ(chunk_num, 2 * kChunkNum);
+  }
+}
+
+TEST_F(RecordPrefetcherTest, filter_test) {
+  // a play range within chunks, and one channel
+  const uint64_t begin_time = 1000 + 1234;
+  const uint64_t end_time = 1000 + 5678;
+  const std::set<std::string> channels = {kChannelB};
+  const std::vector<PlayedMessage> expected =
+      ViewerMessages(begin_time, end_time, channels);
+  ASSERT_FALSE(expected.empty());
+  for (const auto& msg : expected) {
+    EXPECT_EQ(msg.channel_name, kChannelB);
+    EXPECT_GE(msg.time, begin_time);
+    EXPECT_LE(msg.time, end_time);
+  }
+  for (const uint32_t thread_num : {1U, 4U}) {
+    size_t chunk_num = 0;
+    EXPECT_EQ(PrefetchedMessages(begin_time, end_time, channels, thread_num,
+                                 &chunk_num),
+              expected)
+        << thread_num << " threads";
+    // only chunks 9 to 40 of each record hold messages of the channel in the
+    // range
+    EXPECT_EQ(chunk_num, 2 * 32);
+  }
+}
+
+TEST_F(RecordPrefetcherTest, stop_test) {
+  RecordPrefetcher prefetcher({kTestFile1, kTestFile2}, 0,
+                              std::numeric_limits<uint64_t>::max(), {}, 4, 2);
+  ASSERT_TRUE(prefetcher.Start());
+  EXPECT_FALSE(prefetcher.Start());
+  RecordPrefetcher::Chunk chunk;
+  ASSERT_TRUE(prefetcher.Next(&chunk));
+  ASSERT_NE(chunk.body, nullptr);
+  // the threads waiting for the chunks to be taken are stopped
+  prefetcher.Stop();
+  EXPECT_FALSE(prefetcher.Next(&chunk));
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
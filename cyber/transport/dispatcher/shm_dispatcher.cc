@@ -56,19 +56,40 @@ void ShmDispatcher::AddSegment(const RoleAttributes& self_attr) {
   previous_indexes_[channel_id] = UINT32_MAX;
 }
 
-void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
+void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index,
+                                uint64_t seq) {
   ADEBUG << "Reading sharedmem message: "
          << GlobalData::GetChannelById(channel_id)
          << " from block: " << block_index;
-  auto rb = std::make_shared<ReadableBlock>();
-  rb->index = block_index;
-  if (!segments_[channel_id]->AcquireBlockToRead(rb.get())) {
+  ReadableBlock readable_block;
+  readable_block.index = block_index;
+  readable_block.seq = seq;
+  auto& segment = segments_[channel_id];
+  uint64_t overrun_count = segment->overrun_count();
+  if (!segment->AcquireBlockToRead(&readable_block)) {
+    if (segment->overrun_count() != overrun_count) {
+      AWARN << "block overrun, channel: "
+            << GlobalData::GetChannelById(channel_id)
+            << " index: " << block_index << " seq: " << seq
+            << " total overruns: " << segment->overrun_count();
+      return;
+    }
     AWARN << "fail to acquire block, channel: "
           << GlobalData::GetChannelById(channel_id)
           << " index: " << block_index;
     return;
   }
 
+  // A LoanedMessage may keep viewing the block after the listeners return,
+  // so the block is released with the last reference to it.
+  segment->PinMapping();
+  std::shared_ptr<ReadableBlock> rb(
+      new ReadableBlock(readable_block), [segment](ReadableBlock* block) {
+        segment->ReleaseReadBlock(*block);
+        segment->UnpinMapping();
+        delete block;
+      });
+
   MessageInfo msg_info;
   const char* msg_info_addr =
       reinterpret_cast<char*>(rb->buf) + rb->block->msg_size();
@@ -79,7 +100,6 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
     AERROR << "error msg info of channel:"
            << GlobalData::GetChannelById(channel_id);
   }
-  segments_[channel_id]->ReleaseReadBlock(*rb);
 }
 
 void ShmDispatcher::OnMessage(uint64_t channel_id,
@@ -139,7 +159,7 @@ void ShmDispatcher::ThreadFunc() {
       }
       previous_index = block_index;
 
-      ReadMessage(channel_id, block_index);
+      ReadMessage(channel_id, block_index, readable_info.seq());
     }
   }
 }
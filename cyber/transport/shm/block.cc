@@ -72,6 +72,13 @@ void Block::ReleaseWriteLock() { lock_num_.fetch_add(1); }
 
 void Block::ReleaseReadLock() { lock_num_.fetch_sub(1); }
 
+bool Block::DowngradeWriteLock() {
+  int32_t write_exclusive = kWriteExclusive;
+  return lock_num_.compare_exchange_strong(write_exclusive, 1,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
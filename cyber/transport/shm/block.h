@@ -48,8 +48,13 @@ class Block {
   bool TryLockForRead();
   void ReleaseWriteLock();
   void ReleaseReadLock();
+  // turns the write lock into a single read lock without letting a writer in
+  bool DowngradeWriteLock();
 
   std::atomic<int32_t> lock_num_ = {0};
+  // ring mode only: 2 * seq + 1 while seq is being written, 2 * seq + 2 once
+  // it is published, 0 if never written.
+  std::atomic<uint64_t> seq_ = {0};
 
   uint64_t msg_size_;
   uint64_t msg_info_size_;
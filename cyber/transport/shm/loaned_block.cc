@@ -0,0 +1,56 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/loaned_block.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+LoanedBlock::LoanedBlock(const SegmentPtr& segment,
+                         const WritableBlock& writable_block)
+    : segment_(segment), writable_block_(writable_block), published_(false) {}
+
+LoanedBlock::~LoanedBlock() {
+  segment_->ReleaseLentBlock(writable_block_, published_.load());
+}
+
+bool LoanedBlock::Publish(std::size_t msg_size, const MessageInfo& msg_info) {
+  if (published_.load()) {
+    ADEBUG << "block[" << writable_block_.index << "] is already published.";
+    return false;
+  }
+
+  char* msg_info_addr = reinterpret_cast<char*>(writable_block_.buf) + msg_size;
+  if (!msg_info.SerializeTo(msg_info_addr, MessageInfo::kSize)) {
+    AERROR << "serialize message info failed.";
+    return false;
+  }
+  writable_block_.block->set_msg_size(msg_size);
+  writable_block_.block->set_msg_info_size(MessageInfo::kSize);
+  if (!segment_->PublishLentBlock(writable_block_)) {
+    AERROR << "publish block[" << writable_block_.index << "] failed.";
+    return false;
+  }
+  published_.store(true);
+  return true;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
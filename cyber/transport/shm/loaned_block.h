@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_LOANED_BLOCK_H_
+#define CYBER_TRANSPORT_SHM_LOANED_BLOCK_H_
+
+#include <atomic>
+#include <memory>
+
+#include "cyber/message/loaned_message.h"
+#include "cyber/message/message_traits.h"
+#include "cyber/transport/message/message_info.h"
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using apollo::cyber::message::LoanedMessage;
+
+// A shm block lent to a LoanedMessage by the ShmTransmitter. The writer fills
+// it in place, publishing downgrades the write lock to a read lock so that
+// in-process readers and the history can keep using the payload, and the
+// block goes back to the segment with the last copy of the message.
+class LoanedBlock : public LoanedMessage::Owner {
+ public:
+  LoanedBlock(const SegmentPtr& segment, const WritableBlock& writable_block);
+  ~LoanedBlock() override;
+
+  // Appends msg_info behind the payload and publishes the block, only once.
+  bool Publish(std::size_t msg_size, const MessageInfo& msg_info);
+
+  const SegmentPtr& segment() const { return segment_; }
+  const WritableBlock& writable_block() const { return writable_block_; }
+
+ private:
+  SegmentPtr segment_;
+  WritableBlock writable_block_;
+  std::atomic<bool> published_;
+};
+
+// Keeps a block read by the ShmDispatcher read locked for as long as a
+// LoanedMessage views it.
+class ReadableBlockView : public LoanedMessage::Owner {
+ public:
+  explicit ReadableBlockView(const std::shared_ptr<ReadableBlock>& rb)
+      : rb_(rb) {}
+
+ private:
+  std::shared_ptr<ReadableBlock> rb_;
+};
+
+template <typename M>
+std::shared_ptr<LoanedBlock> GetLoanedBlock(const M& msg) {
+  (void)msg;
+  return nullptr;
+}
+
+inline std::shared_ptr<LoanedBlock> GetLoanedBlock(const LoanedMessage& msg) {
+  return std::dynamic_pointer_cast<LoanedBlock>(msg.owner());
+}
+
+template <typename M>
+bool ParseFromBlock(const std::shared_ptr<ReadableBlock>& rb, M* msg) {
+  return message::ParseFromArray(
+      rb->buf, static_cast<int>(rb->block->msg_size()), msg);
+}
+
+// A LoanedMessage views the block instead of copying it, unless the block is
+// a ring mode snapshot that the next read overwrites.
+inline bool ParseFromBlock(const std::shared_ptr<ReadableBlock>& rb,
+                           LoanedMessage* msg) {
+  auto msg_size = rb->block->msg_size();
+  if (rb->snapshot) {
+    return msg->ParseFromArray(rb->buf, static_cast<int>(msg_size));
+  }
+  *msg = LoanedMessage(rb->buf, msg_size, msg_size,
+                       std::make_shared<ReadableBlockView>(rb));
+  return true;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_LOANED_BLOCK_H_
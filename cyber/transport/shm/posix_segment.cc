@@ -80,6 +80,7 @@ bool PosixSegment::OpenOrCreate() {
     shm_unlink(shm_name_.c_str());
     return false;
   }
+  state_->set_ring_mode(ring_mode_);
 
   conf_.Update(state_->ceiling_msg_size());
 
@@ -32,7 +32,8 @@ using ReadableInfoPtr = std::shared_ptr<ReadableInfo>;
 class ReadableInfo {
  public:
   ReadableInfo();
-  ReadableInfo(uint64_t host_id, uint32_t block_index, uint64_t channel_id);
+  ReadableInfo(uint64_t host_id, uint32_t block_index, uint64_t channel_id,
+               uint64_t seq = 0);
   virtual ~ReadableInfo();
 
   ReadableInfo& operator=(const ReadableInfo& other);
@@ -50,12 +51,16 @@ class ReadableInfo {
   uint64_t channel_id() const { return channel_id_; }
   void set_channel_id(uint64_t channel_id) { channel_id_ = channel_id; }
 
+  uint64_t seq() const { return seq_; }
+  void set_seq(uint64_t seq) { seq_ = seq; }
+
   static const size_t kSize;
 
  private:
   uint64_t host_id_;
   uint32_t block_index_;
   uint64_t channel_id_;
+  uint64_t seq_;
 };
 
 }  // namespace transport
@@ -16,6 +16,8 @@
 
 #include "cyber/transport/shm/segment.h"
 
+#include <cstring>
+
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 #include "cyber/transport/shm/shm_conf.h"
@@ -26,13 +28,18 @@ namespace transport {
 
 Segment::Segment(uint64_t channel_id)
     : init_(false),
+      ring_mode_(false),
       conf_(),
       channel_id_(channel_id),
       state_(nullptr),
       blocks_(nullptr),
       managed_shm_(nullptr),
       block_buf_lock_(),
-      block_buf_addrs_() {}
+      block_buf_addrs_(),
+      ring_read_block_(),
+      ring_read_buf_(),
+      overrun_count_(0),
+      pinned_count_(0) {}
 
 bool Segment::AcquireBlockToWrite(std::size_t msg_size,
                                   WritableBlock* writable_block) {
@@ -42,24 +49,19 @@ bool Segment::AcquireBlockToWrite(std::size_t msg_size,
     return false;
   }
 
-  bool result = true;
-  if (state_->need_remap()) {
-    result = Remap();
+  if (!UpdateToWrite(msg_size)) {
+    return false;
   }
 
-  if (msg_size > conf_.ceiling_msg_size()) {
-    AINFO << "msg_size: " << msg_size
-          << " larger than current shm_buffer_size: "
-          << conf_.ceiling_msg_size() << " , need recreate.";
-    result = Recreate(msg_size);
+  if (state_->ring_mode()) {
+    AcquireRingBlockToWrite(writable_block);
+    return true;
   }
 
-  if (!result) {
-    AERROR << "segment update failed.";
+  uint32_t index = 0;
+  if (!GetNextWritableBlockIndex(&index)) {
     return false;
   }
-
-  uint32_t index = GetNextWritableBlockIndex();
   writable_block->index = index;
   writable_block->block = &blocks_[index];
   writable_block->buf = block_buf_addrs_[index];
@@ -71,6 +73,11 @@ void Segment::ReleaseWrittenBlock(const WritableBlock& writable_block) {
   if (index >= conf_.block_num()) {
     return;
   }
+  if (state_->ring_mode()) {
+    blocks_[index].seq_.store(2 * writable_block.seq + 2,
+                              std::memory_order_release);
+    return;
+  }
   blocks_[index].ReleaseWriteLock();
 }
 
@@ -87,6 +94,11 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
     return false;
   }
 
+  if (state_->need_remap() && pinned_count_.load() > 0) {
+    AWARN << "segment is pinned by lent blocks, can't remap it now.";
+    return false;
+  }
+
   bool result = true;
   if (state_->need_remap()) {
     result = Remap();
@@ -97,6 +109,10 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
     return false;
   }
 
+  if (state_->ring_mode()) {
+    return AcquireRingBlockToRead(readable_block);
+  }
+
   if (!blocks_[index].TryLockForRead()) {
     return false;
   }
@@ -110,9 +126,63 @@ void Segment::ReleaseReadBlock(const ReadableBlock& readable_block) {
   if (index >= conf_.block_num()) {
     return;
   }
+  if (state_->ring_mode()) {
+    return;
+  }
   blocks_[index].ReleaseReadLock();
 }
 
+bool Segment::AcquireBlockToLend(std::size_t msg_size,
+                                 WritableBlock* writable_block) {
+  RETURN_VAL_IF_NULL(writable_block, false);
+  if (!init_ && !OpenOrCreate()) {
+    AERROR << "create shm failed, can't lend now.";
+    return false;
+  }
+  if (state_->ring_mode()) {
+    ADEBUG << "ring mode blocks can't be lent.";
+    return false;
+  }
+  if (!UpdateToWrite(msg_size)) {
+    return false;
+  }
+
+  const auto block_num = conf_.block_num();
+  for (uint32_t i = 0; i < block_num; ++i) {
+    uint32_t try_idx = state_->FetchAddSeq(1) % block_num;
+    if (blocks_[try_idx].TryLockForWrite()) {
+      writable_block->index = try_idx;
+      writable_block->block = &blocks_[try_idx];
+      writable_block->buf = block_buf_addrs_[try_idx];
+      PinMapping();
+      return true;
+    }
+  }
+  AWARN << "all " << block_num << " blocks are held, nothing to lend.";
+  return false;
+}
+
+bool Segment::PublishLentBlock(const WritableBlock& writable_block) {
+  auto index = writable_block.index;
+  if (index >= conf_.block_num()) {
+    return false;
+  }
+  return blocks_[index].DowngradeWriteLock();
+}
+
+void Segment::ReleaseLentBlock(const WritableBlock& writable_block,
+                               bool published) {
+  auto index = writable_block.index;
+  if (index < conf_.block_num()) {
+    if (published) {
+      blocks_[index].ReleaseReadLock();
+    } else {
+      blocks_[index].ReleaseWriteLock();
+    }
+  }
+  UnpinMapping();
+}
+
 bool Segment::Destroy() {
   if (!init_) {
     return true;
@@ -133,6 +203,32 @@ bool Segment::Destroy() {
   return true;
 }
 
+bool Segment::UpdateToWrite(std::size_t msg_size) {
+  if (pinned_count_.load() > 0 &&
+      (state_->need_remap() || msg_size > conf_.ceiling_msg_size())) {
+    AWARN << "segment is pinned by lent blocks, can't update it now.";
+    return false;
+  }
+
+  bool result = true;
+  if (state_->need_remap()) {
+    result = Remap();
+  }
+
+  if (msg_size > conf_.ceiling_msg_size()) {
+    AINFO << "msg_size: " << msg_size
+          << " larger than current shm_buffer_size: "
+          << conf_.ceiling_msg_size() << " , need recreate.";
+    result = Recreate(msg_size);
+  }
+
+  if (!result) {
+    AERROR << "segment update failed.";
+    return false;
+  }
+  return true;
+}
+
 bool Segment::Remap() {
   init_ = false;
   ADEBUG << "before reset.";
@@ -150,15 +246,83 @@ bool Segment::Recreate(const uint64_t& msg_size) {
   return OpenOrCreate();
 }
 
-uint32_t Segment::GetNextWritableBlockIndex() {
+bool Segment::GetNextWritableBlockIndex(uint32_t* index) {
+  // lent blocks stay locked as long as the application holds them, so the
+  // blocks are tried once instead of waiting for one of them
   const auto block_num = conf_.block_num();
-  while (1) {
+  for (uint32_t i = 0; i < block_num; ++i) {
     uint32_t try_idx = state_->FetchAddSeq(1) % block_num;
     if (blocks_[try_idx].TryLockForWrite()) {
-      return try_idx;
+      *index = try_idx;
+      return true;
+    }
+  }
+  AWARN << "all " << block_num << " blocks are held, can't write now.";
+  return false;
+}
+
+void Segment::AcquireRingBlockToWrite(WritableBlock* writable_block) {
+  const auto block_num = conf_.block_num();
+  while (1) {
+    uint64_t seq = state_->FetchAddRingSeq(1);
+    uint32_t index = static_cast<uint32_t>(seq % block_num);
+    Block* block = &blocks_[index];
+    // Readers never hold the block. The slot is only given up when a writer
+    // from another lap still owns it or already published a newer seq, and
+    // then a fresh seq is taken instead of waiting on this slot.
+    uint64_t current = block->seq_.load(std::memory_order_relaxed);
+    if ((current & 1) || current > 2 * seq + 1) {
+      continue;
+    }
+    if (!block->seq_.compare_exchange_strong(current, 2 * seq + 1,
+                                             std::memory_order_relaxed)) {
+      continue;
     }
+    std::atomic_thread_fence(std::memory_order_release);
+    writable_block->index = index;
+    writable_block->block = block;
+    writable_block->buf = block_buf_addrs_[index];
+    writable_block->seq = seq;
+    return;
   }
-  return 0;
+}
+
+bool Segment::AcquireRingBlockToRead(ReadableBlock* readable_block) {
+  auto index = readable_block->index;
+  const uint64_t published = 2 * readable_block->seq + 2;
+  Block* block = &blocks_[index];
+
+  uint64_t before = block->seq_.load(std::memory_order_acquire);
+  if (before != published) {
+    if (before > published) {
+      overrun_count_.fetch_add(1);
+      ADEBUG << "block[" << index << "] overrun, seq: " << readable_block->seq;
+    }
+    return false;
+  }
+
+  uint64_t msg_size = block->msg_size();
+  uint64_t msg_info_size = block->msg_info_size();
+  bool torn = msg_size + msg_info_size > conf_.block_buf_size();
+  if (!torn) {
+    ring_read_buf_.resize(msg_size + msg_info_size);
+    std::memcpy(ring_read_buf_.data(), block_buf_addrs_[index],
+                msg_size + msg_info_size);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (torn || block->seq_.load(std::memory_order_relaxed) != published) {
+    overrun_count_.fetch_add(1);
+    ADEBUG << "block[" << index << "] overwritten while reading, seq: "
+           << readable_block->seq;
+    return false;
+  }
+
+  ring_read_block_.set_msg_size(msg_size);
+  ring_read_block_.set_msg_info_size(msg_info_size);
+  readable_block->block = &ring_read_block_;
+  readable_block->buf = ring_read_buf_.data();
+  readable_block->snapshot = true;
+  return true;
 }
 
 }  // namespace transport
@@ -17,10 +17,12 @@
 #ifndef CYBER_TRANSPORT_SHM_SEGMENT_H_
 #define CYBER_TRANSPORT_SHM_SEGMENT_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/transport/shm/block.h"
 #include "cyber/transport/shm/shm_conf.h"
@@ -37,6 +39,11 @@ struct WritableBlock {
   uint32_t index = 0;
   Block* block = nullptr;
   uint8_t* buf = nullptr;
+  // ring mode only, the sequence number this block is written with
+  uint64_t seq = 0;
+  // ring mode reads only, buf is a private copy that the next read of the
+  // segment overwrites
+  bool snapshot = false;
 };
 using ReadableBlock = WritableBlock;
 
@@ -48,9 +55,31 @@ class Segment {
   bool AcquireBlockToWrite(std::size_t msg_size, WritableBlock* writable_block);
   void ReleaseWrittenBlock(const WritableBlock& writable_block);
 
+  // In ring mode the block is copied out of shared memory and checked against
+  // readable_block->seq, the returned block stays valid until the next call.
   bool AcquireBlockToRead(ReadableBlock* readable_block);
   void ReleaseReadBlock(const ReadableBlock& readable_block);
 
+  // Zero-copy loans, lock mode only: ring writers never wait for readers, so
+  // a ring block can't be kept. A lent block is write locked until it is
+  // published, then read locked until it is released. Gives up instead of
+  // spinning when every block is held.
+  bool AcquireBlockToLend(std::size_t msg_size, WritableBlock* writable_block);
+  bool PublishLentBlock(const WritableBlock& writable_block);
+  void ReleaseLentBlock(const WritableBlock& writable_block, bool published);
+
+  // A block kept past the call that acquired it pins the current mapping,
+  // the segment is not remapped or recreated while any pin is held.
+  void PinMapping() { pinned_count_.fetch_add(1); }
+  void UnpinMapping() { pinned_count_.fetch_sub(1); }
+
+  // Only takes effect when this segment creates the shared memory, the mode
+  // of an existing segment is read from its state.
+  void set_ring_mode(bool ring_mode) { ring_mode_ = ring_mode; }
+  bool ring_mode() const { return state_ != nullptr && state_->ring_mode(); }
+  // Number of ring blocks overwritten before or while they were read.
+  uint64_t overrun_count() const { return overrun_count_.load(); }
+
  protected:
   virtual bool Destroy();
   virtual void Reset() = 0;
@@ -59,6 +88,7 @@ class Segment {
   virtual bool OpenOrCreate() = 0;
 
   bool init_;
+  bool ring_mode_;
   ShmConf conf_;
   uint64_t channel_id_;
 
@@ -71,7 +101,15 @@ class Segment {
  private:
   bool Remap();
   bool Recreate(const uint64_t& msg_size);
-  uint32_t GetNextWritableBlockIndex();
+  bool UpdateToWrite(std::size_t msg_size);
+  bool GetNextWritableBlockIndex(uint32_t* index);
+  void AcquireRingBlockToWrite(WritableBlock* writable_block);
+  bool AcquireRingBlockToRead(ReadableBlock* readable_block);
+
+  Block ring_read_block_;
+  std::vector<uint8_t> ring_read_buf_;
+  std::atomic<uint64_t> overrun_count_;
+  std::atomic<uint32_t> pinned_count_;
 };
 
 }  // namespace transport
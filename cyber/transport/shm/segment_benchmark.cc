@@ -0,0 +1,230 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Throughput and write-to-read latency of one shm segment shared by 1-8
+// writers and 1-16 readers, in "lock" and "ring" segment mode. Every thread
+// owns its own Segment, as separate processes would. Notifications go through
+// an in-process broadcast ring shaped like ConditionNotifier, so readers see
+// the same (index, seq) stream the ShmDispatcher does.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/transport/shm/posix_segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+constexpr std::size_t kMsgSize = 64 * 1024;
+constexpr int kMessagesPerWriter = 2000;
+constexpr uint64_t kNotifyBufLength = 4096;
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct Notification {
+  std::atomic<uint64_t> tag = {0};
+  uint32_t index = 0;
+  uint64_t seq = 0;
+};
+
+class NotifyRing {
+ public:
+  void Notify(uint32_t index, uint64_t seq) {
+    uint64_t n = next_.fetch_add(1);
+    auto& slot = slots_[n % kNotifyBufLength];
+    slot.index = index;
+    slot.seq = seq;
+    slot.tag.store(n + 1, std::memory_order_release);
+  }
+
+  // 1: got one, 0: nothing yet, -1: reader fell behind and n was dropped
+  int Listen(uint64_t n, uint32_t* index, uint64_t* seq) {
+    auto& slot = slots_[n % kNotifyBufLength];
+    uint64_t tag = slot.tag.load(std::memory_order_acquire);
+    if (tag < n + 1) {
+      return 0;
+    }
+    if (tag > n + 1) {
+      return -1;
+    }
+    *index = slot.index;
+    *seq = slot.seq;
+    return 1;
+  }
+
+ private:
+  std::atomic<uint64_t> next_ = {0};
+  Notification slots_[kNotifyBufLength];
+};
+
+void BM_SegmentWriteRead(benchmark::State& state) {
+  static uint64_t channel_id = 0x5e9b0000;
+  const bool ring_mode = state.range(0) != 0;
+  const int writer_num = static_cast<int>(state.range(1));
+  const int reader_num = static_cast<int>(state.range(2));
+  const uint64_t total = static_cast<uint64_t>(writer_num) * kMessagesPerWriter;
+
+  std::vector<uint64_t> latencies;
+  uint64_t read_count = 0;
+  uint64_t overrun_count = 0;
+  uint64_t dropped_count = 0;
+  double elapsed_s = 0.0;
+
+  for (auto _ : state) {
+    ++channel_id;
+    // create the segment at full size before anyone starts writing
+    PosixSegment creator(channel_id);
+    creator.set_ring_mode(ring_mode);
+    WritableBlock init_block;
+    if (!creator.AcquireBlockToWrite(kMsgSize, &init_block)) {
+      state.SkipWithError("create segment failed");
+      break;
+    }
+    creator.ReleaseWrittenBlock(init_block);
+
+    auto notify_ring = std::make_unique<NotifyRing>();
+    std::atomic<int> writers_done = {0};
+    std::vector<std::vector<uint64_t>> reader_latencies(reader_num);
+    std::vector<uint64_t> reader_overruns(reader_num, 0);
+    std::vector<uint64_t> reader_dropped(reader_num, 0);
+
+    std::vector<std::thread> threads;
+    const uint64_t start_ns = NowNs();
+    for (int r = 0; r < reader_num; ++r) {
+      threads.emplace_back([&, r]() {
+        PosixSegment segment(channel_id);
+        auto& local = reader_latencies[r];
+        local.reserve(total);
+        uint64_t n = 0;
+        while (n < total) {
+          uint32_t index = 0;
+          uint64_t seq = 0;
+          int ret = notify_ring->Listen(n, &index, &seq);
+          if (ret == 0) {
+            if (writers_done.load() == writer_num &&
+                notify_ring->Listen(n, &index, &seq) == 0) {
+              break;
+            }
+            std::this_thread::yield();
+            continue;
+          }
+          ++n;
+          if (ret < 0) {
+            ++reader_dropped[r];
+            continue;
+          }
+          ReadableBlock rb;
+          rb.index = index;
+          rb.seq = seq;
+          if (!segment.AcquireBlockToRead(&rb)) {
+            continue;
+          }
+          uint64_t sent_ns = 0;
+          std::memcpy(&sent_ns, rb.buf, sizeof(sent_ns));
+          local.push_back(NowNs() - sent_ns);
+          segment.ReleaseReadBlock(rb);
+        }
+        reader_overruns[r] = segment.overrun_count();
+      });
+    }
+    for (int w = 0; w < writer_num; ++w) {
+      threads.emplace_back([&]() {
+        PosixSegment segment(channel_id);
+        std::vector<uint8_t> payload(kMsgSize, 0xAB);
+        for (int i = 0; i < kMessagesPerWriter; ++i) {
+          WritableBlock wb;
+          if (!segment.AcquireBlockToWrite(kMsgSize, &wb)) {
+            continue;
+          }
+          uint64_t now_ns = NowNs();
+          std::memcpy(payload.data(), &now_ns, sizeof(now_ns));
+          std::memcpy(wb.buf, payload.data(), kMsgSize);
+          wb.block->set_msg_size(kMsgSize);
+          wb.block->set_msg_info_size(0);
+          segment.ReleaseWrittenBlock(wb);
+          notify_ring->Notify(wb.index, wb.seq);
+        }
+        writers_done.fetch_add(1);
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    elapsed_s += static_cast<double>(NowNs() - start_ns) * 1e-9;
+
+    for (int r = 0; r < reader_num; ++r) {
+      read_count += reader_latencies[r].size();
+      latencies.insert(latencies.end(), reader_latencies[r].begin(),
+                       reader_latencies[r].end());
+      overrun_count += reader_overruns[r];
+      dropped_count += reader_dropped[r];
+    }
+  }
+
+  const double iterations = static_cast<double>(state.iterations());
+  if (latencies.empty() || iterations == 0) {
+    return;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile_us = [&latencies](double p) {
+    size_t idx = static_cast<size_t>(p * (latencies.size() - 1));
+    return static_cast<double>(latencies[idx]) * 1e-3;
+  };
+  state.counters["write_msg/s"] = iterations * total / elapsed_s;
+  state.counters["read_msg/s"] = read_count / elapsed_s;
+  state.counters["p50_us"] = percentile_us(0.5);
+  state.counters["p99_us"] = percentile_us(0.99);
+  state.counters["max_us"] = percentile_us(1.0);
+  state.counters["overrun"] = overrun_count / iterations;
+  state.counters["dropped"] = dropped_count / iterations;
+  state.SetLabel(ring_mode ? "ring" : "lock");
+}
+
+void SegmentArgs(benchmark::internal::Benchmark* b) {
+  for (int ring_mode : {0, 1}) {
+    for (int writers : {1, 2, 4, 8}) {
+      for (int readers : {1, 4, 16}) {
+        b->Args({ring_mode, writers, readers});
+      }
+    }
+  }
+  b->ArgNames({"ring", "writers", "readers"});
+  b->Iterations(3)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK(BM_SegmentWriteRead)->Apply(SegmentArgs);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
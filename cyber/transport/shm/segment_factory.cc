@@ -39,13 +39,23 @@ auto SegmentFactory::CreateSegment(uint64_t channel_id) -> SegmentPtr {
     segment_type = shm_conf.transport_conf().shm_conf().shm_type();
   }
 
-  ADEBUG << "segment type: " << segment_type;
+  bool ring_mode = false;
+  if (shm_conf.has_transport_conf() &&
+      shm_conf.transport_conf().has_shm_conf() &&
+      shm_conf.transport_conf().shm_conf().has_segment_mode()) {
+    ring_mode = shm_conf.transport_conf().shm_conf().segment_mode() == "ring";
+  }
 
+  ADEBUG << "segment type: " << segment_type << ", ring mode: " << ring_mode;
+
+  SegmentPtr segment = nullptr;
   if (segment_type == PosixSegment::Type()) {
-    return std::make_shared<PosixSegment>(channel_id);
+    segment = std::make_shared<PosixSegment>(channel_id);
+  } else {
+    segment = std::make_shared<XsiSegment>(channel_id);
   }
-
-  return std::make_shared<XsiSegment>(channel_id);
+  segment->set_ring_mode(ring_mode);
+  return segment;
 }
 
 }  // namespace transport
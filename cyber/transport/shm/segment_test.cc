@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/transport/shm/posix_segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+bool Write(Segment* segment, const std::string& msg, WritableBlock* wb) {
+  if (!segment->AcquireBlockToWrite(msg.size(), wb)) {
+    return false;
+  }
+  std::memcpy(wb->buf, msg.data(), msg.size());
+  wb->block->set_msg_size(msg.size());
+  wb->block->set_msg_info_size(0);
+  segment->ReleaseWrittenBlock(*wb);
+  return true;
+}
+
+std::string Read(const ReadableBlock& rb) {
+  return std::string(reinterpret_cast<char*>(rb.buf), rb.block->msg_size());
+}
+
+}  // namespace
+
+TEST(SegmentTest, lock_mode) {
+  PosixSegment writer(0x5e9e01);
+  PosixSegment reader(0x5e9e01);
+
+  WritableBlock wb;
+  ASSERT_TRUE(Write(&writer, "hello", &wb));
+  EXPECT_FALSE(writer.ring_mode());
+
+  ReadableBlock rb;
+  rb.index = wb.index;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  EXPECT_EQ("hello", Read(rb));
+  reader.ReleaseReadBlock(rb);
+}
+
+TEST(SegmentTest, ring_mode) {
+  PosixSegment writer(0x5e9e02);
+  writer.set_ring_mode(true);
+  PosixSegment reader(0x5e9e02);
+
+  WritableBlock wb1;
+  ASSERT_TRUE(Write(&writer, "first", &wb1));
+  WritableBlock wb2;
+  ASSERT_TRUE(Write(&writer, "second", &wb2));
+  EXPECT_TRUE(writer.ring_mode());
+  EXPECT_EQ(wb1.seq + 1, wb2.seq);
+
+  ReadableBlock rb;
+  rb.index = wb2.index;
+  rb.seq = wb2.seq;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  // the mode follows the creator of the segment
+  EXPECT_TRUE(reader.ring_mode());
+  EXPECT_EQ("second", Read(rb));
+  reader.ReleaseReadBlock(rb);
+
+  rb.index = wb1.index;
+  rb.seq = wb1.seq;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  EXPECT_EQ("first", Read(rb));
+  reader.ReleaseReadBlock(rb);
+  EXPECT_EQ(0, reader.overrun_count());
+}
+
+TEST(SegmentTest, ring_mode_overrun) {
+  PosixSegment writer(0x5e9e03);
+  writer.set_ring_mode(true);
+  PosixSegment reader(0x5e9e03);
+
+  WritableBlock first;
+  ASSERT_TRUE(Write(&writer, "first", &first));
+  // lap the ring until the first block is overwritten
+  WritableBlock wb;
+  do {
+    ASSERT_TRUE(Write(&writer, "newer", &wb));
+  } while (wb.index != first.index);
+
+  ReadableBlock rb;
+  rb.index = first.index;
+  rb.seq = first.seq;
+  EXPECT_FALSE(reader.AcquireBlockToRead(&rb));
+  EXPECT_EQ(1, reader.overrun_count());
+
+  rb.seq = wb.seq;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  EXPECT_EQ("newer", Read(rb));
+  reader.ReleaseReadBlock(rb);
+}
+
+TEST(SegmentTest, ring_mode_writer_ignores_readers) {
+  PosixSegment writer(0x5e9e04);
+  writer.set_ring_mode(true);
+  PosixSegment reader(0x5e9e04);
+
+  WritableBlock wb;
+  ASSERT_TRUE(Write(&writer, "held", &wb));
+  ReadableBlock rb;
+  rb.index = wb.index;
+  rb.seq = wb.seq;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+
+  // the reader does not release, writers still cycle through every block
+  WritableBlock next;
+  do {
+    ASSERT_TRUE(Write(&writer, "next", &next));
+  } while (next.index != wb.index);
+  // the snapshot taken by the reader is unaffected
+  EXPECT_EQ("held", Read(rb));
+  reader.ReleaseReadBlock(rb);
+}
+
+TEST(SegmentTest, lend_block) {
+  PosixSegment writer(0x5e9e05);
+  PosixSegment reader(0x5e9e05);
+
+  WritableBlock lent;
+  ASSERT_TRUE(writer.AcquireBlockToLend(5, &lent));
+  std::memcpy(lent.buf, "lent!", 5);
+  lent.block->set_msg_size(5);
+  lent.block->set_msg_info_size(0);
+
+  // write locked until published
+  ReadableBlock rb;
+  rb.index = lent.index;
+  EXPECT_FALSE(reader.AcquireBlockToRead(&rb));
+  ASSERT_TRUE(writer.PublishLentBlock(lent));
+  EXPECT_FALSE(writer.PublishLentBlock(lent));
+
+  // published blocks are shared with readers, writers skip them
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  EXPECT_EQ("lent!", Read(rb));
+  WritableBlock wb;
+  ASSERT_TRUE(Write(&writer, "other", &wb));
+  EXPECT_NE(lent.index, wb.index);
+  reader.ReleaseReadBlock(rb);
+  writer.ReleaseLentBlock(lent, true);
+}
+
+TEST(SegmentTest, lend_block_pins_mapping) {
+  PosixSegment writer(0x5e9e06);
+
+  WritableBlock lent;
+  ASSERT_TRUE(writer.AcquireBlockToLend(16, &lent));
+  // growing the segment would unmap the lent block
+  WritableBlock wb;
+  EXPECT_FALSE(writer.AcquireBlockToWrite(1024 * 1024, &wb));
+  writer.ReleaseLentBlock(lent, false);
+  ASSERT_TRUE(writer.AcquireBlockToWrite(1024 * 1024, &wb));
+  writer.ReleaseWrittenBlock(wb);
+}
+
+TEST(SegmentTest, lend_all_blocks) {
+  PosixSegment writer(0x5e9e08);
+
+  std::vector<WritableBlock> lent;
+  WritableBlock block;
+  while (writer.AcquireBlockToLend(16, &block)) {
+    lent.push_back(block);
+  }
+  ASSERT_FALSE(lent.empty());
+
+  // a write fails instead of waiting for the application to give one back
+  WritableBlock wb;
+  EXPECT_FALSE(Write(&writer, "hello", &wb));
+  writer.ReleaseLentBlock(lent.back(), false);
+  ASSERT_TRUE(Write(&writer, "hello", &wb));
+  EXPECT_EQ(lent.back().index, wb.index);
+  lent.pop_back();
+  for (const auto& lent_block : lent) {
+    writer.ReleaseLentBlock(lent_block, false);
+  }
+}
+
+TEST(SegmentTest, lend_block_ring_mode) {
+  PosixSegment writer(0x5e9e07);
+  writer.set_ring_mode(true);
+
+  WritableBlock lent;
+  EXPECT_FALSE(writer.AcquireBlockToLend(16, &lent));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
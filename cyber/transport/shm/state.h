@@ -46,6 +46,12 @@ class State {
   uint32_t FetchAddSeq(uint32_t diff) { return seq_.fetch_add(diff); }
   uint32_t seq() { return seq_.load(); }
 
+  uint64_t FetchAddRingSeq(uint64_t diff) { return ring_seq_.fetch_add(diff); }
+  uint64_t ring_seq() { return ring_seq_.load(); }
+
+  void set_ring_mode(bool ring_mode) { ring_mode_.store(ring_mode); }
+  bool ring_mode() { return ring_mode_.load(); }
+
   void set_need_remap(bool need) { need_remap_.store(need); }
   bool need_remap() { return need_remap_; }
 
@@ -57,6 +63,8 @@ class State {
   std::atomic<uint32_t> seq_ = {0};
   std::atomic<uint32_t> reference_count_ = {0};
   std::atomic<uint64_t> ceiling_msg_size_;
+  std::atomic<bool> ring_mode_ = {false};
+  std::atomic<uint64_t> ring_seq_ = {0};
 };
 
 }  // namespace transport
@@ -84,6 +84,7 @@ bool XsiSegment::OpenOrCreate() {
     shmctl(shmid, IPC_RMID, 0);
     return false;
   }
+  state_->set_ring_mode(ring_mode_);
 
   conf_.Update(state_->ceiling_msg_size());
 
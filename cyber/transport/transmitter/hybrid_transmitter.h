@@ -71,6 +71,8 @@ class HybridTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  std::shared_ptr<message::LoanedMessage> Loan(std::size_t msg_size) override;
+
  private:
   void InitMode();
   void ObtainConfig();
@@ -171,6 +173,17 @@ bool HybridTransmitter<M>::Transmit(const MessagePtr& msg,
   return true;
 }
 
+template <typename M>
+std::shared_ptr<message::LoanedMessage> HybridTransmitter<M>::Loan(
+    std::size_t msg_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = transmitters_.find(OptionalMode::SHM);
+  if (it == transmitters_.end()) {
+    return nullptr;
+  }
+  return it->second->Loan(msg_size);
+}
+
 template <typename M>
 void HybridTransmitter<M>::InitMode() {
   mode_ = std::make_shared<proto::CommunicationMode>();
@@ -27,6 +27,7 @@
 #include "cyber/common/util.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/shm/notifier_factory.h"
+#include "cyber/transport/shm/loaned_block.h"
 #include "cyber/transport/shm/readable_info.h"
 #include "cyber/transport/shm/segment_factory.h"
 #include "cyber/transport/transmitter/transmitter.h"
@@ -48,8 +49,11 @@ class ShmTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  std::shared_ptr<LoanedMessage> Loan(std::size_t msg_size) override;
+
  private:
   bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Notify(const WritableBlock& wb);
 
   SegmentPtr segment_;
   uint64_t channel_id_;
@@ -94,9 +98,33 @@ void ShmTransmitter<M>::Disable() {
 template <typename M>
 bool ShmTransmitter<M>::Transmit(const MessagePtr& msg,
                                  const MessageInfo& msg_info) {
+  // a message lent by this segment is already in place, publish it as is
+  auto loaned_block = GetLoanedBlock(*msg);
+  if (this->enabled_ && loaned_block != nullptr &&
+      loaned_block->segment() == segment_ &&
+      loaned_block->Publish(message::ByteSize(*msg), msg_info)) {
+    return Notify(loaned_block->writable_block());
+  }
   return Transmit(*msg, msg_info);
 }
 
+template <typename M>
+std::shared_ptr<LoanedMessage> ShmTransmitter<M>::Loan(std::size_t msg_size) {
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return nullptr;
+  }
+
+  WritableBlock wb;
+  if (!segment_->AcquireBlockToLend(msg_size, &wb)) {
+    ADEBUG << "no block to lend.";
+    return nullptr;
+  }
+  auto loaned_block = std::make_shared<LoanedBlock>(segment_, wb);
+  return std::make_shared<LoanedMessage>(wb.buf, msg_size, msg_size,
+                                         loaned_block);
+}
+
 template <typename M>
 bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   if (!this->enabled_) {
@@ -127,8 +155,12 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   }
   wb.block->set_msg_info_size(MessageInfo::kSize);
   segment_->ReleaseWrittenBlock(wb);
+  return Notify(wb);
+}
 
-  ReadableInfo readable_info(host_id_, wb.index, channel_id_);
+template <typename M>
+bool ShmTransmitter<M>::Notify(const WritableBlock& wb) {
+  ReadableInfo readable_info(host_id_, wb.index, channel_id_, wb.seq);
 
   ADEBUG << "Writing sharedmem message: "
          << common::GlobalData::GetChannelById(channel_id_)
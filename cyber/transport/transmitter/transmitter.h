@@ -22,6 +22,7 @@
 #include <string>
 
 #include "cyber/event/perf_event_cache.h"
+#include "cyber/message/loaned_message.h"
 #include "cyber/transport/common/endpoint.h"
 #include "cyber/transport/message/message_info.h"
 
@@ -49,6 +50,13 @@ class Transmitter : public Endpoint {
   virtual bool Transmit(const MessagePtr& msg);
   virtual bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) = 0;
 
+  // Lends msg_size bytes of transport memory for a zero-copy message, nullptr
+  // if this transport has nothing to lend.
+  virtual std::shared_ptr<message::LoanedMessage> Loan(std::size_t msg_size) {
+    (void)msg_size;
+    return nullptr;
+  }
+
   uint64_t NextSeqNum() { return ++seq_num_; }
 
   uint64_t seq_num() const { return seq_num_; }
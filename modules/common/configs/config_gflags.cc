@@ -38,6 +38,9 @@ DEFINE_string(park_go_routing_filename, "park_go_routing.txt",
               "Park go routing of the map, support for dreamview contest.");
 DEFINE_string(speed_control_filename, "speed_control.pb.txt",
               "The speed control region in a map.");
+DEFINE_bool(hdmap_lazy_spatial_index, true,
+            "Build each spatial index of the hdmap on its first query instead "
+            "of when the map is loaded.");
 
 DEFINE_string(vehicle_config_path,
               "/apollo/modules/common/data/vehicle_param.pb.txt",
@@ -31,6 +31,7 @@ DECLARE_string(end_way_point_filename);
 DECLARE_string(default_routing_filename);
 DECLARE_string(park_go_routing_filename);
 DECLARE_string(speed_control_filename);
+DECLARE_bool(hdmap_lazy_spatial_index);
 
 DECLARE_double(look_forward_time_sec);
 
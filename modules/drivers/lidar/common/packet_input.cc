@@ -0,0 +1,209 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/drivers/lidar/common/packet_input.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "cyber/cyber.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+PacketStatus PacketInput::NextPacket(LidarPacketView* packet,
+                                     int timeout_ms) {
+  if (ring_.Empty()) {
+    // all packets are handed out, reuse the slots from the start
+    ring_.Clear();
+    const PacketStatus status = Receive(&ring_, timeout_ms);
+    if (status != PacketStatus::OK) {
+      return status;
+    }
+    if (ring_.Empty()) {
+      return PacketStatus::TRUNCATED;
+    }
+    ++batch_num_;
+    packet_num_ += ring_.Size();
+  }
+  ring_.Pop(packet);
+  return PacketStatus::OK;
+}
+
+UdpPacketInput::UdpPacketInput(size_t batch_size, size_t max_packet_size)
+    : PacketInput(batch_size, max_packet_size),
+      messages_(std::max<size_t>(batch_size, 1)),
+      iovecs_(messages_.size()),
+      addresses_(messages_.size()),
+      control_size_(CMSG_SPACE(sizeof(timespec))) {
+  controls_.resize(messages_.size() * control_size_);
+}
+
+UdpPacketInput::~UdpPacketInput() { Close(); }
+
+bool UdpPacketInput::Open(uint16_t port, int receive_buffer_bytes) {
+  Close();
+  port_ = port;
+  fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd_ == -1) {
+    AERROR << "Init socket failed, UDP port is " << port_;
+    return false;
+  }
+
+  if (receive_buffer_bytes > 0 &&
+      setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receive_buffer_bytes,
+                 sizeof(receive_buffer_bytes)) != 0) {
+    AWARN << "Set receive buffer of port " << port_ << " to "
+          << receive_buffer_bytes << " bytes failed: " << strerror(errno);
+  }
+  // without kernel stamps the packets are stamped when they are received
+  int enable = 1;
+  if (setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) !=
+      0) {
+    AWARN << "Kernel timestamps not available on port " << port_ << ": "
+          << strerror(errno);
+  }
+
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port_);
+  address.sin_addr.s_addr = INADDR_ANY;
+  if (bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) ==
+      -1) {
+    AERROR << "Socket bind failed! Port " << port_;
+    Close();
+    return false;
+  }
+  if (fcntl(fd_, F_SETFL, O_NONBLOCK) < 0) {
+    AERROR << "Set non-blocking failed! Port " << port_;
+    Close();
+    return false;
+  }
+  AINFO << "UDP packet input fd is " << fd_ << ", port " << port_;
+  return true;
+}
+
+void UdpPacketInput::Close() {
+  if (fd_ != -1) {
+    (void)close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool UdpPacketInput::WaitReadable(int timeout_ms) {
+  pollfd fds[1];
+  fds[0].fd = fd_;
+  fds[0].events = POLLIN;
+  do {
+    const int retval = poll(fds, 1, timeout_ms);
+    if (retval < 0) {
+      if (errno != EINTR) {
+        AWARN << "Port " << port_ << " poll() error: " << strerror(errno);
+      }
+      return false;
+    }
+    if (retval == 0) {
+      AWARN << "Port " << port_ << " poll() timeout";
+      return false;
+    }
+    if ((fds[0].revents & POLLERR) || (fds[0].revents & POLLHUP) ||
+        (fds[0].revents & POLLNVAL)) {
+      AERROR << "Port " << port_ << " poll() reports error";
+      return false;
+    }
+  } while ((fds[0].revents & POLLIN) == 0);
+  return true;
+}
+
+PacketStatus UdpPacketInput::Receive(PacketRing* ring, int timeout_ms) {
+  if (fd_ == -1) {
+    return PacketStatus::FAIL;
+  }
+  const size_t count = std::min(ring->ContiguousFree(), messages_.size());
+  int received = -1;
+  while (true) {
+    for (size_t i = 0; i < count; ++i) {
+      iovecs_[i].iov_base = ring->FreeSlotData(i);
+      iovecs_[i].iov_len = ring->slot_size();
+      msghdr& header = messages_[i].msg_hdr;
+      header.msg_name = &addresses_[i];
+      header.msg_namelen = sizeof(addresses_[i]);
+      header.msg_iov = &iovecs_[i];
+      header.msg_iovlen = 1;
+      header.msg_control = &controls_[i * control_size_];
+      header.msg_controllen = control_size_;
+      header.msg_flags = 0;
+    }
+    // everything already queued in the socket in one call, poll() only when
+    // the socket is drained
+    received = recvmmsg(fd_, messages_.data(),
+                        static_cast<unsigned int>(count), MSG_DONTWAIT,
+                        nullptr);
+    if (received >= 0) {
+      break;
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      AERROR << "recvmmsg fail from port " << port_ << ": "
+             << strerror(errno);
+      return PacketStatus::FAIL;
+    }
+    if (!WaitReadable(timeout_ms)) {
+      return PacketStatus::TIMEOUT;
+    }
+  }
+
+  const uint64_t now_ns = cyber::Time::Now().ToNanosecond();
+  size_t pushed = 0;
+  for (int i = 0; i < received; ++i) {
+    msghdr& header = messages_[i].msg_hdr;
+    if (header.msg_flags & MSG_TRUNC) {
+      ++truncated_num_;
+      continue;
+    }
+    uint64_t stamp_ns = now_ns;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&header, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET &&
+          cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+        timespec stamp;
+        memcpy(&stamp, CMSG_DATA(cmsg), sizeof(stamp));
+        stamp_ns = static_cast<uint64_t>(stamp.tv_sec) * 1000000000ULL +
+                   static_cast<uint64_t>(stamp.tv_nsec);
+        break;
+      }
+    }
+    // close the gaps of dropped packets
+    if (pushed != static_cast<size_t>(i)) {
+      memmove(ring->FreeSlotData(pushed), ring->FreeSlotData(i),
+              messages_[i].msg_len);
+    }
+    ring->SetFreeSlot(pushed, messages_[i].msg_len, stamp_ns,
+                      addresses_[i].sin_addr.s_addr);
+    ++pushed;
+  }
+  ring->Push(pushed);
+  return PacketStatus::OK;
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "modules/drivers/lidar/common/packet_ring.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+enum class PacketStatus {
+  OK = 0,
+  TIMEOUT,
+  // socket error, or a pcap file that cannot be read
+  FAIL,
+  END_OF_FILE,
+  // every packet of the batch was longer than the ring slots and dropped
+  TRUNCATED,
+};
+
+/**
+ * @brief Packet source shared by the lidar drivers. Packets are received in
+ * batches into a packet ring and handed out one by one, so a driver asking
+ * for one packet at a time only pays a receive call per batch.
+ */
+class PacketInput {
+ public:
+  PacketInput(size_t batch_size, size_t max_packet_size)
+      : ring_(batch_size, max_packet_size) {}
+  virtual ~PacketInput() = default;
+
+  /**
+   * @brief Take the next packet, receiving a new batch when none is left.
+   * The packet data stays valid until the next call.
+   * @param timeout_ms how long to wait for a batch, < 0 waits forever
+   */
+  PacketStatus NextPacket(LidarPacketView* packet, int timeout_ms);
+
+  // received packets not taken yet
+  bool HasPacket() const { return !ring_.Empty(); }
+
+  uint64_t packet_num() const { return packet_num_; }
+  // receive calls that returned packets
+  uint64_t batch_num() const { return batch_num_; }
+  // packets longer than the ring slots, dropped
+  uint64_t truncated_num() const { return truncated_num_; }
+
+ protected:
+  // receive at most ring->ContiguousFree() packets into the ring
+  virtual PacketStatus Receive(PacketRing* ring, int timeout_ms) = 0;
+
+  uint64_t truncated_num_ = 0;
+
+ private:
+  PacketRing ring_;
+  uint64_t packet_num_ = 0;
+  uint64_t batch_num_ = 0;
+};
+
+/**
+ * @brief Live packets of one UDP port, received with recvmmsg and stamped by
+ * the kernel on arrival.
+ */
+class UdpPacketInput : public PacketInput {
+ public:
+  explicit UdpPacketInput(size_t batch_size = 64,
+                          size_t max_packet_size = 1500);
+  ~UdpPacketInput() override;
+
+  /**
+   * @brief Bind to the port on all interfaces.
+   * @param receive_buffer_bytes socket receive buffer, the system default
+   * when 0
+   */
+  bool Open(uint16_t port, int receive_buffer_bytes = 0);
+  void Close();
+
+  int fd() const { return fd_; }
+  uint16_t port() const { return port_; }
+
+ protected:
+  PacketStatus Receive(PacketRing* ring, int timeout_ms) override;
+
+ private:
+  bool WaitReadable(int timeout_ms);
+
+  int fd_ = -1;
+  uint16_t port_ = 0;
+  std::vector<mmsghdr> messages_;
+  std::vector<iovec> iovecs_;
+  std::vector<sockaddr_in> addresses_;
+  std::vector<char> controls_;
+  size_t control_size_ = 0;
+};
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
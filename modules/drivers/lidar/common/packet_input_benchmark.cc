@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Receive cost per lidar packet: a burst of velodyne sized packets is sent
+// over loopback and drained either with a poll and a recvfrom per packet, the
+// way the drivers used to read, or through UdpPacketInput with one recvmmsg
+// per batch. BM_PcapReplay reads a recorded capture as fast as possible:
+//   packet_input_benchmark --benchmark_pcap_file=/path/to/velodyne.pcap
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "modules/drivers/lidar/common/packet_input.h"
+#include "modules/drivers/lidar/common/pcap_packet_input.h"
+
+DEFINE_string(benchmark_pcap_file, "", "pcap capture replayed by the "
+              "BM_PcapReplay benchmark");
+DEFINE_int32(benchmark_pcap_port, 2368, "destination port replayed");
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+namespace {
+
+constexpr uint16_t kReceivePort = 23680;
+constexpr size_t kPacketSize = 1206;
+constexpr int kReceiveBuffer = 8 * 1024 * 1024;
+
+class LoopbackSender {
+ public:
+  explicit LoopbackSender(uint16_t port) : payload_(kPacketSize, 0x5a) {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&address_, 0, sizeof(address_));
+    address_.sin_family = AF_INET;
+    address_.sin_port = htons(port);
+    address_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  }
+  ~LoopbackSender() { close(fd_); }
+
+  void Send(int count) {
+    for (int i = 0; i < count; ++i) {
+      sendto(fd_, payload_.data(), payload_.size(), 0,
+             reinterpret_cast<sockaddr*>(&address_), sizeof(address_));
+    }
+  }
+
+ private:
+  int fd_ = -1;
+  sockaddr_in address_;
+  std::vector<uint8_t> payload_;
+};
+
+int OpenRecvfromSocket(uint16_t port) {
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &kReceiveBuffer,
+             sizeof(kReceiveBuffer));
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = INADDR_ANY;
+  bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  return fd;
+}
+
+void BM_RecvfromLoopback(benchmark::State& state) {
+  const int burst = static_cast<int>(state.range(0));
+  const int fd = OpenRecvfromSocket(kReceivePort);
+  LoopbackSender sender(kReceivePort);
+  uint8_t bytes[kPacketSize];
+  int64_t packets = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    sender.Send(burst);
+    state.ResumeTiming();
+    for (int i = 0; i < burst; ++i) {
+      pollfd fds[1] = {{fd, POLLIN, 0}};
+      if (poll(fds, 1, 100) <= 0) {
+        continue;
+      }
+      if (recvfrom(fd, bytes, kPacketSize, 0, nullptr, nullptr) > 0) {
+        ++packets;
+      }
+    }
+  }
+  close(fd);
+  state.SetItemsProcessed(packets);
+}
+BENCHMARK(BM_RecvfromLoopback)->Arg(64)->Arg(384);
+
+void BM_PacketInputLoopback(benchmark::State& state) {
+  const int burst = static_cast<int>(state.range(0));
+  UdpPacketInput input(static_cast<size_t>(state.range(1)));
+  if (!input.Open(kReceivePort, kReceiveBuffer)) {
+    state.SkipWithError("open failed");
+    return;
+  }
+  LoopbackSender sender(kReceivePort);
+  LidarPacketView packet;
+  int64_t packets = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    sender.Send(burst);
+    state.ResumeTiming();
+    for (int i = 0; i < burst; ++i) {
+      if (input.NextPacket(&packet, 100) == PacketStatus::OK) {
+        ++packets;
+      }
+    }
+  }
+  state.SetItemsProcessed(packets);
+  state.counters["packets_per_batch"] =
+      input.batch_num() > 0 ? static_cast<double>(input.packet_num()) /
+                                  static_cast<double>(input.batch_num())
+                            : 0.0;
+}
+BENCHMARK(BM_PacketInputLoopback)
+    ->Args({64, 16})
+    ->Args({64, 64})
+    ->Args({384, 64})
+    ->Args({384, 128});
+
+void BM_PcapReplay(benchmark::State& state) {
+  if (FLAGS_benchmark_pcap_file.empty()) {
+    state.SkipWithError("no --benchmark_pcap_file");
+    return;
+  }
+  PcapPacketInput input(static_cast<size_t>(state.range(0)));
+  if (!input.Open(FLAGS_benchmark_pcap_file,
+                  static_cast<uint16_t>(FLAGS_benchmark_pcap_port), false,
+                  true)) {
+    state.SkipWithError("open failed");
+    return;
+  }
+  LidarPacketView packet;
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    if (input.NextPacket(&packet, 0) != PacketStatus::OK) {
+      state.SkipWithError("no packet for the port");
+      break;
+    }
+    bytes += static_cast<int64_t>(packet.size);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_PcapReplay)->Arg(64);
+
+}  // namespace
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/lidar/common/packet_input.h"
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+constexpr uint16_t kTestPort = 23690;
+
+class UdpPacketInputTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&address_, 0, sizeof(address_));
+    address_.sin_family = AF_INET;
+    address_.sin_port = htons(kTestPort);
+    address_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  }
+  void TearDown() override { close(fd_); }
+
+  void Send(size_t size, uint8_t value) {
+    const std::vector<uint8_t> payload(size, value);
+    ASSERT_EQ(sendto(fd_, payload.data(), payload.size(), 0,
+                     reinterpret_cast<sockaddr*>(&address_),
+                     sizeof(address_)),
+              static_cast<ssize_t>(size));
+  }
+
+  int fd_ = -1;
+  sockaddr_in address_;
+};
+
+TEST_F(UdpPacketInputTest, batch_test) {
+  UdpPacketInput input(4, 100);
+  ASSERT_TRUE(input.Open(kTestPort));
+  LidarPacketView packet;
+  EXPECT_EQ(input.NextPacket(&packet, 0), PacketStatus::TIMEOUT);
+
+  for (uint8_t i = 0; i < 6; ++i) {
+    Send(50, i);
+  }
+  // one receive call per 4 packets
+  for (uint8_t i = 0; i < 6; ++i) {
+    ASSERT_EQ(input.NextPacket(&packet, 100), PacketStatus::OK);
+    EXPECT_EQ(packet.size, 50);
+    EXPECT_EQ(packet.data[0], i);
+    EXPECT_EQ(packet.source_address, htonl(INADDR_LOOPBACK));
+    EXPECT_GT(packet.stamp_ns, 0);
+  }
+  EXPECT_FALSE(input.HasPacket());
+  EXPECT_EQ(input.packet_num(), 6);
+  EXPECT_EQ(input.batch_num(), 2);
+}
+
+TEST_F(UdpPacketInputTest, truncated_test) {
+  UdpPacketInput input(4, 100);
+  ASSERT_TRUE(input.Open(kTestPort));
+  LidarPacketView packet;
+
+  // oversized packets are dropped and the gaps closed
+  Send(50, 1);
+  Send(200, 2);
+  Send(50, 3);
+  ASSERT_EQ(input.NextPacket(&packet, 100), PacketStatus::OK);
+  EXPECT_EQ(packet.data[0], 1);
+  ASSERT_EQ(input.NextPacket(&packet, 100), PacketStatus::OK);
+  EXPECT_EQ(packet.data[0], 3);
+  EXPECT_EQ(input.truncated_num(), 1);
+
+  // a batch of only oversized packets is no timeout
+  Send(200, 4);
+  Send(200, 5);
+  EXPECT_EQ(input.NextPacket(&packet, 100), PacketStatus::TRUNCATED);
+  EXPECT_EQ(input.truncated_num(), 3);
+  Send(50, 6);
+  ASSERT_EQ(input.NextPacket(&packet, 100), PacketStatus::OK);
+  EXPECT_EQ(packet.data[0], 6);
+  EXPECT_EQ(input.NextPacket(&packet, 0), PacketStatus::TIMEOUT);
+}
+
+TEST_F(UdpPacketInputTest, closed_test) {
+  UdpPacketInput input;
+  LidarPacketView packet;
+  EXPECT_EQ(input.NextPacket(&packet, 0), PacketStatus::FAIL);
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
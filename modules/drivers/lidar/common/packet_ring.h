@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+/**
+ * @brief One received packet. The data belongs to the ring it was taken from
+ * and stays valid until the ring receives again.
+ */
+struct LidarPacketView {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+  // kernel receive time, or capture time for recorded packets
+  uint64_t stamp_ns = 0;
+  // IPv4 source address in network byte order, 0 if unknown
+  uint32_t source_address = 0;
+};
+
+/**
+ * @brief Fixed number of preallocated packet slots in one contiguous buffer.
+ * Packets are received in batches into the free slots after the tail and
+ * taken in order from the head; nothing is allocated after construction.
+ */
+class PacketRing {
+ public:
+  PacketRing(size_t slot_num, size_t slot_size)
+      : slot_num_(std::max<size_t>(slot_num, 1)),
+        slot_size_(slot_size),
+        buffer_(slot_num_ * slot_size_),
+        slots_(slot_num_) {}
+
+  size_t slot_num() const { return slot_num_; }
+  size_t slot_size() const { return slot_size_; }
+  size_t Size() const { return static_cast<size_t>(tail_ - head_); }
+  bool Empty() const { return head_ == tail_; }
+
+  // free slots following the tail without wrapping, the most one batch can
+  // be received into
+  size_t ContiguousFree() const {
+    const size_t tail_pos = static_cast<size_t>(tail_ % slot_num_);
+    return std::min(slot_num_ - Size(), slot_num_ - tail_pos);
+  }
+
+  // data of the i-th free slot after the tail, i < ContiguousFree()
+  uint8_t* FreeSlotData(size_t i) {
+    return &buffer_[SlotPos(tail_ + i) * slot_size_];
+  }
+
+  // fills in the i-th free slot after the tail, it is not readable before
+  // Push()
+  void SetFreeSlot(size_t i, size_t size, uint64_t stamp_ns,
+                   uint32_t source_address) {
+    Slot& slot = slots_[SlotPos(tail_ + i)];
+    slot.size = std::min(size, slot_size_);
+    slot.stamp_ns = stamp_ns;
+    slot.source_address = source_address;
+  }
+
+  // makes the first count free slots readable
+  void Push(size_t count) { tail_ += std::min(count, slot_num_ - Size()); }
+
+  bool Pop(LidarPacketView* packet) {
+    if (Empty()) {
+      return false;
+    }
+    const size_t pos = SlotPos(head_++);
+    const Slot& slot = slots_[pos];
+    packet->data = &buffer_[pos * slot_size_];
+    packet->size = slot.size;
+    packet->stamp_ns = slot.stamp_ns;
+    packet->source_address = slot.source_address;
+    return true;
+  }
+
+  void Clear() { head_ = tail_ = 0; }
+
+ private:
+  struct Slot {
+    size_t size = 0;
+    uint64_t stamp_ns = 0;
+    uint32_t source_address = 0;
+  };
+
+  size_t SlotPos(uint64_t index) const {
+    return static_cast<size_t>(index % slot_num_);
+  }
+
+  size_t slot_num_;
+  size_t slot_size_;
+  std::vector<uint8_t> buffer_;
+  std::vector<Slot> slots_;
+  uint64_t head_ = 0;
+  uint64_t tail_ = 0;
+};
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/lidar/common/packet_ring.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+// fills in count free slots with packets of one byte holding their stamp
+void PushPackets(PacketRing* ring, size_t count, uint64_t first_stamp) {
+  for (size_t i = 0; i < count; ++i) {
+    ring->FreeSlotData(i)[0] = static_cast<uint8_t>(first_stamp + i);
+    ring->SetFreeSlot(i, 1, first_stamp + i, 0);
+  }
+  ring->Push(count);
+}
+
+void ExpectPop(PacketRing* ring, uint64_t stamp) {
+  LidarPacketView packet;
+  ASSERT_TRUE(ring->Pop(&packet));
+  EXPECT_EQ(packet.stamp_ns, stamp);
+  ASSERT_EQ(packet.size, 1);
+  EXPECT_EQ(packet.data[0], static_cast<uint8_t>(stamp));
+}
+
+TEST(PacketRingTest, push_pop_test) {
+  PacketRing ring(4, 16);
+  EXPECT_EQ(ring.slot_num(), 4);
+  EXPECT_EQ(ring.slot_size(), 16);
+  EXPECT_TRUE(ring.Empty());
+  EXPECT_EQ(ring.ContiguousFree(), 4);
+  LidarPacketView packet;
+  EXPECT_FALSE(ring.Pop(&packet));
+
+  ring.FreeSlotData(0)[0] = 7;
+  ring.SetFreeSlot(0, 1, 100, 0x0100a8c0);
+  // not readable before the push
+  EXPECT_TRUE(ring.Empty());
+  ring.Push(1);
+  EXPECT_EQ(ring.Size(), 1);
+  ASSERT_TRUE(ring.Pop(&packet));
+  EXPECT_EQ(packet.data[0], 7);
+  EXPECT_EQ(packet.size, 1);
+  EXPECT_EQ(packet.stamp_ns, 100);
+  EXPECT_EQ(packet.source_address, 0x0100a8c0);
+  EXPECT_TRUE(ring.Empty());
+
+  PushPackets(&ring, 3, 10);
+  EXPECT_EQ(ring.Size(), 3);
+  for (uint64_t stamp = 10; stamp < 13; ++stamp) {
+    ExpectPop(&ring, stamp);
+  }
+  EXPECT_FALSE(ring.Pop(&packet));
+}
+
+TEST(PacketRingTest, clamp_test) {
+  PacketRing ring(4, 16);
+  // sizes are clamped to the slot size
+  ring.SetFreeSlot(0, 100, 1, 0);
+  ring.Push(1);
+  LidarPacketView packet;
+  ASSERT_TRUE(ring.Pop(&packet));
+  EXPECT_EQ(packet.size, 16);
+
+  // pushes are clamped to the free slots
+  ring.Clear();
+  ring.Push(10);
+  EXPECT_EQ(ring.Size(), 4);
+  EXPECT_EQ(ring.ContiguousFree(), 0);
+
+  // a ring has at least one slot
+  PacketRing empty_ring(0, 16);
+  EXPECT_EQ(empty_ring.slot_num(), 1);
+}
+
+TEST(PacketRingTest, wrap_around_test) {
+  PacketRing ring(4, 16);
+  PushPackets(&ring, 3, 0);
+  ExpectPop(&ring, 0);
+  ExpectPop(&ring, 1);
+  // two slots are free, but only the last one before the wrap
+  EXPECT_EQ(ring.ContiguousFree(), 1);
+  PushPackets(&ring, 1, 3);
+  EXPECT_EQ(ring.ContiguousFree(), 2);
+  PushPackets(&ring, 2, 4);
+  EXPECT_EQ(ring.Size(), 4);
+  EXPECT_EQ(ring.ContiguousFree(), 0);
+  // packets come out in order over the wrap
+  for (uint64_t stamp = 2; stamp < 6; ++stamp) {
+    ExpectPop(&ring, stamp);
+  }
+  EXPECT_TRUE(ring.Empty());
+
+  // many rounds keep the order
+  uint64_t next_push = 6;
+  uint64_t next_pop = 6;
+  for (int round = 0; round < 50; ++round) {
+    const size_t count = std::min<size_t>(ring.ContiguousFree(), 3);
+    PushPackets(&ring, count, next_push);
+    next_push += count;
+    ExpectPop(&ring, next_pop++);
+    ExpectPop(&ring, next_pop++);
+  }
+  while (!ring.Empty()) {
+    ExpectPop(&ring, next_pop++);
+  }
+  EXPECT_EQ(next_pop, next_push);
+}
+
+TEST(PacketRingTest, clear_test) {
+  PacketRing ring(4, 16);
+  PushPackets(&ring, 3, 0);
+  ExpectPop(&ring, 0);
+  ring.Clear();
+  EXPECT_TRUE(ring.Empty());
+  EXPECT_EQ(ring.Size(), 0);
+  // a cleared ring receives from the first slot again
+  EXPECT_EQ(ring.ContiguousFree(), 4);
+  PushPackets(&ring, 4, 20);
+  for (uint64_t stamp = 20; stamp < 24; ++stamp) {
+    ExpectPop(&ring, stamp);
+  }
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
@@ -0,0 +1,277 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#include "modules/drivers/lidar/common/pcap_packet_input.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "cyber/cyber.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+namespace {
+
+constexpr uint32_t kPcapMagic = 0xa1b2c3d4;
+constexpr uint32_t kPcapMagicSwapped = 0xd4c3b2a1;
+constexpr uint32_t kPcapNanoMagic = 0xa1b23c4d;
+constexpr uint32_t kPcapNanoMagicSwapped = 0x4d3cb2a1;
+constexpr size_t kFileHeaderSize = 24;
+constexpr size_t kRecordHeaderSize = 16;
+// bigger captured records are not lidar packets
+constexpr uint32_t kMaxRecordSize = 256 * 1024;
+
+constexpr uint32_t kLinkTypeEthernet = 1;
+constexpr uint32_t kLinkTypeRaw = 101;
+constexpr uint32_t kLinkTypeLinuxSll = 113;
+constexpr uint32_t kLinkTypeIpv4 = 228;
+
+constexpr uint16_t kEtherTypeIpv4 = 0x0800;
+constexpr uint16_t kEtherTypeVlan = 0x8100;
+constexpr uint8_t kIpProtocolUdp = 17;
+constexpr size_t kUdpHeaderSize = 8;
+
+uint16_t ReadBigEndian16(const uint8_t* data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+uint64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+PcapPacketInput::PcapPacketInput(size_t batch_size, size_t max_packet_size)
+    : PacketInput(batch_size, max_packet_size) {}
+
+PcapPacketInput::~PcapPacketInput() { Close(); }
+
+bool PcapPacketInput::Open(const std::string& file, uint16_t port,
+                           bool realtime, bool loop) {
+  Close();
+  file_ = file;
+  port_ = port;
+  realtime_ = realtime;
+  loop_ = loop;
+  stream_ = fopen(file_.c_str(), "rb");
+  if (stream_ == nullptr) {
+    AERROR << "Open pcap file " << file_ << " failed";
+    return false;
+  }
+  if (!ReadFileHeader()) {
+    Close();
+    return false;
+  }
+  first_stamp_ns_ = 0;
+  first_release_ns_ = 0;
+  AINFO << "Replay pcap file " << file_ << ", link type " << link_type_
+        << ", port " << port_;
+  return true;
+}
+
+void PcapPacketInput::Close() {
+  if (stream_ != nullptr) {
+    fclose(stream_);
+    stream_ = nullptr;
+  }
+}
+
+uint32_t PcapPacketInput::Swap(uint32_t value) const {
+  return swapped_ ? __builtin_bswap32(value) : value;
+}
+
+bool PcapPacketInput::ReadFileHeader() {
+  uint8_t header[kFileHeaderSize];
+  if (fread(header, 1, kFileHeaderSize, stream_) != kFileHeaderSize) {
+    AERROR << "Pcap file " << file_ << " is too short";
+    return false;
+  }
+  uint32_t magic = 0;
+  memcpy(&magic, header, sizeof(magic));
+  switch (magic) {
+    case kPcapMagic:
+      swapped_ = false;
+      nanosecond_ = false;
+      break;
+    case kPcapMagicSwapped:
+      swapped_ = true;
+      nanosecond_ = false;
+      break;
+    case kPcapNanoMagic:
+      swapped_ = false;
+      nanosecond_ = true;
+      break;
+    case kPcapNanoMagicSwapped:
+      swapped_ = true;
+      nanosecond_ = true;
+      break;
+    default:
+      AERROR << "Unknown pcap magic " << std::hex << magic << " in " << file_
+             << ", pcapng is not supported";
+      return false;
+  }
+  memcpy(&link_type_, header + 20, sizeof(link_type_));
+  link_type_ = Swap(link_type_) & 0x0fffffff;
+  if (link_type_ != kLinkTypeEthernet && link_type_ != kLinkTypeRaw &&
+      link_type_ != kLinkTypeLinuxSll && link_type_ != kLinkTypeIpv4) {
+    AERROR << "Unsupported pcap link type " << link_type_ << " in " << file_;
+    return false;
+  }
+  data_offset_ = ftell(stream_);
+  return true;
+}
+
+PcapPacketInput::ReadResult PcapPacketInput::ReadPacket(
+    uint8_t* data, size_t capacity, size_t* size, uint64_t* stamp_ns,
+    uint32_t* source_address) {
+  uint32_t header[kRecordHeaderSize / sizeof(uint32_t)];
+  const size_t header_read = fread(header, 1, kRecordHeaderSize, stream_);
+  if (header_read == 0 && feof(stream_)) {
+    return ReadResult::END;
+  }
+  if (header_read != kRecordHeaderSize) {
+    AWARN << "Pcap file " << file_ << " ends in a record header";
+    return ReadResult::END;
+  }
+  const uint32_t captured = Swap(header[2]);
+  if (captured > kMaxRecordSize) {
+    AERROR << "Broken pcap record of " << captured << " bytes in " << file_;
+    return ReadResult::ERROR;
+  }
+  record_.resize(captured);
+  if (fread(record_.data(), 1, captured, stream_) != captured) {
+    AWARN << "Pcap file " << file_ << " ends in a record";
+    return ReadResult::END;
+  }
+  const uint64_t fraction = Swap(header[1]);
+  *stamp_ns = static_cast<uint64_t>(Swap(header[0])) * 1000000000ULL +
+              (nanosecond_ ? fraction : fraction * 1000ULL);
+
+  const uint8_t* frame = record_.data();
+  size_t left = captured;
+  if (link_type_ == kLinkTypeEthernet || link_type_ == kLinkTypeLinuxSll) {
+    const size_t link_header = link_type_ == kLinkTypeEthernet ? 14 : 16;
+    if (left < link_header) {
+      return ReadResult::SKIPPED;
+    }
+    uint16_t ether_type = ReadBigEndian16(frame + link_header - 2);
+    frame += link_header;
+    left -= link_header;
+    while (ether_type == kEtherTypeVlan && left >= 4) {
+      ether_type = ReadBigEndian16(frame + 2);
+      frame += 4;
+      left -= 4;
+    }
+    if (ether_type != kEtherTypeIpv4) {
+      return ReadResult::SKIPPED;
+    }
+  }
+
+  // IPv4, unfragmented UDP only
+  if (left < 20 || (frame[0] >> 4) != 4) {
+    return ReadResult::SKIPPED;
+  }
+  const size_t ip_header = static_cast<size_t>(frame[0] & 0x0f) * 4;
+  const uint16_t fragment = ReadBigEndian16(frame + 6);
+  if (ip_header < 20 || left < ip_header + kUdpHeaderSize ||
+      frame[9] != kIpProtocolUdp || (fragment & 0x3fff) != 0) {
+    return ReadResult::SKIPPED;
+  }
+  uint32_t address = 0;
+  memcpy(&address, frame + 12, sizeof(address));
+  frame += ip_header;
+  left -= ip_header;
+  if (port_ != 0 && ReadBigEndian16(frame + 2) != port_) {
+    return ReadResult::SKIPPED;
+  }
+  const size_t udp_size = ReadBigEndian16(frame + 4);
+  if (udp_size < kUdpHeaderSize || udp_size > left) {
+    // cut by the capture snap length
+    return ReadResult::SKIPPED;
+  }
+  const size_t payload = udp_size - kUdpHeaderSize;
+  if (payload > capacity) {
+    ++truncated_num_;
+    return ReadResult::SKIPPED;
+  }
+  memcpy(data, frame + kUdpHeaderSize, payload);
+  *size = payload;
+  *source_address = address;
+  return ReadResult::PACKET;
+}
+
+void PcapPacketInput::WaitForCaptureTime(uint64_t stamp_ns) {
+  if (first_release_ns_ == 0 || stamp_ns < first_stamp_ns_) {
+    first_stamp_ns_ = stamp_ns;
+    first_release_ns_ = SteadyNowNs();
+    return;
+  }
+  const uint64_t release_ns = first_release_ns_ + (stamp_ns - first_stamp_ns_);
+  const uint64_t now_ns = SteadyNowNs();
+  if (release_ns > now_ns) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(release_ns - now_ns));
+  }
+}
+
+PacketStatus PcapPacketInput::Receive(PacketRing* ring, int timeout_ms) {
+  if (stream_ == nullptr) {
+    return PacketStatus::FAIL;
+  }
+  // paced packets are handed out one by one like a live socket would
+  const size_t count = realtime_ ? 1 : ring->ContiguousFree();
+  size_t pushed = 0;
+  bool rewound = false;
+  while (pushed < count) {
+    size_t size = 0;
+    uint64_t stamp_ns = 0;
+    uint32_t source_address = 0;
+    const ReadResult result =
+        ReadPacket(ring->FreeSlotData(pushed), ring->slot_size(), &size,
+                   &stamp_ns, &source_address);
+    if (result == ReadResult::ERROR) {
+      ring->Push(pushed);
+      return pushed > 0 ? PacketStatus::OK : PacketStatus::FAIL;
+    }
+    if (result == ReadResult::END) {
+      // a file without a single matching packet would rewind forever
+      if (!loop_ || pushed > 0 || rewound) {
+        break;
+      }
+      fseek(stream_, data_offset_, SEEK_SET);
+      first_release_ns_ = 0;
+      rewound = true;
+      continue;
+    }
+    if (result == ReadResult::SKIPPED) {
+      continue;
+    }
+    if (realtime_) {
+      WaitForCaptureTime(stamp_ns);
+    }
+    ring->SetFreeSlot(pushed, size, stamp_ns, source_address);
+    ++pushed;
+  }
+  ring->Push(pushed);
+  return pushed > 0 ? PacketStatus::OK : PacketStatus::END_OF_FILE;
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
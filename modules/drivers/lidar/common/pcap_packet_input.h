@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "modules/drivers/lidar/common/packet_input.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+/**
+ * @brief Stand-in for UdpPacketInput that replays the UDP payloads of a pcap
+ * capture (ethernet or raw IPv4), for running drivers and benchmarks
+ * offline. Packets keep their capture time as stamp. Reads as fast as the
+ * ring is drained unless realtime is set, then packets are released at
+ * their captured pace.
+ */
+class PcapPacketInput : public PacketInput {
+ public:
+  explicit PcapPacketInput(size_t batch_size = 64,
+                           size_t max_packet_size = 1500);
+  ~PcapPacketInput() override;
+
+  /**
+   * @param port only UDP packets to this destination port, all if 0
+   */
+  bool Open(const std::string& file, uint16_t port = 0, bool realtime = false,
+            bool loop = false);
+  void Close();
+
+ protected:
+  PacketStatus Receive(PacketRing* ring, int timeout_ms) override;
+
+ private:
+  enum class ReadResult { PACKET, SKIPPED, END, ERROR };
+
+  bool ReadFileHeader();
+  ReadResult ReadPacket(uint8_t* data, size_t capacity, size_t* size,
+                        uint64_t* stamp_ns, uint32_t* source_address);
+  uint32_t Swap(uint32_t value) const;
+  void WaitForCaptureTime(uint64_t stamp_ns);
+
+  std::string file_;
+  FILE* stream_ = nullptr;
+  uint16_t port_ = 0;
+  bool realtime_ = false;
+  bool loop_ = false;
+  bool swapped_ = false;
+  bool nanosecond_ = false;
+  uint32_t link_type_ = 0;
+  long data_offset_ = 0;  // NOLINT
+  std::vector<uint8_t> record_;
+  // first capture time and the wall time it was released at
+  uint64_t first_stamp_ns_ = 0;
+  uint64_t first_release_ns_ = 0;
+};
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
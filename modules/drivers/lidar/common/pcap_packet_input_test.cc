@@ -0,0 +1,254 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/lidar/common/pcap_packet_input.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace drivers {
+namespace lidar {
+
+// classic little endian pcap file with microsecond stamps
+class PcapWriter {
+ public:
+  explicit PcapWriter(uint32_t link_type) {
+    Append32(0xa1b2c3d4);
+    Append16(2);
+    Append16(4);
+    Append32(0);
+    Append32(0);
+    Append32(65535);
+    Append32(link_type);
+  }
+
+  void AddRecord(uint32_t second, uint32_t microsecond,
+                 const std::vector<uint8_t>& frame) {
+    Append32(second);
+    Append32(microsecond);
+    Append32(static_cast<uint32_t>(frame.size()));
+    Append32(static_cast<uint32_t>(frame.size()));
+    data_.insert(data_.end(), frame.begin(), frame.end());
+  }
+
+  // drops the last bytes, like a capture which was cut off
+  void Truncate(size_t size) { data_.resize(data_.size() - size); }
+
+  bool Write(const std::string& file) const {
+    FILE* stream = fopen(file.c_str(), "wb");
+    if (stream == nullptr) {
+      return false;
+    }
+    const bool written =
+        fwrite(data_.data(), 1, data_.size(), stream) == data_.size();
+    fclose(stream);
+    return written;
+  }
+
+ private:
+  void Append16(uint16_t value) {
+    data_.push_back(static_cast<uint8_t>(value));
+    data_.push_back(static_cast<uint8_t>(value >> 8));
+  }
+  void Append32(uint32_t value) {
+    Append16(static_cast<uint16_t>(value));
+    Append16(static_cast<uint16_t>(value >> 16));
+  }
+
+  std::vector<uint8_t> data_;
+};
+
+void AppendBigEndian16(uint16_t value, std::vector<uint8_t>* data) {
+  data->push_back(static_cast<uint8_t>(value >> 8));
+  data->push_back(static_cast<uint8_t>(value));
+}
+
+// IPv4 UDP packet from 192.168.1.201, the payload bytes are all the value
+std::vector<uint8_t> UdpPacket(uint16_t port, size_t payload, uint8_t value,
+                               uint8_t protocol = 17) {
+  const size_t udp_size = 8 + payload;
+  std::vector<uint8_t> packet = {0x45, 0};
+  AppendBigEndian16(static_cast<uint16_t>(20 + udp_size), &packet);
+  packet.insert(packet.end(), {0, 0, 0, 0, 64, protocol, 0, 0});
+  packet.insert(packet.end(), {192, 168, 1, 201, 192, 168, 1, 100});
+  AppendBigEndian16(10000, &packet);
+  AppendBigEndian16(port, &packet);
+  AppendBigEndian16(static_cast<uint16_t>(udp_size), &packet);
+  AppendBigEndian16(0, &packet);
+  packet.insert(packet.end(), payload, value);
+  return packet;
+}
+
+std::vector<uint8_t> EthernetFrame(const std::vector<uint8_t>& packet,
+                                   uint16_t ether_type = 0x0800) {
+  std::vector<uint8_t> frame(12, 0);
+  AppendBigEndian16(ether_type, &frame);
+  frame.insert(frame.end(), packet.begin(), packet.end());
+  return frame;
+}
+
+class PcapPacketInputTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    file_ = "/tmp/pcap_packet_input_test_" +
+            std::string(::testing::UnitTest::GetInstance()
+                            ->current_test_info()
+                            ->name()) +
+            ".pcap";
+  }
+  void TearDown() override { std::remove(file_.c_str()); }
+
+  // payload bytes of all packets until the end of the file
+  std::vector<uint8_t> ReadAll(PcapPacketInput* input) {
+    std::vector<uint8_t> values;
+    LidarPacketView packet;
+    PacketStatus status;
+    while ((status = input->NextPacket(&packet, 0)) == PacketStatus::OK) {
+      EXPECT_GT(packet.size, 0);
+      values.push_back(packet.data[0]);
+    }
+    EXPECT_EQ(status, PacketStatus::END_OF_FILE);
+    return values;
+  }
+
+  std::string file_;
+};
+
+TEST_F(PcapPacketInputTest, ethernet_test) {
+  PcapWriter writer(1);
+  writer.AddRecord(100, 250000, EthernetFrame(UdpPacket(2368, 100, 1)));
+  writer.AddRecord(100, 250100, EthernetFrame(UdpPacket(2368, 100, 2)));
+  ASSERT_TRUE(writer.Write(file_));
+
+  PcapPacketInput input(4, 1500);
+  ASSERT_TRUE(input.Open(file_));
+  LidarPacketView packet;
+  ASSERT_EQ(input.NextPacket(&packet, 0), PacketStatus::OK);
+  EXPECT_EQ(packet.size, 100);
+  EXPECT_EQ(packet.data[0], 1);
+  EXPECT_EQ(packet.data[99], 1);
+  EXPECT_EQ(packet.stamp_ns, 100250000000ULL);
+  const uint8_t address[4] = {192, 168, 1, 201};
+  EXPECT_EQ(memcmp(&packet.source_address, address, 4), 0);
+  ASSERT_EQ(input.NextPacket(&packet, 0), PacketStatus::OK);
+  EXPECT_EQ(packet.data[0], 2);
+  EXPECT_EQ(packet.stamp_ns, 100250100000ULL);
+  EXPECT_EQ(input.NextPacket(&packet, 0), PacketStatus::END_OF_FILE);
+  EXPECT_EQ(input.packet_num(), 2);
+  EXPECT_EQ(input.batch_num(), 1);
+}
+
+TEST_F(PcapPacketInputTest, non_udp_test) {
+  PcapWriter writer(1);
+  writer.AddRecord(1, 0, EthernetFrame(UdpPacket(2368, 10, 1)));
+  // ARP frame
+  writer.AddRecord(1, 1, EthernetFrame(std::vector<uint8_t>(28, 0), 0x0806));
+  // TCP packet
+  writer.AddRecord(1, 2, EthernetFrame(UdpPacket(2368, 10, 2, 6)));
+  // IPv6 frame
+  writer.AddRecord(1, 3, EthernetFrame(std::vector<uint8_t>(48, 0x60),
+                                       0x86dd));
+  // frame shorter than its ethernet header
+  writer.AddRecord(1, 4, std::vector<uint8_t>(6, 0));
+  writer.AddRecord(1, 5, EthernetFrame(UdpPacket(2368, 10, 3)));
+  ASSERT_TRUE(writer.Write(file_));
+
+  PcapPacketInput input(8, 1500);
+  ASSERT_TRUE(input.Open(file_));
+  EXPECT_EQ(ReadAll(&input), std::vector<uint8_t>({1, 3}));
+}
+
+TEST_F(PcapPacketInputTest, port_filter_test) {
+  PcapWriter writer(101);
+  writer.AddRecord(1, 0, UdpPacket(2368, 10, 1));
+  writer.AddRecord(1, 1, UdpPacket(8308, 10, 2));
+  writer.AddRecord(1, 2, UdpPacket(2368, 10, 3));
+  writer.AddRecord(1, 3, UdpPacket(2369, 10, 4));
+  ASSERT_TRUE(writer.Write(file_));
+
+  PcapPacketInput input(8, 1500);
+  ASSERT_TRUE(input.Open(file_, 2368));
+  EXPECT_EQ(ReadAll(&input), std::vector<uint8_t>({1, 3}));
+  ASSERT_TRUE(input.Open(file_, 8308));
+  EXPECT_EQ(ReadAll(&input), std::vector<uint8_t>({2}));
+  // all ports
+  ASSERT_TRUE(input.Open(file_));
+  EXPECT_EQ(ReadAll(&input), std::vector<uint8_t>({1, 2, 3, 4}));
+}
+
+TEST_F(PcapPacketInputTest, truncated_test) {
+  PcapWriter writer(1);
+  writer.AddRecord(1, 0, EthernetFrame(UdpPacket(2368, 100, 1)));
+  // UDP packet cut by the snap length
+  std::vector<uint8_t> cut = EthernetFrame(UdpPacket(2368, 100, 2));
+  cut.resize(cut.size() - 50);
+  writer.AddRecord(1, 1, cut);
+  // payload bigger than the ring slots
+  writer.AddRecord(1, 2, EthernetFrame(UdpPacket(2368, 300, 3)));
+  writer.AddRecord(1, 3, EthernetFrame(UdpPacket(2368, 100, 4)));
+  // the capture ends in the last record
+  writer.AddRecord(1, 4, EthernetFrame(UdpPacket(2368, 100, 5)));
+  writer.Truncate(20);
+  ASSERT_TRUE(writer.Write(file_));
+
+  PcapPacketInput input(8, 200);
+  ASSERT_TRUE(input.Open(file_));
+  EXPECT_EQ(ReadAll(&input), std::vector<uint8_t>({1, 4}));
+  EXPECT_EQ(input.truncated_num(), 1);
+
+  // the capture ends in a record header
+  PcapWriter header_writer(1);
+  header_writer.AddRecord(1, 0, EthernetFrame(UdpPacket(2368, 100, 1)));
+  header_writer.AddRecord(1, 1, EthernetFrame(UdpPacket(2368, 100, 2)));
+  header_writer.Truncate(100 + 8 + 20 + 14 + 8);
+  ASSERT_TRUE(header_writer.Write(file_));
+  ASSERT_TRUE(input.Open(file_));
+  EXPECT_EQ(ReadAll(&input), std::vector<uint8_t>({1}));
+
+  // a file shorter than its header is not opened
+  PcapWriter short_writer(1);
+  short_writer.Truncate(10);
+  ASSERT_TRUE(short_writer.Write(file_));
+  EXPECT_FALSE(input.Open(file_));
+}
+
+TEST_F(PcapPacketInputTest, loop_test) {
+  PcapWriter writer(101);
+  writer.AddRecord(1, 0, UdpPacket(2368, 10, 1));
+  writer.AddRecord(1, 1, UdpPacket(2368, 10, 2));
+  ASSERT_TRUE(writer.Write(file_));
+
+  PcapPacketInput input(8, 1500);
+  ASSERT_TRUE(input.Open(file_, 0, false, true));
+  LidarPacketView packet;
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_EQ(input.NextPacket(&packet, 0), PacketStatus::OK);
+    EXPECT_EQ(packet.data[0], i % 2 + 1);
+  }
+
+  // without a matching packet a looped file ends anyway
+  ASSERT_TRUE(input.Open(file_, 9999, false, true));
+  EXPECT_EQ(input.NextPacket(&packet, 0), PacketStatus::END_OF_FILE);
+}
+
+}  // namespace lidar
+}  // namespace drivers
+}  // namespace apollo
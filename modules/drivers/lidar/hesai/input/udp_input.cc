@@ -17,9 +17,7 @@
 #include "modules/drivers/lidar/hesai/input/udp_input.h"
 
 #include <arpa/inet.h>
-#include <fcntl.h>
 #include <poll.h>
-#include <sys/file.h>
 #include <sys/socket.h>
 
 #include <cerrno>
@@ -33,28 +31,10 @@ namespace apollo {
 namespace drivers {
 namespace hesai {
 
-Input::Input(uint16_t port, uint16_t gpsPort) {
-  socketForLidar = -1;
-  socketForLidar = socket(PF_INET, SOCK_DGRAM, 0);
-  if (-1 == socketForLidar) {
-    AERROR << "socket open error";
-    return;
-  }
-
-  sockaddr_in myAddress;                     // my address information
-  memset(&myAddress, 0, sizeof(myAddress));  // initialize to zeros
-  myAddress.sin_family = AF_INET;            // host byte order
-  myAddress.sin_port = htons(port);          // port in network byte order
-  myAddress.sin_addr.s_addr = INADDR_ANY;    // automatically fill in my IP
-
-  if (bind(socketForLidar, reinterpret_cast<sockaddr *>(&myAddress),
-           sizeof(sockaddr)) == -1) {
-    AERROR << "bind error, port:" << port;
-    return;
-  }
-
-  if (fcntl(socketForLidar, F_SETFL, O_NONBLOCK | FASYNC) < 0) {
-    AERROR << "fcntl error";
+Input::Input(uint16_t port, uint16_t gpsPort)
+    : lidarInput(64, ETHERNET_MTU) {
+  if (!lidarInput.Open(port)) {
+    AERROR << "socket open error, port:" << port;
     return;
   }
 
@@ -64,26 +44,8 @@ Input::Input(uint16_t port, uint16_t gpsPort) {
   }
 
   // gps socket
-  socketForGPS = -1;
-  socketForGPS = socket(PF_INET, SOCK_DGRAM, 0);
-  if (socketForGPS == -1) {
-    return;
-  }
-
-  sockaddr_in myAddressGPS;                        // my address information
-  memset(&myAddressGPS, 0, sizeof(myAddressGPS));  // initialize to zeros
-  myAddressGPS.sin_family = AF_INET;               // host byte order
-  myAddressGPS.sin_port = htons(gpsPort);          // port in network byte order
-  myAddressGPS.sin_addr.s_addr = INADDR_ANY;  // automatically fill in my IP
-
-  if (bind(socketForGPS, reinterpret_cast<sockaddr *>(&myAddressGPS),
-           sizeof(sockaddr)) == -1) {
-    AERROR << "gps bind error";
-    return;
-  }
-
-  if (fcntl(socketForGPS, F_SETFL, O_NONBLOCK | FASYNC) < 0) {
-    AERROR << "gps fcntl error";
+  if (!gpsInput.Open(gpsPort)) {
+    AERROR << "gps socket open error, port:" << gpsPort;
     return;
   }
 
@@ -91,65 +53,80 @@ Input::Input(uint16_t port, uint16_t gpsPort) {
 }
 
 Input::~Input(void) {
-  if (socketForGPS > 0) close(socketForGPS);
-  if (socketForLidar > 0) (void)close(socketForLidar);
+  gpsInput.Close();
+  lidarInput.Close();
 }
 
 // return : 0 - lidar
 //          1 - gps
 //         -1 - error
 int Input::GetPacket(HesaiPacket *pkt) {
-  struct pollfd fds[socketNumber];
+  apollo::drivers::lidar::UdpPacketInput *inputs[2] = {&lidarInput, nullptr};
   if (socketNumber == 2) {
-    fds[0].fd = socketForGPS;
-    fds[0].events = POLLIN;
-
-    fds[1].fd = socketForLidar;
-    fds[1].events = POLLIN;
-  } else if (socketNumber == 1) {
-    fds[0].fd = socketForLidar;
-    fds[0].events = POLLIN;
-  }
-  static const int POLL_TIMEOUT = 1000;  // one second (in msec)
-
-  sockaddr_in senderAddress;
-  socklen_t senderAddressLen = sizeof(senderAddress);
-  int retval = poll(fds, socketNumber, POLL_TIMEOUT);
-  if (retval < 0) {
-    if (errno != EINTR) {
-      AERROR << "poll() error:" << strerror(errno);
-    }
-    return -1;
-  }
-  if (retval == 0) {
-    AERROR << "poll() timeout";
-    return -1;
-  }
-  if ((fds[0].revents & POLLERR) || (fds[0].revents & POLLHUP) ||
-      (fds[0].revents & POLLNVAL)) {
-    AERROR << "poll() reports hesai error";
+    inputs[0] = &gpsInput;
+    inputs[1] = &lidarInput;
+  } else if (socketNumber != 1) {
     return -1;
   }
 
-  senderAddressLen = sizeof(senderAddress);
-  ssize_t nbytes = 0;
+  // packets left from the last batch are taken without polling
+  apollo::drivers::lidar::UdpPacketInput *ready = nullptr;
   for (int i = 0; i != socketNumber; ++i) {
-    if (fds[i].revents & POLLIN) {
-      nbytes = recvfrom(fds[i].fd, &pkt->data[0], ETHERNET_MTU, 0,
-                        reinterpret_cast<sockaddr *>(&senderAddress),
-                        &senderAddressLen);
+    if (inputs[i]->HasPacket()) {
+      ready = inputs[i];
       break;
     }
   }
 
-  if (nbytes < 0) {
-    if (errno != EWOULDBLOCK) {
-      AERROR << "recvfrom error";
+  if (ready == nullptr) {
+    struct pollfd fds[2];
+    for (int i = 0; i != socketNumber; ++i) {
+      fds[i].fd = inputs[i]->fd();
+      fds[i].events = POLLIN;
+    }
+    static const int POLL_TIMEOUT = 1000;  // one second (in msec)
+
+    int retval = poll(fds, socketNumber, POLL_TIMEOUT);
+    if (retval < 0) {
+      if (errno != EINTR) {
+        AERROR << "poll() error:" << strerror(errno);
+      }
+      return -1;
+    }
+    if (retval == 0) {
+      AERROR << "poll() timeout";
+      return -1;
+    }
+    if ((fds[0].revents & POLLERR) || (fds[0].revents & POLLHUP) ||
+        (fds[0].revents & POLLNVAL)) {
+      AERROR << "poll() reports hesai error";
+      return -1;
+    }
+    for (int i = 0; i != socketNumber; ++i) {
+      if (fds[i].revents & POLLIN) {
+        ready = inputs[i];
+        break;
+      }
+    }
+    if (ready == nullptr) {
       return -1;
     }
   }
 
-  pkt->size = nbytes;
+  apollo::drivers::lidar::LidarPacketView packet;
+  const apollo::drivers::lidar::PacketStatus status =
+      ready->NextPacket(&packet, 0);
+  if (status == apollo::drivers::lidar::PacketStatus::TRUNCATED) {
+    AERROR << "oversized hesai packets dropped";
+    return -1;
+  }
+  if (status != apollo::drivers::lidar::PacketStatus::OK) {
+    AERROR << "recvfrom error";
+    return -1;
+  }
+  memcpy(&pkt->data[0], packet.data, packet.size);
+  pkt->size = static_cast<uint32_t>(packet.size);
+  pkt->stamp = static_cast<double>(packet.stamp_ns) * 1e-9;
   return 0;
 }
 
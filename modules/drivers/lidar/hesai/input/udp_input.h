@@ -18,6 +18,7 @@
 #define LIDAR_HESAI_SRC_INPUT_H_
 
 #include <cstdint>
+#include "modules/drivers/lidar/common/packet_input.h"
 #include "modules/drivers/lidar/hesai/common/type_defs.h"
 
 namespace apollo {
@@ -31,8 +32,10 @@ class Input {
   int GetPacket(HesaiPacket *pkt);
 
  private:
-  int socketForLidar = -1;
-  int socketForGPS = -1;
+  // lidar packets arrive in bursts and are received in batches, gps packets
+  // once a second
+  apollo::drivers::lidar::UdpPacketInput lidarInput;
+  apollo::drivers::lidar::UdpPacketInput gpsInput{1, ETHERNET_MTU};
   int socketNumber = -1;
 };
 
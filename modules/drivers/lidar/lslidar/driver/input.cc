@@ -17,9 +17,6 @@
 #include "modules/drivers/lidar/lslidar/driver/input.h"
 
 #include <arpa/inet.h>
-#include <fcntl.h>
-#include <poll.h>
-#include <sys/file.h>
 #include <sys/socket.h>
 
 #include <memory>
@@ -43,90 +40,46 @@ Input::~Input(void) { (void)close(sockfd_); }
 InputSocket::InputSocket(uint16_t port, std::string lidar_ip, int packet_size)
     : Input(port, lidar_ip, packet_size) {
   port_ = port;
+  // the socket is owned by input_
   sockfd_ = -1;
-  sockfd_ = socket(PF_INET, SOCK_DGRAM, 0);
-  if (-1 == sockfd_) {
-    AERROR << "socket open error";
-    return;
-  }
-
   inet_aton(lidar_ip.c_str(), &devip_);
-  sockaddr_in myAddress;                     // my address information
-  memset(&myAddress, 0, sizeof(myAddress));  // initialize to zeros
-  myAddress.sin_family = AF_INET;            // host byte order
-  myAddress.sin_port = htons(port);          // port in network byte order
-  myAddress.sin_addr.s_addr = INADDR_ANY;    // automatically fill in my IP
-
-  if (bind(sockfd_, reinterpret_cast<sockaddr *>(&myAddress),
-           sizeof(sockaddr)) == -1) {
-    AERROR << "bind error, port:" << port;
-    return;
-  }
-
-  if (fcntl(sockfd_, F_SETFL, O_NONBLOCK | FASYNC) < 0) {
-    AERROR << "fcntl error";
-    return;
+  if (!input_.Open(port)) {
+    AERROR << "socket open error, port:" << port;
   }
 }
 
-InputSocket::~InputSocket(void) { (void)close(sockfd_); }
+InputSocket::~InputSocket(void) { input_.Close(); }
 
 int InputSocket::GetPacket(LslidarPacket *pkt) {
-  double time1 = apollo::cyber::Time().Now().ToSecond();
-  struct pollfd fds[1];
-  fds[0].fd = sockfd_;
-  fds[0].events = POLLIN;
-  static const int POLL_TIMEOUT = 3000;  // one second (in msec)
-
-  sockaddr_in sender_address;
-  socklen_t sender_address_len = sizeof(sender_address);
+  static const int POLL_TIMEOUT = 3000;  // three seconds (in msec)
 
+  apollo::drivers::lidar::LidarPacketView packet;
   while (true) {
-    // Receive packets that should now be available from the
-    // socket using a blocking read.
-    // poll() until input available
-    do {
-      int retval = poll(fds, 1, POLL_TIMEOUT);
-      if (retval < 0) {
-        if (errno != EINTR) AERROR << "poll() error: " << strerror(errno);
-
-        return 1;
-      }
-      if (retval == 0) {
-        AERROR << "lslidar poll() timeout, port: " << port_;
-        return 1;
-      }
-      if ((fds[0].revents & POLLERR) || (fds[0].revents & POLLHUP) ||
-          (fds[0].revents & POLLNVAL)) {
-        AWARN << "poll() reports lslidar error";
-        return 1;
-      }
-    } while ((fds[0].revents & POLLIN) == 0);
-    uint8_t bytes[1212];
-    ssize_t nbytes = recvfrom(sockfd_, bytes, packet_size_, 0,
-                              reinterpret_cast<sockaddr *>(&sender_address),
-                              &sender_address_len);
-    if (nbytes < 0) {
-      if (errno != EWOULDBLOCK) {
-        AERROR << "recvfail";
-        return 1;
-      }
-    } else if ((size_t)nbytes == size_t(packet_size_)) {
-      if (sender_address.sin_addr.s_addr != devip_.s_addr) {
+    const apollo::drivers::lidar::PacketStatus status =
+        input_.NextPacket(&packet, POLL_TIMEOUT);
+    if (status == apollo::drivers::lidar::PacketStatus::TIMEOUT) {
+      AERROR << "lslidar poll() timeout, port: " << port_;
+      return 1;
+    }
+    if (status == apollo::drivers::lidar::PacketStatus::TRUNCATED) {
+      AERROR << "oversized lslidar packets dropped, port: " << port_;
+      continue;
+    }
+    if (status != apollo::drivers::lidar::PacketStatus::OK) {
+      AERROR << "recvfail";
+      return 1;
+    }
+    if (packet.size == size_t(packet_size_)) {
+      if (packet.source_address != devip_.s_addr) {
         AERROR << "lidar IP parameter set error,please reset in config file";
         continue;
       } else {
-        pkt->set_data(bytes, packet_size_);
+        pkt->set_data(packet.data, packet_size_);
         break;
       }
     }
-    AERROR << "incomplete lslidar packet read: " << nbytes << " bytes";
+    AERROR << "incomplete lslidar packet read: " << packet.size << " bytes";
   }
-
-  // Average the times at which we begin and end reading.  Use that to
-  // estimate when the scan occurred.
-  double time2 = apollo::cyber::Time().Now().ToSecond();
-  AINFO << apollo::cyber::Time((time2 + time1) / 2.0).ToNanosecond();
   return 0;
 }
 
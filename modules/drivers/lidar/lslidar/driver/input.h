@@ -24,6 +24,8 @@
 #include <pcap.h>
 #include "modules/drivers/lidar/lslidar/proto/lslidar.pb.h"
 
+#include "modules/drivers/lidar/common/packet_input.h"
+
 #include "cyber/cyber.h"
 
 namespace apollo {
@@ -58,6 +60,9 @@ class InputSocket : public Input {
   virtual ~InputSocket();
 
   virtual int GetPacket(LslidarPacket *pkt);
+
+ private:
+  apollo::drivers::lidar::UdpPacketInput input_;
 };
 
 /** @brief lslidar input from PCAP dump file.
@@ -16,6 +16,7 @@
 
 #include "modules/drivers/lidar/velodyne/compensator/compensator.h"
 
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <string>
@@ -24,6 +25,88 @@ namespace apollo {
 namespace drivers {
 namespace velodyne {
 
+namespace {
+
+constexpr int kBatchSize = 256;
+
+// points waiting for compensation, as arrays so the transforms of the whole
+// batch run in loops the compiler vectorizes
+struct PointBatch {
+  int size = 0;
+  const PointXYZIT* points[kBatchSize];
+  double x[kBatchSize];
+  double y[kBatchSize];
+  double z[kBatchSize];
+  double t[kBatchSize];
+
+  void Add(const PointXYZIT& point, double time) {
+    points[size] = &point;
+    x[size] = point.x();
+    y[size] = point.y();
+    z[size] = point.z();
+    t[size] = time;
+    ++size;
+  }
+};
+
+void AppendBatch(PointBatch* batch, PointCloud* msg_compensated) {
+  for (int i = 0; i < batch->size; ++i) {
+    auto* point_new = msg_compensated->add_point();
+    point_new->set_intensity(batch->points[i]->intensity());
+    point_new->set_timestamp(batch->points[i]->timestamp());
+    point_new->set_x(static_cast<float>(batch->x[i]));
+    point_new->set_y(static_cast<float>(batch->y[i]));
+    point_new->set_z(static_cast<float>(batch->z[i]));
+  }
+  batch->size = 0;
+}
+
+// p = ti * qi * p with qi the slerp from identity to q1 at t, expanded the
+// way Eigen composes and applies the transform
+void RotateBatch(const Eigen::Quaterniond& q1,
+                 const Eigen::Vector3d& translation, double theta,
+                 double sin_theta, double c1_sign, PointBatch* batch,
+                 PointCloud* msg_compensated) {
+  double c0[kBatchSize];
+  double c1[kBatchSize];
+  const int size = batch->size;
+  for (int i = 0; i < size; ++i) {
+    c0[i] = std::sin((1 - batch->t[i]) * theta) / sin_theta;
+    c1[i] = std::sin(batch->t[i] * theta) / sin_theta * c1_sign;
+  }
+  for (int i = 0; i < size; ++i) {
+    const double qx = c1[i] * q1.x();
+    const double qy = c1[i] * q1.y();
+    const double qz = c1[i] * q1.z();
+    const double qw = c0[i] + c1[i] * q1.w();
+    const double tx = 2 * qx;
+    const double ty = 2 * qy;
+    const double tz = 2 * qz;
+    const double twx = tx * qw;
+    const double twy = ty * qw;
+    const double twz = tz * qw;
+    const double txx = tx * qx;
+    const double txy = ty * qx;
+    const double txz = tz * qx;
+    const double tyy = ty * qy;
+    const double tyz = tz * qy;
+    const double tzz = tz * qz;
+    const double x = batch->x[i];
+    const double y = batch->y[i];
+    const double z = batch->z[i];
+    const double t = batch->t[i];
+    batch->x[i] = (1 - (tyy + tzz)) * x + (txy - twz) * y + (txz + twy) * z +
+                  t * translation.x();
+    batch->y[i] = (txy + twz) * x + (1 - (txx + tzz)) * y + (tyz - twx) * z +
+                  t * translation.y();
+    batch->z[i] = (txz - twy) * x + (tyz + twx) * y + (1 - (txx + tyy)) * z +
+                  t * translation.z();
+  }
+  AppendBatch(batch, msg_compensated);
+}
+
+}  // namespace
+
 bool Compensator::QueryPoseAffineFromTF2(const uint64_t& timestamp, void* pose,
                                          const std::string& child_frame_id) {
   cyber::Time query_time(timestamp);
@@ -157,9 +240,13 @@ void Compensator::MotionCompensation(
     double theta = acos(abs_d);
     double sin_theta = sin(theta);
     double c1_sign = (d > 0) ? 1 : -1;
+    PointBatch batch;
     for (const auto& point : msg->point()) {
       float x_scalar = point.x();
       if (std::isnan(x_scalar)) {
+        // keep the points in order around the nan point
+        RotateBatch(q1, translation, theta, sin_theta, c1_sign, &batch,
+                    msg_compensated.get());
         // if (config_.organized()) {
         auto* point_new = msg_compensated->add_point();
         point_new->CopyFrom(point);
@@ -168,29 +255,15 @@ void Compensator::MotionCompensation(
         // }
         continue;
       }
-      float y_scalar = point.y();
-      float z_scalar = point.z();
-      Eigen::Vector3d p(x_scalar, y_scalar, z_scalar);
-
       uint64_t tp = point.timestamp();
-      double t = static_cast<double>(timestamp_max - tp) * f;
-
-      Eigen::Translation3d ti(t * translation);
-
-      double c0 = sin((1 - t) * theta) / sin_theta;
-      double c1 = sin(t * theta) / sin_theta * c1_sign;
-      Eigen::Quaterniond qi(c0 * q0.coeffs() + c1 * q1.coeffs());
-
-      Eigen::Affine3d trans = ti * qi;
-      p = trans * p;
-
-      auto* point_new = msg_compensated->add_point();
-      point_new->set_intensity(point.intensity());
-      point_new->set_timestamp(point.timestamp());
-      point_new->set_x(static_cast<float>(p.x()));
-      point_new->set_y(static_cast<float>(p.y()));
-      point_new->set_z(static_cast<float>(p.z()));
+      batch.Add(point, static_cast<double>(timestamp_max - tp) * f);
+      if (batch.size == kBatchSize) {
+        RotateBatch(q1, translation, theta, sin_theta, c1_sign, &batch,
+                    msg_compensated.get());
+      }
     }
+    RotateBatch(q1, translation, theta, sin_theta, c1_sign, &batch,
+                msg_compensated.get());
     return;
   }
   // Not a "significant" rotation. Do translation only.
@@ -46,6 +46,17 @@ class Compensator {
   bool MotionCompensation(const std::shared_ptr<const PointCloud>& msg,
                           std::shared_ptr<PointCloud> msg_compensated);
 
+  /**
+   * @brief motion compensation for point cloud with the poses at the first
+   *   and the last point time known
+   */
+  static void MotionCompensation(const std::shared_ptr<const PointCloud>& msg,
+                          std::shared_ptr<PointCloud> msg_compensated,
+                          const uint64_t timestamp_min,
+                          const uint64_t timestamp_max,
+                          const Eigen::Affine3d& pose_min_time,
+                          const Eigen::Affine3d& pose_max_time);
+
  private:
   /**
    * @brief get pose affine from tf2 by gps timestamp
@@ -54,15 +65,6 @@ class Compensator {
   bool QueryPoseAffineFromTF2(const uint64_t& timestamp, void* pose,
                               const std::string& child_frame_id);
 
-  /**
-   * @brief motion compensation for point cloud
-   */
-  void MotionCompensation(const std::shared_ptr<const PointCloud>& msg,
-                          std::shared_ptr<PointCloud> msg_compensated,
-                          const uint64_t timestamp_min,
-                          const uint64_t timestamp_max,
-                          const Eigen::Affine3d& pose_min_time,
-                          const Eigen::Affine3d& pose_max_time);
   /**
    * @brief get min timestamp and max timestamp from points in pointcloud2
    */
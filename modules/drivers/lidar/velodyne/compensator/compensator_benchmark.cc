@@ -0,0 +1,206 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Motion compensation of one HDL-64 sized rotation: BM_PerPointCompensation
+// builds an Eigen transform for every point the way the compensator used to,
+// BM_MotionCompensation is Compensator::MotionCompensation with its batched
+// transforms. mismatched_points counts coordinates that are not bit
+// identical to the per point result, max_error_m is the largest difference.
+// Range 0 drives straight (translation only), range 1 turns.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/drivers/lidar/velodyne/compensator/compensator.h"
+
+namespace apollo {
+namespace drivers {
+namespace velodyne {
+namespace {
+
+constexpr int kPointNum = 120000;
+constexpr uint64_t kStartNs = 1600000000000000000ULL;
+constexpr uint64_t kScanNs = 100000000ULL;
+
+std::shared_ptr<PointCloud> MakeCloud() {
+  auto cloud = std::make_shared<PointCloud>();
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> coord(-80.0f, 80.0f);
+  for (int i = 0; i < kPointNum; ++i) {
+    auto* point = cloud->add_point();
+    point->set_timestamp(kStartNs + kScanNs * i / kPointNum);
+    point->set_intensity(static_cast<uint32_t>(i % 255));
+    if (i % 50 == 0) {
+      point->set_x(std::numeric_limits<float>::quiet_NaN());
+      point->set_y(std::numeric_limits<float>::quiet_NaN());
+      point->set_z(std::numeric_limits<float>::quiet_NaN());
+      continue;
+    }
+    point->set_x(coord(random));
+    point->set_y(coord(random));
+    point->set_z(coord(random) / 20.0f);
+  }
+  return cloud;
+}
+
+// the vehicle moves 1.5 m during the scan, turning 2 degrees if turn is set
+void MakePoses(bool turn, Eigen::Affine3d* pose_min_time,
+               Eigen::Affine3d* pose_max_time) {
+  *pose_min_time = Eigen::Translation3d(100.0, 200.0, 1.0) *
+                   Eigen::Quaterniond(Eigen::AngleAxisd(
+                       0.3, Eigen::Vector3d::UnitZ()));
+  *pose_max_time =
+      Eigen::Translation3d(101.5, 200.2, 1.0) *
+      Eigen::Quaterniond(Eigen::AngleAxisd(
+          turn ? 0.3 + 2.0 * M_PI / 180.0 : 0.3, Eigen::Vector3d::UnitZ()));
+}
+
+// Compensator::MotionCompensation before the points were batched
+void PerPointCompensation(const std::shared_ptr<const PointCloud>& msg,
+                          std::shared_ptr<PointCloud> msg_compensated,
+                          const uint64_t timestamp_min,
+                          const uint64_t timestamp_max,
+                          const Eigen::Affine3d& pose_min_time,
+                          const Eigen::Affine3d& pose_max_time) {
+  Eigen::Vector3d translation =
+      pose_min_time.translation() - pose_max_time.translation();
+  Eigen::Quaterniond q_max(pose_max_time.linear());
+  Eigen::Quaterniond q_min(pose_min_time.linear());
+  Eigen::Quaterniond q1(q_max.conjugate() * q_min);
+  Eigen::Quaterniond q0(Eigen::Quaterniond::Identity());
+  q1.normalize();
+  translation = q_max.conjugate() * translation;
+  double d = q0.dot(q1);
+  double abs_d = std::abs(d);
+  double f = 1.0 / static_cast<double>(timestamp_max - timestamp_min);
+  const bool rotate = abs_d < 1.0 - 1.0e-8;
+  double theta = std::acos(abs_d);
+  double sin_theta = std::sin(theta);
+  double c1_sign = (d > 0) ? 1 : -1;
+  for (const auto& point : msg->point()) {
+    if (std::isnan(point.x())) {
+      if (rotate) {
+        msg_compensated->add_point()->CopyFrom(point);
+      }
+      continue;
+    }
+    Eigen::Vector3d p(point.x(), point.y(), point.z());
+    double t = static_cast<double>(timestamp_max - point.timestamp()) * f;
+    Eigen::Translation3d ti(t * translation);
+    if (rotate) {
+      double c0 = std::sin((1 - t) * theta) / sin_theta;
+      double c1 = std::sin(t * theta) / sin_theta * c1_sign;
+      Eigen::Quaterniond qi(c0 * q0.coeffs() + c1 * q1.coeffs());
+      Eigen::Affine3d trans = ti * qi;
+      p = trans * p;
+    } else {
+      p = ti * p;
+    }
+    auto* point_new = msg_compensated->add_point();
+    point_new->set_intensity(point.intensity());
+    point_new->set_timestamp(point.timestamp());
+    point_new->set_x(static_cast<float>(p.x()));
+    point_new->set_y(static_cast<float>(p.y()));
+    point_new->set_z(static_cast<float>(p.z()));
+  }
+}
+
+void ComparePoints(const PointCloud& expected, const PointCloud& actual,
+                   benchmark::State* state) {
+  if (expected.point_size() != actual.point_size()) {
+    state->SkipWithError("point count differs");
+    return;
+  }
+  int mismatched = 0;
+  double max_error = 0.0;
+  for (int i = 0; i < expected.point_size(); ++i) {
+    const float e[3] = {expected.point(i).x(), expected.point(i).y(),
+                        expected.point(i).z()};
+    const float a[3] = {actual.point(i).x(), actual.point(i).y(),
+                        actual.point(i).z()};
+    for (int k = 0; k < 3; ++k) {
+      if (std::isnan(e[k]) && std::isnan(a[k])) {
+        continue;
+      }
+      if (memcmp(&e[k], &a[k], sizeof(float)) != 0) {
+        ++mismatched;
+        max_error =
+            std::max(max_error, static_cast<double>(std::fabs(e[k] - a[k])));
+      }
+    }
+  }
+  state->counters["mismatched_points"] = mismatched;
+  state->counters["max_error_m"] = max_error;
+}
+
+template <typename Compensate>
+void RunCompensation(benchmark::State& state, Compensate compensate) {
+  const std::shared_ptr<const PointCloud> cloud = MakeCloud();
+  Eigen::Affine3d pose_min_time;
+  Eigen::Affine3d pose_max_time;
+  MakePoses(state.range(0) != 0, &pose_min_time, &pose_max_time);
+  const uint64_t timestamp_min = kStartNs;
+  const uint64_t timestamp_max = cloud->point(kPointNum - 1).timestamp();
+  auto compensated = std::make_shared<PointCloud>();
+  for (auto _ : state) {
+    state.PauseTiming();
+    compensated = std::make_shared<PointCloud>();
+    compensated->mutable_point()->Reserve(kPointNum);
+    state.ResumeTiming();
+    compensate(cloud, compensated, timestamp_min, timestamp_max,
+               pose_min_time, pose_max_time);
+  }
+  auto expected = std::make_shared<PointCloud>();
+  PerPointCompensation(cloud, expected, timestamp_min, timestamp_max,
+                       pose_min_time, pose_max_time);
+  ComparePoints(*expected, *compensated, &state);
+  state.SetItemsProcessed(state.iterations() * kPointNum);
+}
+
+void BM_PerPointCompensation(benchmark::State& state) {
+  RunCompensation(state, PerPointCompensation);
+}
+BENCHMARK(BM_PerPointCompensation)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_MotionCompensation(benchmark::State& state) {
+  RunCompensation(
+      state, [](const std::shared_ptr<const PointCloud>& msg,
+                std::shared_ptr<PointCloud> msg_compensated,
+                const uint64_t timestamp_min, const uint64_t timestamp_max,
+                const Eigen::Affine3d& pose_min_time,
+                const Eigen::Affine3d& pose_max_time) {
+        Compensator::MotionCompensation(msg, msg_compensated, timestamp_min,
+                                        timestamp_max, pose_min_time,
+                                        pose_max_time);
+      });
+}
+BENCHMARK(BM_MotionCompensation)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace velodyne
+}  // namespace drivers
+}  // namespace apollo
+
+BENCHMARK_MAIN();
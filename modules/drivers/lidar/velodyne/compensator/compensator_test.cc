@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/lidar/velodyne/compensator/compensator.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace drivers {
+namespace velodyne {
+
+// the batched transforms expand the Eigen math of the per point path, the
+// points agree to far below a float step at the maximum range
+constexpr float kToleranceM = 1e-5f;
+constexpr int kPointNum = 5000;
+constexpr uint64_t kStartNs = 1600000000000000000ULL;
+constexpr uint64_t kScanNs = 100000000ULL;
+
+std::shared_ptr<PointCloud> MockCloud() {
+  auto cloud = std::make_shared<PointCloud>();
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> coord(-80.0f, 80.0f);
+  for (int i = 0; i < kPointNum; ++i) {
+    auto* point = cloud->add_point();
+    point->set_timestamp(kStartNs + kScanNs * i / kPointNum);
+    point->set_intensity(static_cast<uint32_t>(i % 255));
+    // no returns, alone and in runs longer than a batch
+    if (i % 50 == 0 || (i >= 3000 && i < 3300)) {
+      point->set_x(std::numeric_limits<float>::quiet_NaN());
+      point->set_y(std::numeric_limits<float>::quiet_NaN());
+      point->set_z(std::numeric_limits<float>::quiet_NaN());
+      continue;
+    }
+    point->set_x(coord(random));
+    point->set_y(coord(random));
+    point->set_z(coord(random) / 20.0f);
+  }
+  return cloud;
+}
+
+// the vehicle moves 1.5 m during the scan, turning by yaw_rad
+void MockPoses(double yaw_rad, Eigen::Affine3d* pose_min_time,
+               Eigen::Affine3d* pose_max_time) {
+  *pose_min_time =
+      Eigen::Translation3d(100.0, 200.0, 1.0) *
+      Eigen::Quaterniond(Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()));
+  *pose_max_time = Eigen::Translation3d(101.5, 200.2, 1.0) *
+                   Eigen::Quaterniond(Eigen::AngleAxisd(
+                       0.3 + yaw_rad, Eigen::Vector3d::UnitZ()));
+}
+
+// Compensator::MotionCompensation before the points were batched
+void PerPointCompensation(const std::shared_ptr<const PointCloud>& msg,
+                          std::shared_ptr<PointCloud> msg_compensated,
+                          const uint64_t timestamp_min,
+                          const uint64_t timestamp_max,
+                          const Eigen::Affine3d& pose_min_time,
+                          const Eigen::Affine3d& pose_max_time) {
+  Eigen::Vector3d translation =
+      pose_min_time.translation() - pose_max_time.translation();
+  Eigen::Quaterniond q_max(pose_max_time.linear());
+  Eigen::Quaterniond q_min(pose_min_time.linear());
+  Eigen::Quaterniond q1(q_max.conjugate() * q_min);
+  Eigen::Quaterniond q0(Eigen::Quaterniond::Identity());
+  q1.normalize();
+  translation = q_max.conjugate() * translation;
+  double d = q0.dot(q1);
+  double abs_d = std::abs(d);
+  double f = 1.0 / static_cast<double>(timestamp_max - timestamp_min);
+  const bool rotate = abs_d < 1.0 - 1.0e-8;
+  double theta = std::acos(abs_d);
+  double sin_theta = std::sin(theta);
+  double c1_sign = (d > 0) ? 1 : -1;
+  for (const auto& point : msg->point()) {
+    if (std::isnan(point.x())) {
+      if (rotate) {
+        msg_compensated->add_point()->CopyFrom(point);
+      }
+      continue;
+    }
+    Eigen::Vector3d p(point.x(), point.y(), point.z());
+    double t = static_cast<double>(timestamp_max - point.timestamp()) * f;
+    Eigen::Translation3d ti(t * translation);
+    if (rotate) {
+      double c0 = std::sin((1 - t) * theta) / sin_theta;
+      double c1 = std::sin(t * theta) / sin_theta * c1_sign;
+      Eigen::Quaterniond qi(c0 * q0.coeffs() + c1 * q1.coeffs());
+      Eigen::Affine3d trans = ti * qi;
+      p = trans * p;
+    } else {
+      p = ti * p;
+    }
+    auto* point_new = msg_compensated->add_point();
+    point_new->set_intensity(point.intensity());
+    point_new->set_timestamp(point.timestamp());
+    point_new->set_x(static_cast<float>(p.x()));
+    point_new->set_y(static_cast<float>(p.y()));
+    point_new->set_z(static_cast<float>(p.z()));
+  }
+}
+
+void ExpectSamePoints(const PointCloud& expected, const PointCloud& actual) {
+  ASSERT_EQ(expected.point_size(), actual.point_size());
+  for (int i = 0; i < expected.point_size(); ++i) {
+    const auto& e = expected.point(i);
+    const auto& a = actual.point(i);
+    EXPECT_EQ(e.timestamp(), a.timestamp()) << "point " << i;
+    EXPECT_EQ(e.intensity(), a.intensity()) << "point " << i;
+    if (std::isnan(e.x())) {
+      EXPECT_TRUE(std::isnan(a.x())) << "point " << i;
+      continue;
+    }
+    EXPECT_NEAR(e.x(), a.x(), kToleranceM) << "point " << i;
+    EXPECT_NEAR(e.y(), a.y(), kToleranceM) << "point " << i;
+    EXPECT_NEAR(e.z(), a.z(), kToleranceM) << "point " << i;
+  }
+}
+
+TEST(CompensatorTest, motion_compensation_test) {
+  const std::shared_ptr<const PointCloud> cloud = MockCloud();
+  const uint64_t timestamp_min = kStartNs;
+  const uint64_t timestamp_max = cloud->point(kPointNum - 1).timestamp();
+  // straight (translation only), turning left and right
+  for (const double yaw_rad : {0.0, 2.0 * M_PI / 180.0, -0.1}) {
+    Eigen::Affine3d pose_min_time;
+    Eigen::Affine3d pose_max_time;
+    MockPoses(yaw_rad, &pose_min_time, &pose_max_time);
+    auto expected = std::make_shared<PointCloud>();
+    PerPointCompensation(cloud, expected, timestamp_min, timestamp_max,
+                         pose_min_time, pose_max_time);
+    auto actual = std::make_shared<PointCloud>();
+    Compensator::MotionCompensation(cloud, actual, timestamp_min,
+                                    timestamp_max, pose_min_time,
+                                    pose_max_time);
+    SCOPED_TRACE(yaw_rad);
+    ExpectSamePoints(*expected, *actual);
+  }
+}
+
+}  // namespace velodyne
+}  // namespace drivers
+}  // namespace apollo
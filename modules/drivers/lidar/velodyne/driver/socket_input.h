@@ -19,6 +19,7 @@
 #include <unistd.h>
 #include <cstdio>
 
+#include "modules/drivers/lidar/common/packet_input.h"
 #include "modules/drivers/lidar/velodyne/driver/input.h"
 
 namespace apollo {
@@ -31,7 +32,7 @@ using apollo::drivers::velodyne::VelodynePacket;
 // static int POSITIONING_DATA_PORT = 8308;
 static const int POLL_TIMEOUT = 1000;  // one second (in msec)
 
-/** @brief Live Velodyne input from socket. */
+/** @brief Live Velodyne input from socket, received in batches. */
 class SocketInput : public Input {
  public:
   SocketInput();
@@ -41,9 +42,9 @@ class SocketInput : public Input {
   int get_positioning_data_packet(NMEATimePtr nmea_time);
 
  private:
-  int sockfd_;
+  // receives the packets of the whole rotation
+  apollo::drivers::lidar::UdpPacketInput input_;
   int port_;
-  bool input_available(int timeout);
 };
 
 }  // namespace velodyne
@@ -94,22 +94,28 @@ void Velodyne128Parser::Unpack(const VelodynePacket& pkt,
       azimuth_diff = last_azimuth_diff;
     }
 
+    /** correct for the laser rotation as a function of timing during the
+     * firings, all lasers of a block fire at once **/
+    uint8_t group = static_cast<uint8_t>(block % 4);
+    uint8_t firing_order = 0;
+    azimuth_corrected_f =
+        azimuth +
+        (azimuth_diff * (firing_order * CHANNEL_TDURATION) / SEQ_TDURATION);
+    azimuth_corrected =
+        (static_cast<uint16_t>(round(azimuth_corrected_f))) % 36000;
+
+    // Position Calculation of the whole block
+    BlockCoords coords;
+    ComputeBlockCoords(raw->blocks[block], group * 32,
+                       VSL128_DISTANCE_RESOLUTION, azimuth_corrected, &coords);
+
     /*condition added to avoid calculating points which are not
       in the interesting defined area (min_angle < area < max_angle)*/
     for (int j = 0, k = 0; j < SCANS_PER_BLOCK; j++, k += RAW_SCAN_SIZE) {
-      uint8_t group = static_cast<uint8_t>(block % 4);
       uint8_t chan_id = static_cast<uint8_t>(j + group * 32);
-      uint8_t firing_order = chan_id / 8;
-      firing_order = 0;
-      LaserCorrection& corrections = calibration_.laser_corrections_[chan_id];
+      const LaserCorrection& corrections = laser_table_.corrections[chan_id];
       // distance extraction
-      // union two_bytes tmp;
-      union RawDistance raw_distance;
-      raw_distance.bytes[0] = raw->blocks[block].data[k];
-      raw_distance.bytes[1] = raw->blocks[block].data[k + 1];
-
-      float real_distance =
-          raw_distance.raw_distance * VSL128_DISTANCE_RESOLUTION;
+      float real_distance = coords.real_distance[j];
       float distance = real_distance + corrections.dist_correction;
 
       uint64_t timestamp = static_cast<uint64_t>(GetTimestamp(
@@ -130,22 +136,16 @@ void Velodyne128Parser::Unpack(const VelodynePacket& pkt,
       // if (pointInRange(distance)) {
       int intensity = static_cast<int>(raw->blocks[block].data[k + 2]);
 
-      /** correct for the laser rotation as a function of timing during the
-       * firings **/
-      azimuth_corrected_f =
-          azimuth +
-          (azimuth_diff * (firing_order * CHANNEL_TDURATION) / SEQ_TDURATION);
-      azimuth_corrected =
-          (static_cast<uint16_t>(round(azimuth_corrected_f))) % 36000;
-
       // add new point
       PointXYZIT* point_new = pc->add_point();
 
       // compute time , time offset is zero
       point_new->set_timestamp(timestamp);
-      ComputeCoords(real_distance, corrections, azimuth_corrected, point_new);
+      point_new->set_x(coords.x[j]);
+      point_new->set_y(coords.y[j]);
+      point_new->set_z(coords.z[j]);
 
-      intensity = IntensityCompensate(corrections, raw_distance.raw_distance,
+      intensity = IntensityCompensate(corrections, coords.raw_distance[j],
                                       intensity);
       point_new->set_intensity(intensity);
     }
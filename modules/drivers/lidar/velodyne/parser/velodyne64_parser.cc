@@ -154,6 +154,7 @@ void Velodyne64Parser::GeneratePointcloud(
       return;
     }
     calibration_ = online_calibration_.calibration();
+    InitLaserTable();
     if (config_.organized()) {
       InitOffsets();
     }
@@ -255,17 +256,18 @@ void Velodyne64Parser::Unpack(const VelodynePacket& pkt,
     // NOTE: this is a change from the old velodyne_common implementation
     int bank_origin = (raw->blocks[i].laser_block_id == LOWER_BANK) ? 32 : 0;
 
+    // Position Calculation of the whole block
+    BlockCoords coords;
+    ComputeBlockCoords(raw->blocks[i], bank_origin, DISTANCE_RESOLUTION,
+                       raw->blocks[i].rotation, &coords);
+
     for (int j = 0, k = 0; j < SCANS_PER_BLOCK;
          ++j, k += RAW_SCAN_SIZE) {  // 32, 3
       // One point
       uint8_t laser_number =
           static_cast<uint8_t>(j + bank_origin);  // hardware laser number
-      LaserCorrection& corrections =
-          calibration_.laser_corrections_[laser_number];
-
-      union RawDistance raw_distance;
-      raw_distance.bytes[0] = raw->blocks[i].data[k];
-      raw_distance.bytes[1] = raw->blocks[i].data[k + 1];
+      const LaserCorrection& corrections =
+          laser_table_.corrections[laser_number];
 
       // compute time
       uint64_t timestamp = GetTimestamp(basetime, (*inner_time_)[i][j],
@@ -276,10 +278,10 @@ void Velodyne64Parser::Unpack(const VelodynePacket& pkt,
         pc->set_measurement_time(static_cast<double>(timestamp) / 1e9);
       }
 
-      float real_distance = raw_distance.raw_distance * DISTANCE_RESOLUTION;
+      float real_distance = coords.real_distance[j];
       float distance = real_distance + corrections.dist_correction;
 
-      if (raw_distance.raw_distance == 0 ||
+      if (coords.raw_distance[j] == 0 ||
           !is_scan_valid(raw->blocks[i].rotation, distance)) {
         // if organized append a nan point to the cloud
         if (config_.organized()) {
@@ -293,13 +295,14 @@ void Velodyne64Parser::Unpack(const VelodynePacket& pkt,
         continue;
       }
 
+      // append this point to the cloud
       apollo::drivers::PointXYZIT* point = pc->add_point();
       point->set_timestamp(timestamp);
-      // Position Calculation, append this point to the cloud
-      ComputeCoords(real_distance, corrections, raw->blocks[i].rotation, point);
+      point->set_x(coords.x[j]);
+      point->set_y(coords.y[j]);
+      point->set_z(coords.z[j]);
       point->set_intensity(IntensityCompensate(
-          corrections, raw_distance.raw_distance, raw->blocks[i].data[k + 2]));
-      // append this point to the cloud
+          corrections, coords.raw_distance[j], raw->blocks[i].data[k + 2]));
     }
   }
 }
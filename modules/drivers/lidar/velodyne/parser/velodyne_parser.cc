@@ -99,6 +99,8 @@ void VelodyneParser::setup() {
     }
   }
 
+  InitLaserTable();
+
   // setup angle parameters.
   init_angle_params(config_.view_direction(), config_.view_width());
   init_sin_cos_rot_table(sin_rot_table_, cos_rot_table_, ROTATION_MAX_UNITS,
@@ -200,6 +202,103 @@ void VelodyneParser::ComputeCoords(const float &raw_distance,
   point->set_z(static_cast<float>(z));
 }
 
+void VelodyneParser::InitLaserTable() {
+  for (int laser = 0; laser < MAX_LASERS; ++laser) {
+    LaserCorrection corrections = LaserCorrection();
+    auto iter = calibration_.laser_corrections_.find(laser);
+    if (iter != calibration_.laser_corrections_.end()) {
+      corrections = iter->second;
+    }
+    laser_table_.dist_correction[laser] = corrections.dist_correction;
+    laser_table_.dist_correction_x[laser] = corrections.dist_correction_x;
+    laser_table_.dist_correction_y[laser] = corrections.dist_correction_y;
+    laser_table_.vert_offset_correction[laser] =
+        corrections.vert_offset_correction;
+    laser_table_.horiz_offset_correction[laser] =
+        corrections.horiz_offset_correction;
+    laser_table_.cos_rot_correction[laser] = corrections.cos_rot_correction;
+    laser_table_.sin_rot_correction[laser] = corrections.sin_rot_correction;
+    laser_table_.cos_vert_correction[laser] = corrections.cos_vert_correction;
+    laser_table_.sin_vert_correction[laser] = corrections.sin_vert_correction;
+    laser_table_.corrections[laser] = corrections;
+  }
+}
+
+void VelodyneParser::ComputeBlockCoords(const RawBlock &block,
+                                        int first_laser,
+                                        float distance_resolution,
+                                        uint16_t rotation,
+                                        BlockCoords *coords) const {
+  assert(rotation <= 36000);
+  assert(first_laser >= 0 && first_laser + SCANS_PER_BLOCK <= MAX_LASERS);
+  for (int j = 0; j < SCANS_PER_BLOCK; ++j) {
+    const int k = j * RAW_SCAN_SIZE;
+    coords->raw_distance[j] =
+        static_cast<uint16_t>(block.data[k] | (block.data[k + 1] << 8));
+    coords->real_distance[j] = coords->raw_distance[j] * distance_resolution;
+  }
+
+  const float cos_rot = cos_rot_table_[rotation];
+  const float sin_rot = sin_rot_table_[rotation];
+  const float *dist_correction = laser_table_.dist_correction + first_laser;
+  const float *dist_correction_x =
+      laser_table_.dist_correction_x + first_laser;
+  const float *dist_correction_y =
+      laser_table_.dist_correction_y + first_laser;
+  const float *vert_offset = laser_table_.vert_offset_correction + first_laser;
+  const float *horiz_offset =
+      laser_table_.horiz_offset_correction + first_laser;
+  const float *cos_rot_correction =
+      laser_table_.cos_rot_correction + first_laser;
+  const float *sin_rot_correction =
+      laser_table_.sin_rot_correction + first_laser;
+  const float *cos_vert = laser_table_.cos_vert_correction + first_laser;
+  const float *sin_vert = laser_table_.sin_vert_correction + first_laser;
+  const bool two_pt_correction = need_two_pt_correction_;
+
+  // keep every operation and its precision as in ComputeCoords, the points
+  // have to come out the same
+  for (int j = 0; j < SCANS_PER_BLOCK; ++j) {
+    const float raw_distance = coords->real_distance[j];
+    double distance = raw_distance + dist_correction[j];
+    double cos_rot_angle =
+        cos_rot * cos_rot_correction[j] + sin_rot * sin_rot_correction[j];
+    double sin_rot_angle =
+        sin_rot * cos_rot_correction[j] - cos_rot * sin_rot_correction[j];
+    double xy_distance = distance * cos_vert[j];
+    double xx =
+        fabs(xy_distance * sin_rot_angle - horiz_offset[j] * cos_rot_angle);
+    double yy =
+        fabs(xy_distance * cos_rot_angle + horiz_offset[j] * sin_rot_angle);
+
+    double distance_corr_x = dist_correction[j];
+    double distance_corr_y = dist_correction[j];
+    if (two_pt_correction && raw_distance <= 2500) {
+      distance_corr_x = (dist_correction[j] - dist_correction_x[j]) *
+                            (xx - 2.4) / 22.64 +
+                        dist_correction_x[j];
+      distance_corr_y = (dist_correction[j] - dist_correction_y[j]) *
+                            (yy - 1.93) / 23.11 +
+                        dist_correction_y[j];
+    }
+
+    double distance_x = raw_distance + distance_corr_x;
+    xy_distance = distance_x * cos_vert[j];
+    double x = xy_distance * sin_rot_angle - horiz_offset[j] * cos_rot_angle;
+
+    double distance_y = raw_distance + distance_corr_y;
+    xy_distance = distance_y * cos_vert[j];
+    double y = xy_distance * cos_rot_angle + horiz_offset[j] * sin_rot_angle;
+
+    double z = distance * sin_vert[j] + vert_offset[j];
+
+    /** Use standard ROS coordinate system (right-hand rule) */
+    coords->x[j] = static_cast<float>(y);
+    coords->y[j] = static_cast<float>(-x);
+    coords->z[j] = static_cast<float>(z);
+  }
+}
+
 VelodyneParser *VelodyneParserFactory::CreateParser(Config source_config) {
   Config config = source_config;
   if (config.model() == VLP16) {
@@ -220,6 +220,35 @@ struct RawPacket {
 
 static const float nan = std::numeric_limits<float>::signaling_NaN();
 
+static const int MAX_LASERS = 128;
+
+/** \brief Calibration of all lasers as arrays indexed by laser number.
+ *
+ *  Lasers missing in the calibration have all corrections zero, like the
+ *  entries std::map::operator[] inserts for them.
+ */
+struct LaserTable {
+  float dist_correction[MAX_LASERS];
+  float dist_correction_x[MAX_LASERS];
+  float dist_correction_y[MAX_LASERS];
+  float vert_offset_correction[MAX_LASERS];
+  float horiz_offset_correction[MAX_LASERS];
+  float cos_rot_correction[MAX_LASERS];
+  float sin_rot_correction[MAX_LASERS];
+  float cos_vert_correction[MAX_LASERS];
+  float sin_vert_correction[MAX_LASERS];
+  LaserCorrection corrections[MAX_LASERS];
+};
+
+/** \brief Decoded returns of one block and their coordinates. */
+struct BlockCoords {
+  uint16_t raw_distance[SCANS_PER_BLOCK];
+  float real_distance[SCANS_PER_BLOCK];
+  float x[SCANS_PER_BLOCK];
+  float y[SCANS_PER_BLOCK];
+  float z[SCANS_PER_BLOCK];
+};
+
 /** \brief Velodyne data conversion class */
 class VelodyneParser {
  public:
@@ -251,6 +280,7 @@ class VelodyneParser {
   const float (*inner_time_)[12][32];
 
   Calibration calibration_;
+  LaserTable laser_table_;
   float sin_rot_table_[ROTATION_MAX_UNITS];
   float cos_rot_table_[ROTATION_MAX_UNITS];
   double last_time_stamp_;
@@ -271,6 +301,22 @@ class VelodyneParser {
                      const LaserCorrection& corrections,
                      const uint16_t rotation, PointXYZIT* point);
 
+  /**
+   * \brief Fill laser_table_ from calibration_, again whenever it changes
+   */
+  void InitLaserTable();
+
+  /**
+   * \brief Compute coords of all returns of a block at once
+   *
+   * The returns are fired by the consecutive lasers from first_laser at the
+   * same rotation. Same arithmetic as ComputeCoords, on laser_table_ arrays
+   * so the compiler vectorizes the loop over the block.
+   */
+  void ComputeBlockCoords(const RawBlock& block, int first_laser,
+                          float distance_resolution, uint16_t rotation,
+                          BlockCoords* coords) const;
+
   bool is_scan_valid(int rotation, float distance);
 
   /**
@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Packet to point conversion of the HDL-64 parser: BM_ComputeCoords converts
+// every return on its own the way the parsers used to, BM_ComputeBlockCoords
+// a whole block at once. Both run over the same packets and the points have
+// to agree, mismatched_points counts the ones that are not bit identical and
+// max_error_m is the largest difference. Packets are recorded ones when
+// --benchmark_pcap_file is given, random returns otherwise:
+//   velodyne_parser_benchmark --benchmark_pcap_file=/path/to/hdl64.pcap
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "modules/drivers/lidar/common/pcap_packet_input.h"
+#include "modules/drivers/lidar/velodyne/parser/velodyne_parser.h"
+
+DEFINE_string(benchmark_calibration_file,
+              "modules/drivers/lidar/velodyne/params/"
+              "64E_S3_calibration_example.yaml",
+              "HDL-64 calibration the packets are converted with");
+DEFINE_string(benchmark_pcap_file, "", "recorded HDL-64 packets");
+DEFINE_int32(benchmark_pcap_port, 2368, "firing data port in the capture");
+
+namespace apollo {
+namespace drivers {
+namespace velodyne {
+namespace {
+
+constexpr int kPacketNum = 580;  // about one rotation at 10 Hz
+
+class ParserProbe : public Velodyne64Parser {
+ public:
+  explicit ParserProbe(const Config& config) : Velodyne64Parser(config) {}
+
+  // returns in the order of the block, nan for no return
+  void PointCoords(const RawBlock& block, std::vector<float>* xyz) {
+    const int bank_origin = block.laser_block_id == LOWER_BANK ? 32 : 0;
+    for (int j = 0, k = 0; j < SCANS_PER_BLOCK; ++j, k += RAW_SCAN_SIZE) {
+      LaserCorrection& corrections =
+          calibration_.laser_corrections_[j + bank_origin];
+      union RawDistance raw_distance;
+      raw_distance.bytes[0] = block.data[k];
+      raw_distance.bytes[1] = block.data[k + 1];
+      float real_distance = raw_distance.raw_distance * DISTANCE_RESOLUTION;
+      PointXYZIT point;
+      ComputeCoords(real_distance, corrections, block.rotation, &point);
+      Append(raw_distance.raw_distance != 0, point.x(), point.y(), point.z(),
+             xyz);
+    }
+  }
+
+  void BlockCoords(const RawBlock& block, std::vector<float>* xyz) {
+    const int bank_origin = block.laser_block_id == LOWER_BANK ? 32 : 0;
+    velodyne::BlockCoords coords;
+    ComputeBlockCoords(block, bank_origin, DISTANCE_RESOLUTION,
+                       block.rotation, &coords);
+    for (int j = 0; j < SCANS_PER_BLOCK; ++j) {
+      Append(coords.raw_distance[j] != 0, coords.x[j], coords.y[j],
+             coords.z[j], xyz);
+    }
+  }
+
+ private:
+  static void Append(bool valid, float x, float y, float z,
+                     std::vector<float>* xyz) {
+    xyz->push_back(valid ? x : nan);
+    xyz->push_back(valid ? y : nan);
+    xyz->push_back(valid ? z : nan);
+  }
+};
+
+std::vector<RawPacket> LoadPackets() {
+  std::vector<RawPacket> packets;
+  if (!FLAGS_benchmark_pcap_file.empty()) {
+    lidar::PcapPacketInput input;
+    if (input.Open(FLAGS_benchmark_pcap_file,
+                   static_cast<uint16_t>(FLAGS_benchmark_pcap_port))) {
+      lidar::LidarPacketView packet;
+      while (packets.size() < kPacketNum &&
+             input.NextPacket(&packet, 0) == lidar::PacketStatus::OK) {
+        if (packet.size == PACKET_SIZE) {
+          packets.emplace_back();
+          memcpy(&packets.back(), packet.data, sizeof(RawPacket));
+        }
+      }
+    }
+    return packets;
+  }
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> distance(0, 60000);
+  packets.resize(kPacketNum);
+  for (int i = 0; i < kPacketNum; ++i) {
+    RawPacket& packet = packets[i];
+    memset(&packet, 0, sizeof(packet));
+    for (int b = 0; b < BLOCKS_PER_PACKET; ++b) {
+      RawBlock& block = packet.blocks[b];
+      block.laser_block_id = (b & 1) ? LOWER_BANK : UPPER_BANK;
+      block.rotation = static_cast<uint16_t>((i * 62 + (b / 2) * 10) % 36000);
+      for (int k = 0; k < BLOCK_DATA_SIZE; k += RAW_SCAN_SIZE) {
+        // every tenth return missing
+        const int raw = k % 30 == 0 ? 0 : distance(random);
+        block.data[k] = static_cast<uint8_t>(raw & 0xff);
+        block.data[k + 1] = static_cast<uint8_t>(raw >> 8);
+        block.data[k + 2] = static_cast<uint8_t>(raw % 256);
+      }
+    }
+  }
+  return packets;
+}
+
+ParserProbe* Probe() {
+  static ParserProbe* probe = [] {
+    Config config;
+    config.set_model(HDL64E_S3S);
+    config.set_calibration_online(false);
+    config.set_calibration_file(FLAGS_benchmark_calibration_file);
+    config.set_min_range(0.9);
+    config.set_max_range(200.0);
+    auto* parser = new ParserProbe(config);
+    parser->setup();
+    return parser;
+  }();
+  return probe;
+}
+
+template <typename Convert>
+std::vector<float> ConvertAll(const std::vector<RawPacket>& packets,
+                              Convert convert) {
+  std::vector<float> xyz;
+  xyz.reserve(packets.size() * SCANS_PER_PACKET * 3);
+  for (const auto& packet : packets) {
+    for (const auto& block : packet.blocks) {
+      convert(block, &xyz);
+    }
+  }
+  return xyz;
+}
+
+void ComparePoints(const std::vector<float>& expected,
+                   const std::vector<float>& actual, benchmark::State* state) {
+  int mismatched = 0;
+  double max_error = 0.0;
+  for (size_t i = 0; i < expected.size() && i < actual.size(); ++i) {
+    if (std::isnan(expected[i]) && std::isnan(actual[i])) {
+      continue;
+    }
+    if (memcmp(&expected[i], &actual[i], sizeof(float)) != 0) {
+      ++mismatched;
+      max_error = std::max(
+          max_error, static_cast<double>(std::fabs(expected[i] - actual[i])));
+    }
+  }
+  if (expected.size() != actual.size()) {
+    state->SkipWithError("point count differs");
+  }
+  state->counters["mismatched_points"] = mismatched;
+  state->counters["max_error_m"] = max_error;
+}
+
+void RunConvert(benchmark::State& state, bool block) {
+  const auto packets = LoadPackets();
+  if (packets.empty()) {
+    state.SkipWithError("no packets");
+    return;
+  }
+  ParserProbe* probe = Probe();
+  auto per_point = [probe](const RawBlock& b, std::vector<float>* xyz) {
+    probe->PointCoords(b, xyz);
+  };
+  auto per_block = [probe](const RawBlock& b, std::vector<float>* xyz) {
+    probe->BlockCoords(b, xyz);
+  };
+  std::vector<float> xyz;
+  for (auto _ : state) {
+    xyz = block ? ConvertAll(packets, per_block)
+                : ConvertAll(packets, per_point);
+    benchmark::DoNotOptimize(xyz.data());
+  }
+  ComparePoints(ConvertAll(packets, per_point), xyz, &state);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(xyz.size() / 3));
+}
+
+void BM_ComputeCoords(benchmark::State& state) { RunConvert(state, false); }
+BENCHMARK(BM_ComputeCoords)->Unit(benchmark::kMicrosecond);
+
+void BM_ComputeBlockCoords(benchmark::State& state) {
+  RunConvert(state, true);
+}
+BENCHMARK(BM_ComputeBlockCoords)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace velodyne
+}  // namespace drivers
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
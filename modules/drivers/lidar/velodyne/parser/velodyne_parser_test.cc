@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/drivers/lidar/velodyne/parser/velodyne_parser.h"
+
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace drivers {
+namespace velodyne {
+
+// ComputeBlockCoords keeps the arithmetic of ComputeCoords, the points agree
+// to far below a float step at the maximum range
+constexpr float kToleranceM = 1e-5f;
+
+class ParserProbe : public Velodyne64Parser {
+ public:
+  explicit ParserProbe(const Config& config) : Velodyne64Parser(config) {}
+
+  void set_two_pt_correction(bool enable) {
+    need_two_pt_correction_ = enable;
+  }
+
+  // converts every return of the block on its own
+  void PointCoords(const RawBlock& block, int first_laser, uint16_t rotation,
+                   BlockCoords* coords) {
+    for (int j = 0, k = 0; j < SCANS_PER_BLOCK; ++j, k += RAW_SCAN_SIZE) {
+      LaserCorrection& corrections =
+          calibration_.laser_corrections_[j + first_laser];
+      union RawDistance raw_distance;
+      raw_distance.bytes[0] = block.data[k];
+      raw_distance.bytes[1] = block.data[k + 1];
+      coords->raw_distance[j] = raw_distance.raw_distance;
+      coords->real_distance[j] =
+          raw_distance.raw_distance * DISTANCE_RESOLUTION;
+      PointXYZIT point;
+      ComputeCoords(coords->real_distance[j], corrections, rotation, &point);
+      coords->x[j] = point.x();
+      coords->y[j] = point.y();
+      coords->z[j] = point.z();
+    }
+  }
+
+  void BlockCoords(const RawBlock& block, int first_laser, uint16_t rotation,
+                   velodyne::BlockCoords* coords) {
+    ComputeBlockCoords(block, first_laser, DISTANCE_RESOLUTION, rotation,
+                       coords);
+  }
+};
+
+Config HDL64Config() {
+  Config config;
+  config.set_model(HDL64E_S3S);
+  config.set_calibration_online(false);
+  config.set_calibration_file(
+      "modules/drivers/lidar/velodyne/params/"
+      "64E_S3_calibration_example.yaml");
+  config.set_min_range(0.9);
+  config.set_max_range(200.0);
+  return config;
+}
+
+void ExpectSameCoords(const BlockCoords& expected, const BlockCoords& actual,
+                      uint16_t rotation) {
+  for (int j = 0; j < SCANS_PER_BLOCK; ++j) {
+    EXPECT_EQ(expected.raw_distance[j], actual.raw_distance[j]);
+    EXPECT_EQ(expected.real_distance[j], actual.real_distance[j]);
+    EXPECT_NEAR(expected.x[j], actual.x[j], kToleranceM)
+        << "rotation " << rotation << " return " << j;
+    EXPECT_NEAR(expected.y[j], actual.y[j], kToleranceM)
+        << "rotation " << rotation << " return " << j;
+    EXPECT_NEAR(expected.z[j], actual.z[j], kToleranceM)
+        << "rotation " << rotation << " return " << j;
+  }
+}
+
+TEST(VelodyneParserTest, block_coords_test) {
+  ParserProbe parser(HDL64Config());
+  parser.setup();
+  ASSERT_TRUE(parser.get_calibration().initialized_);
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> distance(0, 60000);
+  for (const bool two_pt_correction : {true, false}) {
+    parser.set_two_pt_correction(two_pt_correction);
+    // every rotation step of 0.7 degrees, and the end of the table
+    for (int rotation = 0; rotation <= 36000; rotation += 70) {
+      for (const int first_laser : {0, 32}) {
+        RawBlock block;
+        block.laser_block_id = first_laser == 0 ? UPPER_BANK : LOWER_BANK;
+        block.rotation = static_cast<uint16_t>(rotation);
+        for (int k = 0; k < BLOCK_DATA_SIZE; k += RAW_SCAN_SIZE) {
+          // short ranges take the two point correction, some without return
+          const int raw = k % 30 == 0 ? 0
+                          : k % 9 == 0 ? distance(random) % 2500
+                                       : distance(random);
+          block.data[k] = static_cast<uint8_t>(raw & 0xff);
+          block.data[k + 1] = static_cast<uint8_t>(raw >> 8);
+          block.data[k + 2] = static_cast<uint8_t>(raw % 256);
+        }
+        BlockCoords expected;
+        BlockCoords actual;
+        parser.PointCoords(block, first_laser, block.rotation, &expected);
+        parser.BlockCoords(block, first_laser, block.rotation, &actual);
+        ExpectSameCoords(expected, actual, block.rotation);
+      }
+    }
+  }
+}
+
+}  // namespace velodyne
+}  // namespace drivers
+}  // namespace apollo
@@ -16,8 +16,11 @@
 
 #include "modules/localization/msf/local_pyramid_map/base_map/base_map.h"
 
+#include <algorithm>
+#include <chrono>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
@@ -35,7 +38,10 @@ BaseMap::BaseMap(BaseMapConfig* config)
       map_node_cache_lvl2_(nullptr),
       map_node_pool_(nullptr) {}
 
-BaseMap::~BaseMap() {}
+BaseMap::~BaseMap() {
+  // the loads still running use the caches and the pool
+  map_load_workers_.reset();
+}
 
 void BaseMap::InitMapNodeCaches(int cacheL1_size, int cahceL2_size) {
   destroy_func_lvl1_ =
@@ -52,6 +58,10 @@ void BaseMap::InitMapNodeCaches(int cacheL1_size, int cahceL2_size) {
 
 void BaseMap::AttachMapNodePool(BaseMapNodePool* map_node_pool) {
   map_node_pool_ = map_node_pool;
+  if (map_load_workers_ == nullptr && map_node_pool_ != nullptr) {
+    map_load_workers_.reset(new cyber::base::ThreadPool(
+        std::max(map_node_pool_->GetThreadSize(), 1u)));
+  }
 }
 
 BaseMapNode* BaseMap::GetMapNode(const MapNodeIndex& index) {
@@ -86,10 +96,25 @@ BaseMapNode* BaseMap::GetMapNodeSafe(const MapNodeIndex& index) {
   std::cerr << "GetMapNodeSafe: This node don't exist in cache! " << std::endl
             << "load this node from disk now!" << index << std::endl;
 
-  LoadMapNodeThreadSafety(index, true);
+  std::shared_future<void> load = LoadMapNodeAsync(index, true);
+  if (load.valid()) {
+    load.wait();
+  }
 
   boost::unique_lock<boost::recursive_mutex> lock3(map_load_mutex_);
-  map_node_cache_lvl2_->Get(index, &node);
+  while (!map_node_cache_lvl2_->Get(index, &node)) {
+    lock3.unlock();
+    // no node is loaded without a node pool
+    if (map_node_pool_ == nullptr) {
+      return nullptr;
+    }
+    // the preload waited for gave up on a full pool, or the load was not
+    // queued, a reserved load waits for a free node
+    LoadMapNodeThreadSafety(index, true);
+    lock3.lock();
+  }
+  // the node may come from a preload
+  node->SetIsReserved(true);
   map_node_cache_lvl1_->Put(index, node);
   lock3.unlock();
 
@@ -125,6 +150,7 @@ void BaseMap::LoadMapNodes(std::set<MapNodeIndex>* map_ids) {
     std::cerr << "map_ids's size is bigger than cache's capacity" << std::endl;
     return;
   }
+  const size_t request_count = map_ids->size();
 
   // check in cacheL1
   std::set<MapNodeIndex>::iterator itr = map_ids->begin();
@@ -142,23 +168,96 @@ void BaseMap::LoadMapNodes(std::set<MapNodeIndex>* map_ids) {
   }
   // check and update cache
   CheckAndUpdateCache(map_ids);
-  // load from disk sync
-  std::vector<std::future<void>> load_futures_;
-  itr = map_ids->begin();
-  while (itr != map_ids->end()) {
-    AERROR << "Preload map node failed!";
-    load_futures_.emplace_back(
-        cyber::Async(&BaseMap::LoadMapNodeThreadSafety, this, *itr, true));
-    ++itr;
+  const size_t hit_count = request_count - map_ids->size();
+  if (map_ids->empty()) {
+    boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+    map_node_cache_stats_.hit_count += hit_count;
+    return;
   }
 
-  for (auto& future : load_futures_) {
-    if (future.valid()) {
-      future.get();
+  // Wait for the nodes still preloading and load the others from disk. A
+  // preloaded node is not reserved until it is in cacheL1, another load may
+  // drop it from cacheL2 before, so it is loaded once more.
+  const auto start_time = std::chrono::steady_clock::now();
+  size_t stall_count = 0;
+  size_t miss_count = 0;
+  for (int round = 0; round < 2 && !map_ids->empty(); ++round) {
+    std::vector<std::shared_future<void>> load_futures;
+    for (const MapNodeIndex& index : *map_ids) {
+      bool is_loading = false;
+      load_futures.push_back(LoadMapNodeAsync(index, true, &is_loading));
+      if (round == 0 && is_loading) {
+        ++stall_count;
+      } else {
+        ++miss_count;
+      }
     }
+    for (auto& future : load_futures) {
+      if (future.valid()) {
+        future.wait();
+      }
+    }
+    // check in cacheL2 again
+    CheckAndUpdateCache(map_ids);
   }
-  // check in cacheL2 again
-  CheckAndUpdateCache(map_ids);
+  if (!map_ids->empty() && map_node_pool_ != nullptr) {
+    // the loads were not queued, load the nodes here
+    for (const MapNodeIndex& index : *map_ids) {
+      LoadMapNodeThreadSafety(index, true);
+    }
+    CheckAndUpdateCache(map_ids);
+  }
+  const double wait_time_ms =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start_time)
+          .count();
+
+  boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+  map_node_cache_stats_.hit_count += hit_count;
+  map_node_cache_stats_.stall_count += stall_count;
+  map_node_cache_stats_.miss_count += miss_count;
+  map_node_cache_stats_.wait_time_ms += wait_time_ms;
+  ADEBUG << "Waited " << wait_time_ms << " ms for " << stall_count
+         << " preloading and " << miss_count << " missing map nodes, total hit "
+         << map_node_cache_stats_.hit_count << " stall "
+         << map_node_cache_stats_.stall_count << " miss "
+         << map_node_cache_stats_.miss_count;
+}
+
+std::shared_future<void> BaseMap::LoadMapNodeAsync(const MapNodeIndex& index,
+                                                   bool is_reserved,
+                                                   bool* is_loading) {
+  // the load removes itself from map_loading_tasks_ with the lock held
+  boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+  auto itr = map_loading_tasks_.find(index);
+  if (is_loading != nullptr) {
+    *is_loading = itr != map_loading_tasks_.end();
+  }
+  if (itr != map_loading_tasks_.end()) {
+    return itr->second;
+  }
+  if (map_load_workers_ == nullptr) {
+    return std::shared_future<void>();
+  }
+  std::shared_future<void> load =
+      map_load_workers_
+          ->Enqueue(&BaseMap::LoadMapNodeThreadSafety, this, index,
+                    is_reserved)
+          .share();
+  // a load takes the lock before it ends, so its future can only be ready
+  // here when the full task queue dropped the load
+  if (!load.valid() ||
+      load.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    AWARN << "Map node load is not queued: " << index;
+    return std::shared_future<void>();
+  }
+  map_loading_tasks_[index] = load;
+  return load;
+}
+
+MapNodeCacheStats BaseMap::GetMapNodeCacheStats() {
+  boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+  return map_node_cache_stats_;
 }
 
 void BaseMap::CheckAndUpdateCache(std::set<MapNodeIndex>* map_ids) {
@@ -196,32 +295,14 @@ void BaseMap::PreloadMapNodes(std::set<MapNodeIndex>* map_ids) {
       ++itr;
     }
   }
-  // check whether in already preloading index set
-  itr = map_ids->begin();
-  auto preloading_itr = map_preloading_task_index_.end();
-  while (itr != map_ids->end()) {
-    boost::unique_lock<boost::recursive_mutex> lock2(map_load_mutex_);
-    preloading_itr = map_preloading_task_index_.find(*itr);
-    lock2.unlock();
-    if (preloading_itr != map_preloading_task_index_.end()) {
-      // already preloading
-      itr = map_ids->erase(itr);
-    } else {
-      ++itr;
-    }
-  }
-  // load form disk sync
-  std::vector<std::future<void>> preload_futures;
-  itr = map_ids->begin();
+  // load from disk async, the nodes already loading are skipped
   AINFO << "Preload map node size: " << map_ids->size();
-  while (itr != map_ids->end()) {
-    AINFO << "Preload map node: " << *itr << std::endl;
-    boost::unique_lock<boost::recursive_mutex> lock3(map_load_mutex_);
-    map_preloading_task_index_.insert(*itr);
-    lock3.unlock();
-    preload_futures.emplace_back(
-        cyber::Async(&BaseMap::LoadMapNodeThreadSafety, this, *itr, false));
-    ++itr;
+  for (const MapNodeIndex& index : *map_ids) {
+    bool is_loading = false;
+    LoadMapNodeAsync(index, false, &is_loading);
+    if (!is_loading) {
+      AINFO << "Preload map node: " << index;
+    }
   }
 }
 
@@ -236,6 +317,12 @@ void BaseMap::LoadMapNodeThreadSafety(const MapNodeIndex& index,
       lock.unlock();
       if (node_remove) {
         map_node_pool_->FreeMapNode(node_remove);
+      } else if (!is_reserved) {
+        // all the nodes of the pool are in use, a preload does not wait
+        AWARN << "No free map node to preload: " << index;
+        lock.lock();
+        map_loading_tasks_.erase(index);
+        return;
       }
     }
   }
@@ -249,11 +336,8 @@ void BaseMap::LoadMapNodeThreadSafety(const MapNodeIndex& index,
   map_node->SetIsReserved(is_reserved);
   boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
   BaseMapNode* node_remove = map_node_cache_lvl2_->Put(index, map_node);
-  // if the node already added into cacheL2, erase it from preloading set
-  auto itr = map_preloading_task_index_.find(index);
-  if (itr != map_preloading_task_index_.end()) {
-    map_preloading_task_index_.erase(itr);
-  }
+  // if the node already added into cacheL2, erase it from loading tasks
+  map_loading_tasks_.erase(index);
   lock.unlock();
   if (node_remove) {
     map_node_pool_->FreeMapNode(node_remove);
@@ -15,12 +15,15 @@
  *****************************************************************************/
 #pragma once
 
+#include <cstdint>
+#include <future>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "cyber/base/thread_pool.h"
 #include "cyber/task/task.h"
 #include "modules/localization/msf/common/util/base_map_cache.h"
 #include "modules/localization/msf/local_pyramid_map/base_map/base_map_config.h"
@@ -34,6 +37,18 @@ namespace localization {
 namespace msf {
 namespace pyramid_map {
 
+/**@brief Counters of the map nodes LoadMapArea asked for. */
+struct MapNodeCacheStats {
+  /**@brief Nodes found in the caches. */
+  uint64_t hit_count = 0;
+  /**@brief Nodes still being preloaded, LoadMapArea waited for them. */
+  uint64_t stall_count = 0;
+  /**@brief Nodes neither cached nor preloaded, LoadMapArea loaded them. */
+  uint64_t miss_count = 0;
+  /**@brief Time LoadMapArea waited for stalled and missed nodes. */
+  double wait_time_ms = 0.0;
+};
+
 /**@brief The data structure of the base map. */
 class BaseMap {
  public:
@@ -45,7 +60,8 @@ class BaseMap {
   // @brief Init level 1 and level 2 map node caches. */
   virtual void InitMapNodeCaches(int cacheL1_size, int cahceL2_size);
 
-  /**@brief Attach map node pointer. */
+  /**@brief Attach map node pointer. The map nodes are loaded on as many
+   * threads as the thread size of the first pool attached. */
   void AttachMapNodePool(BaseMapNodePool* p_map_node_pool);
 
   /**@brief Return the map node, if it's not in the cache, return false. */
@@ -105,6 +121,8 @@ class BaseMap {
   inline const std::vector<std::string>& GetAllMapNodeMd5s() const {
     return all_map_node_md5s_;
   }
+  /**@brief Get the counters of the map nodes LoadMapArea asked for. */
+  MapNodeCacheStats GetMapNodeCacheStats();
 
  protected:
   void GetAllMapIndexAndPath();
@@ -118,6 +136,12 @@ class BaseMap {
   /**@brief Load map node by index, thread_safety. */
   void LoadMapNodeThreadSafety(const MapNodeIndex& index,
                                bool is_reserved = false);
+  /**@brief Load map node by index on the load workers unless it is being
+   * loaded already, is_loading tells which. Return the future of the load,
+   * invalid when the load is not queued. */
+  std::shared_future<void> LoadMapNodeAsync(const MapNodeIndex& index,
+                                            bool is_reserved,
+                                            bool* is_loading = nullptr);
   /**@brief Check map node in L2 Cache.*/
   void CheckAndUpdateCache(std::set<MapNodeIndex>* map_ids);
 
@@ -134,10 +158,14 @@ class BaseMap {
       map_node_cache_lvl2_ = nullptr;
   /**@brief The map node memory pool pointer. */
   BaseMapNodePool* map_node_pool_ = nullptr;
-  /**@bried Keep the index of preloading nodes. */
-  std::set<MapNodeIndex> map_preloading_task_index_;
+  /**@brief The map nodes being loaded and their loads. */
+  std::map<MapNodeIndex, std::shared_future<void>> map_loading_tasks_;
   /**@brief The mutex for preload map node. **/
   boost::recursive_mutex map_load_mutex_;
+  /**@brief The threads loading the map nodes from the disk. */
+  std::unique_ptr<cyber::base::ThreadPool> map_load_workers_;
+  /**@brief Counters of LoadMapArea, guarded by map_load_mutex_. */
+  MapNodeCacheStats map_node_cache_stats_;
 
   /**@brief All the map nodes in the Map (in the disk). */
   std::vector<MapNodeIndex> all_map_node_indices_;
@@ -27,7 +27,7 @@ namespace pyramid_map {
 
 BaseMapNodePool::BaseMapNodePool(unsigned int pool_size,
                                  unsigned int thread_size)
-    : pool_size_(pool_size) {}
+    : pool_size_(pool_size), thread_size_(thread_size) {}
 
 BaseMapNodePool::~BaseMapNodePool() { Release(); }
 
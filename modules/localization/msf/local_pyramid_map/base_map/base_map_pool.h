@@ -57,6 +57,8 @@ class BaseMapNodePool {
   void FreeMapNode(BaseMapNode* map_node);
   /**@brief Get the size of pool. */
   unsigned int GetPoolSize() { return pool_size_; }
+  /**@brief Get the size of the thread pool loading the nodes. */
+  unsigned int GetThreadSize() { return thread_size_; }
 
  private:
   /**@brief The task function of the thread pool for release node.
@@ -83,6 +85,8 @@ class BaseMapNodePool {
   std::set<BaseMapNode*> busy_nodes_;
   /**@brief The size of memory pool. */
   unsigned int pool_size_ = 0;
+  /**@brief The size of the thread pool loading the nodes. */
+  unsigned int thread_size_ = 0;
   /**@brief The thread pool for release node. */
   std::future<void> node_reset_workers_;
   /**@brief The mutex for release thread.*/
@@ -13,6 +13,12 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  *****************************************************************************/
+#include <chrono>
+#include <future>
+#include <memory>
+#include <set>
+#include <thread>
+
 #include <boost/filesystem.hpp>
 
 #include "gtest/gtest.h"
@@ -224,6 +230,195 @@ TEST_F(PyramidMapTestSuite, test_init) {
   EXPECT_TRUE(pyramid_map.LoadMapArea(loc, 0, 50, 0, 0));
 }
 
+TEST_F(PyramidMapTestSuite, test_preload_map_area) {
+  // init config
+  PyramidMapConfig* config = new PyramidMapConfig("lossy_full_alt");
+  config->SetMapNodeSize(2, 2);
+  config->resolution_num_ = 1;
+  config->map_folder_path_ = "test_map";
+
+  // create and save nodes
+  for (unsigned int m = 0; m < 4; ++m) {
+    for (unsigned int n = 0; n < 4; ++n) {
+      MapNodeIndex index;
+      index.resolution_id_ = 0;
+      index.zone_id_ = 50;
+      index.m_ = m;
+      index.n_ = n;
+      CreateTestMapNode(m, n, index, config);
+    }
+  }
+  config->Save("test_map/config.xml");
+
+  PyramidMapNodePool pm_node_pool(16, 4);
+  pm_node_pool.Initial(config);
+  PyramidMap pyramid_map(config);
+  pyramid_map.InitMapNodeCaches(4, 15);
+  pyramid_map.AttachMapNodePool(&pm_node_pool);
+  EXPECT_TRUE(pyramid_map.SetMapFolderPath(config->map_folder_path_));
+
+  // nothing is cached for the first area
+  Eigen::Vector3d loc(0.375, 0.375, 1.0);
+  EXPECT_TRUE(pyramid_map.LoadMapArea(loc, 0, 50, 0, 0));
+  MapNodeCacheStats stats = pyramid_map.GetMapNodeCacheStats();
+  EXPECT_EQ(stats.hit_count, 0);
+  EXPECT_EQ(stats.stall_count, 0);
+  EXPECT_EQ(stats.miss_count, 4);
+
+  // moving along +x and +y, the nodes of the next area are loaded or loading
+  pyramid_map.PreloadMapArea(loc, Eigen::Vector3d(1.0, 1.0, 0.0), 0, 50);
+  loc[0] += 0.25;
+  loc[1] += 0.25;
+  EXPECT_TRUE(pyramid_map.LoadMapArea(loc, 0, 50, 0, 0));
+  stats = pyramid_map.GetMapNodeCacheStats();
+  EXPECT_EQ(stats.hit_count + stats.stall_count, 4);
+  EXPECT_EQ(stats.miss_count, 4);
+  EXPECT_FLOAT_EQ(pyramid_map.GetIntensitySafe(loc, 50, 0),
+                  2.f * static_cast<float>(config->map_node_size_x_) + 2.f);
+
+  if (config != nullptr) {
+    delete config;
+    config = nullptr;
+  }
+}
+
+// Gives the tests access to the loads of the map.
+class PyramidMapLoadProbe : public PyramidMap {
+ public:
+  explicit PyramidMapLoadProbe(PyramidMapConfig* config)
+      : PyramidMap(config) {}
+
+  using BaseMap::PreloadMapNodes;
+
+  std::shared_future<void> LoadingTask(const MapNodeIndex& index) {
+    boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+    auto itr = map_loading_tasks_.find(index);
+    return itr == map_loading_tasks_.end() ? std::shared_future<void>()
+                                           : itr->second;
+  }
+
+  void SetIsReserved(BaseMapNode* node, bool is_reserved) {
+    boost::unique_lock<boost::recursive_mutex> lock(map_load_mutex_);
+    node->SetIsReserved(is_reserved);
+  }
+
+  // occupies the only load worker until the returned promise is set
+  std::shared_ptr<std::promise<void>> BlockLoadWorker() {
+    auto gate = std::make_shared<std::promise<void>>();
+    std::shared_future<void> opened = gate->get_future().share();
+    std::promise<void> started;
+    std::future<void> is_started = started.get_future();
+    map_load_workers_->Enqueue([opened, &started]() {
+      started.set_value();
+      opened.wait();
+    });
+    is_started.wait();
+    return gate;
+  }
+
+  // fills the task queue of the load workers, the surplus tasks are dropped
+  void FillLoadQueue() {
+    for (int i = 0; i < 1100; ++i) {
+      map_load_workers_->Enqueue([]() {});
+    }
+  }
+};
+
+MapNodeIndex TestMapNodeIndex(unsigned int m, unsigned int n) {
+  MapNodeIndex index;
+  index.resolution_id_ = 0;
+  index.zone_id_ = 50;
+  index.m_ = m;
+  index.n_ = n;
+  return index;
+}
+
+PyramidMapConfig* CreateTestMap() {
+  PyramidMapConfig* config = new PyramidMapConfig("lossy_full_alt");
+  config->SetMapNodeSize(2, 2);
+  config->resolution_num_ = 1;
+  config->map_folder_path_ = "test_map";
+  for (unsigned int m = 0; m < 2; ++m) {
+    for (unsigned int n = 0; n < 2; ++n) {
+      CreateTestMapNode(m, n, TestMapNodeIndex(m, n), config);
+    }
+  }
+  config->Save("test_map/config.xml");
+  return config;
+}
+
+TEST_F(PyramidMapTestSuite, test_get_node_after_failed_preload) {
+  std::unique_ptr<PyramidMapConfig> config(CreateTestMap());
+  PyramidMapNodePool pm_node_pool(2, 1);
+  pm_node_pool.Initial(config.get());
+  PyramidMapLoadProbe pyramid_map(config.get());
+  pyramid_map.InitMapNodeCaches(3, 3);
+  pyramid_map.AttachMapNodePool(&pm_node_pool);
+  EXPECT_TRUE(pyramid_map.SetMapFolderPath(config->map_folder_path_));
+
+  // both nodes of the pool are in use
+  BaseMapNode* node_a = pyramid_map.GetMapNodeSafe(TestMapNodeIndex(0, 0));
+  BaseMapNode* node_b = pyramid_map.GetMapNodeSafe(TestMapNodeIndex(0, 1));
+  ASSERT_NE(node_a, nullptr);
+  ASSERT_NE(node_b, nullptr);
+
+  // the preload is queued behind a blocked load and is waited for by the get
+  const MapNodeIndex index = TestMapNodeIndex(1, 1);
+  auto gate = pyramid_map.BlockLoadWorker();
+  std::set<MapNodeIndex> preload_ids = {index};
+  pyramid_map.PreloadMapNodes(&preload_ids);
+  std::shared_future<void> preload = pyramid_map.LoadingTask(index);
+  ASSERT_TRUE(preload.valid());
+  BaseMapNode* node = nullptr;
+  std::thread get_thread(
+      [&pyramid_map, &index, &node]() {
+        node = pyramid_map.GetMapNodeSafe(index);
+      });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  // the preload gives up on the exhausted pool, then a node is released
+  gate->set_value();
+  preload.wait();
+  EXPECT_FALSE(pyramid_map.LoadingTask(index).valid());
+  pyramid_map.SetIsReserved(node_a, false);
+  pyramid_map.SetIsReserved(node_b, false);
+  get_thread.join();
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->GetMapNodeIndex(), index);
+  EXPECT_TRUE(node->GetIsReserved());
+}
+
+TEST_F(PyramidMapTestSuite, test_get_node_with_full_load_queue) {
+  std::unique_ptr<PyramidMapConfig> config(CreateTestMap());
+  PyramidMapNodePool pm_node_pool(4, 1);
+  pm_node_pool.Initial(config.get());
+  PyramidMapLoadProbe pyramid_map(config.get());
+  pyramid_map.InitMapNodeCaches(3, 4);
+  pyramid_map.AttachMapNodePool(&pm_node_pool);
+  EXPECT_TRUE(pyramid_map.SetMapFolderPath(config->map_folder_path_));
+
+  // the load is dropped by the full queue, the node is loaded in the call
+  auto gate = pyramid_map.BlockLoadWorker();
+  pyramid_map.FillLoadQueue();
+  const MapNodeIndex index = TestMapNodeIndex(1, 0);
+  BaseMapNode* node = pyramid_map.GetMapNodeSafe(index);
+  ASSERT_NE(node, nullptr);
+  EXPECT_EQ(node->GetMapNodeIndex(), index);
+  // no dead load is kept for the node
+  EXPECT_FALSE(pyramid_map.LoadingTask(index).valid());
+
+  // the preloads dropped as well are loaded by the next area
+  std::set<MapNodeIndex> preload_ids = {TestMapNodeIndex(0, 0),
+                                        TestMapNodeIndex(0, 1)};
+  pyramid_map.PreloadMapNodes(&preload_ids);
+  EXPECT_FALSE(pyramid_map.LoadingTask(TestMapNodeIndex(0, 0)).valid());
+  Eigen::Vector3d loc(0.375, 0.375, 1.0);
+  EXPECT_TRUE(pyramid_map.LoadMapArea(loc, 0, 50, 0, 0));
+  EXPECT_FLOAT_EQ(pyramid_map.GetIntensitySafe(loc, 50, 0),
+                  static_cast<float>(config->map_node_size_x_) + 1.f);
+  gate->set_value();
+}
+
 }  // namespace pyramid_map
 }  // namespace msf
 }  // namespace localization
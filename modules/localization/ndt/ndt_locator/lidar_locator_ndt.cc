@@ -85,6 +85,7 @@ void LidarLocatorNdt::Init(const Eigen::Affine3d& init_location,
   reg_.SetResolution(static_cast<float>(ndt_target_resolution_));
   reg_.SetStepSize(ndt_line_search_step_size_);
   reg_.SetTransformationEpsilon(ndt_transformation_epsilon_);
+  reg_.SetThreadNum(FLAGS_ndt_thread_num);
 
   is_initialized_ = true;
 }
@@ -56,11 +56,13 @@
 #pragma once
 
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include "pcl/registration/registration.h"
 #include "unsupported/Eigen/NonLinearOptimization"
 
+#include "cyber/base/thread_pool.h"
 #include "cyber/common/log.h"
 #include "modules/common/util/perf_util.h"
 #include "modules/localization/ndt/ndt_locator/ndt_voxel_grid_covariance.h"
@@ -91,6 +93,34 @@ class NormalDistributionsTransform {
   typedef pcl::search::KdTree<PointTarget> KdTree;
   typedef typename pcl::search::KdTree<PointTarget>::Ptr KdTreePtr;
 
+  /**@brief The first order derivative of the transformation of a point
+   * w.r.t. the transform vector, Equation 6.18 [Magnusson 2009], and the
+   * second order one, Equation 6.20 [Magnusson 2009]. */
+  struct PointDerivatives {
+    PointDerivatives() {
+      gradient.setZero();
+      gradient.block<3, 3>(0, 0).setIdentity();
+      hessian.setZero();
+    }
+    Eigen::Matrix<double, 3, 6> gradient;
+    Eigen::Matrix<double, 18, 6> hessian;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /**@brief Score, gradient and hessian summed over the points of a chunk,
+   * the chunks are summed in order. */
+  struct ChunkDerivatives {
+    double score;
+    Eigen::Matrix<double, 6, 1> gradient;
+    Eigen::Matrix<double, 6, 6> hessian;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /**@brief Input points a thread takes at once. */
+  static constexpr int kChunkPointNum = 256;
+
  public:
   /**@brief Typedef shared pointer. */
   typedef boost::shared_ptr<
@@ -148,6 +178,13 @@ class NormalDistributionsTransform {
   /**@brief Get voxel grid resolution. */
   inline float GetResolution() const { return resolution_; }
 
+  /**@brief Set the number of threads computing the derivatives, the calling
+   * thread is one of them. The result does not depend on it. */
+  void SetThreadNum(int thread_num);
+
+  /**@brief Get the number of threads computing the derivatives. */
+  inline int GetThreadNum() const { return thread_num_; }
+
   /**@brief Get the newton line search maximum step length.
    * \return maximum step length
    */
@@ -260,7 +297,8 @@ class NormalDistributionsTransform {
                            Eigen::Matrix<double, 6, 6> *hessian,
                            const Eigen::Vector3d &x_trans,
                            const Eigen::Matrix3d &c_inv,
-                           bool ComputeHessian = true);
+                           const PointDerivatives &point_derivatives,
+                           bool ComputeHessian = true) const;
 
   /**@brief Precompute anglular components of derivatives. */
   void ComputeAngleDerivatives(const Eigen::Matrix<double, 6, 1> &p,
@@ -268,7 +306,8 @@ class NormalDistributionsTransform {
 
   /**@brief Compute point derivatives. */
   void ComputePointDerivatives(const Eigen::Vector3d &x,
-                               bool ComputeHessian = true);
+                               PointDerivatives *point_derivatives,
+                               bool ComputeHessian = true) const;
 
   /**@brief Compute hessian of probability function w.r.t. the transformation
    * vector. */
@@ -280,7 +319,26 @@ class NormalDistributionsTransform {
    * function. */
   void UpdateHessian(Eigen::Matrix<double, 6, 6> *hessian,
                      const Eigen::Vector3d &x_trans,
-                     const Eigen::Matrix3d &c_inv);
+                     const Eigen::Matrix3d &c_inv,
+                     const PointDerivatives &point_derivatives) const;
+
+  /**@brief Add the contribution of a point to all elements of the hessian,
+   * Equation 6.13 [Magnusson 2009]. */
+  void AddHessianIncrement(double e_x_cov_x, const Eigen::Vector3d &x_trans,
+                           const Eigen::Matrix3d &c_inv,
+                           const Eigen::Matrix<double, 3, 6> &cov_dxd_p,
+                           const Eigen::Matrix<double, 6, 1> &x_cov_dxd_p,
+                           const PointDerivatives &point_derivatives,
+                           Eigen::Matrix<double, 6, 6> *hessian) const;
+
+  /**@brief Call accumulate(begin, end, sum) for the chunks of kChunkPointNum
+   * input points on all threads, sum is zeroed before and kept in
+   * chunk_derivatives_. The chunks do not depend on the number of threads
+   * and summing them in order gives the same result for any. The sums are
+   * grouped differently from a single running sum over all points, so the
+   * result equals that of a per point loop only within rounding. */
+  template <typename Accumulate>
+  void AccumulateChunks(Accumulate accumulate);
 
   /**@brief Compute line search step length and update transform and probability
    * derivatives. */
@@ -363,12 +421,13 @@ class NormalDistributionsTransform {
   Eigen::Vector3d h_ang_a2_, h_ang_a3_, h_ang_b2_, h_ang_b3_, h_ang_c2_,
       h_ang_c3_, h_ang_d1_, h_ang_d2_, h_ang_d3_, h_ang_e1_, h_ang_e2_,
       h_ang_e3_, h_ang_f1_, h_ang_f2_, h_ang_f3_;
-  /**@brief The first order derivative of the transformation of a point
-   * w.r.t. the transform vector, Equation 6.18 [Magnusson 2009]. */
-  Eigen::Matrix<double, 3, 6> point_gradient_;
-  /**@brief The second order derivative of the transformation of a point
-   * w.r.t. the transform vector, Equation 6.20 [Magnusson 2009]. */
-  Eigen::Matrix<double, 18, 6> point_hessian_;
+
+  /**@brief Threads computing the derivatives, the pool runs all but the
+   * calling one. */
+  int thread_num_ = 1;
+  std::unique_ptr<cyber::base::ThreadPool> thread_pool_;
+  std::vector<ChunkDerivatives, Eigen::aligned_allocator<ChunkDerivatives>>
+      chunk_derivatives_;
 
  public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -55,6 +55,8 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <limits>
 #include <vector>
 
@@ -62,6 +64,10 @@ namespace apollo {
 namespace localization {
 namespace ndt {
 
+template <typename PointSource, typename PointTarget>
+constexpr int NormalDistributionsTransform<PointSource,
+                                           PointTarget>::kChunkPointNum;
+
 template <typename PointSource, typename PointTarget>
 void NormalDistributionsTransform<PointSource, PointTarget>::Align(
     PointCloudSourcePtr output, const Eigen::Matrix4f &guess) {
@@ -191,9 +197,7 @@ NormalDistributionsTransform<PointSource,
       h_ang_e3_(),
       h_ang_f1_(),
       h_ang_f2_(),
-      h_ang_f3_(),
-      point_gradient_(),
-      point_hessian_() {
+      h_ang_f3_() {
   double gauss_c1, gauss_c2, gauss_d3;
 
   // Initializes the guassian fitting parameters (eq. 6.8) [Magnusson 2009]
@@ -234,11 +238,6 @@ void NormalDistributionsTransform<PointSource, PointTarget>::
     transformPointCloud(*output, *output, guess);
   }
 
-  // Initialize Point Gradient and Hessian
-  point_gradient_.setZero();
-  point_gradient_.block<3, 3>(0, 0).setIdentity();
-  point_hessian_.setZero();
-
   Eigen::Transform<float, 3, Eigen::Affine, Eigen::ColMajor> eig_transformation;
   eig_transformation.matrix() = final_transformation_;
 
@@ -318,63 +317,105 @@ void NormalDistributionsTransform<PointSource, PointTarget>::
   trans_probability_ = score / static_cast<double>(input_->points.size());
 }
 
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransform<PointSource, PointTarget>::SetThreadNum(
+    int thread_num) {
+  thread_num = std::max(thread_num, 1);
+  if (thread_num == thread_num_) {
+    return;
+  }
+  thread_num_ = thread_num;
+  thread_pool_.reset(thread_num_ > 1
+                         ? new cyber::base::ThreadPool(thread_num_ - 1)
+                         : nullptr);
+  AINFO << "NDT threads: " << thread_num_;
+}
+
+template <typename PointSource, typename PointTarget>
+template <typename Accumulate>
+void NormalDistributionsTransform<PointSource, PointTarget>::AccumulateChunks(
+    Accumulate accumulate) {
+  const size_t point_num = input_->points.size();
+  const int chunk_num =
+      static_cast<int>((point_num + kChunkPointNum - 1) / kChunkPointNum);
+  chunk_derivatives_.resize(chunk_num);
+
+  std::atomic<int> next_chunk(0);
+  auto run_chunks = [&]() {
+    for (int chunk = next_chunk++; chunk < chunk_num; chunk = next_chunk++) {
+      ChunkDerivatives &sum = chunk_derivatives_[chunk];
+      sum.score = 0.0;
+      sum.gradient.setZero();
+      sum.hessian.setZero();
+      const size_t begin = static_cast<size_t>(chunk) * kChunkPointNum;
+      accumulate(begin, std::min(begin + kChunkPointNum, point_num), &sum);
+    }
+  };
+  std::vector<std::future<void>> helpers;
+  if (thread_pool_ != nullptr) {
+    for (int i = 1; i < thread_num_ && i < chunk_num; ++i) {
+      helpers.push_back(thread_pool_->Enqueue(run_chunks));
+    }
+  }
+  run_chunks();
+  for (auto &helper : helpers) {
+    if (helper.valid()) {
+      helper.wait();
+    }
+  }
+}
+
 template <typename PointSource, typename PointTarget>
 double
 NormalDistributionsTransform<PointSource, PointTarget>::ComputeDerivatives(
     Eigen::Matrix<double, 6, 1> *score_gradient,
     Eigen::Matrix<double, 6, 6> *hessian, PointCloudSourcePtr trans_cloud,
     Eigen::Matrix<double, 6, 1> *p, bool compute_hessian) {
-  // Original Point and Transformed Point
-  PointSource x_pt, x_trans_pt;
-  // Original Point and Transformed Point (for math)
-  Eigen::Vector3d x, x_trans;
-  // Occupied Voxel
-  TargetGridLeafConstPtr cell;
-  // Inverse Covariance of Occupied Voxel
-  Eigen::Matrix3d c_inv;
-
-  score_gradient->setZero();
-  hessian->setZero();
-  double score = 0;
-
   // Precompute Angular Derivatives (eq. 6.19 and 6.21)[Magnusson 2009]
   ComputeAngleDerivatives(*p);
 
   // Update gradient and hessian for each point, line 17 in Algorithm 2
   // [Magnusson 2009]
-  for (size_t idx = 0; idx < input_->points.size(); idx++) {
-    x_trans_pt = trans_cloud->points[idx];
-
-    // Find neighbors (Radius search has been experimentally faster than
-    // direct neighbor checking.
+  AccumulateChunks([&](size_t begin, size_t end, ChunkDerivatives *sum) {
+    PointDerivatives point_derivatives;
+    // Occupied voxels around the point
     std::vector<TargetGridLeafConstPtr> neighborhood;
     std::vector<float> distances;
-    target_cells_.RadiusSearch(x_trans_pt, resolution_, &neighborhood,
-                               &distances);
-
-    for (typename std::vector<TargetGridLeafConstPtr>::iterator
-             neighborhood_it = neighborhood.begin();
-         neighborhood_it != neighborhood.end(); neighborhood_it++) {
-      cell = *neighborhood_it;
-      x_pt = input_->points[idx];
-      x = Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z);
-
-      x_trans = Eigen::Vector3d(x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
-
-      // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
-      x_trans -= cell->GetMean();
-      // Uses precomputed covariance for speed.
-      c_inv = cell->GetInverseCov();
+    for (size_t idx = begin; idx < end; ++idx) {
+      const PointSource &x_trans_pt = trans_cloud->points[idx];
+      target_cells_.RadiusSearch(x_trans_pt, resolution_, &neighborhood,
+                                 &distances);
+      if (neighborhood.empty()) {
+        continue;
+      }
 
       // Compute derivative of transform function w.r.t. transform vector,
       // J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
-      ComputePointDerivatives(x);
-      // Update score, gradient and hessian, lines 19-21 in Algorithm 2,
-      // according to Equations 6.10, 6.12 and 6.13, respectively [Magnusson
-      // 2009]
-      score += UpdateDerivatives(score_gradient, hessian, x_trans, c_inv,
-                                 compute_hessian);
+      const PointSource &x_pt = input_->points[idx];
+      ComputePointDerivatives(Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z),
+                              &point_derivatives);
+      const Eigen::Vector3d x_trans_p(x_trans_pt.x, x_trans_pt.y,
+                                      x_trans_pt.z);
+      for (const TargetGridLeafConstPtr cell : neighborhood) {
+        // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
+        const Eigen::Vector3d x_trans = x_trans_p - cell->GetMean();
+        // Update score, gradient and hessian, lines 19-21 in Algorithm 2,
+        // according to Equations 6.10, 6.12 and 6.13, respectively
+        // [Magnusson 2009]
+        sum->score += UpdateDerivatives(
+            &sum->gradient, &sum->hessian, x_trans, cell->GetInverseCov(),
+            point_derivatives, compute_hessian);
+      }
     }
+  });
+
+  score_gradient->setZero();
+  hessian->setZero();
+  double score = 0;
+  for (const ChunkDerivatives &sum : chunk_derivatives_) {
+    score += sum.score;
+    *score_gradient += sum.gradient;
+    *hessian += sum.hessian;
   }
   return (score);
 }
@@ -450,20 +491,22 @@ void NormalDistributionsTransform<PointSource, PointTarget>::
 }
 
 template <typename PointSource, typename PointTarget>
-void NormalDistributionsTransform<
-    PointSource, PointTarget>::ComputePointDerivatives(const Eigen::Vector3d &x,
-                                                       bool compute_hessian) {
+void NormalDistributionsTransform<PointSource, PointTarget>::
+    ComputePointDerivatives(const Eigen::Vector3d &x,
+                            PointDerivatives *point_derivatives,
+                            bool compute_hessian) const {
   // Calculate first derivative of Transformation Equation 6.17 w.r.t. transform
   // vector p. Derivative w.r.t. ith element of transform vector corresponds to
   // column i, Equation 6.18 and 6.19 [Magnusson 2009]
-  point_gradient_(1, 3) = x.dot(j_ang_a_);
-  point_gradient_(2, 3) = x.dot(j_ang_b_);
-  point_gradient_(0, 4) = x.dot(j_ang_c_);
-  point_gradient_(1, 4) = x.dot(j_ang_d_);
-  point_gradient_(2, 4) = x.dot(j_ang_e_);
-  point_gradient_(0, 5) = x.dot(j_ang_f_);
-  point_gradient_(1, 5) = x.dot(j_ang_g_);
-  point_gradient_(2, 5) = x.dot(j_ang_h_);
+  Eigen::Matrix<double, 3, 6> &point_gradient = point_derivatives->gradient;
+  point_gradient(1, 3) = x.dot(j_ang_a_);
+  point_gradient(2, 3) = x.dot(j_ang_b_);
+  point_gradient(0, 4) = x.dot(j_ang_c_);
+  point_gradient(1, 4) = x.dot(j_ang_d_);
+  point_gradient(2, 4) = x.dot(j_ang_e_);
+  point_gradient(0, 5) = x.dot(j_ang_f_);
+  point_gradient(1, 5) = x.dot(j_ang_g_);
+  point_gradient(2, 5) = x.dot(j_ang_h_);
 
   if (compute_hessian) {
     // Vectors from Equation 6.21 [Magnusson 2009]
@@ -480,15 +523,16 @@ void NormalDistributionsTransform<
     // transform vector p. Derivative w.r.t. ith and jth elements of transform
     // vector corresponds to the 3x1 block matrix starting at (3i,j),
     // Equation 6.20 and 6.21 [Magnusson 2009]
-    point_hessian_.block<3, 1>(9, 3) = a;
-    point_hessian_.block<3, 1>(12, 3) = b;
-    point_hessian_.block<3, 1>(15, 3) = c;
-    point_hessian_.block<3, 1>(9, 4) = b;
-    point_hessian_.block<3, 1>(12, 4) = d;
-    point_hessian_.block<3, 1>(15, 4) = e;
-    point_hessian_.block<3, 1>(9, 5) = c;
-    point_hessian_.block<3, 1>(12, 5) = e;
-    point_hessian_.block<3, 1>(15, 5) = f;
+    Eigen::Matrix<double, 18, 6> &point_hessian = point_derivatives->hessian;
+    point_hessian.block<3, 1>(9, 3) = a;
+    point_hessian.block<3, 1>(12, 3) = b;
+    point_hessian.block<3, 1>(15, 3) = c;
+    point_hessian.block<3, 1>(9, 4) = b;
+    point_hessian.block<3, 1>(12, 4) = d;
+    point_hessian.block<3, 1>(15, 4) = e;
+    point_hessian.block<3, 1>(9, 5) = c;
+    point_hessian.block<3, 1>(12, 5) = e;
+    point_hessian.block<3, 1>(15, 5) = f;
   }
 }
 
@@ -497,8 +541,8 @@ double
 NormalDistributionsTransform<PointSource, PointTarget>::UpdateDerivatives(
     Eigen::Matrix<double, 6, 1> *score_gradient,
     Eigen::Matrix<double, 6, 6> *hessian, const Eigen::Vector3d &x_trans,
-    const Eigen::Matrix3d &c_inv, bool compute_hessian) {
-  Eigen::Vector3d cov_dxd_pi;
+    const Eigen::Matrix3d &c_inv, const PointDerivatives &point_derivatives,
+    bool compute_hessian) const {
   // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson
   // 2009]
   double e_x_cov_x = exp(-gauss_d2_ * x_trans.dot(c_inv * x_trans) / 2);
@@ -516,92 +560,98 @@ NormalDistributionsTransform<PointSource, PointTarget>::UpdateDerivatives(
   // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
   e_x_cov_x *= gauss_d1_;
 
-  for (int i = 0; i < 6; i++) {
-    // Sigma_k^-1 d(T(x,p))/dpi, Reusable portion of Equation 6.12 and 6.13
-    // [Magnusson 2009]
-    cov_dxd_pi = c_inv * point_gradient_.col(i);
-
-    // Update gradient, Equation 6.12 [Magnusson 2009]
-    (*score_gradient)(i) += x_trans.dot(cov_dxd_pi) * e_x_cov_x;
-
-    if (compute_hessian) {
-      for (int j = 0; j < hessian->cols(); j++) {
-        // Update hessian, Equation 6.13 [Magnusson 2009]
-        (*hessian)(i, j) +=
-            e_x_cov_x *
-            (-gauss_d2_ * x_trans.dot(cov_dxd_pi) *
-                 x_trans.dot(c_inv * point_gradient_.col(j)) +
-             x_trans.dot(c_inv * point_hessian_.block<3, 1>(3 * i, j)) +
-             point_gradient_.col(j).dot(cov_dxd_pi));
-      }
-    }
+  // Sigma_k^-1 d(T(x,p))/dpi of all i, Reusable portion of Equation 6.12 and
+  // 6.13 [Magnusson 2009]
+  const Eigen::Matrix<double, 3, 6> cov_dxd_p =
+      c_inv * point_derivatives.gradient;
+  const Eigen::Matrix<double, 6, 1> x_cov_dxd_p =
+      cov_dxd_p.transpose() * x_trans;
+
+  // Update gradient, Equation 6.12 [Magnusson 2009]
+  *score_gradient += x_cov_dxd_p * e_x_cov_x;
+
+  if (compute_hessian) {
+    AddHessianIncrement(e_x_cov_x, x_trans, c_inv, cov_dxd_p, x_cov_dxd_p,
+                        point_derivatives, hessian);
   }
 
   return score_inc;
 }
 
+template <typename PointSource, typename PointTarget>
+void NormalDistributionsTransform<PointSource, PointTarget>::
+    AddHessianIncrement(double e_x_cov_x, const Eigen::Vector3d &x_trans,
+                        const Eigen::Matrix3d &c_inv,
+                        const Eigen::Matrix<double, 3, 6> &cov_dxd_p,
+                        const Eigen::Matrix<double, 6, 1> &x_cov_dxd_p,
+                        const PointDerivatives &point_derivatives,
+                        Eigen::Matrix<double, 6, 6> *hessian) const {
+  // Element (i, j) is, Equation 6.13 [Magnusson 2009],
+  //   -d_2 * x'^T Sigma_k^-1 dT/dpi * x'^T Sigma_k^-1 dT/dpj
+  //   + x'^T Sigma_k^-1 d2T/dpidpj + dT/dpj^T Sigma_k^-1 dT/dpi
+  Eigen::Matrix<double, 6, 6> hessian_inc =
+      (point_derivatives.gradient.transpose() * cov_dxd_p).transpose();
+  hessian_inc.noalias() -= gauss_d2_ * x_cov_dxd_p * x_cov_dxd_p.transpose();
+  // only rows 9 to 17 of the point hessian are not zero
+  const Eigen::Matrix<double, 1, 3> x_cov = (c_inv.transpose() * x_trans)
+                                                .transpose();
+  for (int i = 3; i < 6; ++i) {
+    hessian_inc.row(i).noalias() +=
+        x_cov * point_derivatives.hessian.template block<3, 6>(3 * i, 0);
+  }
+  *hessian += e_x_cov_x * hessian_inc;
+}
+
 template <typename PointSource, typename PointTarget>
 void NormalDistributionsTransform<PointSource, PointTarget>::ComputeHessian(
     Eigen::Matrix<double, 6, 6> *hessian, const PointCloudSource &trans_cloud,
     Eigen::Matrix<double, 6, 1> *p) {
-  // Original Point and Transformed Point
-  PointSource x_pt, x_trans_pt;
-  // Original Point and Transformed Point (for math)
-  Eigen::Vector3d x, x_trans;
-  // Occupied Voxel
-  TargetGridLeafConstPtr cell;
-  // Inverse Covariance of Occupied Voxel
-  Eigen::Matrix3d c_inv;
-
-  hessian->setZero();
-
   // Precompute Angular Derivatives unnecessary because only used after regular
   // derivative calculation
 
   // Update hessian for each point, line 17 in Algorithm 2 [Magnusson 2009]
-  for (size_t idx = 0; idx < input_->points.size(); idx++) {
-    x_trans_pt = trans_cloud.points[idx];
-
-    // Find neighbors (Radius search has been experimentally faster than
-    // direct neighbor checking.
+  AccumulateChunks([&](size_t begin, size_t end, ChunkDerivatives *sum) {
+    PointDerivatives point_derivatives;
+    // Occupied voxels around the point
     std::vector<TargetGridLeafConstPtr> neighborhood;
     std::vector<float> distances;
-    target_cells_.RadiusSearch(x_trans_pt, resolution_, &neighborhood,
-                               &distances);
-
-    for (typename std::vector<TargetGridLeafConstPtr>::iterator
-             neighborhood_it = neighborhood.begin();
-         neighborhood_it != neighborhood.end(); neighborhood_it++) {
-      cell = *neighborhood_it;
-      {
-        x_pt = input_->points[idx];
-        x = Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z);
-
-        x_trans = Eigen::Vector3d(x_trans_pt.x, x_trans_pt.y, x_trans_pt.z);
-
-        // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson
-        // 2009]
-        x_trans -= cell->GetMean();
-        // Uses precomputed covariance for speed.
-        c_inv = cell->GetInverseCov();
-
-        // Compute derivative of transform function w.r.t. transform
-        // vector, J_E and H_E in Equations 6.18 and 6.20 [Magnusson
-        // 2009]
-        ComputePointDerivatives(x);
+    for (size_t idx = begin; idx < end; ++idx) {
+      const PointSource &x_trans_pt = trans_cloud.points[idx];
+      target_cells_.RadiusSearch(x_trans_pt, resolution_, &neighborhood,
+                                 &distances);
+      if (neighborhood.empty()) {
+        continue;
+      }
+
+      // Compute derivative of transform function w.r.t. transform vector,
+      // J_E and H_E in Equations 6.18 and 6.20 [Magnusson 2009]
+      const PointSource &x_pt = input_->points[idx];
+      ComputePointDerivatives(Eigen::Vector3d(x_pt.x, x_pt.y, x_pt.z),
+                              &point_derivatives);
+      const Eigen::Vector3d x_trans_p(x_trans_pt.x, x_trans_pt.y,
+                                      x_trans_pt.z);
+      for (const TargetGridLeafConstPtr cell : neighborhood) {
+        // Denorm point, x_k' in Equations 6.12 and 6.13 [Magnusson 2009]
+        const Eigen::Vector3d x_trans = x_trans_p - cell->GetMean();
         // Update hessian, lines 21 in Algorithm 2, according to
         // Equations 6.10, 6.12 and 6.13, respectively [Magnusson 2009]
-        UpdateHessian(hessian, x_trans, c_inv);
+        UpdateHessian(&sum->hessian, x_trans, cell->GetInverseCov(),
+                      point_derivatives);
       }
     }
+  });
+
+  hessian->setZero();
+  for (const ChunkDerivatives &sum : chunk_derivatives_) {
+    *hessian += sum.hessian;
   }
 }
 
 template <typename PointSource, typename PointTarget>
 void NormalDistributionsTransform<PointSource, PointTarget>::UpdateHessian(
     Eigen::Matrix<double, 6, 6> *hessian, const Eigen::Vector3d &x_trans,
-    const Eigen::Matrix3d &c_inv) {
-  Eigen::Vector3d cov_dxd_pi;
+    const Eigen::Matrix3d &c_inv,
+    const PointDerivatives &point_derivatives) const {
   // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9
   // [Magnusson 2009]
   double e_x_cov_x =
@@ -615,21 +665,14 @@ void NormalDistributionsTransform<PointSource, PointTarget>::UpdateHessian(
   // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
   e_x_cov_x *= gauss_d1_;
 
-  for (int i = 0; i < 6; i++) {
-    // Sigma_k^-1 d(T(x,p))/dpi, Reusable portion of Equation 6.12 and 6.13
-    // [Magnusson 2009]
-    cov_dxd_pi = c_inv * point_gradient_.col(i);
-
-    for (int j = 0; j < hessian->cols(); j++) {
-      // Update hessian, Equation 6.13 [Magnusson 2009]
-      (*hessian)(i, j) +=
-          e_x_cov_x *
-          (-gauss_d2_ * x_trans.dot(cov_dxd_pi) *
-               x_trans.dot(c_inv * point_gradient_.col(j)) +
-           x_trans.dot(c_inv * point_hessian_.block<3, 1>(3 * i, j)) +
-           point_gradient_.col(j).dot(cov_dxd_pi));
-    }
-  }
+  // Sigma_k^-1 d(T(x,p))/dpi of all i, Reusable portion of Equation 6.12 and
+  // 6.13 [Magnusson 2009]
+  const Eigen::Matrix<double, 3, 6> cov_dxd_p =
+      c_inv * point_derivatives.gradient;
+  const Eigen::Matrix<double, 6, 1> x_cov_dxd_p =
+      cov_dxd_p.transpose() * x_trans;
+  AddHessianIncrement(e_x_cov_x, x_trans, c_inv, cov_dxd_p, x_cov_dxd_p,
+                      point_derivatives, hessian);
 }
 
 template <typename PointSource, typename PointTarget>
@@ -0,0 +1,227 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Latency of one NDT scan match against the map of the ndt test data, the
+// way LidarLocatorNdt::Update runs it: the map cells are set as target and
+// the filtered scan is aligned from a pose 0.5 m and 0.3 m off. Range 0 is
+// the number of threads computing the derivatives, range 1 the leaf size of
+// the scan filter in cm, 50 cm keeps about four times the points of the
+// default 1 m and stands for a denser lidar. A frame should stay under 10 ms.
+// Run from the repo root:
+//   ndt_solver_benchmark
+// iterations is the number of newton steps of the last run, probability its
+// transformation probability; they are the same for every thread number.
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "boost/filesystem.hpp"
+#include "gflags/gflags.h"
+#include "pcl/filters/voxel_grid.h"
+#include "pcl/io/pcd_io.h"
+#include "pcl/point_types.h"
+
+#include "modules/localization/msf/local_pyramid_map/base_map/base_map_node_index.h"
+#include "modules/localization/msf/local_pyramid_map/ndt_map/ndt_map.h"
+#include "modules/localization/msf/local_pyramid_map/ndt_map/ndt_map_config.h"
+#include "modules/localization/msf/local_pyramid_map/ndt_map/ndt_map_matrix.h"
+#include "modules/localization/msf/local_pyramid_map/ndt_map/ndt_map_node.h"
+#include "modules/localization/msf/local_pyramid_map/ndt_map/ndt_map_pool.h"
+#include "modules/localization/ndt/ndt_locator/ndt_solver.h"
+
+DEFINE_string(ndt_benchmark_pcd,
+              "modules/localization/ndt/test_data/pcds/1.pcd",
+              "scan aligned by the benchmark");
+DEFINE_string(ndt_benchmark_map_dir,
+              "modules/localization/ndt/test_data/ndt_map",
+              "ndt map the scan is aligned to");
+
+namespace apollo {
+namespace localization {
+namespace ndt {
+namespace {
+
+typedef msf::pyramid_map::MapNodeIndex MapNodeIndex;
+typedef pcl::PointCloud<pcl::PointXYZ> PointCloud;
+
+struct Target {
+  std::vector<Leaf> cell_map;
+  PointCloud::Ptr cell_pointcloud{new PointCloud()};
+  Eigen::Vector3d left_top_corner = Eigen::Vector3d::Zero();
+  float resolution = 1.0f;
+};
+
+std::list<MapNodeIndex> GetAllMapIndex(const std::string& map_folder) {
+  std::list<MapNodeIndex> indices;
+  const std::string map_path = map_folder + "/map";
+  boost::filesystem::recursive_directory_iterator end_iter;
+  boost::filesystem::recursive_directory_iterator iter(map_path);
+  for (; iter != end_iter; ++iter) {
+    if (boost::filesystem::is_directory(*iter) ||
+        iter->path().extension() != "") {
+      continue;
+    }
+    const std::string node_path =
+        iter->path().string().substr(map_path.length());
+    MapNodeIndex index;
+    char zone[100];
+    sscanf(node_path.c_str(), "/%03u/%05s/%02d/%08u/%08u",
+           &index.resolution_id_, zone, &index.zone_id_, &index.m_,
+           &index.n_);
+    if (std::string(zone) == "south") {
+      index.zone_id_ = -index.zone_id_;
+    }
+    indices.push_back(index);
+  }
+  return indices;
+}
+
+// the cells of the map as LidarLocatorNdt::Update collects them
+const Target& SharedTarget() {
+  static const Target* target = [] {
+    auto* map_target = new Target();
+    msf::pyramid_map::NdtMapConfig ndt_map_config("map_ndt_v01");
+    msf::pyramid_map::NdtMap ndt_map(&ndt_map_config);
+    ndt_map.SetMapFolderPath(FLAGS_ndt_benchmark_map_dir);
+    msf::pyramid_map::NdtMapNodePool ndt_map_node_pool(20, 4);
+    ndt_map_node_pool.Initial(&ndt_map_config);
+    ndt_map.InitMapNodeCaches(10, 4);
+    ndt_map.AttachMapNodePool(&ndt_map_node_pool);
+    map_target->resolution = ndt_map_config.map_resolutions_[0];
+
+    bool first_node = true;
+    for (const MapNodeIndex& index :
+         GetAllMapIndex(FLAGS_ndt_benchmark_map_dir)) {
+      auto* ndt_map_node = static_cast<msf::pyramid_map::NdtMapNode*>(
+          ndt_map.GetMapNodeSafe(index));
+      if (ndt_map_node == nullptr) {
+        continue;
+      }
+      const auto& ndt_map_matrix =
+          static_cast<const msf::pyramid_map::NdtMapMatrix&>(
+              ndt_map_node->GetMapCellMatrix());
+      const Eigen::Vector2d& left_top_corner =
+          ndt_map_node->GetLeftTopCorner();
+      const double resolution = ndt_map_node->GetMapResolution();
+      const double resolution_z = ndt_map_node->GetMapResolutionZ();
+      if (first_node || (left_top_corner(0) < map_target->left_top_corner(0) &&
+                         left_top_corner(1) < map_target->left_top_corner(1))) {
+        map_target->left_top_corner.head<2>() = left_top_corner;
+        first_node = false;
+      }
+      for (unsigned int row = 0; row < ndt_map_config.map_node_size_y_;
+           ++row) {
+        for (unsigned int col = 0; col < ndt_map_config.map_node_size_x_;
+             ++col) {
+          const auto& cell_ndt = ndt_map_matrix.GetMapCell(row, col);
+          for (const auto& cell : cell_ndt.cells_) {
+            if (cell.second.count_ < 6 || !cell.second.is_icov_available_) {
+              continue;
+            }
+            Leaf leaf;
+            leaf.nr_points_ = static_cast<int>(cell.second.count_);
+            leaf.mean_ = Eigen::Vector3d(
+                left_top_corner(0) + col * resolution +
+                    cell.second.centroid_[0],
+                left_top_corner(1) + row * resolution +
+                    cell.second.centroid_[1],
+                resolution_z * cell.first + cell.second.centroid_[2]);
+            leaf.icov_ = cell.second.centroid_icov_.cast<double>();
+            map_target->cell_map.push_back(leaf);
+            map_target->cell_pointcloud->push_back(
+                pcl::PointXYZ(static_cast<float>(leaf.mean_(0)),
+                              static_cast<float>(leaf.mean_(1)),
+                              static_cast<float>(leaf.mean_(2))));
+          }
+        }
+      }
+    }
+    return map_target;
+  }();
+  return *target;
+}
+
+PointCloud::Ptr LoadSource(float leaf_size) {
+  PointCloud::Ptr cloud(new PointCloud());
+  if (pcl::io::loadPCDFile(FLAGS_ndt_benchmark_pcd, *cloud) < 0) {
+    return cloud;
+  }
+  pcl::VoxelGrid<pcl::PointXYZ> sor;
+  sor.setInputCloud(cloud);
+  sor.setLeafSize(leaf_size, leaf_size, leaf_size);
+  sor.filter(*cloud);
+  return cloud;
+}
+
+void BM_NdtAlign(benchmark::State& state) {
+  const Target& target = SharedTarget();
+  const PointCloud::Ptr source =
+      LoadSource(static_cast<float>(state.range(1)) / 100.0f);
+  if (target.cell_map.empty() || source->empty()) {
+    state.SkipWithError("ndt test data not found, run from the repo root");
+    return;
+  }
+
+  NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> reg;
+  reg.SetMaximumIterations(10);
+  reg.SetStepSize(0.1);
+  reg.SetTransformationEpsilon(0.01);
+  reg.SetThreadNum(static_cast<int>(state.range(0)));
+  reg.SetLeftTopCorner(target.left_top_corner);
+  reg.SetResolution(target.resolution);
+
+  Eigen::Matrix4d guess(Eigen::Matrix4d::Identity());
+  guess.block<3, 3>(0, 0) =
+      Eigen::Quaterniond(0.857989, 0.009698, -0.008629, -0.513505)
+          .toRotationMatrix();
+  guess.block<3, 1>(0, 3) =
+      Eigen::Vector3d(588348.947978 + 0.5, 4141240.223859 - 0.5,
+                      -30.094324 + 0.3);
+  PointCloud::Ptr output_cloud(new PointCloud());
+  for (auto _ : state) {
+    reg.SetInputTarget(target.cell_map, target.cell_pointcloud);
+    reg.SetInputSource(source);
+    reg.Align(output_cloud, guess.cast<float>());
+  }
+  state.counters["iterations"] = reg.GetFinalNumIteration();
+  state.counters["probability"] = reg.GetTransformationProbability();
+  state.counters["source_points"] = static_cast<double>(source->size());
+}
+BENCHMARK(BM_NdtAlign)
+    ->ArgNames({"threads", "leaf_cm"})
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      for (int leaf_cm : {100, 50}) {
+        for (int thread_num : {1, 2, 4, 8}) {
+          benchmark->Args({thread_num, leaf_cm});
+        }
+      }
+    })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace ndt
+}  // namespace localization
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
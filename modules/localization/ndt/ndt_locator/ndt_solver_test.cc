@@ -70,32 +70,11 @@ bool GetAllMapIndex(const std::string& src_map_folder,
   return true;
 }
 
-class NdtSolverTestSuite : public ::testing::Test {
- protected:
-  NdtSolverTestSuite() {}
-  virtual ~NdtSolverTestSuite() {}
-  virtual void SetUp() {}
-  virtual void TearDown() {}
-};
-
-TEST_F(NdtSolverTestSuite, NdtSolver) {
-  // Set NDT
-  NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> reg;
-  reg.SetMaximumIterations(5);
-  reg.SetStepSize(0.1);
-  reg.SetTransformationEpsilon(0.01);
-
-  // Load input source.
-  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_source(
-      new pcl::PointCloud<pcl::PointXYZ>());
-  const std::string input_source_file =
-      "/apollo/modules/localization/ndt/test_data/pcds/1.pcd";
-  int ret = pcl::io::loadPCDFile(input_source_file, *cloud_source);
-  EXPECT_LE(ret, 0);
-
-  // Load input target.
-  const std::string map_folder =
-      "/apollo/modules/localization/ndt/test_data/ndt_map";
+// Loads the cells of the ndt map as leaves and their centroids, returns the
+// map resolution.
+float LoadTarget(const std::string& map_folder, std::vector<Leaf>* cell_map,
+                 pcl::PointCloud<pcl::PointXYZ>::Ptr cell_pointcloud,
+                 Eigen::Vector2d* map_left_top_corner) {
   std::list<MapNodeIndex> buf;
   GetAllMapIndex(map_folder, &buf);
   std::cout << "index size: " << buf.size() << std::endl;
@@ -110,11 +89,6 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
   ndt_map.AttachMapNodePool(&ndt_map_node_pool);
 
   // Get the map pointcloud.
-  pcl::PointCloud<pcl::PointXYZ>::Ptr cell_pointcloud(
-      new pcl::PointCloud<pcl::PointXYZ>());
-  std::vector<Leaf> cell_map;
-  Eigen::Vector2d map_left_top_corner(Eigen::Vector2d::Zero());
-
   int index = 0;
   for (auto itr = buf.begin(); itr != buf.end(); ++itr, ++index) {
     NdtMapNode* ndt_map_node =
@@ -130,11 +104,11 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
     double resolution_z = ndt_map_node->GetMapResolutionZ();
 
     if (index == 0) {
-      map_left_top_corner = left_top_corner;
+      *map_left_top_corner = left_top_corner;
     }
-    if (left_top_corner(0) < map_left_top_corner(0) &&
-        left_top_corner(1) < map_left_top_corner(1)) {
-      map_left_top_corner = left_top_corner;
+    if (left_top_corner(0) < (*map_left_top_corner)(0) &&
+        left_top_corner(1) < (*map_left_top_corner)(1)) {
+      *map_left_top_corner = left_top_corner;
     }
 
     int rows = ndt_map_config.map_node_size_y_;
@@ -165,7 +139,7 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
             } else {
               leaf.nr_points_ = -1;
             }
-            cell_map.push_back(leaf);
+            cell_map->push_back(leaf);
             cell_pointcloud->push_back(pcl::PointXYZ(
                 static_cast<float>(point(0)), static_cast<float>(point(1)),
                 static_cast<float>(point(2))));
@@ -174,6 +148,40 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
       }
     }
   }
+  return ndt_map_config.map_resolutions_[0];
+}
+
+class NdtSolverTestSuite : public ::testing::Test {
+ protected:
+  NdtSolverTestSuite() {}
+  virtual ~NdtSolverTestSuite() {}
+  virtual void SetUp() {}
+  virtual void TearDown() {}
+};
+
+TEST_F(NdtSolverTestSuite, NdtSolver) {
+  // Set NDT
+  NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> reg;
+  reg.SetMaximumIterations(5);
+  reg.SetStepSize(0.1);
+  reg.SetTransformationEpsilon(0.01);
+
+  // Load input source.
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_source(
+      new pcl::PointCloud<pcl::PointXYZ>());
+  const std::string input_source_file =
+      "/apollo/modules/localization/ndt/test_data/pcds/1.pcd";
+  int ret = pcl::io::loadPCDFile(input_source_file, *cloud_source);
+  EXPECT_LE(ret, 0);
+
+  // Load input target.
+  std::vector<Leaf> cell_map;
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cell_pointcloud(
+      new pcl::PointCloud<pcl::PointXYZ>());
+  Eigen::Vector2d map_left_top_corner(Eigen::Vector2d::Zero());
+  const float resolution =
+      LoadTarget("/apollo/modules/localization/ndt/test_data/ndt_map",
+                 &cell_map, cell_pointcloud, &map_left_top_corner);
 
   // Set left top corner.
   Eigen::Vector3d target_left_top_corner(Eigen::Vector3d::Zero());
@@ -181,7 +189,7 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
   reg.SetLeftTopCorner(target_left_top_corner);
 
   // Set input target.
-  reg.SetResolution(ndt_map_config.map_resolutions_[0]);
+  reg.SetResolution(resolution);
   reg.SetInputTarget(cell_map, cell_pointcloud);
 
   // Set input source.
@@ -217,6 +225,65 @@ TEST_F(NdtSolverTestSuite, NdtSolver) {
   ASSERT_LE(iteration, 7);
 }
 
+TEST_F(NdtSolverTestSuite, ThreadNumDoesNotChangeResult) {
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud_source(
+      new pcl::PointCloud<pcl::PointXYZ>());
+  int ret = pcl::io::loadPCDFile(
+      "/apollo/modules/localization/ndt/test_data/pcds/1.pcd", *cloud_source);
+  EXPECT_LE(ret, 0);
+  pcl::VoxelGrid<pcl::PointXYZ> sor;
+  sor.setInputCloud(cloud_source);
+  sor.setLeafSize(1.0, 1.0, 1.0);
+  sor.filter(*cloud_source);
+
+  std::vector<Leaf> cell_map;
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cell_pointcloud(
+      new pcl::PointCloud<pcl::PointXYZ>());
+  Eigen::Vector2d map_left_top_corner(Eigen::Vector2d::Zero());
+  const float resolution =
+      LoadTarget("/apollo/modules/localization/ndt/test_data/ndt_map",
+                 &cell_map, cell_pointcloud, &map_left_top_corner);
+  Eigen::Vector3d target_left_top_corner(Eigen::Vector3d::Zero());
+  target_left_top_corner.block<2, 1>(0, 0) = map_left_top_corner;
+
+  Eigen::Matrix4d transform(Eigen::Matrix4d::Identity());
+  transform.block<3, 3>(0, 0) =
+      Eigen::Quaterniond(0.857989, 0.009698, -0.008629, -0.513505)
+          .toRotationMatrix();
+  transform.block<3, 1>(0, 3) =
+      Eigen::Vector3d(588348.947978 + 0.5, 4141240.223859 - 0.5,
+                      -30.094324 + 0.3);
+
+  // The derivatives are summed in chunks of points independent of the
+  // threads, every thread number takes the same steps.
+  Eigen::Matrix4f expected_pose(Eigen::Matrix4f::Identity());
+  double expected_score = 0.0;
+  for (int thread_num : {1, 4}) {
+    NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> reg;
+    reg.SetMaximumIterations(5);
+    reg.SetStepSize(0.1);
+    reg.SetTransformationEpsilon(0.01);
+    reg.SetThreadNum(thread_num);
+    EXPECT_EQ(reg.GetThreadNum(), thread_num);
+    reg.SetLeftTopCorner(target_left_top_corner);
+    reg.SetResolution(resolution);
+    reg.SetInputTarget(cell_map, cell_pointcloud);
+    reg.SetInputSource(cloud_source);
+
+    pcl::PointCloud<pcl::PointXYZ>::Ptr output_cloud(
+        new pcl::PointCloud<pcl::PointXYZ>);
+    reg.Align(output_cloud, transform.cast<float>());
+    ASSERT_TRUE(reg.HasConverged());
+    if (thread_num == 1) {
+      expected_pose = reg.GetFinalTransformation();
+      expected_score = reg.GetFitnessScore();
+    } else {
+      EXPECT_EQ(reg.GetFinalTransformation(), expected_pose);
+      EXPECT_EQ(reg.GetFitnessScore(), expected_score);
+    }
+  }
+}
+
 }  // namespace ndt
 }  // namespace localization
 }  // namespace apollo
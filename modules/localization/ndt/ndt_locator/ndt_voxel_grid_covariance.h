@@ -57,7 +57,6 @@
 
 #include "pcl/filters/boost.h"
 #include "pcl/filters/voxel_grid.h"
-#include "pcl/kdtree/kdtree_flann.h"
 #include "pcl/point_types.h"
 
 #include "cyber/common/log.h"
@@ -125,8 +124,7 @@ class VoxelGridCovariance {
       : min_points_per_voxel_(6),
         leaves_(),
         voxel_centroids_(),
-        voxel_centroids_leaf_indices_(),
-        kdtree_() {
+        voxel_centroids_leaf_indices_() {
     leaf_size_.setZero();
     min_b_.setZero();
     max_b_.setZero();
@@ -155,9 +153,8 @@ class VoxelGridCovariance {
                      bool searchable = true) {
     voxel_centroids_ = PointCloudPtr(new PointCloud);
     SetMap(cell_leaf, voxel_centroids_);
-    if (voxel_centroids_->size() > 0) {
-      kdtree_.setInputCloud(voxel_centroids_);
-    }
+    BuildSearchGrid(voxel_centroids_->size() > 0 ? cell_leaf
+                                                 : std::vector<Leaf>());
   }
 
   void SetMap(const std::vector<Leaf> &map_leaves, PointCloudPtr output);
@@ -235,11 +232,12 @@ class VoxelGridCovariance {
   inline PointCloudPtr GetCentroids() { return voxel_centroids_; }
 
   /**@brief Search for all the nearest occupied voxels of the query point in a
-   * given radius. */
+   * given radius. The output vectors are cleared first, reusing them between
+   * searches saves their allocations. */
   int RadiusSearch(const PointT &point, double radius,
                    std::vector<LeafConstPtr> *k_leaves,
                    std::vector<float> *k_sqr_distances,
-                   unsigned int max_nn = 0);
+                   unsigned int max_nn = 0) const;
 
   void GetDisplayCloud(pcl::PointCloud<pcl::PointXYZ> *cell_cloud);
 
@@ -259,6 +257,9 @@ class VoxelGridCovariance {
   }
 
  protected:
+  /**@brief Sort the occupied voxels into the columns of the search grid. */
+  void BuildSearchGrid(const std::vector<Leaf> &map_leaves);
+
   /**@brief Minimum points contained with in a voxel to allow it to be usable.
    */
   int min_points_per_voxel_;
@@ -274,8 +275,18 @@ class VoxelGridCovariance {
   /**@brief Indices of leaf structurs associated with each point. */
   std::vector<int> voxel_centroids_leaf_indices_;
 
-  /**@brief KdTree generated using voxel_centroids_ (used for searching). */
-  pcl::KdTreeFLANN<PointT> kdtree_;
+  /**@brief Dense grid of xy columns over the occupied voxels used for the
+   * radius search, column i holds the voxels [grid_offsets_[i],
+   * grid_offsets_[i + 1]) of grid_leaves_ and their centroids in
+   * grid_centroids_ (x, y, z interleaved). */
+  std::vector<Leaf> grid_leaves_;
+  std::vector<float> grid_centroids_;
+  std::vector<int> grid_offsets_;
+  double grid_origin_x_ = 0.0;
+  double grid_origin_y_ = 0.0;
+  double grid_column_size_ = 1.0;
+  int grid_size_x_ = 0;
+  int grid_size_y_ = 0;
 
   /**@brief Left top corner. */
   Eigen::Vector3d map_left_top_corner_;
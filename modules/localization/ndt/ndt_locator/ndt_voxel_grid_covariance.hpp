@@ -50,6 +50,9 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -139,24 +142,141 @@ void VoxelGridCovariance<PointT>::SetMap(const std::vector<Leaf>& map_leaves,
   output->width = static_cast<uint32_t>(output->points.size());
 }
 
+template <typename PointT>
+void VoxelGridCovariance<PointT>::BuildSearchGrid(
+    const std::vector<Leaf>& map_leaves) {
+  // Columns are a voxel wide unless the voxels spread over more columns.
+  constexpr int64_t kMaxGridColumns = 4 * 1024 * 1024;
+
+  grid_leaves_.clear();
+  grid_centroids_.clear();
+  grid_offsets_.assign(1, 0);
+  grid_size_x_ = 0;
+  grid_size_y_ = 0;
+
+  // Only voxels with enough points are searched, they are the centroids of
+  // voxel_centroids_.
+  std::vector<int> occupied;
+  occupied.reserve(map_leaves.size());
+  float min_x = std::numeric_limits<float>::max();
+  float min_y = std::numeric_limits<float>::max();
+  float max_x = std::numeric_limits<float>::lowest();
+  float max_y = std::numeric_limits<float>::lowest();
+  for (size_t i = 0; i < map_leaves.size(); ++i) {
+    if (map_leaves[i].nr_points_ < min_points_per_voxel_) {
+      continue;
+    }
+    const float x = static_cast<float>(map_leaves[i].mean_[0]);
+    const float y = static_cast<float>(map_leaves[i].mean_[1]);
+    min_x = std::min(min_x, x);
+    min_y = std::min(min_y, y);
+    max_x = std::max(max_x, x);
+    max_y = std::max(max_y, y);
+    occupied.push_back(static_cast<int>(i));
+  }
+  if (occupied.empty()) {
+    return;
+  }
+
+  grid_origin_x_ = min_x;
+  grid_origin_y_ = min_y;
+  grid_column_size_ = leaf_size_[0] > 0.0f ? leaf_size_[0] : 1.0;
+  while (true) {
+    grid_size_x_ =
+        static_cast<int>((max_x - grid_origin_x_) / grid_column_size_) + 1;
+    grid_size_y_ =
+        static_cast<int>((max_y - grid_origin_y_) / grid_column_size_) + 1;
+    if (static_cast<int64_t>(grid_size_x_) * grid_size_y_ <=
+        kMaxGridColumns) {
+      break;
+    }
+    grid_column_size_ *= 2.0;
+  }
+
+  // Counting sort of the voxels by column, voxels of a column keep their
+  // order.
+  std::vector<int> columns(occupied.size());
+  grid_offsets_.assign(grid_size_x_ * grid_size_y_ + 1, 0);
+  for (size_t k = 0; k < occupied.size(); ++k) {
+    const Leaf& leaf = map_leaves[occupied[k]];
+    const int column_x = std::min(
+        static_cast<int>(
+            (static_cast<float>(leaf.mean_[0]) - grid_origin_x_) /
+            grid_column_size_),
+        grid_size_x_ - 1);
+    const int column_y = std::min(
+        static_cast<int>(
+            (static_cast<float>(leaf.mean_[1]) - grid_origin_y_) /
+            grid_column_size_),
+        grid_size_y_ - 1);
+    columns[k] = column_y * grid_size_x_ + column_x;
+    ++grid_offsets_[columns[k] + 1];
+  }
+  for (size_t i = 1; i < grid_offsets_.size(); ++i) {
+    grid_offsets_[i] += grid_offsets_[i - 1];
+  }
+  std::vector<int> next_slot(grid_offsets_.begin(), grid_offsets_.end() - 1);
+  grid_leaves_.resize(occupied.size());
+  grid_centroids_.resize(occupied.size() * 3);
+  for (size_t k = 0; k < occupied.size(); ++k) {
+    const int slot = next_slot[columns[k]]++;
+    const Leaf& leaf = map_leaves[occupied[k]];
+    grid_leaves_[slot] = leaf;
+    grid_centroids_[3 * slot] = static_cast<float>(leaf.mean_[0]);
+    grid_centroids_[3 * slot + 1] = static_cast<float>(leaf.mean_[1]);
+    grid_centroids_[3 * slot + 2] = static_cast<float>(leaf.mean_[2]);
+  }
+}
+
 template <typename PointT>
 int VoxelGridCovariance<PointT>::RadiusSearch(
     const PointT& point, double radius, std::vector<LeafConstPtr>* k_leaves,
-    std::vector<float>* k_sqr_distances, unsigned int max_nn) {
+    std::vector<float>* k_sqr_distances, unsigned int max_nn) const {
   k_leaves->clear();
+  k_sqr_distances->clear();
+  if (grid_leaves_.empty()) {
+    return 0;
+  }
 
-  // Find neighbors within radius in the occupied voxel centroid cloud
-  std::vector<int> k_indices;
-  int k =
-      kdtree_.radiusSearch(point, radius, k_indices, *k_sqr_distances, max_nn);
+  // A voxel within the radius is at most range columns away.
+  const int range = static_cast<int>(std::ceil(radius / grid_column_size_));
+  const double column_x =
+      std::floor((point.x - grid_origin_x_) / grid_column_size_);
+  const double column_y =
+      std::floor((point.y - grid_origin_y_) / grid_column_size_);
+  if (column_x + range < 0.0 || column_x - range >= grid_size_x_ ||
+      column_y + range < 0.0 || column_y - range >= grid_size_y_) {
+    return 0;
+  }
+  const int x_begin = std::max(static_cast<int>(column_x) - range, 0);
+  const int x_end = std::min(static_cast<int>(column_x) + range + 1,
+                             grid_size_x_);
+  const int y_begin = std::max(static_cast<int>(column_y) - range, 0);
+  const int y_end = std::min(static_cast<int>(column_y) + range + 1,
+                             grid_size_y_);
 
-  // Find leaves corresponding to neighbors
-  k_leaves->reserve(k);
-  for (std::vector<int>::iterator iter = k_indices.begin();
-       iter != k_indices.end(); iter++) {
-    k_leaves->push_back(&leaves_[voxel_centroids_leaf_indices_[*iter]]);
+  const float sqr_radius = static_cast<float>(radius * radius);
+  for (int y = y_begin; y < y_end; ++y) {
+    // the columns of a grid row are stored one after the other
+    const int row = y * grid_size_x_;
+    const int end = grid_offsets_[row + x_end];
+    for (int i = grid_offsets_[row + x_begin]; i < end; ++i) {
+      const float* centroid = &grid_centroids_[3 * i];
+      const float dx = point.x - centroid[0];
+      const float dy = point.y - centroid[1];
+      const float dz = point.z - centroid[2];
+      const float sqr_distance = dx * dx + dy * dy + dz * dz;
+      if (sqr_distance > sqr_radius) {
+        continue;
+      }
+      k_leaves->push_back(&grid_leaves_[i]);
+      k_sqr_distances->push_back(sqr_distance);
+      if (max_nn > 0 && k_leaves->size() == max_nn) {
+        return static_cast<int>(max_nn);
+      }
+    }
   }
-  return k;
+  return static_cast<int>(k_leaves->size());
 }
 
 template <typename PointT>
@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "modules/map/hdmap/hdmap_impl.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <limits>
 #include <mutex>
@@ -23,6 +28,7 @@ limitations under the License.
 
 #include "absl/strings/match.h"
 #include "cyber/common/file.h"
+#include "modules/common/configs/config_gflags.h"
 #include "modules/common/util/util.h"
 #include "modules/map/hdmap/adapter/opendrive_adapter.h"
 
@@ -40,6 +46,37 @@ Id CreateHDMapId(const std::string& string_id) {
   return id;
 }
 
+// Parses a binary map straight from a read-only mapping of the file. Every
+// process loading the same map shares its pages through the page cache, and
+// there is no intermediate copy to free afterwards.
+bool LoadBinaryMap(const std::string& map_filename, Map* map) {
+  const int fd = open(map_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    AERROR << "Failed to open map file " << map_filename;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0 ||
+      file_stat.st_size > std::numeric_limits<int>::max()) {
+    close(fd);
+    return cyber::common::GetProtoFromFile(map_filename, map);
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return cyber::common::GetProtoFromFile(map_filename, map);
+  }
+  madvise(data, size, MADV_SEQUENTIAL);
+  const bool parsed = map->ParseFromArray(data, static_cast<int>(size));
+  munmap(data, size);
+  if (!parsed) {
+    // not a binary proto after all, let the generic loader try text format
+    return cyber::common::GetProtoFromFile(map_filename, map);
+  }
+  return true;
+}
+
 // default lanes search radius in GetForwardNearestSignalsOnLane
 constexpr double kLanesSearchRange = 10.0;
 // backward search distance in GetForwardNearestSignalsOnLane
@@ -55,6 +92,10 @@ int HDMapImpl::LoadMapFromFile(const std::string& map_filename) {
     if (!adapter::OpendriveAdapter::LoadData(map_filename, &map_)) {
       return -1;
     }
+  } else if (absl::EndsWith(map_filename, ".bin")) {
+    if (!LoadBinaryMap(map_filename, &map_)) {
+      return -1;
+    }
   } else if (!cyber::common::GetProtoFromFile(map_filename, &map_)) {
     return -1;
   }
@@ -147,16 +188,16 @@ int HDMapImpl::LoadMapFromProto(const Map& map_proto) {
   for (const auto& stop_sign_ptr_pair : stop_sign_table_) {
     stop_sign_ptr_pair.second->PostProcess(*this);
   }
-  BuildLaneSegmentKDTree();
-  BuildJunctionPolygonKDTree();
-  BuildSignalSegmentKDTree();
-  BuildCrosswalkPolygonKDTree();
-  BuildStopSignSegmentKDTree();
-  BuildYieldSignSegmentKDTree();
-  BuildClearAreaPolygonKDTree();
-  BuildSpeedBumpSegmentKDTree();
-  BuildParkingSpacePolygonKDTree();
-  BuildPNCJunctionPolygonKDTree();
+  {
+    // read by EnsureSpatialIndex under the same lock
+    std::lock_guard<std::mutex> lock(spatial_index_mutex_);
+    map_loaded_ = true;
+  }
+  if (!FLAGS_hdmap_lazy_spatial_index) {
+    for (int i = 0; i < SPATIAL_INDEX_NUM; ++i) {
+      EnsureSpatialIndex(static_cast<SpatialIndex>(i));
+    }
+  }
   return 0;
 }
 
@@ -231,6 +272,7 @@ int HDMapImpl::GetLanes(const PointENU& point, double distance,
 
 int HDMapImpl::GetLanes(const Vec2d& point, double distance,
                         std::vector<LaneInfoConstPtr>* lanes) const {
+  EnsureSpatialIndex(LANE_SEGMENT_INDEX);
   if (lanes == nullptr || lane_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -283,6 +325,7 @@ int HDMapImpl::GetJunctions(
 int HDMapImpl::GetJunctions(
     const Vec2d& point, double distance,
     std::vector<JunctionInfoConstPtr>* junctions) const {
+  EnsureSpatialIndex(JUNCTION_POLYGON_INDEX);
   if (junctions == nullptr || junction_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -306,6 +349,7 @@ int HDMapImpl::GetSignals(const PointENU& point, double distance,
 
 int HDMapImpl::GetSignals(const Vec2d& point, double distance,
                           std::vector<SignalInfoConstPtr>* signals) const {
+  EnsureSpatialIndex(SIGNAL_SEGMENT_INDEX);
   if (signals == nullptr || signal_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -331,6 +375,7 @@ int HDMapImpl::GetCrosswalks(
 int HDMapImpl::GetCrosswalks(
     const Vec2d& point, double distance,
     std::vector<CrosswalkInfoConstPtr>* crosswalks) const {
+  EnsureSpatialIndex(CROSSWALK_POLYGON_INDEX);
   if (crosswalks == nullptr || crosswalk_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -356,6 +401,7 @@ int HDMapImpl::GetStopSigns(
 int HDMapImpl::GetStopSigns(
     const Vec2d& point, double distance,
     std::vector<StopSignInfoConstPtr>* stop_signs) const {
+  EnsureSpatialIndex(STOP_SIGN_SEGMENT_INDEX);
   if (stop_signs == nullptr || stop_sign_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -381,6 +427,7 @@ int HDMapImpl::GetYieldSigns(
 int HDMapImpl::GetYieldSigns(
     const Vec2d& point, double distance,
     std::vector<YieldSignInfoConstPtr>* yield_signs) const {
+  EnsureSpatialIndex(YIELD_SIGN_SEGMENT_INDEX);
   if (yield_signs == nullptr || yield_sign_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -407,6 +454,7 @@ int HDMapImpl::GetClearAreas(
 int HDMapImpl::GetClearAreas(
     const Vec2d& point, double distance,
     std::vector<ClearAreaInfoConstPtr>* clear_areas) const {
+  EnsureSpatialIndex(CLEAR_AREA_POLYGON_INDEX);
   if (clear_areas == nullptr || clear_area_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -433,6 +481,7 @@ int HDMapImpl::GetSpeedBumps(
 int HDMapImpl::GetSpeedBumps(
     const Vec2d& point, double distance,
     std::vector<SpeedBumpInfoConstPtr>* speed_bumps) const {
+  EnsureSpatialIndex(SPEED_BUMP_SEGMENT_INDEX);
   if (speed_bumps == nullptr || speed_bump_segment_kdtree_ == nullptr) {
     return -1;
   }
@@ -459,6 +508,7 @@ int HDMapImpl::GetParkingSpaces(
 int HDMapImpl::GetParkingSpaces(
     const Vec2d& point, double distance,
     std::vector<ParkingSpaceInfoConstPtr>* parking_spaces) const {
+  EnsureSpatialIndex(PARKING_SPACE_POLYGON_INDEX);
   if (parking_spaces == nullptr || parking_space_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -485,6 +535,7 @@ int HDMapImpl::GetPNCJunctions(
 int HDMapImpl::GetPNCJunctions(
     const apollo::common::math::Vec2d& point, double distance,
     std::vector<PNCJunctionInfoConstPtr>* pnc_junctions) const {
+  EnsureSpatialIndex(PNC_JUNCTION_POLYGON_INDEX);
   if (pnc_junctions == nullptr || pnc_junction_polygon_kdtree_ == nullptr) {
     return -1;
   }
@@ -520,6 +571,7 @@ int HDMapImpl::GetNearestLaneWithDistance(
   CHECK_NOTNULL(nearest_lane);
   CHECK_NOTNULL(nearest_s);
   CHECK_NOTNULL(nearest_l);
+  EnsureSpatialIndex(LANE_SEGMENT_INDEX);
   const auto* segment_object = lane_segment_kdtree_->GetNearestObject(point);
   if (segment_object == nullptr) {
     return -1;
@@ -556,6 +608,7 @@ int HDMapImpl::GetNearestLane(const Vec2d& point,
   CHECK_NOTNULL(nearest_lane);
   CHECK_NOTNULL(nearest_s);
   CHECK_NOTNULL(nearest_l);
+  EnsureSpatialIndex(LANE_SEGMENT_INDEX);
   const auto* segment_object = lane_segment_kdtree_->GetNearestObject(point);
   if (segment_object == nullptr) {
     return -1;
@@ -1465,6 +1518,58 @@ void HDMapImpl::BuildPNCJunctionPolygonKDTree() {
                      &pnc_junction_polygon_kdtree_);
 }
 
+void HDMapImpl::EnsureSpatialIndex(SpatialIndex index) const {
+  if (spatial_index_built_[index].load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(spatial_index_mutex_);
+  if (!map_loaded_ ||
+      spatial_index_built_[index].load(std::memory_order_relaxed)) {
+    return;
+  }
+  // the indices are caches of the loaded map, HDMapImpl is never const itself
+  const_cast<HDMapImpl*>(this)->BuildSpatialIndex(index);
+}
+
+void HDMapImpl::BuildSpatialIndex(SpatialIndex index) {
+  switch (index) {
+    case LANE_SEGMENT_INDEX:
+      BuildLaneSegmentKDTree();
+      break;
+    case JUNCTION_POLYGON_INDEX:
+      BuildJunctionPolygonKDTree();
+      break;
+    case CROSSWALK_POLYGON_INDEX:
+      BuildCrosswalkPolygonKDTree();
+      break;
+    case SIGNAL_SEGMENT_INDEX:
+      BuildSignalSegmentKDTree();
+      break;
+    case STOP_SIGN_SEGMENT_INDEX:
+      BuildStopSignSegmentKDTree();
+      break;
+    case YIELD_SIGN_SEGMENT_INDEX:
+      BuildYieldSignSegmentKDTree();
+      break;
+    case CLEAR_AREA_POLYGON_INDEX:
+      BuildClearAreaPolygonKDTree();
+      break;
+    case SPEED_BUMP_SEGMENT_INDEX:
+      BuildSpeedBumpSegmentKDTree();
+      break;
+    case PARKING_SPACE_POLYGON_INDEX:
+      BuildParkingSpacePolygonKDTree();
+      break;
+    case PNC_JUNCTION_POLYGON_INDEX:
+      BuildPNCJunctionPolygonKDTree();
+      break;
+    default:
+      AERROR << "Unknown spatial index " << index;
+      return;
+  }
+  spatial_index_built_[index].store(true, std::memory_order_release);
+}
+
 template <class KDTree>
 int HDMapImpl::SearchObjects(const Vec2d& center, const double radius,
                              const KDTree& kdtree,
@@ -1516,6 +1621,11 @@ void HDMapImpl::Clear() {
   parking_space_polygon_kdtree_.reset(nullptr);
   pnc_junction_polygon_boxes_.clear();
   pnc_junction_polygon_kdtree_.reset(nullptr);
+  std::lock_guard<std::mutex> lock(spatial_index_mutex_);
+  for (auto& built : spatial_index_built_) {
+    built.store(false);
+  }
+  map_loaded_ = false;
 }
 
 }  // namespace hdmap
@@ -15,7 +15,10 @@ limitations under the License.
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -431,6 +434,29 @@ class HDMapImpl {
 
   void Clear();
 
+ private:
+  enum SpatialIndex {
+    LANE_SEGMENT_INDEX = 0,
+    JUNCTION_POLYGON_INDEX,
+    CROSSWALK_POLYGON_INDEX,
+    SIGNAL_SEGMENT_INDEX,
+    STOP_SIGN_SEGMENT_INDEX,
+    YIELD_SIGN_SEGMENT_INDEX,
+    CLEAR_AREA_POLYGON_INDEX,
+    SPEED_BUMP_SEGMENT_INDEX,
+    PARKING_SPACE_POLYGON_INDEX,
+    PNC_JUNCTION_POLYGON_INDEX,
+    SPATIAL_INDEX_NUM,
+  };
+
+  /**
+   * @brief builds the spatial index unless it is already built, so that
+   * FLAGS_hdmap_lazy_spatial_index only pays for the indices a process
+   * actually queries
+   */
+  void EnsureSpatialIndex(SpatialIndex index) const;
+  void BuildSpatialIndex(SpatialIndex index);
+
  private:
   Map map_;
   LaneTable lane_table_;
@@ -476,6 +502,12 @@ class HDMapImpl {
 
   std::vector<PNCJunctionPolygonBox> pnc_junction_polygon_boxes_;
   std::unique_ptr<PNCJunctionPolygonKDTree> pnc_junction_polygon_kdtree_;
+
+  mutable std::mutex spatial_index_mutex_;
+  // guarded by spatial_index_mutex_
+  bool map_loaded_ = false;
+  mutable std::array<std::atomic<bool>, SPATIAL_INDEX_NUM>
+      spatial_index_built_ = {};
 };
 
 }  // namespace hdmap
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Measures what a process pays for the hdmap before it can answer queries:
+// BM_LoadMap times LoadMapFromFile with the spatial indices built eagerly
+// (arg 0) or on first query (arg 1), BM_LoadAndQueryLanes adds the first
+// GetNearestLane / GetLanes, which is when the lazy indices are built.
+// heap_mb is the heap held by one loaded map, rss_mb the resident size of the
+// whole process afterwards. Point --benchmark_map_file at a production map,
+// the test map is tiny:
+//   hdmap_impl_benchmark --benchmark_map_file=/apollo/.../base_map.bin
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "modules/common/configs/config_gflags.h"
+#include "modules/map/hdmap/hdmap_impl.h"
+
+DEFINE_string(benchmark_map_file, "modules/map/hdmap/test-data/base_map.bin",
+              "map file loaded by the benchmarks");
+
+namespace apollo {
+namespace hdmap {
+namespace {
+
+double HeapMb() {
+  return static_cast<double>(mallinfo2().uordblks) / (1024.0 * 1024.0);
+}
+
+double RssMb() {
+  long pages = 0;  // NOLINT
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm != nullptr) {
+    if (fscanf(statm, "%*ld %ld", &pages) != 1) {
+      pages = 0;
+    }
+    fclose(statm);
+  }
+  return static_cast<double>(pages) * sysconf(_SC_PAGESIZE) /
+         (1024.0 * 1024.0);
+}
+
+// a point on the first lane of the map, so the queries hit real data
+apollo::common::PointENU QueryPoint() {
+  apollo::common::PointENU query_point;
+  Map map;
+  if (!cyber::common::GetProtoFromFile(FLAGS_benchmark_map_file, &map) ||
+      map.lane().empty() || map.lane(0).central_curve().segment().empty()) {
+    return query_point;
+  }
+  const auto& segment = map.lane(0).central_curve().segment(0);
+  if (segment.line_segment().point().empty()) {
+    return query_point;
+  }
+  query_point.set_x(segment.line_segment().point(0).x());
+  query_point.set_y(segment.line_segment().point(0).y());
+  return query_point;
+}
+
+void RunLoad(benchmark::State& state, bool query) {
+  const bool lazy = FLAGS_hdmap_lazy_spatial_index;
+  FLAGS_hdmap_lazy_spatial_index = state.range(0) != 0;
+  const auto point = QueryPoint();
+  double heap_mb = 0.0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto impl = std::make_unique<HDMapImpl>();
+    const double heap_before = HeapMb();
+    state.ResumeTiming();
+
+    if (impl->LoadMapFromFile(FLAGS_benchmark_map_file) != 0) {
+      state.SkipWithError("failed to load the map");
+      break;
+    }
+    if (query) {
+      LaneInfoConstPtr nearest_lane;
+      double nearest_s = 0.0;
+      double nearest_l = 0.0;
+      impl->GetNearestLane(point, &nearest_lane, &nearest_s, &nearest_l);
+      std::vector<LaneInfoConstPtr> lanes;
+      impl->GetLanes(point, 10.0, &lanes);
+      benchmark::DoNotOptimize(lanes);
+    }
+
+    state.PauseTiming();
+    heap_mb = HeapMb() - heap_before;
+    impl.reset();
+    state.ResumeTiming();
+  }
+  FLAGS_hdmap_lazy_spatial_index = lazy;
+  state.counters["heap_mb"] = heap_mb;
+  state.counters["rss_mb"] = RssMb();
+}
+
+void BM_LoadMap(benchmark::State& state) { RunLoad(state, false); }
+BENCHMARK(BM_LoadMap)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+void BM_LoadAndQueryLanes(benchmark::State& state) { RunLoad(state, true); }
+BENCHMARK(BM_LoadAndQueryLanes)
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace hdmap
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -13,13 +13,18 @@ See the License for the specific language governing permissions and
 limitations under the License.
 =========================================================================*/
 
+#include <algorithm>
 #include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "gflags/gflags.h"
 #include "gtest/gtest.h"
 
 #include "cyber/common/file.h"
+#include "modules/common/configs/config_gflags.h"
 #include "modules/map/hdmap/hdmap_impl.h"
 
 DEFINE_string(output_dir, "/tmp", "output map directory");
@@ -28,6 +33,16 @@ namespace {
 
 constexpr char kMapFilename[] = "modules/map/hdmap/test-data/base_map.bin";
 
+template <class InfoConstPtr>
+std::vector<std::string> SortedIds(const std::vector<InfoConstPtr>& infos) {
+  std::vector<std::string> ids;
+  for (const auto& info : infos) {
+    ids.push_back(info->id().id());
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
 }  // namespace
 
 namespace apollo {
@@ -432,5 +447,50 @@ TEST_F(HDMapImplTestSuite, GetLocalMap) {
   cyber::common::DeleteFile(output_bin_file);
 }
 
+TEST_F(HDMapImplTestSuite, LazySpatialIndex) {
+  apollo::common::PointENU point;
+  point.set_x(586424.09);
+  point.set_y(4140727.02);
+
+  const bool lazy = FLAGS_hdmap_lazy_spatial_index;
+  FLAGS_hdmap_lazy_spatial_index = false;
+  HDMapImpl eager_impl;
+  ASSERT_EQ(0, eager_impl.LoadMapFromFile(kMapFilename));
+  std::vector<LaneInfoConstPtr> expected_lanes;
+  ASSERT_EQ(0, eager_impl.GetLanes(point, 5, &expected_lanes));
+  std::vector<JunctionInfoConstPtr> expected_junctions;
+  ASSERT_EQ(0, eager_impl.GetJunctions(point, 100, &expected_junctions));
+
+  FLAGS_hdmap_lazy_spatial_index = true;
+  HDMapImpl lazy_impl;
+  ASSERT_EQ(0, lazy_impl.LoadMapFromFile(kMapFilename));
+  FLAGS_hdmap_lazy_spatial_index = lazy;
+
+  // the first queries race to build the indices
+  std::vector<std::thread> threads;
+  std::vector<std::vector<LaneInfoConstPtr>> lanes(8);
+  std::vector<std::vector<JunctionInfoConstPtr>> junctions(8);
+  for (size_t i = 0; i < lanes.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      EXPECT_EQ(0, lazy_impl.GetLanes(point, 5, &lanes[i]));
+      EXPECT_EQ(0, lazy_impl.GetJunctions(point, 100, &junctions[i]));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_FALSE(expected_lanes.empty());
+  for (size_t i = 0; i < lanes.size(); ++i) {
+    EXPECT_EQ(SortedIds(expected_lanes), SortedIds(lanes[i]));
+    EXPECT_EQ(SortedIds(expected_junctions), SortedIds(junctions[i]));
+  }
+
+  // reloading drops the indices built so far
+  ASSERT_EQ(0, lazy_impl.LoadMapFromFile(kMapFilename));
+  std::vector<LaneInfoConstPtr> reloaded_lanes;
+  ASSERT_EQ(0, lazy_impl.GetLanes(point, 5, &reloaded_lanes));
+  EXPECT_EQ(SortedIds(expected_lanes), SortedIds(reloaded_lanes));
+}
+
 }  // namespace hdmap
 }  // namespace apollo
@@ -16,6 +16,8 @@
 #include "modules/perception/common/algorithm/i_lib/pc/i_ground.h"
 
 #include <algorithm>
+#include <atomic>
+#include <future>
 #include <limits>
 
 namespace apollo {
@@ -44,6 +46,8 @@ void PlaneFitGroundDetectorParam::SetDefault() {
   nr_ransac_iter_threshold = 32;
   candidate_filter_threshold = 1.0f;  // 1 meter
   nr_smooth_iter = 1;
+  nr_threads = 1;
+  use_warm_start = false;
 }
 
 bool PlaneFitGroundDetectorParam::Validate() const {
@@ -51,6 +55,7 @@ bool PlaneFitGroundDetectorParam::Validate() const {
       nr_grids_coarse > nr_grids_fine || nr_points_max == 0 ||
       nr_samples_min_threshold == 0 || nr_samples_max_threshold == 0 ||
       nr_inliers_min_threshold == 0 || nr_ransac_iter_threshold == 0 ||
+      nr_threads == 0 ||
       roi_region_rad_x <= 0.f || roi_region_rad_y <= 0.f ||
       roi_region_rad_z <= 0.f ||
       planefit_dist_threshold_near > planefit_dist_threshold_far) {
@@ -129,6 +134,55 @@ void PlaneFitGroundDetector::InitOrderTable(const VoxelGridXY<float> *vg,
   }
 }
 
+// Init the fitting levels, a grid is one level above its neighbors before it
+// in the order table. The grids of a level are not neighbors, so they see the
+// same neighbor planes as in the order of the table when fitted in parallel.
+void PlaneFitGroundDetector::InitFitLevels() {
+  int rows = static_cast<int>(param_.nr_grids_coarse);
+  std::vector<int> levels(rows * rows, -1);
+  std::vector<std::pair<int, int>> neighbors;
+  fit_levels_.clear();
+  for (unsigned int i = 0; i < vg_coarse_->NrVoxel(); ++i) {
+    int r = order_table_[i].first;
+    int c = order_table_[i].second;
+    int level = 0;
+    neighbors.clear();
+    GetNeighbors(r, c, rows, rows, &neighbors);
+    for (const auto &neighbor : neighbors) {
+      level = IMax(level, levels[neighbor.first * rows + neighbor.second] + 1);
+    }
+    levels[r * rows + c] = level;
+    if (level >= static_cast<int>(fit_levels_.size())) {
+      fit_levels_.resize(level + 1);
+    }
+    fit_levels_[level].push_back(std::pair<int, int>(r, c));
+  }
+}
+
+void PlaneFitGroundDetector::RunTasks(
+    unsigned int nr_tasks,
+    const std::function<void(unsigned int, unsigned int)> &task) {
+  std::atomic<unsigned int> next_task(0);
+  auto run_tasks = [&](unsigned int thread) {
+    for (unsigned int i = next_task++; i < nr_tasks; i = next_task++) {
+      task(i, thread);
+    }
+  };
+  std::vector<std::future<void>> helpers;
+  if (thread_pool_ != nullptr) {
+    unsigned int nr_threads = IMin(param_.nr_threads, nr_tasks);
+    for (unsigned int thread = 1; thread < nr_threads; ++thread) {
+      helpers.push_back(thread_pool_->Enqueue(run_tasks, thread));
+    }
+  }
+  run_tasks(0);
+  for (auto &helper : helpers) {
+    if (helper.valid()) {
+      helper.wait();
+    }
+  }
+}
+
 bool PlaneFitGroundDetector::Init() {
   unsigned int r = 0;
   unsigned int c = 0;
@@ -166,6 +220,7 @@ bool PlaneFitGroundDetector::Init() {
   // Init order lookup table
   order_table_ = IAlloc<std::pair<int, int>>(vg_fine_->NrVoxel());
   InitOrderTable(vg_coarse_, order_table_);
+  InitFitLevels();
 
   // ground plane:
   ground_planes_ =
@@ -207,14 +262,15 @@ bool PlaneFitGroundDetector::Init() {
       local_candis_[r][c].Reserve(capacity);
     }
   }
-  // threeds in ransac, in inhomogeneous coordinates:
-  pf_threeds_ =
-      IAllocAligned<float>(param_.nr_samples_max_threshold * dim_point_, 4);
+  // threeds in ransac, in inhomogeneous coordinates, one buffer a thread:
+  pf_threeds_ = IAllocAligned<float>(
+      param_.nr_threads * param_.nr_samples_max_threshold * dim_point_, 4);
   if (!pf_threeds_) {
     return false;
   }
   memset(reinterpret_cast<void *>(pf_threeds_), 0,
-         param_.nr_samples_max_threshold * dim_point_ * sizeof(float));
+         param_.nr_threads * param_.nr_samples_max_threshold * dim_point_ *
+             sizeof(float));
   // labels:
   labels_ = IAllocAligned<char>(param_.nr_points_max, 4);
   if (!labels_) {
@@ -236,20 +292,22 @@ bool PlaneFitGroundDetector::Init() {
       map_fine_to_coarse_[index + c] = pr * param_.nr_grids_coarse + pc;
     }
   }
-  // ransac memory:
-  sampled_z_values_ = IAllocAligned<float>(param_.nr_z_comp_candis, 4);
+  // ransac memory, one buffer a thread:
+  sampled_z_values_ =
+      IAllocAligned<float>(param_.nr_threads * param_.nr_z_comp_candis, 4);
   if (!sampled_z_values_) {
     return false;
   }
   memset(reinterpret_cast<void *>(sampled_z_values_), 0,
-         param_.nr_z_comp_candis * sizeof(float));
-  // ransac memory:
-  sampled_indices_ = IAllocAligned<int>(param_.nr_z_comp_candis, 4);
+         param_.nr_threads * param_.nr_z_comp_candis * sizeof(float));
+  // ransac memory, one buffer a thread:
+  sampled_indices_ =
+      IAllocAligned<int>(param_.nr_threads * param_.nr_z_comp_candis, 4);
   if (!sampled_indices_) {
     return false;
   }
   memset(reinterpret_cast<void *>(sampled_indices_), 0,
-         param_.nr_z_comp_candis * sizeof(int));
+         param_.nr_threads * param_.nr_z_comp_candis * sizeof(int));
   // ransac thresholds:
   pf_thresholds_ =
       IAlloc2<float>(param_.nr_grids_coarse, param_.nr_grids_coarse);
@@ -258,6 +316,11 @@ bool PlaneFitGroundDetector::Init() {
   }
   // compute thresholds
   ComputeAdaptiveThreshold();
+  // the calling thread is one of the threads
+  thread_pool_.reset();
+  if (param_.nr_threads > 1) {
+    thread_pool_.reset(new cyber::base::ThreadPool(param_.nr_threads - 1));
+  }
   return true;
 }
 
@@ -392,19 +455,15 @@ void PlaneFitGroundDetector::ComputeSignedGroundHeight(
   for (r = 0; r < nr_points; ++r) {
     height_above_ground[r] = std::numeric_limits<float>::max();
   }
-  ComputeSignedGroundHeightLine(
-      point_cloud, ground_planes_[0], ground_planes_[0], ground_planes_[1],
-      height_above_ground, 0, nr_points, nr_point_elements);
-  for (r = 1; r < nm1; ++r) {
-    ComputeSignedGroundHeightLine(point_cloud, ground_planes_[r - 1],
-                                  ground_planes_[r], ground_planes_[r + 1],
-                                  height_above_ground, r, nr_points,
+  // the points of a line are in its voxels only
+  RunTasks(param_.nr_grids_coarse, [&](unsigned int line, unsigned int) {
+    unsigned int up = line > 0 ? line - 1 : 0;
+    unsigned int dn = line < nm1 ? line + 1 : nm1;
+    ComputeSignedGroundHeightLine(point_cloud, ground_planes_[up],
+                                  ground_planes_[line], ground_planes_[dn],
+                                  height_above_ground, line, nr_points,
                                   nr_point_elements);
-  }
-  ComputeSignedGroundHeightLine(point_cloud, ground_planes_[nm1 - 1],
-                                ground_planes_[nm1], ground_planes_[nm1],
-                                height_above_ground, nm1, nr_points,
-                                nr_point_elements);
+  });
 }
 
 void PlaneFitGroundDetector::ComputeSignedGroundHeightLine(
@@ -543,12 +602,16 @@ int PlaneFitGroundDetector::FilterGrid(const Voxel<float> &vx,
                                        const float *point_cloud,
                                        PlaneFitPointCandIndices *candi,
                                        unsigned int nr_points,
-                                       unsigned int nr_point_element) {
+                                       unsigned int nr_point_element,
+                                       unsigned int thread) {
   int pos = 0;
   int rseed = I_DEFAULT_SEED;
   int nr_candis = 0;
   unsigned int i = 0;
   unsigned int nr_samples = IMin(param_.nr_z_comp_candis, vx.NrPoints());
+  float *sampled_z_values =
+      sampled_z_values_ + thread * param_.nr_z_comp_candis;
+  int *sampled_indices = sampled_indices_ + thread * param_.nr_z_comp_candis;
   if (vx.Empty()) {
     return 0;
   }
@@ -559,25 +622,25 @@ int PlaneFitGroundDetector::FilterGrid(const Voxel<float> &vx,
     for (i = 0; i < vx.NrPoints(); ++i) {
       pos = vx.indices_[i] * nr_point_element;
       //  requires the Z element to be in the third position, i.e., after X, Y
-      sampled_z_values_[i] = (point_cloud + pos)[2];
+      sampled_z_values[i] = (point_cloud + pos)[2];
     }
   } else {
-    IRandomSample(sampled_indices_, static_cast<int>(param_.nr_z_comp_candis),
+    IRandomSample(sampled_indices, static_cast<int>(param_.nr_z_comp_candis),
                   static_cast<int>(vx.NrPoints()), &rseed);
     //  sampled z values
     for (i = 0; i < nr_samples; ++i) {
-      pos = vx.indices_[sampled_indices_[i]] * nr_point_element;
+      pos = vx.indices_[sampled_indices[i]] * nr_point_element;
       // requires the Z element to be in the third position, i.e., after X, Y
-      sampled_z_values_[i] = (point_cloud + pos)[2];
+      sampled_z_values[i] = (point_cloud + pos)[2];
     }
   }
   // Filter points and get plane fitting candidates
-  nr_candis = CompareZ(point_cloud, vx.indices_, sampled_z_values_, candi,
+  nr_candis = CompareZ(point_cloud, vx.indices_, sampled_z_values, candi,
                        nr_points, nr_point_element, nr_samples);
   return nr_candis;
 }
 
-int PlaneFitGroundDetector::FilterLine(unsigned int r) {
+int PlaneFitGroundDetector::FilterLine(unsigned int r, unsigned int thread) {
   int nr_candis = 0;
   unsigned int c = 0;
   const float *point_cloud = vg_fine_->const_data();
@@ -589,25 +652,33 @@ int PlaneFitGroundDetector::FilterLine(unsigned int r) {
     parent = map_fine_to_coarse_[begin + c];
     nr_candis +=
         FilterGrid((*vg_fine_)(r, c), point_cloud, &local_candis_[0][parent],
-                   nr_points, nr_point_element);
+                   nr_points, nr_point_element, thread);
   }
   return nr_candis;
 }
 
 int PlaneFitGroundDetector::Filter() {
-  int nr_candis = 0;
+  std::atomic<int> nr_candis(0);
   unsigned int i = 0;
-  unsigned int r = 0;
+  unsigned int sf = param_.nr_grids_fine / param_.nr_grids_coarse;
   memset(reinterpret_cast<void *>(labels_), 0,
          vg_fine_->NrPoints() * sizeof(char));
   //  Clear candidate list
   for (i = 0; i < vg_coarse_->NrVoxel(); ++i) {
     local_candis_[0][i].Clear();
   }
-  //  Filter plane fitting candidates
-  for (r = 0; r < param_.nr_grids_fine; ++r) {
-    nr_candis += FilterLine(r);
-  }
+  //  Filter plane fitting candidates, the fine lines of a coarse line fill
+  //  its candidate lists in the order of the lines
+  RunTasks(param_.nr_grids_coarse, [&](unsigned int pr, unsigned int thread) {
+    unsigned int begin = pr * sf;
+    unsigned int end = pr + 1 < param_.nr_grids_coarse ? begin + sf
+                                                       : param_.nr_grids_fine;
+    int nr_line_candis = 0;
+    for (unsigned int r = begin; r < end; ++r) {
+      nr_line_candis += FilterLine(r, thread);
+    }
+    nr_candis += nr_line_candis;
+  });
   return nr_candis;
 }
 
@@ -810,9 +881,12 @@ inline float calculate_two_angles(const GroundPlaneLiDAR &p1,
 
 int PlaneFitGroundDetector::FitGridWithNeighbors(
     int r, int c, const float *point_cloud, GroundPlaneLiDAR *groundplane,
-    unsigned int nr_points, unsigned int nr_point_element, float dist_thre) {
+    unsigned int nr_points, unsigned int nr_point_element, float dist_thre,
+    unsigned int thread) {
   // initialize the best plane
   groundplane->ForceInvalid();
+  // the grid is not fitted yet, its plane is the one of the last frame
+  GroundPlaneLiDAR prior = ground_planes_[r][c];
   // not enough samples, failed and return
 
   PlaneFitPointCandIndices &candi = local_candis_[r][c];
@@ -825,9 +899,10 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
     return 0;
   }
 
-  GroundPlaneLiDAR plane;
-  int kNr_iter =
+  // the last hypothesis is the plane of the last frame
+  int prior_id =
       param_.nr_ransac_iter_threshold + static_cast<int>(neighbors.size());
+  int kNr_iter = prior_id + 1;
   //  check hypothesis initialized correct or not
   if (kNr_iter < 1) {
     return 0;
@@ -849,8 +924,10 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
   // 3x3 matrix stores: x, y, z; x, y, z; x, y, z;
   float samples[9];
   // copy 3D points
+  float *threeds =
+      pf_threeds_ + thread * param_.nr_samples_max_threshold * dim_point_;
   float *psrc = nullptr;
-  float *pdst = pf_threeds_;
+  float *pdst = threeds;
   int r_n = 0;
   int c_n = 0;
   float angle = -1.f;
@@ -859,13 +936,34 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
     ICopy3(point_cloud + (nr_point_element * candi[i]), pdst);
     pdst += dim_point_;
   }
+  // warm start: no ransac if the plane of the last frame has enough inliers
+  bool is_prior_fit = false;
+  if (param_.use_warm_start && prior.IsValid()) {
+    hypothesis[prior_id] = prior;
+    psrc = threeds;
+    nr_inliers = 0;
+    for (int j = 0; j < nr_samples; ++j) {
+      ptp_dist = IPlaneToPointDistanceWUnitNorm(prior.params, psrc);
+      if (ptp_dist < dist_thre) {
+        nr_inliers++;
+      }
+      psrc += dim_point_;
+    }
+    if (nr_inliers < static_cast<int>(param_.nr_inliers_min_threshold)) {
+      hypothesis[prior_id].ForceInvalid();
+    } else {
+      hypothesis[prior_id].SetNrSupport(nr_inliers);
+      is_prior_fit = nr_inliers > nr_inliers_termi;
+    }
+  }
   // generate plane hypothesis and vote
-  for (int i = 0; i < param_.nr_ransac_iter_threshold; ++i) {
+  for (int i = 0; i < param_.nr_ransac_iter_threshold && !is_prior_fit;
+       ++i) {
     IRandomSample(indices_trial, 3, nr_samples, &rseed);
     IScale3(indices_trial, dim_point_);
-    ICopy3(pf_threeds_ + indices_trial[0], samples);
-    ICopy3(pf_threeds_ + indices_trial[1], samples + 3);
-    ICopy3(pf_threeds_ + indices_trial[2], samples + 6);
+    ICopy3(threeds + indices_trial[0], samples);
+    ICopy3(threeds + indices_trial[1], samples + 3);
+    ICopy3(threeds + indices_trial[2], samples + 6);
     IPlaneFitDestroyed(samples, hypothesis[i].params);
     // check if the plane hypothesis has valid geometry
     if (hypothesis[i].GetDegreeNormalToZ() > param_.planefit_orien_threshold) {
@@ -873,7 +971,7 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
     }
     // iterate samples and check if the point to plane distance is below
     // threshold
-    psrc = pf_threeds_;
+    psrc = threeds;
     nr_inliers = 0;
     for (int j = 0; j < nr_samples; ++j) {
       ptp_dist = IPlaneToPointDistanceWUnitNorm(hypothesis[i].params, psrc);
@@ -896,7 +994,7 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
     if (ground_planes_[r_n][c_n].IsValid()) {
       hypothesis[i + param_.nr_ransac_iter_threshold] =
           ground_planes_[r_n][c_n];
-      psrc = pf_threeds_;
+      psrc = threeds;
       nr_inliers = 0;
       for (int j = 0; j < nr_samples; ++j) {
         ptp_dist = IPlaneToPointDistanceWUnitNorm(
@@ -949,8 +1047,8 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
   // iterate samples and check if the point to plane distance is within
   // threshold
   nr_inliers = 0;
-  psrc = pf_threeds_;
-  pdst = pf_threeds_;
+  psrc = threeds;
+  pdst = threeds;
   for (int i = 0; i < nr_samples; ++i) {
     ptp_dist = IPlaneToPointDistanceWUnitNorm(groundplane->params, psrc);
     if (ptp_dist < dist_thre) {
@@ -962,8 +1060,8 @@ int PlaneFitGroundDetector::FitGridWithNeighbors(
   }
   groundplane->SetNrSupport(nr_inliers);
 
-  // note that pf_threeds_ will be destroyed after calling this routine
-  IPlaneFitTotalLeastSquare(pf_threeds_, groundplane->params, nr_inliers);
+  // note that threeds will be destroyed after calling this routine
+  IPlaneFitTotalLeastSquare(threeds, groundplane->params, nr_inliers);
   if (angle_best <= CalculateAngleDist(*groundplane, neighbors)) {
     *groundplane = hypothesis[best];
     groundplane->SetStatus(true);
@@ -1010,32 +1108,35 @@ float PlaneFitGroundDetector::CalculateAngleDist(
 }
 
 int PlaneFitGroundDetector::FitInOrder() {
-  int nr_grids = 0;
+  std::atomic<int> nr_grids(0);
   unsigned int i = 0;
   unsigned int j = 0;
-  int r = 0;
-  int c = 0;
-  GroundPlaneLiDAR gp;
   for (i = 0; i < param_.nr_grids_coarse; ++i) {
     for (j = 0; j < param_.nr_grids_coarse; ++j) {
       ground_z_[i][j].first = 0.f;
       ground_z_[i][j].second = false;
     }
   }
-  for (i = 0; i < vg_coarse_->NrVoxel(); ++i) {
-    r = order_table_[i].first;
-    c = order_table_[i].second;
-    if (FitGridWithNeighbors(
-            r, c, vg_coarse_->const_data(), &gp, vg_coarse_->NrPoints(),
-            vg_coarse_->NrPointElement(), pf_thresholds_[r][c]) >=
-        static_cast<int>(param_.nr_inliers_min_threshold)) {
-      IPlaneEucliToSpher(gp, &ground_planes_sphe_[r][c]);
-      ground_planes_[r][c] = gp;
-      nr_grids++;
-    } else {
-      ground_planes_sphe_[r][c].ForceInvalid();
-      ground_planes_[r][c].ForceInvalid();
-    }
+  // same planes as fitting the grids one by one in the order table
+  for (const auto &level : fit_levels_) {
+    RunTasks(static_cast<unsigned int>(level.size()),
+             [&](unsigned int k, unsigned int thread) {
+               int r = level[k].first;
+               int c = level[k].second;
+               GroundPlaneLiDAR gp;
+               if (FitGridWithNeighbors(r, c, vg_coarse_->const_data(), &gp,
+                                        vg_coarse_->NrPoints(),
+                                        vg_coarse_->NrPointElement(),
+                                        pf_thresholds_[r][c], thread) >=
+                   static_cast<int>(param_.nr_inliers_min_threshold)) {
+                 IPlaneEucliToSpher(gp, &ground_planes_sphe_[r][c]);
+                 ground_planes_[r][c] = gp;
+                 nr_grids++;
+               } else {
+                 ground_planes_sphe_[r][c].ForceInvalid();
+                 ground_planes_[r][c].ForceInvalid();
+               }
+             });
   }
   return nr_grids;
 }
@@ -1214,21 +1315,20 @@ int PlaneFitGroundDetector::SmoothGrid(const GroundPlaneSpherical &g,
 }
 
 int PlaneFitGroundDetector::Smooth() {
-  int nr_grids = 0;
-  unsigned int r = 0;
-  unsigned int c = 0;
+  std::atomic<int> nr_grids(0);
   unsigned int nm1 = param_.nr_grids_coarse - 1;
   assert(param_.nr_grids_coarse >= 2);
-  nr_grids += SmoothLine(0, 0, 1);
-  for (r = 1; r < nm1; ++r) {
-    nr_grids += SmoothLine(r - 1, r, r + 1);
-  }
-  nr_grids += SmoothLine(nm1 - 1, nm1, nm1);
-  for (r = 0; r < param_.nr_grids_coarse; ++r) {
-    for (c = 0; c < param_.nr_grids_coarse; ++c) {
+  // the lines read the spherical planes and write the euclidean ones
+  RunTasks(param_.nr_grids_coarse, [&](unsigned int r, unsigned int) {
+    unsigned int up = r > 0 ? r - 1 : 0;
+    unsigned int dn = r < nm1 ? r + 1 : nm1;
+    nr_grids += SmoothLine(up, r, dn);
+  });
+  RunTasks(param_.nr_grids_coarse, [&](unsigned int r, unsigned int) {
+    for (unsigned int c = 0; c < param_.nr_grids_coarse; ++c) {
       IPlaneEucliToSpher(ground_planes_[r][c], &ground_planes_sphe_[r][c]);
     }
-  }
+  });
   return nr_grids;
 }
 
@@ -1240,12 +1340,19 @@ bool PlaneFitGroundDetector::Detect(const float *point_cloud,
   assert(height_above_ground != nullptr);
   assert(nr_points <= param_.nr_points_max);
   assert(nr_point_elements >= 3);
-  // setup the fine voxel grid
-  if (!vg_fine_->SetS(point_cloud, nr_points, nr_point_elements)) {
-    return false;
-  }
-  // setup the coarse voxel grid
-  if (!vg_coarse_->SetS(point_cloud, nr_points, nr_point_elements)) {
+  // setup the fine and the coarse voxel grids
+  std::future<bool> coarse_set;
+  if (thread_pool_ != nullptr) {
+    coarse_set = thread_pool_->Enqueue([&]() {
+      return vg_coarse_->SetS(point_cloud, nr_points, nr_point_elements);
+    });
+  }
+  bool is_fine_set = vg_fine_->SetS(point_cloud, nr_points, nr_point_elements);
+  bool is_coarse_set =
+      coarse_set.valid()
+          ? coarse_set.get()
+          : vg_coarse_->SetS(point_cloud, nr_points, nr_point_elements);
+  if (!is_fine_set || !is_coarse_set) {
     return false;
   }
   // int nr_candis = 0;
@@ -1312,6 +1419,29 @@ PlaneFitPointCandIndices **PlaneFitGroundDetector::GetCandis() const {
   return local_candis_;
 }
 
+void PlaneFitGroundDetector::TranslateGroundPlanes(const float *translation) {
+  assert(translation != nullptr);
+  float voxel_width_x = 0.f;
+  float voxel_width_y = 0.f;
+  float voxel_width_z = 0.f;
+  vg_coarse_->GetVoxelDimension(&voxel_width_x, &voxel_width_y,
+                                &voxel_width_z);
+  // farther than a grid, the grids cover other ground
+  bool is_far = IAbs(translation[0]) > voxel_width_x ||
+                IAbs(translation[1]) > voxel_width_y;
+  for (unsigned int r = 0; r < param_.nr_grids_coarse; ++r) {
+    for (unsigned int c = 0; c < param_.nr_grids_coarse; ++c) {
+      GroundPlaneLiDAR &plane = ground_planes_[r][c];
+      if (is_far) {
+        plane.ForceInvalid();
+      } else if (plane.IsValid()) {
+        // n * (p' + t) + d = 0 for a point p' of the next frame
+        plane.params[3] += IDot3(plane.params, translation);
+      }
+    }
+  }
+}
+
 void IPlaneEucliToSpher(const GroundPlaneLiDAR &src,
                         GroundPlaneSpherical *dst) {
   if (!src.IsValid()) {
@@ -15,9 +15,12 @@
  *****************************************************************************/
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "cyber/base/thread_pool.h"
 #include "modules/perception/common/algorithm/i_lib/core/i_blas.h"
 #include "modules/perception/common/algorithm/i_lib/core/i_rand.h"
 #include "modules/perception/common/algorithm/i_lib/geometry/i_plane.h"
@@ -189,6 +192,8 @@ struct PlaneFitGroundDetectorParam {
   float candidate_filter_threshold;
   int nr_ransac_iter_threshold;
   int nr_smooth_iter;
+  unsigned int nr_threads;
+  bool use_warm_start;
 };
 
 struct PlaneFitPointCandIndices {
@@ -253,10 +258,19 @@ class PlaneFitGroundDetector : public BaseGroundDetector {
   unsigned int GetGridDimY() const;
   float GetUnknownHeight();
   PlaneFitPointCandIndices **GetCandis() const;
+  // move the ground planes of the last frame into the coordinates of the next
+  // frame, whose origin is at translation in the last frame. They warm start
+  // the fit of the next frame if use_warm_start is set.
+  void TranslateGroundPlanes(const float *translation);
 
  protected:
   void CleanUp();
   void InitOrderTable(const VoxelGridXY<float> *vg, std::pair<int, int> *order);
+  void InitFitLevels();
+  // run task(i, thread) for i in [0, nr_tasks) on nr_threads threads, thread
+  // is the index of the scratch buffers of the calling thread
+  void RunTasks(unsigned int nr_tasks,
+                const std::function<void(unsigned int, unsigned int)> &task);
   int Fit();
   int FitLine(unsigned int r);
   int FitGrid(const float *point_cloud, PlaneFitPointCandIndices *candi,
@@ -270,16 +284,17 @@ class PlaneFitGroundDetector : public BaseGroundDetector {
   int FitGridWithNeighbors(int r, int c, const float *point_cloud,
                            GroundPlaneLiDAR *groundplane,
                            unsigned int nr_points,
-                           unsigned int nr_point_element, float dist_thre);
+                           unsigned int nr_point_element, float dist_thre,
+                           unsigned int thread);
   void GetNeighbors(int r, int c, int rows, int cols,
                     std::vector<std::pair<int, int>> *neighbors);
   float CalculateAngleDist(const GroundPlaneLiDAR &plane,
                            const std::vector<std::pair<int, int>> &neighbors);
   int Filter();
-  int FilterLine(unsigned int r);
+  int FilterLine(unsigned int r, unsigned int thread);
   int FilterGrid(const Voxel<float> &vg, const float *point_cloud,
                  PlaneFitPointCandIndices *candi, unsigned int nr_points,
-                 unsigned int nr_point_element);
+                 unsigned int nr_point_element, unsigned int thread);
   int Smooth();
   int SmoothLine(unsigned int up, unsigned int r, unsigned int dn);
   int CompleteGrid(const GroundPlaneSpherical &lt,
@@ -320,6 +335,10 @@ class PlaneFitGroundDetector : public BaseGroundDetector {
   float *pf_threeds_;
   int *sampled_indices_;
   std::pair<int, int> *order_table_;
+  // the coarse grids by level, a grid is fitted after its neighbors before it
+  // in the order table, the grids of a level are fitted in parallel
+  std::vector<std::vector<std::pair<int, int>>> fit_levels_;
+  std::unique_ptr<cyber::base::ThreadPool> thread_pool_;
 };
 
 }  // namespace algorithm
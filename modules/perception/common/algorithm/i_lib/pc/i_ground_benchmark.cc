@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Latency of PlaneFitGroundDetector::Detect with the parameters of the
+// spatio temporal ground detector config, on --ground_benchmark_beam_num
+// beams of 1800 points up to 110 m, driving 1.5 m a frame over a sloped and
+// rolling ground with 15% of the points above it. Arguments are the thread
+// number and use_warm_start, the translation of the planes between the frames
+// is part of the time. Run:
+//   i_ground_benchmark
+// ground_points is the mean number of points within 0.25 m of the ground, the
+// heights are the same for all thread numbers.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "modules/perception/common/algorithm/i_lib/pc/i_ground.h"
+
+DEFINE_int32(ground_benchmark_beam_num, 128, "number of beams of the lidar");
+
+namespace apollo {
+namespace perception {
+namespace algorithm {
+namespace {
+
+constexpr int kFrameNum = 20;
+constexpr float kFrameStep = 1.5f;
+
+std::vector<float> LidarCloud(int frame) {
+  std::mt19937 random(frame);
+  std::uniform_real_distribution<float> uniform(0.f, 1.f);
+  std::normal_distribution<float> noise(0.f, 0.03f);
+  const int beam_num = FLAGS_ground_benchmark_beam_num;
+  const int point_num = 1800;
+  std::vector<float> cloud;
+  cloud.reserve(3 * beam_num * point_num);
+  for (int beam = 0; beam < beam_num; ++beam) {
+    const float range =
+        3.f + 107.f * std::pow(static_cast<float>(beam) / beam_num, 2.f);
+    for (int i = 0; i < point_num; ++i) {
+      const float angle = 2.f * static_cast<float>(M_PI) * i / point_num;
+      const float x = range * std::cos(angle);
+      const float y = range * std::sin(angle);
+      const float world_x = x + kFrameStep * frame;
+      float z = -1.8f + 0.02f * world_x + 0.5f * std::sin(world_x / 30.f) +
+                0.01f * y + noise(random);
+      if (uniform(random) < 0.15f) {
+        z += 0.3f + 2.f * uniform(random);
+      }
+      cloud.push_back(x);
+      cloud.push_back(y);
+      cloud.push_back(z);
+    }
+  }
+  return cloud;
+}
+
+void BM_PlaneFitGroundDetect(benchmark::State& state) {
+  PlaneFitGroundDetectorParam param;
+  param.roi_region_rad_x = 120.f;
+  param.roi_region_rad_y = 120.f;
+  param.roi_region_rad_z = 120.f;
+  param.nr_grids_coarse = 16;
+  param.nr_smooth_iter = 5;
+  param.nr_threads = static_cast<unsigned int>(state.range(0));
+  param.use_warm_start = state.range(1) != 0;
+  PlaneFitGroundDetector detector(param);
+  if (!detector.Init()) {
+    state.SkipWithError("failed to init the detector");
+    return;
+  }
+  std::vector<std::vector<float>> clouds;
+  for (int frame = 0; frame < kFrameNum; ++frame) {
+    clouds.push_back(LidarCloud(frame));
+  }
+  const unsigned int nr_points =
+      static_cast<unsigned int>(clouds[0].size() / 3);
+  std::vector<float> heights(nr_points);
+  size_t frame = 0;
+  double ground_points = 0.0;
+  for (auto _ : state) {
+    const int frame_id = static_cast<int>(frame++ % kFrameNum);
+    const std::vector<float>& cloud = clouds[frame_id];
+    if (param.use_warm_start) {
+      // back to the first frame after the last one
+      const float step = frame_id > 0 ? kFrameStep
+                                      : -kFrameStep * (kFrameNum - 1);
+      const float translation[3] = {step, 0.f, 0.f};
+      detector.TranslateGroundPlanes(translation);
+    }
+    detector.Detect(cloud.data(), heights.data(), nr_points, 3);
+    for (const float height : heights) {
+      ground_points += std::abs(height) < 0.25f;
+    }
+  }
+  state.counters["points"] = static_cast<double>(nr_points);
+  state.counters["ground_points"] =
+      benchmark::Counter(ground_points, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PlaneFitGroundDetect)
+    ->ArgNames({"threads", "warm_start"})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({2, 1})
+    ->Args({4, 1})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace algorithm
+}  // namespace perception
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
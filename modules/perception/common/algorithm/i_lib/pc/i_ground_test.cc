@@ -0,0 +1,162 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/algorithm/i_lib/pc/i_ground.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace algorithm {
+
+// a lidar frame on a sloped and rolling ground, a part of the points are
+// above the ground; offset_x moves the lidar along x
+std::vector<float> MockCloud(int seed, float offset_x) {
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<float> uniform(0.f, 1.f);
+  std::normal_distribution<float> noise(0.f, 0.03f);
+  std::vector<float> cloud;
+  for (int beam = 0; beam < 32; ++beam) {
+    const float range = 3.f + 100.f * std::pow(beam / 31.f, 2.f);
+    for (int i = 0; i < 900; ++i) {
+      const float angle = 2.f * static_cast<float>(M_PI) * i / 900;
+      const float x = range * std::cos(angle);
+      const float y = range * std::sin(angle);
+      const float world_x = x + offset_x;
+      float z = -1.8f + 0.02f * world_x + 0.5f * std::sin(world_x / 30.f) +
+                0.01f * y + noise(random);
+      if (uniform(random) < 0.15f) {
+        z += 0.3f + 2.f * uniform(random);
+      }
+      cloud.push_back(x);
+      cloud.push_back(y);
+      cloud.push_back(z);
+    }
+  }
+  return cloud;
+}
+
+PlaneFitGroundDetectorParam MockParam(unsigned int nr_threads,
+                                      bool use_warm_start) {
+  PlaneFitGroundDetectorParam param;
+  param.roi_region_rad_x = 120.f;
+  param.roi_region_rad_y = 120.f;
+  param.roi_region_rad_z = 120.f;
+  param.nr_grids_coarse = 16;
+  param.nr_smooth_iter = 5;
+  param.nr_threads = nr_threads;
+  param.use_warm_start = use_warm_start;
+  return param;
+}
+
+std::vector<float> Detect(const std::vector<float>& cloud,
+                          PlaneFitGroundDetector* detector) {
+  const unsigned int nr_points = static_cast<unsigned int>(cloud.size() / 3);
+  std::vector<float> heights(nr_points);
+  EXPECT_TRUE(detector->Detect(cloud.data(), heights.data(), nr_points, 3));
+  return heights;
+}
+
+size_t CountGround(const std::vector<float>& heights) {
+  size_t ground_num = 0;
+  for (const float height : heights) {
+    ground_num += std::abs(height) < 0.25f;
+  }
+  return ground_num;
+}
+
+TEST(PlaneFitGroundDetectorTest, thread_num_test) {
+  const PlaneFitGroundDetectorParam param = MockParam(1, true);
+  PlaneFitGroundDetector detector(param);
+  ASSERT_TRUE(detector.Init());
+  std::vector<std::vector<float>> heights;
+  for (int frame = 0; frame < 3; ++frame) {
+    heights.push_back(Detect(MockCloud(frame, 1.5f * frame), &detector));
+    const float translation[3] = {1.5f, 0.f, 0.f};
+    detector.TranslateGroundPlanes(translation);
+  }
+  EXPECT_GT(CountGround(heights[0]), heights[0].size() / 2);
+
+  for (const unsigned int nr_threads : {2u, 3u, 4u, 8u}) {
+    const PlaneFitGroundDetectorParam thread_param =
+        MockParam(nr_threads, true);
+    PlaneFitGroundDetector thread_detector(thread_param);
+    ASSERT_TRUE(thread_detector.Init());
+    for (int frame = 0; frame < 3; ++frame) {
+      EXPECT_EQ(Detect(MockCloud(frame, 1.5f * frame), &thread_detector),
+                heights[frame])
+          << nr_threads << " " << frame;
+      const float translation[3] = {1.5f, 0.f, 0.f};
+      thread_detector.TranslateGroundPlanes(translation);
+    }
+  }
+}
+
+TEST(PlaneFitGroundDetectorTest, warm_start_test) {
+  const PlaneFitGroundDetectorParam param = MockParam(2, true);
+  PlaneFitGroundDetector detector(param);
+  ASSERT_TRUE(detector.Init());
+  const std::vector<float> cloud = MockCloud(0, 0.f);
+  const size_t ground_num = CountGround(Detect(cloud, &detector));
+
+  // the origin of the next frame is 0.5 m higher
+  std::vector<float> points;
+  std::vector<const GroundPlaneLiDAR*> planes;
+  for (unsigned int r = 0; r < detector.GetGridDimY(); ++r) {
+    for (unsigned int c = 0; c < detector.GetGridDimX(); ++c) {
+      const GroundPlaneLiDAR* plane = detector.GetGroundPlane(r, c);
+      if (plane->IsValid()) {
+        // a point on the plane below the center of the lidar
+        points.push_back(-plane->params[3] / plane->params[2]);
+        planes.push_back(plane);
+      }
+    }
+  }
+  ASSERT_GT(planes.size(), 100);
+  const float translation[3] = {0.f, 0.f, 0.5f};
+  detector.TranslateGroundPlanes(translation);
+  for (size_t i = 0; i < planes.size(); ++i) {
+    const float point[3] = {0.f, 0.f, points[i] - 0.5f};
+    EXPECT_NEAR(IPlaneToPointSignedDistanceWUnitNorm(planes[i]->params, point),
+                0.f, 1e-4f);
+  }
+
+  // the warm started planes give the same ground
+  std::vector<float> moved_cloud = cloud;
+  for (size_t i = 2; i < moved_cloud.size(); i += 3) {
+    moved_cloud[i] -= 0.5f;
+  }
+  const size_t moved_ground_num = CountGround(Detect(moved_cloud, &detector));
+  EXPECT_NEAR(static_cast<double>(moved_ground_num),
+              static_cast<double>(ground_num), 0.01 * ground_num);
+
+  // the grids cover other ground after moving by more than a grid
+  const float far_translation[3] = {40.f, 0.f, 0.f};
+  detector.TranslateGroundPlanes(far_translation);
+  for (unsigned int r = 0; r < detector.GetGridDimY(); ++r) {
+    for (unsigned int c = 0; c < detector.GetGridDimX(); ++c) {
+      EXPECT_FALSE(detector.GetGroundPlane(r, c)->IsValid());
+    }
+  }
+}
+
+}  // namespace algorithm
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,338 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "Eigen/Dense"
+
+#include "modules/perception/common/base/point.h"
+#include "modules/perception/common/base/point_cloud.h"
+
+namespace apollo {
+namespace perception {
+namespace base {
+
+// @brief column of a SoaPointCloud, aligned for vectorized loads
+template <typename T>
+using PointColumn = std::vector<T, Eigen::aligned_allocator<T>>;
+
+// @brief point selection, one byte per point, nonzero selects the point
+typedef std::vector<uint8_t> PointMask;
+
+// @brief Point cloud storing every coordinate and attribute in its own
+// column, the attributes are the ones of AttributePointCloud. A loop over
+// a few columns only loads what it uses and vectorizes, points are selected
+// with a PointMask instead of an index vector.
+template <typename T>
+class SoaPointCloud {
+ public:
+  using Type = T;
+  // @brief default constructor
+  SoaPointCloud() = default;
+  // @brief construct from a point cloud
+  template <typename PointT>
+  explicit SoaPointCloud(const AttributePointCloud<PointT>& pc) {
+    FromPointCloud(pc);
+  }
+  // @brief destructor
+  ~SoaPointCloud() = default;
+
+  // @brief accessor of point size
+  inline size_t size() const { return x_.size(); }
+  // @brief whether the cloud has no point
+  inline bool empty() const { return x_.empty(); }
+  // @brief reserve all columns
+  inline void reserve(size_t size) {
+    x_.reserve(size);
+    y_.reserve(size);
+    z_.reserve(size);
+    intensity_.reserve(size);
+    points_timestamp_.reserve(size);
+    points_height_.reserve(size);
+    points_beam_id_.reserve(size);
+    points_label_.reserve(size);
+    points_semantic_label_.reserve(size);
+  }
+  // @brief resize all columns, new points get the default attributes
+  inline void resize(size_t size) {
+    x_.resize(size, 0);
+    y_.resize(size, 0);
+    z_.resize(size, 0);
+    intensity_.resize(size, 0);
+    points_timestamp_.resize(size, 0.0);
+    points_height_.resize(size, std::numeric_limits<float>::max());
+    points_beam_id_.resize(size, -1);
+    points_label_.resize(size, 0);
+    points_semantic_label_.resize(size, 0);
+  }
+  // @brief clear all columns
+  inline void clear() { resize(0); }
+  // @brief append a point and its attributes
+  inline void push_back(const Point<T>& point, double timestamp = 0.0,
+                        float height = std::numeric_limits<float>::max(),
+                        int32_t beam_id = -1, uint8_t label = 0,
+                        uint8_t semantic_label = 0) {
+    x_.push_back(point.x);
+    y_.push_back(point.y);
+    z_.push_back(point.z);
+    intensity_.push_back(point.intensity);
+    points_timestamp_.push_back(timestamp);
+    points_height_.push_back(height);
+    points_beam_id_.push_back(beam_id);
+    points_label_.push_back(label);
+    points_semantic_label_.push_back(semantic_label);
+  }
+  // @brief gather the coordinates of a point
+  inline Point<T> point(size_t i) const {
+    Point<T> point;
+    point.x = x_[i];
+    point.y = y_[i];
+    point.z = z_[i];
+    point.intensity = intensity_[i];
+    return point;
+  }
+
+  // @brief replace the points with the ones of an AttributePointCloud
+  template <typename PointT>
+  void FromPointCloud(const AttributePointCloud<PointT>& pc) {
+    const size_t size = pc.size();
+    x_.resize(size);
+    y_.resize(size);
+    z_.resize(size);
+    intensity_.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      const PointT& point = pc[i];
+      x_[i] = static_cast<T>(point.x);
+      y_[i] = static_cast<T>(point.y);
+      z_[i] = static_cast<T>(point.z);
+      intensity_[i] = static_cast<T>(point.intensity);
+    }
+    points_timestamp_.assign(pc.points_timestamp().begin(),
+                             pc.points_timestamp().end());
+    points_height_.assign(pc.points_height().begin(),
+                          pc.points_height().end());
+    points_beam_id_.assign(pc.points_beam_id().begin(),
+                           pc.points_beam_id().end());
+    points_label_.assign(pc.points_label().begin(), pc.points_label().end());
+    points_semantic_label_.assign(pc.points_semantic_label().begin(),
+                                  pc.points_semantic_label().end());
+    timestamp_ = pc.get_timestamp();
+  }
+  // @brief replace the points of an AttributePointCloud with these ones,
+  // so the plugins taking AttributePointCloud can consume the cloud
+  template <typename PointT>
+  void ToPointCloud(AttributePointCloud<PointT>* pc) const {
+    pc->resize(size());
+    for (size_t i = 0; i < size(); ++i) {
+      PointT& point = pc->at(i);
+      point.x = static_cast<typename PointT::Type>(x_[i]);
+      point.y = static_cast<typename PointT::Type>(y_[i]);
+      point.z = static_cast<typename PointT::Type>(z_[i]);
+      point.intensity = static_cast<typename PointT::Type>(intensity_[i]);
+    }
+    pc->mutable_points_timestamp()->assign(points_timestamp_.begin(),
+                                           points_timestamp_.end());
+    pc->mutable_points_height()->assign(points_height_.begin(),
+                                        points_height_.end());
+    pc->mutable_points_beam_id()->assign(points_beam_id_.begin(),
+                                         points_beam_id_.end());
+    pc->mutable_points_label()->assign(points_label_.begin(),
+                                       points_label_.end());
+    pc->mutable_points_semantic_label()->assign(
+        points_semantic_label_.begin(), points_semantic_label_.end());
+    pc->set_timestamp(timestamp_);
+  }
+
+  // @brief keep the points selected by mask, in their order, the mask has
+  // one value per point
+  void Compact(const PointMask& mask) { CopyPointCloud(*this, mask); }
+  // @brief copy the points of rhs selected by mask, in their order
+  void CopyPointCloud(const SoaPointCloud<T>& rhs, const PointMask& mask) {
+    SelectColumn(mask, rhs.x_, &x_);
+    SelectColumn(mask, rhs.y_, &y_);
+    SelectColumn(mask, rhs.z_, &z_);
+    SelectColumn(mask, rhs.intensity_, &intensity_);
+    SelectColumn(mask, rhs.points_timestamp_, &points_timestamp_);
+    SelectColumn(mask, rhs.points_height_, &points_height_);
+    SelectColumn(mask, rhs.points_beam_id_, &points_beam_id_);
+    SelectColumn(mask, rhs.points_label_, &points_label_);
+    SelectColumn(mask, rhs.points_semantic_label_, &points_semantic_label_);
+    timestamp_ = rhs.timestamp_;
+  }
+
+  // @brief transform the coordinates with pose into out, the attributes
+  // are copied
+  template <typename OutT>
+  void TransformPointCloud(const Eigen::Affine3d& pose,
+                           SoaPointCloud<OutT>* out) const {
+    const size_t size = this->size();
+    out->resize(size);
+    const Eigen::Matrix3d r = pose.linear();
+    const Eigen::Vector3d t = pose.translation();
+    const T* x = x_.data();
+    const T* y = y_.data();
+    const T* z = z_.data();
+    OutT* out_x = out->mutable_points_x()->data();
+    OutT* out_y = out->mutable_points_y()->data();
+    OutT* out_z = out->mutable_points_z()->data();
+    for (size_t i = 0; i < size; ++i) {
+      const double px = static_cast<double>(x[i]);
+      const double py = static_cast<double>(y[i]);
+      const double pz = static_cast<double>(z[i]);
+      out_x[i] = static_cast<OutT>(r(0, 0) * px + r(0, 1) * py +
+                                   r(0, 2) * pz + t(0));
+      out_y[i] = static_cast<OutT>(r(1, 0) * px + r(1, 1) * py +
+                                   r(1, 2) * pz + t(1));
+      out_z[i] = static_cast<OutT>(r(2, 0) * px + r(2, 1) * py +
+                                   r(2, 2) * pz + t(2));
+    }
+    OutT* out_intensity = out->mutable_points_intensity()->data();
+    for (size_t i = 0; i < size; ++i) {
+      out_intensity[i] = static_cast<OutT>(intensity_[i]);
+    }
+    *out->mutable_points_timestamp() = points_timestamp_;
+    *out->mutable_points_height() = points_height_;
+    *out->mutable_points_beam_id() = points_beam_id_;
+    *out->mutable_points_label() = points_label_;
+    *out->mutable_points_semantic_label() = points_semantic_label_;
+    out->set_timestamp(timestamp_);
+  }
+
+  // @brief check data member consistency
+  bool CheckConsistency() const {
+    return y_.size() == x_.size() && z_.size() == x_.size() &&
+           intensity_.size() == x_.size() &&
+           points_timestamp_.size() == x_.size() &&
+           points_height_.size() == x_.size() &&
+           points_beam_id_.size() == x_.size() &&
+           points_label_.size() == x_.size() &&
+           points_semantic_label_.size() == x_.size();
+  }
+
+  // @brief cloud timestamp setter
+  void set_timestamp(const double timestamp) { timestamp_ = timestamp; }
+  // @brief cloud timestamp getter
+  double get_timestamp() const { return timestamp_; }
+
+  // @brief column accessors, resizing a single column breaks the
+  // consistency of the cloud
+  const PointColumn<T>& points_x() const { return x_; }
+  PointColumn<T>* mutable_points_x() { return &x_; }
+  const PointColumn<T>& points_y() const { return y_; }
+  PointColumn<T>* mutable_points_y() { return &y_; }
+  const PointColumn<T>& points_z() const { return z_; }
+  PointColumn<T>* mutable_points_z() { return &z_; }
+  const PointColumn<T>& points_intensity() const { return intensity_; }
+  PointColumn<T>* mutable_points_intensity() { return &intensity_; }
+  const PointColumn<double>& points_timestamp() const {
+    return points_timestamp_;
+  }
+  PointColumn<double>* mutable_points_timestamp() {
+    return &points_timestamp_;
+  }
+  const PointColumn<float>& points_height() const { return points_height_; }
+  PointColumn<float>* mutable_points_height() { return &points_height_; }
+  const PointColumn<int32_t>& points_beam_id() const {
+    return points_beam_id_;
+  }
+  PointColumn<int32_t>* mutable_points_beam_id() { return &points_beam_id_; }
+  const PointColumn<uint8_t>& points_label() const { return points_label_; }
+  PointColumn<uint8_t>* mutable_points_label() { return &points_label_; }
+  const PointColumn<uint8_t>& points_semantic_label() const {
+    return points_semantic_label_;
+  }
+  PointColumn<uint8_t>* mutable_points_semantic_label() {
+    return &points_semantic_label_;
+  }
+
+ private:
+  // @brief write the values of in selected by mask to out, out may be in
+  template <typename ValueT>
+  static void SelectColumn(const PointMask& mask,
+                           const PointColumn<ValueT>& in,
+                           PointColumn<ValueT>* out) {
+    const size_t size = in.size();
+    out->resize(size);
+    const ValueT* in_values = in.data();
+    ValueT* out_values = out->data();
+    size_t count = 0;
+    // no branch, a value is overwritten by the next one unless selected
+    for (size_t i = 0; i < size; ++i) {
+      out_values[count] = in_values[i];
+      count += mask[i] != 0;
+    }
+    out->resize(count);
+  }
+
+  PointColumn<T> x_;
+  PointColumn<T> y_;
+  PointColumn<T> z_;
+  PointColumn<T> intensity_;
+  PointColumn<double> points_timestamp_;
+  PointColumn<float> points_height_;
+  PointColumn<int32_t> points_beam_id_;
+  PointColumn<uint8_t> points_label_;
+  PointColumn<uint8_t> points_semantic_label_;
+
+  double timestamp_ = 0.0;
+};
+
+// @brief number of points selected by mask
+inline size_t MaskCount(const PointMask& mask) {
+  size_t count = 0;
+  for (const uint8_t selected : mask) {
+    count += selected != 0;
+  }
+  return count;
+}
+
+// @brief indices of the points selected by mask, for the plugins taking
+// PointIndices
+inline void MaskToIndices(const PointMask& mask, PointIndices* indices) {
+  indices->indices.clear();
+  for (size_t i = 0; i < mask.size(); ++i) {
+    if (mask[i] != 0) {
+      indices->indices.push_back(static_cast<int>(i));
+    }
+  }
+}
+
+// @brief mask of size points selecting indices
+inline void IndicesToMask(const PointIndices& indices, size_t size,
+                          PointMask* mask) {
+  mask->assign(size, 0);
+  for (const int id : indices.indices) {
+    (*mask)[id] = 1;
+  }
+}
+
+typedef SoaPointCloud<float> SoaPointFCloud;
+typedef SoaPointCloud<double> SoaPointDCloud;
+
+typedef std::shared_ptr<SoaPointFCloud> SoaPointFCloudPtr;
+typedef std::shared_ptr<const SoaPointFCloud> SoaPointFCloudConstPtr;
+
+typedef std::shared_ptr<SoaPointDCloud> SoaPointDCloudPtr;
+typedef std::shared_ptr<const SoaPointDCloud> SoaPointDCloudConstPtr;
+
+}  // namespace base
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,142 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/base/soa_point_cloud.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace base {
+
+void MockPointCloud(PointFCloud* cloud) {
+  for (size_t i = 0; i < 5; ++i) {
+    PointF point;
+    point.x = static_cast<float>(i);
+    point.y = static_cast<float>(i) + 0.5f;
+    point.z = -static_cast<float>(i);
+    point.intensity = 10.f * static_cast<float>(i);
+    cloud->push_back(point, 0.1 * static_cast<double>(i),
+                     static_cast<float>(i), static_cast<int32_t>(i),
+                     static_cast<uint8_t>(i), static_cast<uint8_t>(i + 1));
+  }
+  cloud->set_timestamp(1.5);
+}
+
+TEST(SoaPointCloudTest, point_cloud_adapter_test) {
+  PointFCloud cloud;
+  MockPointCloud(&cloud);
+  SoaPointFCloud soa_cloud(cloud);
+  EXPECT_EQ(soa_cloud.size(), 5);
+  EXPECT_TRUE(soa_cloud.CheckConsistency());
+  EXPECT_DOUBLE_EQ(soa_cloud.get_timestamp(), 1.5);
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    EXPECT_EQ(soa_cloud.points_x()[i], cloud[i].x);
+    EXPECT_EQ(soa_cloud.points_y()[i], cloud[i].y);
+    EXPECT_EQ(soa_cloud.points_z()[i], cloud[i].z);
+    EXPECT_EQ(soa_cloud.points_intensity()[i], cloud[i].intensity);
+    EXPECT_EQ(soa_cloud.points_timestamp()[i], cloud.points_timestamp(i));
+    EXPECT_EQ(soa_cloud.points_height()[i], cloud.points_height(i));
+    EXPECT_EQ(soa_cloud.points_beam_id()[i], cloud.points_beam_id(i));
+    EXPECT_EQ(soa_cloud.points_label()[i], cloud.points_label(i));
+    EXPECT_EQ(soa_cloud.points_semantic_label()[i],
+              cloud.points_semantic_label(i));
+  }
+
+  PointDCloud double_cloud;
+  double_cloud.push_back(PointD());
+  soa_cloud.ToPointCloud(&double_cloud);
+  EXPECT_EQ(double_cloud.size(), 5);
+  EXPECT_TRUE(double_cloud.CheckConsistency());
+  EXPECT_DOUBLE_EQ(double_cloud.get_timestamp(), 1.5);
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    EXPECT_EQ(double_cloud[i].x, cloud[i].x);
+    EXPECT_EQ(double_cloud[i].y, cloud[i].y);
+    EXPECT_EQ(double_cloud[i].z, cloud[i].z);
+    EXPECT_EQ(double_cloud[i].intensity, cloud[i].intensity);
+    EXPECT_EQ(double_cloud.points_timestamp(i), cloud.points_timestamp(i));
+    EXPECT_EQ(double_cloud.points_beam_id(i), cloud.points_beam_id(i));
+    EXPECT_EQ(double_cloud.points_semantic_label(i),
+              cloud.points_semantic_label(i));
+  }
+}
+
+TEST(SoaPointCloudTest, mask_test) {
+  PointFCloud cloud;
+  MockPointCloud(&cloud);
+  SoaPointFCloud soa_cloud(cloud);
+  PointMask mask = {0, 1, 0, 1, 1};
+  EXPECT_EQ(MaskCount(mask), 3);
+
+  SoaPointFCloud selected_cloud;
+  selected_cloud.CopyPointCloud(soa_cloud, mask);
+  EXPECT_EQ(soa_cloud.size(), 5);
+  soa_cloud.Compact(mask);
+  EXPECT_TRUE(soa_cloud.CheckConsistency());
+  ASSERT_EQ(soa_cloud.size(), 3);
+  ASSERT_EQ(selected_cloud.size(), 3);
+
+  // the same points as the ones copied by indices
+  PointIndices indices;
+  MaskToIndices(mask, &indices);
+  EXPECT_EQ(indices.indices, std::vector<int>({1, 3, 4}));
+  PointFCloud indexed_cloud(cloud, indices);
+  for (size_t i = 0; i < indexed_cloud.size(); ++i) {
+    EXPECT_EQ(soa_cloud.points_x()[i], indexed_cloud[i].x);
+    EXPECT_EQ(soa_cloud.points_intensity()[i], indexed_cloud[i].intensity);
+    EXPECT_EQ(soa_cloud.points_timestamp()[i],
+              indexed_cloud.points_timestamp(i));
+    EXPECT_EQ(soa_cloud.points_beam_id()[i], indexed_cloud.points_beam_id(i));
+    EXPECT_EQ(selected_cloud.points_y()[i], indexed_cloud[i].y);
+    EXPECT_EQ(selected_cloud.points_label()[i],
+              indexed_cloud.points_label(i));
+  }
+
+  PointMask indices_mask;
+  IndicesToMask(indices, 5, &indices_mask);
+  EXPECT_EQ(indices_mask, mask);
+
+  soa_cloud.Compact(PointMask(3, 0));
+  EXPECT_TRUE(soa_cloud.empty());
+  EXPECT_TRUE(soa_cloud.CheckConsistency());
+}
+
+TEST(SoaPointCloudTest, transform_test) {
+  PointFCloud cloud;
+  MockPointCloud(&cloud);
+  SoaPointFCloud soa_cloud(cloud);
+  Eigen::Affine3d pose = Eigen::Affine3d::Identity();
+  pose.rotate(Eigen::AngleAxisd(0.3, Eigen::Vector3d(0.0, 0.6, 0.8)));
+  pose.translation() << 100.0, -20.0, 3.0;
+
+  SoaPointDCloud world_cloud;
+  soa_cloud.TransformPointCloud(pose, &world_cloud);
+  EXPECT_TRUE(world_cloud.CheckConsistency());
+  ASSERT_EQ(world_cloud.size(), cloud.size());
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    const Eigen::Vector3d expected =
+        pose * Eigen::Vector3d(cloud[i].x, cloud[i].y, cloud[i].z);
+    EXPECT_NEAR(world_cloud.points_x()[i], expected(0), 1e-9);
+    EXPECT_NEAR(world_cloud.points_y()[i], expected(1), 1e-9);
+    EXPECT_NEAR(world_cloud.points_z()[i], expected(2), 1e-9);
+    EXPECT_EQ(world_cloud.points_intensity()[i], cloud[i].intensity);
+    EXPECT_EQ(world_cloud.points_beam_id()[i], cloud.points_beam_id(i));
+  }
+}
+
+}  // namespace base
+}  // namespace perception
+}  // namespace apollo
@@ -29,6 +29,12 @@ DEFINE_bool(obs_benchmark_mode, false,
 DEFINE_bool(obs_save_fusion_supplement, false,
             "whether save fusion supplement data, default false");
 DEFINE_bool(start_visualizer, false, "Whether to start visualizer");
+DEFINE_double(obs_lidar_latency_budget, 100.0,
+              "ms from the sensor time to the end of lidar tracking, a frame "
+              "beyond is reported");
+DEFINE_bool(obs_require_intra_process_transport, false,
+            "fail the init of the lidar components writing inner messages "
+            "if the same process transport is not intra");
 
 }  // namespace onboard
 }  // namespace perception
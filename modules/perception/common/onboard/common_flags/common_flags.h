@@ -26,6 +26,8 @@ DECLARE_bool(obs_enable_visualization);
 DECLARE_string(obs_screen_output_dir);
 DECLARE_bool(obs_benchmark_mode);
 DECLARE_bool(obs_save_fusion_supplement);
+DECLARE_double(obs_lidar_latency_budget);
+DECLARE_bool(obs_require_intra_process_transport);
 DECLARE_bool(start_visualizer);
 
 }  // namespace onboard
@@ -17,7 +17,9 @@
 
 #include <string>
 
+#include "cyber/common/global_data.h"
 #include "cyber/cyber.h"
+#include "modules/perception/common/onboard/common_flags/common_flags.h"
 #include "modules/perception/common/base/frame.h"
 #include "modules/perception/common/base/hdmap_struct.h"
 #include "modules/perception/common/base/impending_collision_edge.h"
@@ -41,6 +43,32 @@ enum class ProcessStage {
   PROCESSSTAGE_COUNT = 10
 };
 
+// The inner component messages hold shared pointers to the pooled frames and
+// have no serializer, they only reach the readers of the same process, to
+// which cyber hands the written pointer itself when the same process
+// transport is intra. Check it before writing them, it only fails with
+// obs_require_intra_process_transport, otherwise it warns.
+inline bool CheckIntraProcessTransport(const std::string& channel_name) {
+  const auto same_proc = cyber::common::GlobalData::Instance()
+                             ->Config()
+                             .transport_conf()
+                             .communication_mode()
+                             .same_proc();
+  if (same_proc == cyber::proto::OptionalMode::INTRA) {
+    return true;
+  }
+  if (FLAGS_obs_require_intra_process_transport) {
+    AERROR << "Channel " << channel_name << " needs the intra process "
+           << "transport, same_proc is "
+           << cyber::proto::OptionalMode_Name(same_proc);
+    return false;
+  }
+  AWARN << "Channel " << channel_name << " expects the intra process "
+        << "transport, same_proc is "
+        << cyber::proto::OptionalMode_Name(same_proc);
+  return true;
+}
+
 class Descriptor {
  public:
   std::string full_name() { return "name"; }
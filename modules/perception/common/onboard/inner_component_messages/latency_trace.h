@@ -0,0 +1,98 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+
+// @brief times of a stage of the processing of a frame, in seconds
+struct StageLatency {
+  std::string name;
+  double start_time = 0.0;
+  double end_time = 0.0;
+};
+
+// @brief stages a frame went through, from the sensor time on. Each stage
+// waits for the previous one to hand the frame over, the wait is the time
+// between the end of the previous stage and the start of the stage.
+class LatencyTrace {
+ public:
+  LatencyTrace() = default;
+  ~LatencyTrace() = default;
+
+  // @brief clear the stages of a frame measured at sensor_time
+  void Reset(double sensor_time) {
+    sensor_time_ = sensor_time;
+    stages_.clear();
+  }
+
+  // @brief start a stage, a started stage which is not ended is replaced
+  void BeginStage(const std::string& name, double time) {
+    if (!stages_.empty() && stages_.back().end_time <= 0.0) {
+      stages_.pop_back();
+    }
+    stages_.emplace_back();
+    stages_.back().name = name;
+    stages_.back().start_time = time;
+  }
+
+  // @brief end the last started stage
+  void EndStage(double time) {
+    if (!stages_.empty()) {
+      stages_.back().end_time = time;
+    }
+  }
+
+  double sensor_time() const { return sensor_time_; }
+  const std::vector<StageLatency>& stages() const { return stages_; }
+
+  // @brief time from the sensor time to the end of the last stage, in ms
+  double TotalLatency() const {
+    if (stages_.empty()) {
+      return 0.0;
+    }
+    return (stages_.back().end_time - sensor_time_) * 1e3;
+  }
+
+  // @brief "stage[wait_ms,proc_ms]" for each stage, the wait of the first
+  // stage is from the sensor time on
+  std::string ToString() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    double last_time = sensor_time_;
+    for (const auto& stage : stages_) {
+      oss << stage.name << "[" << (stage.start_time - last_time) * 1e3 << ","
+          << (stage.end_time - stage.start_time) * 1e3 << "]:";
+      last_time = stage.end_time;
+    }
+    oss << "total[" << TotalLatency() << "]";
+    return oss.str();
+  }
+
+ private:
+  double sensor_time_ = 0.0;
+  std::vector<StageLatency> stages_;
+};
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
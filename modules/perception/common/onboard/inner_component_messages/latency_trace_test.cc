@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/common/onboard/inner_component_messages/latency_trace.h"
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace onboard {
+
+TEST(LatencyTraceTest, stage_test) {
+  LatencyTrace trace;
+  trace.Reset(10.0);
+  EXPECT_EQ(trace.sensor_time(), 10.0);
+  EXPECT_TRUE(trace.stages().empty());
+  EXPECT_EQ(trace.TotalLatency(), 0.0);
+
+  trace.BeginStage("preprocess", 10.010);
+  trace.EndStage(10.015);
+  trace.BeginStage("ground", 10.020);
+  trace.EndStage(10.030);
+  ASSERT_EQ(trace.stages().size(), 2);
+  EXPECT_EQ(trace.stages()[0].name, "preprocess");
+  EXPECT_EQ(trace.stages()[1].name, "ground");
+  EXPECT_DOUBLE_EQ(trace.stages()[1].start_time, 10.020);
+  EXPECT_DOUBLE_EQ(trace.stages()[1].end_time, 10.030);
+  EXPECT_NEAR(trace.TotalLatency(), 30.0, 1e-6);
+
+  // a frame is reset for the next sensor time
+  trace.Reset(11.0);
+  EXPECT_TRUE(trace.stages().empty());
+  EXPECT_EQ(trace.TotalLatency(), 0.0);
+}
+
+TEST(LatencyTraceTest, missing_end_test) {
+  LatencyTrace trace;
+  trace.Reset(10.0);
+  // a stage which failed before its end is replaced by the next one
+  trace.BeginStage("detection", 10.010);
+  trace.BeginStage("detection", 10.050);
+  trace.EndStage(10.060);
+  ASSERT_EQ(trace.stages().size(), 1);
+  EXPECT_DOUBLE_EQ(trace.stages()[0].start_time, 10.050);
+
+  // the last stage is not ended yet
+  trace.BeginStage("tracking", 10.070);
+  ASSERT_EQ(trace.stages().size(), 2);
+  EXPECT_EQ(trace.stages()[1].end_time, 0.0);
+
+  // an end without a stage is ignored
+  LatencyTrace empty_trace;
+  empty_trace.EndStage(1.0);
+  EXPECT_TRUE(empty_trace.stages().empty());
+}
+
+TEST(LatencyTraceTest, to_string_test) {
+  LatencyTrace trace;
+  trace.Reset(10.0);
+  EXPECT_EQ(trace.ToString(), "total[0.000]");
+  trace.BeginStage("preprocess", 10.010);
+  trace.EndStage(10.015);
+  trace.BeginStage("ground", 10.020);
+  trace.EndStage(10.030);
+  // the wait of a stage is from the end of the last one
+  EXPECT_EQ(trace.ToString(),
+            "preprocess[10.000,5.000]:ground[5.000,10.000]:total[30.000]");
+}
+
+}  // namespace onboard
+}  // namespace perception
+}  // namespace apollo
@@ -21,6 +21,7 @@
 #include "cyber/cyber.h"
 #include "modules/perception/common/lidar/common/lidar_frame.h"
 #include "modules/perception/common/onboard/inner_component_messages/inner_component_messages.h"
+#include "modules/perception/common/onboard/inner_component_messages/latency_trace.h"
 #include "modules/common_msgs/perception_msgs/perception_obstacle.pb.h"
 
 namespace apollo {
@@ -47,6 +48,7 @@ class LidarFrameMessage {
   ProcessStage process_stage_ = ProcessStage::UNKNOWN_STAGE;
   apollo::common::ErrorCode error_code_ = apollo::common::ErrorCode::OK;
   std::shared_ptr<lidar::LidarFrame> lidar_frame_;
+  LatencyTrace latency_trace_;
 };
 
 }  // namespace onboard
@@ -125,6 +125,8 @@ bool CNNSegmentation::InitClusterAndBackgroundSegmentation() {
   SppParams params;
   params.height_gap = model_param_.engine_config().height_gap();
   params.confidence_range = model_param_.confidence_range();
+  params.cc_thread_num =
+      static_cast<int>(model_param_.engine_config().cc_thread_num());
 
   // init spp data
   auto& spp_data = spp_engine_.GetSppData();
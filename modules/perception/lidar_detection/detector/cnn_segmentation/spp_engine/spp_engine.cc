@@ -27,6 +27,7 @@ void SppEngine::Init(size_t width, size_t height, float range,
                      const SppParams& param, const std::string& sensor_name) {
   // initialize connect component detector
   detector_2d_cc_.Init(static_cast<int>(height), static_cast<int>(width));
+  detector_2d_cc_.SetThreadNum(param.cc_thread_num);
   detector_2d_cc_.SetData(data_.obs_prob_data_ref, data_.offset_data,
                           static_cast<float>(height) / (2.f * range),
                           data_.objectness_threshold);
@@ -89,7 +90,12 @@ size_t SppEngine::ProcessConnectedComponentCluster(
   // first sync between cluster list and label image,
   // and they shared the same cluster pointer
   clusters_ = labels_2d_;
-  for (size_t i = 0; i < point_cloud->size(); ++i) {
+  // label of each point, counted per cluster to write the points of each
+  // cluster in place
+  const size_t point_num = point_cloud->size();
+  point_labels_.assign(point_num, 0);
+  cluster_point_nums_.assign(clusters_.size(), 0);
+  for (size_t i = 0; i < point_num; ++i) {
     if (mask.size() && mask[static_cast<int>(i)] == 0) {
       continue;
     }
@@ -98,17 +104,34 @@ size_t SppEngine::ProcessConnectedComponentCluster(
     if (id < 0) {
       continue;
     }
-    const auto& point = point_cloud->at(i);
     const uint16_t& label = labels_2d_[0][id];
     if (!label) {
       continue;
     }
-    if (point.z <=
+    if (point_cloud->at(i).z <=
         labels_2d_.GetCluster(label - 1)->top_z + data_.top_z_threshold) {
-      clusters_.AddPointSample(label - 1, point, point_cloud->points_height(i),
-                               static_cast<uint32_t>(i));
+      point_labels_[i] = label;
+      ++cluster_point_nums_[label - 1];
     }
   }
+  for (size_t n = 0; n < clusters_.size(); ++n) {
+    auto& cluster = clusters_[static_cast<int>(n)];
+    const size_t start = cluster->points.size();
+    cluster->points.resize(start + cluster_point_nums_[n]);
+    cluster->point_ids.resize(start + cluster_point_nums_[n]);
+    cluster_point_nums_[n] = start;
+  }
+  for (size_t i = 0; i < point_num; ++i) {
+    const uint16_t label = point_labels_[i];
+    if (!label) {
+      continue;
+    }
+    auto& cluster = clusters_[label - 1];
+    const size_t index = cluster_point_nums_[label - 1]++;
+    cluster->points[index] =
+        SppPoint(point_cloud->at(i), point_cloud->points_height(i));
+    cluster->point_ids[index] = static_cast<uint32_t>(i);
+  }
   double mapping_time = timer.toc(true);
   // 5. remove empty clusters
   clusters_.RemoveEmptyClusters();
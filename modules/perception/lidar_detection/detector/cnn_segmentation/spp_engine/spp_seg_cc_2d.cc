@@ -14,6 +14,8 @@
  * limitations under the License.
  *****************************************************************************/
 #include <algorithm>
+#include <atomic>
+#include <future>
 
 #include "modules/perception/common/lidar/common/lidar_log.h"
 #include "modules/perception/common/lidar/common/lidar_timer.h"
@@ -65,47 +67,96 @@ bool SppCCDetector::CleanNodes() {
   return true;
 }
 
+void SppCCDetector::SetThreadNum(int thread_num) {
+  thread_num = std::max(thread_num, 1);
+  if (thread_num == thread_num_) {
+    return;
+  }
+  thread_num_ = thread_num;
+  thread_pool_.reset(thread_num_ > 1
+                         ? new cyber::base::ThreadPool(thread_num_ - 1)
+                         : nullptr);
+  InitBlocks();
+}
+
+void SppCCDetector::InitBlocks() {
+  const int block_rows = std::max(1, (rows_ + thread_num_ - 1) / thread_num_);
+  const int block_num = std::max(1, (rows_ + block_rows - 1) / block_rows);
+  blocks_.resize(block_num);
+  for (int i = 0; i < block_num; ++i) {
+    blocks_[i].start_row = i * block_rows;
+    blocks_[i].end_row = std::min(rows_, (i + 1) * block_rows);
+  }
+}
+
+void SppCCDetector::RunBlocks(const std::function<void(Block*)>& func) {
+  const size_t block_num = blocks_.size();
+  std::atomic<size_t> next_block(0);
+  auto run_blocks = [&]() {
+    for (size_t i = next_block++; i < block_num; i = next_block++) {
+      func(&blocks_[i]);
+    }
+  };
+  std::vector<std::future<void>> helpers;
+  if (thread_pool_ != nullptr) {
+    for (size_t i = 1; i < block_num; ++i) {
+      helpers.push_back(thread_pool_->Enqueue(run_blocks));
+    }
+  }
+  run_blocks();
+  for (auto& helper : helpers) {
+    if (helper.valid()) {
+      helper.wait();
+    }
+  }
+}
+
 size_t SppCCDetector::Detect(SppLabelImage* labels) {
   Timer timer;
   if (!first_process_) {
     worker_.Join();  // sync for cleaning nodes
   }
   first_process_ = false;
-  BuildNodes(0, rows_);
-  double init_time = timer.toc(true);
-
   double sync_time = timer.toc(true);
 
-  TraverseNodes();
-  double traverse_time = timer.toc(true);
+  RunBlocks([this](Block* block) { ProcessBlock(block); });
+  double block_time = timer.toc(true);
 
-  UnionNodes();
-  double union_time = timer.toc(true);
+  MergeBlocks();
+  double merge_time = timer.toc(true);
 
   size_t num = ToLabelMap(labels);
   worker_.WakeUp();  // for next use
   double collect_time = timer.toc(true);
 
-  AINFO << "SppSegCC2D: init: " << init_time << "\tsync: " << sync_time
-        << "\ttraverse: " << traverse_time << "\tunion: " << union_time
-        << "\tcollect: " << collect_time << "\t#obj: " << num;
+  AINFO << "SppSegCC2D: sync: " << sync_time << "\tblock: " << block_time
+        << "\tmerge: " << merge_time << "\tcollect: " << collect_time
+        << "\t#obj: " << num << "\t#block: " << blocks_.size();
 
   return num;
 }
 
-void SppCCDetector::TraverseNodes() {
-  for (int row = 0; row < rows_; row++) {
-    for (int col = 0; col < cols_; col++) {
-      Node& node = nodes_[row][col];
-      if (node.is_object() && node.get_traversed() == 0) {
-        Traverse(&node);
-      }
+void SppCCDetector::ProcessBlock(Block* block) {
+  BuildNodes(block->start_row, block->end_row);
+  TraverseNodes(block);
+  UnionNodes(*block);
+}
+
+void SppCCDetector::TraverseNodes(Block* block) {
+  block->exits.clear();
+  Node* node = nodes_[0] + block->start_row * cols_;
+  Node* end = nodes_[0] + block->end_row * cols_;
+  for (; node != end; ++node) {
+    if (node->is_object() && node->get_traversed() == 0) {
+      Traverse(node, block);
     }
   }
 }
 
-void SppCCDetector::UnionNodes() {
-  for (int row = 0; row < rows_; ++row) {
+void SppCCDetector::UnionNodes(const Block& block) {
+  // the neighbors below the last row are in the next block
+  const int last_row = block.end_row - 1;
+  for (int row = block.start_row; row < block.end_row; ++row) {
     for (int col = 0; col < cols_; ++col) {
       Node* node = &nodes_[row][col];
       if (!node->is_center()) {
@@ -120,21 +171,21 @@ void SppCCDetector::UnionNodes() {
         }
       }
       // down
-      if (row < rows_ - 1) {
+      if (row < last_row) {
         node_neighbor = &nodes_[row + 1][col];
         if (node_neighbor->is_center()) {
           DisjointSetUnion(node, node_neighbor);
         }
       }
       // right down
-      if (row < rows_ - 1 && col < cols_ - 1) {
+      if (row < last_row && col < cols_ - 1) {
         node_neighbor = &nodes_[row + 1][col + 1];
         if (node_neighbor->is_center()) {
           DisjointSetUnion(node, node_neighbor);
         }
       }
       // left down
-      if (row < rows_ - 1 && col > 0) {
+      if (row < last_row && col > 0) {
         node_neighbor = &nodes_[row + 1][col - 1];
         if (node_neighbor->is_center()) {
           DisjointSetUnion(node, node_neighbor);
@@ -144,38 +195,139 @@ void SppCCDetector::UnionNodes() {
   }
 }
 
-size_t SppCCDetector::ToLabelMap(SppLabelImage* labels) {
-  uint16_t id = 0;
-  uint32_t pixel_id = 0;
-  labels->ResetClusters(kDefaultReserveSize);
-  for (int row = 0; row < rows_; ++row) {
-    for (int col = 0; col < cols_; ++col, ++pixel_id) {
+void SppCCDetector::MergeBlocks() {
+  merge_centers_.clear();
+  for (const auto& block : blocks_) {
+    for (const uint32_t exit : block.exits) {
+      Node* node = nodes_[0] + exit;
+      if (node->get_traversed() == 3) {
+        TraverseExit(node);
+      }
+    }
+  }
+  // centers across block borders
+  for (size_t i = 1; i < blocks_.size(); ++i) {
+    const int row = blocks_[i].start_row - 1;
+    for (int col = 0; col < cols_; ++col) {
       Node* node = &nodes_[row][col];
+      if (!node->is_center()) {
+        continue;
+      }
+      for (int dc = -1; dc <= 1; ++dc) {
+        if (col + dc >= 0 && col + dc < cols_ &&
+            nodes_[row + 1][col + dc].is_center()) {
+          DisjointSetUnion(node, &nodes_[row + 1][col + dc]);
+        }
+      }
+    }
+  }
+  // centers found by the merge, on cycles across blocks
+  for (Node* node : merge_centers_) {
+    const int row = static_cast<int>(node - nodes_[0]) / cols_;
+    const int col = static_cast<int>(node - nodes_[0]) % cols_;
+    for (int r = std::max(0, row - 1); r <= std::min(rows_ - 1, row + 1);
+         ++r) {
+      for (int c = std::max(0, col - 1); c <= std::min(cols_ - 1, col + 1);
+           ++c) {
+        if (nodes_[r][c].is_center()) {
+          DisjointSetUnion(node, &nodes_[r][c]);
+        }
+      }
+    }
+  }
+}
+
+size_t SppCCDetector::ToLabelMap(SppLabelImage* labels) {
+  // roots of the object nodes
+  RunBlocks([this](Block* block) {
+    block->roots.clear();
+    const uint32_t end = static_cast<uint32_t>(block->end_row * cols_);
+    uint32_t last_root = 0;
+    for (uint32_t pixel_id = static_cast<uint32_t>(block->start_row * cols_);
+         pixel_id < end; ++pixel_id) {
+      Node* node = nodes_[0] + pixel_id;
       if (!node->is_object()) {
-        (*labels)[row][col] = 0;
         continue;
       }
-      Node* root = DisjointSetFind(node);
-      // note label in label image started from 1,
-      // zero is reserved from non-object
-      if (!root->id) {
-        root->id = ++id;
+      const uint32_t root = DisjointSetRoot(node);
+      roots_[pixel_id] = root;
+      if (block->roots.empty() || root != last_root) {
+        block->roots.push_back(root);
+        last_root = root;
+      }
+    }
+  });
+  // note label in label image started from 1,
+  // zero is reserved from non-object, the labels are given in the order
+  // of the first pixel of each cluster
+  uint16_t id = 0;
+  for (const auto& block : blocks_) {
+    for (const uint32_t root : block.roots) {
+      if (!nodes_[0][root].id) {
+        nodes_[0][root].id = ++id;
+      }
+    }
+  }
+  labels->ResetClusters(id);
+  const size_t cluster_num = id;
+  RunBlocks([this, labels, cluster_num](Block* block) {
+    block->pixel_nums.assign(cluster_num, 0);
+    uint16_t* label_ptr = (*labels)[0];
+    const uint32_t end = static_cast<uint32_t>(block->end_row * cols_);
+    for (uint32_t pixel_id = static_cast<uint32_t>(block->start_row * cols_);
+         pixel_id < end; ++pixel_id) {
+      if (!nodes_[0][pixel_id].is_object()) {
+        label_ptr[pixel_id] = 0;
+        continue;
       }
-      (*labels)[row][col] = root->id;
-      labels->AddPixelSample(root->id - 1, pixel_id);
+      const uint16_t label = nodes_[0][roots_[pixel_id]].id;
+      label_ptr[pixel_id] = label;
+      ++block->pixel_nums[label - 1];
+    }
+  });
+  // the pixels of a cluster are kept in row order, block after block
+  auto& clusters = labels->GetClusters();
+  for (size_t i = 0; i < cluster_num; ++i) {
+    uint32_t pixel_num = 0;
+    for (auto& block : blocks_) {
+      const uint32_t block_pixel_num = block.pixel_nums[i];
+      block.pixel_nums[i] = pixel_num;
+      pixel_num += block_pixel_num;
     }
+    clusters[i]->pixels.resize(pixel_num);
   }
-  labels->ResizeClusters(id);
+  RunBlocks([this, labels, &clusters](Block* block) {
+    const uint16_t* label_ptr = (*labels)[0];
+    const uint32_t end = static_cast<uint32_t>(block->end_row * cols_);
+    for (uint32_t pixel_id = static_cast<uint32_t>(block->start_row * cols_);
+         pixel_id < end; ++pixel_id) {
+      const uint16_t label = label_ptr[pixel_id];
+      if (label) {
+        clusters[label - 1]->pixels[block->pixel_nums[label - 1]++] =
+            pixel_id;
+      }
+    }
+  });
   return id;
 }
 
-void SppCCDetector::Traverse(SppCCDetector::Node* x) {
-  std::vector<SppCCDetector::Node*> p;
+void SppCCDetector::Traverse(SppCCDetector::Node* x, Block* block) {
+  const Node* begin = nodes_[0] + block->start_row * cols_;
+  const Node* end = nodes_[0] + block->end_row * cols_;
+  std::vector<SppCCDetector::Node*>& p = block->path;
   p.clear();
   while (x->get_traversed() == 0) {
     p.push_back(x);
     x->set_traversed(2);
-    x = nodes_[0] + x->center_node;
+    Node* center = nodes_[0] + x->center_node;
+    if (center < begin || center >= end) {
+      // the chain leaves the block, x stands for its root until the merge
+      p.pop_back();
+      x->set_traversed(3);
+      block->exits.push_back(static_cast<uint32_t>(x - nodes_[0]));
+      break;
+    }
+    x = center;
   }
   if (x->get_traversed() == 2) {
     for (int i = static_cast<int>(p.size()) - 1; i >= 0 && p[i] != x; i--) {
@@ -190,6 +342,63 @@ void SppCCDetector::Traverse(SppCCDetector::Node* x) {
   }
 }
 
+void SppCCDetector::TraverseExit(SppCCDetector::Node* x) {
+  std::vector<SppCCDetector::Node*>& p = merge_path_;
+  p.clear();
+  uint32_t root = 0;
+  while (true) {
+    const uint16_t traversed = x->get_traversed();
+    if (traversed == 0 || traversed == 3) {
+      p.push_back(x);
+      x->set_traversed(2);
+      x = nodes_[0] + x->center_node;
+      continue;
+    }
+    if (traversed == 2) {
+      // a cycle through several blocks
+      for (int i = static_cast<int>(p.size()) - 1; i >= 0 && p[i] != x; i--) {
+        MergeCenter(p[i]);
+      }
+      MergeCenter(x);
+      root = x->parent;
+      break;
+    }
+    // a traversed node, the root of its chain in its block may be the node
+    // of another chain leaving the block, to go on from
+    Node* block_root = nodes_[0] + x->parent;
+    const uint16_t root_traversed = block_root->get_traversed();
+    if (root_traversed == 2 || root_traversed == 3) {
+      for (; x != block_root; x = nodes_[0] + x->center_node) {
+        p.push_back(x);
+        x->set_traversed(2);
+      }
+      continue;
+    }
+    root = block_root->parent;
+    break;
+  }
+  for (size_t i = 0; i < p.size(); i++) {
+    Node* y = p[i];
+    y->set_traversed(1);
+    y->parent = root;
+  }
+}
+
+void SppCCDetector::MergeCenter(SppCCDetector::Node* x) {
+  if (!x->is_center()) {
+    x->set_is_center(true);
+    merge_centers_.push_back(x);
+  }
+}
+
+uint32_t SppCCDetector::DisjointSetRoot(const Node* x) const {
+  uint32_t root = x->parent;
+  while (nodes_[0][root].parent != root) {
+    root = nodes_[0][root].parent;
+  }
+  return root;
+}
+
 SppCCDetector::Node* SppCCDetector::DisjointSetFindLoop(Node* x) {
   Node* root = x;
   while (nodes_[0] + root->parent != root) {
@@ -15,8 +15,11 @@
  *****************************************************************************/
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 
+#include "cyber/base/thread_pool.h"
 #include "modules/perception/common/algorithm/i_lib/core/i_alloc.h"
 #include "modules/perception/common/lib/thread/thread_worker.h"
 #include "modules/perception/lidar_detection/detector/cnn_segmentation/spp_engine/spp_label_image.h"
@@ -25,11 +28,18 @@ namespace apollo {
 namespace perception {
 namespace lidar {
 
+// @brief: connected components of the spp nodes, the rows of the feature map
+// are split in one block per thread: the nodes are built, traversed and
+// unioned within each block in parallel, then the chains and the centers
+// across blocks are merged. The labels do not depend on the thread number.
 class SppCCDetector {
  public:
   SppCCDetector() = default;
 
   ~SppCCDetector() {
+    // wait for the nodes to be cleaned before they are released
+    worker_.Join();
+    worker_.Release();
     if (nodes_ != nullptr) {
       algorithm::IFree2(&nodes_);
     }
@@ -45,9 +55,14 @@ class SppCCDetector {
       nodes_ = algorithm::IAlloc2<Node>(rows, cols);
       rows_ = static_cast<int>(rows);
       cols_ = static_cast<int>(cols);
+      roots_.resize(static_cast<size_t>(rows) * cols);
     }
+    InitBlocks();
     CleanNodes();
   }
+  // @brief: set number of threads, the calling thread included
+  // @param [in]: thread number, at least 1
+  void SetThreadNum(int thread_num);
   // @brief: set data for clusterin
   // @param [in]: probability map
   // @param [in]: center offset map
@@ -61,15 +76,28 @@ class SppCCDetector {
   size_t Detect(SppLabelImage* labels);
 
  private:
+  struct Block;
   // @brief: build node matrix given start row index and end row index
   // @param [in]: start row index, inclusive
   // @param [in]: end row index, exclusive
   // @param [out]: state of build nodes
   bool BuildNodes(int start_row_index, int end_row_index);
-  // @brief: traverse node matrix
-  void TraverseNodes();
-  // @brief: union adjacent nodes
-  void UnionNodes();
+  // @brief: split rows in blocks, one per thread
+  void InitBlocks();
+  // @brief: run function on all blocks with the thread pool
+  // @param [in]: function on a block
+  void RunBlocks(const std::function<void(Block*)>& func);
+  // @brief: build, traverse and union the nodes of a block
+  // @param [in]: block
+  void ProcessBlock(Block* block);
+  // @brief: traverse node matrix of a block
+  // @param [in]: block
+  void TraverseNodes(Block* block);
+  // @brief: union adjacent nodes of a block
+  // @param [in]: block
+  void UnionNodes(const Block& block);
+  // @brief: resolve chains leaving the blocks and union across blocks
+  void MergeBlocks();
   // @brief: collect clusters to label map
   size_t ToLabelMap(SppLabelImage* labels);
   // @brief: clean node matrix
@@ -83,6 +111,8 @@ class SppCCDetector {
     // Note, we compress node_rank, traversed, is_center and is_object
     // in one 16bits variable, the arrangemant is as following
     // |is_center(1bit)|is_object(1bit)|traversed(3bit)|node_rank(11bit)|
+    // traversed is 0 before traversal, 2 on the current path, 1 after, and
+    // 3 on the last node of a chain leaving its block until the merge
     uint16_t status = 0;
 
     inline uint16_t get_node_rank() { return status & 2047; }
@@ -116,9 +146,20 @@ class SppCCDetector {
       }
     }
   };
-  // @brief: tranverse a node
+  // @brief: traverse a node within a block
   // @param [in]: input node
-  void Traverse(Node* x);
+  // @param [in]: block of the node
+  void Traverse(Node* x, Block* block);
+  // @brief: traverse a chain from a node leaving its block
+  // @param [in]: input node
+  void TraverseExit(Node* x);
+  // @brief: set node as center, and keep it to be unioned in the merge
+  // @param [in]: input node
+  void MergeCenter(Node* x);
+  // @brief: find root of input node without compressing path
+  // @param [in]: input node
+  // @return: root node index
+  uint32_t DisjointSetRoot(const Node* x) const;
   // @brief: find root of input node and compress path
   // @param [in]: input node
   // @return: root node
@@ -144,8 +185,26 @@ class SppCCDetector {
   lib::ThreadWorker worker_;
   bool first_process_ = true;
 
- private:
-  static const size_t kDefaultReserveSize = 500;
+  struct Block {
+    int start_row = 0;
+    int end_row = 0;
+    // nodes of the current traversal path
+    std::vector<Node*> path;
+    // nodes whose center is out of the block
+    std::vector<uint32_t> exits;
+    // roots of the object nodes, in order, repeated ones in a row skipped
+    std::vector<uint32_t> roots;
+    // pixel number per cluster, then offset of the block pixels
+    std::vector<uint32_t> pixel_nums;
+  };
+  int thread_num_ = 1;
+  std::unique_ptr<cyber::base::ThreadPool> thread_pool_;
+  std::vector<Block> blocks_;
+  // root of each object node
+  std::vector<uint32_t> roots_;
+  // merge path and centers found by the merge
+  std::vector<Node*> merge_path_;
+  std::vector<Node*> merge_centers_;
 };  // class SppCCDetector
 
 }  // namespace lidar
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Latency of SppCCDetector::Detect, the connected component clustering of the
+// cnn segmentation, on the cpu. The feature maps have the grid sizes of
+// cnnseg64 (672 x 672, 70 m) and cnnseg128 (864 x 864, 90 m). They hold
+// --spp_benchmark_object_num objects of 2 m to 5 m, whose cells point to the
+// object center as the instance offsets of the model do, with a quarter of a
+// cell of noise; the background cells point to themselves. Arguments are the
+// grid size and the thread number. Run:
+//   spp_seg_cc_2d_benchmark
+// objects is the number of clusters found. The labels are the same for all
+// thread numbers.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "modules/perception/lidar_detection/detector/cnn_segmentation/spp_engine/spp_seg_cc_2d.h"
+
+DEFINE_int32(spp_benchmark_object_num, 300, "number of objects in the maps");
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+namespace {
+
+struct SppMaps {
+  std::vector<float> prob;
+  std::vector<float> offset;
+  float* prob_ptr = nullptr;
+  float scale = 0.f;
+};
+
+SppMaps CreateMaps(int size, float range) {
+  SppMaps maps;
+  const size_t cell_num = static_cast<size_t>(size) * size;
+  maps.prob.assign(cell_num, 0.f);
+  maps.offset.assign(2 * cell_num, 0.f);
+  maps.prob_ptr = maps.prob.data();
+  maps.scale = static_cast<float>(size) / (2.f * range);
+  std::mt19937 random(17);
+  std::uniform_int_distribution<int> position(0, size - 1);
+  std::uniform_real_distribution<float> length(2.f, 5.f);
+  std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+  // cells per meter
+  const float resolution = maps.scale;
+  for (int i = 0; i < FLAGS_spp_benchmark_object_num; ++i) {
+    const int center_row = position(random);
+    const int center_col = position(random);
+    const int half_rows = static_cast<int>(length(random) * resolution / 2);
+    const int half_cols = static_cast<int>(length(random) * resolution / 2);
+    for (int row = std::max(0, center_row - half_rows);
+         row <= std::min(size - 1, center_row + half_rows); ++row) {
+      for (int col = std::max(0, center_col - half_cols);
+           col <= std::min(size - 1, center_col + half_cols); ++col) {
+        const size_t index = static_cast<size_t>(row) * size + col;
+        maps.prob[index] = 1.f;
+        // offsets are in meters, scale gives the cells
+        maps.offset[index] =
+            (static_cast<float>(center_row - row) + noise(random)) /
+            maps.scale;
+        maps.offset[cell_num + index] =
+            (static_cast<float>(center_col - col) + noise(random)) /
+            maps.scale;
+      }
+    }
+  }
+  return maps;
+}
+
+void BM_SppCCDetect(benchmark::State& state) {
+  const int size = static_cast<int>(state.range(0));
+  const float range = size == 672 ? 70.f : 90.f;
+  const SppMaps maps = CreateMaps(size, range);
+  SppCCDetector detector;
+  detector.Init(size, size);
+  detector.SetThreadNum(static_cast<int>(state.range(1)));
+  detector.SetData(&maps.prob_ptr, maps.offset.data(), maps.scale, 0.5f);
+  SppLabelImage labels;
+  labels.Init(size, size);
+  size_t object_num = 0;
+  for (auto _ : state) {
+    object_num = detector.Detect(&labels);
+  }
+  state.counters["objects"] = static_cast<double>(object_num);
+}
+BENCHMARK(BM_SppCCDetect)
+    ->ArgNames({"size", "threads"})
+    ->Args({672, 1})
+    ->Args({672, 2})
+    ->Args({672, 4})
+    ->Args({864, 1})
+    ->Args({864, 2})
+    ->Args({864, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/lidar_detection/detector/cnn_segmentation/spp_engine/spp_seg_cc_2d.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+// probability and center offset maps, the offsets point to given centers
+class SppMaps {
+ public:
+  SppMaps(int rows, int cols)
+      : rows_(rows),
+        cols_(cols),
+        prob_(rows * cols, 0.f),
+        offset_(2 * rows * cols, 0.f) {
+    prob_ptr_ = prob_.data();
+  }
+
+  void Set(int row, int col, int center_row, int center_col) {
+    prob_[row * cols_ + col] = 1.f;
+    SetCenter(row, col, center_row, center_col);
+  }
+  void SetCenter(int row, int col, int center_row, int center_col) {
+    offset_[row * cols_ + col] = static_cast<float>(center_row - row);
+    offset_[(rows_ + row) * cols_ + col] = static_cast<float>(center_col - col);
+  }
+
+  const float* const* prob() const { return &prob_ptr_; }
+  const float* offset() const { return offset_.data(); }
+
+ private:
+  int rows_;
+  int cols_;
+  std::vector<float> prob_;
+  std::vector<float> offset_;
+  float* prob_ptr_ = nullptr;
+};
+
+std::vector<uint16_t> Detect(const SppMaps& maps, int rows, int cols,
+                             int thread_num, SppLabelImage* labels) {
+  SppCCDetector detector;
+  detector.Init(rows, cols);
+  detector.SetThreadNum(thread_num);
+  detector.SetData(maps.prob(), maps.offset(), 1.f, 0.5f);
+  labels->Init(cols, rows);
+  detector.Detect(labels);
+  return std::vector<uint16_t>((*labels)[0], (*labels)[0] + rows * cols);
+}
+
+TEST(SppCCDetectorTest, cycle_across_blocks_test) {
+  // 8 rows in 4 blocks of 2 rows
+  const int rows = 8;
+  const int cols = 6;
+  SppMaps maps(rows, cols);
+  // two centers pointing at each other across the first block border
+  maps.Set(1, 1, 2, 1);
+  maps.Set(2, 1, 1, 1);
+  maps.Set(0, 0, 1, 1);
+  // a chain through three blocks to them, through a background node
+  maps.Set(7, 4, 5, 4);
+  maps.SetCenter(5, 4, 3, 2);
+  maps.Set(3, 2, 2, 1);
+  // a center on a block border, next to a center in the block below
+  maps.Set(5, 0, 5, 0);
+  maps.Set(6, 1, 6, 1);
+  maps.Set(7, 0, 6, 1);
+  // a lone center
+  maps.Set(4, 5, 4, 5);
+
+  SppLabelImage labels;
+  const std::vector<uint16_t> label_map = Detect(maps, rows, cols, 4, &labels);
+  ASSERT_EQ(labels.GetClusterNum(), 3);
+  EXPECT_EQ(label_map[0 * cols + 0], 1);
+  EXPECT_EQ(label_map[1 * cols + 1], 1);
+  EXPECT_EQ(label_map[2 * cols + 1], 1);
+  EXPECT_EQ(label_map[3 * cols + 2], 1);
+  EXPECT_EQ(label_map[7 * cols + 4], 1);
+  EXPECT_EQ(label_map[5 * cols + 4], 0);
+  EXPECT_EQ(label_map[4 * cols + 5], 2);
+  EXPECT_EQ(label_map[5 * cols + 0], 3);
+  EXPECT_EQ(label_map[6 * cols + 1], 3);
+  EXPECT_EQ(label_map[7 * cols + 0], 3);
+  const std::vector<uint32_t> pixels = {0 * cols + 0, 1 * cols + 1,
+                                        2 * cols + 1, 3 * cols + 2,
+                                        7 * cols + 4};
+  EXPECT_EQ(labels.GetCluster(0)->pixels, pixels);
+
+  SppLabelImage single_labels;
+  EXPECT_EQ(Detect(maps, rows, cols, 1, &single_labels), label_map);
+}
+
+TEST(SppCCDetectorTest, thread_num_test) {
+  const int rows = 67;
+  const int cols = 45;
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> prob(0.f, 1.f);
+  std::uniform_int_distribution<int> offset(-4, 4);
+  SppMaps maps(rows, cols);
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      const int center_row =
+          std::max(0, std::min(rows - 1, row + offset(random)));
+      const int center_col =
+          std::max(0, std::min(cols - 1, col + offset(random)));
+      if (prob(random) < 0.4f) {
+        maps.Set(row, col, center_row, center_col);
+      } else {
+        maps.SetCenter(row, col, center_row, center_col);
+      }
+    }
+  }
+  SppLabelImage labels;
+  const std::vector<uint16_t> label_map = Detect(maps, rows, cols, 1, &labels);
+  EXPECT_GT(labels.GetClusterNum(), 10);
+  for (const int thread_num : {2, 3, 5, 8}) {
+    SppLabelImage thread_labels;
+    EXPECT_EQ(Detect(maps, rows, cols, thread_num, &thread_labels), label_map)
+        << thread_num;
+    ASSERT_EQ(thread_labels.GetClusterNum(), labels.GetClusterNum());
+    for (size_t i = 0; i < labels.GetClusterNum(); ++i) {
+      EXPECT_EQ(thread_labels.GetCluster(i)->pixels,
+                labels.GetCluster(i)->pixels);
+    }
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -58,6 +58,7 @@ struct SppData {
 struct SppParams {
   float height_gap = 0.5f;
   float confidence_range = 58.f;
+  int cc_thread_num = 1;
 };
 
 }  // namespace lidar
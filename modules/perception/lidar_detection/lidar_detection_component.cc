@@ -18,11 +18,14 @@
 
 #include "cyber/common/log.h"
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
+
 bool LidarDetectionComponent::Init() {
   LidarDetectionComponentConfig comp_config;
   if (!GetProtoConfig(&comp_config)) {
@@ -36,6 +39,9 @@ bool LidarDetectionComponent::Init() {
   output_channel_name_ = comp_config.output_channel_name();
   writer_ =
       node_->CreateWriter<onboard::LidarFrameMessage>(output_channel_name_);
+  if (!onboard::CheckIntraProcessTransport(output_channel_name_)) {
+    return false;
+  }
 
   use_object_builder_ = comp_config.use_object_builder();
 
@@ -70,9 +76,11 @@ bool LidarDetectionComponent::Init() {
 bool LidarDetectionComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
+  message->latency_trace_.BeginStage("detection", Clock::NowInSeconds());
   // internal proc
   bool status = InternalProc(message);
   if (status) {
+    message->latency_trace_.EndStage(Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send Lidar detection output message.";
   }
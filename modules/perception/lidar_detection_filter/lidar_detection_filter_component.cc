@@ -18,11 +18,14 @@
 
 #include "cyber/common/log.h"
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
+
 bool LidarDetectionFilterComponent::Init() {
   LidarDetectionFilterComponentConfig comp_config;
   if (!GetProtoConfig(&comp_config)) {
@@ -34,6 +37,9 @@ bool LidarDetectionFilterComponent::Init() {
 
   output_channel_name_ = comp_config.output_channel_name();
   writer_ = node_->CreateWriter<LidarFrameMessage>(output_channel_name_);
+  if (!onboard::CheckIntraProcessTransport(output_channel_name_)) {
+    return false;
+  }
 
   use_object_filter_bank_ = comp_config.use_object_filter_bank();
   if (use_object_filter_bank_) {
@@ -50,9 +56,11 @@ bool LidarDetectionFilterComponent::Init() {
 bool LidarDetectionFilterComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
+  message->latency_trace_.BeginStage("detection_filter", Clock::NowInSeconds());
   // internal proc
   bool status = InternalProc(message);
   if (status) {
+    message->latency_trace_.EndStage(Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send lidar detection filter message.";
   }
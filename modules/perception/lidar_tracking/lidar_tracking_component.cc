@@ -18,6 +18,7 @@
 
 #include "cyber/profiler/profiler.h"
 #include "cyber/time/clock.h"
+#include "modules/perception/common/onboard/common_flags/common_flags.h"
 
 namespace apollo {
 namespace perception {
@@ -68,6 +69,7 @@ bool LidarTrackingComponent::Init() {
 bool LidarTrackingComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
+  message->latency_trace_.BeginStage("tracking", Clock::NowInSeconds());
   AINFO << std::setprecision(16)
         << "Enter LidarTracking component, message timestamp: "
         << message->timestamp_
@@ -76,6 +78,16 @@ bool LidarTrackingComponent::Proc(
   auto out_message = std::make_shared<SensorFrameMessage>();
 
   if (InternalProc(message, out_message)) {
+    message->latency_trace_.EndStage(Clock::NowInSeconds());
+    const auto& latency_trace = message->latency_trace_;
+    ADEBUG << std::setprecision(16) << "FRAME_LATENCY:Lidar:msg_time["
+           << message->timestamp_ << "]:" << latency_trace.ToString();
+    if (latency_trace.TotalLatency() > FLAGS_obs_lidar_latency_budget) {
+      AWARN << "Lidar frame " << message->seq_num_ << " latency "
+            << latency_trace.TotalLatency() << " ms over the budget of "
+            << FLAGS_obs_lidar_latency_budget << " ms: "
+            << latency_trace.ToString();
+    }
     writer_->Write(out_message);
     return true;
   }
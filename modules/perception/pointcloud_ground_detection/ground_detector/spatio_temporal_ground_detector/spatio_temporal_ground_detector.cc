@@ -16,6 +16,8 @@
 
 #include "modules/perception/pointcloud_ground_detection/ground_detector/spatio_temporal_ground_detector/spatio_temporal_ground_detector.h"
 
+#include <algorithm>
+
 #include "cyber/common/file.h"
 
 #include "modules/perception/common/util.h"
@@ -49,6 +51,8 @@ bool SpatioTemporalGroundDetector::Init(
   param_->roi_region_rad_z = config_params.roi_rad_z();
   param_->nr_grids_coarse = config_params.grid_size();
   param_->nr_smooth_iter = config_params.nr_smooth_iter();
+  param_->nr_threads = std::max(config_params.thread_num(), 1u);
+  param_->use_warm_start = config_params.use_warm_start();
 
   pfdetector_ = new algorithm::PlaneFitGroundDetector(*param_);
   pfdetector_->Init();
@@ -92,6 +96,14 @@ bool SpatioTemporalGroundDetector::Detect(const GroundDetectorOptions& options,
   cloud_center_(0) = frame->lidar2world_pose(0, 3);
   cloud_center_(1) = frame->lidar2world_pose(1, 3);
   cloud_center_(2) = frame->lidar2world_pose(2, 3);
+  // the planes of the last frame around the new center, the first frame has
+  // none and the grids of a far center are reset
+  if (param_->use_warm_start) {
+    const Eigen::Vector3f translation =
+        (cloud_center_ - last_cloud_center_).cast<float>();
+    pfdetector_->TranslateGroundPlanes(translation.data());
+  }
+  last_cloud_center_ = cloud_center_;
 
   // check output
   frame->non_ground_indices.indices.clear();
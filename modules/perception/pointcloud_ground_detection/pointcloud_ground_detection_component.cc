@@ -17,11 +17,13 @@
 #include "modules/perception/pointcloud_ground_detection/pointcloud_ground_detection_component.h"
 
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
 using apollo::cyber::common::GetAbsolutePath;
 
 bool PointCloudGroundDetectComponent::Init() {
@@ -35,6 +37,9 @@ bool PointCloudGroundDetectComponent::Init() {
   output_channel_name_ = comp_config.output_channel_name();
   writer_ =
       node_->CreateWriter<onboard::LidarFrameMessage>(output_channel_name_);
+  if (!onboard::CheckIntraProcessTransport(output_channel_name_)) {
+    return false;
+  }
 
   // groun detector
   auto plugin_param = comp_config.plugin_param();
@@ -54,9 +59,11 @@ bool PointCloudGroundDetectComponent::Init() {
 bool PointCloudGroundDetectComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
+  message->latency_trace_.BeginStage("ground_detection", Clock::NowInSeconds());
   // internal proc
   bool status = InternalProc(message);
   if (status) {
+    message->latency_trace_.EndStage(Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send pointcloud ground detect output message.";
   }
@@ -17,12 +17,15 @@
 #include "modules/perception/pointcloud_map_based_roi/pointcloud_map_based_roi_component.h"
 
 #include "cyber/profiler/profiler.h"
+#include "cyber/time/clock.h"
 #include "modules/perception/common/lidar/common/config_util.h"
 
 namespace apollo {
 namespace perception {
 namespace lidar {
 
+using apollo::cyber::Clock;
+
 bool PointCloudMapROIComponent::Init() {
   PointCloudMapROIComponentConfig comp_config;
   if (!GetProtoConfig(&comp_config)) {
@@ -34,6 +37,9 @@ bool PointCloudMapROIComponent::Init() {
   // writer
   output_channel_name_ = comp_config.output_channel_name();
   writer_ = node_->CreateWriter<LidarFrameMessage>(output_channel_name_);
+  if (!onboard::CheckIntraProcessTransport(output_channel_name_)) {
+    return false;
+  }
 
   // Scene manager
   ACHECK(SceneManager::Instance().Init());
@@ -72,9 +78,11 @@ bool PointCloudMapROIComponent::Init() {
 bool PointCloudMapROIComponent::Proc(
     const std::shared_ptr<LidarFrameMessage>& message) {
   PERF_FUNCTION()
+  message->latency_trace_.BeginStage("map_roi", Clock::NowInSeconds());
   // internal proc
   bool status = InternalProc(message);
   if (status) {
+    message->latency_trace_.EndStage(Clock::NowInSeconds());
     writer_->Write(message);
     AINFO << "Send pointcloud map based roi output message.";
   }
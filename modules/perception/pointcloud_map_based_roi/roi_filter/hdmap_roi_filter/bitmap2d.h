@@ -95,6 +95,13 @@ class Bitmap2D {
    */
   const std::vector<uint64_t>& bitmap() const { return bitmap_; }
 
+  /**
+   * @brief Return the mutable bitmap_
+   * 
+   * @return std::vector<uint64_t>* bitmap_
+   */
+  std::vector<uint64_t>* mutable_bitmap() { return &bitmap_; }
+
   /**
    * @brief Return the dir_major_
    * 
@@ -17,6 +17,7 @@
 #include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/hdmap_roi_filter.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "cyber/common/file.h"
 #include "modules/perception/common/util.h"
@@ -46,6 +47,7 @@ bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   extend_dist_ = config.extend_dist();
   no_edge_table_ = config.no_edge_table();
   set_roi_service_ = config.set_roi_service();
+  use_bitmap_cache_ = config.use_bitmap_cache();
 
   // reserve mem
   const size_t KPolygonMaxNum = 100;
@@ -57,13 +59,19 @@ bool HdmapROIFilter::Init(const ROIFilterInitOptions& options) {
   Eigen::Vector2d max_range(range_, range_);
   Eigen::Vector2d cell_size(cell_size_, cell_size_);
   bitmap_.Init(min_range, max_range, cell_size);
+  if (use_bitmap_cache_) {
+    bitmap_cache_.Init(cell_size_, config.cache_tile_size(),
+                       config.cache_max_tile_num(), extend_dist_,
+                       no_edge_table_);
+  }
 
   // output input parameters
   AINFO << " HDMap Roi Filter Parameters: "
         << " range: " << range_ << " cell_size: " << cell_size_
         << " extend_dist: " << extend_dist_
         << " no_edge_table: " << no_edge_table_
-        << " set_roi_service: " << set_roi_service_;
+        << " set_roi_service: " << set_roi_service_
+        << " use_bitmap_cache: " << use_bitmap_cache_;
 
   return true;
 }
@@ -94,13 +102,20 @@ bool HdmapROIFilter::Filter(const ROIFilterOptions& options,
     polygons_world_[i++] = &polygon;
   }
 
-  // transform to local
-  base::PointFCloudPtr cloud_local = base::PointFCloudPool::Instance().Get();
-  TransformFrame(frame->cloud, frame->lidar2world_pose, polygons_world_,
-                 &polygons_local_, &cloud_local);
+  bool ret = false;
+  if (use_bitmap_cache_) {
+    ret = FilterWithBitmapCache(frame->cloud, frame->lidar2world_pose,
+                                polygons_world_, &(frame->roi_indices));
+  } else {
+    // transform to local
+    base::PointFCloudPtr cloud_local =
+        base::PointFCloudPool::Instance().Get();
+    TransformFrame(frame->cloud, frame->lidar2world_pose, polygons_world_,
+                   &polygons_local_, &cloud_local);
 
-  bool ret = FilterWithPolygonMask(cloud_local, polygons_local_,
-                                   &(frame->roi_indices));
+    ret = FilterWithPolygonMask(cloud_local, polygons_local_,
+                                &(frame->roi_indices));
+  }
 
   // set roi points label
   if (ret) {
@@ -116,13 +131,18 @@ bool HdmapROIFilter::Filter(const ROIFilterOptions& options,
   if (set_roi_service_) {
     auto roi_service = SceneManager::Instance().Service("ROIService");
     if (roi_service != nullptr) {
+      if (use_bitmap_cache_) {
+        GetCachedBitmap(frame->lidar2world_pose);
+      } else {
+        roi_service_content_.transform_ =
+            frame->lidar2world_pose.translation();
+      }
       roi_service_content_.range_ = range_;
       roi_service_content_.cell_size_ = cell_size_;
       roi_service_content_.map_size_ = bitmap_.map_size();
       roi_service_content_.bitmap_ = bitmap_.bitmap();
       roi_service_content_.major_dir_ =
           static_cast<ROIServiceContent::DirectionMajor>(bitmap_.dir_major());
-      roi_service_content_.transform_ = frame->lidar2world_pose.translation();
       if (!ret) {
         std::fill(roi_service_content_.bitmap_.begin(),
                   roi_service_content_.bitmap_.end(), -1);
@@ -176,6 +196,34 @@ bool HdmapROIFilter::FilterWithPolygonMask(
          Bitmap2dFilter(cloud, bitmap_, roi_indices);
 }
 
+bool HdmapROIFilter::FilterWithBitmapCache(
+    const base::PointFCloudPtr& cloud, const Eigen::Affine3d& vel_pose,
+    const EigenVector<PolygonDType*>& polygons_world,
+    base::PointIndices* roi_indices) {
+  const Eigen::Vector2d vel_location = vel_pose.translation().head<2>();
+  if (!bitmap_cache_.Update(polygons_world, vel_location, range_)) {
+    return false;
+  }
+  if (!bitmap_cache_.Check(vel_location)) {
+    AWARN << " Car is not in roi!!.";
+    return false;
+  }
+  bitmap_cache_.Filter(*cloud, vel_pose, &roi_mask_);
+  base::MaskToIndices(roi_mask_, roi_indices);
+  return true;
+}
+
+void HdmapROIFilter::GetCachedBitmap(const Eigen::Affine3d& vel_pose) {
+  // the service bitmap is centered on the cell of the car, so that its cells
+  // are the ones of the tiles
+  Eigen::Vector3d vel_location = vel_pose.translation();
+  vel_location.x() = std::floor(vel_location.x() / cell_size_) * cell_size_;
+  vel_location.y() = std::floor(vel_location.y() / cell_size_) * cell_size_;
+  bitmap_cache_.GetBitmap(
+      vel_location.head<2>() - Eigen::Vector2d(range_, range_), &bitmap_);
+  roi_service_content_.transform_ = vel_location;
+}
+
 void HdmapROIFilter::TransformFrame(
     const base::PointFCloudPtr& cloud, const Eigen::Affine3d& vel_pose,
     const EigenVector<PolygonDType*>& polygons_world,
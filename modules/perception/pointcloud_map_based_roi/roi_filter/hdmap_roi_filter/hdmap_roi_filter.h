@@ -28,6 +28,7 @@
 #include "modules/perception/common/onboard/inner_component_messages/lidar_inner_component_messages.h"
 #include "modules/perception/pointcloud_map_based_roi/interface/base_roi_filter.h"
 #include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/bitmap2d.h"
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/roi_bitmap_cache.h"
 
 namespace apollo {
 namespace perception {
@@ -91,15 +92,25 @@ class HdmapROIFilter : public BaseROIFilter {
   bool Bitmap2dFilter(const base::PointFCloudPtr& in_cloud,
                       const Bitmap2D& bitmap, base::PointIndices* roi_indices);
 
+  bool FilterWithBitmapCache(
+      const base::PointFCloudPtr& cloud, const Eigen::Affine3d& vel_pose,
+      const apollo::common::EigenVector<base::PolygonDType*>& polygons_world,
+      base::PointIndices* roi_indices);
+
+  void GetCachedBitmap(const Eigen::Affine3d& vel_pose);
+
   // parameters for polygons scans convert
   double range_ = 120.0;
   double cell_size_ = 0.25;
   double extend_dist_ = 0.0;
   bool no_edge_table_ = false;
   bool set_roi_service_ = false;
+  bool use_bitmap_cache_ = false;
   apollo::common::EigenVector<base::PolygonDType*> polygons_world_;
   apollo::common::EigenVector<base::PolygonDType> polygons_local_;
   Bitmap2D bitmap_;
+  RoiBitmapCache bitmap_cache_;
+  base::PointMask roi_mask_;
   ROIServiceContent roi_service_content_;
 };
 
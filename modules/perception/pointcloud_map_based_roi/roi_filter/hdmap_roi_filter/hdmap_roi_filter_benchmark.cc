@@ -0,0 +1,196 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Latency of HdmapROIFilter::Filter on a 128 beam lidar frame, 1800 points a
+// beam, driving through a synthetic town of 100 m blocks: 14 m wide road
+// sections between the junctions, all the sections and junctions within
+// 150 m of the car in the hdmap struct of the frame, as HDMapInput gathers
+// them. The car moves 1 m a frame along a road. Range 0 is use_bitmap_cache:
+// 0 rasterizes the polygons around the car every frame, 1 draws them in the
+// world aligned tiles of the cache on the first visit and only indexes the
+// tiles afterwards. The other parameters are the ones of the data config,
+// without the roi service. Run:
+//   hdmap_roi_filter_benchmark
+// roi_points is the mean number of points of a frame in the roi. It differs
+// by a few tenths of a percent between both: the cells of the tiles are on
+// the world grid, not on the grid around the car, and the polygons are
+// scanned along x instead of along their longer side, which moves the
+// polygon edges by up to a cell.
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "modules/perception/common/lidar/common/lidar_frame.h"
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/hdmap_roi_filter.h"
+
+DEFINE_string(hdmap_roi_benchmark_dir, "/tmp",
+              "directory the benchmark configs are written to");
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+namespace {
+
+constexpr double kBlockSize = 100.0;
+constexpr double kRoadHalfWidth = 7.0;
+constexpr double kMapDistance = 150.0;
+constexpr int kFrameNum = 200;
+// town origin, an utm position
+const Eigen::Vector2d kOrigin(437000.0, 4432000.0);
+
+void AddRectangle(double min_x, double min_y, double max_x, double max_y,
+                  apollo::common::EigenVector<base::PolygonDType>* polygons) {
+  base::PolygonDType polygon;
+  const double corners[4][2] = {
+      {min_x, min_y}, {max_x, min_y}, {max_x, max_y}, {min_x, max_y}};
+  for (const auto& corner : corners) {
+    base::PointD point;
+    point.x = kOrigin.x() + corner[0];
+    point.y = kOrigin.y() + corner[1];
+    polygon.push_back(point);
+  }
+  polygons->push_back(polygon);
+}
+
+// the road sections and junctions around a town position
+std::shared_ptr<base::HdmapStruct> TownAround(const Eigen::Vector2d& center) {
+  auto hdmap = std::make_shared<base::HdmapStruct>();
+  const int min_i =
+      static_cast<int>(std::floor((center.x() - kMapDistance) / kBlockSize));
+  const int max_i =
+      static_cast<int>(std::ceil((center.x() + kMapDistance) / kBlockSize));
+  const int min_j =
+      static_cast<int>(std::floor((center.y() - kMapDistance) / kBlockSize));
+  const int max_j =
+      static_cast<int>(std::ceil((center.y() + kMapDistance) / kBlockSize));
+  for (int i = min_i; i <= max_i; ++i) {
+    for (int j = min_j; j <= max_j; ++j) {
+      const double x = i * kBlockSize;
+      const double y = j * kBlockSize;
+      AddRectangle(x - kRoadHalfWidth, y - kRoadHalfWidth, x + kRoadHalfWidth,
+                   y + kRoadHalfWidth, &hdmap->junction_polygons);
+      // the sections along x and along y to the next junctions
+      AddRectangle(x + kRoadHalfWidth, y - kRoadHalfWidth,
+                   x + kBlockSize - kRoadHalfWidth, y + kRoadHalfWidth,
+                   &hdmap->road_polygons);
+      AddRectangle(x - kRoadHalfWidth, y + kRoadHalfWidth, x + kRoadHalfWidth,
+                   y + kBlockSize - kRoadHalfWidth, &hdmap->road_polygons);
+    }
+  }
+  return hdmap;
+}
+
+// 128 beams from 2 m to 150 m on the ground, 1800 points a beam
+std::shared_ptr<base::PointFCloud> LidarCloud() {
+  auto cloud = std::make_shared<base::PointFCloud>();
+  const int beam_num = 128;
+  const int point_num = 1800;
+  cloud->reserve(beam_num * point_num);
+  for (int beam = 0; beam < beam_num; ++beam) {
+    const double range = 2.0 + 148.0 * std::pow(beam / 127.0, 2.0);
+    for (int i = 0; i < point_num; ++i) {
+      const double angle = 2.0 * M_PI * i / point_num;
+      base::PointF point;
+      point.x = static_cast<float>(range * std::cos(angle));
+      point.y = static_cast<float>(range * std::sin(angle));
+      point.z = -1.8f;
+      cloud->push_back(point, 0.0, std::numeric_limits<float>::max(),
+                       beam);
+    }
+  }
+  return cloud;
+}
+
+std::unique_ptr<HdmapROIFilter> CreateFilter(bool use_bitmap_cache) {
+  HDMapRoiFilterConfig config;
+  config.set_range(120.0);
+  config.set_cell_size(0.25);
+  config.set_use_bitmap_cache(use_bitmap_cache);
+  const std::string config_file = use_bitmap_cache
+                                      ? "hdmap_roi_filter_cache.pb.txt"
+                                      : "hdmap_roi_filter_raster.pb.txt";
+  if (!cyber::common::SetProtoToASCIIFile(
+          config, FLAGS_hdmap_roi_benchmark_dir + "/" + config_file)) {
+    return nullptr;
+  }
+  std::unique_ptr<HdmapROIFilter> filter(new HdmapROIFilter());
+  ROIFilterInitOptions options;
+  options.config_path = FLAGS_hdmap_roi_benchmark_dir;
+  options.config_file = config_file;
+  if (!filter->Init(options)) {
+    return nullptr;
+  }
+  return filter;
+}
+
+void BM_HdmapRoiFilter(benchmark::State& state) {
+  std::unique_ptr<HdmapROIFilter> filter = CreateFilter(state.range(0) != 0);
+  if (filter == nullptr) {
+    state.SkipWithError("failed to write the config");
+    return;
+  }
+  // a road along x, in the right lane, slightly turning
+  std::vector<LidarFrame> frames(kFrameNum);
+  const auto cloud = LidarCloud();
+  for (int i = 0; i < kFrameNum; ++i) {
+    const Eigen::Vector2d position(20.0 + i, -3.5);
+    frames[i].cloud = cloud;
+    frames[i].world_cloud = std::make_shared<base::PointDCloud>();
+    frames[i].world_cloud->resize(cloud->size());
+    frames[i].hdmap_struct = TownAround(position);
+    frames[i].lidar2world_pose.translation() << kOrigin.x() + position.x(),
+        kOrigin.y() + position.y(), 40.0;
+    frames[i].lidar2world_pose.rotate(
+        Eigen::AngleAxisd(0.01 * std::sin(0.1 * i), Eigen::Vector3d::UnitZ()));
+  }
+
+  ROIFilterOptions options;
+  size_t frame_id = 0;
+  double roi_points = 0.0;
+  for (auto _ : state) {
+    LidarFrame* frame = &frames[frame_id++ % kFrameNum];
+    filter->Filter(options, frame);
+    roi_points += static_cast<double>(frame->roi_indices.indices.size());
+  }
+  state.counters["points"] = static_cast<double>(cloud->size());
+  state.counters["roi_points"] =
+      benchmark::Counter(roi_points, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_HdmapRoiFilter)
+    ->ArgNames({"cache"})
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,322 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/roi_bitmap_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "modules/perception/common/lidar/common/lidar_log.h"
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/polygon_mask.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+using DirectionMajor = Bitmap2D::DirectionMajor;
+using apollo::common::EigenVector;
+using base::PolygonDType;
+
+void RoiBitmapCache::Init(double cell_size, size_t tile_cell_num,
+                          size_t max_tile_num, double extend_dist,
+                          bool no_edge_table) {
+  CHECK_GT(cell_size, 0.0);
+  cell_size_ = cell_size;
+  tile_shift_ = 6;
+  while ((static_cast<size_t>(1) << tile_shift_) < tile_cell_num) {
+    ++tile_shift_;
+  }
+  tile_cell_num_ = static_cast<int64_t>(1) << tile_shift_;
+  // one more row and column than the tile, see GetTile
+  tile_words_per_row_ = static_cast<size_t>((tile_cell_num_ + 2) >> 6) + 1;
+  max_tile_num_ = max_tile_num;
+  extend_dist_ = extend_dist;
+  no_edge_table_ = no_edge_table;
+
+  tiles_.clear();
+  update_count_ = 0;
+  window_tile_num_x_ = 0;
+  window_tile_num_y_ = 0;
+  window_tiles_.clear();
+}
+
+// static
+int64_t RoiBitmapCache::TileKey(int64_t tile_x, int64_t tile_y) {
+  // shifted unsigned, the tiles left and below the origin are negative
+  return static_cast<int64_t>((static_cast<uint64_t>(tile_x) << 32) ^
+                              (static_cast<uint64_t>(tile_y) & 0xffffffff));
+}
+
+// static
+uint64_t RoiBitmapCache::PolygonKey(const PolygonDType& polygon) {
+  std::hash<double> hasher;
+  uint64_t key = polygon.size();
+  for (size_t i = 0; i < polygon.size(); ++i) {
+    for (const double value : {polygon[i].x, polygon[i].y}) {
+      key ^= hasher(value) + 0x9e3779b97f4a7c15 + (key << 6) + (key >> 2);
+    }
+  }
+  return key;
+}
+
+// static
+bool RoiBitmapCache::HasPolygon(const Tile& tile, uint64_t key,
+                                const Polygon& polygon) {
+  const auto range = tile.polygons.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (*it->second == polygon) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RoiBitmapCache::Tile* RoiBitmapCache::GetTile(int64_t tile_x,
+                                              int64_t tile_y) {
+  std::unique_ptr<Tile>& tile = tiles_[TileKey(tile_x, tile_y)];
+  if (tile == nullptr) {
+    tile.reset(new Tile());
+    const double tile_size = static_cast<double>(tile_cell_num_) * cell_size_;
+    const Eigen::Vector2d min_range(static_cast<double>(tile_x) * tile_size,
+                                    static_cast<double>(tile_y) * tile_size);
+    // the scans of DrawPolygonMask stop a cell before the max range, the
+    // extra row and column keep the last ones of the tile
+    const Eigen::Vector2d max_range =
+        min_range + Eigen::Vector2d::Constant(tile_size + cell_size_);
+    tile->bitmap.Init(min_range, max_range,
+                      Eigen::Vector2d(cell_size_, cell_size_));
+    tile->bitmap.SetUp(DirectionMajor::XMAJOR);
+  }
+  return tile.get();
+}
+
+void RoiBitmapCache::EvictTiles() {
+  if (tiles_.size() <= max_tile_num_) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, int64_t>> unused_tiles;
+  for (const auto& tile : tiles_) {
+    if (tile.second->last_used < update_count_) {
+      unused_tiles.emplace_back(tile.second->last_used, tile.first);
+    }
+  }
+  const size_t evict_num =
+      std::min(tiles_.size() - max_tile_num_, unused_tiles.size());
+  std::partial_sort(unused_tiles.begin(), unused_tiles.begin() + evict_num,
+                    unused_tiles.end());
+  for (size_t i = 0; i < evict_num; ++i) {
+    tiles_.erase(unused_tiles[i].second);
+  }
+}
+
+bool RoiBitmapCache::Update(const EigenVector<PolygonDType*>& polygons_world,
+                            const Eigen::Vector2d& center, double range) {
+  ++update_count_;
+  center_ = center;
+  range_ = range;
+
+  // tiles of the window
+  const double tile_size = static_cast<double>(tile_cell_num_) * cell_size_;
+  const auto to_tile = [tile_size](double value) {
+    return static_cast<int64_t>(std::floor(value / tile_size));
+  };
+  window_min_tile_x_ = to_tile(center.x() - range);
+  window_min_tile_y_ = to_tile(center.y() - range);
+  window_tile_num_x_ = to_tile(center.x() + range) - window_min_tile_x_ + 1;
+  window_tile_num_y_ = to_tile(center.y() + range) - window_min_tile_y_ + 1;
+  window_min_ << static_cast<double>(window_min_tile_x_) * tile_size,
+      static_cast<double>(window_min_tile_y_) * tile_size;
+  std::vector<Tile*> window_tiles;
+  window_tiles.reserve(window_tile_num_x_ * window_tile_num_y_);
+  for (int64_t j = 0; j < window_tile_num_y_; ++j) {
+    for (int64_t i = 0; i < window_tile_num_x_; ++i) {
+      Tile* tile = GetTile(window_min_tile_x_ + i, window_min_tile_y_ + j);
+      tile->last_used = update_count_;
+      window_tiles.push_back(tile);
+    }
+  }
+  EvictTiles();
+
+  window_tiles_.resize(window_tiles.size());
+  for (size_t i = 0; i < window_tiles.size(); ++i) {
+    window_tiles_[i] = window_tiles[i]->bitmap.bitmap().data();
+  }
+
+  // draw the polygons new to the tiles they overlap
+  for (const PolygonDType* polygon : polygons_world) {
+    if (polygon->empty()) {
+      continue;
+    }
+    Eigen::Vector2d poly_min_p;
+    poly_min_p.setConstant(std::numeric_limits<double>::max());
+    Eigen::Vector2d poly_max_p = -poly_min_p;
+    for (size_t i = 0; i < polygon->size(); ++i) {
+      const Eigen::Vector2d pt(polygon->at(i).x, polygon->at(i).y);
+      poly_min_p = poly_min_p.cwiseMin(pt);
+      poly_max_p = poly_max_p.cwiseMax(pt);
+    }
+    const uint64_t key = PolygonKey(*polygon);
+    std::shared_ptr<Polygon> raw_polygon;
+    for (Tile* tile : window_tiles) {
+      const Eigen::Vector2d& tile_min = tile->bitmap.min_range();
+      const Eigen::Vector2d& tile_max = tile->bitmap.max_range();
+      // the polygons DrawPolygonMask draws no scan of
+      double first_x = std::max(poly_min_p.x(), tile_min.x());
+      first_x = (std::floor((first_x - tile_min.x()) / cell_size_) + 0.5) *
+                    cell_size_ + tile_min.x();
+      if (std::min(poly_max_p.x(), tile_max.x()) < first_x + cell_size_ ||
+          poly_max_p.y() + extend_dist_ < tile_min.y() ||
+          poly_min_p.y() - extend_dist_ > tile_max.y()) {
+        continue;
+      }
+      if (raw_polygon == nullptr) {
+        raw_polygon = std::make_shared<Polygon>(polygon->size());
+        for (size_t i = 0; i < polygon->size(); ++i) {
+          (*raw_polygon)[i].x() = polygon->at(i).x;
+          (*raw_polygon)[i].y() = polygon->at(i).y;
+        }
+      }
+      if (HasPolygon(*tile, key, *raw_polygon)) {
+        continue;
+      }
+      if (!DrawPolygonMask<double>(*raw_polygon, &tile->bitmap, extend_dist_,
+                                   no_edge_table_)) {
+        return false;
+      }
+      tile->polygons.emplace(key, raw_polygon);
+    }
+  }
+  return true;
+}
+
+uint64_t RoiBitmapCache::GetWord(int64_t cell_x, int64_t cell_y) const {
+  const int64_t tile_x = cell_x >> tile_shift_;
+  const int64_t tile_y = cell_y >> tile_shift_;
+  if (cell_x < 0 || tile_x >= window_tile_num_x_ || cell_y < 0 ||
+      tile_y >= window_tile_num_y_) {
+    return 0;
+  }
+  const int64_t mask = tile_cell_num_ - 1;
+  const uint64_t* bitmap = window_tiles_[tile_y * window_tile_num_x_ + tile_x];
+  return bitmap[(cell_x & mask) * tile_words_per_row_ + ((cell_y & mask) >> 6)];
+}
+
+uint64_t RoiBitmapCache::GetBits(int64_t cell_x, int64_t cell_y) const {
+  // the words of the tile rows are aligned to 64 cells of the window
+  const int shift = static_cast<int>(cell_y & 63);
+  const uint64_t low = GetWord(cell_x, cell_y) >> shift;
+  if (shift == 0) {
+    return low;
+  }
+  return low | (GetWord(cell_x, cell_y + 64) << (64 - shift));
+}
+
+bool RoiBitmapCache::Check(const Eigen::Vector2d& p) const {
+  const Eigen::Vector2d d = p - center_;
+  // written so that nan fails too
+  if (!(d.x() >= -range_ && d.x() < range_ && d.y() >= -range_ &&
+        d.y() < range_)) {
+    return false;
+  }
+  // the same cells as Filter
+  const int64_t cell_x = static_cast<int64_t>(
+      (center_.x() - window_min_.x() + d.x()) / cell_size_);
+  const int64_t cell_y = static_cast<int64_t>(
+      (center_.y() - window_min_.y() + d.y()) / cell_size_);
+  return (GetWord(cell_x, cell_y) >> (cell_y & 63)) & 1;
+}
+
+void RoiBitmapCache::Filter(const base::PointFCloud& cloud,
+                            const Eigen::Affine3d& pose,
+                            base::PointMask* mask) const {
+  mask->resize(cloud.size());
+  // the cells are counted from the window corner, they are positive in the
+  // window and truncated instead of floored
+  const double offset_x = pose.translation().x() - window_min_.x();
+  const double offset_y = pose.translation().y() - window_min_.y();
+  const double range = range_;
+  const double inv_cell_size = 1.0 / cell_size_;
+  // the cells of the points in range have to fit an int, which holds for
+  // any pose near the window; nan poses fail too
+  const double max_cell =
+      static_cast<double>(std::numeric_limits<int>::max() >> 1);
+  if (window_tiles_.empty() ||
+      !(std::abs(offset_x) + range < max_cell * cell_size_ &&
+        std::abs(offset_y) + range < max_cell * cell_size_)) {
+    std::fill(mask->begin(), mask->end(), 0);
+    return;
+  }
+  const Eigen::Matrix3d rot = pose.linear();
+  const int cell_mask = static_cast<int>(tile_cell_num_ - 1);
+  const int tile_shift = tile_shift_;
+  const int tile_num_x = static_cast<int>(window_tile_num_x_);
+  const int tile_num_y = static_cast<int>(window_tile_num_y_);
+  const int words_per_row = static_cast<int>(tile_words_per_row_);
+  const uint64_t* const* tiles = window_tiles_.data();
+  const base::PointF* points = cloud.points().data();
+  uint8_t* out = mask->data();
+  // no branch per point: the points out of the window read the first word
+  // of the first tile and are masked out
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    const double px = points[i].x;
+    const double py = points[i].y;
+    const double pz = points[i].z;
+    const double dx = rot(0, 0) * px + rot(0, 1) * py + rot(0, 2) * pz;
+    const double dy = rot(1, 0) * px + rot(1, 1) * py + rot(1, 2) * pz;
+    // false for nan, only the points in range are converted to cells
+    const bool in_range =
+        (dx >= -range) & (dx < range) & (dy >= -range) & (dy < range);
+    const int cell_x =
+        static_cast<int>(in_range ? (offset_x + dx) * inv_cell_size : 0.0);
+    const int cell_y =
+        static_cast<int>(in_range ? (offset_y + dy) * inv_cell_size : 0.0);
+    const int tile_x = cell_x >> tile_shift;
+    const int tile_y = cell_y >> tile_shift;
+    const int in_window = in_range & (cell_x >= 0) & (cell_y >= 0) &
+                          (tile_x < tile_num_x) & (tile_y < tile_num_y);
+    const int tile = (tile_y * tile_num_x + tile_x) * in_window;
+    const int word =
+        ((cell_x & cell_mask) * words_per_row + ((cell_y & cell_mask) >> 6)) *
+        in_window;
+    out[i] = static_cast<uint8_t>((tiles[tile][word] >> (cell_y & 63)) &
+                                  static_cast<uint64_t>(in_window));
+  }
+}
+
+void RoiBitmapCache::GetBitmap(const Eigen::Vector2d& min_corner,
+                               Bitmap2D* bitmap) const {
+  bitmap->SetUp(DirectionMajor::XMAJOR);
+  const int64_t min_cell_x = static_cast<int64_t>(
+      std::round((min_corner.x() - window_min_.x()) / cell_size_));
+  const int64_t min_cell_y = static_cast<int64_t>(
+      std::round((min_corner.y() - window_min_.y()) / cell_size_));
+  const Bitmap2D::Vec2ui& map_size = bitmap->map_size();
+  std::vector<uint64_t>* words = bitmap->mutable_bitmap();
+  for (size_t x = 0; x < map_size[0]; ++x) {
+    for (size_t y = 0; y < map_size[1]; ++y) {
+      (*words)[x * map_size[1] + y] =
+          GetBits(min_cell_x + static_cast<int64_t>(x),
+                  min_cell_y + static_cast<int64_t>(y << 6));
+    }
+  }
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -0,0 +1,180 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Eigen/Geometry"
+#include "gtest/gtest_prod.h"
+
+#include "modules/common/util/eigen_defs.h"
+#include "modules/perception/common/base/point_cloud.h"
+#include "modules/perception/common/base/soa_point_cloud.h"
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/bitmap2d.h"
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/polygon_scan_cvter.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+/**
+ * @brief ROI bitmap of the map polygons in world aligned square tiles.
+ * The map polygons are static, a polygon is rasterized into a tile the first
+ * time the tile is visited with it and the tiles are kept until they are the
+ * least recently used ones of a full cache.
+ */
+class RoiBitmapCache {
+ public:
+  /**
+   * @brief Construct a new Roi Bitmap Cache object
+   *
+   */
+  RoiBitmapCache() = default;
+  /**
+   * @brief Destroy the Roi Bitmap Cache object
+   *
+   */
+  ~RoiBitmapCache() = default;
+
+  /**
+   * @brief Init of Roi Bitmap Cache object, the tiles are cleared
+   *
+   * @param cell_size size of a bitmap cell in meters
+   * @param tile_cell_num cells of a tile side, rounded up to a power of two
+   * not lower than 64
+   * @param max_tile_num tiles kept, the ones of the current window are kept
+   * even beyond
+   * @param extend_dist distance the polygons are extended by
+   * @param no_edge_table whether the polygons are scanned without edge table
+   */
+  void Init(double cell_size, size_t tile_cell_num, size_t max_tile_num,
+            double extend_dist, bool no_edge_table);
+
+  /**
+   * @brief Set the window of the tiles around center and rasterize the
+   * polygons into the tiles of the window which do not have them yet
+   *
+   * @param polygons_world map polygons in world coordinates
+   * @param center window center in world coordinates
+   * @param range half size of the window
+   * @return false if a polygon could not be rasterized
+   */
+  bool Update(
+      const apollo::common::EigenVector<base::PolygonDType*>& polygons_world,
+      const Eigen::Vector2d& center, double range);
+
+  /**
+   * @brief Check a world point of the window
+   *
+   * @param p 2d world point
+   * @return true if the point is in the roi
+   */
+  bool Check(const Eigen::Vector2d& p) const;
+
+  /**
+   * @brief Select the points of a cloud which are in the window and in the
+   * roi, the window is the square of half size range around the center in
+   * the world axes
+   *
+   * @param cloud point cloud in the sensor frame
+   * @param pose sensor to world pose
+   * @param mask one value per point, nonzero for the points in the roi
+   */
+  void Filter(const base::PointFCloud& cloud, const Eigen::Affine3d& pose,
+              base::PointMask* mask) const;
+
+  /**
+   * @brief Copy the roi of the window into an initialized bitmap, which is
+   * set up x major
+   *
+   * @param min_corner world position of the bitmap min range, on the cell
+   * grid of the tiles
+   * @param bitmap bitmap to fill
+   */
+  void GetBitmap(const Eigen::Vector2d& min_corner, Bitmap2D* bitmap) const;
+
+  /**
+   * @brief Return the number of tiles in the cache
+   *
+   * @return size_t
+   */
+  size_t tile_num() const { return tiles_.size(); }
+
+  /**
+   * @brief Return the cell_size_
+   *
+   * @return double
+   */
+  double cell_size() const { return cell_size_; }
+
+ private:
+  FRIEND_TEST(RoiBitmapCacheTest, polygon_key_test);
+
+  using Polygon = PolygonScanCvter<double>::Polygon;
+
+  struct Tile {
+    // x major, the bits of a row are the cells along y
+    Bitmap2D bitmap;
+    // the polygons drawn by their keys, shared by the tiles they were drawn
+    // into in one update
+    std::unordered_multimap<uint64_t, std::shared_ptr<const Polygon>>
+        polygons;
+    uint64_t last_used = 0;
+  };
+
+  static int64_t TileKey(int64_t tile_x, int64_t tile_y);
+  static uint64_t PolygonKey(const base::PolygonDType& polygon);
+  // whether the tile has the polygon, the vertices are compared as the keys
+  // of different polygons may collide
+  static bool HasPolygon(const Tile& tile, uint64_t key,
+                         const Polygon& polygon);
+
+  Tile* GetTile(int64_t tile_x, int64_t tile_y);
+  void EvictTiles();
+  // word of the tile bitmap holding cell_y in row cell_x, 0 out of window,
+  // the cells are counted from the window corner
+  uint64_t GetWord(int64_t cell_x, int64_t cell_y) const;
+  // 64 bits of the cells of row cell_x from cell_y on
+  uint64_t GetBits(int64_t cell_x, int64_t cell_y) const;
+
+  double cell_size_ = 0.25;
+  int tile_shift_ = 8;
+  int64_t tile_cell_num_ = 256;
+  size_t tile_words_per_row_ = 5;
+  size_t max_tile_num_ = 100;
+  double extend_dist_ = 0.0;
+  bool no_edge_table_ = false;
+
+  std::unordered_map<int64_t, std::unique_ptr<Tile>> tiles_;
+  uint64_t update_count_ = 0;
+
+  // bitmaps of the tiles of the current window, row by row along y
+  Eigen::Vector2d center_ = Eigen::Vector2d::Zero();
+  double range_ = 0.0;
+  Eigen::Vector2d window_min_ = Eigen::Vector2d::Zero();
+  int64_t window_min_tile_x_ = 0;
+  int64_t window_min_tile_y_ = 0;
+  int64_t window_tile_num_x_ = 0;
+  int64_t window_tile_num_y_ = 0;
+  std::vector<const uint64_t*> window_tiles_;
+};
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
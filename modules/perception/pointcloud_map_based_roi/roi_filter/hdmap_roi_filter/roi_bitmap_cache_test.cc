@@ -0,0 +1,270 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/perception/pointcloud_map_based_roi/roi_filter/hdmap_roi_filter/roi_bitmap_cache.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace perception {
+namespace lidar {
+
+using apollo::common::EigenVector;
+using base::PolygonDType;
+
+// a road along x and a junction crossing it, around a utm position
+void MockPolygons(const Eigen::Vector2d& origin,
+                  EigenVector<PolygonDType>* polygons) {
+  polygons->resize(2);
+  const double road[4][2] = {
+      {-150.0, -3.6}, {150.0, -3.6}, {150.0, 3.6}, {-150.0, 3.6}};
+  const double junction[4][2] = {
+      {20.0, -40.0}, {30.0, -40.0}, {30.0, 40.0}, {20.0, 40.0}};
+  for (size_t i = 0; i < 4; ++i) {
+    base::PointD point;
+    point.x = origin.x() + road[i][0];
+    point.y = origin.y() + road[i][1];
+    (*polygons)[0].push_back(point);
+    point.x = origin.x() + junction[i][0];
+    point.y = origin.y() + junction[i][1];
+    (*polygons)[1].push_back(point);
+  }
+}
+
+bool InRoi(const Eigen::Vector2d& local_point) {
+  return (std::abs(local_point.x()) < 150.0 &&
+          std::abs(local_point.y()) < 3.6) ||
+         (local_point.x() > 20.0 && local_point.x() < 30.0 &&
+          std::abs(local_point.y()) < 40.0);
+}
+
+// true if the point is not within a cell of a polygon edge
+bool AwayFromEdges(const Eigen::Vector2d& local_point) {
+  const double margin = 0.5;
+  for (const double dy : {-margin, margin}) {
+    for (const double dx : {-margin, margin}) {
+      if (InRoi(local_point + Eigen::Vector2d(dx, dy)) !=
+          InRoi(local_point)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(RoiBitmapCacheTest, filter_test) {
+  const Eigen::Vector2d origin(437521.3, 4432310.7);
+  EigenVector<PolygonDType> polygons;
+  MockPolygons(origin, &polygons);
+  EigenVector<PolygonDType*> polygons_world;
+  for (auto& polygon : polygons) {
+    polygons_world.push_back(&polygon);
+  }
+
+  RoiBitmapCache cache;
+  cache.Init(0.25, 256, 100, 0.0, false);
+  const double range = 60.0;
+  ASSERT_TRUE(cache.Update(polygons_world, origin, range));
+  // 120 m window on 64 m tiles
+  EXPECT_GE(cache.tile_num(), 4);
+  EXPECT_LE(cache.tile_num(), 9);
+  EXPECT_TRUE(cache.Check(origin));
+
+  // a rotated lidar above the origin
+  Eigen::Affine3d pose = Eigen::Affine3d::Identity();
+  pose.translation() << origin.x(), origin.y(), 40.0;
+  pose.rotate(Eigen::AngleAxisd(0.7, Eigen::Vector3d::UnitZ()));
+  base::PointFCloud cloud;
+  for (int i = 0; i < 4000; ++i) {
+    base::PointF point;
+    point.x = static_cast<float>((i % 80) * 1.9 - 75.0);
+    point.y = static_cast<float>((i / 80) * 3.1 - 77.0);
+    point.z = -1.5f;
+    cloud.push_back(point);
+  }
+  base::PointMask mask;
+  cache.Filter(cloud, pose, &mask);
+  ASSERT_EQ(mask.size(), cloud.size());
+  size_t checked_num = 0;
+  size_t roi_num = 0;
+  for (size_t i = 0; i < cloud.size(); ++i) {
+    const Eigen::Vector3d world_point =
+        pose * Eigen::Vector3d(cloud[i].x, cloud[i].y, cloud[i].z);
+    const Eigen::Vector2d local_point = world_point.head<2>() - origin;
+    const bool in_window = std::abs(local_point.x()) < range - 0.5 &&
+                           std::abs(local_point.y()) < range - 0.5;
+    if (std::abs(local_point.x()) >= range ||
+        std::abs(local_point.y()) >= range) {
+      EXPECT_EQ(mask[i], 0);
+    } else if (in_window && AwayFromEdges(local_point)) {
+      EXPECT_EQ(mask[i] != 0, InRoi(local_point)) << local_point.transpose();
+      ++checked_num;
+    }
+    EXPECT_EQ(mask[i] != 0, cache.Check(world_point.head<2>()));
+    roi_num += mask[i];
+  }
+  EXPECT_GT(checked_num, 1000);
+  EXPECT_GT(roi_num, 100);
+
+  // the polygons are drawn once, the next frames only index the tiles
+  const size_t tile_num = cache.tile_num();
+  ASSERT_TRUE(cache.Update(polygons_world, origin, range));
+  EXPECT_EQ(cache.tile_num(), tile_num);
+  base::PointMask next_mask;
+  cache.Filter(cloud, pose, &next_mask);
+  EXPECT_EQ(next_mask, mask);
+}
+
+TEST(RoiBitmapCacheTest, invalid_point_test) {
+  const Eigen::Vector2d origin(437521.3, 4432310.7);
+  EigenVector<PolygonDType> polygons;
+  MockPolygons(origin, &polygons);
+  EigenVector<PolygonDType*> polygons_world;
+  for (auto& polygon : polygons) {
+    polygons_world.push_back(&polygon);
+  }
+
+  RoiBitmapCache cache;
+  cache.Init(0.25, 256, 100, 0.0, false);
+  ASSERT_TRUE(cache.Update(polygons_world, origin, 60.0));
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double inf = std::numeric_limits<double>::infinity();
+  EXPECT_FALSE(cache.Check(Eigen::Vector2d(nan, origin.y())));
+  EXPECT_FALSE(cache.Check(Eigen::Vector2d(origin.x(), nan)));
+  EXPECT_FALSE(cache.Check(Eigen::Vector2d(inf, -inf)));
+
+  // nan, infinite and far points next to one in the roi
+  base::PointFCloud cloud;
+  const float values[][2] = {{0.f, 0.f},
+                             {std::numeric_limits<float>::quiet_NaN(), 0.f},
+                             {0.f, -std::numeric_limits<float>::infinity()},
+                             {std::numeric_limits<float>::max(), 0.f},
+                             {-1e30f, 1e30f}};
+  for (const auto& value : values) {
+    base::PointF point;
+    point.x = value[0];
+    point.y = value[1];
+    point.z = -1.5f;
+    cloud.push_back(point);
+  }
+  Eigen::Affine3d pose = Eigen::Affine3d::Identity();
+  pose.translation() << origin.x(), origin.y(), 1.0;
+  base::PointMask mask;
+  cache.Filter(cloud, pose, &mask);
+  EXPECT_EQ(mask, base::PointMask({1, 0, 0, 0, 0}));
+
+  // a pose far away or nan has no point in the window
+  for (const double x : {1e30, nan}) {
+    pose.translation() << x, origin.y(), 1.0;
+    cache.Filter(cloud, pose, &mask);
+    EXPECT_EQ(mask, base::PointMask(cloud.size(), 0)) << x;
+  }
+}
+
+TEST(RoiBitmapCacheTest, polygon_key_test) {
+  EigenVector<PolygonDType> polygons;
+  MockPolygons(Eigen::Vector2d(0.0, 0.0), &polygons);
+  auto road = std::make_shared<RoiBitmapCache::Polygon>();
+  for (size_t i = 0; i < polygons[0].size(); ++i) {
+    road->emplace_back(polygons[0][i].x, polygons[0][i].y);
+  }
+  RoiBitmapCache::Polygon junction;
+  for (size_t i = 0; i < polygons[1].size(); ++i) {
+    junction.emplace_back(polygons[1][i].x, polygons[1][i].y);
+  }
+  const uint64_t key = RoiBitmapCache::PolygonKey(polygons[0]);
+  EXPECT_EQ(key, RoiBitmapCache::PolygonKey(polygons[0]));
+  EXPECT_NE(key, RoiBitmapCache::PolygonKey(polygons[1]));
+
+  RoiBitmapCache::Tile tile;
+  tile.polygons.emplace(key, road);
+  EXPECT_TRUE(RoiBitmapCache::HasPolygon(tile, key, *road));
+  EXPECT_FALSE(RoiBitmapCache::HasPolygon(
+      tile, RoiBitmapCache::PolygonKey(polygons[1]), junction));
+  // another polygon with a colliding key is still new to the tile
+  EXPECT_FALSE(RoiBitmapCache::HasPolygon(tile, key, junction));
+  tile.polygons.emplace(
+      key, std::make_shared<RoiBitmapCache::Polygon>(junction));
+  EXPECT_TRUE(RoiBitmapCache::HasPolygon(tile, key, junction));
+  EXPECT_TRUE(RoiBitmapCache::HasPolygon(tile, key, *road));
+}
+
+TEST(RoiBitmapCacheTest, bitmap_test) {
+  const Eigen::Vector2d origin(-1234.56, 789.01);
+  EigenVector<PolygonDType> polygons;
+  MockPolygons(origin, &polygons);
+  EigenVector<PolygonDType*> polygons_world;
+  for (auto& polygon : polygons) {
+    polygons_world.push_back(&polygon);
+  }
+
+  RoiBitmapCache cache;
+  cache.Init(0.25, 64, 100, 0.0, false);
+  const double range = 40.0;
+  ASSERT_TRUE(cache.Update(polygons_world, origin, range));
+
+  // the bitmap of the roi service, centered on the cell of the origin
+  const Eigen::Vector2d center(std::floor(origin.x() / 0.25) * 0.25,
+                               std::floor(origin.y() / 0.25) * 0.25);
+  Bitmap2D bitmap;
+  bitmap.Init(Eigen::Vector2d(-range, -range), Eigen::Vector2d(range, range),
+              Eigen::Vector2d(0.25, 0.25));
+  cache.GetBitmap(center - Eigen::Vector2d(range, range), &bitmap);
+  EXPECT_EQ(bitmap.dir_major(), 0);
+  size_t roi_num = 0;
+  for (double y = -range + 0.13; y < range; y += 0.7) {
+    for (double x = -range + 0.13; x < range; x += 0.9) {
+      const Eigen::Vector2d world_point = center + Eigen::Vector2d(x, y);
+      // the window of the cache is centered on the origin itself
+      if ((world_point - origin).cwiseAbs().maxCoeff() >= range) {
+        continue;
+      }
+      const bool in_roi = bitmap.Check(Eigen::Vector2d(x, y));
+      EXPECT_EQ(in_roi, cache.Check(world_point)) << x << " " << y;
+      roi_num += in_roi;
+    }
+  }
+  EXPECT_GT(roi_num, 100);
+}
+
+TEST(RoiBitmapCacheTest, evict_test) {
+  EigenVector<PolygonDType> polygons;
+  MockPolygons(Eigen::Vector2d(0.0, 0.0), &polygons);
+  EigenVector<PolygonDType*> polygons_world;
+  for (auto& polygon : polygons) {
+    polygons_world.push_back(&polygon);
+  }
+
+  RoiBitmapCache cache;
+  cache.Init(0.25, 64, 12, 0.0, false);
+  // 16 m tiles, a window of 3 x 3 tiles
+  for (int i = 0; i < 10; ++i) {
+    const Eigen::Vector2d center(-100.0 + 20.0 * i, 0.0);
+    ASSERT_TRUE(cache.Update(polygons_world, center, 15.0));
+    EXPECT_LE(cache.tile_num(), 12);
+    EXPECT_TRUE(cache.Check(center));
+  }
+  // out of the window
+  EXPECT_FALSE(cache.Check(Eigen::Vector2d(-100.0, 0.0)));
+}
+
+}  // namespace lidar
+}  // namespace perception
+}  // namespace apollo
@@ -57,6 +57,9 @@ bool PointCloudPreprocessComponent::Init() {
   // writer
   writer_ =
       node_->CreateWriter<onboard::LidarFrameMessage>(output_channel_name_);
+  if (!onboard::CheckIntraProcessTransport(output_channel_name_)) {
+    return false;
+  }
 
   if (!InitAlgorithmPlugin()) {
     AERROR << "Failed to init pointcloud preprocess component plugin.";
@@ -78,6 +81,7 @@ bool PointCloudPreprocessComponent::Proc(
 
   bool status = InternalProc(message, out_message);
   if (status) {
+    out_message->latency_trace_.EndStage(Clock::NowInSeconds());
     writer_->Write(out_message);
     AINFO << "Send pointcloud preprocess output message.";
   }
@@ -116,6 +120,8 @@ bool PointCloudPreprocessComponent::InternalProc(
   out_message->seq_num_ = seq_num;
   out_message->process_stage_ = onboard::ProcessStage::LIDAR_DETECTION;
   out_message->error_code_ = apollo::common::ErrorCode::OK;
+  out_message->latency_trace_.Reset(timestamp);
+  out_message->latency_trace_.BeginStage("preprocess", cur_time);
 
   auto& frame = out_message->lidar_frame_;
   frame = lidar::LidarFramePool::Instance().Get();
@@ -16,6 +16,7 @@
 
 #include "modules/perception/pointcloud_preprocess/preprocessor/pointcloud_preprocessor.h"
 
+#include <cmath>
 #include <limits>
 
 #include "modules/perception/pointcloud_preprocess/preprocessor/proto/pointcloud_preprocessor_config.pb.h"
@@ -64,41 +65,33 @@ bool PointCloudPreprocessor::Preprocess(
 
   frame->cloud->set_timestamp(message->measurement_time());
   if (message->point_size() > 0) {
-    frame->cloud->reserve(message->point_size());
-    base::PointF point;
+    // the points are filtered and transformed column by column
+    const size_t size = static_cast<size_t>(message->point_size());
+    base::SoaPointFCloud local_cloud;
+    local_cloud.resize(size);
+    local_cloud.set_timestamp(message->measurement_time());
+    float* x = local_cloud.mutable_points_x()->data();
+    float* y = local_cloud.mutable_points_y()->data();
+    float* z = local_cloud.mutable_points_z()->data();
+    float* intensity = local_cloud.mutable_points_intensity()->data();
+    double* timestamp = local_cloud.mutable_points_timestamp()->data();
+    int32_t* beam_id = local_cloud.mutable_points_beam_id()->data();
     for (int i = 0; i < message->point_size(); ++i) {
       const apollo::drivers::PointXYZIT& pt = message->point(i);
-      if (filter_naninf_points_) {
-        if (std::isnan(pt.x()) || std::isnan(pt.y()) || std::isnan(pt.z())) {
-          continue;
-        }
-        if (fabs(pt.x()) > kPointInfThreshold ||
-            fabs(pt.y()) > kPointInfThreshold ||
-            fabs(pt.z()) > kPointInfThreshold) {
-          continue;
-        }
-      }
-      Eigen::Vector3d vec3d_lidar(pt.x(), pt.y(), pt.z());
-      // Eigen::Vector3d vec3d_novatel =
-      //     options.sensor2novatel_extrinsics * vec3d_lidar;
-      Eigen::Vector3d vec3d_novatel = vec3d_lidar;
-      if (filter_nearby_box_points_ && vec3d_novatel[0] < box_forward_x_ &&
-          vec3d_novatel[0] > box_backward_x_ &&
-          vec3d_novatel[1] < box_forward_y_ &&
-          vec3d_novatel[1] > box_backward_y_) {
-        continue;
-      }
-      if (filter_high_z_points_ && pt.z() > z_threshold_) {
-        continue;
-      }
-      point.x = pt.x();
-      point.y = pt.y();
-      point.z = pt.z();
-      point.intensity = static_cast<float>(pt.intensity());
-      frame->cloud->push_back(point, static_cast<double>(pt.timestamp()) * 1e-9,
-                              std::numeric_limits<float>::max(), i, 0);
+      x[i] = pt.x();
+      y[i] = pt.y();
+      z[i] = pt.z();
+      intensity[i] = static_cast<float>(pt.intensity());
+      timestamp[i] = static_cast<double>(pt.timestamp()) * 1e-9;
+      beam_id[i] = i;
     }
-    TransformCloud(frame->cloud, frame->lidar2world_pose, frame->world_cloud);
+    base::PointMask mask;
+    MaskPoints(local_cloud, &mask);
+    local_cloud.Compact(mask);
+    base::SoaPointDCloud world_cloud;
+    local_cloud.TransformPointCloud(frame->lidar2world_pose, &world_cloud);
+    local_cloud.ToPointCloud(frame->cloud.get());
+    world_cloud.ToPointCloud(frame->world_cloud.get());
   }
 
   return true;
@@ -153,6 +146,36 @@ bool PointCloudPreprocessor::Preprocess(
   return true;
 }
 
+void PointCloudPreprocessor::MaskPoints(const base::SoaPointFCloud& cloud,
+                                        base::PointMask* mask) const {
+  const size_t size = cloud.size();
+  mask->assign(size, 1);
+  uint8_t* keep = mask->data();
+  const float* x = cloud.points_x().data();
+  const float* y = cloud.points_y().data();
+  const float* z = cloud.points_z().data();
+  // & instead of && leaves no branch in the loops
+  if (filter_naninf_points_) {
+    // the comparisons are false for nan too
+    for (size_t i = 0; i < size; ++i) {
+      keep[i] = (std::fabs(x[i]) <= kPointInfThreshold) &
+                (std::fabs(y[i]) <= kPointInfThreshold) &
+                (std::fabs(z[i]) <= kPointInfThreshold);
+    }
+  }
+  if (filter_nearby_box_points_) {
+    for (size_t i = 0; i < size; ++i) {
+      keep[i] &= !((x[i] < box_forward_x_) & (x[i] > box_backward_x_) &
+                   (y[i] < box_forward_y_) & (y[i] > box_backward_y_));
+    }
+  }
+  if (filter_high_z_points_) {
+    for (size_t i = 0; i < size; ++i) {
+      keep[i] &= !(z[i] > z_threshold_);
+    }
+  }
+}
+
 bool PointCloudPreprocessor::TransformCloud(
     const base::PointFCloudPtr& local_cloud, const Eigen::Affine3d& pose,
     base::PointDCloudPtr world_cloud) const {
@@ -22,6 +22,7 @@
 #include "modules/common_msgs/sensor_msgs/pointcloud.pb.h"
 #include "modules/perception/pointcloud_preprocess/preprocessor/proto/pointcloud_preprocessor_config.pb.h"
 
+#include "modules/perception/common/base/soa_point_cloud.h"
 #include "modules/perception/common/lidar/common/lidar_frame.h"
 #include "modules/perception/pointcloud_preprocess/interface/base_pointcloud_preprocessor.h"
 
@@ -78,6 +79,9 @@ class PointCloudPreprocessor : public BasePointCloudPreprocessor {
   bool TransformCloud(const base::PointFCloudPtr& local_cloud,
                       const Eigen::Affine3d& pose,
                       base::PointDCloudPtr world_cloud) const;
+  // @brief select the points kept by the filters
+  void MaskPoints(const base::SoaPointFCloud& cloud,
+                  base::PointMask* mask) const;
   // params
   bool filter_naninf_points_ = true;
   bool filter_nearby_box_points_ = true;
@@ -171,6 +171,17 @@ bool STBoundary::GetUnblockSRange(const double curr_time, double* s_upper,
 
 bool STBoundary::GetBoundarySRange(const double curr_time, double* s_upper,
                                    double* s_lower) const {
+  if (!GetUnclampedBoundarySRange(curr_time, s_upper, s_lower)) {
+    return false;
+  }
+  *s_upper = std::fmin(*s_upper, FLAGS_speed_lon_decision_horizon);
+  *s_lower = std::fmax(*s_lower, 0.0);
+  return true;
+}
+
+bool STBoundary::GetUnclampedBoundarySRange(const double curr_time,
+                                            double* s_upper,
+                                            double* s_lower) const {
   CHECK_NOTNULL(s_upper);
   CHECK_NOTNULL(s_lower);
   if (curr_time < min_t_ || curr_time > max_t_) {
@@ -193,9 +204,6 @@ bool STBoundary::GetBoundarySRange(const double curr_time, double* s_upper,
              r * (upper_points_[right].s() - upper_points_[left].s());
   *s_lower = lower_points_[left].s() +
              r * (lower_points_[right].s() - lower_points_[left].s());
-
-  *s_upper = std::fmin(*s_upper, FLAGS_speed_lon_decision_horizon);
-  *s_lower = std::fmax(*s_lower, 0.0);
   return true;
 }
 
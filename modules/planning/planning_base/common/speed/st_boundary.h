@@ -74,6 +74,12 @@ class STBoundary : public common::math::Polygon2d {
   bool GetBoundarySRange(const double curr_time, double* s_upper,
                          double* s_lower) const;
 
+  // Same as GetBoundarySRange but without clamping the range to
+  // [0, speed_lon_decision_horizon]; a point is in the boundary iff it lies
+  // strictly between the two, see IsPointInBoundary.
+  bool GetUnclampedBoundarySRange(const double curr_time, double* s_upper,
+                                  double* s_lower) const;
+
   bool GetBoundarySlopes(const double curr_time, double* ds_upper,
                          double* ds_lower) const;
   void PrintDebug(std::string suffix = "") const;
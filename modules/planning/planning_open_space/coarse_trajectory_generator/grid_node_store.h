@@ -0,0 +1,338 @@
+/******************************************************************************
+ * Copyright 2019 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @brief Open and closed sets of a best-first search keyed by integer grid
+ * index. Cells touched by the search live in one flat array; they are found
+ * directly by index when the grid is small enough to be dense, otherwise
+ * through an open-addressing table. The open set is a binary min-heap over
+ * those cells that supports decrease-key.
+ */
+template <typename T>
+class GridNodeStore {
+ public:
+  /**
+   * @brief Drops all cells but keeps the allocated memory.
+   * @param dense_size index cells directly in [0, dense_size), hash them
+   * when 0
+   */
+  void Reset(size_t dense_size = 0) {
+    cells_.clear();
+    heap_.clear();
+    if (dense_size > 0) {
+      dense_.assign(dense_size, 0);
+      table_.clear();
+    } else {
+      dense_.clear();
+      table_.assign(kInitialTableSize, 0);
+    }
+  }
+
+  /**
+   * @brief Puts the cell into the open set, or replaces its value when it is
+   * already open with a higher key.
+   * @return false if the cell is closed or not improved
+   */
+  bool Push(int64_t index, double key, T value) {
+    uint32_t* slot = Slot(index);
+    if (*slot == 0) {
+      cells_.push_back({index, key, kNotInHeap, false, std::move(value)});
+      *slot = static_cast<uint32_t>(cells_.size());
+      if (dense_.empty() && cells_.size() * 2 > table_.size()) {
+        Rehash();
+      }
+      const uint32_t id = static_cast<uint32_t>(cells_.size() - 1);
+      cells_[id].heap_pos = static_cast<int32_t>(heap_.size());
+      heap_.push_back(id);
+      SiftUp(heap_.size() - 1);
+      return true;
+    }
+    Cell& cell = cells_[*slot - 1];
+    if (cell.closed || key >= cell.key) {
+      return false;
+    }
+    cell.key = key;
+    cell.value = std::move(value);
+    SiftUp(cell.heap_pos);
+    return true;
+  }
+
+  /**
+   * @brief Removes the open cell with the lowest key and closes it.
+   * @return the value of the cell
+   */
+  T Pop() {
+    CHECK(!heap_.empty());
+    Cell& cell = cells_[heap_.front()];
+    cell.closed = true;
+    cell.heap_pos = kNotInHeap;
+    RemoveTop();
+    return cell.value;
+  }
+
+  double TopKey() const { return cells_[heap_.front()].key; }
+
+  bool OpenEmpty() const { return heap_.empty(); }
+
+  size_t OpenSize() const { return heap_.size(); }
+
+  size_t CellSize() const { return cells_.size(); }
+
+  // number of directly indexed cells, 0 in hash mode
+  size_t DenseSize() const { return dense_.size(); }
+
+  bool IsOpen(int64_t index) const {
+    const Cell* cell = FindCell(index);
+    return cell != nullptr && !cell->closed;
+  }
+
+  bool IsClosed(int64_t index) const {
+    const Cell* cell = FindCell(index);
+    return cell != nullptr && cell->closed;
+  }
+
+  /**
+   * @brief Value of an open or closed cell, nullptr if never pushed.
+   */
+  const T* Find(int64_t index) const {
+    const Cell* cell = FindCell(index);
+    return cell == nullptr ? nullptr : &cell->value;
+  }
+
+ private:
+  static constexpr int32_t kNotInHeap = -1;
+  static constexpr size_t kInitialTableSize = 1024;
+
+  struct Cell {
+    int64_t index;
+    double key;
+    int32_t heap_pos;
+    bool closed;
+    T value;
+  };
+
+  static size_t Hash(int64_t index) {
+    uint64_t h = static_cast<uint64_t>(index) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+
+  // dense or hash slot holding cell id + 1, 0 when the cell is unknown
+  uint32_t* Slot(int64_t index) {
+    if (!dense_.empty()) {
+      CHECK(index >= 0 && static_cast<size_t>(index) < dense_.size())
+          << "grid index " << index << " out of " << dense_.size();
+      return &dense_[index];
+    }
+    const size_t mask = table_.size() - 1;
+    size_t pos = Hash(index) & mask;
+    while (table_[pos] != 0 && cells_[table_[pos] - 1].index != index) {
+      pos = (pos + 1) & mask;
+    }
+    return &table_[pos];
+  }
+
+  const Cell* FindCell(int64_t index) const {
+    if (!dense_.empty()) {
+      if (index < 0 || static_cast<size_t>(index) >= dense_.size() ||
+          dense_[index] == 0) {
+        return nullptr;
+      }
+      return &cells_[dense_[index] - 1];
+    }
+    const size_t mask = table_.size() - 1;
+    size_t pos = Hash(index) & mask;
+    while (table_[pos] != 0) {
+      const Cell& cell = cells_[table_[pos] - 1];
+      if (cell.index == index) {
+        return &cell;
+      }
+      pos = (pos + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  void Rehash() {
+    table_.assign(table_.size() * 2, 0);
+    const size_t mask = table_.size() - 1;
+    for (size_t id = 0; id < cells_.size(); ++id) {
+      size_t pos = Hash(cells_[id].index) & mask;
+      while (table_[pos] != 0) {
+        pos = (pos + 1) & mask;
+      }
+      table_[pos] = static_cast<uint32_t>(id + 1);
+    }
+  }
+
+  void Place(size_t pos, uint32_t id) {
+    heap_[pos] = id;
+    cells_[id].heap_pos = static_cast<int32_t>(pos);
+  }
+
+  void SiftUp(size_t pos) {
+    const uint32_t id = heap_[pos];
+    const double key = cells_[id].key;
+    while (pos > 0) {
+      const size_t parent = (pos - 1) / 2;
+      if (cells_[heap_[parent]].key <= key) {
+        break;
+      }
+      Place(pos, heap_[parent]);
+      pos = parent;
+    }
+    Place(pos, id);
+  }
+
+  void RemoveTop() {
+    const uint32_t last = heap_.back();
+    heap_.pop_back();
+    if (heap_.empty()) {
+      return;
+    }
+    const double key = cells_[last].key;
+    size_t pos = 0;
+    const size_t size = heap_.size();
+    while (true) {
+      size_t child = 2 * pos + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size &&
+          cells_[heap_[child + 1]].key < cells_[heap_[child]].key) {
+        ++child;
+      }
+      if (key <= cells_[heap_[child]].key) {
+        break;
+      }
+      Place(pos, heap_[child]);
+      pos = child;
+    }
+    Place(pos, last);
+  }
+
+  std::vector<Cell> cells_;
+  std::vector<uint32_t> heap_;
+  std::vector<uint32_t> dense_;
+  std::vector<uint32_t> table_ = std::vector<uint32_t>(kInitialTableSize, 0);
+};
+
+/**
+ * @brief Fixed size slot pool backing std::allocate_shared, so search nodes
+ * and their control blocks are carved out of large blocks and recycled
+ * through a free list instead of going through the heap one by one.
+ * Requests of any other size fall back to operator new. Not thread safe, and
+ * it must outlive every node allocated from it.
+ */
+class NodePool {
+ public:
+  explicit NodePool(size_t slots_per_block = 4096)
+      : slots_per_block_(slots_per_block) {}
+
+  void* Allocate(size_t size) {
+    if (slot_size_ == 0) {
+      slot_size_ = RoundUp(size);
+    }
+    if (RoundUp(size) != slot_size_) {
+      return ::operator new(size);
+    }
+    if (free_list_ != nullptr) {
+      FreeSlot* slot = free_list_;
+      free_list_ = slot->next;
+      return slot;
+    }
+    if (blocks_.empty() || block_offset_ == slots_per_block_) {
+      blocks_.emplace_back(new char[slot_size_ * slots_per_block_]);
+      block_offset_ = 0;
+    }
+    return blocks_.back().get() + slot_size_ * block_offset_++;
+  }
+
+  void Deallocate(void* ptr, size_t size) {
+    if (RoundUp(size) != slot_size_) {
+      ::operator delete(ptr);
+      return;
+    }
+    FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+    slot->next = free_list_;
+    free_list_ = slot;
+  }
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  static size_t RoundUp(size_t size) {
+    constexpr size_t kAlign = alignof(std::max_align_t);
+    return (size + kAlign - 1) / kAlign * kAlign;
+  }
+
+  size_t slots_per_block_;
+  size_t slot_size_ = 0;
+  size_t block_offset_ = 0;
+  FreeSlot* free_list_ = nullptr;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+};
+
+template <typename T>
+class NodePoolAllocator {
+ public:
+  using value_type = T;
+
+  explicit NodePoolAllocator(NodePool* pool) : pool_(pool) {}
+  template <typename U>
+  NodePoolAllocator(const NodePoolAllocator<U>& other)  // NOLINT
+      : pool_(other.pool()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(pool_->Allocate(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t n) { pool_->Deallocate(ptr, n * sizeof(T)); }
+
+  NodePool* pool() const { return pool_; }
+
+  template <typename U>
+  bool operator==(const NodePoolAllocator<U>& other) const {
+    return pool_ == other.pool();
+  }
+  template <typename U>
+  bool operator!=(const NodePoolAllocator<U>& other) const {
+    return pool_ != other.pool();
+  }
+
+ private:
+  NodePool* pool_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_node_store.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+class GridNodeStoreTest : public ::testing::TestWithParam<size_t> {};
+
+TEST_P(GridNodeStoreTest, pop_order) {
+  GridNodeStore<int> store;
+  store.Reset(GetParam());
+  const std::vector<double> keys = {5.0, 3.0, 9.0, 1.0, 7.0, 2.0};
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_TRUE(store.Push(i * 10, keys[i], static_cast<int>(i)));
+  }
+  EXPECT_EQ(keys.size(), store.OpenSize());
+  std::vector<int> order;
+  while (!store.OpenEmpty()) {
+    order.push_back(store.Pop());
+  }
+  EXPECT_EQ(std::vector<int>({3, 5, 1, 0, 4, 2}), order);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_TRUE(store.IsClosed(i * 10));
+    EXPECT_FALSE(store.IsOpen(i * 10));
+  }
+}
+
+TEST_P(GridNodeStoreTest, decrease_key) {
+  GridNodeStore<int> store;
+  store.Reset(GetParam());
+  EXPECT_TRUE(store.Push(1, 4.0, 100));
+  EXPECT_TRUE(store.Push(2, 3.0, 200));
+  // a more expensive node for an open cell is dropped
+  EXPECT_FALSE(store.Push(1, 6.0, 101));
+  EXPECT_EQ(100, *store.Find(1));
+  // a cheaper one replaces it and moves up the heap
+  EXPECT_TRUE(store.Push(1, 2.0, 102));
+  EXPECT_EQ(2U, store.OpenSize());
+  EXPECT_DOUBLE_EQ(2.0, store.TopKey());
+  EXPECT_EQ(102, store.Pop());
+  // closed cells are never reopened
+  EXPECT_FALSE(store.Push(1, 0.0, 103));
+  EXPECT_EQ(102, *store.Find(1));
+  EXPECT_EQ(200, store.Pop());
+  EXPECT_TRUE(store.OpenEmpty());
+  EXPECT_EQ(nullptr, store.Find(3));
+
+  store.Reset(GetParam());
+  EXPECT_EQ(0U, store.CellSize());
+  EXPECT_FALSE(store.IsClosed(1));
+  EXPECT_TRUE(store.Push(1, 1.0, 104));
+}
+
+TEST_P(GridNodeStoreTest, many_cells) {
+  constexpr int kCellNum = 4096;
+  GridNodeStore<int> store;
+  store.Reset(GetParam() == 0 ? 0 : kCellNum);
+  for (int i = 0; i < kCellNum; ++i) {
+    // scattered keys, every cell pushed twice with the second one cheaper
+    const int index = (i * 37) % kCellNum;
+    EXPECT_TRUE(store.Push(index, kCellNum + index, index));
+    EXPECT_TRUE(store.Push(index, index, index));
+  }
+  EXPECT_EQ(static_cast<size_t>(kCellNum), store.CellSize());
+  for (int i = 0; i < kCellNum; ++i) {
+    ASSERT_EQ(i, store.Pop());
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(DenseAndHashed, GridNodeStoreTest,
+                        ::testing::Values(0, 64));
+
+TEST(NodePoolTest, allocate_shared) {
+  struct Node {
+    explicit Node(int* destroyed) : destroyed(destroyed) {}
+    ~Node() { ++*destroyed; }
+    int* destroyed;
+    double payload[4] = {0.0};
+  };
+  int destroyed = 0;
+  NodePool pool(4);
+  std::vector<std::shared_ptr<Node>> nodes;
+  for (int i = 0; i < 10; ++i) {
+    nodes.push_back(std::allocate_shared<Node>(NodePoolAllocator<Node>(&pool),
+                                               &destroyed));
+  }
+  const Node* last = nodes.back().get();
+  nodes.clear();
+  EXPECT_EQ(10, destroyed);
+  // the most recently freed slot is handed out first
+  auto reused = std::allocate_shared<Node>(NodePoolAllocator<Node>(&pool),
+                                           &destroyed);
+  EXPECT_EQ(last, reused.get());
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -20,11 +20,43 @@
 
 #include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_search.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
 namespace apollo {
 namespace planning {
 
 using apollo::common::math::Vec2d;
 
+namespace {
+// 8-connected neighbours: up, up right, right, down right, down, down left,
+// left and up left
+constexpr int kNeighborNum = 8;
+constexpr int kNeighborDx[kNeighborNum] = {0, 1, 1, 1, 0, -1, -1, -1};
+constexpr int kNeighborDy[kNeighborNum] = {1, 1, 0, -1, -1, -1, 0, 1};
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+double StepCost(const int neighbor) {
+  return (neighbor & 1) ? std::sqrt(2.0) : 1.0;
+}
+
+std::vector<std::array<double, 4>> SortedSegments(
+    const std::vector<std::vector<common::math::LineSegment2d>>&
+        linesegments_vec) {
+  std::vector<std::array<double, 4>> segments;
+  for (const auto& linesegments : linesegments_vec) {
+    for (const auto& linesegment : linesegments) {
+      segments.push_back({linesegment.start().x(), linesegment.start().y(),
+                          linesegment.end().x(), linesegment.end().y()});
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+}  // namespace
+
 GridSearch::GridSearch(const PlannerOpenSpaceConfig& open_space_conf) {
   xy_grid_resolution_ =
       open_space_conf.warm_start_config().grid_a_star_xy_resolution();
@@ -37,22 +69,48 @@ double GridSearch::EuclidDistance(
   return std::sqrt((x1 - x2) * (x1 - x2) + (y1 - y2) * (y1 - y2));
 }
 
-bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
-  const double node_grid_x = node->GetGridX();
-  const double node_grid_y = node->GetGridY();
-  if (node_grid_x > max_grid_x_ ||
-      node_grid_x < 0  ||
-      node_grid_y > max_grid_y_ ||
-      node_grid_y < 0) {
+bool GridSearch::ResetGrid(const std::vector<double>& XYbounds) {
+  if (XYbounds == XYbounds_) {
     return false;
   }
+  XYbounds_ = XYbounds;
+  // XYbounds with xmin, xmax, ymin, ymax
+  max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
+  max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
+  // the DP map belongs to the previous grid
+  dp_goal_index_ = -1;
+  return true;
+}
+
+size_t GridSearch::GridCellNum() const {
+  return static_cast<size_t>(max_grid_x_ + 1) *
+         static_cast<size_t>(max_grid_y_ + 1);
+}
+
+bool GridSearch::InGrid(const int grid_x, const int grid_y) const {
+  return grid_x >= 0 && grid_x <= max_grid_x_ && grid_y >= 0 &&
+         grid_y <= max_grid_y_;
+}
+
+Node2d GridSearch::MakeNode(const int grid_x, const int grid_y) const {
+  const int64_t grid_dim_x = static_cast<int64_t>(max_grid_x_) + 1;
+  return Node2d(grid_x, grid_y, grid_y * grid_dim_x + grid_x);
+}
+
+Node2d GridSearch::MakeNode(const double x, const double y) const {
+  // XYbounds with xmin, xmax, ymin, ymax
+  return MakeNode(static_cast<int>((x - XYbounds_[0]) / xy_grid_resolution_),
+                  static_cast<int>((y - XYbounds_[2]) / xy_grid_resolution_));
+}
+
+bool GridSearch::CheckConstraints(const Node2d& node) {
   if (obstacles_linesegments_vec_.empty()) {
     return true;
   }
   for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
     for (const common::math::LineSegment2d& linesegment :
          obstacle_linesegments) {
-      if (linesegment.DistanceTo({node->GetGridX(), node->GetGridY()})
+      if (linesegment.DistanceTo({node.GetGridX(), node.GetGridY()})
           < node_radius_) {
         return false;
       }
@@ -61,108 +119,71 @@ bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
   return true;
 }
 
-std::vector<std::shared_ptr<Node2d>> GridSearch::GenerateNextNodes(
-    std::shared_ptr<Node2d> current_node) {
-  double current_node_x = current_node->GetGridX();
-  double current_node_y = current_node->GetGridY();
-  double current_node_path_cost = current_node->GetPathCost();
-  double diagonal_distance = std::sqrt(2.0);
-  std::vector<std::shared_ptr<Node2d>> next_nodes;
-  std::shared_ptr<Node2d> up =
-      std::make_shared<Node2d>(current_node_x, current_node_y + 1.0, XYbounds_);
-  up->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> up_right = std::make_shared<Node2d>(
-      current_node_x + 1.0, current_node_y + 1.0, XYbounds_);
-  up_right->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> right =
-      std::make_shared<Node2d>(current_node_x + 1.0, current_node_y, XYbounds_);
-  right->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> down_right = std::make_shared<Node2d>(
-      current_node_x + 1.0, current_node_y - 1.0, XYbounds_);
-  down_right->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> down =
-      std::make_shared<Node2d>(current_node_x, current_node_y - 1.0, XYbounds_);
-  down->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> down_left = std::make_shared<Node2d>(
-      current_node_x - 1.0, current_node_y - 1.0, XYbounds_);
-  down_left->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> left =
-      std::make_shared<Node2d>(current_node_x - 1.0, current_node_y, XYbounds_);
-  left->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> up_left = std::make_shared<Node2d>(
-      current_node_x - 1.0, current_node_y + 1.0, XYbounds_);
-  up_left->SetPathCost(current_node_path_cost + diagonal_distance);
-
-  next_nodes.emplace_back(up);
-  next_nodes.emplace_back(up_right);
-  next_nodes.emplace_back(right);
-  next_nodes.emplace_back(down_right);
-  next_nodes.emplace_back(down);
-  next_nodes.emplace_back(down_left);
-  next_nodes.emplace_back(left);
-  next_nodes.emplace_back(up_left);
-  return next_nodes;
-}
-
 bool GridSearch::GenerateAStarPath(
     const double sx, const double sy, const double ex, const double ey,
     const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec,
     GridAStartResult* result) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
-      open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> close_set;
-  XYbounds_ = XYbounds;
-  std::shared_ptr<Node2d> start_node =
-      std::make_shared<Node2d>(sx, sy, xy_grid_resolution_, XYbounds_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
-  std::shared_ptr<Node2d> final_node_ = nullptr;
+  ResetGrid(XYbounds);
+  node_store_.Reset(GridCellNum());
   obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(start_node->GetIndex(), start_node);
-  open_pq.emplace(start_node->GetIndex(), start_node->GetCost());
+  Node2d start_node = MakeNode(sx, sy);
+  const Node2d end_node = MakeNode(ex, ey);
+  if (!InGrid(static_cast<int>(start_node.GetGridX()),
+              static_cast<int>(start_node.GetGridY())) ||
+      !InGrid(static_cast<int>(end_node.GetGridX()),
+              static_cast<int>(end_node.GetGridY()))) {
+    AERROR << "Grid A star start or end point out of XYbounds";
+    return false;
+  }
+  start_node.SetHeuristic(
+      EuclidDistance(start_node.GetGridX(), start_node.GetGridY(),
+                     end_node.GetGridX(), end_node.GetGridY()));
+  node_store_.Push(start_node.GetIndex(), start_node.GetCost(), start_node);
 
   // Grid a star begins
   size_t explored_node_num = 0;
-  while (!open_pq.empty()) {
-    std::string current_id = open_pq.top().first;
-    open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
+  bool found = false;
+  Node2d final_node;
+  while (!node_store_.OpenEmpty()) {
+    const Node2d current_node = node_store_.Pop();
     // Check destination
-    if (*(current_node) == *(end_node)) {
-      final_node_ = current_node;
+    if (current_node == end_node) {
+      final_node = current_node;
+      found = true;
       break;
     }
-    close_set.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
+    const int current_x = static_cast<int>(current_node.GetGridX());
+    const int current_y = static_cast<int>(current_node.GetGridY());
+    for (int i = 0; i < kNeighborNum; ++i) {
+      const int next_x = current_x + kNeighborDx[i];
+      const int next_y = current_y + kNeighborDy[i];
+      if (!InGrid(next_x, next_y)) {
         continue;
       }
-      if (close_set.find(next_node->GetIndex()) != close_set.end()) {
+      Node2d next_node = MakeNode(next_x, next_y);
+      if (node_store_.IsClosed(next_node.GetIndex()) ||
+          !CheckConstraints(next_node)) {
         continue;
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
+      next_node.SetPathCost(current_node.GetPathCost() + StepCost(i));
+      next_node.SetHeuristic(
+          EuclidDistance(next_node.GetGridX(), next_node.GetGridY(),
+                         end_node.GetGridX(), end_node.GetGridY()));
+      next_node.SetPreNode(current_node.GetIndex());
+      if (node_store_.Push(next_node.GetIndex(), next_node.GetCost(),
+                           next_node)) {
         ++explored_node_num;
-        next_node->SetHeuristic(
-            EuclidDistance(next_node->GetGridX(), next_node->GetGridY(),
-                           end_node->GetGridX(), end_node->GetGridY()));
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
       }
     }
   }
 
-  if (final_node_ == nullptr) {
+  if (!found) {
     AERROR << "Grid A searching return null ptr(open_set ran out)";
     return false;
   }
-  LoadGridAStarResult(result);
+  LoadGridAStarResult(final_node, result);
   ADEBUG << "explored node num is " << explored_node_num;
   return true;
 }
@@ -175,74 +196,186 @@ bool GridSearch::GenerateDpMap(
             obstacles_linesegments_vec,
         const std::vector<std::vector<common::math::LineSegment2d>>&
             soft_boundary_linesegments_vec) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
-      open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  dp_map_ = decltype(dp_map_)();
-  XYbounds_ = XYbounds;
-  // XYbounds with xmin, xmax, ymin, ymax
-  max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
-  max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
+  const bool grid_changed = ResetGrid(XYbounds);
   obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(end_node->GetIndex(), end_node);
-  open_pq.emplace(end_node->GetIndex(), end_node->GetCost());
+  const Node2d end_node = MakeNode(ex, ey);
+  if (!InGrid(static_cast<int>(end_node.GetGridX()),
+              static_cast<int>(end_node.GetGridY()))) {
+    AERROR << "DP map end point out of XYbounds";
+    dp_goal_index_ = -1;
+    return false;
+  }
+  std::vector<std::array<double, 4>> segments =
+      SortedSegments(obstacles_linesegments_vec);
+  if (grid_changed || end_node.GetIndex() != dp_goal_index_ ||
+      !RepairDpMap(segments)) {
+    RebuildDpMap(end_node.GetIndex());
+  }
+  dp_segments_ = std::move(segments);
+  return true;
+}
 
-  // Grid a star begins
-  size_t explored_node_num = 0;
-  while (!open_pq.empty()) {
-    const std::string current_id = open_pq.top().first;
-    open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
-    dp_map_.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
-        continue;
-      }
-      if (dp_map_.find(next_node->GetIndex()) != dp_map_.end()) {
-        continue;
+void GridSearch::RebuildDpMap(const int64_t goal_index) {
+  const size_t cell_num = GridCellNum();
+  dp_goal_index_ = goal_index;
+  dp_map_.assign(cell_num, kInf);
+  dp_rhs_.assign(cell_num, kInf);
+  dp_blocked_.assign(cell_num, 0);
+  dp_queue_ = decltype(dp_queue_)();
+  const int grid_dim_x = static_cast<int>(max_grid_x_) + 1;
+  for (size_t i = 0; i < cell_num; ++i) {
+    const int grid_x = static_cast<int>(i % grid_dim_x);
+    const int grid_y = static_cast<int>(i / grid_dim_x);
+    dp_blocked_[i] = !CheckConstraints(MakeNode(grid_x, grid_y));
+  }
+  // the goal itself is never checked against obstacles
+  dp_blocked_[goal_index] = 0;
+  dp_rhs_[goal_index] = 0.0;
+  dp_queue_.emplace(0.0, goal_index);
+  ComputeDpMap();
+  ADEBUG << "DP map rebuilt over " << cell_num << " cells";
+}
+
+bool GridSearch::RepairDpMap(
+    const std::vector<std::array<double, 4>>& segments) {
+  std::vector<std::array<double, 4>> changed_segments;
+  std::set_symmetric_difference(segments.begin(), segments.end(),
+                                dp_segments_.begin(), dp_segments_.end(),
+                                std::back_inserter(changed_segments));
+  if (changed_segments.empty()) {
+    return true;
+  }
+  // cells whose blocked state may have changed, in the point frame used by
+  // CheckConstraints
+  std::vector<int64_t> cells;
+  for (const auto& segment : changed_segments) {
+    const int min_x = std::max(
+        0, static_cast<int>(std::floor(std::min(segment[0], segment[2]) -
+                                       node_radius_)));
+    const int max_x = std::min(
+        static_cast<int>(max_grid_x_),
+        static_cast<int>(std::ceil(std::max(segment[0], segment[2]) +
+                                   node_radius_)));
+    const int min_y = std::max(
+        0, static_cast<int>(std::floor(std::min(segment[1], segment[3]) -
+                                       node_radius_)));
+    const int max_y = std::min(
+        static_cast<int>(max_grid_y_),
+        static_cast<int>(std::ceil(std::max(segment[1], segment[3]) +
+                                   node_radius_)));
+    for (int grid_y = min_y; grid_y <= max_y; ++grid_y) {
+      for (int grid_x = min_x; grid_x <= max_x; ++grid_x) {
+        cells.push_back(MakeNode(grid_x, grid_y).GetIndex());
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
-        ++explored_node_num;
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
-      } else {
-        if (open_set[next_node->GetIndex()]->GetCost() > next_node->GetCost()) {
-          open_set[next_node->GetIndex()]->SetCost(next_node->GetCost());
-          open_set[next_node->GetIndex()]->SetPreNode(current_node);
+    }
+    if (cells.size() > GridCellNum() / 2) {
+      return false;
+    }
+  }
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+  const int grid_dim_x = static_cast<int>(max_grid_x_) + 1;
+  size_t changed_cell_num = 0;
+  for (const int64_t index : cells) {
+    if (index == dp_goal_index_) {
+      continue;
+    }
+    const uint8_t blocked = !CheckConstraints(
+        MakeNode(static_cast<int>(index % grid_dim_x),
+                 static_cast<int>(index / grid_dim_x)));
+    if (blocked != dp_blocked_[index]) {
+      dp_blocked_[index] = blocked;
+      UpdateDpCell(index);
+      ++changed_cell_num;
+    }
+  }
+  ComputeDpMap();
+  ADEBUG << "DP map repaired for " << changed_segments.size()
+         << " changed segments, " << changed_cell_num << " changed cells";
+  return true;
+}
+
+void GridSearch::UpdateDpCell(const int64_t index) {
+  if (index != dp_goal_index_) {
+    double rhs = kInf;
+    if (!dp_blocked_[index]) {
+      const int grid_dim_x = static_cast<int>(max_grid_x_) + 1;
+      const int grid_x = static_cast<int>(index % grid_dim_x);
+      const int grid_y = static_cast<int>(index / grid_dim_x);
+      for (int i = 0; i < kNeighborNum; ++i) {
+        const int next_x = grid_x + kNeighborDx[i];
+        const int next_y = grid_y + kNeighborDy[i];
+        if (InGrid(next_x, next_y)) {
+          rhs = std::min(rhs, dp_map_[next_y * grid_dim_x + next_x] +
+                                  StepCost(i));
         }
       }
     }
+    dp_rhs_[index] = rhs;
+  }
+  if (dp_map_[index] != dp_rhs_[index]) {
+    dp_queue_.emplace(std::min(dp_map_[index], dp_rhs_[index]), index);
+  }
+}
+
+void GridSearch::ComputeDpMap() {
+  const int grid_dim_x = static_cast<int>(max_grid_x_) + 1;
+  size_t explored_node_num = 0;
+  while (!dp_queue_.empty()) {
+    const double key = dp_queue_.top().first;
+    const int64_t index = dp_queue_.top().second;
+    dp_queue_.pop();
+    const double cost = dp_map_[index];
+    const double rhs = dp_rhs_[index];
+    // entries are never removed from the queue, skip outdated ones
+    if (cost == rhs || key != std::min(cost, rhs)) {
+      continue;
+    }
+    ++explored_node_num;
+    if (cost > rhs) {
+      dp_map_[index] = rhs;
+    } else {
+      dp_map_[index] = kInf;
+      UpdateDpCell(index);
+    }
+    const int grid_x = static_cast<int>(index % grid_dim_x);
+    const int grid_y = static_cast<int>(index / grid_dim_x);
+    for (int i = 0; i < kNeighborNum; ++i) {
+      const int next_x = grid_x + kNeighborDx[i];
+      const int next_y = grid_y + kNeighborDy[i];
+      if (InGrid(next_x, next_y)) {
+        UpdateDpCell(next_y * grid_dim_x + next_x);
+      }
+    }
   }
   ADEBUG << "explored node num is " << explored_node_num;
-  return true;
 }
 
 double GridSearch::CheckDpMap(const double sx, const double sy) {
-  std::string index = Node2d::CalcIndex(sx, sy, xy_grid_resolution_, XYbounds_);
-  if (dp_map_.find(index) != dp_map_.end()) {
-    return dp_map_[index]->GetCost() * xy_grid_resolution_;
-  } else {
-    return std::numeric_limits<double>::infinity();
+  if (dp_goal_index_ < 0) {
+    return kInf;
+  }
+  const Node2d node = MakeNode(sx, sy);
+  if (!InGrid(static_cast<int>(node.GetGridX()),
+              static_cast<int>(node.GetGridY()))) {
+    return kInf;
   }
+  return dp_map_[node.GetIndex()] * xy_grid_resolution_;
 }
 
-void GridSearch::LoadGridAStarResult(GridAStartResult* result) {
-  (*result).path_cost = final_node_->GetPathCost() * xy_grid_resolution_;
-  std::shared_ptr<Node2d> current_node = final_node_;
+void GridSearch::LoadGridAStarResult(const Node2d& final_node,
+                                     GridAStartResult* result) {
+  (*result).path_cost = final_node.GetPathCost() * xy_grid_resolution_;
+  const Node2d* current_node = &final_node;
   std::vector<double> grid_a_x;
   std::vector<double> grid_a_y;
-  while (current_node->GetPreNode() != nullptr) {
+  while (current_node->GetPreNode() >= 0) {
     grid_a_x.push_back(current_node->GetGridX() * xy_grid_resolution_ +
                        XYbounds_[0]);
     grid_a_y.push_back(current_node->GetGridY() * xy_grid_resolution_ +
                        XYbounds_[2]);
-    current_node = current_node->GetPreNode();
+    current_node = node_store_.Find(current_node->GetPreNode());
   }
   std::reverse(grid_a_x.begin(), grid_a_x.end());
   std::reverse(grid_a_y.begin(), grid_a_y.end());
@@ -20,40 +20,31 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <queue>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <unordered_set>
 #include <vector>
 
-#include "absl/strings/str_cat.h"
-
 #include "modules/planning/planning_open_space/proto/planner_open_space_config.pb.h"
 
 #include "cyber/common/log.h"
 #include "modules/common/math/line_segment2d.h"
+#include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_node_store.h"
 
 namespace apollo {
 namespace planning {
 
 class Node2d {
  public:
-  Node2d(const double x, const double y, const double xy_resolution,
-         const std::vector<double>& XYbounds) {
-    // XYbounds with xmin, xmax, ymin, ymax
-    grid_x_ = static_cast<int>((x - XYbounds[0]) / xy_resolution);
-    grid_y_ = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
-  }
-  Node2d(const int grid_x, const int grid_y,
-         const std::vector<double>& XYbounds) {
-    grid_x_ = grid_x;
-    grid_y_ = grid_y;
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
-  }
+  Node2d() = default;
+  Node2d(const int grid_x, const int grid_y, const int64_t index)
+      : grid_x_(grid_x), grid_y_(grid_y), index_(index) {}
   void SetPathCost(const double path_cost) {
     path_cost_ = path_cost;
     cost_ = path_cost_ + heuristic_;
@@ -66,7 +57,7 @@ class Node2d {
   void SetDistanceToObstacle(const double dist) {
       distance_to_obstacle_ = dist;
   }
-  void SetPreNode(std::shared_ptr<Node2d> pre_node) { pre_node_ = pre_node; }
+  void SetPreNode(const int64_t pre_index) { pre_index_ = pre_index; }
   double GetGridX() const { return grid_x_; }
   double GetGridY() const { return grid_y_; }
   double GetPathCost() const { return path_cost_; }
@@ -75,34 +66,23 @@ class Node2d {
   double GetDistanceToObstacle() const {
       return distance_to_obstacle_;
   }
-  const std::string& GetIndex() const { return index_; }
-  std::shared_ptr<Node2d> GetPreNode() const { return pre_node_; }
-  static std::string CalcIndex(const double x, const double y,
-                               const double xy_resolution,
-                               const std::vector<double>& XYbounds) {
-    // XYbounds with xmin, xmax, ymin, ymax
-    int grid_x = static_cast<int>((x - XYbounds[0]) / xy_resolution);
-    int grid_y = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    return ComputeStringIndex(grid_x, grid_y);
-  }
+  // row major cell index in the search grid
+  int64_t GetIndex() const { return index_; }
+  // index of the node this one is reached from, -1 for the search root
+  int64_t GetPreNode() const { return pre_index_; }
   bool operator==(const Node2d& right) const {
     return right.GetIndex() == index_;
   }
 
- private:
-  static std::string ComputeStringIndex(int x_grid, int y_grid) {
-    return absl::StrCat(x_grid, "_", y_grid);
-  }
-
  private:
   int grid_x_ = 0;
   int grid_y_ = 0;
+  int64_t index_ = 0;
   double path_cost_ = 0.0;
   double heuristic_ = 0.0;
   double cost_ = 0.0;
   double distance_to_obstacle_ = std::numeric_limits<double>::max();
-  std::string index_;
-  std::shared_ptr<Node2d> pre_node_ = nullptr;
+  int64_t pre_index_ = -1;
 };
 
 struct GridAStartResult {
@@ -121,6 +101,12 @@ class GridSearch {
       const std::vector<std::vector<common::math::LineSegment2d>>&
           obstacles_linesegments_vec,
       GridAStartResult* result);
+  /**
+   * @brief Cost-to-go map of the holonomic heuristic towards (ex, ey). The
+   * map is kept across calls: it is rebuilt only when the goal cell or the
+   * XYbounds change, otherwise it is repaired around the obstacle line
+   * segments that were added or removed since the last call.
+   */
   bool GenerateDpMap(
           const double ex,
           const double ey,
@@ -134,10 +120,19 @@ class GridSearch {
  private:
   double EuclidDistance(const double x1, const double y1, const double x2,
                         const double y2);
-  std::vector<std::shared_ptr<Node2d>> GenerateNextNodes(
-      std::shared_ptr<Node2d> node);
-  bool CheckConstraints(std::shared_ptr<Node2d> node);
-  void LoadGridAStarResult(GridAStartResult* result);
+  // returns true if the bounds differ from the previous grid
+  bool ResetGrid(const std::vector<double>& XYbounds);
+  size_t GridCellNum() const;
+  bool InGrid(const int grid_x, const int grid_y) const;
+  Node2d MakeNode(const int grid_x, const int grid_y) const;
+  Node2d MakeNode(const double x, const double y) const;
+  bool CheckConstraints(const Node2d& node);
+  void LoadGridAStarResult(const Node2d& final_node, GridAStartResult* result);
+  void RebuildDpMap(const int64_t goal_index);
+  // returns false if the change is too large to be worth repairing
+  bool RepairDpMap(const std::vector<std::array<double, 4>>& segments);
+  void UpdateDpCell(const int64_t index);
+  void ComputeDpMap();
 
  private:
   double xy_grid_resolution_ = 0.0;
@@ -145,20 +140,26 @@ class GridSearch {
   std::vector<double> XYbounds_;
   double max_grid_x_ = 0.0;
   double max_grid_y_ = 0.0;
-  std::shared_ptr<Node2d> start_node_;
-  std::shared_ptr<Node2d> end_node_;
-  std::shared_ptr<Node2d> final_node_;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
 
-  struct cmp {
-      bool operator()(const std::pair<std::string,
-                      double>& left,
-                      const std::pair<std::string, double>& right) const {
-          return left.second >= right.second;
-      }
-  };
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> dp_map_;
+  // open and closed nodes of the running search, reused across searches
+  GridNodeStore<Node2d> node_store_;
+
+  // Incremental DP map, a goal rooted LPA* without heuristic: dp_map_ holds
+  // the settled cost-to-go in grids (infinity if the goal is unreachable) and
+  // dp_rhs_ the one step lookahead of it, cells where they differ wait in
+  // dp_queue_ keyed by the smaller one.
+  int64_t dp_goal_index_ = -1;
+  std::vector<double> dp_map_;
+  std::vector<double> dp_rhs_;
+  std::vector<uint8_t> dp_blocked_;
+  // obstacle line segments the map is built for, as sorted x1 y1 x2 y2
+  std::vector<std::array<double, 4>> dp_segments_;
+  std::priority_queue<std::pair<double, int64_t>,
+                      std::vector<std::pair<double, int64_t>>,
+                      std::greater<std::pair<double, int64_t>>>
+      dp_queue_;
 
   // park generic
  public:
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_search.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+
+class GridSearchTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    auto* warm_start_config =
+        planner_open_space_config_.mutable_warm_start_config();
+    warm_start_config->set_grid_a_star_xy_resolution(1.0);
+    warm_start_config->set_node_radius(0.5);
+  }
+
+ protected:
+  // compares the cost-to-go of every cell with a map built from scratch
+  void ExpectSameDpMap(GridSearch* grid_search, const double ex,
+                       const double ey,
+                       const std::vector<std::vector<LineSegment2d>>&
+                           obstacles_linesegments_vec) {
+    GridSearch fresh(planner_open_space_config_);
+    ASSERT_TRUE(grid_search->GenerateDpMap(ex, ey, XYbounds_,
+                                           obstacles_linesegments_vec));
+    ASSERT_TRUE(
+        fresh.GenerateDpMap(ex, ey, XYbounds_, obstacles_linesegments_vec));
+    for (double x = XYbounds_[0]; x <= XYbounds_[1]; x += 1.0) {
+      for (double y = XYbounds_[2]; y <= XYbounds_[3]; y += 1.0) {
+        const double expected = fresh.CheckDpMap(x, y);
+        const double actual = grid_search->CheckDpMap(x, y);
+        if (std::isinf(expected)) {
+          EXPECT_TRUE(std::isinf(actual)) << x << "," << y;
+        } else {
+          EXPECT_NEAR(expected, actual, 1e-9) << x << "," << y;
+        }
+      }
+    }
+  }
+
+  PlannerOpenSpaceConfig planner_open_space_config_;
+  std::vector<double> XYbounds_ = {0.0, 30.0, 0.0, 30.0};
+};
+
+TEST_F(GridSearchTest, dp_map) {
+  GridSearch grid_search(planner_open_space_config_);
+  ASSERT_TRUE(grid_search.GenerateDpMap(10.0, 10.0, XYbounds_, {}));
+  // octile distance without obstacles
+  EXPECT_DOUBLE_EQ(0.0, grid_search.CheckDpMap(10.0, 10.0));
+  EXPECT_DOUBLE_EQ(5.0, grid_search.CheckDpMap(15.0, 10.0));
+  EXPECT_DOUBLE_EQ(5.0 + 2.0 * (std::sqrt(2.0) - 1.0),
+                   grid_search.CheckDpMap(15.0, 12.0));
+  EXPECT_TRUE(std::isinf(grid_search.CheckDpMap(-1.0, 10.0)));
+
+  // a wall through the column x = 12 forces a detour around its top end
+  std::vector<std::vector<LineSegment2d>> wall = {
+      {LineSegment2d({12.0, 0.0}, {12.0, 20.0})}};
+  ASSERT_TRUE(grid_search.GenerateDpMap(10.0, 10.0, XYbounds_, wall));
+  EXPECT_TRUE(std::isinf(grid_search.CheckDpMap(12.0, 10.0)));
+  EXPECT_GT(grid_search.CheckDpMap(15.0, 10.0), 20.0);
+  ExpectSameDpMap(&grid_search, 10.0, 10.0, wall);
+}
+
+TEST_F(GridSearchTest, dp_map_repair) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> coord(0.0, 30.0);
+  std::uniform_real_distribution<double> length(-6.0, 6.0);
+  std::vector<std::vector<LineSegment2d>> obstacles(1);
+  GridSearch grid_search(planner_open_space_config_);
+  ASSERT_TRUE(grid_search.GenerateDpMap(3.0, 3.0, XYbounds_, obstacles));
+  for (int cycle = 0; cycle < 20; ++cycle) {
+    // add, move or remove a few segments, keeping the goal fixed
+    auto& segments = obstacles.front();
+    if (cycle % 4 == 3 && !segments.empty()) {
+      segments.erase(segments.begin());
+    } else {
+      const double x = coord(rng);
+      const double y = coord(rng);
+      segments.emplace_back(common::math::Vec2d(x, y),
+                            common::math::Vec2d(x + length(rng),
+                                                y + length(rng)));
+    }
+    if (cycle % 5 == 4) {
+      segments.back() = LineSegment2d(segments.back().start(),
+                                      segments.back().start() +
+                                          common::math::Vec2d(1.0, 1.0));
+    }
+    ExpectSameDpMap(&grid_search, 3.0, 3.0, obstacles);
+  }
+  // moving the goal rebuilds the map
+  ExpectSameDpMap(&grid_search, 25.0, 20.0, obstacles);
+  obstacles.front().clear();
+  ExpectSameDpMap(&grid_search, 25.0, 20.0, obstacles);
+}
+
+}  // namespace planning
+}  // namespace apollo
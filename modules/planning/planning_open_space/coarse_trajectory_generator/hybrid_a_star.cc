@@ -21,7 +21,6 @@
 #include "modules/planning/planning_open_space/coarse_trajectory_generator/hybrid_a_star.h"
 
 #include <limits>
-#include <unordered_set>
 
 #include "modules/planning/planning_base/common/path/discretized_path.h"
 #include "modules/planning/planning_base/common/speed/speed_data.h"
@@ -124,12 +123,20 @@ bool HybridAStar::AnalyticExpansion(
 
 bool HybridAStar::RSPCheck(
     const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end) {
-  std::shared_ptr<Node3d> node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
+  std::shared_ptr<Node3d> node = NewNode(
+      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi);
   return ValidityCheck(node);
 }
 
+std::shared_ptr<Node3d> HybridAStar::NewNode(
+    const std::vector<double>& traversed_x,
+    const std::vector<double>& traversed_y,
+    const std::vector<double>& traversed_phi) {
+  return std::allocate_shared<Node3d>(
+      NodePoolAllocator<Node3d>(&node_pool_), traversed_x, traversed_y,
+      traversed_phi, XYbounds_, planner_open_space_config_);
+}
+
 bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
   CHECK_NOTNULL(node);
   CHECK_GT(node->GetStepSize(), 0U);
@@ -178,9 +185,8 @@ bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
 std::shared_ptr<Node3d> HybridAStar::LoadRSPinCS(
     const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end,
     std::shared_ptr<Node3d> current_node) {
-  std::shared_ptr<Node3d> end_node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
+  std::shared_ptr<Node3d> end_node = NewNode(
+      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi);
   end_node->SetPre(current_node);
   end_node->SetTrajCost(current_node->GetTrajCost() + reeds_shepp_to_end->cost);
   return end_node;
@@ -240,9 +246,8 @@ std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
       intermediate_y.back() < XYbounds_[2]) {
     return nullptr;
   }
-  std::shared_ptr<Node3d> next_node = std::shared_ptr<Node3d>(
-      new Node3d(intermediate_x, intermediate_y, intermediate_phi, XYbounds_,
-                 planner_open_space_config_));
+  std::shared_ptr<Node3d> next_node =
+      NewNode(intermediate_x, intermediate_y, intermediate_phi);
   next_node->SetPre(current_node);
   next_node->SetDirec(traveled_distance > 0.0);
   next_node->SetSteer(steering);
@@ -712,9 +717,6 @@ bool HybridAStar::Plan(
     bool reeds_sheep_last_straight) {
   reed_shepp_generator_->reeds_sheep_last_straight_ = reeds_sheep_last_straight;
   // clear containers
-  open_set_.clear();
-  close_set_.clear();
-  open_pq_ = decltype(open_pq_)();
   final_node_ = nullptr;
   PrintCurves print_curves;
   std::vector<std::vector<common::math::LineSegment2d>>
@@ -758,11 +760,14 @@ bool HybridAStar::Plan(
   Box2d ebox(ecenter, ephi, vehicle_param_.length(), vehicle_param_.width());
   print_curves.AddPoint("vehicle_end_box", ebox.GetAllCorners());
   XYbounds_ = XYbounds;
+  // index the grid directly when it is small enough, hash it otherwise
+  static constexpr int64_t kMaxDenseGridSize = 1 << 21;
+  const int64_t grid_size =
+      Node3d::GridSize(XYbounds_, planner_open_space_config_);
+  node_store_.Reset(grid_size <= kMaxDenseGridSize ? grid_size : 0);
 // load nodes and obstacles
-  start_node_.reset(
-      new Node3d({sx}, {sy}, {sphi}, XYbounds_, planner_open_space_config_));
-  end_node_.reset(
-      new Node3d({ex}, {ey}, {ephi}, XYbounds_, planner_open_space_config_));
+  start_node_ = NewNode({sx}, {sy}, {sphi});
+  end_node_ = NewNode({ex}, {ey}, {ephi});
   AINFO << "start node" << sx << "," << sy << "," << sphi;
   AINFO << "end node " << ex << "," << ey << "," << ephi;
   if (!ValidityCheck(start_node_)) {
@@ -782,9 +787,9 @@ bool HybridAStar::Plan(
   grid_a_star_heuristic_generator_->GenerateDpMap(
       ex, ey, XYbounds_, obstacles_linesegments_vec_);
   ADEBUG << "map time " << Clock::NowInSeconds() - map_time;
-  // load open set, pq
-  open_set_.insert(start_node_->GetIndex());
-  open_pq_.emplace(start_node_, start_node_->GetCost());
+  // load open set
+  node_store_.Push(start_node_->GetIndex(), start_node_->GetCost(),
+                   start_node_);
   // Hybrid A* begins
   size_t explored_node_num = 0;
   size_t available_result_num = 0;
@@ -802,12 +807,12 @@ bool HybridAStar::Plan(
       planner_open_space_config_.warm_start_config().max_explored_num());
   static constexpr int kMaxNodeNum = 200000;
   std::vector<std::shared_ptr<Node3d>> candidate_final_nodes;
-  while (!open_pq_.empty() &&
-         open_pq_.size() < kMaxNodeNum &&
+  while (!node_store_.OpenEmpty() &&
+         node_store_.OpenSize() < kMaxNodeNum &&
          available_result_num < desired_explored_num &&
          explored_node_num < max_explored_num) {
-    std::shared_ptr<Node3d> current_node = open_pq_.top().first;
-    open_pq_.pop();
+    // popping moves the node to the close set
+    std::shared_ptr<Node3d> current_node = node_store_.Pop();
     const double rs_start_time = Clock::NowInSeconds();
     std::shared_ptr<Node3d> final_node = nullptr;
     if (AnalyticExpansion(current_node, &final_node)) {
@@ -822,7 +827,6 @@ bool HybridAStar::Plan(
     explored_node_num++;
     const double rs_end_time = Clock::NowInSeconds();
     rs_time += rs_end_time - rs_start_time;
-    close_set_.insert(current_node->GetIndex());
 
     if (Clock::NowInSeconds() - astar_start_time >
             planner_open_space_config_.warm_start_config()
@@ -833,7 +837,6 @@ bool HybridAStar::Plan(
 
     size_t begin_index = 0;
     size_t end_index = next_node_num_;
-    std::unordered_set<std::string> temp_set;
     for (size_t i = begin_index; i < end_index; ++i) {
       const double gen_node_time = Clock::NowInSeconds();
       std::shared_ptr<Node3d> next_node = Next_node_generator(current_node, i);
@@ -844,7 +847,7 @@ bool HybridAStar::Plan(
         continue;
       }
       // check if the node is already in the close set
-      if (close_set_.count(next_node->GetIndex()) > 0) {
+      if (node_store_.IsClosed(next_node->GetIndex())) {
         continue;
       }
       // collision check
@@ -853,16 +856,13 @@ bool HybridAStar::Plan(
         continue;
       }
       validity_check_time += Clock::NowInSeconds() - validity_check_start_time;
-      if (open_set_.count(next_node->GetIndex()) == 0) {
-        const double start_time = Clock::NowInSeconds();
-        CalculateNodeCost(current_node, next_node);
-        const double end_time = Clock::NowInSeconds();
-        heuristic_time += end_time - start_time;
-        temp_set.insert(next_node->GetIndex());
-        open_pq_.emplace(next_node, next_node->GetCost());
-      }
+      const double start_time = Clock::NowInSeconds();
+      CalculateNodeCost(current_node, next_node);
+      const double end_time = Clock::NowInSeconds();
+      heuristic_time += end_time - start_time;
+      // keeps the cheaper node when the grid cell is already open
+      node_store_.Push(next_node->GetIndex(), next_node->GetCost(), next_node);
     }
-    open_set_.insert(temp_set.begin(), temp_set.end());
   }
 
   if (final_node_ == nullptr) {
@@ -871,8 +871,8 @@ bool HybridAStar::Plan(
     return false;
   }
 
-  AINFO << "open_pq_.empty()" << (open_pq_.empty() ? "true" : "false");
-  AINFO << "open_pq_.size()" << open_pq_.size();
+  AINFO << "open set empty " << (node_store_.OpenEmpty() ? "true" : "false");
+  AINFO << "open set size " << node_store_.OpenSize();
   AINFO << "desired_explored_num" << desired_explored_num;
   AINFO << "min cost is : " << final_node_->GetTrajCost();
   AINFO << "max_explored_num is " << max_explored_num;
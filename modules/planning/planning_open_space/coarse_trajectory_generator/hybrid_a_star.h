@@ -21,11 +21,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
-#include <queue>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -39,6 +37,7 @@
 #include "modules/common/math/math_utils.h"
 #include "modules/planning/planning_base/common/obstacle.h"
 #include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_node_store.h"
 #include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_search.h"
 #include "modules/planning/planning_open_space/coarse_trajectory_generator/node3d.h"
 #include "modules/planning/planning_open_space/coarse_trajectory_generator/reeds_shepp_path.h"
@@ -86,6 +85,10 @@ class HybridAStar {
           std::shared_ptr<Node3d> current_node,
           std::shared_ptr<Node3d> next_node);
   double HoloObstacleHeuristic(std::shared_ptr<Node3d> next_node);
+  // nodes are carved out of node_pool_, see NodePool
+  std::shared_ptr<Node3d> NewNode(const std::vector<double>& traversed_x,
+                                  const std::vector<double>& traversed_y,
+                                  const std::vector<double>& traversed_phi);
   bool GetResult(HybridAStartResult* result);
   bool GetTemporalProfile(HybridAStartResult* result);
   bool GenerateSpeedAcceleration(HybridAStartResult* result);
@@ -124,26 +127,15 @@ class HybridAStar {
   double max_acc_jerk_ = 0.0;
   double arc_length_ = 0.0;
   std::vector<double> XYbounds_;
+  // declared before every node holder so that it is destroyed last
+  NodePool node_pool_;
   std::shared_ptr<Node3d> start_node_;
   std::shared_ptr<Node3d> end_node_;
   std::shared_ptr<Node3d> final_node_;
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec_;
-
-  struct cmp {
-      bool operator()(
-              const std::pair<std::shared_ptr<Node3d>, double>& left,
-              const std::pair<std::shared_ptr<Node3d>, double>& right) const {
-          return left.second >= right.second;
-      }
-  };
-  std::priority_queue<
-          std::pair<std::shared_ptr<Node3d>, double>,
-          std::vector<std::pair<std::shared_ptr<Node3d>, double>>,
-          cmp>
-          open_pq_;
-  std::unordered_set<std::string> open_set_;
-  std::unordered_set<std::string> close_set_;
+  // open and close set keyed by Node3d grid index
+  GridNodeStore<std::shared_ptr<Node3d>> node_store_;
   std::unique_ptr<ReedShepp> reed_shepp_generator_;
   std::unique_ptr<GridSearch> grid_a_star_heuristic_generator_;
 
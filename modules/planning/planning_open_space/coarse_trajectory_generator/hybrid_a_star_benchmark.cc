@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Measures Hybrid A* planning time on the standard parking lot config used by
+// hybrid_a_star_test: the straight drive of that test plus a parallel and a
+// perpendicular parking maneuver into a slot bounded by obstacle polylines.
+// BM_GenerateDpMap isolates building the holonomic heuristic from scratch,
+// BM_RepairDpMap the incremental update when the obstacles shift by 10cm
+// between two replanning cycles.
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/planning_base/gflags/planning_gflags.h"
+#include "modules/planning/planning_open_space/coarse_trajectory_generator/grid_search.h"
+#include "modules/planning/planning_open_space/coarse_trajectory_generator/hybrid_a_star.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+struct Scenario {
+  double sx;
+  double sy;
+  double sphi;
+  double ex;
+  double ey;
+  double ephi;
+  std::vector<double> XYbounds;
+  std::vector<std::vector<Vec2d>> obstacles;
+};
+
+const PlannerOpenSpaceConfig& Config() {
+  static const PlannerOpenSpaceConfig config = [] {
+    FLAGS_planner_open_space_config_filename =
+        "/apollo/modules/planning/planning_base/testdata/conf/"
+        "open_space_standard_parking_lot.pb.txt";
+    PlannerOpenSpaceConfig conf;
+    ACHECK(apollo::cyber::common::GetProtoFromFile(
+        FLAGS_planner_open_space_config_filename, &conf))
+        << "Failed to load open space config file "
+        << FLAGS_planner_open_space_config_filename;
+    return conf;
+  }();
+  return config;
+}
+
+// a slot of the given size opening towards +y, with the road boundary on the
+// far side of the lane
+std::vector<std::vector<Vec2d>> ParkingLot(double slot_width,
+                                           double slot_depth) {
+  const double half_width = slot_width / 2.0;
+  return {{Vec2d(-15.0, 0.0), Vec2d(-half_width, 0.0),
+           Vec2d(-half_width, -slot_depth), Vec2d(half_width, -slot_depth),
+           Vec2d(half_width, 0.0), Vec2d(15.0, 0.0)},
+          {Vec2d(-15.0, 8.0), Vec2d(15.0, 8.0)}};
+}
+
+const std::vector<Scenario>& Scenarios() {
+  static const std::vector<Scenario> scenarios = {
+      // hybrid_a_star_test test1
+      {-15.0, 0.0, 0.0, 15.0, 0.0, 0.0, {-50.0, 50.0, -50.0, 50.0},
+       {{Vec2d(1.0, 0.0), Vec2d(-1.0, 0.0)}}},
+      // parallel parking
+      {-8.0, 4.0, 0.0, -1.2, -1.2, 0.0, {-15.0, 15.0, -3.0, 8.0},
+       ParkingLot(7.0, 2.5)},
+      // perpendicular parking, reversing in
+      {-8.0, 4.0, 0.0, 0.0, -2.0, M_PI_2, {-15.0, 15.0, -6.0, 8.0},
+       ParkingLot(3.0, 5.5)},
+  };
+  return scenarios;
+}
+
+std::vector<std::vector<LineSegment2d>> ToLineSegments(
+    const std::vector<std::vector<Vec2d>>& obstacles) {
+  std::vector<std::vector<LineSegment2d>> segments_vec;
+  for (const auto& vertices : obstacles) {
+    std::vector<LineSegment2d> segments;
+    for (size_t i = 0; i + 1 < vertices.size(); ++i) {
+      segments.emplace_back(vertices[i], vertices[i + 1]);
+    }
+    segments_vec.emplace_back(std::move(segments));
+  }
+  return segments_vec;
+}
+
+void BM_HybridAStarPlan(benchmark::State& state) {
+  const Scenario& scenario = Scenarios()[state.range(0)];
+  HybridAStar hybrid_a_star(Config());
+  HybridAStartResult result;
+  for (auto _ : state) {
+    if (!hybrid_a_star.Plan(scenario.sx, scenario.sy, scenario.sphi,
+                            scenario.ex, scenario.ey, scenario.ephi,
+                            scenario.XYbounds, scenario.obstacles, &result)) {
+      state.SkipWithError("Hybrid A* failed to plan");
+      break;
+    }
+    benchmark::DoNotOptimize(result.x.data());
+  }
+  state.counters["points"] = static_cast<double>(result.x.size());
+}
+
+void BM_GenerateDpMap(benchmark::State& state) {
+  const Scenario& scenario = Scenarios()[state.range(0)];
+  const auto segments = ToLineSegments(scenario.obstacles);
+  for (auto _ : state) {
+    GridSearch grid_search(Config());
+    grid_search.GenerateDpMap(scenario.ex, scenario.ey, scenario.XYbounds,
+                              segments);
+    benchmark::DoNotOptimize(
+        grid_search.CheckDpMap(scenario.sx, scenario.sy));
+  }
+}
+
+void BM_RepairDpMap(benchmark::State& state) {
+  const Scenario& scenario = Scenarios()[state.range(0)];
+  const auto segments = ToLineSegments(scenario.obstacles);
+  auto shifted_obstacles = scenario.obstacles;
+  for (auto& vertices : shifted_obstacles) {
+    for (auto& vertex : vertices) {
+      vertex += Vec2d(0.1, 0.0);
+    }
+  }
+  const auto shifted_segments = ToLineSegments(shifted_obstacles);
+  GridSearch grid_search(Config());
+  grid_search.GenerateDpMap(scenario.ex, scenario.ey, scenario.XYbounds,
+                            segments);
+  bool shifted = false;
+  for (auto _ : state) {
+    shifted = !shifted;
+    grid_search.GenerateDpMap(scenario.ex, scenario.ey, scenario.XYbounds,
+                              shifted ? shifted_segments : segments);
+    benchmark::DoNotOptimize(
+        grid_search.CheckDpMap(scenario.sx, scenario.sy));
+  }
+}
+
+void ScenarioArgs(benchmark::internal::Benchmark* b) {
+  for (size_t i = 0; i < Scenarios().size(); ++i) {
+    b->Arg(static_cast<int>(i));
+  }
+  b->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK(BM_HybridAStarPlan)->Apply(ScenarioArgs);
+BENCHMARK(BM_GenerateDpMap)->Apply(ScenarioArgs);
+BENCHMARK(BM_RepairDpMap)->Apply(ScenarioArgs);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -20,7 +20,8 @@
 
 #include "modules/planning/planning_open_space/coarse_trajectory_generator/node3d.h"
 
-#include "absl/strings/str_cat.h"
+#include <algorithm>
+#include <cmath>
 
 #include "cyber/common/log.h"
 
@@ -29,6 +30,25 @@ namespace planning {
 
 using apollo::common::math::Box2d;
 
+namespace {
+
+// cells along x, y and phi
+void GridDims(const std::vector<double>& XYbounds,
+              const PlannerOpenSpaceConfig& open_space_conf, int* x_dim,
+              int* y_dim, int* phi_dim) {
+  const auto& warm_start_conf = open_space_conf.warm_start_config();
+  *x_dim = static_cast<int>((XYbounds[1] - XYbounds[0]) /
+                            warm_start_conf.xy_grid_resolution()) +
+           1;
+  *y_dim = static_cast<int>((XYbounds[3] - XYbounds[2]) /
+                            warm_start_conf.xy_grid_resolution()) +
+           1;
+  *phi_dim =
+      static_cast<int>(2.0 * M_PI / warm_start_conf.phi_grid_resolution()) + 1;
+}
+
+}  // namespace
+
 Node3d::Node3d(double x, double y, double phi) {
     x_ = x;
     y_ = y;
@@ -59,7 +79,8 @@ Node3d::Node3d(double x, double y, double phi,
   traversed_y_.push_back(y);
   traversed_phi_.push_back(phi);
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
+  index_ =
+      ComputeIndex(x_grid_, y_grid_, phi_grid_, XYbounds, open_space_conf);
 }
 
 Node3d::Node3d(const std::vector<double>& traversed_x,
@@ -91,7 +112,8 @@ Node3d::Node3d(const std::vector<double>& traversed_x,
   traversed_y_ = traversed_y;
   traversed_phi_ = traversed_phi;
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
+  index_ =
+      ComputeIndex(x_grid_, y_grid_, phi_grid_, XYbounds, open_space_conf);
   step_size_ = traversed_x.size();
 }
 
@@ -107,12 +129,32 @@ Box2d Node3d::GetBoundingBox(const common::VehicleParam& vehicle_param_,
   return ego_box;
 }
 
+int64_t Node3d::GridSize(const std::vector<double>& XYbounds,
+                         const PlannerOpenSpaceConfig& open_space_conf) {
+  int x_dim = 0;
+  int y_dim = 0;
+  int phi_dim = 0;
+  GridDims(XYbounds, open_space_conf, &x_dim, &y_dim, &phi_dim);
+  return static_cast<int64_t>(x_dim) * y_dim * phi_dim;
+}
+
 bool Node3d::operator==(const Node3d& right) const {
     return right.GetIndex() == index_;
 }
 
-std::string Node3d::ComputeStringIndex(int x_grid, int y_grid, int phi_grid) {
-    return absl::StrCat(x_grid, "_", y_grid, "_", phi_grid);
+int64_t Node3d::ComputeIndex(int x_grid, int y_grid, int phi_grid,
+                             const std::vector<double>& XYbounds,
+                             const PlannerOpenSpaceConfig& open_space_conf) {
+  int x_dim = 0;
+  int y_dim = 0;
+  int phi_dim = 0;
+  GridDims(XYbounds, open_space_conf, &x_dim, &y_dim, &phi_dim);
+  // out of bound positions are rejected by the search before they are used,
+  // clamping only keeps every index inside the grid
+  x_grid = std::max(0, std::min(x_grid, x_dim - 1));
+  y_grid = std::max(0, std::min(y_grid, y_dim - 1));
+  phi_grid = (phi_grid % phi_dim + phi_dim) % phi_dim;
+  return (static_cast<int64_t>(phi_grid) * y_dim + y_grid) * x_dim + x_grid;
 }
 
 }  // namespace planning
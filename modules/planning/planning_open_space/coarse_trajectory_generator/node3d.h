@@ -20,8 +20,8 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <string>
 #include <vector>
 
 #include "modules/common_msgs/config_msgs/vehicle_config.pb.h"
@@ -46,6 +46,9 @@ class Node3d {
           const std::vector<double>& XYbounds,
           const PlannerOpenSpaceConfig& open_space_conf);
   virtual ~Node3d() = default;
+  // number of cells of the x-y-phi grid, node indices are in [0, GridSize)
+  static int64_t GridSize(const std::vector<double>& XYbounds,
+                          const PlannerOpenSpaceConfig& open_space_conf);
   static apollo::common::math::Box2d GetBoundingBox(
           const common::VehicleParam& vehicle_param_,
           const double x,
@@ -76,7 +79,7 @@ class Node3d {
       return phi_;
   }
   bool operator==(const Node3d& right) const;
-  const std::string& GetIndex() const {
+  int64_t GetIndex() const {
       return index_;
   }
   size_t GetStepSize() const {
@@ -123,8 +126,10 @@ class Node3d {
   }
 
  private:
-  static std::string ComputeStringIndex(
-          int x_grid, int y_grid, int phi_grid);
+  static int64_t ComputeIndex(
+          int x_grid, int y_grid, int phi_grid,
+          const std::vector<double>& XYbounds,
+          const PlannerOpenSpaceConfig& open_space_conf);
 
  private:
   double x_ = 0.0;
@@ -137,7 +142,7 @@ class Node3d {
   int x_grid_ = 0;
   int y_grid_ = 0;
   int phi_grid_ = 0;
-  std::string index_;
+  int64_t index_ = 0;
   double traj_cost_ = 0.0;
   double heuristic_cost_ = 0.0;
   double cost_ = 0.0;
@@ -144,7 +144,7 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
       continue;
     }
 
-    auto boundary = obstacle->path_st_boundary();
+    const auto& boundary = obstacle->path_st_boundary();
 
     if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
       continue;
@@ -195,6 +195,99 @@ double DpStCost::GetSpatialPotentialCost(const StGraphPoint& point) {
   return (total_s_ - point.point().s()) * config_.spatial_potential_penalty();
 }
 
+void DpStCost::GetObstacleColumn(const double t,
+                                 ObstacleColumn* column) const {
+  column->drivable_s_lower = -kInf;
+  column->drivable_s_upper = kInf;
+  if (FLAGS_use_st_drivable_boundary) {
+    static constexpr double boundary_resolution = 0.1;
+    int index = static_cast<int>(t / boundary_resolution);
+    column->drivable_s_lower =
+        st_drivable_boundary_.st_boundary(index).s_lower();
+    column->drivable_s_upper =
+        st_drivable_boundary_.st_boundary(index).s_upper();
+  }
+  column->inside_s_lower.clear();
+  column->inside_s_upper.clear();
+  column->s_lower.clear();
+  column->s_upper.clear();
+  column->follow_distance_s = config_.safe_distance();
+  column->overtake_distance_s = StGapEstimator::EstimateSafeOvertakingGap();
+
+  // the same obstacles as GetObstacleCost considers at t
+  for (const auto* obstacle : obstacles_) {
+    if (obstacle->IsVirtual() ||
+        obstacle->LongitudinalDecision().has_stop()) {
+      continue;
+    }
+    const auto& boundary = obstacle->path_st_boundary();
+    if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
+      continue;
+    }
+    if (t < boundary.min_t() || t > boundary.max_t()) {
+      continue;
+    }
+    double s_upper = 0.0;
+    double s_lower = 0.0;
+    boundary.GetBoundarySRange(t, &s_upper, &s_lower);
+    column->s_lower.push_back(s_lower);
+    column->s_upper.push_back(s_upper);
+    // IsPointInBoundary excludes the first and last instant of the boundary
+    if (t > boundary.min_t() && t < boundary.max_t()) {
+      boundary.GetUnclampedBoundarySRange(t, &s_upper, &s_lower);
+      column->inside_s_lower.push_back(s_lower);
+      column->inside_s_upper.push_back(s_upper);
+    } else {
+      column->inside_s_lower.push_back(kInf);
+      column->inside_s_upper.push_back(-kInf);
+    }
+  }
+}
+
+void DpStCost::GetObstacleCosts(const ObstacleColumn& column, const double* s,
+                                const size_t size, double* costs) const {
+  const double weight =
+      config_.obstacle_weight() * config_.default_obstacle_cost();
+  const double follow_distance_s = column.follow_distance_s;
+  const double overtake_distance_s = column.overtake_distance_s;
+  std::fill(costs, costs + size, 0.0);
+  // obstacles in the outer loop keep the summation order of GetObstacleCost
+  // and leave a branch free inner loop over s
+  for (size_t k = 0; k < column.s_lower.size(); ++k) {
+    const double inside_s_lower = column.inside_s_lower[k];
+    const double inside_s_upper = column.inside_s_upper[k];
+    const double s_lower = column.s_lower[k];
+    const double s_upper = column.s_upper[k];
+    for (size_t i = 0; i < size; ++i) {
+      const double follow_diff =
+          s[i] < s_lower && s[i] + follow_distance_s >= s_lower
+              ? follow_distance_s - s_lower + s[i]
+              : 0.0;
+      const double overtake_diff =
+          s[i] >= s_lower && s[i] > s_upper &&
+                  s[i] <= s_upper + overtake_distance_s
+              ? overtake_distance_s + s_upper - s[i]
+              : 0.0;
+      const double s_diff = follow_diff + overtake_diff;
+      const bool inside = inside_s_lower < s[i] && s[i] < inside_s_upper;
+      costs[i] = inside ? kInf : costs[i] + weight * s_diff * s_diff;
+    }
+  }
+  for (size_t i = 0; i < size; ++i) {
+    const bool drivable =
+        s[i] >= column.drivable_s_lower && s[i] <= column.drivable_s_upper;
+    costs[i] = drivable ? costs[i] * unit_t_ : kInf;
+  }
+}
+
+void DpStCost::GetSpatialPotentialCosts(const double* s, const size_t size,
+                                        double* costs) const {
+  const double penalty = config_.spatial_potential_penalty();
+  for (size_t i = 0; i < size; ++i) {
+    costs[i] = (total_s_ - s[i]) * penalty;
+  }
+}
+
 double DpStCost::GetReferenceCost(const STPoint& point,
                                   const STPoint& reference_point) const {
   return config_.reference_weight() * (point.s() - reference_point.s()) *
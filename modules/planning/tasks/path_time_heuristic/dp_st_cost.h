@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -38,6 +39,22 @@ namespace planning {
 
 class DpStCost {
  public:
+  // Obstacle boundaries crossing one time column of the st graph, laid out
+  // as arrays so that a whole column of s can be costed in one pass.
+  struct ObstacleColumn {
+    // s outside of the drivable range costs infinity
+    double drivable_s_lower = 0.0;
+    double drivable_s_upper = 0.0;
+    // s strictly between the two is in the boundary of obstacle i
+    std::vector<double> inside_s_lower;
+    std::vector<double> inside_s_upper;
+    // boundary range the follow and overtake distances are measured from
+    std::vector<double> s_lower;
+    std::vector<double> s_upper;
+    double follow_distance_s = 0.0;
+    double overtake_distance_s = 0.0;
+  };
+
   DpStCost(const DpStSpeedOptimizerConfig& config, const double total_t,
            const double total_s, const std::vector<const Obstacle*>& obstacles,
            const STDrivableBoundary& st_drivable_boundary,
@@ -47,6 +64,16 @@ class DpStCost {
 
   double GetSpatialPotentialCost(const StGraphPoint& point);
 
+  void GetObstacleColumn(const double t, ObstacleColumn* column) const;
+
+  // Same as GetObstacleCost for the points (s[i], t) of the column.
+  void GetObstacleCosts(const ObstacleColumn& column, const double* s,
+                        const size_t size, double* costs) const;
+
+  // Same as GetSpatialPotentialCost for the points s[i].
+  void GetSpatialPotentialCosts(const double* s, const size_t size,
+                                double* costs) const;
+
   double GetReferenceCost(const STPoint& point,
                           const STPoint& reference_point) const;
 
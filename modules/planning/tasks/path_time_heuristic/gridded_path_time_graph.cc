@@ -21,8 +21,10 @@
 #include "modules/planning/tasks/path_time_heuristic/gridded_path_time_graph.h"
 
 #include <algorithm>
+#include <future>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
 
@@ -239,7 +241,12 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
 
     int count = static_cast<int>(next_highest_row) -
                 static_cast<int>(next_lowest_row) + 1;
-    if (count > 0) {
+    if (count > 0 && gridded_path_time_graph_config_
+                         .enable_batched_cost_in_dp_st_graph()) {
+      CalculateCostColumn(static_cast<uint32_t>(c),
+                          static_cast<uint32_t>(next_lowest_row),
+                          static_cast<uint32_t>(next_highest_row));
+    } else if (count > 0) {
       std::vector<std::future<void>> results;
       for (size_t r = next_lowest_row; r <= next_highest_row; ++r) {
         auto msg = std::make_shared<StGraphMessage>(c, r);
@@ -332,7 +339,63 @@ void GriddedPathTimeGraph::CalculateCostAt(
   }
 
   cost_cr.SetSpatialPotentialCost(dp_st_cost_.GetSpatialPotentialCost(cost_cr));
+  CalculateTotalCostAt(c, r);
+}
+
+void GriddedPathTimeGraph::CalculateCostColumn(const uint32_t c,
+                                               const uint32_t lowest_row,
+                                               const uint32_t highest_row) {
+  // rows are split into at most kMaxChunkNum tasks of kMinChunkRows or more,
+  // one task per cell drowns the cost evaluation in scheduling overhead
+  static constexpr uint32_t kMinChunkRows = 16;
+  static constexpr uint32_t kMaxChunkNum = 8;
+  dp_st_cost_.GetObstacleColumn(cost_table_[c][0].point().t(),
+                                &obstacle_column_);
+  const uint32_t row_num = highest_row - lowest_row + 1;
+  uint32_t chunk_num = 1;
+  if (gridded_path_time_graph_config_.enable_multi_thread_in_dp_st_graph()) {
+    chunk_num = std::max(1U, std::min(kMaxChunkNum, row_num / kMinChunkRows));
+  }
+  const uint32_t chunk_rows = (row_num + chunk_num - 1) / chunk_num;
+  std::vector<std::future<void>> results;
+  for (uint32_t begin_row = lowest_row + chunk_rows; begin_row <= highest_row;
+       begin_row += chunk_rows) {
+    const uint32_t end_row = std::min(begin_row + chunk_rows, highest_row + 1);
+    results.push_back(cyber::Async(&GriddedPathTimeGraph::CalculateCostChunk,
+                                   this, c, begin_row, end_row));
+  }
+  CalculateCostChunk(c, lowest_row,
+                     std::min(lowest_row + chunk_rows, highest_row + 1));
+  for (auto& result : results) {
+    result.get();
+  }
+}
 
+void GriddedPathTimeGraph::CalculateCostChunk(const uint32_t c,
+                                              const uint32_t begin_row,
+                                              const uint32_t end_row) {
+  const size_t size = end_row - begin_row;
+  const double* s = spatial_distance_by_index_.data() + begin_row;
+  std::vector<double> obstacle_costs(size);
+  std::vector<double> spatial_potential_costs(size);
+  dp_st_cost_.GetObstacleCosts(obstacle_column_, s, size,
+                               obstacle_costs.data());
+  dp_st_cost_.GetSpatialPotentialCosts(s, size,
+                                       spatial_potential_costs.data());
+  for (size_t i = 0; i < size; ++i) {
+    auto& cost_cr = cost_table_[c][begin_row + i];
+    cost_cr.SetObstacleCost(obstacle_costs[i]);
+    if (cost_cr.obstacle_cost() > std::numeric_limits<double>::max()) {
+      continue;
+    }
+    cost_cr.SetSpatialPotentialCost(spatial_potential_costs[i]);
+    CalculateTotalCostAt(c, static_cast<uint32_t>(begin_row + i));
+  }
+}
+
+void GriddedPathTimeGraph::CalculateTotalCostAt(const uint32_t c,
+                                                const uint32_t r) {
+  auto& cost_cr = cost_table_[c][r];
   const auto& cost_init = cost_table_[0][0];
   if (c == 0) {
     DCHECK_EQ(r, 0U) << "Incorrect. Row should be 0 with col = 0. row: " << r;
@@ -66,6 +66,16 @@ class GriddedPathTimeGraph {
   };
   void CalculateCostAt(const std::shared_ptr<StGraphMessage>& msg);
 
+  // batched mode: costs the rows [lowest_row, highest_row] of column c in
+  // coarse chunks sharing one flattened view of the obstacle boundaries
+  void CalculateCostColumn(const uint32_t c, const uint32_t lowest_row,
+                           const uint32_t highest_row);
+  void CalculateCostChunk(const uint32_t c, const uint32_t begin_row,
+                          const uint32_t end_row);
+
+  // total cost of a cell whose obstacle and spatial potential costs are set
+  void CalculateTotalCostAt(const uint32_t c, const uint32_t r);
+
   double CalculateEdgeCost(const STPoint& first, const STPoint& second,
                            const STPoint& third, const STPoint& forth,
                            const double speed_limit, const double cruise_speed);
@@ -104,6 +114,9 @@ class GriddedPathTimeGraph {
   // cost utility with configuration;
   DpStCost dp_st_cost_;
 
+  // obstacle boundaries of the column being costed in batched mode
+  DpStCost::ObstacleColumn obstacle_column_;
+
   double total_length_t_ = 0.0;
   double unit_t_ = 0.0;
   uint32_t dimension_t_ = 0;
@@ -19,6 +19,10 @@
  **/
 #include "modules/planning/tasks/path_time_heuristic/gridded_path_time_graph.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "modules/common_msgs/basic_msgs/pnc_point.pb.h"
 #include "modules/common_msgs/perception_msgs/perception_obstacle.pb.h"
@@ -107,5 +111,53 @@ TEST_F(DpStGraphTest, simple) {
   EXPECT_TRUE(ret.ok());
 }
 
+TEST_F(DpStGraphTest, batched_cost) {
+  // a leading vehicle and one cutting in later, in both cost modes
+  const std::vector<std::vector<std::pair<STPoint, STPoint>>>
+      boundaries_points = {{{STPoint(25.0, 0.0), STPoint(30.0, 0.0)},
+                            {STPoint(45.0, 7.0), STPoint(50.0, 7.0)}},
+                           {{STPoint(12.0, 3.0), STPoint(18.0, 3.0)},
+                            {STPoint(20.0, 5.0), STPoint(26.0, 5.0)}}};
+  std::vector<const Obstacle*> obstacles;
+  std::vector<const STBoundary*> boundaries;
+  for (size_t i = 0; i < boundaries_points.size(); ++i) {
+    Obstacle obstacle;
+    obstacle.SetId("o" + std::to_string(i));
+    obstacle_list_.push_back(obstacle);
+    STBoundary boundary(boundaries_points[i]);
+    boundary.set_id(obstacle_list_.back().Id());
+    obstacle_list_.back().set_path_st_boundary(boundary);
+    obstacles.push_back(&obstacle_list_.back());
+    boundaries.push_back(&obstacle_list_.back().path_st_boundary());
+  }
+
+  init_point_.set_v(8.0);
+  init_point_.set_a(0.0);
+  planning_internal::STGraphDebug st_graph_debug;
+  st_graph_data_ = StGraphData();
+  st_graph_data_.LoadData(boundaries, 30.0, init_point_, speed_limit_, 5.0,
+                          120.0, 7.0, &st_graph_debug);
+
+  std::vector<SpeedData> results;
+  for (const bool batched : {false, true}) {
+    for (const bool multi_thread : {false, true}) {
+      dp_config_.set_enable_batched_cost_in_dp_st_graph(batched);
+      dp_config_.set_enable_multi_thread_in_dp_st_graph(multi_thread);
+      GriddedPathTimeGraph dp_st_graph(st_graph_data_, dp_config_, obstacles,
+                                       init_point_);
+      SpeedData speed_data;
+      ASSERT_TRUE(dp_st_graph.Search(&speed_data).ok());
+      results.push_back(speed_data);
+    }
+  }
+  for (size_t i = 1; i < results.size(); ++i) {
+    ASSERT_EQ(results[0].size(), results[i].size());
+    for (size_t j = 0; j < results[0].size(); ++j) {
+      EXPECT_DOUBLE_EQ(results[0][j].s(), results[i][j].s());
+      EXPECT_DOUBLE_EQ(results[0][j].t(), results[i][j].t());
+    }
+  }
+}
+
 }  // namespace planning
 }  // namespace apollo
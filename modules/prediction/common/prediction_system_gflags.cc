@@ -58,6 +58,9 @@ DEFINE_bool(enable_multi_agent_pedestrian_evaluator, true, "If enable multi agen
 DEFINE_bool(enable_multi_agent_vehicle_evaluator, true, "If enable multi agent vehicle evaluator.");
 DEFINE_bool(prediction_eval_mode, false, "Set prediction to eval mode");
 DEFINE_bool(enable_multi_thread, true, "If enable multi-thread.");
+DEFINE_bool(enable_batch_evaluation, false,
+            "If group the obstacles of a frame by evaluator and run one "
+            "batched model inference per evaluator.");
 DEFINE_int32(max_thread_num, 8, "Maximal number of threads.");
 DEFINE_int32(max_caution_thread_num, 2,
              "Maximal number of threads for caution obstacles.");
@@ -36,6 +36,7 @@ DECLARE_bool(enable_multi_agent_pedestrian_evaluator);
 DECLARE_bool(enable_multi_agent_vehicle_evaluator);
 DECLARE_bool(prediction_eval_mode);
 DECLARE_bool(enable_multi_thread);
+DECLARE_bool(enable_batch_evaluation);
 DECLARE_int32(max_thread_num);
 DECLARE_int32(max_caution_thread_num);
 DECLARE_bool(enable_async_draw_base_image);
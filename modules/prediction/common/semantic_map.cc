@@ -16,6 +16,7 @@
 
 #include "modules/prediction/common/semantic_map.h"
 
+#include <cmath>
 #include <utility>
 #include <vector>
 
@@ -36,6 +37,30 @@ namespace prediction {
 
 namespace {
 
+// meters per pixel
+constexpr double kResolution = 0.1;
+constexpr int kBaseImageSize = 2000;
+// pixels per side of a map tile
+constexpr int kTileSize = 256;
+// map elements up to this far outside of a tile are drawn into it, for the
+// width of the lines
+constexpr double kTileMargin = 2.0;
+// The crop around an obstacle is 400 x 400 pixels from 200 pixels left to
+// 200 pixels right and 300 pixels ahead to 100 pixels behind of it, no
+// pixel farther than this from the obstacle ends up in it.
+constexpr int kCropRadius = 364;
+
+int FloorDiv(const int a, const int b) {
+  return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// Lower left corner of the base image around the ADC at x, snapped to the
+// pixel grid so the map tiles line up with the image pixels.
+double BaseOrigin(const double x) {
+  return std::floor((x - FLAGS_base_image_half_range) / kResolution) *
+         kResolution;
+}
+
 bool ValidFeatureHistory(const ObstacleHistory& obstacle_history,
                          const double curr_base_x, const double curr_base_y) {
   if (obstacle_history.feature_size() == 0) {
@@ -57,8 +82,10 @@ bool ValidFeatureHistory(const ObstacleHistory& obstacle_history,
 SemanticMap::SemanticMap() {}
 
 void SemanticMap::Init() {
-  curr_img_ = cv::Mat(2000, 2000, CV_8UC3, cv::Scalar(0, 0, 0));
+  curr_img_ = cv::Mat(kBaseImageSize, kBaseImageSize, CV_8UC3,
+                      cv::Scalar(0, 0, 0));
   obstacle_id_history_map_.clear();
+  map_tiles_.clear();
 #ifdef __aarch64__
   affine_transformer_.Init(cv::Size(2000, 2000), CV_8UC3);
 #endif
@@ -73,16 +100,16 @@ void SemanticMap::RunCurrFrame(
 
   ego_feature_ = obstacle_id_history_map.at(FLAGS_ego_vehicle_id).feature(0);
   if (!FLAGS_enable_async_draw_base_image) {
-    double x = ego_feature_.position().x();
-    double y = ego_feature_.position().y();
-    curr_base_x_ = x - FLAGS_base_image_half_range;
-    curr_base_y_ = y - FLAGS_base_image_half_range;
-    DrawBaseMap(x, y, curr_base_x_, curr_base_y_);
-    base_img_.copyTo(curr_img_);
+    curr_base_x_ = BaseOrigin(ego_feature_.position().x());
+    curr_base_y_ = BaseOrigin(ego_feature_.position().y());
+    DrawBaseMap(curr_base_x_, curr_base_y_, &curr_img_);
   } else {
-    base_img_.copyTo(curr_img_);
-    curr_base_x_ = base_x_;
-    curr_base_y_ = base_y_;
+    {
+      std::lock_guard<std::mutex> lock(base_img_mutex_);
+      base_img_.copyTo(curr_img_);
+      curr_base_x_ = base_x_;
+      curr_base_y_ = base_y_;
+    }
     task_future_ = cyber::Async(&SemanticMap::DrawBaseMapThread, this);
     // This is only for the first frame without base image yet
     if (!started_drawing_) {
@@ -116,30 +143,77 @@ void SemanticMap::RunCurrFrame(
   }
 }
 
-void SemanticMap::DrawBaseMap(const double x, const double y,
-                              const double base_x, const double base_y) {
-  base_img_ = cv::Mat(2000, 2000, CV_8UC3, cv::Scalar(0, 0, 0));
-  common::PointENU center_point = common::util::PointFactory::ToPointENU(x, y);
-  DrawRoads(center_point, base_x, base_y);
-  DrawJunctions(center_point, base_x, base_y);
-  DrawCrosswalks(center_point, base_x, base_y);
-  DrawLanes(center_point, base_x, base_y);
+void SemanticMap::DrawBaseMap(const double base_x, const double base_y,
+                              cv::Mat* img) {
+  img->create(kBaseImageSize, kBaseImageSize, CV_8UC3);
+  const cv::Rect image_rect(0, 0, kBaseImageSize, kBaseImageSize);
+  const int base_col = static_cast<int>(std::lround(base_x / kResolution));
+  const int base_row = static_cast<int>(std::lround(base_y / kResolution));
+  const int min_tile_x = FloorDiv(base_col, kTileSize);
+  const int max_tile_x = FloorDiv(base_col + kBaseImageSize - 1, kTileSize);
+  const int min_tile_y = FloorDiv(base_row, kTileSize);
+  const int max_tile_y = FloorDiv(base_row + kBaseImageSize - 1, kTileSize);
+  for (int tile_y = min_tile_y; tile_y <= max_tile_y; ++tile_y) {
+    for (int tile_x = min_tile_x; tile_x <= max_tile_x; ++tile_x) {
+      // image rows go down while the tiles go up in y
+      const cv::Rect tile_rect(
+          tile_x * kTileSize - base_col,
+          base_row + kBaseImageSize - (tile_y + 1) * kTileSize, kTileSize,
+          kTileSize);
+      const cv::Rect rect = tile_rect & image_rect;
+      GetMapTile(tile_x, tile_y)(rect - tile_rect.tl()).copyTo((*img)(rect));
+    }
+  }
+
+  // keep the tiles next to the image for when the ADC moves back and forth
+  for (auto it = map_tiles_.begin(); it != map_tiles_.end();) {
+    if (it->first.first < min_tile_x - 1 || it->first.first > max_tile_x + 1 ||
+        it->first.second < min_tile_y - 1 ||
+        it->first.second > max_tile_y + 1) {
+      it = map_tiles_.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 void SemanticMap::DrawBaseMapThread() {
   std::lock_guard<std::mutex> lock(draw_base_map_thread_mutex_);
-  double x = ego_feature_.position().x();
-  double y = ego_feature_.position().y();
-  base_x_ = x - FLAGS_base_image_half_range;
-  base_y_ = y - FLAGS_base_image_half_range;
-  DrawBaseMap(x, y, base_x_, base_y_);
+  const double base_x = BaseOrigin(ego_feature_.position().x());
+  const double base_y = BaseOrigin(ego_feature_.position().y());
+  // composed aside, RunCurrFrame only waits for the image to be swapped in
+  cv::Mat base_img;
+  DrawBaseMap(base_x, base_y, &base_img);
+  std::lock_guard<std::mutex> base_img_lock(base_img_mutex_);
+  base_img_ = base_img;
+  base_x_ = base_x;
+  base_y_ = base_y;
+}
+
+const cv::Mat& SemanticMap::GetMapTile(const int tile_x, const int tile_y) {
+  cv::Mat& tile = map_tiles_[std::make_pair(tile_x, tile_y)];
+  if (tile.empty()) {
+    tile = cv::Mat(kTileSize, kTileSize, CV_8UC3, cv::Scalar(0, 0, 0));
+    const double tile_length = kTileSize * kResolution;
+    const double tile_base_x = tile_x * tile_length;
+    const double tile_base_y = tile_y * tile_length;
+    common::PointENU center_point = common::util::PointFactory::ToPointENU(
+        tile_base_x + 0.5 * tile_length, tile_base_y + 0.5 * tile_length);
+    const double radius = tile_length * M_SQRT1_2 + kTileMargin;
+    DrawRoads(center_point, radius, tile_base_x, tile_base_y, &tile);
+    DrawJunctions(center_point, radius, tile_base_x, tile_base_y, &tile);
+    DrawCrosswalks(center_point, radius, tile_base_x, tile_base_y, &tile);
+    DrawLanes(center_point, radius, tile_base_x, tile_base_y, &tile);
+  }
+  return tile;
 }
 
 void SemanticMap::DrawRoads(const common::PointENU& center_point,
-                            const double base_x, const double base_y,
+                            const double radius, const double base_x,
+                            const double base_y, cv::Mat* img,
                             const cv::Scalar& color) {
   std::vector<apollo::hdmap::RoadInfoConstPtr> roads;
-  apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point, 141.4, &roads);
+  apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point, radius, &roads);
   for (const auto& road : roads) {
     for (const auto& section : road->road().section()) {
       std::vector<cv::Point> polygon;
@@ -147,21 +221,22 @@ void SemanticMap::DrawRoads(const common::PointENU& center_point,
         if (edge.type() == 2) {  // left edge
           for (const auto& segment : edge.curve().segment()) {
             for (const auto& point : segment.line_segment().point()) {
-              polygon.push_back(std::move(
-                  GetTransPoint(point.x(), point.y(), base_x, base_y)));
+              polygon.push_back(std::move(GetTransPoint(
+                  point.x(), point.y(), base_x, base_y, img->rows)));
             }
           }
         } else if (edge.type() == 3) {  // right edge
           for (const auto& segment : edge.curve().segment()) {
             for (const auto& point : segment.line_segment().point()) {
-              polygon.insert(polygon.begin(),
-                             std::move(GetTransPoint(point.x(), point.y(),
-                                                     base_x, base_y)));
+              polygon.insert(
+                  polygon.begin(),
+                  std::move(GetTransPoint(point.x(), point.y(), base_x,
+                                          base_y, img->rows)));
             }
           }
         }
       }
-      cv::fillPoly(base_img_,
+      cv::fillPoly(*img,
                    std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                    color);
     }
@@ -169,56 +244,59 @@ void SemanticMap::DrawRoads(const common::PointENU& center_point,
 }
 
 void SemanticMap::DrawJunctions(const common::PointENU& center_point,
-                                const double base_x, const double base_y,
+                                const double radius, const double base_x,
+                                const double base_y, cv::Mat* img,
                                 const cv::Scalar& color) {
   std::vector<apollo::hdmap::JunctionInfoConstPtr> junctions;
-  apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, 141.4,
+  apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, radius,
                                                    &junctions);
   for (const auto& junction : junctions) {
     std::vector<cv::Point> polygon;
     for (const auto& point : junction->junction().polygon().point()) {
-      polygon.push_back(
-          std::move(GetTransPoint(point.x(), point.y(), base_x, base_y)));
+      polygon.push_back(std::move(
+          GetTransPoint(point.x(), point.y(), base_x, base_y, img->rows)));
     }
-    cv::fillPoly(base_img_,
+    cv::fillPoly(*img,
                  std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                  color);
   }
 }
 
 void SemanticMap::DrawCrosswalks(const common::PointENU& center_point,
-                                 const double base_x, const double base_y,
+                                 const double radius, const double base_x,
+                                 const double base_y, cv::Mat* img,
                                  const cv::Scalar& color) {
   std::vector<apollo::hdmap::CrosswalkInfoConstPtr> crosswalks;
-  apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(center_point, 141.4,
+  apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(center_point, radius,
                                                     &crosswalks);
   for (const auto& crosswalk : crosswalks) {
     std::vector<cv::Point> polygon;
     for (const auto& point : crosswalk->crosswalk().polygon().point()) {
-      polygon.push_back(
-          std::move(GetTransPoint(point.x(), point.y(), base_x, base_y)));
+      polygon.push_back(std::move(
+          GetTransPoint(point.x(), point.y(), base_x, base_y, img->rows)));
     }
-    cv::fillPoly(base_img_,
+    cv::fillPoly(*img,
                  std::vector<std::vector<cv::Point>>({std::move(polygon)}),
                  color);
   }
 }
 
 void SemanticMap::DrawLanes(const common::PointENU& center_point,
-                            const double base_x, const double base_y,
+                            const double radius, const double base_x,
+                            const double base_y, cv::Mat* img,
                             const cv::Scalar& color) {
   std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
-  apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point, 141.4, &lanes);
+  apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point, radius, &lanes);
   for (const auto& lane : lanes) {
     // Draw lane_central first
     for (const auto& segment : lane->lane().central_curve().segment()) {
       for (int i = 0; i < segment.line_segment().point_size() - 1; ++i) {
-        const auto& p0 =
-            GetTransPoint(segment.line_segment().point(i).x(),
-                          segment.line_segment().point(i).y(), base_x, base_y);
+        const auto& p0 = GetTransPoint(segment.line_segment().point(i).x(),
+                                       segment.line_segment().point(i).y(),
+                                       base_x, base_y, img->rows);
         const auto& p1 = GetTransPoint(segment.line_segment().point(i + 1).x(),
                                        segment.line_segment().point(i + 1).y(),
-                                       base_x, base_y);
+                                       base_x, base_y, img->rows);
         double theta = atan2(segment.line_segment().point(i + 1).y() -
                                  segment.line_segment().point(i).y(),
                              segment.line_segment().point(i + 1).x() -
@@ -232,7 +310,7 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
         //     cv::Scalar(rgb.at<float>(0, 0) * 255, rgb.at<float>(0, 1) * 255,
         //                rgb.at<float>(0, 2) * 255);
 
-        cv::line(base_img_, p0, p1, HSVtoRGB(H), 4);
+        cv::line(*img, p0, p1, HSVtoRGB(H), 4);
       }
     }
     // Not drawing boundary for virtual city_driving lane
@@ -243,26 +321,26 @@ void SemanticMap::DrawLanes(const common::PointENU& center_point,
     // Draw lane's left_boundary
     for (const auto& segment : lane->lane().left_boundary().curve().segment()) {
       for (int i = 0; i < segment.line_segment().point_size() - 1; ++i) {
-        const auto& p0 =
-            GetTransPoint(segment.line_segment().point(i).x(),
-                          segment.line_segment().point(i).y(), base_x, base_y);
+        const auto& p0 = GetTransPoint(segment.line_segment().point(i).x(),
+                                       segment.line_segment().point(i).y(),
+                                       base_x, base_y, img->rows);
         const auto& p1 = GetTransPoint(segment.line_segment().point(i + 1).x(),
                                        segment.line_segment().point(i + 1).y(),
-                                       base_x, base_y);
-        cv::line(base_img_, p0, p1, color, 2);
+                                       base_x, base_y, img->rows);
+        cv::line(*img, p0, p1, color, 2);
       }
     }
     // Draw lane's right_boundary
     for (const auto& segment :
          lane->lane().right_boundary().curve().segment()) {
       for (int i = 0; i < segment.line_segment().point_size() - 1; ++i) {
-        const auto& p0 =
-            GetTransPoint(segment.line_segment().point(i).x(),
-                          segment.line_segment().point(i).y(), base_x, base_y);
+        const auto& p0 = GetTransPoint(segment.line_segment().point(i).x(),
+                                       segment.line_segment().point(i).y(),
+                                       base_x, base_y, img->rows);
         const auto& p1 = GetTransPoint(segment.line_segment().point(i + 1).x(),
                                        segment.line_segment().point(i + 1).y(),
-                                       base_x, base_y);
-        cv::line(base_img_, p0, p1, color, 2);
+                                       base_x, base_y, img->rows);
+        cv::line(*img, p0, p1, color, 2);
       }
     }
   }
@@ -292,7 +370,7 @@ cv::Scalar SemanticMap::HSVtoRGB(double H, double S, double V) {
 
 void SemanticMap::DrawRect(const Feature& feature, const cv::Scalar& color,
                            const double base_x, const double base_y,
-                           cv::Mat* img) {
+                           cv::Mat* img, const cv::Point& offset) {
   double obs_l = feature.length();
   double obs_w = feature.width();
   double obs_x = feature.position().x();
@@ -317,36 +395,37 @@ void SemanticMap::DrawRect(const Feature& feature, const cv::Scalar& color,
       obs_x + (cos(theta) * obs_l - sin(theta) * -obs_w) / 2,
       obs_y + (sin(theta) * obs_l + cos(theta) * -obs_w) / 2, base_x, base_y)));
   cv::fillPoly(*img, std::vector<std::vector<cv::Point>>({std::move(polygon)}),
-               color);
+               color, cv::LINE_8, 0, offset);
 }
 
 void SemanticMap::DrawPoly(const Feature& feature, const cv::Scalar& color,
                            const double base_x, const double base_y,
-                           cv::Mat* img) {
+                           cv::Mat* img, const cv::Point& offset) {
   std::vector<cv::Point> polygon;
   for (auto& polygon_point : feature.polygon_point()) {
     polygon.push_back(std::move(
         GetTransPoint(polygon_point.x(), polygon_point.y(), base_x, base_y)));
   }
   cv::fillPoly(*img, std::vector<std::vector<cv::Point>>({std::move(polygon)}),
-               color);
+               color, cv::LINE_8, 0, offset);
 }
 
 void SemanticMap::DrawHistory(const ObstacleHistory& history,
                               const cv::Scalar& color, const double base_x,
-                              const double base_y, cv::Mat* img) {
+                              const double base_y, cv::Mat* img,
+                              const cv::Point& offset) {
   for (int i = history.feature_size() - 1; i >= 0; --i) {
     const Feature& feature = history.feature(i);
     double time_decay = 1.0 - ego_feature_.timestamp() + feature.timestamp();
     cv::Scalar decay_color = color * time_decay;
     if (feature.id() == FLAGS_ego_vehicle_id) {
-      DrawRect(feature, decay_color, base_x, base_y, img);
+      DrawRect(feature, decay_color, base_x, base_y, img, offset);
     } else {
       if (feature.polygon_point_size() == 0) {
         AERROR << "No polygon points in feature, please check!";
         continue;
       }
-      DrawPoly(feature, decay_color, base_x, base_y, img);
+      DrawPoly(feature, decay_color, base_x, base_y, img, offset);
     }
   }
 }
@@ -371,26 +450,42 @@ cv::Mat SemanticMap::CropArea(const cv::Mat& input_img,
 #ifdef __aarch64__
   affine_transformer_.AffineTransformsFromMat(input_img,
     center_point, heading, 1.0, &rotated_mat);
+  cv::Rect rect(center_point.x - 200, center_point.y - 300, 400, 400);
+  rotated_mat = rotated_mat(rect);
 #else
+  // Rotate and move the crop to the origin in one warp, only the 400 x 400
+  // pixels of the crop are computed.
   cv::Mat rotation_mat =
       cv::getRotationMatrix2D(center_point, 90.0 - heading * 180.0 / M_PI, 1.0);
-  cv::warpAffine(input_img, rotated_mat, rotation_mat, input_img.size());
+  rotation_mat.at<double>(0, 2) -= center_point.x - 200;
+  rotation_mat.at<double>(1, 2) -= center_point.y - 300;
+  cv::warpAffine(input_img, rotated_mat, rotation_mat, cv::Size(400, 400));
 #endif
-  cv::Rect rect(center_point.x - 200, center_point.y - 300, 400, 400);
   cv::Mat output_img;
-  cv::resize(rotated_mat(rect), output_img, cv::Size(224, 224));
+  cv::resize(rotated_mat, output_img, cv::Size(224, 224));
   return output_img;
 }
 
 cv::Mat SemanticMap::CropByHistory(const ObstacleHistory& history,
                                    const cv::Scalar& color, const double base_x,
                                    const double base_y) {
-  cv::Mat feature_map = curr_img_.clone();
-  DrawHistory(history, color, base_x, base_y, &feature_map);
   const Feature& curr_feature = history.feature(0);
   const cv::Point2i& center_point = GetTransPoint(
       curr_feature.position().x(), curr_feature.position().y(), base_x, base_y);
+#ifdef __aarch64__
+  cv::Mat feature_map = curr_img_.clone();
+  DrawHistory(history, color, base_x, base_y, &feature_map);
   return CropArea(feature_map, center_point, curr_feature.theta());
+#else
+  // Only the pixels around the obstacle are copied out of the image shared
+  // by all obstacles of the frame to draw its history on.
+  cv::Rect rect(center_point.x - kCropRadius, center_point.y - kCropRadius,
+                2 * kCropRadius + 1, 2 * kCropRadius + 1);
+  rect &= cv::Rect(0, 0, curr_img_.cols, curr_img_.rows);
+  cv::Mat feature_map = curr_img_(rect).clone();
+  DrawHistory(history, color, base_x, base_y, &feature_map, -rect.tl());
+  return CropArea(feature_map, center_point - rect.tl(), curr_feature.theta());
+#endif
 }
 
 bool SemanticMap::GetMapById(const int obstacle_id, cv::Mat* feature_map) {
@@ -16,9 +16,13 @@
 
 #pragma once
 
+#include <cmath>
 #include <future>
+#include <map>
 #include <unordered_map>
+#include <utility>
 
+#include "gtest/gtest.h"
 #include "opencv2/opencv.hpp"
 
 #include "cyber/common/macros.h"
@@ -46,42 +50,55 @@ class SemanticMap {
 
  private:
   cv::Point2i GetTransPoint(const double x, const double y, const double base_x,
-                            const double base_y) {
-    return cv::Point2i(static_cast<int>((x - base_x) / 0.1),
-                       static_cast<int>(2000 - (y - base_y) / 0.1));
+                            const double base_y, const int rows = 2000) {
+    // floored, a cast rounds the points left and below of the base toward
+    // it and shifts them by a pixel against the map tiles
+    return cv::Point2i(static_cast<int>(std::floor((x - base_x) / 0.1)),
+                       static_cast<int>(std::floor(rows - (y - base_y) / 0.1)));
   }
 
-  void DrawBaseMap(const double x, const double y, const double base_x,
-                   const double base_y);
+  // Compose the map layer of the 2000 x 2000 image with its lower left
+  // corner at (base_x, base_y) from the map tiles. base_x and base_y have to
+  // be on the pixel grid.
+  void DrawBaseMap(const double base_x, const double base_y, cv::Mat* img);
 
   void DrawBaseMapThread();
 
-  void DrawRoads(const common::PointENU& center_point, const double base_x,
-                 const double base_y,
+  // The map tile with the given index, rendered on first use.
+  const cv::Mat& GetMapTile(const int tile_x, const int tile_y);
+
+  void DrawRoads(const common::PointENU& center_point, const double radius,
+                 const double base_x, const double base_y, cv::Mat* img,
                  const cv::Scalar& color = cv::Scalar(64, 64, 64));
 
-  void DrawJunctions(const common::PointENU& center_point, const double base_x,
-                     const double base_y,
+  void DrawJunctions(const common::PointENU& center_point, const double radius,
+                     const double base_x, const double base_y, cv::Mat* img,
                      const cv::Scalar& color = cv::Scalar(128, 128, 128));
 
-  void DrawCrosswalks(const common::PointENU& center_point, const double base_x,
-                      const double base_y,
+  void DrawCrosswalks(const common::PointENU& center_point,
+                      const double radius, const double base_x,
+                      const double base_y, cv::Mat* img,
                       const cv::Scalar& color = cv::Scalar(192, 192, 192));
 
-  void DrawLanes(const common::PointENU& center_point, const double base_x,
-                 const double base_y,
+  void DrawLanes(const common::PointENU& center_point, const double radius,
+                 const double base_x, const double base_y, cv::Mat* img,
                  const cv::Scalar& color = cv::Scalar(255, 255, 255));
 
   cv::Scalar HSVtoRGB(double H = 1.0, double S = 1.0, double V = 1.0);
 
+  // offset is added to the pixels of the feature, to draw into a part of
+  // the image
   void DrawRect(const Feature& feature, const cv::Scalar& color,
-                const double base_x, const double base_y, cv::Mat* img);
+                const double base_x, const double base_y, cv::Mat* img,
+                const cv::Point& offset = cv::Point());
 
   void DrawPoly(const Feature& feature, const cv::Scalar& color,
-                const double base_x, const double base_y, cv::Mat* img);
+                const double base_x, const double base_y, cv::Mat* img,
+                const cv::Point& offset = cv::Point());
 
   void DrawHistory(const ObstacleHistory& history, const cv::Scalar& color,
-                   const double base_x, const double base_y, cv::Mat* img);
+                   const double base_x, const double base_y, cv::Mat* img,
+                   const cv::Point& offset = cv::Point());
 
   // Draw adc trajectory in semantic map
   void DrawADCTrajectory(const cv::Scalar& color, const double base_x,
@@ -93,11 +110,15 @@ class SemanticMap {
   cv::Mat CropByHistory(const ObstacleHistory& history, const cv::Scalar& color,
                         const double base_x, const double base_y);
 
+  FRIEND_TEST(SemanticMapTest, map_tiles_match_full_draw);
+
  private:
   // base_image, base_x, and base_y to be updated by async thread
   cv::Mat base_img_;
   double base_x_ = 0.0;
   double base_y_ = 0.0;
+  // guards base_img_, base_x_ and base_y_
+  std::mutex base_img_mutex_;
 
   std::mutex draw_base_map_thread_mutex_;
 
@@ -113,6 +134,10 @@ class SemanticMap {
 
   bool started_drawing_ = false;
 
+  // Map layer in tiles aligned to the world grid, only the tiles the image
+  // moved onto are rendered. Used by the thread drawing the base map.
+  std::map<std::pair<int, int>, cv::Mat> map_tiles_;
+
 #ifdef __aarch64__
   AffineTransform affine_transformer_;
 #endif
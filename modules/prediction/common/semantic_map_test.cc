@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright 2019 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/prediction/common/semantic_map.h"
+
+#include <cmath>
+
+#include "modules/common/util/point_factory.h"
+#include "modules/prediction/common/kml_map_based_test.h"
+
+namespace apollo {
+namespace prediction {
+
+class SemanticMapTest : public KMLMapBasedTest {};
+
+TEST_F(SemanticMapTest, map_tiles_match_full_draw) {
+  SemanticMap semantic_map;
+  semantic_map.Init();
+
+  // on the pixel grid and not on the tile grid, so the tiles stick out of
+  // the image on every side
+  const double base_x = 24.0;
+  const double base_y = 248.0;
+  cv::Mat stitched_img;
+  semantic_map.DrawBaseMap(base_x, base_y, &stitched_img);
+
+  // the whole image drawn at once
+  cv::Mat full_img(2000, 2000, CV_8UC3, cv::Scalar(0, 0, 0));
+  const common::PointENU center_point =
+      common::util::PointFactory::ToPointENU(base_x + 100.0, base_y + 100.0);
+  const double radius = 100.0 * M_SQRT2 + 2.0;
+  semantic_map.DrawRoads(center_point, radius, base_x, base_y, &full_img);
+  semantic_map.DrawJunctions(center_point, radius, base_x, base_y, &full_img);
+  semantic_map.DrawCrosswalks(center_point, radius, base_x, base_y,
+                              &full_img);
+  semantic_map.DrawLanes(center_point, radius, base_x, base_y, &full_img);
+
+  ASSERT_EQ(full_img.size(), stitched_img.size());
+  int map_pixels = 0;
+  int different_pixels = 0;
+  for (int row = 0; row < full_img.rows; ++row) {
+    for (int col = 0; col < full_img.cols; ++col) {
+      const cv::Vec3b& pixel = full_img.at<cv::Vec3b>(row, col);
+      if (pixel != cv::Vec3b(0, 0, 0)) {
+        ++map_pixels;
+      }
+      if (pixel != stitched_img.at<cv::Vec3b>(row, col)) {
+        ++different_pixels;
+      }
+    }
+  }
+  EXPECT_GT(map_pixels, 0);
+  EXPECT_EQ(0, different_pixels);
+}
+
+}  // namespace prediction
+}  // namespace apollo
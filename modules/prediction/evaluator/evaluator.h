@@ -27,6 +27,8 @@
 
 #include "modules/prediction/container/obstacles/obstacle.h"
 
+#include "modules/prediction/common/prediction_system_gflags.h"
+#include "modules/prediction/common/prediction_thread_pool.h"
 #include "modules/prediction/container/obstacles/obstacles_container.h"
 #include "modules/prediction/container/adc_trajectory/adc_trajectory_container.h"
 
@@ -83,12 +85,55 @@ class Evaluator {
                         ObstaclesContainer* obstacles_container) {
     return Evaluate(obstacle, obstacles_container);
   }
+
+  /**
+   * @brief Evaluate all obstacles of a frame that were assigned to this
+   *        evaluator. Evaluators with a learned model override it to run a
+   *        single batched forward pass, the default evaluates the obstacles
+   *        one by one.
+   * @param Obstacle pointers
+   * @param Obstacles container
+   * @param Obstacles whose evaluation failed
+   */
+  virtual void EvaluateBatch(const std::vector<Obstacle*>& obstacles,
+                             ObstaclesContainer* obstacles_container,
+                             std::vector<Obstacle*>* failed_obstacles) {
+    std::vector<int> evaluated(obstacles.size(), 0);
+    auto evaluate = [&](size_t i) {
+      evaluated[i] = Evaluate(obstacles[i], obstacles_container);
+    };
+    ForEachObstacle(obstacles.size(), evaluate);
+    for (size_t i = 0; i < obstacles.size(); ++i) {
+      if (!evaluated[i]) {
+        failed_obstacles->push_back(obstacles[i]);
+      }
+    }
+  }
+
   /**
    * @brief Get the name of evaluator
    */
   virtual std::string GetName() = 0;
 
  protected:
+  // Calls f(i) for every obstacle index, on the prediction thread pool if
+  // multi-thread is enabled.
+  template <typename F>
+  void ForEachObstacle(size_t obstacle_num, F f) {
+    if (!FLAGS_enable_multi_thread || obstacle_num < 2) {
+      for (size_t i = 0; i < obstacle_num; ++i) {
+        f(i);
+      }
+      return;
+    }
+    std::vector<size_t> indices(obstacle_num);
+    for (size_t i = 0; i < obstacle_num; ++i) {
+      indices[i] = i;
+    }
+    PredictionThreadPool::ForEach(indices.begin(), indices.end(),
+                                  [&f](size_t i) { f(i); });
+  }
+
   // Helper function to convert world coordinates to relative coordinates
   // around the obstacle of interest.
   std::pair<double, double> WorldCoordToObjCoord(
@@ -0,0 +1,184 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Evaluator latency of one frame with 20, 50 and 100 obstacles. The Single
+// benchmarks call Evaluate once per obstacle the way EvaluatorManager does
+// without --enable_batch_evaluation, the Batch ones hand the whole frame to
+// EvaluateBatch which runs one forward pass per model. The obstacles are
+// copies of the ones in the prediction testdata, run from the repo root:
+//   evaluator_batch_benchmark --enable_multi_thread=true
+// Time is the latency of a frame, obstacles_per_second the throughput.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+#include "modules/common/configs/config_gflags.h"
+#include "modules/prediction/common/junction_analyzer.h"
+#include "modules/prediction/common/prediction_gflags.h"
+#include "modules/prediction/container/obstacles/obstacles_container.h"
+#include "modules/prediction/evaluator/vehicle/cruise_mlp_evaluator.h"
+#include "modules/prediction/evaluator/vehicle/junction_mlp_evaluator.h"
+
+namespace apollo {
+namespace prediction {
+namespace {
+
+// copies of the first obstacle of the file with the ids 1 to obstacle_num
+apollo::perception::PerceptionObstacles LoadFrame(const std::string& file,
+                                                  int obstacle_num) {
+  apollo::perception::PerceptionObstacles perception_obstacles;
+  ACHECK(cyber::common::GetProtoFromFile(file, &perception_obstacles));
+  apollo::perception::PerceptionObstacles frame = perception_obstacles;
+  frame.clear_perception_obstacle();
+  for (int id = 1; id <= obstacle_num; ++id) {
+    auto* perception_obstacle = frame.add_perception_obstacle();
+    *perception_obstacle = perception_obstacles.perception_obstacle(0);
+    perception_obstacle->set_id(id);
+  }
+  return frame;
+}
+
+std::vector<Obstacle*> FrameObstacles(ObstaclesContainer* container,
+                                      int obstacle_num) {
+  std::vector<Obstacle*> obstacles;
+  for (int id = 1; id <= obstacle_num; ++id) {
+    obstacles.push_back(container->GetObstacle(id));
+  }
+  return obstacles;
+}
+
+CruiseMLPEvaluator* SharedCruiseEvaluator() {
+  static CruiseMLPEvaluator* evaluator = new CruiseMLPEvaluator();
+  return evaluator;
+}
+
+JunctionMLPEvaluator* SharedJunctionEvaluator() {
+  static JunctionMLPEvaluator* evaluator = new JunctionMLPEvaluator();
+  return evaluator;
+}
+
+void RunCruise(benchmark::State& state, bool batch) {
+  const int obstacle_num = static_cast<int>(state.range(0));
+  ObstaclesContainer container;
+  container.Insert(LoadFrame(
+      "modules/prediction/testdata/single_perception_vehicle_onlane.pb.txt",
+      obstacle_num));
+  container.BuildLaneGraph();
+  const std::vector<Obstacle*> obstacles =
+      FrameObstacles(&container, obstacle_num);
+  CruiseMLPEvaluator* evaluator = SharedCruiseEvaluator();
+  std::vector<Obstacle*> failed_obstacles;
+  for (auto _ : state) {
+    if (batch) {
+      failed_obstacles.clear();
+      evaluator->EvaluateBatch(obstacles, &container, &failed_obstacles);
+    } else {
+      for (Obstacle* obstacle : obstacles) {
+        evaluator->Evaluate(obstacle, &container);
+      }
+    }
+  }
+  state.counters["obstacles_per_second"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * obstacle_num),
+      benchmark::Counter::kIsRate);
+}
+
+void RunJunction(benchmark::State& state, bool batch) {
+  const int obstacle_num = static_cast<int>(state.range(0));
+  FLAGS_enable_all_junction = true;
+  ObstaclesContainer container;
+  container.GetJunctionAnalyzer()->Init("j2");
+  container.Insert(LoadFrame(
+      "modules/prediction/testdata/single_perception_vehicle_injunction.pb.txt",
+      obstacle_num));
+  container.BuildJunctionFeature();
+  const std::vector<Obstacle*> obstacles =
+      FrameObstacles(&container, obstacle_num);
+  JunctionMLPEvaluator* evaluator = SharedJunctionEvaluator();
+  std::vector<Obstacle*> failed_obstacles;
+  for (auto _ : state) {
+    // every evaluation appends the probabilities of the junction feature
+    state.PauseTiming();
+    for (Obstacle* obstacle : obstacles) {
+      obstacle->mutable_latest_feature()
+          ->mutable_junction_feature()
+          ->clear_junction_mlp_probability();
+    }
+    state.ResumeTiming();
+    if (batch) {
+      failed_obstacles.clear();
+      evaluator->EvaluateBatch(obstacles, &container, &failed_obstacles);
+    } else {
+      for (Obstacle* obstacle : obstacles) {
+        evaluator->Evaluate(obstacle, &container);
+      }
+    }
+  }
+  state.counters["obstacles_per_second"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * obstacle_num),
+      benchmark::Counter::kIsRate);
+}
+
+void BM_CruiseMLPSingle(benchmark::State& state) { RunCruise(state, false); }
+BENCHMARK(BM_CruiseMLPSingle)
+    ->Arg(20)
+    ->Arg(50)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CruiseMLPBatch(benchmark::State& state) { RunCruise(state, true); }
+BENCHMARK(BM_CruiseMLPBatch)
+    ->Arg(20)
+    ->Arg(50)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_JunctionMLPSingle(benchmark::State& state) {
+  RunJunction(state, false);
+}
+BENCHMARK(BM_JunctionMLPSingle)
+    ->Arg(20)
+    ->Arg(50)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_JunctionMLPBatch(benchmark::State& state) {
+  RunJunction(state, true);
+}
+BENCHMARK(BM_JunctionMLPBatch)
+    ->Arg(20)
+    ->Arg(50)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace prediction
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  FLAGS_map_dir = "modules/prediction/testdata";
+  FLAGS_base_map_filename = "kml_map.bin";
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -17,6 +17,7 @@
 #include "modules/prediction/evaluator/evaluator_manager.h"
 
 #include <algorithm>
+#include <map>
 
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/prediction/common/feature_output.h"
@@ -235,7 +236,9 @@ void EvaluatorManager::Run(
           << time_cost_multi.count() * 1000 << " ms.";
   }
 
-  if (FLAGS_enable_multi_thread) {
+  if (FLAGS_enable_batch_evaluation) {
+    EvaluateObstaclesInBatch(adc_trajectory_container, obstacles_container);
+  } else if (FLAGS_enable_multi_thread) {
     IdObstacleListMap id_obstacle_map;
     GroupObstaclesByObstacleIds(obstacles_container, &id_obstacle_map);
     PredictionThreadPool::ForEach(
@@ -269,47 +272,78 @@ void EvaluatorManager::EvaluateObstacle(
     Obstacle* obstacle,
     ObstaclesContainer* obstacles_container,
     std::vector<Obstacle*> dynamic_env) {
+  Evaluator* evaluator = SelectCautionEvaluator(obstacle);
+  if (evaluator != nullptr) {
+    // Evaluate and return if success
+    if (evaluator->GetName() == "JOINTLY_PREDICTION_PLANNING_EVALUATOR") {
+      if (evaluator->Evaluate(adc_trajectory_container,
+                              obstacle, obstacles_container)) {
+        return;
+      }
+      AERROR << "Obstacle: " << obstacle->id()
+             << " interaction evaluator failed,"
+             << " downgrade to normal level!";
+    } else {
+      if (evaluator->Evaluate(obstacle, obstacles_container)) {
+        return;
+      }
+      AERROR << "Obstacle: " << obstacle->id()
+             << " caution evaluator failed, downgrade to normal level!";
+    }
+  }
+
+  // if obstacle is not caution or caution_evaluator run failed
+  evaluator = SelectEvaluator(obstacle);
+  if (evaluator == nullptr) {
+    return;
+  }
+  if (obstacle->type() == PerceptionObstacle::PEDESTRIAN &&
+      evaluator == GetEvaluator(pedestrian_evaluator_)) {
+    auto start_time_inference = std::chrono::system_clock::now();
+    evaluator->Evaluate(obstacle, obstacles_container);
+    auto end_time_inference = std::chrono::system_clock::now();
+    std::chrono::duration<double> time_cost_lstm =
+        end_time_inference - start_time_inference;
+    AINFO << "semantic lstm evaluator used time: "
+          << time_cost_lstm.count() * 1000 << " ms.";
+  } else if (evaluator->GetName() == "LANE_SCANNING_EVALUATOR") {
+    evaluator->Evaluate(obstacle, obstacles_container, dynamic_env);
+  } else {
+    evaluator->Evaluate(obstacle, obstacles_container);
+  }
+}
+
+Evaluator* EvaluatorManager::SelectCautionEvaluator(Obstacle* obstacle) {
+  if (obstacle->type() != PerceptionObstacle::VEHICLE ||
+      FLAGS_enable_multi_agent_vehicle_evaluator || !obstacle->IsCaution() ||
+      obstacle->IsSlow()) {
+    return nullptr;
+  }
+  Evaluator* evaluator = nullptr;
+  if (obstacle->IsInteractiveObstacle()) {
+    evaluator = GetEvaluator(interaction_evaluator_);
+  } else if (obstacle->IsNearJunction()) {
+    evaluator = GetEvaluator(vehicle_in_junction_caution_evaluator_);
+  } else if (obstacle->IsOnLane()) {
+    evaluator = GetEvaluator(vehicle_on_lane_caution_evaluator_);
+  } else {
+    evaluator = GetEvaluator(vehicle_default_caution_evaluator_);
+  }
+  CHECK_NOTNULL(evaluator);
+  AINFO << "Caution Obstacle: " << obstacle->id() << " used "
+        << evaluator->GetName();
+  return evaluator;
+}
+
+Evaluator* EvaluatorManager::SelectEvaluator(Obstacle* obstacle) {
   Evaluator* evaluator = nullptr;
   // Select different evaluators depending on the obstacle's type.
   switch (obstacle->type()) {
     case PerceptionObstacle::VEHICLE: {
       if (FLAGS_enable_multi_agent_vehicle_evaluator) {
         AINFO << "The vehicles are evaluated by multi agent evaluator!";
-        break;
-      }
-      if (obstacle->IsCaution() && !obstacle->IsSlow()) {
-        if (obstacle->IsInteractiveObstacle()) {
-          evaluator = GetEvaluator(interaction_evaluator_);
-        } else if (obstacle->IsNearJunction()) {
-          evaluator = GetEvaluator(vehicle_in_junction_caution_evaluator_);
-        } else if (obstacle->IsOnLane()) {
-          evaluator = GetEvaluator(vehicle_on_lane_caution_evaluator_);
-        } else {
-          evaluator = GetEvaluator(vehicle_default_caution_evaluator_);
-        }
-        CHECK_NOTNULL(evaluator);
-        AINFO << "Caution Obstacle: " << obstacle->id() << " used " << evaluator->GetName();
-        // Evaluate and break if success
-        if (evaluator->GetName() == "JOINTLY_PREDICTION_PLANNING_EVALUATOR") {
-          if (evaluator->Evaluate(adc_trajectory_container,
-                                  obstacle, obstacles_container)) {
-            break;
-          } else {
-            AERROR << "Obstacle: " << obstacle->id()
-                  << " interaction evaluator failed,"
-                  << " downgrade to normal level!";
-          }
-        } else {
-          if (evaluator->Evaluate(obstacle, obstacles_container)) {
-            break;
-          } else {
-            AERROR << "Obstacle: " << obstacle->id()
-                  << " caution evaluator failed, downgrade to normal level!";
-          }
-        }
+        return nullptr;
       }
-
-      // if obstacle is not caution or caution_evaluator run failed
       if (obstacle->HasJunctionFeatureWithExits() &&
           !obstacle->IsCloseToJunctionExit()) {
         evaluator = GetEvaluator(vehicle_in_junction_evaluator_);
@@ -317,55 +351,107 @@ void EvaluatorManager::EvaluateObstacle(
         evaluator = GetEvaluator(vehicle_on_lane_evaluator_);
       } else {
         AINFO << "Obstacle: " << obstacle->id()
-               << " is neither on lane, nor in junction. Skip evaluating.";
-        break;
+              << " is neither on lane, nor in junction. Skip evaluating.";
+        return nullptr;
       }
-      AINFO << "Normal Obstacle: " << obstacle->id() << " used " << evaluator->GetName();
       CHECK_NOTNULL(evaluator);
-      if (evaluator->GetName() == "LANE_SCANNING_EVALUATOR") {
-        evaluator->Evaluate(obstacle, obstacles_container, dynamic_env);
-      } else {
-        evaluator->Evaluate(obstacle, obstacles_container);
-      }
-      break;
+      AINFO << "Normal Obstacle: " << obstacle->id() << " used "
+            << evaluator->GetName();
+      return evaluator;
     }
     case PerceptionObstacle::BICYCLE: {
       if (obstacle->IsOnLane()) {
         evaluator = GetEvaluator(cyclist_on_lane_evaluator_);
         CHECK_NOTNULL(evaluator);
-        evaluator->Evaluate(obstacle, obstacles_container);
       }
-      break;
+      return evaluator;
     }
     case PerceptionObstacle::PEDESTRIAN: {
       if (FLAGS_prediction_offline_mode ==
               PredictionConstants::kDumpDataForLearning ||
-              (!FLAGS_enable_multi_agent_pedestrian_evaluator &&
-              obstacle->latest_feature().priority().priority() ==
-              ObstaclePriority::CAUTION)) {
+          (!FLAGS_enable_multi_agent_pedestrian_evaluator &&
+           obstacle->latest_feature().priority().priority() ==
+               ObstaclePriority::CAUTION)) {
         evaluator = GetEvaluator(pedestrian_evaluator_);
         CHECK_NOTNULL(evaluator);
-        auto start_time_inference = std::chrono::system_clock::now();
-        evaluator->Evaluate(obstacle, obstacles_container);
-        auto end_time_inference = std::chrono::system_clock::now();
-        std::chrono::duration<double> time_cost_lstm =
-            end_time_inference - start_time_inference;
-        AINFO << "semantic lstm evaluator used time: "
-               << time_cost_lstm.count() * 1000 << " ms.";
-        break;
+        return evaluator;
       }
     }
     default: {
       if (obstacle->IsOnLane()) {
         evaluator = GetEvaluator(default_on_lane_evaluator_);
         CHECK_NOTNULL(evaluator);
-        evaluator->Evaluate(obstacle, obstacles_container);
       }
-      break;
+      return evaluator;
     }
   }
 }
 
+void EvaluatorManager::EvaluateObstaclesInBatch(
+    const ADCTrajectoryContainer* adc_trajectory_container,
+    ObstaclesContainer* obstacles_container) {
+  // Caution obstacles go first, the ones their caution evaluator failed on
+  // are evaluated again with the normal evaluators.
+  std::map<Evaluator*, std::vector<Obstacle*>> batches;
+  std::vector<Obstacle*> normal_obstacles;
+  for (int id : obstacles_container->curr_frame_considered_obstacle_ids()) {
+    Obstacle* obstacle = obstacles_container->GetObstacle(id);
+    if (obstacle == nullptr) {
+      continue;
+    }
+    if (obstacle->IsStill()) {
+      ADEBUG << "Ignore still obstacle [" << id << "] in evaluator_manager";
+      continue;
+    }
+    Evaluator* evaluator = SelectCautionEvaluator(obstacle);
+    if (evaluator == nullptr) {
+      normal_obstacles.push_back(obstacle);
+    } else if (evaluator->GetName() ==
+               "JOINTLY_PREDICTION_PLANNING_EVALUATOR") {
+      // needs the planning trajectory, not batched
+      if (!evaluator->Evaluate(adc_trajectory_container, obstacle,
+                               obstacles_container)) {
+        AERROR << "Obstacle: " << obstacle->id()
+               << " interaction evaluator failed,"
+               << " downgrade to normal level!";
+        normal_obstacles.push_back(obstacle);
+      }
+    } else {
+      batches[evaluator].push_back(obstacle);
+    }
+  }
+  for (auto& batch : batches) {
+    std::vector<Obstacle*> failed_obstacles;
+    batch.first->EvaluateBatch(batch.second, obstacles_container,
+                               &failed_obstacles);
+    for (Obstacle* obstacle : failed_obstacles) {
+      AERROR << "Obstacle: " << obstacle->id()
+             << " caution evaluator failed, downgrade to normal level!";
+    }
+    normal_obstacles.insert(normal_obstacles.end(), failed_obstacles.begin(),
+                            failed_obstacles.end());
+  }
+
+  batches.clear();
+  for (Obstacle* obstacle : normal_obstacles) {
+    Evaluator* evaluator = SelectEvaluator(obstacle);
+    if (evaluator != nullptr) {
+      batches[evaluator].push_back(obstacle);
+    }
+  }
+  for (auto& batch : batches) {
+    auto start_time = std::chrono::system_clock::now();
+    std::vector<Obstacle*> failed_obstacles;
+    batch.first->EvaluateBatch(batch.second, obstacles_container,
+                               &failed_obstacles);
+    auto end_time = std::chrono::system_clock::now();
+    std::chrono::duration<double> time_cost = end_time - start_time;
+    ADEBUG << batch.first->GetName() << " evaluated "
+           << batch.second.size() << " obstacles in "
+           << time_cost.count() * 1000 << " ms.";
+  }
+}
+
 void EvaluatorManager::EvaluateMultiObstacle(
     const ADCTrajectoryContainer* adc_trajectory_container,
     ObstaclesContainer* obstacles_container) {
@@ -82,12 +82,38 @@ class EvaluatorManager {
     const ADCTrajectoryContainer* adc_trajectory_container,
     ObstaclesContainer* obstacles_container);
 
+  /**
+   * @brief Evaluate the obstacles of the current frame grouped by evaluator,
+   *        every evaluator gets all its obstacles in one batch
+   * @param ADC trajectory container
+   * @param Obstacles container
+   */
+  void EvaluateObstaclesInBatch(
+      const ADCTrajectoryContainer* adc_trajectory_container,
+      ObstaclesContainer* obstacles_container);
+
  private:
   void BuildObstacleIdHistoryMap(ObstaclesContainer* obstacles_container,
                                  size_t max_num_frame);
 
   void DumpCurrentFrameEnv(ObstaclesContainer* obstacles_container);
 
+  /**
+   * @brief Select the evaluator of a caution obstacle
+   * @param Obstacle pointer
+   * @return The caution evaluator, nullptr if the obstacle is not evaluated
+   *         as caution
+   */
+  Evaluator* SelectCautionEvaluator(Obstacle* obstacle);
+
+  /**
+   * @brief Select the evaluator of an obstacle when it is not evaluated as
+   *        caution or its caution evaluator failed
+   * @param Obstacle pointer
+   * @return The evaluator, nullptr if the obstacle is not evaluated
+   */
+  Evaluator* SelectEvaluator(Obstacle* obstacle);
+
   /**
    * @brief Register an evaluator by type
    * @param Evaluator type
@@ -138,6 +138,122 @@ bool CruiseMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
   return true;
 }
 
+void CruiseMLPEvaluator::EvaluateBatch(
+    const std::vector<Obstacle*>& obstacles,
+    ObstaclesContainer* obstacles_container,
+    std::vector<Obstacle*>* failed_obstacles) {
+  if (FLAGS_prediction_offline_mode ==
+      PredictionConstants::kDumpDataForLearning) {
+    Evaluator::EvaluateBatch(obstacles, obstacles_container,
+                             failed_obstacles);
+    return;
+  }
+  omp_set_num_threads(1);
+  std::vector<LaneSequenceBatch> go_batches(obstacles.size());
+  std::vector<LaneSequenceBatch> cutin_batches(obstacles.size());
+  std::vector<int> extracted(obstacles.size(), 0);
+  ForEachObstacle(obstacles.size(), [&](size_t i) {
+    extracted[i] = ExtractLaneSequenceBatch(obstacles[i], &go_batches[i],
+                                            &cutin_batches[i]);
+  });
+
+  LaneSequenceBatch go_batch;
+  LaneSequenceBatch cutin_batch;
+  auto append = [](const LaneSequenceBatch& from, LaneSequenceBatch* to) {
+    to->lane_sequences.insert(to->lane_sequences.end(),
+                              from.lane_sequences.begin(),
+                              from.lane_sequences.end());
+    to->feature_values.insert(to->feature_values.end(),
+                              from.feature_values.begin(),
+                              from.feature_values.end());
+  };
+  for (size_t i = 0; i < obstacles.size(); ++i) {
+    if (!extracted[i]) {
+      failed_obstacles->push_back(obstacles[i]);
+      continue;
+    }
+    append(go_batches[i], &go_batch);
+    append(cutin_batches[i], &cutin_batch);
+  }
+  BatchModelInference(go_batch, &torch_go_model_);
+  BatchModelInference(cutin_batch, &torch_cutin_model_);
+}
+
+bool CruiseMLPEvaluator::ExtractLaneSequenceBatch(
+    Obstacle* obstacle_ptr, LaneSequenceBatch* go_batch,
+    LaneSequenceBatch* cutin_batch) {
+  omp_set_num_threads(1);
+  CHECK_NOTNULL(obstacle_ptr);
+  obstacle_ptr->SetEvaluatorType(evaluator_type_);
+
+  int id = obstacle_ptr->id();
+  if (!obstacle_ptr->latest_feature().IsInitialized()) {
+    AERROR << "Obstacle [" << id << "] has no latest feature.";
+    return false;
+  }
+  Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
+  if (!latest_feature_ptr->has_lane() ||
+      !latest_feature_ptr->lane().has_lane_graph()) {
+    ADEBUG << "Obstacle [" << id << "] has no lane graph.";
+    return false;
+  }
+  LaneGraph* lane_graph_ptr =
+      latest_feature_ptr->mutable_lane()->mutable_lane_graph();
+  if (lane_graph_ptr->lane_sequence().empty()) {
+    AERROR << "Obstacle [" << id << "] has no lane sequences.";
+    return false;
+  }
+
+  const size_t input_dim =
+      OBSTACLE_FEATURE_SIZE + SINGLE_LANE_FEATURE_SIZE * LANE_POINTS_SIZE;
+  for (int i = 0; i < lane_graph_ptr->lane_sequence_size(); ++i) {
+    LaneSequence* lane_sequence_ptr = lane_graph_ptr->mutable_lane_sequence(i);
+    std::vector<double> feature_values;
+    ExtractFeatureValues(obstacle_ptr, lane_sequence_ptr, &feature_values);
+    if (feature_values.size() != input_dim) {
+      lane_sequence_ptr->set_probability(0.0);
+      ADEBUG << "Skip lane sequence due to incorrect feature size";
+      continue;
+    }
+    LaneSequenceBatch* batch =
+        lane_sequence_ptr->vehicle_on_lane() ? go_batch : cutin_batch;
+    batch->lane_sequences.push_back(lane_sequence_ptr);
+    for (double value : feature_values) {
+      batch->feature_values.push_back(static_cast<float>(value));
+    }
+  }
+  return true;
+}
+
+void CruiseMLPEvaluator::BatchModelInference(
+    const LaneSequenceBatch& batch, torch::jit::script::Module* torch_model) {
+  if (batch.lane_sequences.empty()) {
+    return;
+  }
+  const int64_t batch_size = static_cast<int64_t>(batch.lane_sequences.size());
+  const int64_t input_dim = static_cast<int64_t>(
+      OBSTACLE_FEATURE_SIZE + SINGLE_LANE_FEATURE_SIZE * LANE_POINTS_SIZE);
+  torch::Tensor torch_input =
+      torch::from_blob(const_cast<float*>(batch.feature_values.data()),
+                       {batch_size, input_dim}, torch::kFloat32);
+  std::vector<torch::jit::IValue> torch_inputs;
+  torch_inputs.push_back(torch_input.to(device_));
+  auto torch_output_tuple = torch_model->forward(torch_inputs).toTuple();
+  auto probability_tensor =
+      torch_output_tuple->elements()[0].toTensor().to(torch::kCPU);
+  auto finish_time_tensor =
+      torch_output_tuple->elements()[1].toTensor().to(torch::kCPU);
+  auto probability = probability_tensor.accessor<float, 2>();
+  auto finish_time = finish_time_tensor.accessor<float, 2>();
+  for (int64_t i = 0; i < batch_size; ++i) {
+    LaneSequence* lane_sequence_ptr = batch.lane_sequences[i];
+    lane_sequence_ptr->set_probability(apollo::common::math::Sigmoid(
+        static_cast<double>(probability[i][0])));
+    lane_sequence_ptr->set_time_to_lane_center(
+        static_cast<double>(finish_time[i][0]));
+  }
+}
+
 void CruiseMLPEvaluator::ExtractFeatureValues(
     Obstacle* obstacle_ptr, LaneSequence* lane_sequence_ptr,
     std::vector<double>* feature_values) {
@@ -49,6 +49,17 @@ class CruiseMLPEvaluator : public Evaluator {
   bool Evaluate(Obstacle* obstacle_ptr,
                 ObstaclesContainer* obstacles_container) override;
 
+  /**
+   * @brief Override EvaluateBatch, the lane sequences of all obstacles run
+   *        through the go and the cutin model in one forward pass each
+   * @param Obstacle pointers
+   * @param Obstacles container
+   * @param Obstacles whose evaluation failed
+   */
+  void EvaluateBatch(const std::vector<Obstacle*>& obstacles,
+                     ObstaclesContainer* obstacles_container,
+                     std::vector<Obstacle*>* failed_obstacles) override;
+
   /**
    * @brief Extract feature vector
    * @param Obstacle pointer
@@ -66,6 +77,32 @@ class CruiseMLPEvaluator : public Evaluator {
   void Clear();
 
  private:
+  // Lane sequences evaluated by the same model, one row of feature values
+  // per lane sequence
+  struct LaneSequenceBatch {
+    std::vector<LaneSequence*> lane_sequences;
+    std::vector<float> feature_values;
+  };
+
+  /**
+   * @brief Extract the feature values of all lane sequences of an obstacle
+   * @param Obstacle pointer
+   * @param Lane sequences for the go model
+   * @param Lane sequences for the cutin model
+   * @return false if the obstacle has no lane sequence to evaluate
+   */
+  bool ExtractLaneSequenceBatch(Obstacle* obstacle_ptr,
+                                LaneSequenceBatch* go_batch,
+                                LaneSequenceBatch* cutin_batch);
+
+  /**
+   * @brief Run a batch of lane sequences through a model
+   * @param Lane sequences with their feature values
+   * @param Torch model
+   */
+  void BatchModelInference(const LaneSequenceBatch& batch,
+                           torch::jit::script::Module* torch_model);
+
   /**
    * @brief Set obstacle feature vector
    * @param Obstacle pointer
@@ -16,6 +16,8 @@
 
 #include "modules/prediction/evaluator/vehicle/cruise_mlp_evaluator.h"
 
+#include <vector>
+
 #include "cyber/common/file.h"
 #include "modules/prediction/common/kml_map_based_test.h"
 #include "modules/prediction/container/obstacles/obstacles_container.h"
@@ -56,5 +58,51 @@ TEST_F(CruiseMLPEvaluatorTest, OnLaneCase) {
   cruise_mlp_evaluator.Clear();
 }
 
+TEST_F(CruiseMLPEvaluatorTest, BatchMatchesSingle) {
+  CruiseMLPEvaluator cruise_mlp_evaluator;
+  ObstaclesContainer single_container;
+  single_container.Insert(perception_obstacles_);
+  single_container.BuildLaneGraph();
+  Obstacle* single_obstacle_ptr = single_container.GetObstacle(1);
+  ASSERT_NE(single_obstacle_ptr, nullptr);
+  EXPECT_TRUE(
+      cruise_mlp_evaluator.Evaluate(single_obstacle_ptr, &single_container));
+
+  apollo::perception::PerceptionObstacles perception_obstacles =
+      perception_obstacles_;
+  for (int id = 2; id <= 4; ++id) {
+    auto* perception_obstacle = perception_obstacles.add_perception_obstacle();
+    *perception_obstacle = perception_obstacles_.perception_obstacle(0);
+    perception_obstacle->set_id(id);
+  }
+  ObstaclesContainer container;
+  container.Insert(perception_obstacles);
+  container.BuildLaneGraph();
+  std::vector<Obstacle*> obstacles;
+  for (int id = 1; id <= 4; ++id) {
+    obstacles.push_back(container.GetObstacle(id));
+    ASSERT_NE(obstacles.back(), nullptr);
+  }
+  std::vector<Obstacle*> failed_obstacles;
+  cruise_mlp_evaluator.EvaluateBatch(obstacles, &container, &failed_obstacles);
+  EXPECT_TRUE(failed_obstacles.empty());
+
+  const LaneGraph& expected_lane_graph =
+      single_obstacle_ptr->latest_feature().lane().lane_graph();
+  for (const Obstacle* obstacle_ptr : obstacles) {
+    const LaneGraph& lane_graph =
+        obstacle_ptr->latest_feature().lane().lane_graph();
+    ASSERT_EQ(lane_graph.lane_sequence_size(),
+              expected_lane_graph.lane_sequence_size());
+    for (int i = 0; i < lane_graph.lane_sequence_size(); ++i) {
+      const LaneSequence& expected = expected_lane_graph.lane_sequence(i);
+      const LaneSequence& lane_sequence = lane_graph.lane_sequence(i);
+      EXPECT_NEAR(lane_sequence.probability(), expected.probability(), 1e-5);
+      EXPECT_NEAR(lane_sequence.time_to_lane_center(),
+                  expected.time_to_lane_center(), 1e-4);
+    }
+  }
+}
+
 }  // namespace prediction
 }  // namespace apollo
@@ -16,6 +16,7 @@
 
 #include "modules/prediction/evaluator/vehicle/jointly_prediction_planning_evaluator.h"
 
+#include <algorithm>
 #include <limits>
 #include <omp.h>
 
@@ -117,16 +118,15 @@ bool JointlyPredictionPlanningEvaluator::VectornetProcessObstaclePosition(
 }
 
 bool JointlyPredictionPlanningEvaluator::VectornetProcessMapData(
-      FeatureVector* map_feature,
-      PidVector* map_p_id,
+      const VectorNetPolylines& map_polylines,
       const int obs_num,
       torch::Tensor* ptr_map_data,
       torch::Tensor* ptr_all_map_p_id,
       torch::Tensor* ptr_vector_mask) {
-  int map_polyline_num = map_feature->size();
+  int map_polyline_num = map_polylines.size();
 
   for (int i = 0; i < map_polyline_num && obs_num + i < 450; ++i) {
-    size_t one_polyline_vector_size = map_feature->at(i).size();
+    int one_polyline_vector_size = map_polylines.vector_num(i);
     if (one_polyline_vector_size < 50) {
       ptr_vector_mask->index_put_({obs_num + i,
                                    torch::indexing::Slice(
@@ -139,16 +139,19 @@ bool JointlyPredictionPlanningEvaluator::VectornetProcessMapData(
   auto opts = torch::TensorOptions().dtype(torch::kDouble);
 
   for (int i = 0; i < map_polyline_num && i + obs_num < 450; ++i) {
-    ptr_all_map_p_id->index_put_({i}, torch::from_blob(map_p_id->at(i).data(),
-                                                       {2},
-                                                       opts));
-
-    int one_polyline_vector_size = map_feature->at(i).size();
-    for (int j = 0; j < one_polyline_vector_size && j < 50; ++j) {
-      ptr_map_data->index_put_({i, j},
-                               torch::from_blob(map_feature->at(i)[j].data(),
-                                                {9},
-                                                opts));
+    ptr_all_map_p_id->index_put_(
+        {i}, torch::from_blob(const_cast<double*>(map_polylines.p_id(i)),
+                              {2}, opts));
+
+    // the vectors of a polyline are contiguous, copy them in one go
+    int one_polyline_vector_size = std::min(map_polylines.vector_num(i), 50);
+    if (one_polyline_vector_size > 0) {
+      ptr_map_data->index_put_(
+          {i, torch::indexing::Slice(0, one_polyline_vector_size)},
+          torch::from_blob(const_cast<double*>(map_polylines.vector_data(i)),
+                           {one_polyline_vector_size,
+                            VectorNetPolylines::kVectorSize},
+                           opts));
     }
   }
   *ptr_map_data = ptr_map_data->toType(at::kFloat);
@@ -217,8 +220,7 @@ bool JointlyPredictionPlanningEvaluator::Evaluate(
 
 
   // Query the map data vector
-  FeatureVector map_feature;
-  PidVector map_p_id;
+  VectorNetPolylines map_polylines;
   double pos_x = latest_feature_ptr->position().x();
   double pos_y = latest_feature_ptr->position().y();
   common::PointENU center_point;
@@ -228,7 +230,7 @@ bool JointlyPredictionPlanningEvaluator::Evaluate(
 
   auto start_time_query = std::chrono::system_clock::now();
 
-  if (!vector_net_.query(center_point, heading, &map_feature, &map_p_id)) {
+  if (!vector_net_.query(center_point, heading, &map_polylines)) {
     return false;
   }
 
@@ -237,7 +239,7 @@ bool JointlyPredictionPlanningEvaluator::Evaluate(
   ADEBUG << "vectors query used time: " << diff_query.count() * 1000 << " ms.";
 
   // process map data & map p id & v_mask for map polyline
-  int map_polyline_num = map_feature.size();
+  int map_polyline_num = map_polylines.size();
   int data_length =
       ((obs_num + map_polyline_num) < 450) ? (obs_num + map_polyline_num) : 450;
 
@@ -250,8 +252,7 @@ bool JointlyPredictionPlanningEvaluator::Evaluate(
   torch::Tensor map_data = torch::zeros({map_polyline_num_valid, 50, 9});
   torch::Tensor all_map_p_id = torch::zeros({map_polyline_num_valid, 2});
 
-  if (!VectornetProcessMapData(&map_feature,
-                               &map_p_id,
+  if (!VectornetProcessMapData(map_polylines,
                                obs_num,
                                &map_data,
                                &all_map_p_id,
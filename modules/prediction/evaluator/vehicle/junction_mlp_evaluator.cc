@@ -71,20 +71,10 @@ bool JunctionMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
 
   obstacle_ptr->SetEvaluatorType(evaluator_type_);
 
-  int id = obstacle_ptr->id();
-  if (!obstacle_ptr->latest_feature().IsInitialized()) {
-    AERROR << "Obstacle [" << id << "] has no latest feature.";
+  if (!HasJunctionExit(obstacle_ptr)) {
     return false;
   }
   Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
-  CHECK_NOTNULL(latest_feature_ptr);
-
-  // Assume obstacle is NOT closed to any junction exit
-  if (!latest_feature_ptr->has_junction_feature() ||
-      latest_feature_ptr->junction_feature().junction_exit_size() < 1) {
-    ADEBUG << "Obstacle [" << id << "] has no junction_exit.";
-    return false;
-  }
 
   std::vector<double> feature_values;
   ExtractFeatureValues(obstacle_ptr, obstacles_container, &feature_values);
@@ -119,6 +109,112 @@ bool JunctionMLPEvaluator::Evaluate(Obstacle* obstacle_ptr,
                                            EGO_VEHICLE_FEATURE_SIZE + 8 * i]);
     }
   }
+  return SetLaneSequenceProbability(obstacle_ptr, probability);
+}
+
+void JunctionMLPEvaluator::EvaluateBatch(
+    const std::vector<Obstacle*>& obstacles,
+    ObstaclesContainer* obstacles_container,
+    std::vector<Obstacle*>* failed_obstacles) {
+  if (FLAGS_prediction_offline_mode ==
+      PredictionConstants::kDumpDataForLearning) {
+    Evaluator::EvaluateBatch(obstacles, obstacles_container,
+                             failed_obstacles);
+    return;
+  }
+  omp_set_num_threads(1);
+  std::vector<std::vector<double>> feature_values(obstacles.size());
+  std::vector<int> has_junction_exit(obstacles.size(), 0);
+  ForEachObstacle(obstacles.size(), [&](size_t i) {
+    Obstacle* obstacle_ptr = obstacles[i];
+    CHECK_NOTNULL(obstacle_ptr);
+    obstacle_ptr->SetEvaluatorType(evaluator_type_);
+    if (!HasJunctionExit(obstacle_ptr)) {
+      return;
+    }
+    has_junction_exit[i] = 1;
+    ExtractFeatureValues(obstacle_ptr, obstacles_container,
+                         &feature_values[i]);
+  });
+
+  // one row per obstacle close to more than one junction exit
+  const int64_t input_dim = static_cast<int64_t>(
+      OBSTACLE_FEATURE_SIZE + EGO_VEHICLE_FEATURE_SIZE + JUNCTION_FEATURE_SIZE);
+  std::vector<size_t> model_indices;
+  for (size_t i = 0; i < obstacles.size(); ++i) {
+    if (has_junction_exit[i] &&
+        obstacles[i]->latest_feature().junction_feature().junction_exit_size() >
+            1) {
+      model_indices.push_back(i);
+    }
+  }
+  std::vector<std::vector<double>> probabilities(obstacles.size());
+  if (!model_indices.empty()) {
+    const int64_t batch_size = static_cast<int64_t>(model_indices.size());
+    std::vector<float> input_values(batch_size * input_dim, 0.0f);
+    for (int64_t row = 0; row < batch_size; ++row) {
+      const std::vector<double>& values = feature_values[model_indices[row]];
+      for (int64_t i = 0;
+           i < input_dim && i < static_cast<int64_t>(values.size()); ++i) {
+        input_values[row * input_dim + i] = static_cast<float>(values[i]);
+      }
+    }
+    std::vector<torch::jit::IValue> torch_inputs;
+    torch::Tensor torch_input = torch::from_blob(
+        input_values.data(), {batch_size, input_dim}, torch::kFloat32);
+    torch_inputs.push_back(torch_input.to(device_));
+    at::Tensor torch_output_tensor =
+        torch_model_.forward(torch_inputs).toTensor().to(torch::kCPU);
+    auto torch_output = torch_output_tensor.accessor<float, 2>();
+    for (int64_t row = 0; row < batch_size; ++row) {
+      std::vector<double>& probability = probabilities[model_indices[row]];
+      for (int i = 0; i < torch_output.size(1); ++i) {
+        probability.push_back(static_cast<double>(torch_output[row][i]));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < obstacles.size(); ++i) {
+    if (!has_junction_exit[i]) {
+      failed_obstacles->push_back(obstacles[i]);
+      continue;
+    }
+    const Feature& latest_feature = obstacles[i]->latest_feature();
+    std::vector<double>& probability = probabilities[i];
+    if (latest_feature.junction_feature().junction_exit_size() == 1) {
+      for (int k = 0; k < 12; ++k) {
+        probability.push_back(feature_values[i][OBSTACLE_FEATURE_SIZE +
+                                                EGO_VEHICLE_FEATURE_SIZE +
+                                                8 * k]);
+      }
+    }
+    if (!SetLaneSequenceProbability(obstacles[i], probability)) {
+      failed_obstacles->push_back(obstacles[i]);
+    }
+  }
+}
+
+bool JunctionMLPEvaluator::HasJunctionExit(Obstacle* obstacle_ptr) {
+  int id = obstacle_ptr->id();
+  if (!obstacle_ptr->latest_feature().IsInitialized()) {
+    AERROR << "Obstacle [" << id << "] has no latest feature.";
+    return false;
+  }
+  const Feature& latest_feature = obstacle_ptr->latest_feature();
+
+  // Assume obstacle is NOT closed to any junction exit
+  if (!latest_feature.has_junction_feature() ||
+      latest_feature.junction_feature().junction_exit_size() < 1) {
+    ADEBUG << "Obstacle [" << id << "] has no junction_exit.";
+    return false;
+  }
+  return true;
+}
+
+bool JunctionMLPEvaluator::SetLaneSequenceProbability(
+    Obstacle* obstacle_ptr, const std::vector<double>& probability) {
+  int id = obstacle_ptr->id();
+  Feature* latest_feature_ptr = obstacle_ptr->mutable_latest_feature();
   for (double prob : probability) {
     latest_feature_ptr->mutable_junction_feature()
         ->add_junction_mlp_probability(prob);
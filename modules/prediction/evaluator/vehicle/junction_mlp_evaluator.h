@@ -53,6 +53,17 @@ class JunctionMLPEvaluator : public Evaluator {
   bool Evaluate(Obstacle* obstacle_ptr,
                 ObstaclesContainer* obstacles_container) override;
 
+  /**
+   * @brief Override EvaluateBatch, the obstacles close to more than one
+   *        junction exit run through the model in one forward pass
+   * @param Obstacle pointers
+   * @param Obstacles container
+   * @param Obstacles whose evaluation failed
+   */
+  void EvaluateBatch(const std::vector<Obstacle*>& obstacles,
+                     ObstaclesContainer* obstacles_container,
+                     std::vector<Obstacle*>* failed_obstacles) override;
+
   /**
    * @brief Extract feature vector
    * @param Obstacle pointer
@@ -69,6 +80,22 @@ class JunctionMLPEvaluator : public Evaluator {
   std::string GetName() override { return "JUNCTION_MLP_EVALUATOR"; }
 
  private:
+  /**
+   * @brief Check if the obstacle has a latest feature with junction exits
+   * @param Obstacle pointer
+   */
+  bool HasJunctionExit(Obstacle* obstacle_ptr);
+
+  /**
+   * @brief Set the probabilities of the lane sequences from the probabilities
+   *        of the 12 fan areas
+   * @param Obstacle pointer
+   * @param Probabilities of the fan areas
+   * @return false if the obstacle has no lane sequence
+   */
+  bool SetLaneSequenceProbability(Obstacle* obstacle_ptr,
+                                  const std::vector<double>& probability);
+
   /**
    * @brief Set obstacle feature vector
    * @param Obstacle pointer
@@ -16,6 +16,8 @@
 
 #include "modules/prediction/evaluator/vehicle/junction_mlp_evaluator.h"
 
+#include <vector>
+
 #include "cyber/common/file.h"
 #include "modules/prediction/common/junction_analyzer.h"
 #include "modules/prediction/common/kml_map_based_test.h"
@@ -64,5 +66,49 @@ TEST_F(JunctionMLPEvaluatorTest, InJunctionCase) {
   junction_mlp_evaluator.Clear();
 }
 
+TEST_F(JunctionMLPEvaluatorTest, BatchMatchesSingle) {
+  JunctionMLPEvaluator junction_mlp_evaluator;
+  ObstaclesContainer single_container;
+  single_container.GetJunctionAnalyzer()->Init("j2");
+  single_container.Insert(perception_obstacles_);
+  single_container.BuildJunctionFeature();
+  Obstacle* single_obstacle_ptr = single_container.GetObstacle(1);
+  ASSERT_NE(single_obstacle_ptr, nullptr);
+  junction_mlp_evaluator.Evaluate(single_obstacle_ptr, &single_container);
+
+  apollo::perception::PerceptionObstacles perception_obstacles =
+      perception_obstacles_;
+  for (int id = 2; id <= 4; ++id) {
+    auto* perception_obstacle = perception_obstacles.add_perception_obstacle();
+    *perception_obstacle = perception_obstacles_.perception_obstacle(0);
+    perception_obstacle->set_id(id);
+  }
+  ObstaclesContainer container;
+  container.GetJunctionAnalyzer()->Init("j2");
+  container.Insert(perception_obstacles);
+  container.BuildJunctionFeature();
+  std::vector<Obstacle*> obstacles;
+  for (int id = 1; id <= 4; ++id) {
+    obstacles.push_back(container.GetObstacle(id));
+    ASSERT_NE(obstacles.back(), nullptr);
+  }
+  std::vector<Obstacle*> failed_obstacles;
+  junction_mlp_evaluator.EvaluateBatch(obstacles, &container,
+                                       &failed_obstacles);
+
+  const JunctionFeature& expected =
+      single_obstacle_ptr->latest_feature().junction_feature();
+  ASSERT_EQ(expected.junction_mlp_probability_size(), 12);
+  for (const Obstacle* obstacle_ptr : obstacles) {
+    const JunctionFeature& junction_feature =
+        obstacle_ptr->latest_feature().junction_feature();
+    ASSERT_EQ(junction_feature.junction_mlp_probability_size(), 12);
+    for (int i = 0; i < 12; ++i) {
+      EXPECT_NEAR(junction_feature.junction_mlp_probability(i),
+                  expected.junction_mlp_probability(i), 1e-5);
+    }
+  }
+}
+
 }  // namespace prediction
 }  // namespace apollo
@@ -16,6 +16,7 @@
 
 #include "modules/prediction/evaluator/vehicle/multi_agent_evaluator.h"
 
+#include <algorithm>
 #include <limits>
 #include <omp.h>
 
@@ -258,16 +259,15 @@ bool MultiAgentEvaluator::VectornetProcessObstaclePosition(
 }
 
 bool MultiAgentEvaluator::VectornetProcessMapData(
-                             FeatureVector* map_feature,
-                             PidVector* map_p_id,
+                             const VectorNetPolylines& map_polylines,
                              const int other_obs_num,
                              torch::Tensor* ptr_map_data,
                              torch::Tensor* ptr_all_map_p_id,
                              torch::Tensor* ptr_vector_mask) {
-  int map_polyline_num = map_feature->size();
+  int map_polyline_num = map_polylines.size();
 
   for (int i = 0; i < map_polyline_num && other_obs_num + i < 450; ++i) {
-    size_t one_polyline_vector_size = map_feature->at(i).size();
+    int one_polyline_vector_size = map_polylines.vector_num(i);
     if (one_polyline_vector_size < 50) {
       ptr_vector_mask->index_put_({other_obs_num + i,
                                    torch::indexing::Slice(
@@ -282,16 +282,14 @@ bool MultiAgentEvaluator::VectornetProcessMapData(
   std::vector<double> all_map_p_id_temp(map_polyline_num * 2, 0.0);
   std::vector<double> map_data_temp(map_polyline_num * 50 * 9, 0.0);
   for (int i = 0; i < map_polyline_num && i + other_obs_num < 450; ++i) {
-    all_map_p_id_temp[i * 2 + 0] = map_p_id->at(i)[0];
-    all_map_p_id_temp[i * 2 + 1] = map_p_id->at(i)[1];
-
-    int one_polyline_vector_size = map_feature->at(i).size();
-    for (int j = 0; j < one_polyline_vector_size && j < 50; ++j) {
-      for (int k = 0; k < 9; ++k) {
-        map_data_temp[i * 50 * 9 + j * 9 + k] = 
-          map_feature->at(i)[j][k];
-      }
-    }
+    all_map_p_id_temp[i * 2 + 0] = map_polylines.p_id(i)[0];
+    all_map_p_id_temp[i * 2 + 1] = map_polylines.p_id(i)[1];
+
+    // the vectors of a polyline are contiguous, copy them in one go
+    int one_polyline_vector_size = std::min(map_polylines.vector_num(i), 50);
+    std::copy_n(map_polylines.vector_data(i),
+                one_polyline_vector_size * VectorNetPolylines::kVectorSize,
+                map_data_temp.begin() + i * 50 * 9);
   }
 
   *ptr_map_data = torch::from_blob(map_data_temp.data(),
@@ -408,15 +406,14 @@ bool MultiAgentEvaluator::Evaluate(
   Feature* latest_feature_ptr = selected_obstacle->mutable_latest_feature();
   CHECK_NOTNULL(latest_feature_ptr);
   
-  FeatureVector map_feature;
-  PidVector map_p_id;
+  VectorNetPolylines map_polylines;
   const double pos_x = latest_feature_ptr->position().x();
   const double pos_y = latest_feature_ptr->position().y();
   common::PointENU center_point
     = common::util::PointFactory::ToPointENU(pos_x, pos_y);;
   const double heading = latest_feature_ptr->velocity_heading();
 
-  if (!vector_net_.query(center_point, heading, &map_feature, &map_p_id)) {
+  if (!vector_net_.query(center_point, heading, &map_polylines)) {
     return false;
   }
 
@@ -428,7 +425,7 @@ bool MultiAgentEvaluator::Evaluate(
   /* process map data & map p id & v_mask for map polyline */
   auto start_time_map_vectorize = std::chrono::system_clock::now();
 
-  int map_polyline_num = map_feature.size();
+  int map_polyline_num = map_polylines.size();
   int data_length =
       ((vector_obs_num + map_polyline_num) < 450) ? (vector_obs_num + map_polyline_num) : 450;
 
@@ -436,8 +433,7 @@ bool MultiAgentEvaluator::Evaluate(
   torch::Tensor map_data = torch::zeros({map_polyline_num, 50, 9});
   torch::Tensor all_map_p_id = torch::zeros({map_polyline_num, 2});
 
-  if (!VectornetProcessMapData(&map_feature,
-                               &map_p_id,
+  if (!VectornetProcessMapData(map_polylines,
                                vector_obs_num,
                                &map_data,
                                &all_map_p_id,
@@ -16,6 +16,7 @@
 
 #include "modules/prediction/evaluator/vehicle/vectornet_evaluator.h"
 
+#include <algorithm>
 #include <limits>
 #include <omp.h>
 
@@ -148,16 +149,15 @@ bool VectornetEvaluator::VectornetProcessObstaclePosition(
 }
 
 bool VectornetEvaluator::VectornetProcessMapData(
-                             FeatureVector* map_feature,
-                             PidVector* map_p_id,
+                             const VectorNetPolylines& map_polylines,
                              const int obs_num,
                              torch::Tensor* ptr_map_data,
                              torch::Tensor* ptr_all_map_p_id,
                              torch::Tensor* ptr_vector_mask) {
-  int map_polyline_num = map_feature->size();
+  int map_polyline_num = map_polylines.size();
 
   for (int i = 0; i < map_polyline_num && obs_num + i < 450; ++i) {
-    size_t one_polyline_vector_size = map_feature->at(i).size();
+    int one_polyline_vector_size = map_polylines.vector_num(i);
     if (one_polyline_vector_size < 50) {
       ptr_vector_mask->index_put_({obs_num + i,
                                    torch::indexing::Slice(
@@ -170,16 +170,19 @@ bool VectornetEvaluator::VectornetProcessMapData(
   auto opts = torch::TensorOptions().dtype(torch::kDouble);
 
   for (int i = 0; i < map_polyline_num && i + obs_num < 450; ++i) {
-    ptr_all_map_p_id->index_put_({i}, torch::from_blob(map_p_id->at(i).data(),
-                                                       {2},
-                                                       opts));
-
-    int one_polyline_vector_size = map_feature->at(i).size();
-    for (int j = 0; j < one_polyline_vector_size && j < 50; ++j) {
-      ptr_map_data->index_put_({i, j},
-                               torch::from_blob(map_feature->at(i)[j].data(),
-                                                {9},
-                                                opts));
+    ptr_all_map_p_id->index_put_(
+        {i}, torch::from_blob(const_cast<double*>(map_polylines.p_id(i)),
+                              {2}, opts));
+
+    // the vectors of a polyline are contiguous, copy them in one go
+    int one_polyline_vector_size = std::min(map_polylines.vector_num(i), 50);
+    if (one_polyline_vector_size > 0) {
+      ptr_map_data->index_put_(
+          {i, torch::indexing::Slice(0, one_polyline_vector_size)},
+          torch::from_blob(const_cast<double*>(map_polylines.vector_data(i)),
+                           {one_polyline_vector_size,
+                            VectorNetPolylines::kVectorSize},
+                           opts));
     }
   }
   *ptr_map_data = ptr_map_data->toType(at::kFloat);
@@ -233,8 +236,7 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
   CHECK_NOTNULL(latest_feature_ptr);
 
   // Query the map data
-  FeatureVector map_feature;
-  PidVector map_p_id;
+  VectorNetPolylines map_polylines;
   const double pos_x = latest_feature_ptr->position().x();
   const double pos_y = latest_feature_ptr->position().y();
   common::PointENU center_point
@@ -243,7 +245,7 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
 
   auto start_time_query = std::chrono::system_clock::now();
 
-  if (!vector_net_.query(center_point, heading, &map_feature, &map_p_id)) {
+  if (!vector_net_.query(center_point, heading, &map_polylines)) {
     return false;
   }
 
@@ -252,7 +254,7 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
   AINFO << "vectors query used time: " << diff_query.count() * 1000 << " ms.";
 
   // process map data & map p id & v_mask for map polyline
-  int map_polyline_num = map_feature.size();
+  int map_polyline_num = map_polylines.size();
   int data_length =
       ((obs_num + map_polyline_num) < 450) ? (obs_num + map_polyline_num) : 450;
 
@@ -261,8 +263,7 @@ bool VectornetEvaluator::Evaluate(Obstacle* obstacle_ptr,
   torch::Tensor map_data = torch::zeros({map_polyline_num, 50, 9});
   torch::Tensor all_map_p_id = torch::zeros({map_polyline_num, 2});
 
-  if (!VectornetProcessMapData(&map_feature,
-                               &map_p_id,
+  if (!VectornetProcessMapData(map_polylines,
                                obs_num,
                                &map_data,
                                &all_map_p_id,
@@ -66,14 +66,12 @@ class VectornetEvaluator : public Evaluator {
 
   /**
   * @brief Process map data to vector
-  * @param FeatureVector: map feature vector
+  * @param VectorNetPolylines: map polylines
   * @param int: obstacle number
-  * @param PidVector: map p_id vector
   * @param Tensor: map data
   * @param Tensor: map data p_id
   */
-  bool VectornetProcessMapData(FeatureVector *map_feature,
-                               PidVector *map_p_id,
+  bool VectornetProcessMapData(const VectorNetPolylines& map_polylines,
                                const int obs_num,
                                torch::Tensor* ptr_map_data,
                                torch::Tensor* ptr_all_map_p_id,
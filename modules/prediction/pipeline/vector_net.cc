@@ -15,6 +15,7 @@
  *****************************************************************************/
 #include "modules/prediction/pipeline/vector_net.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <unordered_set>
@@ -24,81 +25,132 @@
 
 namespace apollo {
 namespace prediction {
+
+namespace {
+
+// The cache starts over once it holds this many map elements.
+constexpr size_t kMaxCachedElements = 20000;
+
+}  // namespace
+
 template <typename Points>
-void VectorNet::GetOnePolyline(
-    const Points& points, double* start_length,
-    const common::PointENU& center_point, const double obstacle_phi,
-    ATTRIBUTE_TYPE attr_type, BOUNDARY_TYPE bound_type, const int count,
-    std::vector<std::vector<double>>* const one_polyline,
-    std::vector<double>* const one_p_id) {
+void VectorNet::ResamplePoints(const Points& points, double* start_length,
+                               ATTRIBUTE_TYPE attr_type,
+                               ResampledPolyline* const polyline) {
   size_t size = points.size();
-  std::vector<double> s(size, 0);
-
-  for (size_t i = 1; i < size; ++i) {
-    s[i] = std::hypot(points.at(i).x() - points.at(i - 1).x(),
-                      points.at(i).y() - points.at(i - 1).y()) +
-           s[i - 1];
-  }
+  if (size > 0) {
+    std::vector<double> s(size, 0);
 
-  std::vector<double> x;
-  std::vector<double> y;
-  double cur_length = *start_length;
-
-  auto it_lower = std::lower_bound(s.begin(), s.end(), cur_length);
-  while (it_lower != s.end()) {
-    if (it_lower == s.begin()) {
-      x.push_back(points.at(0).x());
-      y.push_back(points.at(0).y());
-    } else {
-      const auto distance = std::distance(s.begin(), it_lower);
-      x.push_back(common::math::lerp(points.at(distance - 1).x(),
-                                     s[distance - 1], points.at(distance).x(),
-                                     s[distance], cur_length));
-      y.push_back(common::math::lerp(points.at(distance - 1).y(),
-                                     s[distance - 1], points.at(distance).y(),
-                                     s[distance], cur_length));
-    }
-    cur_length += FLAGS_point_distance;
-    it_lower = std::lower_bound(s.begin(), s.end(), cur_length);
-  }
-  size_t point_size = x.size();
-
-  *start_length = cur_length - s[size - 1];
-  if (point_size == 0) return;
-  const double attr = attribute_map.at(attr_type);
-  const double bound = boundary_map.at(bound_type);
-  auto last_point_after_rotate = common::math::RotateVector2d(
-      {x[0] - center_point.x(), y[0] - center_point.y()},
-      M_PI_2 - obstacle_phi);
-
-  for (size_t i = 1; i < point_size; ++i) {
-    if (one_p_id->at(0) > last_point_after_rotate.x()) {
-      one_p_id->at(0) = last_point_after_rotate.x();
-    }
-    if (one_p_id->at(1) > last_point_after_rotate.y()) {
-      one_p_id->at(1) = last_point_after_rotate.y();
+    for (size_t i = 1; i < size; ++i) {
+      s[i] = std::hypot(points.at(i).x() - points.at(i - 1).x(),
+                        points.at(i).y() - points.at(i - 1).y()) +
+             s[i - 1];
     }
 
-    std::vector<double> one_vector;
+    double cur_length = *start_length;
 
-    // d_s, d_e
-    one_vector.push_back(last_point_after_rotate.x());
-    one_vector.push_back(last_point_after_rotate.y());
+    auto it_lower = std::lower_bound(s.begin(), s.end(), cur_length);
+    while (it_lower != s.end()) {
+      if (it_lower == s.begin()) {
+        polyline->points.push_back(points.at(0).x());
+        polyline->points.push_back(points.at(0).y());
+      } else {
+        const auto distance = std::distance(s.begin(), it_lower);
+        polyline->points.push_back(common::math::lerp(
+            points.at(distance - 1).x(), s[distance - 1],
+            points.at(distance).x(), s[distance], cur_length));
+        polyline->points.push_back(common::math::lerp(
+            points.at(distance - 1).y(), s[distance - 1],
+            points.at(distance).y(), s[distance], cur_length));
+      }
+      cur_length += FLAGS_point_distance;
+      it_lower = std::lower_bound(s.begin(), s.end(), cur_length);
+    }
 
-    Eigen::Vector2d point_after_rotate = common::math::RotateVector2d(
-        {x[i] - center_point.x(), y[i] - center_point.y()},
-        M_PI_2 - obstacle_phi);
+    *start_length = cur_length - s[size - 1];
+  }
+  polyline->chunk_offsets.push_back(
+      static_cast<int>(polyline->points.size() / 2));
+  polyline->chunk_attributes.push_back(attribute_map.at(attr_type));
+}
 
-    one_vector.push_back(point_after_rotate.x());
-    one_vector.push_back(point_after_rotate.y());
-    last_point_after_rotate = std::move(point_after_rotate);
+bool VectorNet::AppendPolyline(const ResampledPolyline& polyline,
+                               const Rotation& rotation,
+                               const int min_vector_num,
+                               VectorNetPolylines* const polylines) {
+  const double count = static_cast<double>(polylines->size());
+  const size_t vectors_begin = polylines->vectors.size();
+  double p_id_x = std::numeric_limits<float>::max();
+  double p_id_y = std::numeric_limits<float>::max();
+  auto rotate_x = [&rotation](const double* point) {
+    return rotation.cos_theta * (point[0] - rotation.center_x) -
+           rotation.sin_theta * (point[1] - rotation.center_y);
+  };
+  auto rotate_y = [&rotation](const double* point) {
+    return rotation.sin_theta * (point[0] - rotation.center_x) +
+           rotation.cos_theta * (point[1] - rotation.center_y);
+  };
+
+  for (size_t c = 0; c + 1 < polyline.chunk_offsets.size(); ++c) {
+    const double* point =
+        polyline.points.data() + 2 * polyline.chunk_offsets[c];
+    const double* chunk_end =
+        polyline.points.data() + 2 * polyline.chunk_offsets[c + 1];
+    if (chunk_end - point < 4) {
+      continue;
+    }
+    const double attr = polyline.chunk_attributes[c];
+    double last_x = rotate_x(point);
+    double last_y = rotate_y(point);
+    for (point += 2; point < chunk_end; point += 2) {
+      p_id_x = std::min(p_id_x, last_x);
+      p_id_y = std::min(p_id_y, last_y);
+      const double x = rotate_x(point);
+      const double y = rotate_y(point);
+      polylines->vectors.insert(
+          polylines->vectors.end(),
+          {last_x, last_y, x, y, 0.0, 0.0, attr, polyline.boundary, count});
+      last_x = x;
+      last_y = y;
+    }
+  }
 
-    // attribute
-    one_vector.insert(one_vector.end(), {0.0, 0.0, attr, bound});
+  const int vector_num = static_cast<int>(
+      (polylines->vectors.size() - vectors_begin) /
+      VectorNetPolylines::kVectorSize);
+  if (vector_num < min_vector_num) {
+    polylines->vectors.resize(vectors_begin);
+    return false;
+  }
+  polylines->vector_offsets.push_back(polylines->vector_offsets.back() +
+                                      vector_num);
+  polylines->p_ids.push_back(p_id_x);
+  polylines->p_ids.push_back(p_id_y);
+  return true;
+}
 
-    one_vector.push_back(count);
-    one_polyline->push_back(std::move(one_vector));
+template <typename BuildPolylines>
+VectorNet::CachedPolylines VectorNet::GetCachedPolylines(
+    const std::string& key, BuildPolylines build_polylines) {
+  {
+    std::lock_guard<std::mutex> lock(polyline_cache_mutex_);
+    if (cached_point_distance_ != FLAGS_point_distance) {
+      polyline_cache_.clear();
+      cached_point_distance_ = FLAGS_point_distance;
+    }
+    auto it = polyline_cache_.find(key);
+    if (it != polyline_cache_.end()) {
+      return it->second;
+    }
+  }
+  auto polylines = std::make_shared<std::vector<ResampledPolyline>>();
+  build_polylines(polylines.get());
+  std::lock_guard<std::mutex> lock(polyline_cache_mutex_);
+  if (polyline_cache_.size() >= kMaxCachedElements) {
+    polyline_cache_.clear();
   }
+  polyline_cache_.emplace(key, polylines);
+  return polylines;
 }
 
 bool VectorNet::query(const common::PointENU& center_point,
@@ -106,11 +158,36 @@ bool VectorNet::query(const common::PointENU& center_point,
                       FeatureVector* const feature_ptr,
                       PidVector* const p_id_ptr) {
   CHECK_NOTNULL(feature_ptr);
-  count_ = 0;
-  GetRoads(center_point, obstacle_phi, feature_ptr, p_id_ptr);
-  GetLanes(center_point, obstacle_phi, feature_ptr, p_id_ptr);
-  GetJunctions(center_point, obstacle_phi, feature_ptr, p_id_ptr);
-  GetCrosswalks(center_point, obstacle_phi, feature_ptr, p_id_ptr);
+  VectorNetPolylines polylines;
+  query(center_point, obstacle_phi, &polylines);
+  for (int i = 0; i < polylines.size(); ++i) {
+    std::vector<std::vector<double>> one_polyline;
+    const double* vector = polylines.vector_data(i);
+    for (int j = 0; j < polylines.vector_num(i); ++j) {
+      one_polyline.emplace_back(vector,
+                                vector + VectorNetPolylines::kVectorSize);
+      vector += VectorNetPolylines::kVectorSize;
+    }
+    feature_ptr->push_back(std::move(one_polyline));
+    p_id_ptr->push_back({polylines.p_id(i)[0], polylines.p_id(i)[1]});
+  }
+  return true;
+}
+
+bool VectorNet::query(const common::PointENU& center_point,
+                      const double obstacle_phi,
+                      VectorNetPolylines* const polylines) {
+  CHECK_NOTNULL(polylines);
+  polylines->clear();
+  Rotation rotation;
+  rotation.center_x = center_point.x();
+  rotation.center_y = center_point.y();
+  rotation.cos_theta = std::cos(M_PI_2 - obstacle_phi);
+  rotation.sin_theta = std::sin(M_PI_2 - obstacle_phi);
+  GetRoads(center_point, rotation, polylines);
+  GetLanes(center_point, rotation, polylines);
+  GetJunctions(center_point, rotation, polylines);
+  GetCrosswalks(center_point, rotation, polylines);
   return true;
 }
 
@@ -157,42 +234,44 @@ bool VectorNet::offline_query(const double obstacle_x,
 }
 
 void VectorNet::GetRoads(const common::PointENU& center_point,
-                         const double obstacle_phi,
-                         FeatureVector* const feature_ptr,
-                         PidVector* const p_id_ptr) {
+                         const Rotation& rotation,
+                         VectorNetPolylines* const polylines) {
   std::vector<apollo::hdmap::RoadInfoConstPtr> roads;
   apollo::hdmap::HDMapUtil::BaseMap().GetRoads(center_point,
                                                FLAGS_road_distance, &roads);
 
   for (const auto& road : roads) {
-    for (const auto& section : road->road().section()) {
-      for (const auto& edge : section.boundary().outer_polygon().edge()) {
-        std::vector<std::vector<double>> one_polyline;
-        std::vector<double> one_p_id{std::numeric_limits<float>::max(),
-                                     std::numeric_limits<float>::max()};
-        double start_length = 0;
-        BOUNDARY_TYPE bound_type = UNKNOW;
-        if (edge.type() == hdmap::BoundaryEdge::LEFT_BOUNDARY) {
-          bound_type = LEFT_BOUNDARY;
-        } else if (edge.type() == hdmap::BoundaryEdge::RIGHT_BOUNDARY) {
-          bound_type = RIGHT_BOUNDARY;
-        } else if (edge.type() == hdmap::BoundaryEdge::NORMAL) {
-          bound_type = NORMAL;
-        } else {
-          bound_type = UNKNOW;
-        }
-
-        for (const auto& segment : edge.curve().segment()) {
-          GetOnePolyline(segment.line_segment().point(), &start_length,
-                         center_point, obstacle_phi, ROAD, bound_type, count_,
-                         &one_polyline, &one_p_id);
-        }
-        if (one_polyline.size() == 0) continue;
-
-        feature_ptr->push_back(std::move(one_polyline));
-        p_id_ptr->push_back(std::move(one_p_id));
-        ++count_;
-      }
+    auto build_polylines =
+        [this, &road](std::vector<ResampledPolyline>* road_polylines) {
+          for (const auto& section : road->road().section()) {
+            for (const auto& edge :
+                 section.boundary().outer_polygon().edge()) {
+              ResampledPolyline one_polyline;
+              double start_length = 0;
+              BOUNDARY_TYPE bound_type = UNKNOW;
+              if (edge.type() == hdmap::BoundaryEdge::LEFT_BOUNDARY) {
+                bound_type = LEFT_BOUNDARY;
+              } else if (edge.type() == hdmap::BoundaryEdge::RIGHT_BOUNDARY) {
+                bound_type = RIGHT_BOUNDARY;
+              } else if (edge.type() == hdmap::BoundaryEdge::NORMAL) {
+                bound_type = NORMAL;
+              } else {
+                bound_type = UNKNOW;
+              }
+              one_polyline.boundary = boundary_map.at(bound_type);
+
+              for (const auto& segment : edge.curve().segment()) {
+                ResamplePoints(segment.line_segment().point(), &start_length,
+                               ROAD, &one_polyline);
+              }
+              road_polylines->push_back(std::move(one_polyline));
+            }
+          }
+        };
+    CachedPolylines road_polylines =
+        GetCachedPolylines("road/" + road->id().id(), build_polylines);
+    for (const auto& one_polyline : *road_polylines) {
+      AppendPolyline(one_polyline, rotation, 1, polylines);
     }
   }
 }
@@ -236,9 +315,8 @@ void VectorNet::GetLaneQueue(
 }
 
 void VectorNet::GetLanes(const common::PointENU& center_point,
-                         const double obstacle_phi,
-                         FeatureVector* const feature_ptr,
-                         PidVector* const p_id_ptr) {
+                         const Rotation& rotation,
+                         VectorNetPolylines* const polylines) {
   std::vector<apollo::hdmap::LaneInfoConstPtr> lanes;
   apollo::hdmap::HDMapUtil::BaseMap().GetLanes(center_point,
                                                FLAGS_road_distance, &lanes);
@@ -247,94 +325,95 @@ void VectorNet::GetLanes(const common::PointENU& center_point,
   GetLaneQueue(lanes, &lane_deque_vector);
 
   for (const auto& lane_deque : lane_deque_vector) {
-    // Draw lane's left_boundary
-    std::vector<std::vector<double>> left_polyline;
-    std::vector<double> left_p_id{std::numeric_limits<float>::max(),
-                                  std::numeric_limits<float>::max()};
-    double start_length = 0;
+    std::string key = "lane";
     for (const auto& lane : lane_deque) {
-      std::cout << lane->lane().id().id() << " ";
-      // if (lane->lane().left_boundary().virtual_()) continue;
-      for (const auto& segment :
-           lane->lane().left_boundary().curve().segment()) {
-        auto bound_type =
-            lane->lane().left_boundary().boundary_type(0).types(0);
-        GetOnePolyline(segment.line_segment().point(), &start_length,
-                       center_point, obstacle_phi, lane_attr_map.at(bound_type),
-                       LEFT_BOUNDARY, count_, &left_polyline, &left_p_id);
-      }
+      key += "/" + lane->lane().id().id();
     }
-
-    if (left_polyline.size() < 2) continue;
-    feature_ptr->push_back(std::move(left_polyline));
-    p_id_ptr->push_back(std::move(left_p_id));
-    ++count_;
-
-    std::vector<std::vector<double>> right_polyline;
-    std::vector<double> right_p_id{std::numeric_limits<float>::max(),
-                                   std::numeric_limits<float>::max()};
-    start_length = 0;
-    // Draw lane's right_boundary
-    for (const auto& lane : lane_deque) {
-      // if (lane->lane().right_boundary().virtual_()) continue;
-      for (const auto& segment :
-           lane->lane().right_boundary().curve().segment()) {
-        auto bound_type =
-            lane->lane().left_boundary().boundary_type(0).types(0);
-        GetOnePolyline(segment.line_segment().point(), &start_length,
-                       center_point, obstacle_phi, lane_attr_map.at(bound_type),
-                       RIGHT_BOUNDARY, count_, &right_polyline, &right_p_id);
-      }
+    auto build_polylines =
+        [this, &lane_deque](std::vector<ResampledPolyline>* lane_polylines) {
+          // lane's left_boundary
+          ResampledPolyline left_polyline;
+          left_polyline.boundary = boundary_map.at(LEFT_BOUNDARY);
+          double start_length = 0;
+          for (const auto& lane : lane_deque) {
+            // if (lane->lane().left_boundary().virtual_()) continue;
+            for (const auto& segment :
+                 lane->lane().left_boundary().curve().segment()) {
+              auto bound_type =
+                  lane->lane().left_boundary().boundary_type(0).types(0);
+              ResamplePoints(segment.line_segment().point(), &start_length,
+                             lane_attr_map.at(bound_type), &left_polyline);
+            }
+          }
+          lane_polylines->push_back(std::move(left_polyline));
+
+          // lane's right_boundary
+          ResampledPolyline right_polyline;
+          right_polyline.boundary = boundary_map.at(RIGHT_BOUNDARY);
+          start_length = 0;
+          for (const auto& lane : lane_deque) {
+            // if (lane->lane().right_boundary().virtual_()) continue;
+            for (const auto& segment :
+                 lane->lane().right_boundary().curve().segment()) {
+              auto bound_type =
+                  lane->lane().left_boundary().boundary_type(0).types(0);
+              ResamplePoints(segment.line_segment().point(), &start_length,
+                             lane_attr_map.at(bound_type), &right_polyline);
+            }
+          }
+          lane_polylines->push_back(std::move(right_polyline));
+        };
+    CachedPolylines lane_polylines = GetCachedPolylines(key, build_polylines);
+
+    if (!AppendPolyline((*lane_polylines)[0], rotation, 2, polylines)) {
+      continue;
     }
-
-    if (right_polyline.size() < 2) continue;
-    feature_ptr->push_back(std::move(right_polyline));
-    p_id_ptr->push_back(std::move(right_p_id));
-    ++count_;
+    AppendPolyline((*lane_polylines)[1], rotation, 2, polylines);
   }
 }
 
 void VectorNet::GetJunctions(const common::PointENU& center_point,
-                             const double obstacle_phi,
-                             FeatureVector* const feature_ptr,
-                             PidVector* const p_id_ptr) {
+                             const Rotation& rotation,
+                             VectorNetPolylines* const polylines) {
   std::vector<apollo::hdmap::JunctionInfoConstPtr> junctions;
   apollo::hdmap::HDMapUtil::BaseMap().GetJunctions(
       center_point, FLAGS_road_distance, &junctions);
   for (const auto& junction : junctions) {
-    std::vector<std::vector<double>> one_polyline;
-    std::vector<double> one_p_id{std::numeric_limits<float>::max(),
-                                 std::numeric_limits<float>::max()};
-    double start_length = 0;
-    GetOnePolyline(junction->junction().polygon().point(), &start_length,
-                   center_point, obstacle_phi, JUNCTION, UNKNOW, count_,
-                   &one_polyline, &one_p_id);
-
-    feature_ptr->push_back(std::move(one_polyline));
-    p_id_ptr->push_back(std::move(one_p_id));
-    ++count_;
+    auto build_polylines =
+        [this, &junction](std::vector<ResampledPolyline>* junction_polylines) {
+          ResampledPolyline one_polyline;
+          one_polyline.boundary = boundary_map.at(UNKNOW);
+          double start_length = 0;
+          ResamplePoints(junction->junction().polygon().point(), &start_length,
+                         JUNCTION, &one_polyline);
+          junction_polylines->push_back(std::move(one_polyline));
+        };
+    CachedPolylines junction_polylines = GetCachedPolylines(
+        "junction/" + junction->id().id(), build_polylines);
+    AppendPolyline((*junction_polylines)[0], rotation, 0, polylines);
   }
 }
 
 void VectorNet::GetCrosswalks(const common::PointENU& center_point,
-                              const double obstacle_phi,
-                              FeatureVector* const feature_ptr,
-                              PidVector* const p_id_ptr) {
+                              const Rotation& rotation,
+                              VectorNetPolylines* const polylines) {
   std::vector<apollo::hdmap::CrosswalkInfoConstPtr> crosswalks;
   apollo::hdmap::HDMapUtil::BaseMap().GetCrosswalks(
       center_point, FLAGS_road_distance, &crosswalks);
   for (const auto& crosswalk : crosswalks) {
-    std::vector<std::vector<double>> one_polyline;
-    std::vector<double> one_p_id{std::numeric_limits<float>::max(),
-                                 std::numeric_limits<float>::max()};
-    double start_length = 0;
-    GetOnePolyline(crosswalk->crosswalk().polygon().point(), &start_length,
-                   center_point, obstacle_phi, CROSSWALK, UNKNOW, count_,
-                   &one_polyline, &one_p_id);
-
-    feature_ptr->push_back(std::move(one_polyline));
-    p_id_ptr->push_back(std::move(one_p_id));
-    ++count_;
+    auto build_polylines = [this, &crosswalk](
+                               std::vector<ResampledPolyline>*
+                                   crosswalk_polylines) {
+      ResampledPolyline one_polyline;
+      one_polyline.boundary = boundary_map.at(UNKNOW);
+      double start_length = 0;
+      ResamplePoints(crosswalk->crosswalk().polygon().point(), &start_length,
+                     CROSSWALK, &one_polyline);
+      crosswalk_polylines->push_back(std::move(one_polyline));
+    };
+    CachedPolylines crosswalk_polylines = GetCachedPolylines(
+        "crosswalk/" + crosswalk->id().id(), build_polylines);
+    AppendPolyline((*crosswalk_polylines)[0], rotation, 0, polylines);
   }
 }
 }  // namespace prediction
@@ -18,8 +18,11 @@
 
 #include <deque>
 #include <map>
-#include <vector>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "modules/prediction/proto/vector_net.pb.h"
 #include "modules/common/math/linear_interpolation.h"
@@ -33,6 +36,40 @@ namespace prediction {
 using FeatureVector = std::vector<std::vector<std::vector<double>>>;
 using PidVector = std::vector<std::vector<double>>;
 
+// Map polylines around a point in flat arrays. Every vector has
+// kVectorSize values: start x, start y, end x, end y, 0, 0, attribute,
+// boundary type and the index of its polyline, the same as a vector of
+// FeatureVector.
+struct VectorNetPolylines {
+  static constexpr int kVectorSize = 9;
+
+  // vectors of all polylines one after the other
+  std::vector<double> vectors;
+  // polyline i has the vectors [vector_offsets[i], vector_offsets[i + 1])
+  std::vector<int> vector_offsets{0};
+  // p_id x and y of every polyline
+  std::vector<double> p_ids;
+
+  int size() const { return static_cast<int>(vector_offsets.size()) - 1; }
+
+  int vector_num(const int i) const {
+    return vector_offsets[i + 1] - vector_offsets[i];
+  }
+
+  // the vectors of polyline i
+  const double* vector_data(const int i) const {
+    return vectors.data() + vector_offsets[i] * kVectorSize;
+  }
+
+  const double* p_id(const int i) const { return p_ids.data() + 2 * i; }
+
+  void clear() {
+    vectors.clear();
+    vector_offsets.assign(1, 0);
+    p_ids.clear();
+  }
+};
+
 enum ATTRIBUTE_TYPE {
   ROAD,
   LANE_UNKOWN,
@@ -62,6 +99,17 @@ class VectorNet {
   bool query(const common::PointENU& center_point, const double obstacle_phi,
              FeatureVector* const feature_ptr, PidVector* const p_id_ptr);
 
+  /**
+   * @brief Query the map polylines around a point in the frame of an
+   *        obstacle. The polylines of the map elements are resampled once
+   *        and cached, a query only rotates the cached points.
+   * @param Center point
+   * @param Heading of the obstacle
+   * @param Polylines, cleared first
+   */
+  bool query(const common::PointENU& center_point, const double obstacle_phi,
+             VectorNetPolylines* const polylines);
+
   bool offline_query(const double obstacle_x, const double obstacle_y,
                      const double obstacle_phi);
 
@@ -97,31 +145,65 @@ class VectorNet {
       {hdmap::LaneBoundaryType::CURB, LANE_CURB},
   };
 
-  template <typename Points>
-  void GetOnePolyline(const Points& points, double* start_length,
-                      const common::PointENU& center_point,
-                      const double obstacle_phi, ATTRIBUTE_TYPE attr_type,
-                      BOUNDARY_TYPE bound_type, const int count,
-                      std::vector<std::vector<double>>* const one_polyline,
-                      std::vector<double>* const one_p_id);
+  // Points of a map polyline resampled every FLAGS_point_distance in map
+  // coordinates, x and y interleaved. Every curve segment is resampled on
+  // its own, chunk i has the points [chunk_offsets[i], chunk_offsets[i + 1])
+  // and no vector joins two chunks.
+  struct ResampledPolyline {
+    std::vector<double> points;
+    std::vector<int> chunk_offsets{0};
+    std::vector<double> chunk_attributes;
+    double boundary = 0.0;
+  };
+  using CachedPolylines = std::shared_ptr<const std::vector<ResampledPolyline>>;
+
+  // Rotation of map points into the frame of the obstacle
+  struct Rotation {
+    double center_x = 0.0;
+    double center_y = 0.0;
+    double cos_theta = 1.0;
+    double sin_theta = 0.0;
+  };
 
-  void GetRoads(const common::PointENU& center_point, const double obstacle_phi,
-                FeatureVector* const feature_ptr, PidVector* const p_id_ptr);
+  template <typename Points>
+  void ResamplePoints(const Points& points, double* start_length,
+                      ATTRIBUTE_TYPE attr_type,
+                      ResampledPolyline* const polyline);
+
+  // Appends the vectors of a polyline rotated into the frame of the
+  // obstacle as the next polyline if it has at least min_vector_num vectors,
+  // returns false if it does not.
+  bool AppendPolyline(const ResampledPolyline& polyline,
+                      const Rotation& rotation, const int min_vector_num,
+                      VectorNetPolylines* const polylines);
+
+  // The polylines of a map element from the cache, built by build_polylines
+  // the first time the key is asked for.
+  template <typename BuildPolylines>
+  CachedPolylines GetCachedPolylines(const std::string& key,
+                                     BuildPolylines build_polylines);
+
+  void GetRoads(const common::PointENU& center_point, const Rotation& rotation,
+                VectorNetPolylines* const polylines);
 
   void GetLaneQueue(
       const std::vector<hdmap::LaneInfoConstPtr>& lanes,
       std::vector<std::deque<hdmap::LaneInfoConstPtr>>* const lane_deque_ptr);
 
-  void GetLanes(const common::PointENU& center_point, const double obstacle_phi,
-                FeatureVector* const feature_ptr, PidVector* const p_id_ptr);
+  void GetLanes(const common::PointENU& center_point, const Rotation& rotation,
+                VectorNetPolylines* const polylines);
   void GetJunctions(const common::PointENU& center_point,
-                    const double obstacle_phi, FeatureVector* const feature_ptr,
-                    PidVector* const p_id_ptr);
+                    const Rotation& rotation,
+                    VectorNetPolylines* const polylines);
   void GetCrosswalks(const common::PointENU& center_point,
-                     const double obstacle_phi,
-                     FeatureVector* const feature_ptr,
-                     PidVector* const p_id_ptr);
-  int count_ = 0;
+                     const Rotation& rotation,
+                     VectorNetPolylines* const polylines);
+
+  // Resampled polylines by map element, lanes by the ids of the connected
+  // lanes queried together. Queries run concurrently for the obstacles.
+  std::mutex polyline_cache_mutex_;
+  std::unordered_map<std::string, CachedPolylines> polyline_cache_;
+  double cached_point_distance_ = 0.0;
 };
 
 }  // namespace prediction
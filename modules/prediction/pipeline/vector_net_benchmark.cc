@@ -0,0 +1,416 @@
+/******************************************************************************
+ * Copyright 2024 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Map queries of VectorNet over a region: one query at the start of every
+// lane of the prediction testdata map, heading along the lane. BM_NestedQuery
+// resamples and rotates every map element into nested vectors on each query
+// the way VectorNet::query used to, BM_FlatQuery fills VectorNetPolylines from
+// the cached polylines and BM_FlatQueryColdCache does the same with an empty
+// cache on every pass. mismatched_polylines counts the polylines of the
+// FeatureVector query that are not identical to the nested ones. Run from the
+// repo root:
+//   vector_net_benchmark
+// Time is the latency of all queries, items_per_second the query rate.
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "gflags/gflags.h"
+
+#include "modules/common/configs/config_gflags.h"
+#include "modules/prediction/pipeline/vector_net.h"
+
+namespace apollo {
+namespace prediction {
+namespace {
+
+struct QueryPoint {
+  common::PointENU center_point;
+  double heading = 0.0;
+};
+
+std::vector<QueryPoint> LaneStartPoints() {
+  std::vector<hdmap::LaneInfoConstPtr> lanes;
+  hdmap::HDMapUtil::BaseMap().GetLanes(
+      common::util::PointFactory::ToPointENU(0.0, 0.0),
+      std::numeric_limits<double>::max(), &lanes);
+  std::vector<QueryPoint> query_points;
+  for (const auto& lane : lanes) {
+    if (lane->points().empty() || lane->headings().empty()) {
+      continue;
+    }
+    QueryPoint query_point;
+    query_point.center_point = common::util::PointFactory::ToPointENU(
+        lane->points().front().x(), lane->points().front().y());
+    query_point.heading = lane->headings().front();
+    query_points.push_back(query_point);
+  }
+  return query_points;
+}
+
+// VectorNet::query before the polylines were cached
+class NestedVectorNet {
+ public:
+  void Query(const common::PointENU& center_point, const double obstacle_phi,
+             FeatureVector* const feature_ptr, PidVector* const p_id_ptr) {
+    count_ = 0;
+    GetRoads(center_point, obstacle_phi, feature_ptr, p_id_ptr);
+    GetLanes(center_point, obstacle_phi, feature_ptr, p_id_ptr);
+    GetJunctions(center_point, obstacle_phi, feature_ptr, p_id_ptr);
+    GetCrosswalks(center_point, obstacle_phi, feature_ptr, p_id_ptr);
+  }
+
+ private:
+  // the values of attribute_map, boundary_map and lane_attr_map of VectorNet
+  static double Attribute(ATTRIBUTE_TYPE attr_type) {
+    return static_cast<double>(attr_type);
+  }
+  static double LaneAttribute(hdmap::LaneBoundaryType::Type type) {
+    return static_cast<double>(type) + 1.0;
+  }
+
+  template <typename Points>
+  void GetOnePolyline(const Points& points, double* start_length,
+                      const common::PointENU& center_point,
+                      const double obstacle_phi, const double attr,
+                      BOUNDARY_TYPE bound_type, const int count,
+                      std::vector<std::vector<double>>* const one_polyline,
+                      std::vector<double>* const one_p_id) {
+    size_t size = points.size();
+    std::vector<double> s(size, 0);
+    for (size_t i = 1; i < size; ++i) {
+      s[i] = std::hypot(points.at(i).x() - points.at(i - 1).x(),
+                        points.at(i).y() - points.at(i - 1).y()) +
+             s[i - 1];
+    }
+
+    std::vector<double> x;
+    std::vector<double> y;
+    double cur_length = *start_length;
+    auto it_lower = std::lower_bound(s.begin(), s.end(), cur_length);
+    while (it_lower != s.end()) {
+      if (it_lower == s.begin()) {
+        x.push_back(points.at(0).x());
+        y.push_back(points.at(0).y());
+      } else {
+        const auto distance = std::distance(s.begin(), it_lower);
+        x.push_back(common::math::lerp(points.at(distance - 1).x(),
+                                       s[distance - 1],
+                                       points.at(distance).x(), s[distance],
+                                       cur_length));
+        y.push_back(common::math::lerp(points.at(distance - 1).y(),
+                                       s[distance - 1],
+                                       points.at(distance).y(), s[distance],
+                                       cur_length));
+      }
+      cur_length += FLAGS_point_distance;
+      it_lower = std::lower_bound(s.begin(), s.end(), cur_length);
+    }
+    size_t point_size = x.size();
+
+    *start_length = cur_length - s[size - 1];
+    if (point_size == 0) return;
+    const double bound = static_cast<double>(bound_type);
+    auto last_point_after_rotate = common::math::RotateVector2d(
+        {x[0] - center_point.x(), y[0] - center_point.y()},
+        M_PI_2 - obstacle_phi);
+
+    for (size_t i = 1; i < point_size; ++i) {
+      if (one_p_id->at(0) > last_point_after_rotate.x()) {
+        one_p_id->at(0) = last_point_after_rotate.x();
+      }
+      if (one_p_id->at(1) > last_point_after_rotate.y()) {
+        one_p_id->at(1) = last_point_after_rotate.y();
+      }
+      std::vector<double> one_vector;
+      one_vector.push_back(last_point_after_rotate.x());
+      one_vector.push_back(last_point_after_rotate.y());
+      Eigen::Vector2d point_after_rotate = common::math::RotateVector2d(
+          {x[i] - center_point.x(), y[i] - center_point.y()},
+          M_PI_2 - obstacle_phi);
+      one_vector.push_back(point_after_rotate.x());
+      one_vector.push_back(point_after_rotate.y());
+      last_point_after_rotate = std::move(point_after_rotate);
+      one_vector.insert(one_vector.end(), {0.0, 0.0, attr, bound});
+      one_vector.push_back(count);
+      one_polyline->push_back(std::move(one_vector));
+    }
+  }
+
+  static std::vector<double> EmptyPid() {
+    return {std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::max()};
+  }
+
+  void GetRoads(const common::PointENU& center_point,
+                const double obstacle_phi, FeatureVector* const feature_ptr,
+                PidVector* const p_id_ptr) {
+    std::vector<hdmap::RoadInfoConstPtr> roads;
+    hdmap::HDMapUtil::BaseMap().GetRoads(center_point, FLAGS_road_distance,
+                                         &roads);
+    for (const auto& road : roads) {
+      for (const auto& section : road->road().section()) {
+        for (const auto& edge : section.boundary().outer_polygon().edge()) {
+          std::vector<std::vector<double>> one_polyline;
+          std::vector<double> one_p_id = EmptyPid();
+          double start_length = 0;
+          BOUNDARY_TYPE bound_type = UNKNOW;
+          if (edge.type() == hdmap::BoundaryEdge::LEFT_BOUNDARY) {
+            bound_type = LEFT_BOUNDARY;
+          } else if (edge.type() == hdmap::BoundaryEdge::RIGHT_BOUNDARY) {
+            bound_type = RIGHT_BOUNDARY;
+          } else if (edge.type() == hdmap::BoundaryEdge::NORMAL) {
+            bound_type = NORMAL;
+          }
+          for (const auto& segment : edge.curve().segment()) {
+            GetOnePolyline(segment.line_segment().point(), &start_length,
+                           center_point, obstacle_phi, Attribute(ROAD),
+                           bound_type, count_, &one_polyline, &one_p_id);
+          }
+          if (one_polyline.size() == 0) continue;
+          feature_ptr->push_back(std::move(one_polyline));
+          p_id_ptr->push_back(std::move(one_p_id));
+          ++count_;
+        }
+      }
+    }
+  }
+
+  void GetLaneQueue(
+      const std::vector<hdmap::LaneInfoConstPtr>& lanes,
+      std::vector<std::deque<hdmap::LaneInfoConstPtr>>* const lane_deques) {
+    std::unordered_set<hdmap::LaneInfoConstPtr> lane_set(lanes.begin(),
+                                                         lanes.end());
+    while (!lane_set.empty()) {
+      std::deque<hdmap::LaneInfoConstPtr> one_lane_deque;
+      auto cur_lane = *lane_set.begin();
+      lane_set.erase(lane_set.begin());
+      one_lane_deque.push_back(cur_lane);
+      while (cur_lane->lane().successor_id_size() > 0) {
+        cur_lane = hdmap::HDMapUtil::BaseMap().GetLaneById(
+            cur_lane->lane().successor_id(0));
+        if (lane_set.erase(cur_lane) == 0) break;
+        one_lane_deque.push_back(cur_lane);
+      }
+      cur_lane = one_lane_deque.front();
+      while (cur_lane->lane().predecessor_id_size() > 0) {
+        cur_lane = hdmap::HDMapUtil::BaseMap().GetLaneById(
+            cur_lane->lane().predecessor_id(0));
+        if (lane_set.erase(cur_lane) == 0) break;
+        one_lane_deque.push_front(cur_lane);
+      }
+      lane_deques->push_back(one_lane_deque);
+    }
+  }
+
+  void GetLanes(const common::PointENU& center_point,
+                const double obstacle_phi, FeatureVector* const feature_ptr,
+                PidVector* const p_id_ptr) {
+    std::vector<hdmap::LaneInfoConstPtr> lanes;
+    hdmap::HDMapUtil::BaseMap().GetLanes(center_point, FLAGS_road_distance,
+                                         &lanes);
+    std::vector<std::deque<hdmap::LaneInfoConstPtr>> lane_deques;
+    GetLaneQueue(lanes, &lane_deques);
+
+    for (const auto& lane_deque : lane_deques) {
+      std::vector<std::vector<double>> left_polyline;
+      std::vector<double> left_p_id = EmptyPid();
+      double start_length = 0;
+      for (const auto& lane : lane_deque) {
+        const auto& boundary = lane->lane().left_boundary();
+        for (const auto& segment : boundary.curve().segment()) {
+          GetOnePolyline(segment.line_segment().point(), &start_length,
+                         center_point, obstacle_phi,
+                         LaneAttribute(boundary.boundary_type(0).types(0)),
+                         LEFT_BOUNDARY, count_, &left_polyline, &left_p_id);
+        }
+      }
+      if (left_polyline.size() < 2) continue;
+      feature_ptr->push_back(std::move(left_polyline));
+      p_id_ptr->push_back(std::move(left_p_id));
+      ++count_;
+
+      std::vector<std::vector<double>> right_polyline;
+      std::vector<double> right_p_id = EmptyPid();
+      start_length = 0;
+      for (const auto& lane : lane_deque) {
+        // typed by the left boundary like VectorNet does
+        const auto bound_type =
+            lane->lane().left_boundary().boundary_type(0).types(0);
+        for (const auto& segment :
+             lane->lane().right_boundary().curve().segment()) {
+          GetOnePolyline(segment.line_segment().point(), &start_length,
+                         center_point, obstacle_phi, LaneAttribute(bound_type),
+                         RIGHT_BOUNDARY, count_, &right_polyline,
+                         &right_p_id);
+        }
+      }
+      if (right_polyline.size() < 2) continue;
+      feature_ptr->push_back(std::move(right_polyline));
+      p_id_ptr->push_back(std::move(right_p_id));
+      ++count_;
+    }
+  }
+
+  void GetJunctions(const common::PointENU& center_point,
+                    const double obstacle_phi,
+                    FeatureVector* const feature_ptr,
+                    PidVector* const p_id_ptr) {
+    std::vector<hdmap::JunctionInfoConstPtr> junctions;
+    hdmap::HDMapUtil::BaseMap().GetJunctions(center_point, FLAGS_road_distance,
+                                             &junctions);
+    for (const auto& junction : junctions) {
+      std::vector<std::vector<double>> one_polyline;
+      std::vector<double> one_p_id = EmptyPid();
+      double start_length = 0;
+      GetOnePolyline(junction->junction().polygon().point(), &start_length,
+                     center_point, obstacle_phi, Attribute(JUNCTION), UNKNOW,
+                     count_, &one_polyline, &one_p_id);
+      feature_ptr->push_back(std::move(one_polyline));
+      p_id_ptr->push_back(std::move(one_p_id));
+      ++count_;
+    }
+  }
+
+  void GetCrosswalks(const common::PointENU& center_point,
+                     const double obstacle_phi,
+                     FeatureVector* const feature_ptr,
+                     PidVector* const p_id_ptr) {
+    std::vector<hdmap::CrosswalkInfoConstPtr> crosswalks;
+    hdmap::HDMapUtil::BaseMap().GetCrosswalks(
+        center_point, FLAGS_road_distance, &crosswalks);
+    for (const auto& crosswalk : crosswalks) {
+      std::vector<std::vector<double>> one_polyline;
+      std::vector<double> one_p_id = EmptyPid();
+      double start_length = 0;
+      GetOnePolyline(crosswalk->crosswalk().polygon().point(), &start_length,
+                     center_point, obstacle_phi, Attribute(CROSSWALK), UNKNOW,
+                     count_, &one_polyline, &one_p_id);
+      feature_ptr->push_back(std::move(one_polyline));
+      p_id_ptr->push_back(std::move(one_p_id));
+      ++count_;
+    }
+  }
+
+  int count_ = 0;
+};
+
+VectorNet* SharedVectorNet() {
+  static VectorNet* vector_net = new VectorNet();
+  return vector_net;
+}
+
+void CompareQueries(const std::vector<QueryPoint>& query_points,
+                    VectorNet* vector_net, benchmark::State* state) {
+  NestedVectorNet nested_vector_net;
+  int mismatched = 0;
+  for (const auto& query_point : query_points) {
+    FeatureVector expected_feature;
+    PidVector expected_p_id;
+    nested_vector_net.Query(query_point.center_point, query_point.heading,
+                            &expected_feature, &expected_p_id);
+    FeatureVector feature;
+    PidVector p_id;
+    vector_net->query(query_point.center_point, query_point.heading, &feature,
+                      &p_id);
+    if (feature.size() != expected_feature.size()) {
+      state->SkipWithError("polyline count differs");
+      return;
+    }
+    for (size_t i = 0; i < feature.size(); ++i) {
+      if (feature[i] != expected_feature[i] || p_id[i] != expected_p_id[i]) {
+        ++mismatched;
+      }
+    }
+  }
+  state->counters["mismatched_polylines"] = mismatched;
+}
+
+void BM_NestedQuery(benchmark::State& state) {
+  SharedVectorNet();
+  const std::vector<QueryPoint> query_points = LaneStartPoints();
+  NestedVectorNet nested_vector_net;
+  for (auto _ : state) {
+    for (const auto& query_point : query_points) {
+      FeatureVector feature;
+      PidVector p_id;
+      nested_vector_net.Query(query_point.center_point, query_point.heading,
+                              &feature, &p_id);
+      benchmark::DoNotOptimize(feature.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(query_points.size()));
+}
+BENCHMARK(BM_NestedQuery)->Unit(benchmark::kMillisecond);
+
+void BM_FlatQuery(benchmark::State& state) {
+  VectorNet* vector_net = SharedVectorNet();
+  const std::vector<QueryPoint> query_points = LaneStartPoints();
+  VectorNetPolylines polylines;
+  for (auto _ : state) {
+    for (const auto& query_point : query_points) {
+      vector_net->query(query_point.center_point, query_point.heading,
+                        &polylines);
+      benchmark::DoNotOptimize(polylines.vectors.data());
+    }
+  }
+  CompareQueries(query_points, vector_net, &state);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(query_points.size()));
+}
+BENCHMARK(BM_FlatQuery)->Unit(benchmark::kMillisecond);
+
+void BM_FlatQueryColdCache(benchmark::State& state) {
+  std::unique_ptr<VectorNet> vector_net;
+  std::vector<QueryPoint> query_points;
+  VectorNetPolylines polylines;
+  for (auto _ : state) {
+    // the constructor reloads the map
+    state.PauseTiming();
+    vector_net.reset(new VectorNet());
+    query_points = LaneStartPoints();
+    state.ResumeTiming();
+    for (const auto& query_point : query_points) {
+      vector_net->query(query_point.center_point, query_point.heading,
+                        &polylines);
+      benchmark::DoNotOptimize(polylines.vectors.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(query_points.size()));
+}
+BENCHMARK(BM_FlatQueryColdCache)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace prediction
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  FLAGS_map_dir = "modules/prediction/testdata";
+  FLAGS_base_map_filename = "kml_map.bin";
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
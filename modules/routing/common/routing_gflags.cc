@@ -32,3 +32,10 @@ DEFINE_bool(enable_change_lane_in_result, true,
 
 DEFINE_uint32(routing_response_history_interval_ms, 1000,
               "ms, emit routing resposne for this time interval");
+
+DEFINE_bool(enable_routing_landmarks, false,
+            "use the precomputed landmark file next to the routing map as "
+            "the A* heuristic");
+
+DEFINE_int32(routing_landmark_num, 16,
+             "number of landmarks computed by topo_creator, 0 to skip");
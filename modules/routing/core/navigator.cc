@@ -19,7 +19,6 @@
 #include "cyber/common/file.h"
 #include "modules/routing/common/routing_gflags.h"
 #include "modules/routing/graph/sub_topo_graph.h"
-#include "modules/routing/strategy/a_star_strategy.h"
 
 namespace apollo {
 namespace routing {
@@ -107,6 +106,10 @@ Navigator::Navigator(const std::string& topo_file_path) {
           << topo_file_path;
     return;
   }
+  strategy_.reset(new AStarStrategy(FLAGS_enable_change_lane_in_result));
+  if (FLAGS_enable_routing_landmarks) {
+    LoadLandmarks(topo_file_path);
+  }
   black_list_generator_.reset(new BlackListRangeGenerator);
   result_generator_.reset(new ResultGenerator);
   is_ready_ = true;
@@ -119,6 +122,24 @@ bool Navigator::IsReady() const { return is_ready_; }
 
 void Navigator::Clear() { topo_range_manager_.Clear(); }
 
+void Navigator::LoadLandmarks(const std::string& topo_file_path) {
+  const auto landmark_file = LandmarkHeuristic::LandmarkFile(topo_file_path);
+  LandmarkSet landmarks;
+  if (!cyber::common::GetProtoFromFile(landmark_file, &landmarks)) {
+    AWARN << "Failed to read routing landmarks from " << landmark_file
+          << ", search without them.";
+    return;
+  }
+  if (!landmarks_.Init(*graph_, landmarks)) {
+    AWARN << "Routing landmarks in " << landmark_file
+          << " do not match the graph, search without them.";
+    return;
+  }
+  strategy_->SetLandmarks(&landmarks_);
+  AINFO << "Loaded " << landmarks_.LandmarkNum() << " routing landmarks from "
+        << landmark_file;
+}
+
 bool Navigator::Init(const routing::RoutingRequest& request,
                      const TopoGraph* graph,
                      std::vector<const TopoNode*>* const way_nodes,
@@ -155,9 +176,7 @@ bool Navigator::SearchRouteByStrategy(
     const TopoGraph* graph, const std::vector<const TopoNode*>& way_nodes,
     const std::vector<double>& way_s,
     std::vector<NodeWithRange>* const result_nodes) const {
-  std::unique_ptr<Strategy> strategy_ptr;
-  strategy_ptr.reset(new AStarStrategy(FLAGS_enable_change_lane_in_result));
-
+  std::lock_guard<std::mutex> lock(strategy_mutex_);
   result_nodes->clear();
   std::vector<NodeWithRange> node_vec;
   for (size_t i = 1; i < way_nodes.size(); ++i) {
@@ -185,8 +204,8 @@ bool Navigator::SearchRouteByStrategy(
     }
 
     std::vector<NodeWithRange> cur_result_nodes;
-    if (!strategy_ptr->Search(graph, &sub_graph, start, end,
-                              &cur_result_nodes)) {
+    if (!strategy_->Search(graph, &sub_graph, start, end,
+                           &cur_result_nodes)) {
       AERROR << "Failed to search route with waypoint from " << start->LaneId()
              << " to " << end->LaneId();
       return false;
@@ -17,11 +17,14 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "modules/routing/core/black_list_range_generator.h"
 #include "modules/routing/core/result_generator.h"
+#include "modules/routing/strategy/a_star_strategy.h"
+#include "modules/routing/strategy/landmark_heuristic.h"
 
 namespace apollo {
 namespace routing {
@@ -43,6 +46,8 @@ class Navigator {
 
   void Clear();
 
+  void LoadLandmarks(const std::string& topo_file_path);
+
   bool SearchRouteByStrategy(
       const TopoGraph* graph, const std::vector<const TopoNode*>& way_nodes,
       const std::vector<double>& way_s,
@@ -54,6 +59,10 @@ class Navigator {
  private:
   bool is_ready_ = false;
   std::unique_ptr<TopoGraph> graph_;
+  LandmarkHeuristic landmarks_;
+  // keeps its search state across requests, a search holds strategy_mutex_
+  mutable std::mutex strategy_mutex_;
+  std::unique_ptr<AStarStrategy> strategy_;
 
   TopoRangeManager topo_range_manager_;
 
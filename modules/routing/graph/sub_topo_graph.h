@@ -68,6 +68,9 @@ class SubTopoGraph {
 
   const TopoNode* GetSubNodeWithS(const TopoNode* topo_node, double s) const;
 
+  // sub nodes are indexed in [0, SubNodeNum())
+  int SubNodeNum() const;
+
  private:
   void InitSubNodeByValidRange(const TopoNode* topo_node,
                                const std::vector<NodeSRange>& valid_range);
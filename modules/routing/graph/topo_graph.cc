@@ -36,6 +36,7 @@ bool TopoGraph::LoadNodes(const Graph& graph) {
     node_index_map_[node.lane_id()] = static_cast<int>(topo_nodes_.size());
     std::shared_ptr<TopoNode> topo_node;
     topo_node.reset(new TopoNode(node));
+    topo_node->SetIndex(static_cast<int>(topo_nodes_.size()));
     road_node_map_[node.road_id()].insert(topo_node.get());
     topo_nodes_.push_back(std::move(topo_node));
   }
@@ -96,6 +97,15 @@ const TopoNode* TopoGraph::GetNode(const std::string& id) const {
   return topo_nodes_[iter->second].get();
 }
 
+int TopoGraph::NodeNum() const { return static_cast<int>(topo_nodes_.size()); }
+
+const TopoNode* TopoGraph::GetNodeByIndex(int index) const {
+  if (index < 0 || index >= NodeNum()) {
+    return nullptr;
+  }
+  return topo_nodes_[index].get();
+}
+
 void TopoGraph::GetNodesByRoadId(
     const std::string& road_id,
     std::unordered_set<const TopoNode*>* const node_in_road) const {
@@ -38,6 +38,9 @@ class TopoGraph {
   const std::string& MapVersion() const;
   const std::string& MapDistrict() const;
   const TopoNode* GetNode(const std::string& id) const;
+  // nodes are indexed in [0, NodeNum()) in the order of the graph proto
+  int NodeNum() const;
+  const TopoNode* GetNodeByIndex(int index) const;
   void GetNodesByRoadId(
       const std::string& road_id,
       std::unordered_set<const TopoNode*>* const node_in_road) const;
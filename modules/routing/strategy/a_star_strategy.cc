@@ -18,6 +18,7 @@
 #include <cmath>
 #include <limits>
 #include <queue>
+#include <unordered_set>
 
 #include "modules/routing/common/routing_gflags.h"
 #include "modules/routing/graph/sub_topo_graph.h"
@@ -175,24 +176,15 @@ bool AdjustLaneChange(std::vector<const TopoNode*>* const result_node_vec) {
   return true;
 }
 
-bool Reconstruct(
-    const std::unordered_map<const TopoNode*, const TopoNode*>& came_from,
-    const TopoNode* dest_node, std::vector<NodeWithRange>* result_nodes) {
-  std::vector<const TopoNode*> result_node_vec;
-  result_node_vec.push_back(dest_node);
-
-  auto iter = came_from.find(dest_node);
-  while (iter != came_from.end()) {
-    result_node_vec.push_back(iter->second);
-    iter = came_from.find(iter->second);
-  }
-  std::reverse(result_node_vec.begin(), result_node_vec.end());
-  if (!AdjustLaneChange(&result_node_vec)) {
+bool Reconstruct(std::vector<const TopoNode*>* const result_node_vec,
+                 std::vector<NodeWithRange>* result_nodes) {
+  std::reverse(result_node_vec->begin(), result_node_vec->end());
+  if (!AdjustLaneChange(result_node_vec)) {
     AERROR << "Failed to adjust lane change";
     return false;
   }
   result_nodes->clear();
-  for (const auto* node : result_node_vec) {
+  for (const auto* node : *result_node_vec) {
     result_nodes->emplace_back(node->OriginNode(), node->StartS(),
                                node->EndS());
   }
@@ -204,16 +196,45 @@ bool Reconstruct(
 AStarStrategy::AStarStrategy(bool enable_change)
     : change_lane_enabled_(enable_change) {}
 
-void AStarStrategy::Clear() {
-  closed_set_.clear();
-  open_set_.clear();
-  came_from_.clear();
-  enter_s_.clear();
-  g_score_.clear();
+void AStarStrategy::SetLandmarks(const LandmarkHeuristic* landmarks) {
+  landmarks_ = landmarks;
+}
+
+void AStarStrategy::Clear(const TopoGraph* graph,
+                          const SubTopoGraph* sub_graph) {
+  sub_node_offset_ = graph->NodeNum();
+  const size_t node_num =
+      static_cast<size_t>(sub_node_offset_) + sub_graph->SubNodeNum();
+  if (node_states_.size() < node_num) {
+    node_states_.resize(node_num);
+  }
+  ++generation_;
+  if (generation_ == 0) {
+    for (auto& state : node_states_) {
+      state.generation = 0;
+    }
+    generation_ = 1;
+  }
+}
+
+AStarStrategy::NodeState& AStarStrategy::State(const TopoNode* node) {
+  const int index = node->IsSubNode() ? sub_node_offset_ + node->Index()
+                                      : node->Index();
+  CHECK(index >= 0 && static_cast<size_t>(index) < node_states_.size())
+      << "lane " << node->LaneId() << " has no search index";
+  auto& state = node_states_[index];
+  if (state.generation != generation_) {
+    state = NodeState();
+    state.generation = generation_;
+  }
+  return state;
 }
 
 double AStarStrategy::HeuristicCost(const TopoNode* src_node,
                                     const TopoNode* dest_node) {
+  if (landmarks_ != nullptr) {
+    return landmarks_->Estimate(src_node, dest_node);
+  }
   const auto& src_point = src_node->AnchorPoint();
   const auto& dest_point = dest_node->AnchorPoint();
   double distance = std::fabs(src_point.x() - dest_point.x()) +
@@ -225,7 +246,7 @@ bool AStarStrategy::Search(const TopoGraph* graph,
                            const SubTopoGraph* sub_graph,
                            const TopoNode* src_node, const TopoNode* dest_node,
                            std::vector<NodeWithRange>* const result_nodes) {
-  Clear();
+  Clear(graph, sub_graph);
   AINFO << "Start A* search algorithm.";
 
   std::priority_queue<SearchNode> open_set_detail;
@@ -234,9 +255,15 @@ bool AStarStrategy::Search(const TopoGraph* graph,
   src_search_node.f = HeuristicCost(src_node, dest_node);
   open_set_detail.push(src_search_node);
 
-  open_set_.insert(src_node);
-  g_score_[src_node] = 0.0;
-  enter_s_[src_node] = src_node->StartS();
+  auto& src_state = State(src_node);
+  src_state.is_open = true;
+  src_state.has_enter_s = true;
+  src_state.enter_s = src_node->StartS();
+
+  // Without landmarks the score of a node, heuristic included, is what its
+  // successors build on. Keep it that way so the routes do not change; the
+  // landmark heuristic is consistent and uses plain A* costs.
+  const bool use_g = landmarks_ != nullptr;
 
   SearchNode current_node;
   std::unordered_set<const TopoEdge*> next_edge_set;
@@ -245,20 +272,26 @@ bool AStarStrategy::Search(const TopoGraph* graph,
     current_node = open_set_detail.top();
     const auto* from_node = current_node.topo_node;
     if (current_node.topo_node == dest_node) {
-      if (!Reconstruct(came_from_, from_node, result_nodes)) {
+      std::vector<const TopoNode*> result_node_vec;
+      for (const auto* node = from_node; node != nullptr;
+           node = State(node).came_from) {
+        result_node_vec.push_back(node);
+      }
+      if (!Reconstruct(&result_node_vec, result_nodes)) {
         AERROR << "Failed to reconstruct route.";
         return false;
       }
       return true;
     }
-    open_set_.erase(from_node);
+    auto& from_state = State(from_node);
+    from_state.is_open = false;
     open_set_detail.pop();
 
-    if (closed_set_.count(from_node) != 0) {
+    if (from_state.is_closed) {
       // if showed before, just skip...
       continue;
     }
-    closed_set_.emplace(from_node);
+    from_state.is_closed = true;
 
     // if residual_s is less than FLAGS_min_length_for_lane_change, only move
     // forward
@@ -277,29 +310,30 @@ bool AStarStrategy::Search(const TopoGraph* graph,
 
     for (const auto* edge : next_edge_set) {
       const auto* to_node = edge->ToNode();
-      if (closed_set_.count(to_node) == 1) {
+      auto& to_state = State(to_node);
+      if (to_state.is_closed) {
         continue;
       }
       if (GetResidualS(edge, to_node) < FLAGS_min_length_for_lane_change) {
         continue;
       }
-      tentative_g_score =
-          g_score_[current_node.topo_node] + GetCostToNeighbor(edge);
+      tentative_g_score = (use_g ? from_state.g : from_state.score) +
+                          GetCostToNeighbor(edge);
       if (edge->Type() != TopoEdgeType::TET_FORWARD) {
         tentative_g_score -=
             (edge->FromNode()->Cost() + edge->ToNode()->Cost()) / 2;
       }
       double f = tentative_g_score + HeuristicCost(to_node, dest_node);
-      if (open_set_.count(to_node) != 0 && f >= g_score_[to_node]) {
+      if (to_state.is_open && f >= to_state.score) {
         continue;
       }
       // if to_node is reached by forward, reset enter_s to start_s
       if (edge->Type() == TopoEdgeType::TET_FORWARD) {
-        enter_s_[to_node] = to_node->StartS();
+        to_state.enter_s = to_node->StartS();
       } else {
         // else, add enter_s with FLAGS_min_length_for_lane_change
         double to_node_enter_s =
-            (enter_s_[from_node] + FLAGS_min_length_for_lane_change) /
+            (from_state.enter_s + FLAGS_min_length_for_lane_change) /
             from_node->Length() * to_node->Length();
         // enter s could be larger than end_s but should be less than length
         to_node_enter_s = std::min(to_node_enter_s, to_node->Length());
@@ -307,17 +341,17 @@ bool AStarStrategy::Search(const TopoGraph* graph,
         if (to_node_enter_s > to_node->EndS() && to_node == dest_node) {
           continue;
         }
-        enter_s_[to_node] = to_node_enter_s;
+        to_state.enter_s = to_node_enter_s;
       }
+      to_state.has_enter_s = true;
 
-      g_score_[to_node] = f;
+      to_state.g = tentative_g_score;
+      to_state.score = f;
       SearchNode next_node(to_node);
       next_node.f = f;
       open_set_detail.push(next_node);
-      came_from_[to_node] = from_node;
-      if (open_set_.count(to_node) == 0) {
-        open_set_.insert(to_node);
-      }
+      to_state.came_from = from_node;
+      to_state.is_open = true;
     }
   }
   AERROR << "Failed to find goal lane with id: " << dest_node->LaneId();
@@ -326,12 +360,12 @@ bool AStarStrategy::Search(const TopoGraph* graph,
 
 double AStarStrategy::GetResidualS(const TopoNode* node) {
   double start_s = node->StartS();
-  const auto iter = enter_s_.find(node);
-  if (iter != enter_s_.end()) {
-    if (iter->second > node->EndS()) {
+  const auto& state = State(node);
+  if (state.has_enter_s) {
+    if (state.enter_s > node->EndS()) {
       return 0.0;
     }
-    start_s = iter->second;
+    start_s = state.enter_s;
   } else {
     AWARN << "lane " << node->LaneId() << "(" << node->StartS() << ", "
           << node->EndS() << "not found in enter_s map";
@@ -357,9 +391,9 @@ double AStarStrategy::GetResidualS(const TopoEdge* edge,
   }
   double start_s = to_node->StartS();
   const auto* from_node = edge->FromNode();
-  const auto iter = enter_s_.find(from_node);
-  if (iter != enter_s_.end()) {
-    double temp_s = iter->second / from_node->Length() * to_node->Length();
+  const auto& state = State(from_node);
+  if (state.has_enter_s) {
+    double temp_s = state.enter_s / from_node->Length() * to_node->Length();
     start_s = std::max(start_s, temp_s);
   } else {
     AWARN << "lane " << from_node->LaneId() << "(" << from_node->StartS()
@@ -16,10 +16,10 @@
 
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <cstdint>
 #include <vector>
 
+#include "modules/routing/strategy/landmark_heuristic.h"
 #include "modules/routing/strategy/strategy.h"
 
 namespace apollo {
@@ -34,19 +34,39 @@ class AStarStrategy : public Strategy {
                       const TopoNode* src_node, const TopoNode* dest_node,
                       std::vector<NodeWithRange>* const result_nodes);
 
+  // Uses the landmark lower bound instead of the distance of the anchor
+  // points, nullptr to switch back. The landmarks must outlive the searches.
+  void SetLandmarks(const LandmarkHeuristic* landmarks);
+
  private:
-  void Clear();
+  // Search state of one node. It is only valid when its generation is the
+  // one of the current search, so the arrays are reused without clearing.
+  struct NodeState {
+    uint32_t generation = 0;
+    bool is_open = false;
+    bool is_closed = false;
+    bool has_enter_s = false;
+    const TopoNode* came_from = nullptr;
+    // cost from the source node
+    double g = 0.0;
+    // the score the open set is ordered by
+    double score = 0.0;
+    double enter_s = 0.0;
+  };
+
+  void Clear(const TopoGraph* graph, const SubTopoGraph* sub_graph);
+  NodeState& State(const TopoNode* node);
   double HeuristicCost(const TopoNode* src_node, const TopoNode* dest_node);
   double GetResidualS(const TopoNode* node);
   double GetResidualS(const TopoEdge* edge, const TopoNode* to_node);
 
  private:
   bool change_lane_enabled_;
-  std::unordered_set<const TopoNode*> open_set_;
-  std::unordered_set<const TopoNode*> closed_set_;
-  std::unordered_map<const TopoNode*, const TopoNode*> came_from_;
-  std::unordered_map<const TopoNode*, double> g_score_;
-  std::unordered_map<const TopoNode*, double> enter_s_;
+  const LandmarkHeuristic* landmarks_ = nullptr;
+  // graph nodes come first, sub graph nodes follow
+  int sub_node_offset_ = 0;
+  uint32_t generation_ = 0;
+  std::vector<NodeState> node_states_;
 };
 
 }  // namespace routing
@@ -0,0 +1,152 @@
+/******************************************************************************
+ * Copyright 2017 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/routing/strategy/a_star_strategy.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "modules/routing/graph/sub_topo_graph.h"
+#include "modules/routing/graph/topo_graph.h"
+#include "modules/routing/graph/topo_test_utils.h"
+
+namespace apollo {
+namespace routing {
+
+namespace {
+
+const std::unordered_map<const TopoNode*, std::vector<NodeSRange>>
+    kEmptyBlackMap;
+
+std::vector<std::string> LaneIds(const std::vector<NodeWithRange>& nodes) {
+  std::vector<std::string> ids;
+  for (const auto& node : nodes) {
+    ids.push_back(node.GetTopoNode()->LaneId());
+  }
+  return ids;
+}
+
+}  // namespace
+
+TEST(AStarStrategyTestSuit, reuse_search_state) {
+  Graph graph;
+  GetGraph3ForTest(&graph);
+  TopoGraph topo_graph;
+  ASSERT_TRUE(topo_graph.LoadGraph(graph));
+  ASSERT_EQ(6, topo_graph.NodeNum());
+  for (int i = 0; i < topo_graph.NodeNum(); ++i) {
+    EXPECT_EQ(i, topo_graph.GetNodeByIndex(i)->Index());
+  }
+
+  AStarStrategy strategy(true);
+  SubTopoGraph sub_graph(kEmptyBlackMap);
+  std::vector<NodeWithRange> result;
+  ASSERT_TRUE(strategy.Search(&topo_graph, &sub_graph,
+                              topo_graph.GetNode(TEST_L1),
+                              topo_graph.GetNode(TEST_L6), &result));
+  const auto first = LaneIds(result);
+  ASSERT_EQ(4, first.size());
+  EXPECT_EQ(TEST_L1, first.front());
+  EXPECT_EQ(TEST_L6, first.back());
+
+  // nothing of the last search leaks into the next ones
+  ASSERT_FALSE(strategy.Search(&topo_graph, &sub_graph,
+                               topo_graph.GetNode(TEST_L5),
+                               topo_graph.GetNode(TEST_L1), &result));
+  ASSERT_TRUE(strategy.Search(&topo_graph, &sub_graph,
+                              topo_graph.GetNode(TEST_L1),
+                              topo_graph.GetNode(TEST_L6), &result));
+  EXPECT_EQ(first, LaneIds(result));
+}
+
+TEST(AStarStrategyTestSuit, search_with_black_list) {
+  Graph graph;
+  GetGraph3ForTest(&graph);
+  TopoGraph topo_graph;
+  ASSERT_TRUE(topo_graph.LoadGraph(graph));
+  const TopoNode* node_3 = topo_graph.GetNode(TEST_L3);
+
+  // L3 is split into sub nodes, which take indices after the graph nodes
+  std::unordered_map<const TopoNode*, std::vector<NodeSRange>> black_map;
+  black_map[node_3].emplace_back(40.0, 60.0);
+  SubTopoGraph sub_graph(black_map);
+  ASSERT_EQ(2, sub_graph.SubNodeNum());
+  const TopoNode* sub_node = sub_graph.GetSubNodeWithS(node_3, 80.0);
+  ASSERT_NE(nullptr, sub_node);
+  EXPECT_TRUE(sub_node->IsSubNode());
+
+  AStarStrategy strategy(true);
+  std::vector<NodeWithRange> result;
+  ASSERT_TRUE(strategy.Search(&topo_graph, &sub_graph, sub_node,
+                              topo_graph.GetNode(TEST_L5), &result));
+  ASSERT_EQ(2, result.size());
+  EXPECT_EQ(TEST_L3, result.front().GetTopoNode()->LaneId());
+  EXPECT_DOUBLE_EQ(60.0, result.front().StartS());
+  EXPECT_EQ(TEST_L5, result.back().GetTopoNode()->LaneId());
+}
+
+TEST(AStarStrategyTestSuit, landmarks) {
+  Graph graph;
+  GetGraph3ForTest(&graph);
+  TopoGraph topo_graph;
+  ASSERT_TRUE(topo_graph.LoadGraph(graph));
+
+  LandmarkSet landmark_set;
+  ASSERT_TRUE(LandmarkHeuristic::Build(topo_graph, 4, &landmark_set));
+  EXPECT_EQ(TEST_MAP_VERSION, landmark_set.hdmap_version());
+  EXPECT_EQ(6, landmark_set.node_num());
+  ASSERT_LT(0, landmark_set.landmark_size());
+
+  LandmarkHeuristic landmarks;
+  ASSERT_TRUE(landmarks.Init(topo_graph, landmark_set));
+  ASSERT_TRUE(landmarks.IsReady());
+
+  // L1 -> L3 -> L5 -> L6 is the cheapest way
+  const double cost_1_to_6 = 2 * (TEST_EDGE_COST + TEST_LANE_COST) +
+                             TEST_EDGE_COST;
+  const TopoNode* node_1 = topo_graph.GetNode(TEST_L1);
+  const TopoNode* node_6 = topo_graph.GetNode(TEST_L6);
+  EXPECT_LE(landmarks.Estimate(node_1, node_6), cost_1_to_6 + 1e-9);
+  EXPECT_DOUBLE_EQ(0.0, landmarks.Estimate(node_6, node_6));
+
+  AStarStrategy strategy(true);
+  strategy.SetLandmarks(&landmarks);
+  SubTopoGraph sub_graph(kEmptyBlackMap);
+  std::vector<NodeWithRange> result;
+  ASSERT_TRUE(
+      strategy.Search(&topo_graph, &sub_graph, node_1, node_6, &result));
+  const auto ids = LaneIds(result);
+  ASSERT_EQ(4, ids.size());
+  EXPECT_EQ(TEST_L1, ids.front());
+  EXPECT_EQ(TEST_L6, ids.back());
+
+  LandmarkSet other_map = landmark_set;
+  other_map.set_node_num(7);
+  EXPECT_FALSE(landmarks.Init(topo_graph, other_map));
+  EXPECT_FALSE(landmarks.IsReady());
+}
+
+TEST(AStarStrategyTestSuit, landmark_file) {
+  EXPECT_EQ("/apollo/map/routing_map_landmarks.bin",
+            LandmarkHeuristic::LandmarkFile("/apollo/map/routing_map.bin"));
+  EXPECT_EQ("/apollo/map.d/routing_map_landmarks.bin",
+            LandmarkHeuristic::LandmarkFile("/apollo/map.d/routing_map"));
+}
+
+}  // namespace routing
+}  // namespace apollo
@@ -0,0 +1,230 @@
+/******************************************************************************
+ * Copyright 2017 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/routing/strategy/landmark_heuristic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace apollo {
+namespace routing {
+
+namespace {
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+double PlanarDistance(const TopoNode* a, const TopoNode* b) {
+  return std::hypot(a->AnchorPoint().x() - b->AnchorPoint().x(),
+                    a->AnchorPoint().y() - b->AnchorPoint().y());
+}
+
+// farthest point selection on the anchor points, so the landmarks end up at
+// the borders of the map where they give the tightest bounds
+std::vector<int> SelectLandmarks(const TopoGraph& graph, int landmark_num) {
+  std::vector<int> selected;
+  const int node_num = graph.NodeNum();
+  if (node_num == 0) {
+    return selected;
+  }
+  std::vector<double> min_distance(node_num, kInf);
+  const TopoNode* seed = graph.GetNodeByIndex(0);
+  int next = 0;
+  double max_distance = -1.0;
+  for (int i = 0; i < node_num; ++i) {
+    const double distance = PlanarDistance(seed, graph.GetNodeByIndex(i));
+    if (distance > max_distance) {
+      max_distance = distance;
+      next = i;
+    }
+  }
+  while (static_cast<int>(selected.size()) < std::min(landmark_num, node_num)) {
+    selected.push_back(next);
+    const TopoNode* landmark = graph.GetNodeByIndex(next);
+    max_distance = -1.0;
+    for (int i = 0; i < node_num; ++i) {
+      min_distance[i] = std::min(
+          min_distance[i], PlanarDistance(landmark, graph.GetNodeByIndex(i)));
+      if (min_distance[i] > max_distance) {
+        max_distance = min_distance[i];
+        next = i;
+      }
+    }
+    if (max_distance <= 0.0) {
+      break;
+    }
+  }
+  return selected;
+}
+
+}  // namespace
+
+std::string LandmarkHeuristic::LandmarkFile(
+    const std::string& routing_map_file) {
+  const auto slash_pos = routing_map_file.find_last_of('/');
+  auto dot_pos = routing_map_file.find_last_of('.');
+  if (dot_pos == std::string::npos ||
+      (slash_pos != std::string::npos && dot_pos < slash_pos)) {
+    dot_pos = routing_map_file.size();
+  }
+  return routing_map_file.substr(0, dot_pos) + "_landmarks.bin";
+}
+
+double LandmarkHeuristic::SearchCost(const TopoEdge* edge) {
+  // same as AStarStrategy::Search
+  double cost = edge->Cost() + edge->ToNode()->Cost();
+  if (edge->Type() != TopoEdgeType::TET_FORWARD) {
+    cost -= (edge->FromNode()->Cost() + edge->ToNode()->Cost()) / 2;
+  }
+  return cost;
+}
+
+void LandmarkHeuristic::ComputeCosts(const TopoGraph& graph, int source,
+                                     bool forward,
+                                     std::vector<double>* const costs) {
+  costs->assign(graph.NodeNum(), kInf);
+  using QueueItem = std::pair<double, int>;
+  std::priority_queue<QueueItem, std::vector<QueueItem>,
+                      std::greater<QueueItem>>
+      open_queue;
+  (*costs)[source] = 0.0;
+  open_queue.emplace(0.0, source);
+  while (!open_queue.empty()) {
+    const auto item = open_queue.top();
+    open_queue.pop();
+    if (item.first > (*costs)[item.second]) {
+      continue;
+    }
+    const TopoNode* node = graph.GetNodeByIndex(item.second);
+    const auto& edges =
+        forward ? node->OutToAllEdge() : node->InFromAllEdge();
+    for (const auto* edge : edges) {
+      const TopoNode* next = forward ? edge->ToNode() : edge->FromNode();
+      const double cost = item.first + SearchCost(edge);
+      if (cost < (*costs)[next->Index()]) {
+        (*costs)[next->Index()] = cost;
+        open_queue.emplace(cost, next->Index());
+      }
+    }
+  }
+}
+
+bool LandmarkHeuristic::Build(const TopoGraph& graph, int landmark_num,
+                              LandmarkSet* const landmarks) {
+  landmarks->Clear();
+  for (int i = 0; i < graph.NodeNum(); ++i) {
+    for (const auto* edge : graph.GetNodeByIndex(i)->OutToAllEdge()) {
+      if (SearchCost(edge) < 0.0) {
+        AERROR << "Negative search cost on edge " << edge->FromLaneId()
+               << " -> " << edge->ToLaneId() << ", landmarks do not apply.";
+        return false;
+      }
+    }
+  }
+
+  landmarks->set_hdmap_version(graph.MapVersion());
+  landmarks->set_node_num(graph.NodeNum());
+  std::vector<double> costs;
+  for (int index : SelectLandmarks(graph, landmark_num)) {
+    auto* landmark = landmarks->add_landmark();
+    landmark->set_lane_id(graph.GetNodeByIndex(index)->LaneId());
+    ComputeCosts(graph, index, true, &costs);
+    for (double cost : costs) {
+      landmark->add_cost_from(std::isinf(cost) ? -1.0 : cost);
+    }
+    ComputeCosts(graph, index, false, &costs);
+    for (double cost : costs) {
+      landmark->add_cost_to(std::isinf(cost) ? -1.0 : cost);
+    }
+  }
+  AINFO << "Built " << landmarks->landmark_size() << " routing landmarks for "
+        << graph.NodeNum() << " nodes.";
+  return true;
+}
+
+bool LandmarkHeuristic::Init(const TopoGraph& graph,
+                             const LandmarkSet& landmarks) {
+  node_num_ = 0;
+  landmark_num_ = 0;
+  cost_from_.clear();
+  cost_to_.clear();
+  if (landmarks.hdmap_version() != graph.MapVersion() ||
+      landmarks.node_num() != graph.NodeNum()) {
+    AERROR << "Landmarks of map " << landmarks.hdmap_version() << " with "
+           << landmarks.node_num() << " nodes do not match the routing map "
+           << graph.MapVersion() << " with " << graph.NodeNum() << " nodes.";
+    return false;
+  }
+  const int node_num = graph.NodeNum();
+  const int landmark_num = landmarks.landmark_size();
+  cost_from_.resize(static_cast<size_t>(node_num) * landmark_num);
+  cost_to_.resize(cost_from_.size());
+  for (int l = 0; l < landmark_num; ++l) {
+    const auto& landmark = landmarks.landmark(l);
+    if (landmark.cost_from_size() != node_num ||
+        landmark.cost_to_size() != node_num) {
+      AERROR << "Landmark " << landmark.lane_id() << " is incomplete.";
+      cost_from_.clear();
+      cost_to_.clear();
+      return false;
+    }
+    for (int i = 0; i < node_num; ++i) {
+      const size_t pos = static_cast<size_t>(i) * landmark_num + l;
+      cost_from_[pos] =
+          landmark.cost_from(i) < 0.0 ? kInf : landmark.cost_from(i);
+      cost_to_[pos] = landmark.cost_to(i) < 0.0 ? kInf : landmark.cost_to(i);
+    }
+  }
+  node_num_ = node_num;
+  landmark_num_ = landmark_num;
+  return true;
+}
+
+double LandmarkHeuristic::Estimate(const TopoNode* node,
+                                   const TopoNode* dest) const {
+  const int from = node->OriginNode()->Index();
+  const int to = dest->OriginNode()->Index();
+  if (from == to || from < 0 || to < 0 || from >= node_num_ ||
+      to >= node_num_) {
+    return 0.0;
+  }
+  const double* from_cost_from = &cost_from_[static_cast<size_t>(from) *
+                                             landmark_num_];
+  const double* to_cost_from = &cost_from_[static_cast<size_t>(to) *
+                                           landmark_num_];
+  const double* from_cost_to = &cost_to_[static_cast<size_t>(from) *
+                                         landmark_num_];
+  const double* to_cost_to = &cost_to_[static_cast<size_t>(to) *
+                                       landmark_num_];
+  double estimate = 0.0;
+  for (int l = 0; l < landmark_num_; ++l) {
+    // d(L, to) <= d(L, from) + d(from, to)
+    if (!std::isinf(to_cost_from[l]) && !std::isinf(from_cost_from[l])) {
+      estimate = std::max(estimate, to_cost_from[l] - from_cost_from[l]);
+    }
+    // d(from, L) <= d(from, to) + d(to, L)
+    if (!std::isinf(from_cost_to[l]) && !std::isinf(to_cost_to[l])) {
+      estimate = std::max(estimate, from_cost_to[l] - to_cost_to[l]);
+    }
+  }
+  return estimate;
+}
+
+}  // namespace routing
+}  // namespace apollo
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright 2017 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "modules/routing/proto/topo_graph.pb.h"
+#include "modules/routing/graph/topo_graph.h"
+
+namespace apollo {
+namespace routing {
+
+/**
+ * @brief ALT (A*, landmarks, triangle inequality) heuristic. The search costs
+ * from and to a few landmark nodes are computed offline for every node of the
+ * graph; by the triangle inequality their differences bound the cost between
+ * any two nodes from below.
+ */
+class LandmarkHeuristic {
+ public:
+  // path of the landmark file stored next to the given routing map
+  static std::string LandmarkFile(const std::string& routing_map_file);
+
+  // the cost the A* search pays for moving along the edge
+  static double SearchCost(const TopoEdge* edge);
+
+  // Picks landmarks spread over the map and computes the search costs between
+  // them and all nodes. Fails if any edge has a negative search cost.
+  static bool Build(const TopoGraph& graph, int landmark_num,
+                    LandmarkSet* const landmarks);
+
+  bool Init(const TopoGraph& graph, const LandmarkSet& landmarks);
+
+  bool IsReady() const { return landmark_num_ > 0; }
+
+  int LandmarkNum() const { return landmark_num_; }
+
+  // lower bound of the search cost from node to dest, sub nodes are looked up
+  // through their origin nodes
+  double Estimate(const TopoNode* node, const TopoNode* dest) const;
+
+ private:
+  static void ComputeCosts(const TopoGraph& graph, int source, bool forward,
+                           std::vector<double>* const costs);
+
+  int node_num_ = 0;
+  int landmark_num_ = 0;
+  // node major, the costs of one node to all landmarks are contiguous
+  std::vector<double> cost_from_;
+  std::vector<double> cost_to_;
+};
+
+}  // namespace routing
+}  // namespace apollo
@@ -17,6 +17,8 @@
 #include "cyber/common/file.h"
 #include "modules/map/hdmap/hdmap_util.h"
 #include "modules/routing/common/routing_gflags.h"
+#include "modules/routing/graph/topo_graph.h"
+#include "modules/routing/strategy/landmark_heuristic.h"
 #include "modules/routing/topo_creator/graph_creator.h"
 
 int main(int argc, char **argv) {
@@ -39,5 +41,23 @@ int main(int argc, char **argv) {
 
   AINFO << "Create routing topo successfully from " << base_map << " to "
         << routing_map;
+
+  if (FLAGS_routing_landmark_num > 0) {
+    apollo::routing::Graph graph;
+    ACHECK(apollo::cyber::common::GetProtoFromFile(routing_map, &graph))
+        << "Unable to load routing topo " << routing_map;
+    apollo::routing::TopoGraph topo_graph;
+    ACHECK(topo_graph.LoadGraph(graph)) << "Invalid routing topo!";
+    apollo::routing::LandmarkSet landmarks;
+    if (apollo::routing::LandmarkHeuristic::Build(
+            topo_graph, FLAGS_routing_landmark_num, &landmarks)) {
+      const auto landmark_file =
+          apollo::routing::LandmarkHeuristic::LandmarkFile(routing_map);
+      ACHECK(apollo::cyber::common::SetProtoToBinaryFile(landmarks,
+                                                         landmark_file))
+          << "Failed to dump routing landmarks into " << landmark_file;
+      AINFO << "Routing landmarks are dumped to " << landmark_file;
+    }
+  }
   return 0;
 }
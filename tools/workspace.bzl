@@ -20,6 +20,7 @@ load("//third_party/gtest:workspace.bzl", gtest = "repo")
 load("//third_party/gflags:workspace.bzl", gflags = "repo")
 load("//third_party/ipopt:workspace.bzl", ipopt = "repo")
 load("//third_party/libtorch:workspace.bzl", libtorch_cpu = "repo_cpu", libtorch_gpu = "repo_gpu")
+load("//third_party/lz4:workspace.bzl", lz4 = "repo")
 load("//third_party/ncurses5:workspace.bzl", ncurses5 = "repo")
 load("//third_party/nlohmann_json:workspace.bzl", nlohmann_json = "repo")
 load("//third_party/npp:workspace.bzl", npp = "repo")
@@ -36,6 +37,7 @@ load("//third_party/sqlite3:workspace.bzl", sqlite3 = "repo")
 load("//third_party/tinyxml2:workspace.bzl", tinyxml2 = "repo")
 load("//third_party/uuid:workspace.bzl", uuid = "repo")
 load("//third_party/yaml_cpp:workspace.bzl", yaml_cpp = "repo")
+load("//third_party/zstd:workspace.bzl", zstd = "repo")
 load("//third_party/localization_msf:workspace.bzl", localization_msf = "repo")
 
 # load("//third_party/glew:workspace.bzl", glew = "repo")
@@ -70,6 +72,7 @@ def initialize_third_party():
     ipopt()
     libtorch_cpu()
     libtorch_gpu()
+    lz4()
     ncurses5()
     nlohmann_json()
     npp()
@@ -87,6 +90,7 @@ def initialize_third_party():
     nvjpeg()
     uuid()
     yaml_cpp()
+    zstd()
     localization_msf()
 
 # Define all external repositories required by